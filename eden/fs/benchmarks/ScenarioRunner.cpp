@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/benchmarks/ScenarioRunner.h"
+
+#include <folly/CancellationToken.h>
+#include <folly/json.h>
+#include <folly/logging/xlog.h>
+#include <folly/stop_watch.h>
+
+#include <fmt/format.h>
+
+#include <cinttypes>
+#include <cstdio>
+
+#include "eden/fs/inodes/EdenMount.h"
+#include "eden/fs/inodes/FileInode.h"
+#include "eden/fs/service/gen-cpp2/eden_types.h"
+#include "eden/fs/store/ObjectFetchContext.h"
+#include "eden/fs/testharness/FakeTreeBuilder.h"
+#include "eden/fs/testharness/TestMount.h"
+
+namespace facebook::eden {
+
+std::string ScenarioResult::toJson() const {
+  folly::dynamic phasesJson = folly::dynamic::array;
+  for (const auto& phase : phases) {
+    auto seconds =
+        std::chrono::duration_cast<std::chrono::duration<double>>(phase.elapsed)
+            .count();
+    phasesJson.push_back(
+        folly::dynamic::object("name", phase.name)("seconds", seconds)(
+            "operations", phase.operations)(
+            "ops_per_second", seconds > 0 ? phase.operations / seconds : 0.0));
+  }
+  return folly::toJson(folly::dynamic::object("scenario", scenario)(
+      "phases", std::move(phasesJson)));
+}
+
+void ScenarioResult::printSummary() const {
+  printf("scenario: %s\n", scenario.c_str());
+  for (const auto& phase : phases) {
+    auto seconds =
+        std::chrono::duration_cast<std::chrono::duration<double>>(phase.elapsed)
+            .count();
+    printf(
+        "  %-12s %8.3f s, %10" PRIu64 " ops, %10.0f ops/s\n",
+        phase.name.c_str(),
+        seconds,
+        phase.operations,
+        seconds > 0 ? phase.operations / seconds : 0.0);
+  }
+}
+
+ScenarioRunner::ScenarioRunner(std::string scenarioName, RepoShape shape)
+    : shape_{shape} {
+  result_.scenario = std::move(scenarioName);
+}
+
+// Defined here because TestMount is incomplete in the header.
+ScenarioRunner::~ScenarioRunner() = default;
+
+template <typename Fn>
+void ScenarioRunner::runPhase(
+    folly::StringPiece name,
+    uint64_t operations,
+    Fn&& fn) {
+  folly::stop_watch<> timer;
+  fn();
+  result_.phases.push_back(PhaseResult{name.str(), timer.elapsed(), operations});
+}
+
+std::string ScenarioRunner::filePath(size_t dir, size_t file) const {
+  return fmt::format("src/dir{}/file{}.cpp", dir, file);
+}
+
+void ScenarioRunner::clone() {
+  XCHECK(!mount_) << "clone() must be the first phase of a scenario";
+
+  // Building the backing repository is setup, not the thing under test;
+  // only the mount itself is timed.
+  FakeTreeBuilder builder;
+  for (size_t dir = 0; dir < shape_.directories; dir++) {
+    for (size_t file = 0; file < shape_.filesPerDirectory; file++) {
+      // Give every file distinct contents so the backing store holds one
+      // blob per file rather than deduplicating the whole tree into one.
+      auto contents = fmt::format("// {}/{}\n", dir, file);
+      contents.resize(shape_.fileSizeBytes, 'x');
+      builder.setFile(filePath(dir, file), contents);
+    }
+  }
+
+  runPhase(
+      "clone", shape_.directories * shape_.filesPerDirectory, [&] {
+        mount_ = std::make_unique<TestMount>(builder);
+      });
+}
+
+void ScenarioRunner::prefetch() {
+  XCHECK(mount_) << "clone() must run before prefetch()";
+  const auto& context = ObjectFetchContext::getNullContext();
+  runPhase(
+      "prefetch", shape_.directories * shape_.filesPerDirectory, [&] {
+        for (size_t dir = 0; dir < shape_.directories; dir++) {
+          for (size_t file = 0; file < shape_.filesPerDirectory; file++) {
+            mount_->getFileInode(filePath(dir, file))
+                ->readAll(context)
+                .get();
+          }
+        }
+      });
+}
+
+void ScenarioRunner::buildMix() {
+  XCHECK(mount_) << "clone() must run before buildMix()";
+  const auto& context = ObjectFetchContext::getNullContext();
+  auto totalFiles = shape_.directories * shape_.filesPerDirectory;
+  runPhase("build_mix", totalFiles + totalFiles / 4, [&] {
+    size_t index = 0;
+    for (size_t dir = 0; dir < shape_.directories; dir++) {
+      for (size_t file = 0; file < shape_.filesPerDirectory; file++) {
+        auto inode = mount_->getFileInode(filePath(dir, file));
+        inode->stat(context).get();
+        // Re-read a quarter of the files, approximating a compiler that
+        // stats every candidate but only opens the sources it compiles.
+        if (index++ % 4 == 0) {
+          inode->readAll(context).get();
+        }
+      }
+    }
+  });
+}
+
+void ScenarioRunner::statusLoop(size_t iterations) {
+  XCHECK(mount_) << "clone() must run before statusLoop()";
+  auto& edenMount = *mount_->getEdenMount();
+  auto parent = edenMount.getWorkingCopyParent();
+  runPhase("status_loop", iterations, [&] {
+    for (size_t i = 0; i < iterations; i++) {
+      auto statusFuture = edenMount
+                              .diff(
+                                  parent,
+                                  folly::CancellationToken{},
+                                  /*listIgnored=*/false,
+                                  /*enforceCurrentParent=*/false)
+                              .semi()
+                              .via(mount_->getServerExecutor().get());
+      mount_->drainServerExecutor();
+      std::move(statusFuture).get();
+    }
+  });
+}
+
+ScenarioResult ScenarioRunner::takeResult() {
+  return std::move(result_);
+}
+
+} // namespace facebook::eden
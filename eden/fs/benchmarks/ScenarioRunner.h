@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/Range.h>
+
+namespace facebook::eden {
+
+class TestMount;
+
+/**
+ * Shape of the synthetic repository a scenario runs against. The defaults
+ * give a 4096-file tree, large enough that per-phase timings are dominated
+ * by the code under test rather than fixed setup costs.
+ */
+struct RepoShape {
+  size_t directories = 64;
+  size_t filesPerDirectory = 64;
+  size_t fileSizeBytes = 4096;
+};
+
+/**
+ * Timing for one phase of a scenario.
+ */
+struct PhaseResult {
+  std::string name;
+  std::chrono::nanoseconds elapsed{0};
+  uint64_t operations = 0;
+};
+
+struct ScenarioResult {
+  std::string scenario;
+  std::vector<PhaseResult> phases;
+
+  /**
+   * Render the result as a single JSON object, for ingestion by nightly
+   * regression tooling.
+   */
+  std::string toJson() const;
+
+  /**
+   * Print a human-readable per-phase summary to stdout.
+   */
+  void printSummary() const;
+};
+
+/**
+ * Executes declarative end-to-end benchmark scenarios against a scratch
+ * in-process mount.
+ *
+ * Unlike the single-syscall benchmarks in this directory, a scenario covers
+ * the whole mount lifecycle: the runner provisions its own mount (TestMount
+ * over a FakeBackingStore, so no daemon or pre-existing repository is
+ * needed), then times each phase the caller invokes. Phases are composable;
+ * clone() must run first since it creates the mount the other phases
+ * operate on.
+ */
+class ScenarioRunner {
+ public:
+  ScenarioRunner(std::string scenarioName, RepoShape shape);
+  ~ScenarioRunner();
+
+  ScenarioRunner(const ScenarioRunner&) = delete;
+  ScenarioRunner& operator=(const ScenarioRunner&) = delete;
+
+  /**
+   * Provision the backing repository and mount it, timing the mount
+   * initialization. Counts one operation per file in the tree.
+   */
+  void clone();
+
+  /**
+   * Read every file in the tree once, in order, like `eden prefetch`.
+   */
+  void prefetch();
+
+  /**
+   * A build-like metadata-heavy mix: stat every file and re-read every
+   * fourth one, approximating a compiler scanning headers and reading
+   * sources.
+   */
+  void buildMix();
+
+  /**
+   * Run `iterations` status queries against the unchanged working copy,
+   * the IDE/tooling polling pattern.
+   */
+  void statusLoop(size_t iterations);
+
+  /**
+   * Return the accumulated per-phase results.
+   */
+  ScenarioResult takeResult();
+
+ private:
+  template <typename Fn>
+  void runPhase(folly::StringPiece name, uint64_t operations, Fn&& fn);
+
+  std::string filePath(size_t dir, size_t file) const;
+
+  const RepoShape shape_;
+  ScenarioResult result_;
+  std::unique_ptr<TestMount> mount_;
+};
+
+} // namespace facebook::eden
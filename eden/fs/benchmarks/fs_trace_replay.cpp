@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include <folly/File.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <folly/portability/GFlags.h>
+#include <folly/stop_watch.h>
+
+#include <fmt/format.h>
+
+#include <cinttypes>
+#include <regex>
+#include <unordered_map>
+#include <vector>
+
+#include "eden/fs/inodes/EdenMount.h"
+#include "eden/fs/inodes/FuseDispatcherImpl.h"
+#include "eden/fs/inodes/TreeInode.h"
+#include "eden/fs/store/ObjectFetchContext.h"
+#include "eden/fs/testharness/FakeTreeBuilder.h"
+#include "eden/fs/testharness/TestMount.h"
+
+using namespace facebook::eden;
+
+DEFINE_string(
+    trace,
+    "",
+    "File containing the output of `eden trace fs --reads --writes`");
+DEFINE_int32(repeat, 1, "Number of times to replay the captured trace");
+
+namespace {
+
+/**
+ * Replays a captured `eden trace fs` stream against an in-process TestMount.
+ *
+ * Each request start line in the capture looks like:
+ *
+ *   + 1234 from clang(5678): read(42, off=0, len=4096)
+ *
+ * We parse out the opcode, the inode number, and (for reads and writes) the
+ * offset and length. Inode numbers from the trace are remapped onto files in
+ * a synthetic mount, so the replay preserves the operation mix and the
+ * per-inode access pattern of the original workload without needing the
+ * original repository.
+ */
+struct TraceOp {
+  std::string opcode;
+  uint64_t traceIno = 0;
+  uint64_t offset = 0;
+  uint64_t length = 0;
+};
+
+// Cap replayed writes so a corrupt trace line cannot make us allocate
+// an absurd buffer.
+constexpr uint64_t kMaxIoLength = 1024 * 1024;
+
+std::vector<TraceOp> parseTrace(const std::string& contents) {
+  // Matches "+ <unique> from <process>: <opcode>(<nodeid>[, <args>])".
+  static const std::regex lineRe{
+      R"(^\+ \d+ from .*: (\w+)\((\d+)(?:, (.*))?\)\s*$)"};
+  static const std::regex offLenRe{R"(off=(\d+), len=(\d+))"};
+
+  std::vector<TraceOp> ops;
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', contents, lines);
+  for (const auto& line : lines) {
+    std::smatch match;
+    auto lineStr = line.str();
+    if (!std::regex_match(lineStr, match, lineRe)) {
+      continue;
+    }
+    TraceOp op;
+    op.opcode = match[1].str();
+    op.traceIno = folly::to<uint64_t>(match[2].str());
+    if (match[3].matched) {
+      std::smatch ioMatch;
+      auto args = match[3].str();
+      if (std::regex_search(args, ioMatch, offLenRe)) {
+        op.offset = folly::to<uint64_t>(ioMatch[1].str());
+        op.length =
+            std::min(folly::to<uint64_t>(ioMatch[2].str()), kMaxIoLength);
+      }
+    }
+    ops.push_back(std::move(op));
+  }
+  return ops;
+}
+
+struct OpcodeStats {
+  uint64_t count = 0;
+  std::chrono::nanoseconds elapsed{0};
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  if (FLAGS_trace.empty()) {
+    fprintf(stderr, "error: --trace is required\n");
+    return 1;
+  }
+
+  std::string contents;
+  if (!folly::readFile(FLAGS_trace.c_str(), contents)) {
+    fprintf(stderr, "error: unable to read %s\n", FLAGS_trace.c_str());
+    return 1;
+  }
+
+  auto ops = parseTrace(contents);
+  if (ops.empty()) {
+    fprintf(stderr, "error: no replayable operations in trace\n");
+    return 1;
+  }
+  printf("Parsed %zu operations from trace\n", ops.size());
+
+  // Assign each distinct inode number in the trace a file in the synthetic
+  // mount, in order of first appearance.
+  std::unordered_map<uint64_t, size_t> fileIndexByTraceIno;
+  for (const auto& op : ops) {
+    fileIndexByTraceIno.emplace(op.traceIno, fileIndexByTraceIno.size());
+  }
+
+  FakeTreeBuilder builder;
+  std::string fileContents(4096, 'x');
+  for (size_t i = 0; i < fileIndexByTraceIno.size(); ++i) {
+    builder.setFile(fmt::format("dir/f{}", i), fileContents);
+  }
+  TestMount testMount{builder};
+
+  auto dirIno = testMount.getTreeInode("dir")->getNodeId();
+  std::unordered_map<uint64_t, InodeNumber> inoByTraceIno;
+  for (const auto& [traceIno, index] : fileIndexByTraceIno) {
+    inoByTraceIno.emplace(
+        traceIno,
+        testMount.getFileInode(fmt::format("dir/f{}", index))->getNodeId());
+  }
+
+  FuseDispatcherImpl dispatcher{testMount.getEdenMount().get()};
+  const auto& context = ObjectFetchContext::getNullContext();
+
+  std::unordered_map<std::string, OpcodeStats> statsByOpcode;
+  uint64_t replayed = 0;
+  uint64_t skipped = 0;
+
+  folly::stop_watch<> totalTimer;
+  for (int32_t iteration = 0; iteration < FLAGS_repeat; ++iteration) {
+    for (const auto& op : ops) {
+      auto ino = inoByTraceIno.at(op.traceIno);
+      folly::stop_watch<> opTimer;
+      if (op.opcode == "lookup") {
+        dispatcher
+            .lookup(
+                0,
+                dirIno,
+                PathComponent{fmt::format(
+                    "f{}", fileIndexByTraceIno.at(op.traceIno))},
+                context)
+            .get();
+      } else if (op.opcode == "getattr") {
+        dispatcher.getattr(ino, context).get();
+      } else if (op.opcode == "open") {
+        dispatcher.open(ino, O_RDONLY).get();
+      } else if (op.opcode == "read") {
+        dispatcher.read(ino, op.length, op.offset, context).get();
+      } else if (op.opcode == "write") {
+        std::string data(op.length, 'y');
+        dispatcher.write(ino, data, op.offset, context).get();
+      } else if (op.opcode == "flush") {
+        dispatcher.flush(ino, 0).get();
+      } else {
+        // Operations we cannot faithfully replay in-process (forget,
+        // release, interrupts, ...) are counted but skipped.
+        ++skipped;
+        continue;
+      }
+      auto& opStats = statsByOpcode[op.opcode];
+      ++opStats.count;
+      opStats.elapsed += opTimer.elapsed();
+      ++replayed;
+    }
+  }
+  auto totalElapsed = totalTimer.elapsed();
+
+  auto totalSeconds =
+      std::chrono::duration_cast<std::chrono::duration<double>>(totalElapsed)
+          .count();
+  printf(
+      "Replayed %" PRIu64 " operations (%" PRIu64
+      " skipped) in %.3f s: %.0f ops/s\n",
+      replayed,
+      skipped,
+      totalSeconds,
+      replayed / totalSeconds);
+  for (const auto& [opcode, opStats] : statsByOpcode) {
+    printf(
+        "  %-10s %10" PRIu64 " calls, avg %8.3f us\n",
+        opcode.c_str(),
+        opStats.count,
+        double(opStats.elapsed.count()) / 1000.0 / double(opStats.count));
+  }
+
+  return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include <folly/init/Init.h>
+#include <folly/portability/GFlags.h>
+
+#include <cstdio>
+
+#include "eden/fs/benchmarks/ScenarioRunner.h"
+
+using namespace facebook::eden;
+
+DEFINE_string(
+    scenario,
+    "lifecycle",
+    "Scenario to run: lifecycle (clone, prefetch, build mix, status loop), "
+    "clone-prefetch, or status");
+DEFINE_uint64(directories, 64, "Number of directories in the synthetic tree");
+DEFINE_uint64(
+    files_per_directory,
+    64,
+    "Number of files in each directory of the synthetic tree");
+DEFINE_uint64(file_size, 4096, "Size of each file in bytes");
+DEFINE_uint64(
+    status_iterations,
+    100,
+    "Number of status queries in the status loop phase");
+DEFINE_bool(
+    json,
+    false,
+    "Emit a machine-readable JSON result instead of the human summary");
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  RepoShape shape;
+  shape.directories = FLAGS_directories;
+  shape.filesPerDirectory = FLAGS_files_per_directory;
+  shape.fileSizeBytes = FLAGS_file_size;
+
+  ScenarioRunner runner{FLAGS_scenario, shape};
+  if (FLAGS_scenario == "lifecycle") {
+    runner.clone();
+    runner.prefetch();
+    runner.buildMix();
+    runner.statusLoop(FLAGS_status_iterations);
+  } else if (FLAGS_scenario == "clone-prefetch") {
+    runner.clone();
+    runner.prefetch();
+  } else if (FLAGS_scenario == "status") {
+    runner.clone();
+    runner.statusLoop(FLAGS_status_iterations);
+  } else {
+    fprintf(
+        stderr,
+        "error: unknown scenario '%s'; expected lifecycle, clone-prefetch, "
+        "or status\n",
+        FLAGS_scenario.c_str());
+    return 1;
+  }
+
+  auto result = runner.takeResult();
+  if (FLAGS_json) {
+    printf("%s\n", result.toJson().c_str());
+  } else {
+    result.printSummary();
+  }
+
+  return 0;
+}
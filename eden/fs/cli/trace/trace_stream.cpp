@@ -32,6 +32,11 @@ DEFINE_bool(
     retroactive,
     false,
     "Provide stored inode events (from a buffer) across past changes");
+DEFINE_int64(
+    perfWindow,
+    60,
+    "How many trailing seconds of the rolling perf aggregation to report "
+    "(perf mode only, clamped to [1, 60] by the daemon)");
 
 namespace {
 constexpr auto kTimeout = std::chrono::seconds{1};
@@ -763,6 +768,61 @@ int trace_inode_retroactive(
   return 0;
 }
 
+int trace_perf(
+    folly::ScopedEventBaseThread& evbThread,
+    const AbsolutePath& mountRoot,
+    apache::thrift::RocketClientChannel::Ptr channel) {
+  auto client =
+      std::make_unique<apache::thrift::Client<EdenService>>(std::move(channel));
+
+  GetTracePerfStatsParams params{};
+  params.mountPoint() = mountRoot.view();
+  params.windowSeconds() = FLAGS_perfWindow;
+  auto future = client->semifuture_getTracePerfStats(params).via(
+      evbThread.getEventBase());
+
+  std::move(future)
+      .thenValue([](GetTracePerfStatsResponse response) {
+        fmt::print(
+            "Operations completed in the last {} seconds, most expensive "
+            "first\n\n",
+            *response.windowSeconds());
+        std::string header = fmt::format(
+            "{:<6} {:<24} {:>8} {:>12} {:>12} {:>12} {:>12}",
+            "System",
+            "Operation",
+            "Count",
+            "Total",
+            "Max",
+            "Queue",
+            "Fetch");
+        fmt::print("{}\n{}\n", header, std::string(header.size(), '-'));
+        for (const auto& operation : *response.operations()) {
+          fmt::print(
+              "{:<6} {:<24} {:>8} {:>12} {:>12} {:>12} {:>12}\n",
+              *operation.subsystem(),
+              *operation.name(),
+              *operation.count(),
+              formatMicrosecondTime(*operation.totalDurationUs()),
+              formatMicrosecondTime(*operation.maxDurationUs()),
+              formatMicrosecondTime(*operation.queueWaitUs()),
+              formatMicrosecondTime(*operation.storeFetchUs()));
+        }
+        if (response.operations()->empty()) {
+          fmt::print("no operations completed during the window\n");
+        }
+      })
+      .thenError([](const folly::exception_wrapper& ex) {
+        fmt::print("{}\n", ex.what());
+      })
+      .ensure(
+          // Move the client into the callback so that it will be destroyed
+          // on an EventBase thread.
+          [c = std::move(client)] {})
+      .get();
+  return 0;
+}
+
 AbsolutePath getSocketPath(AbsolutePathPiece mountRoot) {
   if constexpr (folly::kIsWindows) {
     auto configPath = mountRoot + ".eden"_pc + "config"_pc;
@@ -817,6 +877,8 @@ int main(int argc, char** argv) {
     return FLAGS_retroactive
         ? trace_inode_retroactive(evbThread, mountRoot, std::move(channel))
         : trace_inode(evbThread, mountRoot, std::move(channel));
+  } else if (FLAGS_trace == "perf") {
+    return trace_perf(evbThread, mountRoot, std::move(channel));
   } else if (FLAGS_trace.empty()) {
     fmt::print(stderr, "Must specify trace mode\n");
     return 1;
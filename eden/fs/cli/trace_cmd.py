@@ -212,6 +212,47 @@ M MATERIALIZE
         )
 
 
+@trace_cmd("perf", "Summarize where recent filesystem requests spent time.")
+class TracePerfCommand(Subcmd):
+    DESCRIPTION = """Report the rolling per-operation performance aggregation.
+
+EdenFS continuously folds its filesystem, hg import, and inode trace streams
+into per-operation stage breakdowns. This command prints the operations that
+completed during the trailing window (60 seconds by default), ordered by
+total time spent, splitting each filesystem operation's latency into hg
+import queue wait, backing store fetch, and everything else. Unlike the
+streaming trace commands, this reports on activity that already happened, so
+it can be run after the slowness was observed.
+"""
+    # pyre-fixme[15]: Type typing.Type[argparse.RawDescriptionHelpFormatter] is not a
+    # subtype of the overridden attribute typing.Optional[argparse.HelpFormatter]
+    FORMATTER = argparse.RawDescriptionHelpFormatter
+
+    def setup_parser(self, parser: argparse.ArgumentParser) -> None:
+        parser.add_argument(
+            "checkout", default=None, nargs="?", help="Path to the checkout"
+        )
+        parser.add_argument(
+            "--window",
+            type=int,
+            default=60,
+            help="How many trailing seconds to report (clamped to [1, 60])",
+        )
+
+    async def run(self, args: argparse.Namespace) -> int:
+        instance, checkout, _rel_path = require_checkout(args, args.checkout)
+        trace_stream_command = get_trace_stream_command()
+        return execute_cmd(
+            [
+                trace_stream_command,
+                "--mountRoot",
+                checkout.path,
+                "--trace=perf",
+                f"--perfWindow={args.window}",
+            ]
+        )
+
+
 @trace_cmd("thrift", "Monitor Thrift requests.")
 class TraceThriftCmd(Subcmd):
     DESCRIPTION = """Trace thrift requests made to EdenFS.
@@ -9,11 +9,19 @@
 
 #include <cpptoml.h>
 
+#include <cerrno>
+
+#include <folly/File.h>
+#include <folly/FileUtil.h>
 #include <folly/Range.h>
 #include <folly/String.h>
+#include <folly/hash/Checksum.h>
 #include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
 #include <folly/json.h>
+#include <folly/logging/xlog.h>
+#include <folly/portability/Fcntl.h>
+#include <folly/portability/Unistd.h>
 #include "eden/fs/utils/FileUtils.h"
 #include "eden/fs/utils/PathMap.h"
 #include "eden/fs/utils/SystemError.h"
@@ -45,6 +53,7 @@ constexpr folly::StringPiece kRepoGuid{"guid"};
 
 // Files of interest in the client directory.
 const RelativePathPiece kSnapshotFile{"SNAPSHOT"};
+const RelativePathPiece kSnapshotJournalFile{"SNAPSHOT.journal"};
 const RelativePathPiece kOverlayDir{"local"};
 
 // File holding mapping of client directories.
@@ -89,20 +98,34 @@ enum : uint32_t {
   // RootId most recently reset to.
   kSnapshotFormatWorkingCopyParentAndCheckedOutRevisionVersion = 4,
 };
-} // namespace
 
-CheckoutConfig::CheckoutConfig(
-    AbsolutePathPiece mountPath,
-    AbsolutePathPiece clientDirectory)
-    : clientDirectory_(clientDirectory), mountPath_(mountPath) {}
-
-ParentCommit CheckoutConfig::getParentCommit() const {
-  // Read the snapshot.
-  auto snapshotFile = getSnapshotPath();
-  auto snapshotFileContents = readFile(snapshotFile).value();
-
-  StringPiece contents{snapshotFileContents};
+// Constants for use with the SNAPSHOT journal.
+//
+// Rewriting the SNAPSHOT file atomically on every commit transition is
+// expensive: a temporary file, a rename, and a read-back of the previous
+// contents. Commit-hopping automation (a 500-commit rebase, say) pays that
+// cost per commit. Instead, working copy parent transitions are appended to
+// a journal of records, each a complete snapshot image:
+//
+// - 32-bit length of the snapshot image
+// - Snapshot image (same bytes as a version 4 SNAPSHOT file)
+// - 32-bit CRC-32 of the snapshot image
+//
+// A record is appended with a single write, so a crash can only produce a
+// torn tail, which the checksum detects at replay time. The journal is
+// folded back into the SNAPSHOT file (and removed) at checkout boundaries
+// and once it grows past kSnapshotJournalCompactionBytes.
+enum : uint32_t {
+  kSnapshotJournalRecordOverhead = 2 * sizeof(uint32_t),
+  kSnapshotJournalCompactionBytes = 64 * 1024,
+};
 
+/**
+ * Parse the contents of a SNAPSHOT file (or snapshot journal record).
+ */
+ParentCommit parseSnapshotContents(
+    StringPiece contents,
+    AbsolutePathPiece snapshotFile) {
   if (contents.size() < kSnapshotHeaderSize) {
     throwf<std::runtime_error>(
         "eden SNAPSHOT file is too short ({} bytes): {}",
@@ -188,9 +211,109 @@ ParentCommit CheckoutConfig::getParentCommit() const {
   }
 }
 
-namespace {
-void writeWorkingCopyParentAndCheckedOutRevisision(
+/**
+ * Return the payload of the last intact journal record, or std::nullopt if
+ * the journal contains no intact record. Replay stops at the first torn or
+ * corrupt record: anything past it may depend on lost state.
+ */
+std::optional<std::string> lastValidSnapshotJournalRecord(
+    StringPiece contents) {
+  std::optional<std::string> last;
+
+  IOBuf buf(IOBuf::WRAP_BUFFER, ByteRange{contents});
+  folly::io::Cursor cursor(&buf);
+  while (cursor.totalLength() >= kSnapshotJournalRecordOverhead) {
+    auto length = cursor.readBE<uint32_t>();
+    if (cursor.totalLength() < length + sizeof(uint32_t)) {
+      // Torn tail from an interrupted append.
+      break;
+    }
+    auto payload = cursor.readFixedString(length);
+    auto checksum = cursor.readBE<uint32_t>();
+    if (folly::crc32(
+            reinterpret_cast<const uint8_t*>(payload.data()),
+            payload.size()) != checksum) {
+      break;
+    }
+    last = std::move(payload);
+  }
+
+  return last;
+}
+
+/**
+ * Append one checksummed record to the snapshot journal with a single
+ * write. Returns the size of the journal after the append, or std::nullopt
+ * if the record could not be written.
+ *
+ * The append is deliberately not fsynced: records are checksummed so a torn
+ * append is detected and ignored at replay time, and the atomic rewrite at
+ * the next checkout boundary makes the state durable. This groups the cost
+ * of flushing a long run of commit transitions into a single rewrite.
+ */
+std::optional<uint64_t> appendSnapshotJournalRecord(
     AbsolutePathPiece path,
+    const IOBuf& payload) {
+  auto record = IOBuf::create(kSnapshotJournalRecordOverhead + payload.length());
+  folly::io::Appender cursor{record.get(), 0};
+  cursor.writeBE<uint32_t>(payload.length());
+  cursor.push(ByteRange{payload.data(), payload.length()});
+  cursor.writeBE<uint32_t>(folly::crc32(payload.data(), payload.length()));
+
+  try {
+    folly::File file{path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644};
+    if (folly::writeFull(file.fd(), record->data(), record->length()) !=
+        static_cast<ssize_t>(record->length())) {
+      XLOG(WARN) << "short write to snapshot journal " << path;
+      return std::nullopt;
+    }
+    // With O_APPEND the offset sits at the end of the file after the write.
+    auto size = ::lseek(file.fd(), 0, SEEK_CUR);
+    if (size < 0) {
+      return std::nullopt;
+    }
+    return static_cast<uint64_t>(size);
+  } catch (const std::exception& ex) {
+    XLOG(WARN) << "unable to append to snapshot journal " << path << ": "
+               << ex.what();
+    return std::nullopt;
+  }
+}
+
+void removeSnapshotJournal(AbsolutePathPiece path) {
+  if (::remove(path.c_str()) != 0 && errno != ENOENT) {
+    XLOG(WARN) << "unable to remove snapshot journal " << path << ": "
+               << folly::errnoStr(errno);
+  }
+}
+} // namespace
+
+CheckoutConfig::CheckoutConfig(
+    AbsolutePathPiece mountPath,
+    AbsolutePathPiece clientDirectory)
+    : clientDirectory_(clientDirectory), mountPath_(mountPath) {}
+
+ParentCommit CheckoutConfig::getParentCommit() const {
+  // Read the snapshot.
+  auto snapshotFile = getSnapshotPath();
+  auto snapshotFileContents = readFile(snapshotFile).value();
+
+  // Newer state may live in the snapshot journal: replay the last intact
+  // record over the SNAPSHOT file's contents.
+  auto journalContents = readFile(getSnapshotJournalPath());
+  if (journalContents.hasValue()) {
+    if (auto record = lastValidSnapshotJournalRecord(
+            StringPiece{journalContents.value()})) {
+      return parseSnapshotContents(
+          StringPiece{*record}, getSnapshotJournalPath());
+    }
+  }
+
+  return parseSnapshotContents(StringPiece{snapshotFileContents}, snapshotFile);
+}
+
+namespace {
+std::unique_ptr<IOBuf> serializeWorkingCopyParentAndCheckedOutRevision(
     const RootId& workingCopy,
     const RootId& checkedOut) {
   const auto& workingCopyString = workingCopy.value();
@@ -219,6 +342,15 @@ void writeWorkingCopyParentAndCheckedOutRevisision(
   cursor.writeBE<uint32_t>(checkedOutString.size());
   cursor.push(folly::StringPiece{checkedOutString});
 
+  return buf;
+}
+
+void writeWorkingCopyParentAndCheckedOutRevisision(
+    AbsolutePathPiece path,
+    const RootId& workingCopy,
+    const RootId& checkedOut) {
+  auto buf =
+      serializeWorkingCopyParentAndCheckedOutRevision(workingCopy, checkedOut);
   writeFileAtomic(path, ByteRange{buf->data(), buf->length()}).value();
 }
 } // namespace
@@ -228,17 +360,37 @@ void CheckoutConfig::setCheckedOutCommit(const RootId& commit) const {
   // commit as a checkout sets both to the same value.
   writeWorkingCopyParentAndCheckedOutRevisision(
       getSnapshotPath(), commit, commit);
+  // The SNAPSHOT file now holds the latest state; drop any journaled
+  // transitions it supersedes.
+  removeSnapshotJournal(getSnapshotJournalPath());
+  cachedCheckedOutRootId_ = commit;
 }
 
 void CheckoutConfig::setWorkingCopyParentCommit(const RootId& commit) const {
-  // The checked out commit doesn't change, re-use what's in the file currently
-  auto parentCommit = getParentCommit();
-  auto checkedOutRootId =
-      parentCommit.getLastCheckoutId(ParentCommit::RootIdPreference::OnlyStable)
-          .value();
+  // The checked out commit doesn't change; cache it so a long run of commit
+  // transitions doesn't re-read and re-parse the snapshot state every time.
+  if (!cachedCheckedOutRootId_.has_value()) {
+    auto parentCommit = getParentCommit();
+    cachedCheckedOutRootId_ =
+        parentCommit
+            .getLastCheckoutId(ParentCommit::RootIdPreference::OnlyStable)
+            .value();
+  }
 
-  writeWorkingCopyParentAndCheckedOutRevisision(
-      getSnapshotPath(), commit, checkedOutRootId);
+  auto buf = serializeWorkingCopyParentAndCheckedOutRevision(
+      commit, *cachedCheckedOutRootId_);
+  auto journalSize =
+      appendSnapshotJournalRecord(getSnapshotJournalPath(), *buf);
+  if (!journalSize.has_value() ||
+      *journalSize >= kSnapshotJournalCompactionBytes) {
+    // Either journaling failed (fall back to the durable rewrite) or the
+    // journal has grown large enough to compact. In both cases the SNAPSHOT
+    // file is rewritten first, then the journal removed; a crash in between
+    // leaves a journal whose last record matches the SNAPSHOT file.
+    writeFileAtomic(getSnapshotPath(), ByteRange{buf->data(), buf->length()})
+        .value();
+    removeSnapshotJournal(getSnapshotJournalPath());
+  }
 }
 
 void CheckoutConfig::setCheckoutInProgress(const RootId& from, const RootId& to)
@@ -270,6 +422,9 @@ void CheckoutConfig::setCheckoutInProgress(const RootId& from, const RootId& to)
 
   writeFileAtomic(getSnapshotPath(), ByteRange{buf->data(), buf->length()})
       .value();
+  // The in-progress marker must not be masked by older journaled state.
+  removeSnapshotJournal(getSnapshotJournalPath());
+  cachedCheckedOutRootId_.reset();
 }
 
 const AbsolutePath& CheckoutConfig::getClientDirectory() const {
@@ -280,6 +435,10 @@ AbsolutePath CheckoutConfig::getSnapshotPath() const {
   return clientDirectory_ + kSnapshotFile;
 }
 
+AbsolutePath CheckoutConfig::getSnapshotJournalPath() const {
+  return clientDirectory_ + kSnapshotJournalFile;
+}
+
 AbsolutePath CheckoutConfig::getOverlayPath() const {
   return clientDirectory_ + kOverlayDir;
 }
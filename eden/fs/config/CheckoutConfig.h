@@ -119,6 +119,17 @@ class CheckoutConfig {
   /** Path to the file where the current commit ID is stored */
   AbsolutePath getSnapshotPath() const;
 
+  /**
+   * Path to the snapshot journal.
+   *
+   * Working copy parent transitions are appended to this file as checksummed
+   * records instead of atomically rewriting the SNAPSHOT file on every
+   * transition; see CheckoutConfig.cpp for the record format. The journal is
+   * folded back into the SNAPSHOT file at checkout boundaries and when it
+   * grows large.
+   */
+  AbsolutePath getSnapshotJournalPath() const;
+
   /** Path to the client directory */
   const AbsolutePath& getClientDirectory() const;
 
@@ -156,6 +167,15 @@ class CheckoutConfig {
  private:
   const AbsolutePath clientDirectory_;
   const AbsolutePath mountPath_;
+
+  /**
+   * The checked out commit most recently written to the SNAPSHOT state by
+   * this process. Caching it lets setWorkingCopyParentCommit serialize a new
+   * snapshot without re-reading and re-parsing the SNAPSHOT file on every
+   * commit transition. Parent updates are serialized by EdenMount's parent
+   * lock, so no additional synchronization is needed here.
+   */
+  mutable std::optional<RootId> cachedCheckedOutRootId_;
   std::string repoType_;
   std::string repoSource_;
   MountProtocol mountProtocol_{kMountProtocolDefault};
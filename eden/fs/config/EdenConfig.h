@@ -8,6 +8,7 @@
 #pragma once
 
 #include <chrono>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -293,6 +294,26 @@ class EdenConfig : private ConfigSettingManager {
       std::chrono::seconds(30),
       this};
 
+  /**
+   * Maximum number of expensive Thrift requests (working copy status, large
+   * globs) allowed to run concurrently. Requests beyond the limit are shed
+   * with EBUSY rather than queued, so cheap calls never wait behind heavy
+   * ones. Zero means unlimited.
+   */
+  ConfigSetting<uint32_t> thriftHeavyRequestLimit{
+      "thrift:heavy-request-limit",
+      8,
+      this};
+
+  /**
+   * Maximum number of expensive Thrift requests a single client process may
+   * have in flight at once. Zero means unlimited.
+   */
+  ConfigSetting<uint32_t> thriftHeavyRequestPerClientLimit{
+      "thrift:heavy-request-per-client-limit",
+      2,
+      this};
+
   // [ssl]
 
   ConfigSetting<AbsolutePath> clientCertificate{
@@ -317,6 +338,59 @@ class EdenConfig : private ConfigSettingManager {
       10,
       this};
 
+  /**
+   * The maximum number of checkout actions to run concurrently within one
+   * directory during a checkout. Actions for independent entries, including
+   * entire modified subtrees, are dispatched to the server thread pool up to
+   * this limit. Zero runs actions inline on the calling thread.
+   */
+  ConfigSetting<uint64_t> checkoutActionConcurrency{
+      "mount:checkout-action-concurrency",
+      16,
+      this};
+
+  /**
+   * The maximum number of subtree walks a single diff operation may have
+   * queued or running on the server thread pool at once. Without an executor
+   * the entire CPU-bound portion of a diff runs on whichever threads complete
+   * the tree fetches, typically serializing it behind the backing store.
+   * Zero restores that inline behavior.
+   */
+  ConfigSetting<uint64_t> diffWalkParallelism{
+      "mount:diff-walk-parallelism",
+      8,
+      this};
+
+  /**
+   * Whether a mount started without takeover data should pre-populate its
+   * InodeMap from the inode numbers recorded in the overlay, as is always
+   * done on Windows. This lets inode-number based requests issued after an
+   * ungraceful restart (for example NFS file handles held by the kernel, or
+   * FUSE dentry revalidation) be answered from the persisted mapping instead
+   * of failing with ESTALE or re-walking trees from the backing store.
+   */
+  ConfigSetting<bool> initializeInodeMapFromOverlay{
+      "mount:initialize-inode-map-from-overlay",
+      false,
+      this};
+
+  /**
+   * Controls whether the FUSE and NFS dispatchers cache computed stat
+   * results keyed by inode number. Entries are stamped with the journal
+   * sequence observed before the stat was computed and any journal
+   * activity invalidates them, so a cached attribute can never outlive a
+   * change to the mount. See InodeAttributeCache.
+   */
+  ConfigSetting<bool> attributeCache{"mount:attribute-cache", false, this};
+
+  /**
+   * Whether a freshly started (non-takeover) mount should automatically
+   * warm its working set in the background once the channel is up, using
+   * the manifest of paths recorded in the client directory. Takeover mounts
+   * are skipped since their caches are already warm. See MountWarmup.h.
+   */
+  ConfigSetting<bool> warmupAfterClone{"mount:warmup-after-clone", false, this};
+
   // [store]
 
   /**
@@ -328,6 +402,18 @@ class EdenConfig : private ConfigSettingManager {
       std::chrono::minutes(1),
       this};
 
+  /**
+   * How often to snapshot the set of objects resident in the in-memory blob
+   * and tree caches into the LocalStore. After a cold start the most recent
+   * snapshot is streamed back into the caches in the background so the first
+   * requests of the day do not all miss. An interval of 0 disables both the
+   * snapshot and the pre-warming.
+   */
+  ConfigSetting<std::chrono::nanoseconds> workingSetSnapshotInterval{
+      "store:working-set-snapshot-interval",
+      std::chrono::nanoseconds(0),
+      this};
+
   /*
    * The following settings control the maximum sizes of the local store's
    * caches, per object type.
@@ -356,6 +442,123 @@ class EdenConfig : private ConfigSettingManager {
       20'000'000,
       this};
 
+  ConfigSetting<uint64_t> localStoreBlobSha1SizeLimit{
+      "store:blobsha1-size-limit",
+      100'000'000,
+      this};
+
+  ConfigSetting<uint64_t> localStoreBlobChunkSizeLimit{
+      "store:blobchunk-size-limit",
+      15'000'000'000,
+      this};
+
+  /**
+   * Blobs at least this many bytes are stored in the local store as lists of
+   * content-defined chunks, deduplicated by chunk hash, instead of as whole
+   * values in the blob key space. Near-identical large artifacts then share
+   * most of their on-disk bytes. A value of 0 disables chunked storage.
+   */
+  ConfigSetting<uint64_t> localStoreBlobChunkingThreshold{
+      "store:blob-chunking-threshold",
+      16'777'216,
+      this};
+
+  /**
+   * When true, blob and blob chunk values written to the local store are
+   * compressed at the application level, picking a codec by value size and
+   * skipping incompressible content (see StoreCompression.h). Existing data
+   * is unaffected; reads handle compressed and plain values alike.
+   */
+  ConfigSetting<bool> localStoreCompressBlobs{
+      "store:compress-blobs",
+      false,
+      this};
+
+  /**
+   * Blobs at least this many bytes bypass the in-memory BlobCache: they are
+   * written once to a per-checkout spill file and served from a read-only
+   * memory mapping of that file, so reading one huge artifact cannot evict
+   * the working set of small hot blobs. A value of 0 disables the spill
+   * store.
+   */
+  ConfigSetting<uint64_t> largeBlobSpillThreshold{
+      "store:large-blob-spill-threshold",
+      0,
+      this};
+
+  /*
+   * The following settings allow overriding the RocksDB column family
+   * options for each key space, without rebuilding edenfs.
+   *
+   * Each value is parsed with rocksdb::GetColumnFamilyOptionsFromString and
+   * applied on top of our built-in defaults when the local store is opened,
+   * e.g. "compaction_style=kCompactionStyleUniversal;compression=kZSTD".
+   * An empty string (the default) leaves the built-in options unchanged.
+   * Changes take effect the next time edenfs starts.
+   */
+
+  ConfigSetting<std::string> localStoreBlobColumnFamilyOptions{
+      "store:blob-column-family-options",
+      "",
+      this};
+
+  ConfigSetting<std::string> localStoreBlobMetaColumnFamilyOptions{
+      "store:blobmeta-column-family-options",
+      "",
+      this};
+
+  ConfigSetting<std::string> localStoreTreeColumnFamilyOptions{
+      "store:tree-column-family-options",
+      "",
+      this};
+
+  ConfigSetting<std::string> localStoreHgProxyHashColumnFamilyOptions{
+      "store:hgproxyhash-column-family-options",
+      "",
+      this};
+
+  ConfigSetting<std::string> localStoreHgCommit2TreeColumnFamilyOptions{
+      "store:hgcommit2tree-column-family-options",
+      "",
+      this};
+
+  ConfigSetting<std::string> localStoreBlobChunkColumnFamilyOptions{
+      "store:blobchunk-column-family-options",
+      "",
+      this};
+
+  /**
+   * Size of a single RocksDB block cache shared by every column family, in
+   * bytes. When 0 (the default), each column family keeps its own private
+   * block cache sized by the built-in defaults. A shared cache is required
+   * for the unified cache budget below to govern RocksDB memory.
+   */
+  ConfigSetting<uint64_t> localStoreBlockCacheSize{
+      "store:block-cache-size",
+      0,
+      this};
+
+  /**
+   * A single memory budget, in bytes, spanning the RocksDB block cache, the
+   * in-memory BlobCache and TreeCache, and an estimate of loaded inode
+   * memory. When non-zero, a periodic task rebalances the individual cache
+   * limits within this budget toward whichever cache shows the most miss
+   * pressure. When 0 (the default), each cache keeps its statically
+   * configured size.
+   */
+  ConfigSetting<uint64_t> cacheMemoryBudget{
+      "store:cache-memory-budget",
+      0,
+      this};
+
+  /**
+   * How often the unified cache budget is rebalanced.
+   */
+  ConfigSetting<std::chrono::nanoseconds> cacheBudgetRebalanceInterval{
+      "store:cache-budget-rebalance-interval",
+      std::chrono::minutes{1},
+      this};
+
   /**
    * The minimum duration between logging occurrences of failed HgProxyHash
    * loads.
@@ -374,6 +577,30 @@ class EdenConfig : private ConfigSettingManager {
       100000,
       this};
 
+  /**
+   * Upper bound on the graduated fetch-heavy deprioritization factor: each
+   * further `store:fetch-heavy-threshold` worth of fetches from one process
+   * sinks its subsequent requests one more priority step below its peers,
+   * up to this many steps. This keeps a runaway scanner from monopolizing
+   * the import queue while lighter clients retain their standing. 0 keeps
+   * the single fixed deprioritization step.
+   */
+  ConfigSetting<uint64_t> fetchDeprioritizeMaxFactor{
+      "store:fetch-deprioritize-max-factor",
+      0,
+      this};
+
+  /**
+   * How often per-process fetch counts are halved when graduated
+   * deprioritization is enabled, so the fairness penalty reflects recent
+   * behavior rather than lifetime totals and long-lived processes recover
+   * their priority once they quiet down.
+   */
+  ConfigSetting<std::chrono::nanoseconds> fetchCountDecayInterval{
+      "store:fetch-count-decay-interval",
+      std::chrono::minutes{1},
+      this};
+
   /**
    * The maximum number of tree prefetch operations to allow in parallel for any
    * checkout.  Setting this to 0 will disable prefetch operations.
@@ -397,6 +624,51 @@ class EdenConfig : private ConfigSettingManager {
       1000,
       this};
 
+  /**
+   * Whether large FUSE replies are sent by splicing them through a pipe
+   * (vmsplice + splice with SPLICE_F_MOVE) instead of writev, avoiding the
+   * userspace-to-kernel copy of bulk read payloads. Linux only; falls back to
+   * writev when the kernel rejects the splice.
+   */
+  ConfigSetting<bool> fuseSpliceReplies{
+      "fuse:splice-large-replies",
+      false,
+      this};
+
+  /**
+   * How long, in seconds, the kernel may cache the attributes and directory
+   * entries returned over FUSE before revalidating them with getattr/lookup.
+   * The default is effectively infinite: EdenFS explicitly invalidates the
+   * kernel's caches when files change behind its back (e.g. during checkout),
+   * so TTL expiry is not needed for correctness. Lower this only to bound
+   * staleness on hosts where invalidation cannot be trusted; short TTLs
+   * multiply FUSE lookup traffic.
+   */
+  ConfigSetting<uint64_t> fuseCacheValidSeconds{
+      "fuse:cache-valid-seconds",
+      std::numeric_limits<int32_t>::max(),
+      this};
+
+  /**
+   * Controls whether EdenFS caches serialized FUSE readdir payloads so that
+   * repeated enumerations of an unchanged directory are served from memory
+   * instead of re-walking the TreeInode. Mostly useful on kernels too old for
+   * FOPEN_CACHE_DIR (pre-4.20), where every `ls` reaches EdenFS.
+   */
+  ConfigSetting<bool> fuseReaddirCache{"fuse:readdir-cache", false, this};
+
+  /**
+   * Controls whether EdenFS caches negative FUSE lookup results so that
+   * repeated probes for names that do not exist (build-system config probes
+   * like BUCK or .buckconfig at every directory level) are answered without
+   * consulting the inode tree. Entries are invalidated by any journal
+   * activity, so a cached ENOENT can never outlive a change to the mount.
+   */
+  ConfigSetting<bool> fuseNegativeLookupCache{
+      "fuse:negative-lookup-cache",
+      false,
+      this};
+
   /**
    * The maximum time duration allowed for a fuse request. If a request exceeds
    * this amount of time, an ETIMEDOUT error will be returned to the kernel to
@@ -526,6 +798,18 @@ class EdenConfig : private ConfigSettingManager {
       true,
       this};
 
+  /**
+   * Controls whether directory enumeration snapshots are cached and shared
+   * across enumeration sessions. Windows tools (Explorer, ripgrep) commonly
+   * enumerate the same directory several times in a row; with this enabled
+   * the sorted entry list is only rebuilt when the directory changes.
+   * Only applicable on Windows
+   */
+  ConfigSetting<bool> prjfsEnumerationCache{
+      "prjfs:enumeration-cache",
+      true,
+      this};
+
   /**
    * Controls the number of threads per mount dedicated to running directory
    * invalidation.
@@ -576,6 +860,20 @@ class EdenConfig : private ConfigSettingManager {
    */
   ConfigSetting<bool> useAuxMetadata{"hg:use-aux-metadata", true, this};
 
+  /**
+   * Directory probed for cold-start bootstrap bundles: files that pack the
+   * serialized trees a commit's early workload is known to touch (computed
+   * offline from aggregated fetch logs), named "<rootid>.treebundle". The
+   * first time a commit's root tree is requested, its bundle - if present -
+   * is bulk-inserted into the local store, replacing the level-by-level
+   * tree round trips of a cold clone with one file read. Empty disables
+   * the probe.
+   */
+  ConfigSetting<std::string> hgBootstrapBundleDir{
+      "hg:bootstrap-bundle-dir",
+      "",
+      this};
+
   /**
    * Which object ID format should the HgBackingStore use?
    */
@@ -611,6 +909,40 @@ class EdenConfig : private ConfigSettingManager {
       1,
       this};
 
+  /**
+   * When non-zero, import batch sizes adapt to hit this per-batch import
+   * latency instead of always using the full configured batch size. Batches
+   * that import faster than the target (typically local cache hits) grow up
+   * to the configured size, and batches dominated by remote round trips
+   * shrink so queued requests are not blocked behind one slow batch. Zero
+   * keeps the fixed batch sizes.
+   */
+  ConfigSetting<std::chrono::nanoseconds> importBatchTargetLatency{
+      "hg:import-batch-target-latency",
+      std::chrono::nanoseconds(0),
+      this};
+
+  /**
+   * Number of child trees to import concurrently in the background after a
+   * root manifest import, to warm the hgcache before a checkout descends
+   * into them. Zero disables the warm-up.
+   */
+  ConfigSetting<uint32_t> hgRootTreeImportFanout{
+      "hg:root-tree-import-fanout",
+      8,
+      this};
+
+  /**
+   * When non-zero, a blob import that has not completed within this delay is
+   * hedged: a duplicate fetch is launched through the Mercurial importer and
+   * the first result wins. This bounds the damage of a single slow remote
+   * fetch stalling an entire import batch. Zero disables hedging.
+   */
+  ConfigSetting<std::chrono::nanoseconds> importHedgeThreshold{
+      "hg:import-hedge-threshold",
+      std::chrono::nanoseconds(0),
+      this};
+
   // [backingstore]
 
   /**
@@ -621,6 +953,18 @@ class EdenConfig : private ConfigSettingManager {
       32,
       this};
 
+  /**
+   * Number of servicing threads reserved for requests of Normal or higher
+   * priority. Reserved threads idle rather than pick up background prefetch
+   * batches, so a large prefetch can never occupy every servicing thread
+   * and starve interactive fetches. Clamped to always leave at least one
+   * thread servicing background work.
+   */
+  ConfigSetting<uint8_t> numReservedInteractiveThreads{
+      "backingstore:reserved-interactive-threads",
+      4,
+      this};
+
   // [telemetry]
 
   /**
@@ -700,6 +1044,17 @@ class EdenConfig : private ConfigSettingManager {
       std::vector<std::string>{},
       this};
 
+  /**
+   * Controls sampling of the fine-grained internal stage latency histograms
+   * (the stage.*_us counters). One in every N passes through an instrumented
+   * stage is timed with the CPU timestamp counter; 0 disables the
+   * instrumentation entirely.
+   */
+  ConfigSetting<uint32_t> stageSamplingInterval{
+      "telemetry:stage-sampling-interval",
+      0,
+      this};
+
   /**
    * Controls the capacity of the internal buffer for NFS Tracebus.
    */
@@ -716,6 +1071,36 @@ class EdenConfig : private ConfigSettingManager {
       true,
       this};
 
+  /**
+   * Controls whether each mount keeps an always-on flight recorder: a
+   * fixed-size in-memory ring of compact records of the mount's channel and
+   * inode trace events that can be dumped after the fact with the
+   * debugDumpFlightRecorder thrift call.
+   */
+  ConfigSetting<bool> enableFlightRecorder{
+      "telemetry:enable-flight-recorder",
+      true,
+      this};
+
+  /**
+   * The number of entries the flight recorder ring retains per mount. Each
+   * entry is 24 bytes, so the default bounds the ring at about 1.5 MB.
+   */
+  ConfigSetting<uint32_t> flightRecorderMaxEvents{
+      "telemetry:flight-recorder-max-events",
+      65536,
+      this};
+
+  /**
+   * Controls whether each mount keeps a rolling per-operation aggregation
+   * of its trace buses (filesystem requests, hg imports, inode events),
+   * served by the getTracePerfStats thrift call and `eden trace perf`.
+   */
+  ConfigSetting<bool> enableTracePerf{
+      "telemetry:enable-trace-perf",
+      true,
+      this};
+
   /**
    * Controls whether EdenFS makes use of ActivityBuffers to store past
    * events in memory.
@@ -794,6 +1179,17 @@ class EdenConfig : private ConfigSettingManager {
       16,
       this};
 
+  /**
+   * When a tree fetched from the BackingStore consists mostly of subtrees,
+   * speculatively warm those subtrees into the in-memory tree cache with a
+   * low-priority fetch. This collapses the per-level round trips that
+   * recursive directory walks and glob evaluation otherwise serialize on.
+   */
+  ConfigSetting<bool> warmTreeCacheChildren{
+      "treecache:warm-children",
+      false,
+      this};
+
   // [notifications]
 
   /**
@@ -844,6 +1240,45 @@ class EdenConfig : private ConfigSettingManager {
   ConfigSetting<uint64_t> maxLogFileSize{"log:max-file-size", 50000000, this};
   ConfigSetting<uint64_t> maxRotatedLogFiles{"log:num-rotated-logs", 3, this};
 
+  // [monitor]
+
+  /**
+   * How often the EdenFS monitor process polls daemon health counters
+   * looking for sustained degradation. Zero disables health supervision;
+   * crash supervision is unaffected.
+   */
+  ConfigSetting<std::chrono::nanoseconds> monitorHealthPollInterval{
+      "monitor:health-poll-interval",
+      std::chrono::minutes(1),
+      this};
+
+  /**
+   * The oldest live SCM import must be at least this old, with further
+   * imports queued behind it, on consecutive polls before the monitor
+   * considers the importer wedged.
+   */
+  ConfigSetting<std::chrono::nanoseconds> monitorImportWedgeThreshold{
+      "monitor:import-wedge-threshold",
+      std::chrono::minutes(5),
+      this};
+
+  /**
+   * Number of consecutive unhealthy polls before the monitor applies a
+   * mitigation.
+   */
+  ConfigSetting<uint32_t> monitorUnhealthyPolls{
+      "monitor:unhealthy-polls",
+      3,
+      this};
+
+  /**
+   * Allow the monitor to gracefully shut the daemon down (service
+   * supervision then brings up a fresh one) when milder mitigations did
+   * not clear a sustained wedge. When false the monitor only flushes
+   * caches and logs what it would have done.
+   */
+  ConfigSetting<bool> monitorAutoRestart{"monitor:auto-restart", false, this};
+
   // [prefetch-profiles]
 
   /**
@@ -921,6 +1356,90 @@ class EdenConfig : private ConfigSettingManager {
       std::chrono::minutes(1),
       this};
 
+  /**
+   * Maximum rate, in bytes per second, at which checkout may write
+   * materialized file contents into the overlay. Bulk checkout writes
+   * compete with interactive writes for the same disk, and on slow disks
+   * the bulk writer wins; throttling it keeps interactive saves
+   * responsive. 0 disables the throttle.
+   */
+  ConfigSetting<uint64_t> overlayCheckoutBulkIoThroughput{
+      "overlay:checkout-bulk-io-throughput",
+      0,
+      this};
+
+  /**
+   * Like overlay:checkout-bulk-io-throughput, but for background work such
+   * as prefetch-driven materialization. 0 disables the throttle.
+   */
+  ConfigSetting<uint64_t> overlayBackgroundIoThroughput{
+      "overlay:background-io-throughput",
+      0,
+      this};
+
+  /**
+   * The longest a throttled overlay write may be delayed. Once a write has
+   * waited this long it proceeds regardless of the token bucket, bounding
+   * the latency the throttle can add to any single operation.
+   */
+  ConfigSetting<std::chrono::nanoseconds> overlayIoThrottleDeadline{
+      "overlay:io-throttle-deadline",
+      std::chrono::milliseconds(500),
+      this};
+
+  /**
+   * Determines if the periodic overlay maintenance task should reclaim
+   * overlay space by dematerializing files whose contents are identical to
+   * the currently checked out commit. The scan only runs while the working
+   * copy has been idle for a full maintenance interval.
+   */
+  ConfigSetting<bool> overlayDematerializeUnmodifiedFiles{
+      "overlay:dematerialize-unmodified-files",
+      false,
+      this};
+
+  /**
+   * The maximum number of files to dematerialize per overlay maintenance
+   * interval, bounding the I/O spent hashing and rewriting overlay data in
+   * any single pass.
+   */
+  ConfigSetting<uint64_t> overlayDematerializeMaxFilesPerRun{
+      "overlay:dematerialize-max-files-per-run",
+      2000,
+      this};
+
+  /**
+   * The number of WAL pages SQLite accumulates before automatically
+   * checkpointing the tree overlay database. Larger values keep checkpoint
+   * work off the write path at the cost of a bigger WAL file; the periodic
+   * overlay maintenance task still checkpoints when the database is idle.
+   * This option is ignored in other overlay types.
+   */
+  ConfigSetting<uint32_t> overlayWalAutocheckpointPages{
+      "overlay:wal-autocheckpoint-pages",
+      1000,
+      this};
+
+  /**
+   * Whether reads of materialized files should drive posix_fadvise hints on
+   * the overlay file descriptor based on the access pattern observed for
+   * that file: random-access files are marked POSIX_FADV_RANDOM to stop
+   * useless readahead, sequentially streamed files POSIX_FADV_SEQUENTIAL.
+   * Only has an effect on Linux.
+   */
+  ConfigSetting<bool> overlayReadFadvise{"overlay:read-fadvise", true, this};
+
+  /**
+   * Once a sequentially streamed overlay file has read this many bytes past
+   * the last drop point, the pages behind the read position are released
+   * with POSIX_FADV_DONTNEED so a large sweep cannot evict the rest of the
+   * page cache. 0 disables the drop behavior.
+   */
+  ConfigSetting<uint64_t> overlayReadFadviseDontneedBytes{
+      "overlay:read-fadvise-dontneed-bytes",
+      64 * 1024 * 1024,
+      this};
+
   /**
    * Determines if EdenFS should enable the option to buffer overlay writes.
    * This only works with tree overlays.
@@ -937,6 +1456,84 @@ class EdenConfig : private ConfigSettingManager {
       64 * 1024 * 1024,
       this};
 
+  /**
+   * When the legacy overlay was not shut down cleanly, skip the full fsck
+   * scan at startup and only enumerate the overlay shard directories to
+   * recover the next inode number, letting the mount come up immediately.
+   * Corrupt directories are still detected (and surfaced as errors) when
+   * they are first loaded, but orphaned inodes are not cleaned up and repairs
+   * are deferred until the next full fsck run.
+   */
+  ConfigSetting<bool> overlayLazyFsck{"overlay:lazy-fsck", false, this};
+
+  /**
+   * Defer writing unmaterialized directories (those identical to a source
+   * control Tree) to the overlay until they are first mutated, or until they
+   * are unloaded while the filesystem still references them. Eagerly saving
+   * every enumerated directory costs one overlay write per directory, which
+   * dominates scan-only workloads that list millions of directories they
+   * never modify. The deferred entries are written on demand when their
+   * allocated inode numbers must survive an unload; see
+   * TreeInodeState::overlayDirPersisted. The cost of enabling this is that
+   * directories unloaded while unreferenced are rebuilt with fresh inode
+   * numbers on their next load, rather than reusing the previous numbers.
+   */
+  ConfigSetting<bool> deferUnmaterializedDirSave{
+      "overlay:defer-unmaterialized-dir-save",
+      false,
+      this};
+
+  // [journal]
+
+  /**
+   * Mirror each mount's journal into a shared-memory ring file in the client
+   * directory, which external subscribers like Watchman can map read-only to
+   * follow the change feed without polling over Thrift. Not supported on
+   * Windows.
+   */
+  ConfigSetting<bool> journalShmRing{"journal:shm-ring", false, this};
+
+  /**
+   * Persist each mount's journal into a durable ring file in the client
+   * directory, fsynced once per merged batch. The journal resumes sequence
+   * numbering from the ring after a restart, so subscribers like Watchman
+   * can replay what they missed instead of recrawling the checkout. Not
+   * supported on Windows.
+   */
+  ConfigSetting<bool> journalPersistentRing{
+      "journal:persistent-ring",
+      false,
+      this};
+
+  /**
+   * Upper bound on the maxEntries a getFilesChangedSincePaged caller may
+   * request for a single page. Caps how much journal data one Thrift
+   * response can materialize regardless of what the client asks for.
+   */
+  ConfigSetting<uint64_t> journalPagedQueryMaxEntries{
+      "journal:paged-query-max-entries",
+      100000,
+      this};
+
+  // [peer-cache]
+
+  /**
+   * host:port of an office-local peer object cache to consult between the
+   * local store and the origin backing store; see PeerCachedBackingStore.
+   * Empty disables the tier.
+   */
+  ConfigSetting<std::string> peerCacheAddress{"peer-cache:address", "", this};
+
+  /**
+   * Socket connect/read/write timeout for the peer cache. The peer only
+   * pays off when it is much closer than the origin, so a short timeout
+   * keeps a sick peer from costing more than it saves.
+   */
+  ConfigSetting<std::chrono::nanoseconds> peerCacheIoTimeout{
+      "peer-cache:io-timeout",
+      std::chrono::milliseconds(500),
+      this};
+
   // [clone]
 
   /**
@@ -961,6 +1558,15 @@ class EdenConfig : private ConfigSettingManager {
    */
   ConfigSetting<uint64_t> fsckLogFrequency{"fsck:log-frequency", 10000, this};
 
+  /**
+   * Number of threads Windows FSCK uses to scan top-level directories of the
+   * mount concurrently. 1 keeps the scan fully serial.
+   */
+  ConfigSetting<uint64_t> fsckNumScannerThreads{
+      "fsck:num-scanner-threads",
+      8,
+      this};
+
   // [glob]
 
   /**
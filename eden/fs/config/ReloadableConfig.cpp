@@ -12,6 +12,7 @@
 #include "eden/fs/utils/EnumValue.h"
 
 #include <folly/logging/xlog.h>
+#include <folly/synchronization/Rcu.h>
 
 namespace {
 /// Throttle change checks to a maximum of one per
@@ -22,13 +23,41 @@ constexpr std::chrono::seconds kEdenConfigMinimumPollDuration{5};
 namespace facebook::eden {
 
 ReloadableConfig::ReloadableConfig(std::shared_ptr<const EdenConfig> config)
-    : state_{ConfigState{config}} {}
+    : state_{ConfigState{config}},
+      hotSettings_{new HotSettings{makeHotSettings(*config)}} {}
 ReloadableConfig::ReloadableConfig(
     std::shared_ptr<const EdenConfig> config,
     ConfigReloadBehavior reloadBehavior)
-    : state_{ConfigState{config}}, reloadBehavior_{reloadBehavior} {}
+    : state_{ConfigState{config}},
+      hotSettings_{new HotSettings{makeHotSettings(*config)}},
+      reloadBehavior_{reloadBehavior} {}
 
-ReloadableConfig::~ReloadableConfig() {}
+ReloadableConfig::~ReloadableConfig() {
+  // Wait for in-flight getHotSettings() readers before freeing the current
+  // version.  Retired older versions are reclaimed by rcu_retire itself.
+  folly::synchronize_rcu();
+  delete hotSettings_.load(std::memory_order_relaxed);
+}
+
+ReloadableConfig::HotSettings ReloadableConfig::getHotSettings() const {
+  folly::rcu_reader guard;
+  return *hotSettings_.load(std::memory_order_acquire);
+}
+
+ReloadableConfig::HotSettings ReloadableConfig::makeHotSettings(
+    const EdenConfig& config) {
+  HotSettings settings;
+  settings.useAuxMetadata = config.useAuxMetadata.getValue();
+  settings.checkoutActionConcurrency =
+      config.checkoutActionConcurrency.getValue();
+  return settings;
+}
+
+void ReloadableConfig::publishHotSettings(const EdenConfig& config) {
+  auto* old = hotSettings_.exchange(
+      new HotSettings{makeHotSettings(config)}, std::memory_order_acq_rel);
+  folly::rcu_retire(old);
+}
 
 std::shared_ptr<const EdenConfig> ReloadableConfig::getEdenConfig(
     ConfigReloadBehavior reload) {
@@ -83,6 +112,7 @@ std::shared_ptr<const EdenConfig> ReloadableConfig::getEdenConfig(
       newConfig->loadSystemConfig();
     }
     state->config = std::move(newConfig);
+    publishHotSettings(*state->config);
   }
   return state->config;
 }
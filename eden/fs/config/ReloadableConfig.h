@@ -39,7 +39,42 @@ class ReloadableConfig {
   std::shared_ptr<const EdenConfig> getEdenConfig(
       ConfigReloadBehavior reload = ConfigReloadBehavior::AutoReload);
 
+  /**
+   * A plain copy of the settings consulted on per-request hot paths.
+   *
+   * This struct is regenerated whenever getEdenConfig() installs a reloaded
+   * EdenConfig.  Add a field here when a setting is read at request rate;
+   * everything else should keep going through getEdenConfig().
+   */
+  struct HotSettings {
+    bool useAuxMetadata{true};
+    uint64_t checkoutActionConcurrency{16};
+  };
+
+  /**
+   * Read the hot-path settings without taking an EdenConfig snapshot.
+   *
+   * getEdenConfig() returns a shared_ptr, and the refcount traffic is
+   * measurable when a setting is consulted on every filesystem request.
+   * This instead copies a small struct out of the current version under an
+   * RCU guard: a pointer load plus thread-local epoch bookkeeping, with the
+   * previous version reclaimed once all readers have moved on.
+   *
+   * Note that this accessor never reloads the config from disk; reloads
+   * happen when getEdenConfig() is called with its usual AutoReload
+   * behavior (e.g. from the Thrift interface or colder code paths).
+   */
+  HotSettings getHotSettings() const;
+
  private:
+  static HotSettings makeHotSettings(const EdenConfig& config);
+
+  /**
+   * Install a new HotSettings generated from config, retiring the previous
+   * version via RCU.
+   */
+  void publishHotSettings(const EdenConfig& config);
+
   struct ConfigState {
     explicit ConfigState(const std::shared_ptr<const EdenConfig>& config)
         : config{config} {}
@@ -49,6 +84,12 @@ class ReloadableConfig {
   folly::Synchronized<ConfigState> state_;
   std::atomic<std::chrono::steady_clock::time_point::rep> lastCheck_{};
 
+  /**
+   * The current hot-path settings.  Written only under state_'s write lock;
+   * read by getHotSettings() under an RCU guard.
+   */
+  std::atomic<HotSettings*> hotSettings_{nullptr};
+
   // Reload behavior, when set this overrides reload behavior passed to methods
   // This is used in tests where we want to set the manually set the EdenConfig
   // and avoid reloading it from disk.
@@ -294,6 +294,58 @@ TEST_F(CheckoutConfigTest, testCheckedOutAndReset) {
       parent);
 }
 
+TEST_F(CheckoutConfigTest, testRepeatedWorkingCopyParentTransitions) {
+  auto config =
+      CheckoutConfig::loadFromClientDirectory(mountPoint_, clientDir_);
+
+  auto checkedOut = RootId{"99887766554433221100aabbccddeeffabcdef99"};
+  config->setCheckedOutCommit(checkedOut);
+
+  // A run of commit transitions, as a rebase would produce, is appended to
+  // the snapshot journal rather than rewriting the SNAPSHOT file each time.
+  std::optional<RootId> parent;
+  for (int i = 0; i < 50; i++) {
+    parent = RootId{fmt::format("{:040x}", i)};
+    config->setWorkingCopyParentCommit(*parent);
+  }
+  EXPECT_TRUE(readFile(config->getSnapshotJournalPath()).hasValue());
+
+  EXPECT_EQ(
+      ParentCommit(ParentCommit::WorkingCopyParentAndCheckedOutRevision{
+          *parent, checkedOut}),
+      config->getParentCommit());
+
+  // A checkout boundary folds the journal back into the SNAPSHOT file.
+  config->setCheckedOutCommit(checkedOut);
+  EXPECT_TRUE(readFile(config->getSnapshotJournalPath()).hasException());
+  EXPECT_EQ(
+      ParentCommit(ParentCommit::WorkingCopyParentAndCheckedOutRevision{
+          checkedOut, checkedOut}),
+      config->getParentCommit());
+}
+
+TEST_F(CheckoutConfigTest, testTornSnapshotJournalTailIsIgnored) {
+  auto config =
+      CheckoutConfig::loadFromClientDirectory(mountPoint_, clientDir_);
+
+  auto checkedOut = RootId{"99887766554433221100aabbccddeeffabcdef99"};
+  auto parent = RootId{"fedcba998887766554433221100ffeeddccbbaa99"};
+  config->setCheckedOutCommit(checkedOut);
+  config->setWorkingCopyParentCommit(parent);
+
+  // Simulate an append interrupted mid-record: the checksummed record before
+  // the torn tail still wins.
+  auto journalPath = config->getSnapshotJournalPath();
+  auto contents = readFile(journalPath).value();
+  contents.append("\x00\x00\x01", 3);
+  writeFile(journalPath, folly::StringPiece{contents}).value();
+
+  EXPECT_EQ(
+      ParentCommit(ParentCommit::WorkingCopyParentAndCheckedOutRevision{
+          parent, checkedOut}),
+      config->getParentCommit());
+}
+
 TEST_F(CheckoutConfigTest, testVersion2ParentHex) {
   auto config =
       CheckoutConfig::loadFromClientDirectory(mountPoint_, clientDir_);
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/config/ReloadableConfig.h"
+
+#include <folly/portability/GTest.h>
+
+#include "eden/fs/config/EdenConfig.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+using namespace facebook::eden;
+using namespace facebook::eden::path_literals;
+
+namespace {
+std::shared_ptr<EdenConfig> makeTestConfig() {
+  auto systemConfigDir = canonicalPath("/etc/eden");
+  return std::make_shared<EdenConfig>(
+      "bob",
+      uid_t{},
+      canonicalPath("/home/bob"),
+      canonicalPath("/home/bob/.edenrc"),
+      systemConfigDir,
+      systemConfigDir + "edenfs.rc"_pc);
+}
+} // namespace
+
+TEST(ReloadableConfigTest, hotSettingsReflectInitialConfig) {
+  auto edenConfig = makeTestConfig();
+  edenConfig->useAuxMetadata.setValue(false, ConfigSource::CommandLine);
+  edenConfig->checkoutActionConcurrency.setValue(7, ConfigSource::CommandLine);
+
+  ReloadableConfig config{edenConfig, ConfigReloadBehavior::NoReload};
+  auto hot = config.getHotSettings();
+  EXPECT_FALSE(hot.useAuxMetadata);
+  EXPECT_EQ(7, hot.checkoutActionConcurrency);
+}
+
+TEST(ReloadableConfigTest, hotSettingsMatchEdenConfigDefaults) {
+  auto edenConfig = makeTestConfig();
+  ReloadableConfig config{edenConfig, ConfigReloadBehavior::NoReload};
+
+  auto hot = config.getHotSettings();
+  EXPECT_EQ(edenConfig->useAuxMetadata.getValue(), hot.useAuxMetadata);
+  EXPECT_EQ(
+      edenConfig->checkoutActionConcurrency.getValue(),
+      hot.checkoutActionConcurrency);
+}
@@ -43,6 +43,12 @@ bool FuseDirList::add(StringPiece name, ino_t inode, dtype_t type, off_t off) {
   return true;
 }
 
+void FuseDirList::assign(StringPiece buf) {
+  XCHECK_LE(buf.size(), capacity());
+  memcpy(buf_.get(), buf.data(), buf.size());
+  cur_ = buf_.get() + buf.size();
+}
+
 StringPiece FuseDirList::getBuf() const {
   return StringPiece(buf_.get(), cur_ - buf_.get());
 }
@@ -42,6 +42,19 @@ class FuseDirList {
    */
   bool add(folly::StringPiece name, ino_t inode, dtype_t type, off_t off);
 
+  /**
+   * The total number of bytes this list can hold.
+   */
+  size_t capacity() const {
+    return end_ - buf_.get();
+  }
+
+  /**
+   * Replace the list's contents with a previously serialized listing, as
+   * returned by getBuf(). The payload must fit within capacity().
+   */
+  void assign(folly::StringPiece buf);
+
   folly::StringPiece getBuf() const;
 
   /**
@@ -15,7 +15,9 @@
 #include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 #include <folly/system/ThreadName.h>
+#include <fcntl.h>
 #include <signal.h>
+#include <sys/ioctl.h>
 #include <chrono>
 #include <type_traits>
 #include "eden/common/utils/Synchronized.h"
@@ -23,6 +25,7 @@
 #include "eden/fs/fuse/FuseDispatcher.h"
 #include "eden/fs/fuse/FuseRequestContext.h"
 #include "eden/fs/telemetry/FsEventLogger.h"
+#include "eden/fs/telemetry/RequestProbes.h"
 #include "eden/fs/utils/Bug.h"
 #include "eden/fs/utils/IDGen.h"
 #include "eden/fs/utils/StaticAssert.h"
@@ -95,7 +98,6 @@ std::string single_string_render(FuseArg arg) {
 }
 
 constexpr RenderFn lookup = single_string_render;
-constexpr RenderFn forget = default_render;
 constexpr RenderFn getattr = default_render;
 constexpr RenderFn setattr = default_render;
 constexpr RenderFn readlink = default_render;
@@ -192,12 +194,6 @@ std::string create(FuseArg arg) {
 
 constexpr RenderFn bmap = default_render;
 
-std::string batchforget(FuseArg arg) {
-  auto& in = arg.read<fuse_batch_forget_in>();
-  // TODO: could print some specific inode values here
-  return fmt::format("count={}", in.count);
-}
-
 std::string fallocate(FuseArg arg) {
   auto& in = arg.read<fuse_fallocate_in>();
   return fmt::format(
@@ -207,16 +203,27 @@ std::string fallocate(FuseArg arg) {
 } // namespace argrender
 
 // These static asserts exist to make explicit the memory usage of the per-mount
-// FUSE TraceBus. TraceBus uses 2 * capacity * sizeof(TraceEvent) memory usage,
-// so limit total memory usage to around 4 MB per mount.
-constexpr size_t kTraceBusCapacity = 25000;
+// FUSE TraceBus. The lossy TraceBus allocates one ring of `capacity` events per
+// publishing thread (the FUSE worker threads plus any executor threads that
+// complete requests), so keep each ring well under 1 MB.
+constexpr size_t kTraceBusCapacity = 8192;
 static_assert(CheckSize<FuseTraceEvent, 72>());
 static_assert(
-    CheckEqual<1800000, kTraceBusCapacity * sizeof(FuseTraceEvent)>());
+    CheckEqual<589824, kTraceBusCapacity * sizeof(FuseTraceEvent)>());
+
+// Bounds the request-tracking map when finish events are dropped by the lossy
+// TraceBus. Entries above this limit would otherwise leak until the channel is
+// destroyed.
+constexpr size_t kMaxOutstandingTracedRequests = 16384;
 
 // This is the minimum size used by libfuse so we use it too!
 constexpr size_t MIN_BUFSIZE = 0x21000;
 
+// Replies at least this large are sent through the splice path when it is
+// enabled; below this the vmsplice+splice syscall pair costs more than the
+// copy it saves.
+constexpr size_t kSpliceReplyThreshold = 16 * 1024;
+
 using Handler = ImmediateFuture<folly::Unit> (FuseChannel::*)(
     FuseRequestContext& request,
     const fuse_in_header& header,
@@ -286,11 +293,10 @@ constexpr auto kFuseHandlers = [] {
       &FuseStats::lookup,
       Read,
       SamplingGroup::Four};
-  handlers[FUSE_FORGET] = {
-      "FUSE_FORGET",
-      &FuseChannel::fuseForget,
-      &argrender::forget,
-      &FuseStats::forget};
+  // FUSE_FORGET and FUSE_BATCH_FORGET are handled specially in
+  // processSession(): they are queued to the background forget thread rather
+  // than dispatched on the worker thread that read them.
+  handlers[FUSE_FORGET] = {"FUSE_FORGET"};
   handlers[FUSE_GETATTR] = {
       "FUSE_GETATTR",
       &FuseChannel::fuseGetAttr,
@@ -467,11 +473,7 @@ constexpr auto kFuseHandlers = [] {
   handlers[FUSE_IOCTL] = {"FUSE_IOCTL"};
   handlers[FUSE_POLL] = {"FUSE_POLL"};
   handlers[FUSE_NOTIFY_REPLY] = {"FUSE_NOTIFY_REPLY"};
-  handlers[FUSE_BATCH_FORGET] = {
-      "FUSE_BATCH_FORGET",
-      &FuseChannel::fuseBatchForget,
-      &argrender::batchforget,
-      &FuseStats::forgetmulti};
+  handlers[FUSE_BATCH_FORGET] = {"FUSE_BATCH_FORGET"};
   handlers[FUSE_FALLOCATE] = {
       "FUSE_FALLOCATE",
       &FuseChannel::fuseFallocate,
@@ -695,14 +697,17 @@ std::ostream& operator<<(
             << ")";
 }
 
-void FuseChannel::replyError(const fuse_in_header& request, int errorCode) {
+void FuseChannel::replyError(
+    int deviceFd,
+    const fuse_in_header& request,
+    int errorCode) {
   fuse_out_header err;
   err.len = sizeof(err);
   err.error = -errorCode;
   err.unique = request.unique;
   XLOG(DBG7) << "replyError unique=" << err.unique << " error=" << errorCode
              << " " << folly::errnoStr(errorCode);
-  auto res = write(fuseDevice_.fd(), &err, sizeof(err));
+  auto res = write(deviceFd, &err, sizeof(err));
   if (res != sizeof(err)) {
     if (res < 0) {
       throwSystemError("replyError: error writing to fuse device");
@@ -713,6 +718,7 @@ void FuseChannel::replyError(const fuse_in_header& request, int errorCode) {
 }
 
 void FuseChannel::sendReply(
+    int deviceFd,
     const fuse_in_header& request,
     folly::fbvector<iovec>&& vec) const {
   fuse_out_header out;
@@ -721,10 +727,11 @@ void FuseChannel::sendReply(
 
   vec.insert(vec.begin(), make_iovec(out));
 
-  sendRawReply(vec.data(), vec.size());
+  sendRawReply(deviceFd, vec.data(), vec.size());
 }
 
 void FuseChannel::sendReply(
+    int deviceFd,
     const fuse_in_header& request,
     const folly::IOBuf& buf) const {
   fuse_out_header out;
@@ -736,10 +743,11 @@ void FuseChannel::sendReply(
   vec.push_back(make_iovec(out));
   buf.appendToIov(&vec);
 
-  sendRawReply(vec.data(), vec.size());
+  sendRawReply(deviceFd, vec.data(), vec.size());
 }
 
 void FuseChannel::sendReply(
+    int deviceFd,
     const fuse_in_header& request,
     folly::ByteRange bytes) const {
   fuse_out_header out;
@@ -752,10 +760,11 @@ void FuseChannel::sendReply(
   iov[1].iov_base = const_cast<uint8_t*>(bytes.data());
   iov[1].iov_len = bytes.size();
 
-  sendRawReply(iov.data(), iov.size());
+  sendRawReply(deviceFd, iov.data(), iov.size());
 }
 
-void FuseChannel::sendRawReply(const iovec iov[], size_t count) const {
+void FuseChannel::sendRawReply(int deviceFd, const iovec iov[], size_t count)
+    const {
   // Ensure that the length is set correctly
   XDCHECK_EQ(iov[0].iov_len, sizeof(fuse_out_header));
   const auto header = reinterpret_cast<fuse_out_header*>(iov[0].iov_base);
@@ -764,7 +773,14 @@ void FuseChannel::sendRawReply(const iovec iov[], size_t count) const {
     header->len += iov[i].iov_len;
   }
 
-  const auto res = writev(fuseDevice_.fd(), iov, count);
+#ifdef __linux__
+  if (useSpliceReplies_ && header->len >= kSpliceReplyThreshold &&
+      trySendSpliceReply(deviceFd, iov, count, header->len)) {
+    return;
+  }
+#endif
+
+  const auto res = writev(deviceFd, iov, count);
   const int err = errno;
   XLOG(DBG7) << "sendRawReply: unique=" << header->unique
              << " header->len=" << header->len << " wrote=" << res;
@@ -782,6 +798,80 @@ void FuseChannel::sendRawReply(const iovec iov[], size_t count) const {
   }
 }
 
+#ifdef __linux__
+std::optional<FuseChannel::ReplyPipe> FuseChannel::borrowReplyPipe() const {
+  {
+    auto pool = replyPipePool_.wlock();
+    if (!pool->empty()) {
+      auto pipe = std::move(pool->back());
+      pool->pop_back();
+      return pipe;
+    }
+  }
+
+  int fds[2];
+  if (pipe2(fds, O_CLOEXEC) != 0) {
+    return std::nullopt;
+  }
+  ReplyPipe pipe{
+      folly::File{fds[0], /*ownsFd=*/true},
+      folly::File{fds[1], /*ownsFd=*/true}};
+  // The whole reply must fit in the pipe: nothing drains the read end while
+  // we fill it, so a too-small pipe would block vmsplice forever.
+  if (fcntl(pipe.writeEnd.fd(), F_SETPIPE_SZ, static_cast<int>(bufferSize_)) <
+      0) {
+    return std::nullopt;
+  }
+  return pipe;
+}
+
+bool FuseChannel::trySendSpliceReply(
+    int deviceFd,
+    const iovec iov[],
+    size_t count,
+    size_t totalLength) const {
+  if (totalLength > bufferSize_) {
+    return false;
+  }
+  auto pipe = borrowReplyPipe();
+  if (!pipe) {
+    return false;
+  }
+
+  // vmsplice maps the reply pages into the pipe rather than copying them, and
+  // SPLICE_F_MOVE below lets the FUSE device take them from the pipe. The
+  // device consumes the message synchronously, so by the time this function
+  // returns the handler may reuse its buffers. SPLICE_F_GIFT is deliberately
+  // not set: the pages still belong to the request handler.
+  auto spliced = vmsplice(pipe->writeEnd.fd(), iov, count, 0);
+  if (spliced != static_cast<ssize_t>(totalLength)) {
+    // A short vmsplice leaves the pipe dirty; drop it on the floor (closing
+    // both ends) and let the caller fall back to writev.
+    return false;
+  }
+
+  auto moved = splice(
+      pipe->readEnd.fd(), nullptr, deviceFd, nullptr, totalLength,
+      SPLICE_F_MOVE);
+  if (moved < 0) {
+    // EINVAL and friends mean the device does not accept splice (for example
+    // the fake devices used in tests); the kernel consumed nothing, so the
+    // writev fallback can safely send the whole reply. Transient errors are
+    // also left to the fallback, which reports them with the usual handling.
+    return false;
+  }
+  if (moved != static_cast<ssize_t>(totalLength)) {
+    // The FUSE device accepts only whole messages, so a short splice should
+    // be impossible; retrying would corrupt the reply stream.
+    throw std::runtime_error("unexpected short splice to FUSE device");
+  }
+
+  // The pipe is empty again; make it available to other reply threads.
+  replyPipePool_.wlock()->push_back(std::move(*pipe));
+  return true;
+}
+#endif // __linux__
+
 FuseChannel::FuseChannel(
     folly::File&& fuseDevice,
     AbsolutePathPiece mountPath,
@@ -795,7 +885,8 @@ FuseChannel::FuseChannel(
     CaseSensitivity caseSensitive,
     bool requireUtf8Path,
     int32_t maximumBackgroundRequests,
-    bool useWriteBackCache)
+    bool useWriteBackCache,
+    bool useSpliceReplies)
     : bufferSize_(std::max(size_t(getpagesize()) + 0x1000, MIN_BUFSIZE)),
       numThreads_(numThreads),
       dispatcher_(std::move(dispatcher)),
@@ -807,10 +898,11 @@ FuseChannel::FuseChannel(
       requireUtf8Path_{requireUtf8Path},
       maximumBackgroundRequests_{maximumBackgroundRequests},
       useWriteBackCache_{useWriteBackCache},
+      useSpliceReplies_{useSpliceReplies},
       fuseDevice_(std::move(fuseDevice)),
       processAccessLog_(std::move(processNameCache)),
       traceDetailedArguments_(std::make_shared<std::atomic<size_t>>(0)),
-      traceBus_(TraceBus<FuseTraceEvent>::create(
+      traceBus_(TraceBus<FuseTraceEvent>::createLossy(
           "FuseTrace" + mountPath.asString(),
           kTraceBusCapacity)) {
   XCHECK_GE(numThreads_, 1ul);
@@ -823,13 +915,17 @@ FuseChannel::FuseChannel(
         switch (event.getType()) {
           case FuseTraceEvent::START: {
             auto state = telemetryState_.wlock();
-            auto [iter, inserted] = state->requests.emplace(
+            if (state->requests.size() >= kMaxOutstandingTracedRequests) {
+              // If finish events were dropped by the lossy TraceBus their
+              // start entries can accumulate; cap the map rather than leak.
+              break;
+            }
+            state->requests.emplace(
                 event.getUnique(),
                 OutstandingRequest{
                     event.getUnique(),
                     event.getRequest(),
                     event.monotonicTime});
-            XCHECK(inserted) << "duplicate fuse start event";
             break;
           }
           case FuseTraceEvent::FINISH: {
@@ -837,8 +933,11 @@ FuseChannel::FuseChannel(
             {
               auto state = telemetryState_.wlock();
               auto it = state->requests.find(event.getUnique());
-              XCHECK(it != state->requests.end())
-                  << "duplicate fuse finish event";
+              if (it == state->requests.end()) {
+                // The matching start event was dropped by the lossy TraceBus;
+                // there is nothing to pair this finish with.
+                break;
+              }
               durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
                   event.monotonicTime - it->second.requestStartTime);
               state->requests.erase(it);
@@ -907,11 +1006,13 @@ void FuseChannel::startWorkerThreads() {
     }
 
     invalidationThread_ = std::thread([this] { invalidationThread(); });
+    forgetThread_ = std::thread([this] { forgetThread(); });
   } catch (const std::exception& ex) {
     XLOG(ERR) << "Error starting FUSE worker threads: " << exceptionStr(ex);
     // Request any threads we did start to stop now.
     requestSessionExit(state, StopReason::INIT_FAILED);
     stopInvalidationThread();
+    stopForgetThread();
     throw;
   }
 }
@@ -1244,6 +1345,33 @@ void FuseChannel::initWorkerThread() noexcept {
   fuseWorkerThread();
 }
 
+folly::File FuseChannel::cloneFuseDevice() {
+#ifdef __linux__
+  try {
+    folly::File clonedDevice{"/dev/fuse", O_RDWR | O_CLOEXEC};
+    // The ioctl argument is the descriptor of the session to attach to.
+    uint32_t sourceFd = fuseDevice_.fd();
+    if (ioctl(clonedDevice.fd(), FUSE_DEV_IOC_CLONE, &sourceFd) == 0) {
+      return clonedDevice;
+    }
+    // Kernels older than 4.2, or a fake device in tests. Log once; every
+    // worker will fail the same way.
+    folly::call_once(cloneUnsupportedLogFlag_, [&] {
+      XLOG(DBG2) << "FUSE_DEV_IOC_CLONE not available for " << mountPath_
+                 << ": " << folly::errnoStr(errno)
+                 << "; worker threads will share one device";
+    });
+  } catch (const std::exception& ex) {
+    folly::call_once(cloneUnsupportedLogFlag_, [&] {
+      XLOG(DBG2) << "unable to open /dev/fuse to clone the session for "
+                 << mountPath_ << ": " << exceptionStr(ex)
+                 << "; worker threads will share one device";
+    });
+  }
+#endif
+  return folly::File{};
+}
+
 void FuseChannel::fuseWorkerThread() noexcept {
   disablePthreadCancellation();
   setThreadName(fmt::format("fuse{}", mountPath_.basename()));
@@ -1251,8 +1379,19 @@ void FuseChannel::fuseWorkerThread() noexcept {
   *(liveRequestWatches_.get()) =
       std::make_shared<RequestMetricsScope::LockedRequestWatchList>();
 
+  // Read from a cloned device when the kernel supports it, so each worker
+  // has its own kernel request queue instead of all workers contending on
+  // the main device. Replies to requests read from a clone must be written
+  // back to that clone, so the descriptor is threaded through processSession
+  // into each request.
+  int deviceFd = fuseDevice_.fd();
+  if (auto clonedDevice = cloneFuseDevice()) {
+    deviceFd = clonedDevice.fd();
+    clonedDevices_.wlock()->push_back(std::move(clonedDevice));
+  }
+
   try {
-    processSession();
+    processSession(deviceFd);
   } catch (const std::exception& ex) {
     XLOG(ERR) << "unexpected error in FUSE worker thread: " << exceptionStr(ex);
     // Request that all other FUSE threads exit.
@@ -1333,6 +1472,52 @@ void FuseChannel::stopInvalidationThread() {
   invalidationThread_.join();
 }
 
+void FuseChannel::forgetThread() noexcept {
+  setThreadName(fmt::format("forget{}", mountPath_.basename()));
+
+  // FORGET and BATCH_FORGET requests are processed in this dedicated thread
+  // rather than inline in processSession().  A large inode unload sweep can
+  // emit hundreds of thousands of forgets in quick succession; draining them
+  // on the worker threads would leave no thread blocked in read() on the fuse
+  // device, delaying interactive requests until the storm subsides.
+  while (true) {
+    // Wait for entries to process
+    std::vector<ForgetEntry> entries;
+    {
+      auto lockedQueue = forgetQueue_.lock();
+      while (lockedQueue->queue.empty()) {
+        if (lockedQueue->stop) {
+          return;
+        }
+        forgetCV_.wait(lockedQueue.as_lock());
+      }
+      lockedQueue->queue.swap(entries);
+    }
+
+    // Process all of the entries we found
+    auto* stats = dispatcher_->getStats();
+    for (const auto& entry : entries) {
+      auto start = std::chrono::steady_clock::now();
+      dispatcher_->forget(entry.inode, entry.nlookup);
+      stats->addDuration(
+          &FuseStats::forget, std::chrono::steady_clock::now() - start);
+    }
+    entries.clear();
+  }
+}
+
+void FuseChannel::stopForgetThread() {
+  // Check that the thread is joinable just in case we were destroyed
+  // before the forget thread was started.
+  if (!forgetThread_.joinable()) {
+    return;
+  }
+
+  forgetQueue_.lock()->stop = true;
+  forgetCV_.notify_one();
+  forgetThread_.join();
+}
+
 void FuseChannel::readInitPacket() {
   struct {
     fuse_in_header header;
@@ -1399,7 +1584,7 @@ void FuseChannel::readInitPacket() {
   }
 
   if (init.header.opcode != FUSE_INIT) {
-    replyError(init.header, EPROTO);
+    replyError(fuseDevice_.fd(), init.header, EPROTO);
     throw_<std::runtime_error>(
         "expected to receive FUSE_INIT for \"",
         mountPath_,
@@ -1487,6 +1672,13 @@ void FuseChannel::readInitPacket() {
 #else
   (void)caseSensitive_;
 #endif
+#ifdef __linux__
+  if (useSpliceReplies_) {
+    // Large replies are moved into the kernel through a pipe instead of
+    // being copied by writev; see trySendSpliceReply().
+    want |= FUSE_SPLICE_WRITE | FUSE_SPLICE_MOVE;
+  }
+#endif
 
   // Only return the capabilities the kernel supports.
   want &= capable;
@@ -1500,7 +1692,7 @@ void FuseChannel::readInitPacket() {
              << ", want=" << capsFlagsToLabel(want);
 
   if (init.init.major != FUSE_KERNEL_VERSION) {
-    replyError(init.header, EPROTO);
+    replyError(fuseDevice_.fd(), init.header, EPROTO);
     throw_<std::runtime_error>(
         "Unsupported FUSE kernel version ",
         init.init.major,
@@ -1525,7 +1717,7 @@ void FuseChannel::readInitPacket() {
       FUSE_KERNEL_MINOR_VERSION > 22,
       "Your kernel headers are too old to build Eden.");
   if (init.init.minor > 22) {
-    sendReply(init.header, connInfo);
+    sendReply(fuseDevice_.fd(), init.header, connInfo);
   } else {
     // If the protocol version predates the expansion of fuse_init_out, only
     // send the start of the packet.
@@ -1541,13 +1733,13 @@ void FuseChannel::readInitPacket() {
       FUSE_KERNEL_MINOR_VERSION == 19,
       "osxfuse: API/ABI likely changed, may need something like the"
       " linux code above to send the correct response to the kernel");
-  sendReply(init.header, connInfo);
+  sendReply(fuseDevice_.fd(), init.header, connInfo);
 #endif
 
   dispatcher_->initConnection(connInfo);
 }
 
-void FuseChannel::processSession() {
+void FuseChannel::processSession(int deviceFd) {
   std::vector<char> buf(bufferSize_);
   // Save this for the sanity check later in the loop to avoid
   // additional syscalls on each loop iteration.
@@ -1556,7 +1748,7 @@ void FuseChannel::processSession() {
   while (!stop_.load(std::memory_order_relaxed)) {
     // TODO: FUSE_SPLICE_READ allows using splice(2) here if we enable it.
     // We can look at turning this on once the main plumbing is complete.
-    auto res = read(fuseDevice_.fd(), buf.data(), buf.size());
+    auto res = read(deviceFd, buf.data(), buf.size());
     if (UNLIKELY(res < 0)) {
       int error = errno;
       if (stop_.load(std::memory_order_relaxed)) {
@@ -1642,7 +1834,7 @@ void FuseChannel::processSession() {
       bool matched = false;
       for (auto fastTrack : kFastTracks) {
         if (namePiece == fastTrack) {
-          replyError(*header, ENODATA);
+          replyError(deviceFd, *header, ENODATA);
           matched = true;
           break;
         }
@@ -1661,7 +1853,7 @@ void FuseChannel::processSession() {
     // to resolve this deadlock on kernel inode locks without rebooting the
     // system.
     if (UNLIKELY(static_cast<pid_t>(header->pid) == myPid)) {
-      replyError(*header, EIO);
+      replyError(deviceFd, *header, EIO);
       XLOG(CRITICAL) << "Received FUSE request from our own pid: opcode="
                      << header->opcode << " nodeid=" << header->nodeid
                      << " pid=" << header->pid;
@@ -1675,7 +1867,7 @@ void FuseChannel::processSession() {
 
     switch (header->opcode) {
       case FUSE_INIT:
-        replyError(*header, EPROTO);
+        replyError(deviceFd, *header, EPROTO);
         throw std::runtime_error(
             "received FUSE_INIT after we have been initialized!?");
 
@@ -1685,7 +1877,7 @@ void FuseChannel::processSession() {
         // Deliberately not handling locking; this causes
         // the kernel to do it for us
         XLOG(DBG7) << fuseOpcodeName(header->opcode);
-        replyError(*header, ENOSYS);
+        replyError(deviceFd, *header, ENOSYS);
         break;
 
 #ifdef __linux__
@@ -1694,23 +1886,39 @@ void FuseChannel::processSession() {
         // for us.  Returning ENOSYS causes the kernel to implement it for us,
         // and will cause it to stop sending subsequent FUSE_LSEEK requests.
         XLOG(DBG7) << "FUSE_LSEEK";
-        replyError(*header, ENOSYS);
+        replyError(deviceFd, *header, ENOSYS);
         break;
 #endif
 
       case FUSE_POLL:
         // We do not currently implement FUSE_POLL.
         XLOG(DBG7) << "FUSE_POLL";
-        replyError(*header, ENOSYS);
+        replyError(deviceFd, *header, ENOSYS);
         break;
 
       case FUSE_INTERRUPT: {
         // no reply is required
         XLOG(DBG7) << "FUSE_INTERRUPT";
-        // Ignore it: we don't have a reliable way to guarantee
-        // that interrupting functions correctly.
-        // In addition, the kernel (certainly on macOS) may recycle
-        // ids too quickly for us to safely track by `unique` id.
+        // We don't have a reliable way to abort the dispatched handler
+        // itself, but we can signal cancellation to the request's fetch
+        // context so backing stores drop still-queued imports that no one
+        // is waiting for anymore. The cancellation is advisory: a fetch
+        // proceeds as long as any non-cancelled subscriber wants it, so a
+        // stale or recycled unique id cannot fail an unrelated request on
+        // its own.
+        const auto* interrupt =
+            reinterpret_cast<const fuse_interrupt_in*>(arg.data());
+        FsObjectFetchContextPtr context;
+        {
+          auto contexts = liveRequestContexts_.lock();
+          auto it = contexts->find(interrupt->unique);
+          if (it != contexts->end()) {
+            context = it->second.copy();
+          }
+        }
+        if (context) {
+          context->requestCancellation();
+        }
         break;
       }
 
@@ -1722,7 +1930,7 @@ void FuseChannel::processSession() {
         // we have responded, which in turn blocks our attempt to gracefully
         // unmount, so we respond here.  It doesn't hurt Linux to respond
         // so we do it for both platforms.
-        replyError(*header, 0);
+        replyError(deviceFd, *header, 0);
         break;
 
       case FUSE_NOTIFY_REPLY:
@@ -1735,8 +1943,41 @@ void FuseChannel::processSession() {
       case FUSE_IOCTL:
         // Rather than the default ENOSYS, we need to return ENOTTY
         // to indicate that the requested ioctl is not supported
-        replyError(*header, ENOTTY);
+        replyError(deviceFd, *header, ENOTTY);
+        break;
+
+      case FUSE_FORGET: {
+        auto forget = reinterpret_cast<const fuse_forget_in*>(arg.data());
+        XLOG(DBG7) << "FUSE_FORGET inode=" << header->nodeid
+                   << " nlookup=" << forget->nlookup;
+        // No reply is ever sent for FORGET; queue it for the forget thread
+        // so that forget storms do not tie up the worker threads.
+        forgetQueue_.lock()->queue.push_back(
+            ForgetEntry{InodeNumber{header->nodeid}, forget->nlookup});
+        dispatcher_->getStats()->increment(&FuseStats::forgetsQueued);
+        forgetCV_.notify_one();
+        break;
+      }
+
+      case FUSE_BATCH_FORGET: {
+        const auto forgets =
+            reinterpret_cast<const fuse_batch_forget_in*>(arg.data());
+        auto item = reinterpret_cast<const fuse_forget_one*>(forgets + 1);
+        const auto end = item + forgets->count;
+        XLOG(DBG7) << "FUSE_BATCH_FORGET count=" << forgets->count;
+        {
+          auto lockedQueue = forgetQueue_.lock();
+          while (item != end) {
+            lockedQueue->queue.push_back(
+                ForgetEntry{InodeNumber{item->nodeid}, item->nlookup});
+            ++item;
+          }
+        }
+        dispatcher_->getStats()->increment(
+            &FuseStats::forgetsQueued, forgets->count);
+        forgetCV_.notify_one();
         break;
+      }
 
       default: {
         if (handlerEntry && handlerEntry->handler) {
@@ -1752,10 +1993,15 @@ void FuseChannel::processSession() {
           // This is a shared_ptr because, due to timeouts, the internal request
           // lifetime may not match the FUSE request lifetime, so we capture it
           // in both. I'm sure this could be improved with some cleverness.
-          auto request = std::make_shared<FuseRequestContext>(this, *header);
+          auto request =
+              std::make_shared<FuseRequestContext>(this, deviceFd, *header);
 
           ++state_.wlock()->pendingRequests;
 
+          // Make the request's fetch context reachable from FUSE_INTERRUPT.
+          liveRequestContexts_.lock()->emplace(
+              header->unique, request->getFsObjectFetchContextPtr().copy());
+
           auto headerCopy = *header;
 
           FB_LOG(*straceLogger_, DBG7, ([&]() -> std::string {
@@ -1774,6 +2020,19 @@ void FuseChannel::processSession() {
           request
               ->catchErrors(
                   folly::makeFutureWith([&] {
+                    // Annotate the synchronous portion of the handler for
+                    // CPU profilers; by the time the returned future runs
+                    // continuations on other threads the heavy inline work
+                    // (cache hits, overlay reads) has already happened.
+                    RequestAnnotationScope annotationScope{
+                        requestId,
+                        headerCopy.opcode,
+                        static_cast<uint32_t>(ObjectFetchContext::Cause::Fs)};
+                    EDEN_SDT(
+                        fuse_request_start,
+                        headerCopy.opcode,
+                        headerCopy.nodeid,
+                        requestId);
                     request->startRequest(
                         dispatcher_->getStats(),
                         handlerEntry->stat,
@@ -1786,6 +2045,9 @@ void FuseChannel::processSession() {
                     }).within(requestTimeout_),
                   notifier_.get())
               .ensure([this, request, requestId, headerCopy] {
+                liveRequestContexts_.lock()->erase(headerCopy.unique);
+
+                EDEN_SDT(fuse_request_finish, headerCopy.opcode, requestId);
                 traceBus_->publish(FuseTraceEvent::finish(
                     requestId, headerCopy, request->getResult()));
 
@@ -1819,7 +2081,7 @@ void FuseChannel::processSession() {
             });
 
         try {
-          replyError(*header, ENOSYS);
+          replyError(deviceFd, *header, ENOSYS);
         } catch (const std::system_error& exc) {
           XLOG(ERR) << "Failed to write error response to fuse: " << exc.what();
           requestSessionExit(StopReason::FUSE_WRITE_ERROR);
@@ -1852,6 +2114,11 @@ void FuseChannel::sessionComplete(folly::Synchronized<State>::LockedPtr state) {
   // processed until all outstanding requests complete.
   stopInvalidationThread();
 
+  // Stop the forget thread.  Like the invalidation thread, it drains any
+  // queued entries before exiting, so forgets read before shutdown are still
+  // applied to the inode map.
+  stopForgetThread();
+
   // Fulfill sessionCompletePromise
   sessionCompletePromise_.setValue(std::move(data));
 
@@ -1872,7 +2139,13 @@ ImmediateFuture<folly::Unit> FuseChannel::fuseRead(
   auto ino = InodeNumber{header.nodeid};
   return dispatcher_
       ->read(ino, read->size, read->offset, request.getObjectFetchContext())
-      .thenValue([&request](BufVec&& buf) { request.sendReply(*buf); });
+      .thenValue([&request, this, pid = header.pid](BufVec&& buf) {
+        processAccessLog_.recordBytes(
+            pid,
+            ProcessAccessLog::AccessType::FsChannelRead,
+            buf->computeChainDataLength());
+        request.sendReply(*buf);
+      });
 }
 
 ImmediateFuture<folly::Unit> FuseChannel::fuseWrite(
@@ -1894,7 +2167,9 @@ ImmediateFuture<folly::Unit> FuseChannel::fuseWrite(
           folly::StringPiece{bufPtr, write->size},
           write->offset,
           request.getObjectFetchContext())
-      .thenValue([&request](size_t written) {
+      .thenValue([&request, this, pid = header.pid](size_t written) {
+        processAccessLog_.recordBytes(
+            pid, ProcessAccessLog::AccessType::FsChannelWrite, written);
         fuse_write_out out = {};
         out.size = written;
         request.sendReply(out);
@@ -1932,18 +2207,6 @@ ImmediateFuture<folly::Unit> FuseChannel::fuseLookup(
       });
 }
 
-ImmediateFuture<folly::Unit> FuseChannel::fuseForget(
-    FuseRequestContext& request,
-    const fuse_in_header& header,
-    ByteRange arg) {
-  auto forget = reinterpret_cast<const fuse_forget_in*>(arg.data());
-  XLOG(DBG7) << "FUSE_FORGET inode=" << header.nodeid
-             << " nlookup=" << forget->nlookup;
-  dispatcher_->forget(InodeNumber{header.nodeid}, forget->nlookup);
-  request.replyNone();
-  return folly::unit;
-}
-
 ImmediateFuture<folly::Unit> FuseChannel::fuseGetAttr(
     FuseRequestContext& request,
     const fuse_in_header& header,
@@ -2438,24 +2701,6 @@ ImmediateFuture<folly::Unit> FuseChannel::fuseBmap(
       });
 }
 
-ImmediateFuture<folly::Unit> FuseChannel::fuseBatchForget(
-    FuseRequestContext& request,
-    const fuse_in_header& /*header*/,
-    ByteRange arg) {
-  const auto forgets =
-      reinterpret_cast<const fuse_batch_forget_in*>(arg.data());
-  auto item = reinterpret_cast<const fuse_forget_one*>(forgets + 1);
-  const auto end = item + forgets->count;
-  XLOG(DBG7) << "FUSE_BATCH_FORGET";
-
-  while (item != end) {
-    dispatcher_->forget(InodeNumber{item->nodeid}, item->nlookup);
-    ++item;
-  }
-  request.replyNone();
-  return folly::unit;
-}
-
 ImmediateFuture<folly::Unit> FuseChannel::fuseFallocate(
     FuseRequestContext& request,
     const fuse_in_header& header,
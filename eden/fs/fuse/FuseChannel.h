@@ -26,6 +26,7 @@
 
 #include "eden/fs/fuse/FuseDispatcher.h"
 #include "eden/fs/inodes/InodeNumber.h"
+#include "eden/fs/inodes/RequestContext.h"
 #include "eden/fs/telemetry/RequestMetricsScope.h"
 #include "eden/fs/telemetry/TraceBus.h"
 #include "eden/fs/utils/CaseSensitivity.h"
@@ -238,7 +239,8 @@ class FuseChannel {
       CaseSensitivity caseSensitive,
       bool requireUtf8Path,
       int32_t maximumBackgroundRequests,
-      bool useWriteBackCache);
+      bool useWriteBackCache,
+      bool useSpliceReplies);
 
   /**
    * Destroy the FuseChannel.
@@ -364,10 +366,15 @@ class FuseChannel {
    * status (no additional payload).
    * `err` may be 0 (indicating success) or a positive errno value.
    *
+   * `deviceFd` identifies the FUSE device the request was read from. With
+   * cloned devices (FUSE_DEV_IOC_CLONE) the kernel tracks each in-flight
+   * request on the device it was read from, so every reply method takes the
+   * originating descriptor and must write the reply there.
+   *
    * throws system_error if the write fails.  Writes can fail if the
    * data we send to the kernel is invalid.
    */
-  void replyError(const fuse_in_header& request, int err);
+  void replyError(int deviceFd, const fuse_in_header& request, int err);
 
   /**
    * Sends a raw data packet to the kernel.
@@ -380,7 +387,7 @@ class FuseChannel {
    * throws system_error if the write fails.  Writes can fail if the
    * data we send to the kernel is invalid.
    */
-  void sendRawReply(const iovec iov[], size_t count) const;
+  void sendRawReply(int deviceFd, const iovec iov[], size_t count) const;
 
   /**
    * Sends a range of contiguous bytes as a reply to the kernel.
@@ -391,11 +398,16 @@ class FuseChannel {
    * throws system_error if the write fails.  Writes can fail if the
    * data we send to the kernel is invalid.
    */
-  void sendReply(const fuse_in_header& request, folly::ByteRange bytes) const;
+  void sendReply(
+      int deviceFd,
+      const fuse_in_header& request,
+      folly::ByteRange bytes) const;
 
-  void sendReply(const fuse_in_header& request, folly::StringPiece bytes)
-      const {
-    sendReply(request, folly::ByteRange{bytes});
+  void sendReply(
+      int deviceFd,
+      const fuse_in_header& request,
+      folly::StringPiece bytes) const {
+    sendReply(deviceFd, request, folly::ByteRange{bytes});
   }
 
   /**
@@ -407,8 +419,10 @@ class FuseChannel {
    * throws system_error if the write fails.  Writes can fail if the
    * data we send to the kernel is invalid.
    */
-  void sendReply(const fuse_in_header& request, folly::fbvector<iovec>&& vec)
-      const;
+  void sendReply(
+      int deviceFd,
+      const fuse_in_header& request,
+      folly::fbvector<iovec>&& vec) const;
 
   /**
    * Sends a reply to a kernel request potentially consisting of multiple
@@ -417,7 +431,10 @@ class FuseChannel {
    * throws system_error if the write fails.  Writes can fail if the
    * data we send to the kernel is invalid.
    */
-  void sendReply(const fuse_in_header& request, const folly::IOBuf& buf) const;
+  void sendReply(
+      int deviceFd,
+      const fuse_in_header& request,
+      const folly::IOBuf& buf) const;
 
   /**
    * Sends a reply to the kernel.
@@ -428,10 +445,12 @@ class FuseChannel {
    * data we send to the kernel is invalid.
    */
   template <typename T>
-  void sendReply(const fuse_in_header& request, const T& payload) const {
+  void sendReply(int deviceFd, const fuse_in_header& request, const T& payload)
+      const {
     static_assert(std::is_standard_layout_v<T>);
     static_assert(std::is_trivial_v<T>);
     sendReply(
+        deviceFd,
         request,
         folly::ByteRange{
             reinterpret_cast<const uint8_t*>(&payload), sizeof(T)});
@@ -548,6 +567,23 @@ class FuseChannel {
     std::vector<InvalidationEntry> queue;
     bool stop{false};
   };
+
+  /**
+   * A single deferred FUSE_FORGET, or one element of a FUSE_BATCH_FORGET.
+   *
+   * FORGET requests never receive a reply; they exist only to decrement the
+   * kernel's lookup count on an inode. That makes them safe to process out of
+   * band: the counts are cumulative, so deferring a forget past a later
+   * request can never make the bookkeeping wrong.
+   */
+  struct ForgetEntry {
+    InodeNumber inode;
+    uint64_t nlookup;
+  };
+  struct ForgetQueue {
+    std::vector<ForgetEntry> queue;
+    bool stop{false};
+  };
   friend std::ostream& operator<<(
       std::ostream& os,
       const InvalidationEntry& entry);
@@ -577,10 +613,6 @@ class FuseChannel {
       FuseRequestContext& request,
       const fuse_in_header& header,
       folly::ByteRange arg);
-  ImmediateFuture<folly::Unit> fuseForget(
-      FuseRequestContext& request,
-      const fuse_in_header& header,
-      folly::ByteRange arg);
   ImmediateFuture<folly::Unit> fuseGetAttr(
       FuseRequestContext& request,
       const fuse_in_header& header,
@@ -685,10 +717,6 @@ class FuseChannel {
       FuseRequestContext& request,
       const fuse_in_header& header,
       folly::ByteRange arg);
-  ImmediateFuture<folly::Unit> fuseBatchForget(
-      FuseRequestContext& request,
-      const fuse_in_header& header,
-      folly::ByteRange arg);
   ImmediateFuture<folly::Unit> fuseFallocate(
       FuseRequestContext& request,
       const fuse_in_header& header,
@@ -700,6 +728,8 @@ class FuseChannel {
   void fuseWorkerThread() noexcept;
   void invalidationThread() noexcept;
   void stopInvalidationThread();
+  void forgetThread() noexcept;
+  void stopForgetThread();
   void sendInvalidation(InvalidationEntry& entry);
   void sendInvalidateInode(InodeNumber ino, int64_t off, int64_t len);
   void sendInvalidateEntry(InodeNumber parent, PathComponentPiece name);
@@ -732,8 +762,49 @@ class FuseChannel {
    * This function blocks until the fuse session is stopped.
    * The intent is that this is called from each of the
    * fuse worker threads provided by the MountPoint.
+   *
+   * `deviceFd` is the descriptor this worker reads requests from: its own
+   * cloned device when FUSE_DEV_IOC_CLONE is available, otherwise the shared
+   * fuseDevice_.
    */
-  void processSession();
+  void processSession(int deviceFd);
+
+  /**
+   * A pipe pair used by the splice reply path; see trySendSpliceReply().
+   */
+  struct ReplyPipe {
+    folly::File readEnd;
+    folly::File writeEnd;
+  };
+
+  /**
+   * Attempts to send a large reply through a pipe with vmsplice(2) and
+   * splice(2) rather than writev(2), mapping the reply pages into the kernel
+   * instead of copying them. Returns false without having written anything
+   * if the splice path is unavailable (non-pipe-friendly device, resource
+   * exhaustion), in which case the caller falls back to writev. Only
+   * implemented on Linux.
+   */
+  bool trySendSpliceReply(
+      int deviceFd,
+      const iovec iov[],
+      size_t count,
+      size_t totalLength) const;
+
+  /**
+   * Takes a pipe from replyPipePool_, creating one if the pool is empty.
+   * Returns nullopt if a pipe cannot be created or sized to bufferSize_.
+   */
+  std::optional<ReplyPipe> borrowReplyPipe() const;
+
+  /**
+   * Attempts to clone the FUSE device with FUSE_DEV_IOC_CLONE so each worker
+   * thread can read requests from its own descriptor, with its own kernel
+   * queue, rather than all workers contending on one device. Returns an
+   * invalid File if the kernel does not support cloning (or on non-Linux
+   * platforms, and for the fake devices used in tests).
+   */
+  folly::File cloneFuseDevice();
 
   /**
    * Requests that the worker threads terminate their processing loop.
@@ -757,6 +828,7 @@ class FuseChannel {
   bool requireUtf8Path_;
   int32_t maximumBackgroundRequests_;
   bool useWriteBackCache_;
+  bool useSpliceReplies_;
 
   /*
    * connInfo_ is modified during the initialization process,
@@ -782,12 +854,31 @@ class FuseChannel {
    */
   folly::File fuseDevice_;
 
+  /*
+   * Per-worker clones of fuseDevice_, pushed by each worker thread as it
+   * starts. In-flight requests hold the raw descriptor of the device they
+   * were read from so their replies reach the right kernel queue, and those
+   * replies may be sent after the worker thread has exited; the clones are
+   * therefore kept open until the FuseChannel is destroyed. Not transferred
+   * on takeover: the new process re-clones from the main device.
+   */
+  folly::Synchronized<std::vector<folly::File>> clonedDevices_;
+
+  /*
+   * Idle pipes reused by the splice reply path. Pipes are borrowed for the
+   * duration of one reply and returned empty; a pipe that hits an error is
+   * dropped instead of returned. mutable because replies are sent from const
+   * methods.
+   */
+  mutable folly::Synchronized<std::vector<ReplyPipe>> replyPipePool_;
+
   /*
    * Mutable state that is accessed from the worker threads.
    * All of this state uses locking or other synchronization.
    */
   std::atomic<bool> stop_{false};
   folly::once_flag unmountLogFlag_;
+  folly::once_flag cloneUnsupportedLogFlag_;
   folly::Synchronized<State> state_;
   folly::Promise<StopFuture> initPromise_;
   folly::Promise<StopData> sessionCompletePromise_;
@@ -797,12 +888,35 @@ class FuseChannel {
   // To prevent logging unsupported opcodes twice.
   folly::Synchronized<std::unordered_set<FuseOpcode>> unhandledOpcodes_;
 
+  /*
+   * Fetch contexts of requests currently being dispatched, keyed by the
+   * kernel's unique request id so FUSE_INTERRUPT can signal cancellation to
+   * the object fetches the request is waiting on. Entries are inserted
+   * before dispatch and erased when the request completes, so an interrupt
+   * for an already-finished request is a no-op. Should the kernel recycle a
+   * unique id, the worst case is a spurious cancellation signal on an
+   * unrelated request's fetches, which only has an effect if every other
+   * subscriber of those fetches has also abandoned them.
+   */
+  folly::Synchronized<
+      std::unordered_map<uint64_t, FsObjectFetchContextPtr>,
+      std::mutex>
+      liveRequestContexts_;
+
   // State for sending inode invalidation requests to the kernel
   // These are processed in their own dedicated thread.
   folly::Synchronized<InvalidationQueue, std::mutex> invalidationQueue_;
   std::condition_variable invalidationCV_;
   std::thread invalidationThread_;
 
+  // The background lane for FORGET and BATCH_FORGET requests.
+  // processSession() queues them here instead of dispatching them inline so
+  // that a forget storm (e.g. a large inode unload sweep) cannot occupy every
+  // worker thread and delay interactive requests such as lookups.
+  folly::Synchronized<ForgetQueue, std::mutex> forgetQueue_;
+  std::condition_variable forgetCV_;
+  std::thread forgetThread_;
+
   ProcessAccessLog processAccessLog_;
 
   // this tracks metrics for live FUSE requests, this is a thread local
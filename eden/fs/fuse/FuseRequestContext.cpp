@@ -21,6 +21,7 @@ namespace facebook::eden {
 
 FuseRequestContext::FuseRequestContext(
     FuseChannel* channel,
+    int deviceFd,
     const fuse_in_header& fuseHeader)
     : RequestContext(
           channel->getProcessAccessLog(),
@@ -28,6 +29,7 @@ FuseRequestContext::FuseRequestContext(
               static_cast<pid_t>(fuseHeader.pid),
               fuseHeader.opcode)),
       channel_(channel),
+      deviceFd_(deviceFd),
       fuseHeader_(fuseHeader) {}
 
 fuse_in_header FuseRequestContext::stealReqWithResult(int64_t result) {
@@ -82,11 +84,7 @@ void FuseRequestContext::timeoutErrorHandler(
 
 void FuseRequestContext::replyError(int err) {
   XCHECK(err >= 0) << "errno values are positive";
-  channel_->replyError(stealReqWithResult(-err), err);
-}
-
-void FuseRequestContext::replyNone() {
-  stealReqWithResult(0);
+  channel_->replyError(deviceFd_, stealReqWithResult(-err), err);
 }
 
 } // namespace facebook::eden
@@ -48,8 +48,14 @@ class FuseObjectFetchContext : public FsObjectFetchContext {
  */
 class FuseRequestContext : public RequestContext {
  public:
+  /**
+   * `deviceFd` is the FUSE device descriptor this request was read from.
+   * With cloned devices the kernel tracks the in-flight request on that
+   * descriptor, so the reply must be written back to the same one.
+   */
   explicit FuseRequestContext(
       FuseChannel* channel,
+      int deviceFd,
       const fuse_in_header& fuseHeader);
 
   FuseRequestContext(const FuseRequestContext&) = delete;
@@ -111,7 +117,8 @@ class FuseRequestContext : public RequestContext {
 
   template <typename... T>
   void sendReply(T&&... payload) {
-    channel_->sendReply(stealReqWithResult(0), std::forward<T>(payload)...);
+    channel_->sendReply(
+        deviceFd_, stealReqWithResult(0), std::forward<T>(payload)...);
   }
 
   /**
@@ -121,21 +128,20 @@ class FuseRequestContext : public RequestContext {
    */
   template <typename T>
   void sendReplyWithInode(uint64_t nodeid, T&& reply) {
-    channel_->sendReply(stealReqWithResult(nodeid), std::forward<T>(reply));
+    channel_->sendReply(
+        deviceFd_, stealReqWithResult(nodeid), std::forward<T>(reply));
   }
 
   // Reply with a negative errno value or 0 for success
   void replyError(int err);
 
-  // Don't send a reply, just release req_
-  void replyNone();
-
  private:
   // Returns the header and sets result_ to indicate
   // that the request has been released.
   fuse_in_header stealReqWithResult(int64_t result);
 
   FuseChannel* channel_;
+  const int deviceFd_;
   const fuse_in_header fuseHeader_;
 
   std::optional<int64_t> result_;
@@ -146,6 +146,15 @@ class PrivHelperClientImpl : public PrivHelper,
     UnixSocket::UniquePtr conn_;
   };
 
+  /**
+   * A request waiting to be handed to the EventBase thread.
+   */
+  struct QueuedRequest {
+    uint32_t xid;
+    UnixSocket::Message msg;
+    folly::Promise<UnixSocket::Message> promise;
+  };
+
   uint32_t getNextXid() {
     return nextXid_.fetch_add(1, std::memory_order_acq_rel);
   }
@@ -198,6 +207,13 @@ class PrivHelperClientImpl : public PrivHelper,
 
   /**
    * Send a request and wait for the response.
+   *
+   * Requests are queued and handed to the EventBase in batches: only the
+   * request that finds the queue empty pays for an EventBase wakeup, the
+   * rest piggyback on the already-scheduled drain. When many privileged
+   * operations are issued back-to-back, like the bind mounts of a mass
+   * remount after a reboot, this coalesces thousands of cross-thread
+   * wakeups into a handful.
    */
   Future<UnixSocket::Message> sendAndRecv(
       uint32_t xid,
@@ -212,36 +228,60 @@ class PrivHelperClientImpl : public PrivHelper,
       eventBase = state->eventBase;
     }
 
-    // Note: We intentionally use EventBase::runInEventBaseThread() here rather
-    // than folly::via().
-    //
-    // folly::via() does not do what we want, as it causes chained futures to
-    // use the original executor rather than to execute inline.  In particular
-    // this causes problems during destruction if the EventBase in question has
-    // already been destroyed.
     folly::Promise<UnixSocket::Message> promise;
     auto future = promise.getFuture();
-    eventBase->runInEventBaseThread([this,
-                                     xid,
-                                     msg = std::move(msg),
-                                     promise = std::move(promise)]() mutable {
-      // Double check that the connection is still open
-      {
-        auto state = state_.rlock();
-        if (!state->conn_) {
-          promise.setException(std::runtime_error(
-              "cannot send new requests on closed privhelper connection"));
-          return;
+
+    bool needWakeup;
+    {
+      auto queued = queuedRequests_.wlock();
+      needWakeup = queued->empty();
+      queued->push_back(QueuedRequest{xid, std::move(msg), std::move(promise)});
+    }
+
+    if (needWakeup) {
+      // Note: We intentionally use EventBase::runInEventBaseThread() here
+      // rather than folly::via().
+      //
+      // folly::via() does not do what we want, as it causes chained futures to
+      // use the original executor rather than to execute inline.  In
+      // particular this causes problems during destruction if the EventBase in
+      // question has already been destroyed.
+      eventBase->runInEventBaseThread([this] { drainQueuedRequests(); });
+    }
+    return future;
+  }
+
+  /**
+   * Send all the queued requests to the privhelper process.
+   *
+   * This runs in the EventBase thread. Any request queued while a drain is
+   * running is either picked up by that drain or schedules the next one.
+   */
+  void drainQueuedRequests() {
+    std::vector<QueuedRequest> requests;
+    queuedRequests_.wlock()->swap(requests);
+
+    // Double check that the connection is still open
+    {
+      auto state = state_.rlock();
+      if (!state->conn_) {
+        auto error = std::runtime_error(
+            "cannot send new requests on closed privhelper connection");
+        for (auto& request : requests) {
+          request.promise.setException(error);
         }
+        return;
       }
-      pendingRequests_.emplace(xid, std::move(promise));
+    }
+
+    for (auto& request : requests) {
+      pendingRequests_.emplace(request.xid, std::move(request.promise));
       ++sendPending_;
       {
         auto state = state_.wlock();
-        state->conn_->send(std::move(msg), this);
+        state->conn_->send(std::move(request.msg), this);
       }
-    });
-    return future;
+    }
   }
 
   void messageReceived(UnixSocket::Message&& message) noexcept override {
@@ -331,6 +371,8 @@ class PrivHelperClientImpl : public PrivHelper,
   void closeSocket(const std::exception& ex) {
     PendingRequestMap pending;
     pending.swap(pendingRequests_);
+    std::vector<QueuedRequest> queued;
+    queuedRequests_.wlock()->swap(queued);
     {
       auto state = state_.wlock();
       state->conn_.reset();
@@ -340,6 +382,9 @@ class PrivHelperClientImpl : public PrivHelper,
     for (auto& entry : pending) {
       entry.second.setException(ex);
     }
+    for (auto& request : queued) {
+      request.promise.setException(ex);
+    }
   }
 
   // Separated out from detachEventBase() since it is not safe to cancel() an
@@ -361,6 +406,12 @@ class PrivHelperClientImpl : public PrivHelper,
   std::atomic<uint32_t> nextXid_{1};
   folly::Synchronized<ThreadSafeData> state_;
 
+  /**
+   * Requests waiting for the next drain on the EventBase thread. Any thread
+   * may enqueue here; see sendAndRecv() for the wakeup coalescing.
+   */
+  folly::Synchronized<std::vector<QueuedRequest>> queuedRequests_;
+
   // sendPending_, and pendingRequests_ are only accessed from the
   // EventBase thread.
   size_t sendPending_{0};
@@ -82,7 +82,8 @@ class FuseChannelTest : public ::testing::Test {
         CaseSensitivity::Sensitive,
         /*requireUtf8Path=*/true,
         /*maximumBackgroundRequests=*/12,
-        /*useWriteBackCache=*/false));
+        /*useWriteBackCache=*/false,
+        /*useSpliceReplies=*/false));
   }
 
   FuseChannel::StopFuture performInit(
@@ -26,8 +26,11 @@ CheckoutContext::CheckoutContext(
     CheckoutMode checkoutMode,
     std::optional<pid_t> clientPid,
     folly::StringPiece thriftMethodName,
-    const std::unordered_map<std::string, std::string>* requestInfo)
+    const std::unordered_map<std::string, std::string>* requestInfo,
+    bool stopOnFirstConflict)
     : checkoutMode_{checkoutMode},
+      stopOnFirstConflict_{
+          stopOnFirstConflict && checkoutMode == CheckoutMode::DRY_RUN},
       mount_{mount},
       fetchContext_{makeRefPtr<StatsFetchContext>(
           clientPid,
@@ -87,6 +90,12 @@ Future<vector<CheckoutConflict>> CheckoutContext::finish(RootId newSnapshot) {
   // This allows any filesystem unlink() or rename() operations to proceed.
   renameLock_.unlock();
 
+  if (!precomputedConflictCandidates_.empty()) {
+    XLOG(DBG2) << "checkout reported " << conflicts_.rlock()->size()
+               << " conflicts out of " << precomputedConflictCandidates_.size()
+               << " precomputed candidates";
+  }
+
   return flush();
 }
 
@@ -119,6 +128,7 @@ void CheckoutContext::addConflict(ConflictType type, RelativePathPiece path) {
   *conflict.path_ref() = std::string{path.value()};
   *conflict.type_ref() = type;
   conflicts_.wlock()->push_back(std::move(conflict));
+  conflictFound_.store(true, std::memory_order_relaxed);
 }
 
 void CheckoutContext::addConflict(
@@ -156,5 +166,6 @@ void CheckoutContext::addError(
   *conflict.type_ref() = ConflictType::ERROR;
   *conflict.message_ref() = folly::exceptionStr(ew).toStdString();
   conflicts_.wlock()->push_back(std::move(conflict));
+  conflictFound_.store(true, std::memory_order_relaxed);
 }
 } // namespace facebook::eden
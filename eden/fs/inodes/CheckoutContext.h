@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <optional>
 #include <unordered_map>
 #include <vector>
@@ -45,7 +46,8 @@ class CheckoutContext {
       std::optional<pid_t> clientPid,
       folly::StringPiece thriftMethodName,
       const std::unordered_map<std::string, std::string>* requestInfo =
-          nullptr);
+          nullptr,
+      bool stopOnFirstConflict = false);
 
   ~CheckoutContext();
 
@@ -74,6 +76,21 @@ class CheckoutContext {
     return checkoutMode_ == CheckoutMode::FORCE;
   }
 
+  /**
+   * Returns true once a conflict has been recorded and the caller asked for
+   * the walk to stop at the first one. The checkout tree walk polls this to
+   * prune the rest of its traversal; only dry runs honor the flag since a
+   * real checkout cannot abandon a half-applied update.
+   *
+   * The relaxed load keeps the check free on the hot path; a racing walker
+   * may process a few extra entries before it observes the flag, which only
+   * costs a little extra work and possibly a couple more reported conflicts.
+   */
+  bool shouldStopEarly() const {
+    return stopOnFirstConflict_ &&
+        conflictFound_.load(std::memory_order_relaxed);
+  }
+
   /**
    * Start the checkout operation.
    *
@@ -140,8 +157,24 @@ class CheckoutContext {
     return fetchContext_.as<ObjectFetchContext>();
   }
 
+  /**
+   * Attach the conflict candidate set computed by an earlier
+   * EdenMount::prepareCheckout run between the same pair of roots.
+   *
+   * The set is advisory: every conflict this checkout reports falls on one
+   * of these paths, but most candidates produce no conflict since conflicts
+   * also require a local modification. It is consumed for diagnostics when
+   * the checkout finishes.
+   */
+  void setPrecomputedConflictCandidates(std::vector<RelativePath> candidates) {
+    precomputedConflictCandidates_ = std::move(candidates);
+  }
+
  private:
   CheckoutMode checkoutMode_;
+  /** Only ever true for dry runs; see shouldStopEarly(). */
+  bool stopOnFirstConflict_;
+  std::atomic<bool> conflictFound_{false};
   EdenMount* const mount_;
   RenameLock renameLock_;
   RefPtr<StatsFetchContext> fetchContext_;
@@ -150,5 +183,10 @@ class CheckoutContext {
   // if some data load operations complete asynchronously on other threads.
   // Therefore access to the conflicts list must be synchronized.
   folly::Synchronized<std::vector<CheckoutConflict>> conflicts_;
+
+  // Paths changed between the source and destination roots, precomputed by
+  // EdenMount::prepareCheckout. Empty when no preparation ran. Set before
+  // the checkout starts and read only after it completes.
+  std::vector<RelativePath> precomputedConflictCandidates_;
 };
 } // namespace facebook::eden
@@ -117,8 +117,15 @@ class DirEntry {
     hasHash_ = false;
   }
 
+  /**
+   * Mark this entry as identical to the given source control object.
+   *
+   * The caller must hold the parent TreeInode's contents lock. The entry's
+   * inode may be loaded (as during checkout) or unloaded (as when the
+   * background dematerializer reclaims an unmodified file); in the latter
+   * case the caller is responsible for removing the entry's overlay data.
+   */
   void setDematerialized(ObjectId hash) {
-    XDCHECK(hasInodePointer_);
     hasHash_ = true;
     hash_ = hash;
   }
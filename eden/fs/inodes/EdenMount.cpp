@@ -44,10 +44,12 @@
 #include "eden/fs/service/PrettyPrinters.h"
 #include "eden/fs/service/gen-cpp2/eden_types.h"
 #include "eden/fs/store/BlobAccess.h"
+#include "eden/fs/store/BlobSpillStore.h"
 #include "eden/fs/store/Diff.h"
 #include "eden/fs/store/DiffCallback.h"
 #include "eden/fs/store/DiffContext.h"
 #include "eden/fs/store/ObjectStore.h"
+#include "eden/fs/store/PathLoader.h"
 #include "eden/fs/store/ScmStatusDiffCallback.h"
 #include "eden/fs/store/StatsFetchContext.h"
 #include "eden/fs/telemetry/StructuredLogger.h"
@@ -218,6 +220,24 @@ static const uint64_t globalProcessGeneration =
 // for a given mount instance.
 static std::atomic<uint16_t> mountGeneration{0};
 
+namespace {
+/**
+ * Build the large-blob spill store for a mount, or nullptr when spilling is
+ * disabled. Spill files live in the checkout's client directory, next to the
+ * overlay, so they are cleaned up with the rest of the checkout state.
+ */
+std::shared_ptr<BlobSpillStore> makeBlobSpillStore(
+    const CheckoutConfig& checkoutConfig,
+    const EdenConfig& edenConfig) {
+  auto threshold = edenConfig.largeBlobSpillThreshold.getValue();
+  if (threshold == 0) {
+    return nullptr;
+  }
+  return std::make_shared<BlobSpillStore>(
+      checkoutConfig.getClientDirectory() + "blob-spill"_pc, threshold);
+}
+} // namespace
+
 std::shared_ptr<EdenMount> EdenMount::create(
     std::unique_ptr<CheckoutConfig> config,
     std::shared_ptr<ObjectStore> objectStore,
@@ -257,7 +277,10 @@ EdenMount::EdenMount(
           shouldUseNFSMount_)},
       objectStore_{std::move(objectStore)},
       blobCache_{std::move(blobCache)},
-      blobAccess_{objectStore_, blobCache_},
+      blobAccess_{
+          objectStore_,
+          blobCache_,
+          makeBlobSpillStore(*checkoutConfig_, *serverState_->getEdenConfig())},
       overlay_{Overlay::create(
           checkoutConfig_->getOverlayPath(),
           checkoutConfig_->getCaseSensitive(),
@@ -265,7 +288,10 @@ EdenMount::EdenMount(
           serverState_->getStructuredLogger(),
           *serverState_->getEdenConfig())},
 #ifndef _WIN32
-      overlayFileAccess_{overlay_.get()},
+      overlayFileAccess_{
+          overlay_.get(),
+          serverState_->getReloadableConfig(),
+          &serverState_->getStats()},
 #endif
       journal_{std::move(journal)},
       mountGeneration_{globalProcessGeneration | ++mountGeneration},
@@ -274,6 +300,8 @@ EdenMount::EdenMount(
       lastCheckoutTime_{EdenTimestamp{serverState_->getClock()->getRealtime()}},
       owner_{Owner{getuid(), getgid()}},
       inodeActivityBuffer_{initInodeActivityBuffer()},
+      flightRecorder_{initFlightRecorder()},
+      tracePerfAggregator_{initTracePerfAggregator()},
       inodeTraceBus_{
           TraceBus<InodeTraceEvent>::create("inode", kInodeTraceBusCapacity)},
       clock_{serverState_->getClock()} {
@@ -377,7 +405,8 @@ class TreeLookupProcessor {
 
 FOLLY_NODISCARD folly::Future<folly::Unit> EdenMount::initialize(
     OverlayChecker::ProgressCallback&& progressCallback,
-    const std::optional<SerializedInodeMap>& takeover) {
+    const std::optional<SerializedInodeMap>& takeover,
+    std::optional<folly::File> takeoverInodeMapSegment) {
   transitionState(State::UNINITIALIZED, State::INITIALIZING);
 
   auto parentCommit = checkoutConfig_->getParentCommit();
@@ -450,11 +479,24 @@ FOLLY_NODISCARD folly::Future<folly::Unit> EdenMount::initialize(
               return parentTree;
             });
       })
-      .thenValue([this, takeover](std::shared_ptr<const Tree> parentTree) {
+      .thenValue([this,
+                  takeover,
+                  takeoverInodeMapSegment =
+                      std::move(takeoverInodeMapSegment)](
+                     std::shared_ptr<const Tree> parentTree) {
         auto initTreeNode = createRootInode(std::move(parentTree));
-        if (takeover) {
+        if (takeoverInodeMapSegment) {
+#ifndef _WIN32
+          inodeMap_->initializeFromTakeover(
+              std::move(initTreeNode), *takeoverInodeMapSegment);
+#else
+          EDEN_BUG() << "inode map segments are not used on Windows";
+#endif
+        } else if (takeover) {
           inodeMap_->initializeFromTakeover(std::move(initTreeNode), *takeover);
-        } else if (isWorkingCopyPersistent()) {
+        } else if (
+            isWorkingCopyPersistent() ||
+            getEdenConfig()->initializeInodeMapFromOverlay.getValue()) {
           inodeMap_->initializeFromOverlay(std::move(initTreeNode), *overlay_);
         } else {
           inodeMap_->initialize(std::move(initTreeNode));
@@ -1384,7 +1426,8 @@ folly::Future<CheckoutResult> EdenMount::checkout(
     const RootId& snapshotHash,
     std::optional<pid_t> clientPid,
     folly::StringPiece thriftMethodCaller,
-    CheckoutMode checkoutMode) {
+    CheckoutMode checkoutMode,
+    bool stopOnFirstConflict) {
   const folly::stop_watch<> stopWatch;
   auto checkoutTimes = std::make_shared<CheckoutTimes>();
   bool resumingCheckout = false;
@@ -1429,10 +1472,23 @@ folly::Future<CheckoutResult> EdenMount::checkout(
   }
 
   auto ctx = std::make_shared<CheckoutContext>(
-      this, checkoutMode, clientPid, thriftMethodCaller);
+      this,
+      checkoutMode,
+      clientPid,
+      thriftMethodCaller,
+      /*requestInfo=*/nullptr,
+      stopOnFirstConflict);
   XLOG(DBG1) << "starting checkout for " << this->getPath() << ": " << oldParent
              << " to " << snapshotHash;
 
+  if (auto precomputed = takePrecomputedCheckout(oldParent, snapshotHash)) {
+    XLOG(DBG2) << "checkout was prepared with "
+               << precomputed->conflictCandidates.size()
+               << " conflict candidates";
+    ctx->setPrecomputedConflictCandidates(
+        std::move(precomputed->conflictCandidates));
+  }
+
   // Update lastCheckoutTime_ before starting the checkout operation.
   // This ensures that any inode objects created once the checkout starts will
   // get the current checkout time, rather than the time from the previous
@@ -1711,13 +1767,17 @@ std::unique_ptr<DiffContext> EdenMount::createDiffContext(
     DiffCallback* callback,
     folly::CancellationToken cancellation,
     bool listIgnored) const {
+  auto walkParallelism =
+      serverState_->getEdenConfig()->diffWalkParallelism.getValue();
   return make_unique<DiffContext>(
       callback,
       cancellation,
       listIgnored,
       getCheckoutConfig()->getCaseSensitive(),
       getObjectStore(),
-      serverState_->getTopLevelIgnores());
+      serverState_->getTopLevelIgnores(),
+      walkParallelism > 0 ? serverState_->getThreadPool().get() : nullptr,
+      walkParallelism);
 }
 
 ImmediateFuture<Unit> EdenMount::diff(
@@ -1740,6 +1800,49 @@ ImmediateFuture<Unit> EdenMount::diff(
       });
 }
 
+std::optional<EdenError> EdenMount::ensureParentUpToDateForDiff(
+    const RootId& commitHash) const {
+  auto parentInfo = parentState_.rlock();
+
+  if (parentInfo->checkoutInProgress) {
+    if (parentInfo->checkoutPid == folly::get_cached_pid() ||
+        !parentInfo->checkoutOriginalTrees) {
+      return newEdenError(
+          EdenErrorType::CHECKOUT_IN_PROGRESS,
+          "cannot compute status while a checkout is currently in progress");
+    } else if (getEdenConfig()->allowResumeCheckout.getValue()) {
+      auto [fromCommit, toCommit] = *parentInfo->checkoutOriginalTrees;
+      return newEdenError(
+          EdenErrorType::CHECKOUT_IN_PROGRESS,
+          fmt::format(
+              "cannot compute status while a checkout is in progress - please run 'hg update --clean {}' to resume it",
+              toCommit));
+    } else {
+      return newEdenError(
+          EdenErrorType::CHECKOUT_IN_PROGRESS,
+          "cannot compute status for an interrupted checkout operation");
+    }
+  }
+
+  if (parentInfo->workingCopyParentRootId != commitHash) {
+    // Log this occurrence to Scuba
+    getServerState()->getStructuredLogger()->logEvent(ParentMismatch{
+        commitHash.value(), parentInfo->workingCopyParentRootId.value()});
+    return newEdenError(
+        EdenErrorType::OUT_OF_DATE_PARENT,
+        "error computing status: requested parent commit is out-of-date: requested ",
+        commitHash,
+        ", but current parent commit is ",
+        parentInfo->workingCopyParentRootId,
+        ".\nTry running `eden doctor` to remediate");
+  }
+
+  // TODO: Should we perhaps hold the parentInfo read-lock for the duration
+  // of the status operation?  This would block new checkout operations from
+  // starting until we have finished computing this status call.
+  return std::nullopt;
+}
+
 ImmediateFuture<Unit> EdenMount::diff(
     DiffCallback* callback,
     const RootId& commitHash,
@@ -1747,44 +1850,9 @@ ImmediateFuture<Unit> EdenMount::diff(
     bool enforceCurrentParent,
     folly::CancellationToken cancellation) const {
   if (enforceCurrentParent) {
-    auto parentInfo = parentState_.rlock();
-
-    if (parentInfo->checkoutInProgress) {
-      if (parentInfo->checkoutPid == folly::get_cached_pid() ||
-          !parentInfo->checkoutOriginalTrees) {
-        return makeImmediateFuture<Unit>(newEdenError(
-            EdenErrorType::CHECKOUT_IN_PROGRESS,
-            "cannot compute status while a checkout is currently in progress"));
-      } else if (getEdenConfig()->allowResumeCheckout.getValue()) {
-        auto [fromCommit, toCommit] = *parentInfo->checkoutOriginalTrees;
-        return makeImmediateFuture<Unit>(newEdenError(
-            EdenErrorType::CHECKOUT_IN_PROGRESS,
-            fmt::format(
-                "cannot compute status while a checkout is in progress - please run 'hg update --clean {}' to resume it",
-                toCommit)));
-      } else {
-        return makeImmediateFuture<Unit>(newEdenError(
-            EdenErrorType::CHECKOUT_IN_PROGRESS,
-            "cannot compute status for an interrupted checkout operation"));
-      }
-    }
-
-    if (parentInfo->workingCopyParentRootId != commitHash) {
-      // Log this occurrence to Scuba
-      getServerState()->getStructuredLogger()->logEvent(ParentMismatch{
-          commitHash.value(), parentInfo->workingCopyParentRootId.value()});
-      return makeImmediateFuture<Unit>(newEdenError(
-          EdenErrorType::OUT_OF_DATE_PARENT,
-          "error computing status: requested parent commit is out-of-date: requested ",
-          commitHash,
-          ", but current parent commit is ",
-          parentInfo->workingCopyParentRootId,
-          ".\nTry running `eden doctor` to remediate"));
+    if (auto error = ensureParentUpToDateForDiff(commitHash)) {
+      return makeImmediateFuture<Unit>(std::move(*error));
     }
-
-    // TODO: Should we perhaps hold the parentInfo read-lock for the duration
-    // of the status operation?  This would block new checkout operations from
-    // starting until we have finished computing this status call.
   }
 
   // Create a DiffContext object for this diff operation.
@@ -1805,17 +1873,58 @@ ImmediateFuture<std::unique_ptr<ScmStatus>> EdenMount::diff(
     folly::CancellationToken cancellation,
     bool listIgnored,
     bool enforceCurrentParent) {
-  auto callback = std::make_unique<ScmStatusDiffCallback>();
-  auto callbackPtr = callback.get();
-  return this
-      ->diff(
-          callbackPtr,
-          commitHash,
-          listIgnored,
-          enforceCurrentParent,
-          std::move(cancellation))
-      .thenValue([callback = std::move(callback)](auto&&) {
-        return std::make_unique<ScmStatus>(callback->extractStatus());
+  if (enforceCurrentParent) {
+    // Run parent enforcement before consulting the cache: a cache hit must
+    // not mask a checkout-in-progress or out-of-date-parent error.
+    if (auto error = ensureParentUpToDateForDiff(commitHash)) {
+      return makeImmediateFuture<std::unique_ptr<ScmStatus>>(
+          std::move(*error));
+    }
+  }
+
+  // Flush any pending filesystem notifications into the journal before
+  // reading the sequence number, so a cached result cannot hide a change the
+  // channel has already been told about.
+  return waitForPendingNotifications().thenValue(
+      [this, commitHash, cancellation = std::move(cancellation), listIgnored](
+          auto&&) -> ImmediateFuture<std::unique_ptr<ScmStatus>> {
+        auto sequence = journal_->getLatestSequenceID();
+        {
+          auto cache = scmStatusCache_.rlock();
+          if (cache->has_value() && (*cache)->commitHash == commitHash &&
+              (*cache)->listIgnored == listIgnored &&
+              (*cache)->journalSequence == sequence) {
+            return std::make_unique<ScmStatus>((*cache)->status);
+          }
+        }
+
+        auto callback = std::make_unique<ScmStatusDiffCallback>();
+        auto callbackPtr = callback.get();
+        return this
+            ->diff(
+                callbackPtr,
+                commitHash,
+                listIgnored,
+                /*enforceCurrentParent=*/false,
+                cancellation)
+            .thenValue([this,
+                        commitHash,
+                        cancellation,
+                        listIgnored,
+                        sequence,
+                        callback = std::move(callback)](auto&&) {
+              auto status = callback->extractStatus();
+              // Only cache a result that is known to be complete and still
+              // current: a cancelled diff may be partial, and if the journal
+              // moved while we walked the tree the status may not reflect
+              // those changes.
+              if (!cancellation.isCancellationRequested() &&
+                  journal_->getLatestSequenceID() == sequence) {
+                scmStatusCache_.wlock()->emplace(CachedScmStatus{
+                    commitHash, listIgnored, sequence, status});
+              }
+              return std::make_unique<ScmStatus>(std::move(status));
+            });
       });
 }
 
@@ -1830,6 +1939,164 @@ ImmediateFuture<folly::Unit> EdenMount::diffBetweenRoots(
       [diffContext = std::move(diffContext), rootInode = getRootInode()] {});
 }
 
+namespace {
+
+/**
+ * Scratch state for EdenMount::prepareCheckout, kept alive across the tree
+ * resolution and blob prefetch stages.
+ */
+struct CheckoutPrepState {
+  PrecomputedCheckout result;
+
+  /**
+   * Files added or modified in the target commit, grouped by parent
+   * directory so each directory's tree is resolved only once.
+   */
+  std::unordered_map<RelativePath, std::vector<PathComponent>> dirGroups;
+
+  /** The keys of dirGroups, in the order passed to resolveTrees(). */
+  std::vector<RelativePath> dirs;
+
+  /** Blob ids to prefetch; must outlive the prefetchBlobs() call. */
+  std::vector<ObjectId> blobIds;
+};
+
+} // namespace
+
+ImmediateFuture<folly::Unit> EdenMount::prepareCheckout(RootId toRoot) {
+  auto fromRoot = getCheckedOutRootId();
+  if (fromRoot == toRoot) {
+    return folly::unit;
+  }
+  XLOG(DBG2) << "preparing checkout for " << getPath() << ": " << fromRoot
+             << " to " << toRoot;
+
+  auto callback = std::make_unique<ScmStatusDiffCallback>();
+  auto diffContext = createDiffContext(
+      callback.get(),
+      folly::CancellationToken{},
+      /*listIgnored=*/false,
+      kCheckoutPrepPriority);
+  auto* ctxPtr = diffContext.get();
+
+  // The diff itself pulls every tree that differs between the two roots
+  // through the ObjectStore, warming the tree caches as a side effect.
+  auto fut =
+      diffRoots(ctxPtr, fromRoot, toRoot)
+          .thenValue([this,
+                      ctxPtr,
+                      callbackPtr = callback.get(),
+                      fromRoot,
+                      toRoot](auto&&) {
+            auto status = callbackPtr->extractStatus();
+
+            auto state = std::make_shared<CheckoutPrepState>();
+            state->result.fromRoot = fromRoot;
+            state->result.toRoot = toRoot;
+            state->result.conflictCandidates.reserve(status.entries()->size());
+            for (const auto& entry : *status.entries()) {
+              RelativePath path{entry.first};
+              if (entry.second != ScmFileStatus::REMOVED) {
+                state->dirGroups[path.dirname().copy()].push_back(
+                    path.basename().copy());
+              }
+              state->result.conflictCandidates.push_back(std::move(path));
+            }
+            state->dirs.reserve(state->dirGroups.size());
+            for (const auto& group : state->dirGroups) {
+              state->dirs.push_back(group.first);
+            }
+
+            return objectStore_->getRootTree(toRoot, ctxPtr->getFetchContext())
+                .thenValue([this, ctxPtr, state](
+                               std::shared_ptr<const Tree> rootTree) {
+                  return resolveTrees(
+                      *objectStore_,
+                      ctxPtr->getFetchContext(),
+                      std::move(rootTree),
+                      state->dirs);
+                })
+                .thenValue(
+                    [this, ctxPtr, state](
+                        std::vector<folly::Try<std::shared_ptr<const Tree>>>
+                            trees) {
+                      for (size_t i = 0; i < trees.size(); ++i) {
+                        if (!trees[i].hasValue() || !trees[i].value()) {
+                          continue;
+                        }
+                        const auto& tree = trees[i].value();
+                        for (const auto& name :
+                             state->dirGroups[state->dirs[i]]) {
+                          auto it = tree->find(name);
+                          if (it != tree->cend() && !it->second.isTree()) {
+                            state->blobIds.push_back(it->second.getHash());
+                          }
+                        }
+                      }
+                      return objectStore_
+                          ->prefetchBlobs(
+                              ObjectIdRange{
+                                  state->blobIds.data(),
+                                  state->blobIds.size()},
+                              ctxPtr->getFetchContext())
+                          .ensure([state] {});
+                    })
+                .thenValue([this, state](auto&&) {
+                  XLOG(DBG2) << "prepared checkout for " << getPath() << ": "
+                             << state->result.conflictCandidates.size()
+                             << " changed paths, " << state->blobIds.size()
+                             << " blobs prefetched";
+                  precomputedCheckout_.wlock()->emplace(
+                      std::move(state->result));
+                });
+          });
+  return std::move(fut).ensure(
+      [diffContext = std::move(diffContext),
+       callback = std::move(callback),
+       rootInode = getRootInode()] {});
+}
+
+std::optional<PrecomputedCheckout> EdenMount::takePrecomputedCheckout(
+    const RootId& fromRoot,
+    const RootId& toRoot) {
+  auto state = precomputedCheckout_.wlock();
+  auto result = std::exchange(*state, std::nullopt);
+  if (result && result->fromRoot == fromRoot && result->toRoot == toRoot) {
+    return result;
+  }
+  return std::nullopt;
+}
+
+#ifndef _WIN32
+ImmediateFuture<uint64_t> EdenMount::dematerializeUnmodifiedFiles(
+    uint64_t maxFiles) {
+  // Only scan while the working copy is quiet. If the journal advanced since
+  // the previous maintenance interval the user is actively writing, so skip
+  // this run and try again once the mount has been idle for a full interval.
+  auto journalSequence = journal_->getLatestSequenceID();
+  if (lastDematerializeJournalSequence_.exchange(journalSequence) !=
+      journalSequence) {
+    return uint64_t{0};
+  }
+
+  if (parentState_.rlock()->checkoutInProgress) {
+    // Checkout rewrites materialization state itself; stay out of its way.
+    return uint64_t{0};
+  }
+
+  static auto context = ObjectFetchContext::getNullContextWithCauseDetail(
+      "dematerializeUnmodifiedFiles");
+  auto budget =
+      std::make_shared<std::atomic<int64_t>>(static_cast<int64_t>(maxFiles));
+  return objectStore_->getRootTree(getCheckedOutRootId(), context)
+      .thenValue([rootInode = getRootInode(),
+                  budget](std::shared_ptr<const Tree> rootTree) {
+        return rootInode->dematerializeUnmodifiedChildren(
+            std::move(rootTree), budget, context);
+      });
+}
+#endif
+
 void EdenMount::resetParent(const RootId& parent) {
   // Hold the snapshot lock around the entire operation.
   auto parentLock = parentState_.wlock();
@@ -1926,7 +2193,8 @@ std::unique_ptr<FuseChannel, FuseChannelDeleter> makeFuseChannel(
       mount->getCheckoutConfig()->getCaseSensitive(),
       mount->getCheckoutConfig()->getRequireUtf8Path(),
       edenConfig->fuseMaximumRequests.getValue(),
-      mount->getCheckoutConfig()->getUseWriteBackCache())};
+      mount->getCheckoutConfig()->getUseWriteBackCache(),
+      edenConfig->fuseSpliceReplies.getValue())};
 }
 
 folly::Future<NfsServer::NfsMountInfo> makeNfsChannel(
@@ -2252,6 +2520,8 @@ void EdenMount::channelInitSuccessful(
   // This state transition could fail if shutdown() was called before we saw
   // the FUSE_INIT message from the kernel.
   transitionState(State::STARTING, State::RUNNING);
+  subscribeFlightRecorderToChannel();
+  subscribeTracePerfToChannel();
 #ifndef _WIN32
   if (std::holds_alternative<NfsdChannelVariant>(channel_)) {
     // Make sure that the Nfsd3 is destroyed in the EventBase that it was
@@ -2364,9 +2634,174 @@ EdenMount::initInodeActivityBuffer() {
   return std::nullopt;
 }
 
+std::shared_ptr<FlightRecorder> EdenMount::initFlightRecorder() {
+  if (serverState_->getEdenConfig()->enableFlightRecorder.getValue()) {
+    return std::make_shared<FlightRecorder>(
+        serverState_->getEdenConfig()->flightRecorderMaxEvents.getValue());
+  }
+  return nullptr;
+}
+
+std::shared_ptr<TracePerfAggregator> EdenMount::initTracePerfAggregator() {
+  if (serverState_->getEdenConfig()->enableTracePerf.getValue()) {
+    return std::make_shared<TracePerfAggregator>();
+  }
+  return nullptr;
+}
+
+namespace {
+uint64_t flightRecorderMonotonicNs(const TraceEventBase& event) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          event.monotonicTime.time_since_epoch())
+          .count());
+}
+} // namespace
+
+void EdenMount::subscribeFlightRecorderToChannel() {
+  if (!flightRecorder_) {
+    return;
+  }
+  auto name = fmt::format("flight-recorder-{}", getPath().basename());
+#ifdef _WIN32
+  auto prjfsChannel = channel_ ? channel_->getInner() : nullptr;
+  if (prjfsChannel) {
+    channelFlightRecorderHandle_ =
+        prjfsChannel->getTraceBusPtr()->subscribeFunction(
+            std::move(name),
+            [recorder = flightRecorder_](const PrjfsTraceEvent& event) {
+              recorder->record(FlightRecorderEntry{
+                  flightRecorderMonotonicNs(event),
+                  static_cast<uint64_t>(event.getData().commandId),
+                  event.getData().pid,
+                  static_cast<uint16_t>(event.getCallType()),
+                  static_cast<uint8_t>(event.getType()),
+                  FlightRecorderSubsystem::PRJFS});
+            });
+  }
+#else
+  if (auto* fuseChannel = getFuseChannel()) {
+    channelFlightRecorderHandle_ = fuseChannel->getTraceBus().subscribeFunction(
+        std::move(name),
+        [recorder = flightRecorder_](const FuseTraceEvent& event) {
+          recorder->record(FlightRecorderEntry{
+              flightRecorderMonotonicNs(event),
+              event.getUnique(),
+              event.getRequest().pid,
+              static_cast<uint16_t>(event.getRequest().opcode),
+              static_cast<uint8_t>(event.getType()),
+              FlightRecorderSubsystem::FUSE});
+        });
+  } else if (auto* nfsdChannel = getNfsdChannel()) {
+    channelFlightRecorderHandle_ = nfsdChannel->getTraceBus().subscribeFunction(
+        std::move(name),
+        [recorder = flightRecorder_](const NfsTraceEvent& event) {
+          recorder->record(FlightRecorderEntry{
+              flightRecorderMonotonicNs(event),
+              event.getXid(),
+              0,
+              static_cast<uint16_t>(event.getProcNumber()),
+              static_cast<uint8_t>(event.getType()),
+              FlightRecorderSubsystem::NFS});
+        });
+  }
+#endif
+}
+
+void EdenMount::subscribeTracePerfToChannel() {
+  if (!tracePerfAggregator_) {
+    return;
+  }
+  auto name = fmt::format("trace-perf-{}", getPath().basename());
+#ifdef _WIN32
+  auto prjfsChannel = channel_ ? channel_->getInner() : nullptr;
+  if (prjfsChannel) {
+    channelTracePerfHandle_ = prjfsChannel->getTraceBusPtr()->subscribeFunction(
+        std::move(name),
+        [aggregator = tracePerfAggregator_](const PrjfsTraceEvent& event) {
+          auto commandId = static_cast<uint64_t>(event.getData().commandId);
+          switch (event.getType()) {
+            case PrjfsTraceEvent::START:
+              aggregator->recordFsStart(
+                  commandId,
+                  static_cast<uint32_t>(event.getCallType()),
+                  event.monotonicTime);
+              break;
+            case PrjfsTraceEvent::FINISH:
+              aggregator->recordFsFinish(commandId, event.monotonicTime);
+              break;
+          }
+        });
+  }
+#else
+  if (auto* fuseChannel = getFuseChannel()) {
+    channelTracePerfHandle_ = fuseChannel->getTraceBus().subscribeFunction(
+        std::move(name),
+        [aggregator = tracePerfAggregator_](const FuseTraceEvent& event) {
+          switch (event.getType()) {
+            case FuseTraceEvent::START:
+              aggregator->recordFsStart(
+                  event.getUnique(),
+                  event.getRequest().opcode,
+                  event.monotonicTime);
+              break;
+            case FuseTraceEvent::FINISH:
+              aggregator->recordFsFinish(event.getUnique(), event.monotonicTime);
+              break;
+          }
+        });
+  } else if (auto* nfsdChannel = getNfsdChannel()) {
+    channelTracePerfHandle_ = nfsdChannel->getTraceBus().subscribeFunction(
+        std::move(name),
+        [aggregator = tracePerfAggregator_](const NfsTraceEvent& event) {
+          switch (event.getType()) {
+            case NfsTraceEvent::START:
+              aggregator->recordFsStart(
+                  event.getXid(), event.getProcNumber(), event.monotonicTime);
+              break;
+            case NfsTraceEvent::FINISH:
+              aggregator->recordFsFinish(event.getXid(), event.monotonicTime);
+              break;
+          }
+        });
+  }
+#endif
+}
+
 void EdenMount::subscribeInodeActivityBuffer() {
   inodeTraceHandle_ = std::make_shared<InodeTraceHandle>();
 
+  if (flightRecorder_) {
+    inodeTraceHandle_->flightRecorderHandle = inodeTraceBus_->subscribeFunction(
+        fmt::format("flight-recorder-{}", getPath().basename()),
+        [recorder = flightRecorder_](const InodeTraceEvent& event) {
+          recorder->record(FlightRecorderEntry{
+              flightRecorderMonotonicNs(event),
+              event.ino.getRawValue(),
+              0,
+              static_cast<uint16_t>(event.eventType),
+              static_cast<uint8_t>(event.progress),
+              FlightRecorderSubsystem::INODE});
+        });
+  }
+
+  if (tracePerfAggregator_) {
+    inodeTraceHandle_->tracePerfHandle = inodeTraceBus_->subscribeFunction(
+        fmt::format("trace-perf-{}", getPath().basename()),
+        [aggregator = tracePerfAggregator_](const InodeTraceEvent& event) {
+          // Only completed events carry a duration; starts and failures
+          // have nothing to aggregate.
+          if (event.progress != InodeEventProgress::END) {
+            return;
+          }
+          aggregator->recordInodeEvent(
+              event.eventType == InodeEventType::MATERIALIZE,
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  event.duration),
+              event.monotonicTime);
+        });
+  }
+
   if (inodeActivityBuffer_.has_value()) {
     inodeTraceHandle_->subHandle = inodeTraceBus_->subscribeFunction(
         fmt::format("inode-activitybuffer-{}", getPath().basename()),
@@ -17,6 +17,7 @@
 #include <folly/futures/SharedPromise.h>
 #include <folly/logging/Logger.h>
 #include <folly/portability/GFlags.h>
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <mutex>
@@ -29,14 +30,18 @@
 #include "eden/fs/inodes/InodeNumber.h"
 #include "eden/fs/inodes/InodePtrFwd.h"
 #include "eden/fs/inodes/InodeTimestamps.h"
+#include "eden/fs/inodes/MountWarmup.h"
 #include "eden/fs/inodes/Overlay.h"
 #include "eden/fs/inodes/VirtualInode.h"
 #include "eden/fs/model/RootId.h"
 #include "eden/fs/service/gen-cpp2/eden_types.h"
 #include "eden/fs/store/BlobAccess.h"
+#include "eden/fs/store/ImportPriority.h"
 #include "eden/fs/takeover/TakeoverData.h"
 #include "eden/fs/telemetry/ActivityBuffer.h"
+#include "eden/fs/telemetry/FlightRecorder.h"
 #include "eden/fs/telemetry/IActivityRecorder.h"
+#include "eden/fs/telemetry/TracePerfAggregator.h"
 #include "eden/fs/utils/PathFuncs.h"
 
 #ifndef _WIN32
@@ -232,6 +237,22 @@ struct CheckoutResult {
   CheckoutTimes times;
 };
 
+/**
+ * The result of a background checkout-preparation pass computed by
+ * EdenMount::prepareCheckout.
+ *
+ * conflictCandidates holds every path that differs between fromRoot and
+ * toRoot. An actual checkout between those roots can only report conflicts
+ * at a subset of these paths (those that are also locally modified), so the
+ * set is advisory: it bounds the conflicts a checkout may produce but cannot
+ * be used to skip conflict detection.
+ */
+struct PrecomputedCheckout {
+  RootId fromRoot;
+  RootId toRoot;
+  std::vector<RelativePath> conflictCandidates;
+};
+
 struct SetPathObjectIdResultAndTimes {
   SetPathObjectIdResult result;
   SetPathObjectIdTimes times;
@@ -297,10 +318,14 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
    * Asynchronous EdenMount initialization - post instantiation.
    *
    * If takeover data is specified, it is used to initialize the inode map.
+   * When takeoverInodeMapSegment is set, the inode map is instead built
+   * directly from that memory-backed segment and the takeover parameter is
+   * ignored.
    */
   FOLLY_NODISCARD folly::Future<folly::Unit> initialize(
       OverlayChecker::ProgressCallback&& progressCallback = [](auto) {},
-      const std::optional<SerializedInodeMap>& takeover = std::nullopt);
+      const std::optional<SerializedInodeMap>& takeover = std::nullopt,
+      std::optional<folly::File> takeoverInodeMapSegment = std::nullopt);
 
   /**
    * Destroy the EdenMount.
@@ -544,6 +569,15 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
     return activityRecorder_;
   }
 
+  /**
+   * Progress state of this mount's working-set warm-up. See MountWarmup.h.
+   * The object is valid for the lifetime of the EdenMount whether or not a
+   * warm-up ever runs.
+   */
+  const std::shared_ptr<WarmupState>& getWarmupState() const {
+    return warmupState_;
+  }
+
   uint64_t getMountGeneration() const {
     return mountGeneration_;
   }
@@ -678,12 +712,18 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
    *
    * This updates the checkedOutRootId as well as the workingCopyParentRootId to
    * the passed in snapshotHash.
+   *
+   * When stopOnFirstConflict is set and checkoutMode is DRY_RUN, the tree
+   * walk is abandoned once any conflict has been recorded, so tooling can
+   * cheaply pre-validate a checkout; the returned conflict list is then
+   * truncated. The flag is ignored for real checkouts.
    */
   folly::Future<CheckoutResult> checkout(
       const RootId& snapshotHash,
       std::optional<pid_t> clientPid,
       folly::StringPiece thriftMethodCaller,
-      CheckoutMode checkoutMode = CheckoutMode::NORMAL);
+      CheckoutMode checkoutMode = CheckoutMode::NORMAL,
+      bool stopOnFirstConflict = false);
 
   /**
    * Chown the repository to the given uid and gid
@@ -709,6 +749,13 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
    * @return Returns a folly::Future that will be fulfilled when the diff
    *     operation is complete.  This is marked FOLLY_NODISCARD to
    *     make sure callers do not forget to wait for the operation to complete.
+   *
+   * The computed status is cached keyed on (commitHash, listIgnored) and
+   * validated against the journal's latest sequence number, so repeated
+   * status queries against an unchanged working copy (the common
+   * IDE/tooling polling pattern) are answered without walking the tree.
+   * Any journal movement — file changes or checkouts — invalidates the
+   * cached entry.
    */
   FOLLY_NODISCARD ImmediateFuture<std::unique_ptr<ScmStatus>> diff(
       const RootId& commitHash,
@@ -716,6 +763,20 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
       bool listIgnored = false,
       bool enforceCurrentParent = true);
 
+  /**
+   * This accepts a callback which will be invoked as differences are found.
+   * Note that the callback methods may be invoked simultaneously from multiple
+   * different threads, and the callback is responsible for performing
+   * synchronization (if it is needed). It will be packaged into a DiffContext
+   * and passed through the TreeInode diff() codepath
+   */
+  FOLLY_NODISCARD ImmediateFuture<folly::Unit> diff(
+      DiffCallback* callback,
+      const RootId& commitHash,
+      bool listIgnored,
+      bool enforceCurrentParent,
+      folly::CancellationToken cancellation) const;
+
   /**
    * Compute the difference between the passed in roots.
    *
@@ -729,6 +790,51 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
       folly::CancellationToken cancellation,
       DiffCallback* callback);
 
+  /**
+   * Warm the object caches for an upcoming checkout to toRoot.
+   *
+   * This diffs the currently checked out root against toRoot at low fetch
+   * priority, which pulls every changed tree through the ObjectStore, then
+   * prefetches the blobs for files added or modified in toRoot. The set of
+   * changed paths is remembered and handed to the next checkout between the
+   * same pair of roots; see PrecomputedCheckout.
+   *
+   * This is an optimization only: it modifies no inode state, and a checkout
+   * to a different root (or a working copy that moves in the meantime) simply
+   * ignores the cached result.
+   */
+  FOLLY_NODISCARD ImmediateFuture<folly::Unit> prepareCheckout(RootId toRoot);
+
+  /**
+   * Consume the result of a previous prepareCheckout call, if it matches the
+   * given pair of roots. The stored result is cleared regardless of a match,
+   * so it can never outlive the checkout it was computed for.
+   */
+  std::optional<PrecomputedCheckout> takePrecomputedCheckout(
+      const RootId& fromRoot,
+      const RootId& toRoot);
+
+#ifndef _WIN32
+  /**
+   * Reclaim overlay space by dematerializing files whose contents are
+   * identical to the currently checked out commit.
+   *
+   * This walks the materialized portion of the working copy and flips
+   * unloaded file entries whose overlay contents match the corresponding
+   * source control blob (by SHA-1) back to non-materialized, removing their
+   * overlay files. At most maxFiles files are dematerialized per call.
+   *
+   * The scan only runs while the working copy is quiet: if the journal has
+   * advanced since the previous call, this is a no-op. It is invoked from
+   * the periodic overlay maintenance task; see
+   * `overlay:dematerialize-unmodified-files`.
+   *
+   * Returns the number of files dematerialized.
+   */
+  FOLLY_NODISCARD ImmediateFuture<uint64_t> dematerializeUnmodifiedFiles(
+      uint64_t maxFiles);
+#endif
+
   /**
    * This version of diff is primarily intended for testing.
    * Use diff(DiffCallback* callback, bool listIgnored) instead.
@@ -757,6 +863,28 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
    */
   SharedRenameLock acquireSharedRenameLock();
 
+  /**
+   * Get the current location generation number for this mount.
+   *
+   * The generation is bumped every time any inode's location_ changes (rename,
+   * unlink, rmdir).  Cached path data tagged with an older generation may be
+   * stale and must be recomputed.  Generation 0 is never returned, so it can
+   * be used to mean "no cached data".
+   */
+  uint64_t getLocationGeneration() const {
+    return locationGeneration_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Advance the location generation number.
+   *
+   * This is called whenever an inode's location_ is updated.  Callers always
+   * hold the mount's rename lock when changing location data.
+   */
+  void bumpLocationGeneration() {
+    locationGeneration_.fetch_add(1, std::memory_order_acq_rel);
+  }
+
   /**
    * Returns a pointer to a stats instance associated with this mountpoint.
    * Today this is the global stats instance, but in the future it will be
@@ -776,6 +904,18 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
     return inodeActivityBuffer_;
   }
 
+  const std::shared_ptr<FlightRecorder>& getFlightRecorder() {
+    return flightRecorder_;
+  }
+
+  /**
+   * The mount's rolling per-operation trace aggregation, or nullptr when
+   * disabled by config.
+   */
+  const std::shared_ptr<TracePerfAggregator>& getTracePerfAggregator() const {
+    return tracePerfAggregator_;
+  }
+
   TraceBus<InodeTraceEvent>& getInodeTraceBus() const {
     return *inodeTraceBus_;
   }
@@ -906,6 +1046,38 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
    */
   void subscribeInodeActivityBuffer();
 
+  /**
+   * Return a newly initialized FlightRecorder for the mount if the flight
+   * recorder is enabled and return nullptr otherwise. The recorder is held
+   * by shared_ptr because channel trace bus subscribers capture it, and
+   * channel destruction can be deferred past the mount's members.
+   */
+  std::shared_ptr<FlightRecorder> initFlightRecorder();
+
+  /**
+   * Subscribes flightRecorder_ to the started channel's trace bus so FUSE,
+   * NFS, or PrjFS request events are recorded alongside inode events. Called
+   * from channelInitSuccessful, which all channel start paths (including
+   * takeover) funnel through.
+   */
+  void subscribeFlightRecorderToChannel();
+
+  /**
+   * Return a newly constructed TracePerfAggregator for the mount if trace
+   * perf aggregation is enabled and nullptr otherwise. Held by shared_ptr
+   * for the same reason as the flight recorder: channel trace bus
+   * subscribers capture it, and channel destruction can be deferred past
+   * the mount's members.
+   */
+  std::shared_ptr<TracePerfAggregator> initTracePerfAggregator();
+
+  /**
+   * Subscribes tracePerfAggregator_ to the started channel's trace bus so
+   * filesystem request latencies feed the rolling aggregation. Called from
+   * channelInitSuccessful alongside the flight recorder subscription.
+   */
+  void subscribeTracePerfToChannel();
+
   /**
    * Helper function to publish a new InodeTraceEvent to the mount's
    * inodeTraceBus for telemetry. Used in FileInode, TreeInode, and InodeMap.
@@ -1087,21 +1259,17 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
   std::unique_ptr<DiffContext> createDiffContext(
       DiffCallback* callback,
       folly::CancellationToken cancellation,
-      bool listIgnored = false) const;
+      bool listIgnored = false,
+      ImportPriority fetchPriority = kDefaultImportPriority) const;
 
   /**
-   * This accepts a callback which will be invoked as differences are found.
-   * Note that the callback methods may be invoked simultaneously from multiple
-   * different threads, and the callback is responsible for performing
-   * synchronization (if it is needed). It will be packaged into a DiffContext
-   * and passed through the TreeInode diff() codepath
+   * Verify that a status/diff request against commitHash may proceed: no
+   * checkout is currently in progress and commitHash matches the working
+   * copy parent. Returns the error to report, or std::nullopt if the diff
+   * may run.
    */
-  FOLLY_NODISCARD ImmediateFuture<folly::Unit> diff(
-      DiffCallback* callback,
-      const RootId& commitHash,
-      bool listIgnored,
-      bool enforceCurrentParent,
-      folly::CancellationToken cancellation) const;
+  std::optional<EdenError> ensureParentUpToDateForDiff(
+      const RootId& commitHash) const;
 
   /**
    * Signal to unmount() that fuseMount() or takeoverFuse() has started.
@@ -1212,6 +1380,16 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
    */
   folly::SharedMutex renameMutex_;
 
+  /**
+   * Counter that is incremented every time an inode's location_ is changed.
+   *
+   * This is used to conservatively invalidate cached path computations: any
+   * rename or unlink anywhere in the mount advances the generation, marking
+   * all cached paths as potentially stale.  Starts at 1 so that 0 can mean
+   * "nothing cached".
+   */
+  std::atomic<uint64_t> locationGeneration_{1};
+
   struct ParentCommitState {
     // RootId that the working copy is checked out to
     RootId checkedOutRootId;
@@ -1235,6 +1413,42 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
   ParentLock parentState_;
 
   std::unique_ptr<Journal> journal_;
+
+  std::shared_ptr<WarmupState> warmupState_ = std::make_shared<WarmupState>();
+
+  /**
+   * The most recently computed working copy status, tagged with the journal
+   * sequence number observed before the diff walk started.
+   *
+   * A cached entry is only served when the commit hash and listIgnored flag
+   * match and the journal has not advanced since the entry was stored; any
+   * file change or checkout bumps the journal sequence and naturally
+   * invalidates it.
+   */
+  struct CachedScmStatus {
+    RootId commitHash;
+    bool listIgnored = false;
+    /** Journal::SequenceNumber of the last delta included in this status. */
+    uint64_t journalSequence = 0;
+    ScmStatus status;
+  };
+  folly::Synchronized<std::optional<CachedScmStatus>> scmStatusCache_;
+
+  /**
+   * The most recent completed prepareCheckout result, awaiting consumption
+   * by a checkout between the same pair of roots. A new prepareCheckout run
+   * replaces whatever is stored here.
+   */
+  folly::Synchronized<std::optional<PrecomputedCheckout>> precomputedCheckout_;
+
+#ifndef _WIN32
+  /**
+   * Journal::SequenceNumber observed by the previous
+   * dematerializeUnmodifiedFiles call, used to detect whether the working
+   * copy was written to between two maintenance intervals.
+   */
+  std::atomic<uint64_t> lastDematerializeJournalSequence_{0};
+#endif
   folly::Synchronized<std::unique_ptr<IActivityRecorder>> activityRecorder_;
 
   /**
@@ -1336,15 +1550,63 @@ class EdenMount : public std::enable_shared_from_this<EdenMount> {
    */
   std::optional<ActivityBuffer<InodeTraceEvent>> inodeActivityBuffer_;
 
+  /**
+   * Always-on ring of compact trace records across the mount's trace buses,
+   * dumped on demand for post-hoc analysis of stalls. Like
+   * inodeActivityBuffer_, initialization reads config through serverState_
+   * and trace bus subscriptions publish into it, so it is ordered after
+   * serverState_ and before inodeTraceBus_. nullptr when disabled.
+   */
+  std::shared_ptr<FlightRecorder> flightRecorder_;
+
+  /**
+   * Rolling per-operation aggregation across the mount's trace buses,
+   * queried by the getTracePerfStats thrift call. Ordered like
+   * flightRecorder_: after serverState_ (initialization reads config) and
+   * before inodeTraceBus_ (subscriptions publish into it). nullptr when
+   * disabled.
+   */
+  std::shared_ptr<TracePerfAggregator> tracePerfAggregator_;
+
   std::shared_ptr<TraceBus<InodeTraceEvent>> inodeTraceBus_;
 
-  // Handle for inodeTraceBus subscription
+  // Handles for inodeTraceBus subscriptions
   struct InodeTraceHandle {
     TraceSubscriptionHandle<InodeTraceEvent> subHandle;
+    TraceSubscriptionHandle<InodeTraceEvent> flightRecorderHandle;
+    TraceSubscriptionHandle<InodeTraceEvent> tracePerfHandle;
   };
 
   std::shared_ptr<InodeTraceHandle> inodeTraceHandle_;
 
+  /**
+   * Keeps the flight recorder subscribed to the channel's trace bus for the
+   * channel's lifetime. The variant matches the channel_ variant below.
+   */
+#ifdef _WIN32
+  TraceSubscriptionHandle<PrjfsTraceEvent> channelFlightRecorderHandle_;
+#else
+  std::variant<
+      std::monostate,
+      TraceSubscriptionHandle<FuseTraceEvent>,
+      TraceSubscriptionHandle<NfsTraceEvent>>
+      channelFlightRecorderHandle_;
+#endif // !_WIN32
+
+  /**
+   * Keeps the trace perf aggregator subscribed to the channel's trace bus
+   * for the channel's lifetime, like channelFlightRecorderHandle_ above.
+   */
+#ifdef _WIN32
+  TraceSubscriptionHandle<PrjfsTraceEvent> channelTracePerfHandle_;
+#else
+  std::variant<
+      std::monostate,
+      TraceSubscriptionHandle<FuseTraceEvent>,
+      TraceSubscriptionHandle<NfsTraceEvent>>
+      channelTracePerfHandle_;
+#endif // !_WIN32
+
 #ifdef _WIN32
   /**
    * This is the channel between ProjectedFS and rest of Eden.
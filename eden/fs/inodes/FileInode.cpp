@@ -57,9 +57,10 @@ namespace facebook::eden {
  */
 class FileInode::LockedState {
  public:
-  explicit LockedState(FileInode* inode) : ptr_{inode->state_.wlock()} {}
+  explicit LockedState(FileInode* inode)
+      : inode_{inode}, ptr_{inode->state_.wlock()} {}
   explicit LockedState(const FileInodePtr& inode)
-      : ptr_{inode->state_.wlock()} {}
+      : inode_{inode.get()}, ptr_{inode->state_.wlock()} {}
 
   LockedState(LockedState&&) = default;
   LockedState& operator=(LockedState&&) = default;
@@ -102,6 +103,7 @@ class FileInode::LockedState {
       BlobCache::Interest interest);
 
  private:
+  FileInode* inode_;
   folly::Synchronized<State>::LockedPtr ptr_;
 };
 
@@ -161,6 +163,9 @@ void FileInode::LockedState::setMaterialized() {
 #ifndef _WIN32
   ptr_->readByteRanges.clear();
 #endif
+  // Clear the lock-free read publication before the materializing operation
+  // completes; readers that still see the old blob are concurrent with it.
+  inode_->readFastPathBlob_.store(nullptr, std::memory_order_release);
 }
 
 /*********************************************************************
@@ -1010,59 +1015,98 @@ ImmediateFuture<folly::Unit> FileInode::ensureMaterialized(
 ImmediateFuture<std::tuple<BufVec, bool>>
 FileInode::read(size_t size, off_t off, const ObjectFetchContextPtr& context) {
   XDCHECK_GE(off, 0);
-  return runWhileDataLoaded(
-      LockedState{this},
-      BlobCache::Interest::WantHandle,
-      // This function is only called by FUSE.
-      context,
-      nullptr,
-      [size, off, self = inodePtrFromThis()](
-          LockedState&& state,
-          std::shared_ptr<const Blob> blob) -> std::tuple<BufVec, bool> {
-        SCOPE_SUCCESS {
-          self->updateAtimeLocked(*state);
-        };
 
-        // Materialized either before or during blob load.
-        if (state->tag == State::MATERIALIZED_IN_OVERLAY) {
-          // TODO(xavierd): For materialized files, only return EOF when
-          // read returned no bytes. This will force some FS Channel
-          // (like NFS) to issue at least 2 read calls: one for reading
-          // the entire file, and the second one to get the EOF bit.
-          auto buf = self->getOverlayFileAccess(state)->read(*self, size, off);
-          auto eof = size != 0 && buf->empty();
-          return {std::move(buf), eof};
-        }
+  // Fast path: a clean file with a published blob can be served without
+  // acquiring the state_ lock at all, so concurrent reads of a hot
+  // unmodified file do not serialize on it. updateAtime() and logAccess()
+  // are safe without the state lock; they only take it by convention on the
+  // locked path.
+  if (auto blob = readFastPathBlob_.load(std::memory_order_acquire)) {
+    logAccess(*context);
+    updateAtime();
+
+    const auto& contents = blob->getContents();
+    folly::io::Cursor cursor(&contents);
+    if (!cursor.canAdvance(off)) {
+      // Seek beyond EOF.  Return an empty result.
+      return std::tuple<BufVec, bool>{
+          BufVec{folly::IOBuf::wrapBuffer("", 0)}, true};
+    }
+    cursor.skip(off);
 
-        // runWhileDataLoaded() ensures that the state is either
-        // MATERIALIZED_IN_OVERLAY or BLOB_NOT_LOADING
-        XDCHECK_EQ(state->tag, State::BLOB_NOT_LOADING);
-        XDCHECK(blob) << "blob missing after load completed";
-
-        state->readByteRanges.add(off, off + size);
-        if (state->readByteRanges.covers(0, blob->getSize())) {
-          XLOG(DBG4) << "Inode " << self->getNodeId()
-                     << " dropping interest for blob " << blob->getHash()
-                     << " because it's been fully read.";
-          state->interestHandle.reset();
-          state->readByteRanges.clear();
-        }
+    std::unique_ptr<folly::IOBuf> result;
+    cursor.cloneAtMost(result, size);
+    return std::tuple<BufVec, bool>{BufVec{std::move(result)}, cursor.isAtEnd()};
+  }
 
-        auto buf = blob->getContents();
-        folly::io::Cursor cursor(&buf);
+  auto readFn = [size, off, self = inodePtrFromThis()](
+                    LockedState&& state,
+                    std::shared_ptr<const Blob> blob)
+      -> std::tuple<BufVec, bool> {
+    SCOPE_SUCCESS {
+      self->updateAtimeLocked(*state);
+    };
+
+    // Materialized either before or during blob load.
+    if (state->tag == State::MATERIALIZED_IN_OVERLAY) {
+      // TODO(xavierd): For materialized files, only return EOF when
+      // read returned no bytes. This will force some FS Channel
+      // (like NFS) to issue at least 2 read calls: one for reading
+      // the entire file, and the second one to get the EOF bit.
+      auto buf = self->getOverlayFileAccess(state)->read(*self, size, off);
+      auto eof = size != 0 && buf->empty();
+      return {std::move(buf), eof};
+    }
 
-        if (!cursor.canAdvance(off)) {
-          // Seek beyond EOF.  Return an empty result.
-          return {BufVec{folly::IOBuf::wrapBuffer("", 0)}, true};
-        }
+    // runWhileDataLoaded() ensures that the state is either
+    // MATERIALIZED_IN_OVERLAY or BLOB_NOT_LOADING
+    XDCHECK_EQ(state->tag, State::BLOB_NOT_LOADING);
+    XDCHECK(blob) << "blob missing after load completed";
+
+    state->readByteRanges.add(off, off + size);
+    if (state->readByteRanges.covers(0, blob->getSize())) {
+      XLOG(DBG4) << "Inode " << self->getNodeId()
+                 << " dropping interest for blob " << blob->getHash()
+                 << " because it's been fully read.";
+      state->interestHandle.reset();
+      state->readByteRanges.clear();
+      self->readFastPathBlob_.store(nullptr, std::memory_order_release);
+    } else {
+      // A partially read clean file is likely to see more reads soon.
+      // Publish the blob so those reads can be served without taking the
+      // state lock; see readFastPathBlob_. Fast-path reads do not update
+      // readByteRanges, so coverage tracking resumes only if the
+      // publication is dropped.
+      self->readFastPathBlob_.store(blob, std::memory_order_release);
+    }
+
+    auto buf = blob->getContents();
+    folly::io::Cursor cursor(&buf);
 
-        cursor.skip(off);
+    if (!cursor.canAdvance(off)) {
+      // Seek beyond EOF.  Return an empty result.
+      return {BufVec{folly::IOBuf::wrapBuffer("", 0)}, true};
+    }
 
-        std::unique_ptr<folly::IOBuf> result;
-        cursor.cloneAtMost(result, size);
+    cursor.skip(off);
 
-        return {BufVec{std::move(result)}, cursor.isAtEnd()};
-      });
+    std::unique_ptr<folly::IOBuf> result;
+    cursor.cloneAtMost(result, size);
+
+    return {BufVec{std::move(result)}, cursor.isAtEnd()};
+  };
+  // This continuation rides the FUSE read hot path; keep its captures within
+  // folly::Function's inline storage so the deferred path stays
+  // allocation-free.
+  EDEN_ASSERT_CONTINUATION_CAPTURE_LE(
+      readFn, detail::kMaxInlineContinuationSize);
+  return runWhileDataLoaded(
+      LockedState{this},
+      BlobCache::Interest::WantHandle,
+      // This function is only called by FUSE.
+      context,
+      nullptr,
+      std::move(readFn));
 }
 
 size_t FileInode::writeImpl(
@@ -1083,17 +1127,47 @@ size_t FileInode::writeImpl(
   return xfer;
 }
 
+bool FileInode::isWholeFileOverwrite(
+    const LockedState& state,
+    off_t offset,
+    size_t length) {
+  if (state->tag == State::MATERIALIZED_IN_OVERLAY) {
+    return false;
+  }
+  const auto& nonMaterializedState = state->nonMaterializedState;
+  return offset == 0 &&
+      nonMaterializedState->size !=
+      FileInodeState::NonMaterializedState::kUnknownSize &&
+      length >= nonMaterializedState->size;
+}
+
 ImmediateFuture<size_t> FileInode::write(
     BufVec&& buf,
     off_t off,
     const ObjectFetchContextPtr& fetchContext) {
+  auto state = LockedState{this};
+
+  // Like the explicit-truncation case in setattr(), a write that replaces
+  // the file's entire contents doesn't need the underlying data: every byte
+  // copied out of the blob would be immediately overwritten. Materialize
+  // through the truncation path instead of fetching the blob.
+  if (isWholeFileOverwrite(state, off, buf->computeChainDataLength())) {
+    return truncateAndRun(
+        std::move(state),
+        [buf = std::move(buf), off, self = inodePtrFromThis()](
+            LockedState&& stateLock) {
+          auto vec = buf->getIov();
+          return self->writeImpl(stateLock, vec.data(), vec.size(), off);
+        });
+  }
+
   return runWhileMaterialized(
-      LockedState{this},
+      std::move(state),
       nullptr,
       [buf = std::move(buf), off, self = inodePtrFromThis()](
-          LockedState&& state) {
+          LockedState&& stateLock) {
         auto vec = buf->getIov();
-        return self->writeImpl(state, vec.data(), vec.size(), off);
+        return self->writeImpl(stateLock, vec.data(), vec.size(), off);
       },
       fetchContext);
 }
@@ -1112,6 +1186,20 @@ ImmediateFuture<size_t> FileInode::write(
     return writeImpl(state, &iov, 1, off);
   }
 
+  // See the BufVec overload above: a whole-file overwrite doesn't need the
+  // blob contents, so skip the copying materialization.
+  if (isWholeFileOverwrite(state, off, data.size())) {
+    return truncateAndRun(
+        std::move(state),
+        [data = data.str(), off, self = inodePtrFromThis()](
+            LockedState&& stateLock) {
+          struct iovec iov;
+          iov.iov_base = const_cast<char*>(data.data());
+          iov.iov_len = data.size();
+          return self->writeImpl(stateLock, &iov, 1, off);
+        });
+  }
+
   return runWhileMaterialized(
       std::move(state),
       nullptr,
@@ -1223,7 +1311,22 @@ void FileInode::materializeNow(
     blobSha1 = std::move(blobSha1Future).get();
   }
 
-  getOverlayFileAccess(state)->createFile(getNodeId(), *blob, blobSha1);
+  // Classify the write for the overlay I/O scheduler: checkout drives
+  // materialization through Thrift and its bulk writes may be throttled,
+  // while filesystem-driven materialization stays interactive.
+  auto ioClass = OverlayIoScheduler::IoClass::Interactive;
+  switch (fetchContext->getCause()) {
+    case ObjectFetchContext::Cause::Thrift:
+      ioClass = OverlayIoScheduler::IoClass::CheckoutBulk;
+      break;
+    case ObjectFetchContext::Cause::Prefetch:
+      ioClass = OverlayIoScheduler::IoClass::Background;
+      break;
+    case ObjectFetchContext::Cause::Fs:
+    case ObjectFetchContext::Cause::Unknown:
+      break;
+  }
+  getOverlayFileAccess(state)->createFile(getNodeId(), *blob, blobSha1, ioClass);
 
   state.setMaterialized();
 }
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <folly/Synchronized.h>
+#include <folly/concurrency/AtomicSharedPtr.h>
 #include <folly/futures/SharedPromise.h>
 #include <chrono>
 #include <optional>
@@ -351,6 +352,23 @@ class FileInode final : public InodeBaseMetadata<FileInodeState> {
       LockedState state,
       Fn&& fn);
 
+  /**
+   * Returns true if a write of `length` bytes at `offset` to a file that is
+   * not yet materialized is known to replace the file's entire contents.
+   *
+   * In that case the caller can materialize through truncateAndRun() and
+   * skip fetching and copying the blob, since every existing byte would be
+   * immediately overwritten. Only returns true when a previous stat cached
+   * the non-materialized file's size; when the size is unknown the regular
+   * copying path must be used.
+   *
+   * The state lock must be held.
+   */
+  static bool isWholeFileOverwrite(
+      const LockedState& state,
+      off_t offset,
+      size_t length);
+
 #endif // !_WIN32
 
   /**
@@ -482,6 +500,26 @@ class FileInode final : public InodeBaseMetadata<FileInodeState> {
 
   folly::Synchronized<State> state_;
 
+  /**
+   * Lock-free fast path for read() on clean files.
+   *
+   * Holds the blob last served under the state_ lock while the inode was in
+   * the BLOB_NOT_LOADING state, or null when no blob is published. read()
+   * serves directly from this pointer without acquiring state_, so
+   * concurrent reads of a hot unmodified file do not serialize on the state
+   * lock. Publication and invalidation both happen under the state_ lock:
+   * setMaterialized() clears the pointer before the materializing operation
+   * completes, so a reader that still observes a blob here is concurrent
+   * with that operation and may correctly return the pre-write contents.
+   *
+   * Publishing pins the blob independently of the BlobCache, so it is only
+   * populated for partially read files (likely to see more reads soon) and
+   * cleared once the file has been fully read, alongside the interest
+   * handle. Only read() on POSIX systems consults it; on Windows it stays
+   * null.
+   */
+  folly::atomic_shared_ptr<const Blob> readFastPathBlob_;
+
   // So it can call inodePtrFromThis() for better error messages.
   friend class ::facebook::eden::OverlayFileAccess;
 };
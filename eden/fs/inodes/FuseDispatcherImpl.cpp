@@ -16,8 +16,10 @@
 #include "eden/fs/inodes/InodePtr.h"
 #include "eden/fs/inodes/Overlay.h"
 #include "eden/fs/inodes/TreeInode.h"
+#include "eden/fs/journal/Journal.h"
 #include "eden/fs/store/ObjectFetchContext.h"
 #include "eden/fs/utils/Clock.h"
+#include "eden/fs/utils/ImmediateFutureAudit.h"
 #include "eden/fs/utils/SystemError.h"
 
 using namespace folly;
@@ -45,6 +47,31 @@ fuse_entry_out computeEntryParam(const FuseDispatcher::Attr& attr) {
 
 constexpr int64_t kBrokenInodeCacheSeconds = 5;
 
+/**
+ * The maximum number of serialized readdir payloads retained when
+ * fuse:readdir-cache is enabled. Payloads are at most one FUSE read's worth
+ * of dirents (typically 4-128 KiB), so this keeps the cache to a few MiB.
+ */
+constexpr size_t kReaddirCacheMaxEntries = 256;
+
+/**
+ * The maximum number of negative lookup entries retained when
+ * fuse:negative-lookup-cache is enabled. Each entry is just a path
+ * component and two integers, so this is a few hundred KiB at worst.
+ */
+constexpr size_t kNegativeLookupCacheMaxEntries = 8192;
+
+/**
+ * A successful reply with inode number 0 and a large entry_valid time,
+ * which tells the kernel to cache the fact that this name does not exist.
+ */
+fuse_entry_out negativeEntryParam() {
+  fuse_entry_out entry = {};
+  entry.attr_valid = std::numeric_limits<decltype(entry.attr_valid)>::max();
+  entry.entry_valid = std::numeric_limits<decltype(entry.entry_valid)>::max();
+  return entry;
+}
+
 FuseDispatcher::Attr attrForInodeWithCorruptOverlay(InodeNumber ino) noexcept {
   struct stat st = {};
   st.st_ino = ino.get();
@@ -56,17 +83,48 @@ FuseDispatcher::Attr attrForInodeWithCorruptOverlay(InodeNumber ino) noexcept {
 FuseDispatcherImpl::FuseDispatcherImpl(EdenMount* mount)
     : FuseDispatcher(mount->getStats()),
       mount_(mount),
-      inodeMap_(mount_->getInodeMap()) {}
+      inodeMap_(mount_->getInodeMap()),
+      cacheValidSeconds_(
+          mount_->getEdenConfig()->fuseCacheValidSeconds.getValue()),
+      readdirCacheEnabled_(
+          mount_->getEdenConfig()->fuseReaddirCache.getValue()),
+      negativeLookupCacheEnabled_(
+          mount_->getEdenConfig()->fuseNegativeLookupCache.getValue()),
+      attributeCacheEnabled_(
+          mount_->getEdenConfig()->attributeCache.getValue()),
+      readdirCache_(std::in_place, kReaddirCacheMaxEntries),
+      negativeLookupCache_(std::in_place, kNegativeLookupCacheMaxEntries) {}
 
 ImmediateFuture<FuseDispatcher::Attr> FuseDispatcherImpl::getattr(
     InodeNumber ino,
     const ObjectFetchContextPtr& context) {
-  return inodeMap_->lookupInode(ino)
-      .thenValue([context = context.copy()](const InodePtr& inode) {
-        return inode->stat(context);
-      })
-      .thenValue(
-          [](const struct stat& st) { return FuseDispatcher::Attr{st}; });
+  // As with the negative lookup cache, the journal sequence is read before
+  // the stat is computed so that a concurrent modification prevents the
+  // entry recorded below from ever being served.
+  uint64_t journalSequence = 0;
+  if (attributeCacheEnabled_) {
+    journalSequence = mount_->getJournal().getLatestSequenceID();
+    if (auto st = attributeCache_.get(ino, journalSequence)) {
+      getStats()->increment(&FuseStats::getattrCacheHit);
+      return FuseDispatcher::Attr{*st, cacheValidSeconds_};
+    }
+    getStats()->increment(&FuseStats::getattrCacheMiss);
+  }
+
+  auto fut =
+      inodeMap_->lookupInode(ino)
+          .thenValue([context = context.copy()](const InodePtr& inode) {
+            return inode->stat(context);
+          })
+          .thenValue([this, ino, journalSequence, timeout = cacheValidSeconds_](
+                         const struct stat& st) {
+            if (attributeCacheEnabled_) {
+              attributeCache_.set(ino, journalSequence, st);
+            }
+            return FuseDispatcher::Attr{st, timeout};
+          });
+  EDEN_AUDIT_IMMEDIATE_FUTURE(fut);
+  return fut;
 }
 
 ImmediateFuture<uint64_t> FuseDispatcherImpl::opendir(
@@ -95,18 +153,38 @@ ImmediateFuture<fuse_entry_out> FuseDispatcherImpl::lookup(
     InodeNumber parent,
     PathComponentPiece namepiece,
     const ObjectFetchContextPtr& context) {
-  return inodeMap_->lookupTreeInode(parent)
+  // Read the journal sequence before the lookup. If a concurrent
+  // modification races with the walk below it bumps the sequence, so a
+  // negative entry recorded against the older sequence can never be served.
+  uint64_t journalSequence = 0;
+  if (negativeLookupCacheEnabled_) {
+    journalSequence = mount_->getJournal().getLatestSequenceID();
+    const NegativeLookupCacheKey key{parent.get(), PathComponent{namepiece}};
+    auto cache = negativeLookupCache_.wlock();
+    auto it = cache->find(key);
+    if (it != cache->end()) {
+      if (it->second == journalSequence) {
+        getStats()->increment(&FuseStats::lookupNegativeCacheHit);
+        return negativeEntryParam();
+      }
+      cache->erase(it);
+    }
+    getStats()->increment(&FuseStats::lookupNegativeCacheMiss);
+  }
+
+  auto fut = inodeMap_->lookupTreeInode(parent)
       .thenValue([name = PathComponent(namepiece),
                   context = context.copy()](const TreeInodePtr& tree) {
         return tree->getOrLoadChild(name, context);
       })
-      .thenValue([context = context.copy()](const InodePtr& inode) {
+      .thenValue([context = context.copy(),
+                  timeout = cacheValidSeconds_](const InodePtr& inode) {
         return makeImmediateFutureWith([&]() { return inode->stat(context); })
-            .thenTry([inode](folly::Try<struct stat> maybeStat) {
+            .thenTry([inode, timeout](folly::Try<struct stat> maybeStat) {
               if (maybeStat.hasValue()) {
                 inode->incFsRefcount();
                 return computeEntryParam(
-                    FuseDispatcher::Attr{maybeStat.value()});
+                    FuseDispatcher::Attr{maybeStat.value(), timeout});
               } else {
                 // The most common case for stat() failing is if this file is
                 // materialized but the data for it in the overlay is missing
@@ -131,22 +209,27 @@ ImmediateFuture<fuse_entry_out> FuseDispatcherImpl::lookup(
               }
             });
       })
-      .thenTry([](folly::Try<fuse_entry_out> try_) {
+      .thenTry([this,
+                parent,
+                name = PathComponent{namepiece},
+                journalSequence](folly::Try<fuse_entry_out> try_) mutable {
         if (auto* err = try_.tryGetExceptionObject<std::system_error>()) {
           if (isEnoent(*err)) {
+            if (negativeLookupCacheEnabled_) {
+              negativeLookupCache_.wlock()->set(
+                  NegativeLookupCacheKey{parent.get(), std::move(name)},
+                  journalSequence);
+            }
             // Translate ENOENT into a successful response with an
             // inode number of 0 and a large entry_valid time, to let the kernel
             // cache this negative lookup result.
-            fuse_entry_out entry = {};
-            entry.attr_valid =
-                std::numeric_limits<decltype(entry.attr_valid)>::max();
-            entry.entry_valid =
-                std::numeric_limits<decltype(entry.entry_valid)>::max();
-            return folly::Try<fuse_entry_out>{entry};
+            return folly::Try<fuse_entry_out>{negativeEntryParam()};
           }
         }
         return try_;
       });
+  EDEN_AUDIT_IMMEDIATE_FUTURE(fut);
+  return fut;
 }
 
 ImmediateFuture<FuseDispatcher::Attr> FuseDispatcherImpl::setattr(
@@ -199,8 +282,8 @@ ImmediateFuture<FuseDispatcher::Attr> FuseDispatcherImpl::setattr(
 
         return inode->setattr(desired, context);
       })
-      .thenValue([](struct stat&& stat) {
-        return FuseDispatcher::Attr{std::move(stat)};
+      .thenValue([timeout = cacheValidSeconds_](struct stat&& stat) {
+        return FuseDispatcher::Attr{std::move(stat), timeout};
       });
 }
 
@@ -232,13 +315,15 @@ ImmediateFuture<fuse_entry_out> FuseDispatcherImpl::create(
   // (and thus can be zero)
   mode = S_IFREG | (07777 & mode);
   return inodeMap_->lookupTreeInode(parent).thenValue(
-      [mode, childName = PathComponent{name}, context = context.copy()](
-          const TreeInodePtr& inode) {
+      [mode,
+       childName = PathComponent{name},
+       context = context.copy(),
+       timeout = cacheValidSeconds_](const TreeInodePtr& inode) {
         auto child = inode->mknod(childName, mode, 0, InvalidationRequired::No);
         return child->stat(context).thenValue(
-            [child](struct stat st) -> fuse_entry_out {
+            [child, timeout](struct stat st) -> fuse_entry_out {
               child->incFsRefcount();
-              return computeEntryParam(FuseDispatcher::Attr{st});
+              return computeEntryParam(FuseDispatcher::Attr{st, timeout});
             });
       });
 }
@@ -248,13 +333,15 @@ ImmediateFuture<BufVec> FuseDispatcherImpl::read(
     size_t size,
     off_t off,
     const ObjectFetchContextPtr& context) {
-  return inodeMap_->lookupFileInode(ino).thenValue(
+  auto fut = inodeMap_->lookupFileInode(ino).thenValue(
       [context = context.copy(), size, off](FileInodePtr&& inode) {
         return inode->read(size, off, context)
             .thenValue([](std::tuple<BufVec, bool>&& readRes) {
               return std::get<BufVec>(std::move(readRes));
             });
       });
+  EDEN_AUDIT_IMMEDIATE_FUTURE(fut);
+  return fut;
 }
 
 ImmediateFuture<size_t> FuseDispatcherImpl::write(
@@ -262,10 +349,12 @@ ImmediateFuture<size_t> FuseDispatcherImpl::write(
     folly::StringPiece data,
     off_t off,
     const ObjectFetchContextPtr& context) {
-  return inodeMap_->lookupFileInode(ino).thenValue(
+  auto fut = inodeMap_->lookupFileInode(ino).thenValue(
       [copy = data.str(), off, context = context.copy()](FileInodePtr&& inode) {
         return inode->write(copy, off, context);
       });
+  EDEN_AUDIT_IMMEDIATE_FUTURE(fut);
+  return fut;
 }
 
 ImmediateFuture<Unit> FuseDispatcherImpl::flush(
@@ -329,10 +418,47 @@ ImmediateFuture<FuseDirList> FuseDispatcherImpl::readdir(
     off_t offset,
     uint64_t /*fh*/,
     const ObjectFetchContextPtr& context) {
+  if (!readdirCacheEnabled_) {
+    return inodeMap_->lookupTreeInode(ino).thenValue(
+        [dirList = std::move(dirList), offset, context = context.copy()](
+            TreeInodePtr inode) mutable {
+          return inode->fuseReaddir(std::move(dirList), offset, context);
+        });
+  }
+
+  // Read the journal sequence before computing the listing. If a concurrent
+  // modification races with the walk below, it bumps the sequence and the
+  // entry we store simply never matches again; we can never serve a listing
+  // that is staler than the sequence it is keyed to.
+  const auto journalSequence = mount_->getJournal().getLatestSequenceID();
+  const ReaddirCacheKey key{ino.get(), static_cast<uint64_t>(offset)};
+  {
+    auto cache = readdirCache_.wlock();
+    auto it = cache->find(key);
+    if (it != cache->end()) {
+      if (it->second.journalSequence == journalSequence &&
+          it->second.payload.size() <= dirList.capacity()) {
+        dirList.assign(it->second.payload);
+        return std::move(dirList);
+      }
+      cache->erase(it);
+    }
+  }
+
   return inodeMap_->lookupTreeInode(ino).thenValue(
-      [dirList = std::move(dirList), offset, context = context.copy()](
-          TreeInodePtr inode) mutable {
-        return inode->fuseReaddir(std::move(dirList), offset, context);
+      [this,
+       key,
+       journalSequence,
+       dirList = std::move(dirList),
+       offset,
+       context = context.copy()](TreeInodePtr inode) mutable {
+        auto list = inode->fuseReaddir(std::move(dirList), offset, context);
+        auto buf = list.getBuf();
+        if (!buf.empty()) {
+          readdirCache_.wlock()->set(
+              key, ReaddirCacheEntry{journalSequence, buf.str()});
+        }
+        return list;
       });
 }
 
@@ -343,14 +469,17 @@ ImmediateFuture<fuse_entry_out> FuseDispatcherImpl::mknod(
     dev_t rdev,
     const ObjectFetchContextPtr& context) {
   return inodeMap_->lookupTreeInode(parent).thenValue(
-      [childName = PathComponent{name}, mode, rdev, context = context.copy()](
-          const TreeInodePtr& inode) {
+      [childName = PathComponent{name},
+       mode,
+       rdev,
+       context = context.copy(),
+       timeout = cacheValidSeconds_](const TreeInodePtr& inode) {
         auto child =
             inode->mknod(childName, mode, rdev, InvalidationRequired::No);
         return child->stat(context).thenValue(
-            [child](struct stat st) -> fuse_entry_out {
+            [child, timeout](struct stat st) -> fuse_entry_out {
               child->incFsRefcount();
-              return computeEntryParam(FuseDispatcher::Attr{st});
+              return computeEntryParam(FuseDispatcher::Attr{st, timeout});
             });
       });
 }
@@ -361,12 +490,14 @@ ImmediateFuture<fuse_entry_out> FuseDispatcherImpl::mkdir(
     mode_t mode,
     const ObjectFetchContextPtr& context) {
   return inodeMap_->lookupTreeInode(parent).thenValue(
-      [childName = PathComponent{name}, mode, context = context.copy()](
-          const TreeInodePtr& inode) {
+      [childName = PathComponent{name},
+       mode,
+       context = context.copy(),
+       timeout = cacheValidSeconds_](const TreeInodePtr& inode) {
         auto child = inode->mkdir(childName, mode, InvalidationRequired::No);
-        return child->stat(context).thenValue([child](struct stat st) {
+        return child->stat(context).thenValue([child, timeout](struct stat st) {
           child->incFsRefcount();
-          return computeEntryParam(FuseDispatcher::Attr{st});
+          return computeEntryParam(FuseDispatcher::Attr{st, timeout});
         });
       });
 }
@@ -403,13 +534,14 @@ ImmediateFuture<fuse_entry_out> FuseDispatcherImpl::symlink(
   return inodeMap_->lookupTreeInode(parent).thenValue(
       [linkContents = link.str(),
        childName = PathComponent{name},
-       context = context.copy()](const TreeInodePtr& inode) {
+       context = context.copy(),
+       timeout = cacheValidSeconds_](const TreeInodePtr& inode) {
         auto symlinkInode =
             inode->symlink(childName, linkContents, InvalidationRequired::No);
         symlinkInode->incFsRefcount();
         return symlinkInode->stat(context).thenValue(
-            [symlinkInode](struct stat st) {
-              return computeEntryParam(FuseDispatcher::Attr{st});
+            [symlinkInode, timeout](struct stat st) {
+              return computeEntryParam(FuseDispatcher::Attr{st, timeout});
             });
       });
 }
@@ -7,7 +7,13 @@
 
 #pragma once
 
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <folly/hash/Hash.h>
+
+#include "eden/fs/fuse/DirList.h"
 #include "eden/fs/fuse/FuseDispatcher.h"
+#include "eden/fs/inodes/InodeAttributeCache.h"
 
 namespace facebook::eden {
 
@@ -126,6 +132,43 @@ class FuseDispatcherImpl : public FuseDispatcher {
   ImmediateFuture<std::vector<std::string>> listxattr(InodeNumber ino) override;
 
  private:
+  struct ReaddirCacheKey {
+    uint64_t ino;
+    uint64_t offset;
+
+    bool operator==(const ReaddirCacheKey& other) const {
+      return ino == other.ino && offset == other.offset;
+    }
+  };
+
+  struct ReaddirCacheKeyHash {
+    size_t operator()(const ReaddirCacheKey& key) const {
+      return folly::hash::hash_combine(key.ino, key.offset);
+    }
+  };
+
+  struct ReaddirCacheEntry {
+    // The journal sequence number at the time the listing was computed. The
+    // entry is only valid while this matches the journal's current tip.
+    uint64_t journalSequence;
+    std::string payload;
+  };
+
+  struct NegativeLookupCacheKey {
+    uint64_t parent;
+    PathComponent name;
+
+    bool operator==(const NegativeLookupCacheKey& other) const {
+      return parent == other.parent && name == other.name;
+    }
+  };
+
+  struct NegativeLookupCacheKeyHash {
+    size_t operator()(const NegativeLookupCacheKey& key) const {
+      return folly::hash::hash_combine(key.parent, key.name.view());
+    }
+  };
+
   // The EdenMount associated with this dispatcher.
   EdenMount* const mount_;
 
@@ -134,6 +177,54 @@ class FuseDispatcherImpl : public FuseDispatcher {
   // every FUSE request, and having it locally avoids having to dereference
   // mount_ first.
   InodeMap* const inodeMap_;
+
+  // How long the kernel may cache the attributes and directory entries we
+  // return before revalidating with getattr/lookup. Read from
+  // fuse:cache-valid-seconds at mount time. The default is effectively
+  // infinite, because EdenFS explicitly invalidates the kernel's caches when
+  // files change behind its back (checkout, journal-driven invalidation)
+  // rather than relying on TTL expiry.
+  const uint64_t cacheValidSeconds_;
+
+  // Whether readdirCache_ is consulted at all. Read from fuse:readdir-cache
+  // at mount time.
+  const bool readdirCacheEnabled_;
+
+  // Whether negativeLookupCache_ is consulted at all. Read from
+  // fuse:negative-lookup-cache at mount time.
+  const bool negativeLookupCacheEnabled_;
+
+  // Whether attributeCache_ is consulted at all. Read from
+  // mount:attribute-cache at mount time.
+  const bool attributeCacheEnabled_;
+
+  // Caches serialized readdir payloads keyed by (inode, offset) so that
+  // repeated enumerations of an unchanged directory are a memcpy instead of a
+  // TreeInode contents walk. Entries are keyed to the journal sequence number
+  // observed before the listing was computed; any subsequent modification to
+  // the mount bumps the sequence and implicitly invalidates the whole cache.
+  folly::Synchronized<folly::EvictingCacheMap<
+      ReaddirCacheKey,
+      ReaddirCacheEntry,
+      ReaddirCacheKeyHash>>
+      readdirCache_;
+
+  // Caches (parent inode, name) pairs known not to exist so that repeated
+  // probes for the same missing names (build tools checking for BUCK,
+  // .buckconfig, etc. at every level) skip the inode tree entirely. Like
+  // readdirCache_, entries record the journal sequence number observed
+  // before the lookup and are implicitly invalidated by any modification to
+  // the mount.
+  folly::Synchronized<folly::EvictingCacheMap<
+      NegativeLookupCacheKey,
+      uint64_t,
+      NegativeLookupCacheKeyHash>>
+      negativeLookupCache_;
+
+  // Caches computed stat results keyed by inode number, stamped with the
+  // journal sequence observed before the stat was computed. See
+  // InodeAttributeCache for the invalidation contract.
+  InodeAttributeCache attributeCache_;
 };
 
 } // namespace facebook::eden
@@ -143,6 +143,32 @@ struct TreeRoot {
     return !entryIsTree(entry);
   }
 };
+
+/**
+ * Attach func as a continuation of fut, either inline or as a task scheduled
+ * on the executor when one is provided.
+ *
+ * An inline continuation runs the whole subtree walk it starts on whichever
+ * thread resolved the tree (the calling thread when the tree was cached), so
+ * a warm glob is single threaded. Hopping through the executor at each
+ * directory level instead fans sibling subtrees out across its threads.
+ */
+template <typename T, typename Func>
+ImmediateFuture<folly::Unit> evaluateSubtree(
+    folly::Executor* executor,
+    ImmediateFuture<T> fut,
+    Func func) {
+  if (!executor) {
+    return std::move(fut).thenValue(std::move(func));
+  }
+  return std::move(fut)
+      .semi()
+      .via(executor)
+      .thenValue([func = std::move(func)](T&& value) mutable {
+        return func(std::move(value)).semi();
+      })
+      .semi();
+}
 } // namespace
 
 GlobNode::GlobNode(
@@ -238,7 +264,8 @@ ImmediateFuture<folly::Unit> GlobNode::evaluateImpl(
     ROOT&& root,
     GlobNode::PrefetchList* fileBlobsToPrefetch,
     GlobNode::ResultList& globResult,
-    const RootId& originRootId) const {
+    const RootId& originRootId,
+    folly::Executor* executor) const {
   vector<std::pair<PathComponentPiece, GlobNode*>> recurse;
   vector<ImmediateFuture<folly::Unit>> futures;
 
@@ -251,7 +278,8 @@ ImmediateFuture<folly::Unit> GlobNode::evaluateImpl(
         root,
         fileBlobsToPrefetch,
         globResult,
-        originRootId));
+        originRootId,
+        executor));
   }
 
   auto recurseIfNecessary =
@@ -261,60 +289,76 @@ ImmediateFuture<folly::Unit> GlobNode::evaluateImpl(
           if (root.entryShouldLoadChildTree(entry)) {
             recurse.emplace_back(name, node);
           } else {
-            futures.emplace_back(
-                store->getTree(entry->getHash(), context)
-                    .thenValue([candidateName = rootPath + name,
-                                store,
-                                context = context.copy(),
-                                innerNode = node,
-                                fileBlobsToPrefetch,
-                                &globResult,
-                                &originRootId](
-                                   std::shared_ptr<const Tree> dir) mutable {
-                      return innerNode->evaluateImpl(
-                          store,
-                          context,
-                          candidateName,
-                          TreeRoot(std::move(dir)),
-                          fileBlobsToPrefetch,
-                          globResult,
-                          originRootId);
-                    }));
+            futures.emplace_back(evaluateSubtree(
+                executor,
+                store->getTree(entry->getHash(), context),
+                [candidateName = rootPath + name,
+                 store,
+                 context = context.copy(),
+                 innerNode = node,
+                 fileBlobsToPrefetch,
+                 &globResult,
+                 &originRootId,
+                 executor](std::shared_ptr<const Tree> dir) mutable {
+                  return innerNode->evaluateImpl(
+                      store,
+                      context,
+                      candidateName,
+                      TreeRoot(std::move(dir)),
+                      fileBlobsToPrefetch,
+                      globResult,
+                      originRootId,
+                      executor);
+                }));
           }
         }
       };
 
   {
     const auto& contents = root.lockContents();
+
+    // Children with glob special characters cannot use the name lookup
+    // below and have to be matched against every entry. Collect them so
+    // the directory contents are scanned once for all of them; a large
+    // prefetch profile can compile into dozens of special siblings at one
+    // level, and scanning the directory once per sibling made evaluating
+    // such profiles CPU-bound.
+    vector<GlobNode*> specialChildren;
+
     for (auto& node : children_) {
-      if (!node->hasSpecials_) {
-        // We can try a lookup for the exact name
-        PathComponentPiece name{node->pattern_};
-        auto entry = root.lookupEntry(contents, name);
-        if (entry) {
-          // Matched!
-
-          // Update the name to reflect the entry's actual case
-          name = entry->first;
-
-          if (node->isLeaf_) {
-            globResult.wlock()->emplace_back(
-                rootPath + name, entry->second.getDtype(), originRootId);
-
-            if (fileBlobsToPrefetch &&
-                root.entryShouldPrefetch(&entry->second)) {
-              fileBlobsToPrefetch->wlock()->emplace_back(
-                  entry->second.getHash());
-            }
-          }
+      if (node->hasSpecials_) {
+        specialChildren.emplace_back(node.get());
+        continue;
+      }
 
-          // Not the leaf of a pattern; if this is a dir, we need to recurse
-          recurseIfNecessary(name, node.get(), &entry->second);
+      // We can try a lookup for the exact name
+      PathComponentPiece name{node->pattern_};
+      auto entry = root.lookupEntry(contents, name);
+      if (entry) {
+        // Matched!
+
+        // Update the name to reflect the entry's actual case
+        name = entry->first;
+
+        if (node->isLeaf_) {
+          globResult.wlock()->emplace_back(
+              rootPath + name, entry->second.getDtype(), originRootId);
+
+          if (fileBlobsToPrefetch && root.entryShouldPrefetch(&entry->second)) {
+            fileBlobsToPrefetch->wlock()->emplace_back(entry->second.getHash());
+          }
         }
-      } else {
-        // We need to match it out of the entries in this inode
-        for (auto& entry : root.iterate(contents)) {
-          PathComponentPiece name = entry.first;
+
+        // Not the leaf of a pattern; if this is a dir, we need to recurse
+        recurseIfNecessary(name, node.get(), &entry->second);
+      }
+    }
+
+    if (!specialChildren.empty()) {
+      // We need to match them out of the entries in this inode
+      for (auto& entry : root.iterate(contents)) {
+        PathComponentPiece name = entry.first;
+        for (auto* node : specialChildren) {
           if (node->alwaysMatch_ || node->matcher_.match(name.view())) {
             if (node->isLeaf_) {
               globResult.wlock()->emplace_back(
@@ -327,7 +371,7 @@ ImmediateFuture<folly::Unit> GlobNode::evaluateImpl(
             }
             // Not the leaf of a pattern; if this is a dir, we need to
             // recurse
-            recurseIfNecessary(name, node.get(), &entry.second);
+            recurseIfNecessary(name, node, &entry.second);
           }
         }
       }
@@ -337,23 +381,27 @@ ImmediateFuture<folly::Unit> GlobNode::evaluateImpl(
   // Recursively load child inodes and evaluate matches
 
   for (auto& item : recurse) {
-    futures.emplace_back(root.getOrLoadChildTree(item.first, context)
-                             .thenValue([store,
-                                         context = context.copy(),
-                                         candidateName = rootPath + item.first,
-                                         node = item.second,
-                                         fileBlobsToPrefetch,
-                                         &globResult,
-                                         &originRootId](TreeInodePtr dir) {
-                               return node->evaluateImpl(
-                                   store,
-                                   context,
-                                   candidateName,
-                                   TreeInodePtrRoot(std::move(dir)),
-                                   fileBlobsToPrefetch,
-                                   globResult,
-                                   originRootId);
-                             }));
+    futures.emplace_back(evaluateSubtree(
+        executor,
+        root.getOrLoadChildTree(item.first, context),
+        [store,
+         context = context.copy(),
+         candidateName = rootPath + item.first,
+         node = item.second,
+         fileBlobsToPrefetch,
+         &globResult,
+         &originRootId,
+         executor](TreeInodePtr dir) {
+          return node->evaluateImpl(
+              store,
+              context,
+              candidateName,
+              TreeInodePtrRoot(std::move(dir)),
+              fileBlobsToPrefetch,
+              globResult,
+              originRootId,
+              executor);
+        }));
   }
 
   // Note: we use collectAll() rather than collect() here to make sure that
@@ -376,7 +424,8 @@ ImmediateFuture<folly::Unit> GlobNode::evaluate(
     TreeInodePtr root,
     GlobNode::PrefetchList* fileBlobsToPrefetch,
     GlobNode::ResultList& globResult,
-    const RootId& originRootId) const {
+    const RootId& originRootId,
+    folly::Executor* executor) const {
   return evaluateImpl(
       store,
       context,
@@ -384,7 +433,8 @@ ImmediateFuture<folly::Unit> GlobNode::evaluate(
       TreeInodePtrRoot(std::move(root)),
       fileBlobsToPrefetch,
       globResult,
-      originRootId);
+      originRootId,
+      executor);
 }
 
 ImmediateFuture<folly::Unit> GlobNode::evaluate(
@@ -394,7 +444,8 @@ ImmediateFuture<folly::Unit> GlobNode::evaluate(
     std::shared_ptr<const Tree> tree,
     GlobNode::PrefetchList* fileBlobsToPrefetch,
     GlobNode::ResultList& globResult,
-    const RootId& originRootId) const {
+    const RootId& originRootId,
+    folly::Executor* executor) const {
   return evaluateImpl(
       store,
       context,
@@ -402,7 +453,8 @@ ImmediateFuture<folly::Unit> GlobNode::evaluate(
       TreeRoot(std::move(tree)),
       fileBlobsToPrefetch,
       globResult,
-      originRootId);
+      originRootId,
+      executor);
 }
 
 StringPiece GlobNode::tokenize(StringPiece& pattern, bool* hasSpecials) {
@@ -452,7 +504,8 @@ ImmediateFuture<folly::Unit> GlobNode::evaluateRecursiveComponentImpl(
     ROOT&& root,
     GlobNode::PrefetchList* fileBlobsToPrefetch,
     GlobNode::ResultList& globResult,
-    const RootId& originRootId) const {
+    const RootId& originRootId,
+    folly::Executor* executor) const {
   vector<RelativePath> subDirNames;
   vector<ImmediateFuture<folly::Unit>> futures;
   {
@@ -478,26 +531,29 @@ ImmediateFuture<folly::Unit> GlobNode::evaluateRecursiveComponentImpl(
         if (root.entryShouldLoadChildTree(&entry.second)) {
           subDirNames.emplace_back(std::move(candidateName));
         } else {
-          futures.emplace_back(
-              store->getTree(entry.second.getHash(), context)
-                  .thenValue([candidateName = std::move(candidateName),
-                              rootPath = rootPath.copy(),
-                              store,
-                              context = context.copy(),
-                              this,
-                              fileBlobsToPrefetch,
-                              &globResult,
-                              &originRootId](std::shared_ptr<const Tree> tree) {
-                    return evaluateRecursiveComponentImpl(
-                        store,
-                        context,
-                        rootPath,
-                        candidateName,
-                        TreeRoot(std::move(tree)),
-                        fileBlobsToPrefetch,
-                        globResult,
-                        originRootId);
-                  }));
+          futures.emplace_back(evaluateSubtree(
+              executor,
+              store->getTree(entry.second.getHash(), context),
+              [candidateName = std::move(candidateName),
+               rootPath = rootPath.copy(),
+               store,
+               context = context.copy(),
+               this,
+               fileBlobsToPrefetch,
+               &globResult,
+               &originRootId,
+               executor](std::shared_ptr<const Tree> tree) {
+                return evaluateRecursiveComponentImpl(
+                    store,
+                    context,
+                    rootPath,
+                    candidateName,
+                    TreeRoot(std::move(tree)),
+                    fileBlobsToPrefetch,
+                    globResult,
+                    originRootId,
+                    executor);
+              }));
         }
       }
     }
@@ -507,26 +563,29 @@ ImmediateFuture<folly::Unit> GlobNode::evaluateRecursiveComponentImpl(
   for (auto& candidateName : subDirNames) {
     auto childTreeFuture =
         root.getOrLoadChildTree(candidateName.basename(), context);
-    futures.emplace_back(
-        std::move(childTreeFuture)
-            .thenValue([candidateName = std::move(candidateName),
-                        rootPath = rootPath.copy(),
-                        store,
-                        context = context.copy(),
-                        this,
-                        fileBlobsToPrefetch,
-                        &globResult,
-                        &originRootId](TreeInodePtr dir) {
-              return evaluateRecursiveComponentImpl(
-                  store,
-                  context,
-                  rootPath,
-                  candidateName,
-                  TreeInodePtrRoot(std::move(dir)),
-                  fileBlobsToPrefetch,
-                  globResult,
-                  originRootId);
-            }));
+    futures.emplace_back(evaluateSubtree(
+        executor,
+        std::move(childTreeFuture),
+        [candidateName = std::move(candidateName),
+         rootPath = rootPath.copy(),
+         store,
+         context = context.copy(),
+         this,
+         fileBlobsToPrefetch,
+         &globResult,
+         &originRootId,
+         executor](TreeInodePtr dir) {
+          return evaluateRecursiveComponentImpl(
+              store,
+              context,
+              rootPath,
+              candidateName,
+              TreeInodePtrRoot(std::move(dir)),
+              fileBlobsToPrefetch,
+              globResult,
+              originRootId,
+              executor);
+        }));
   }
 
   // Note: we use collectAll() rather than collect() here to make sure that
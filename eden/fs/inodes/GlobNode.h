@@ -6,6 +6,7 @@
  */
 
 #pragma once
+#include <folly/Executor.h>
 #include <ostream>
 #include "eden/fs/inodes/InodePtrFwd.h"
 #include "eden/fs/model/Tree.h"
@@ -100,6 +101,12 @@ class GlobNode {
    *
    * When fileBlobsToPrefetch is non-null, the Hash of the globbed files will
    * be appended to it.
+   *
+   * When executor is non-null, the evaluation of each subtree is scheduled
+   * onto it instead of running inline on whichever thread resolved the tree,
+   * allowing a wide walk to use several cores. The GlobNode tree itself is
+   * only read during evaluation and the result lists are synchronized, so
+   * the same compiled glob can be evaluated from several threads at once.
    */
   ImmediateFuture<folly::Unit> evaluate(
       const ObjectStore* store,
@@ -108,7 +115,8 @@ class GlobNode {
       TreeInodePtr root,
       PrefetchList* fileBlobsToPrefetch,
       ResultList& globResult,
-      const RootId& originRootId) const;
+      const RootId& originRootId,
+      folly::Executor* executor = nullptr) const;
 
   /**
    * Evaluate the compiled glob against the provided Tree.
@@ -122,7 +130,8 @@ class GlobNode {
       std::shared_ptr<const Tree> tree,
       PrefetchList* fileBlobsToPrefetch,
       ResultList& globResult,
-      const RootId& originRootId) const;
+      const RootId& originRootId,
+      folly::Executor* executor = nullptr) const;
 
   /**
    * Print a human-readable description of this GlobNode to stderr.
@@ -164,7 +173,8 @@ class GlobNode {
       ROOT&& root,
       PrefetchList* fileBlobsToPrefetch,
       ResultList& globResult,
-      const RootId& originRootId) const;
+      const RootId& originRootId,
+      folly::Executor* executor) const;
 
   template <typename ROOT>
   ImmediateFuture<folly::Unit> evaluateImpl(
@@ -174,7 +184,8 @@ class GlobNode {
       ROOT&& root,
       PrefetchList* fileBlobsToPrefetch,
       ResultList& globResult,
-      const RootId& originRootId) const;
+      const RootId& originRootId,
+      folly::Executor* executor) const;
 
   void debugDump(int currentDepth) const;
 
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <sys/stat.h>
+#include <array>
+#include <optional>
+
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+
+#include "eden/fs/inodes/InodeNumber.h"
+
+namespace facebook::eden {
+
+/**
+ * A sharded cache of computed stat results keyed by inode number.
+ *
+ * Computing a stat is not free: it consults the inode if it is loaded, or
+ * the InodeMetadata table and the TreeEntry otherwise, and getattr is the
+ * single most frequent request on every channel. Since attribute results
+ * only change when the mount changes, each entry is stamped with the
+ * journal sequence number observed before the stat was computed; a lookup
+ * only hits while the stamp matches the current sequence, so any recorded
+ * modification implicitly invalidates every cached attribute without an
+ * explicit invalidation path.
+ *
+ * Storage is split into shards each behind its own lock so concurrent
+ * dispatcher threads serving different inodes do not contend.
+ */
+class InodeAttributeCache {
+ public:
+  InodeAttributeCache() = default;
+
+  InodeAttributeCache(const InodeAttributeCache&) = delete;
+  InodeAttributeCache& operator=(const InodeAttributeCache&) = delete;
+
+  /**
+   * Returns the cached stat for this inode if one was recorded at the given
+   * journal sequence. An entry stamped with an older sequence is stale and
+   * is erased on the way out.
+   */
+  std::optional<struct stat> get(InodeNumber ino, uint64_t journalSequence) {
+    auto shard = shardFor(ino).wlock();
+    auto it = shard->find(ino.get());
+    if (it == shard->end()) {
+      return std::nullopt;
+    }
+    if (it->second.journalSequence != journalSequence) {
+      shard->erase(it);
+      return std::nullopt;
+    }
+    return it->second.st;
+  }
+
+  /**
+   * Records a stat computed while the journal was at the given sequence.
+   * The sequence must have been read before the stat computation started so
+   * that a modification racing with the computation bumps the sequence and
+   * prevents the entry from ever being served.
+   */
+  void set(InodeNumber ino, uint64_t journalSequence, const struct stat& st) {
+    shardFor(ino).wlock()->set(ino.get(), Entry{journalSequence, st});
+  }
+
+ private:
+  struct Entry {
+    uint64_t journalSequence;
+    struct stat st;
+  };
+
+  static constexpr size_t kNumShards = 16;
+
+  /**
+   * Per-shard entry bound. Sized so that the whole cache covers a working
+   * set of tens of thousands of hot inodes while staying within a few MiB.
+   */
+  static constexpr size_t kMaxEntriesPerShard = 4096;
+
+  struct Shard {
+    folly::Synchronized<folly::EvictingCacheMap<uint64_t, Entry>> map{
+        std::in_place,
+        kMaxEntriesPerShard};
+  };
+
+  folly::Synchronized<folly::EvictingCacheMap<uint64_t, Entry>>& shardFor(
+      InodeNumber ino) {
+    return shards_[ino.get() % kNumShards].map;
+  }
+
+  std::array<Shard, kNumShards> shards_;
+};
+
+} // namespace facebook::eden
@@ -153,11 +153,26 @@ std::optional<RelativePath> InodeBase::getPath() const {
     return RelativePath();
   }
 
+  // Load the generation before doing anything else.  If a rename races with
+  // the walk below it will bump the generation afterwards, so the entry we
+  // cache can only end up stale, never wrong.
+  auto generation = getMount()->getLocationGeneration();
+  {
+    auto cache = pathCache_.rlock();
+    if (cache->generation == generation) {
+      // Unlinking an inode also bumps the generation, so a current cache
+      // entry implies we are still linked.
+      return cache->path;
+    }
+  }
+
   std::vector<PathComponent> names;
   if (!getPathHelper(names, true)) {
     return std::nullopt;
   }
-  return RelativePath(names);
+  auto path = RelativePath(names);
+  *pathCache_.wlock() = PathCache{generation, path};
+  return path;
 }
 
 RelativePath InodeBase::getUnsafePath() const {
@@ -165,9 +180,23 @@ RelativePath InodeBase::getUnsafePath() const {
     return RelativePath();
   }
 
+  auto generation = getMount()->getLocationGeneration();
+  {
+    auto cache = pathCache_.rlock();
+    if (cache->generation == generation) {
+      return cache->path;
+    }
+  }
+
   std::vector<PathComponent> names;
-  getPathHelper(names, false);
-  return RelativePath{names};
+  bool linked = getPathHelper(names, false);
+  auto path = RelativePath{names};
+  if (linked) {
+    // Only cache paths for linked inodes: a current cache entry is taken to
+    // mean the inode was reachable by that path when it was computed.
+    *pathCache_.wlock() = PathCache{generation, path};
+  }
+  return path;
 }
 
 std::string InodeBase::getLogPath() const {
@@ -178,19 +207,31 @@ std::string InodeBase::getLogPath() const {
     return "<root>";
   }
 
+  auto generation = getMount()->getLocationGeneration();
+  {
+    auto cache = pathCache_.rlock();
+    if (cache->generation == generation) {
+      return cache->path.value();
+    }
+  }
+
   std::vector<PathComponent> names;
   bool unlinked = !getPathHelper(names, false);
   auto path = RelativePath(names);
   if (unlinked) {
     return fmt::format("<deleted:{}>", path);
   }
+  *pathCache_.wlock() = PathCache{generation, path};
   return std::move(path).value();
 }
 
 void InodeBase::markUnlinkedAfterLoad() {
-  auto loc = location_.wlock();
-  XDCHECK(!loc->unlinked);
-  loc->unlinked = true;
+  {
+    auto loc = location_.wlock();
+    XDCHECK(!loc->unlinked);
+    loc->unlinked = true;
+  }
+  getMount()->bumpLocationGeneration();
 }
 
 std::unique_ptr<InodeBase> InodeBase::markUnlinked(
@@ -206,6 +247,7 @@ std::unique_ptr<InodeBase> InodeBase::markUnlinked(
     XDCHECK_EQ(loc->parent.get(), parent);
     loc->unlinked = true;
   }
+  getMount()->bumpLocationGeneration();
 
   // Grab the inode map lock, and check if we should unload
   // ourself immediately.
@@ -243,10 +285,16 @@ void InodeBase::updateLocation(
   XDCHECK(renameLock.isHeld(mount_));
   XDCHECK_EQ(mount_, newParent->mount_);
 
-  auto loc = location_.wlock();
-  XDCHECK(!loc->unlinked);
-  loc->parent = newParent;
-  loc->name = newName.copy();
+  {
+    auto loc = location_.wlock();
+    XDCHECK(!loc->unlinked);
+    loc->parent = newParent;
+    loc->name = newName.copy();
+  }
+  // Bump the generation only after the new location is visible, so that a
+  // concurrent getPath() tagging a cache entry with the new generation cannot
+  // have seen the old location.
+  getMount()->bumpLocationGeneration();
 }
 
 void InodeBase::onPtrRefZero() const {
@@ -666,6 +666,28 @@ class InodeBase {
    */
   folly::Synchronized<LocationInfo> location_;
 
+  /**
+   * A cached copy of this inode's path, tagged with the mount's location
+   * generation at the time it was computed.
+   *
+   * Path computation walks the parent chain and takes each ancestor's
+   * location_ lock, which is expensive for inodes that are logged frequently.
+   * The cache short-circuits that walk: if the stored generation matches the
+   * mount's current location generation, no rename or unlink has happened
+   * anywhere in the mount since the path was computed, so the cached value is
+   * still accurate.  A generation of 0 means nothing is cached.
+   *
+   * Any location_ update bumps the mount-wide generation, so the cache is
+   * invalidated conservatively: a rename in an unrelated subtree also
+   * discards cached paths.  That keeps validation down to a single atomic
+   * load on the hot path.
+   */
+  struct PathCache {
+    uint64_t generation = 0;
+    RelativePath path;
+  };
+  mutable folly::Synchronized<PathCache> pathCache_;
+
   template <typename InodeState>
   friend class InodeBaseMetadata;
 };
@@ -16,11 +16,17 @@
 
 #include "eden/fs/config/EdenConfig.h"
 #include "eden/fs/config/ReloadableConfig.h"
+#include "eden/fs/inodes/EdenMount.h"
 #include "eden/fs/inodes/FileInode.h"
 #include "eden/fs/inodes/Overlay.h"
 #include "eden/fs/inodes/ParentInodeInfo.h"
 #include "eden/fs/inodes/TreeInode.h"
+#ifndef _WIN32
+#include "eden/fs/takeover/InodeMapSegment.h"
+#endif
+#include "eden/fs/telemetry/EdenStats.h"
 #include "eden/fs/utils/Bug.h"
+#include "eden/fs/utils/DirType.h"
 #include "eden/fs/utils/NotImplemented.h"
 #include "eden/fs/utils/SystemError.h"
 #include "eden/fs/utils/TimeUtil.h"
@@ -172,6 +178,47 @@ void InodeMap::initializeUnloadedInode(
   }
 }
 
+#ifndef _WIN32
+void InodeMap::initializeFromTakeover(
+    TreeInodePtr root,
+    const folly::File& takeoverSegment) {
+  auto data = data_.wlock();
+  initializeRoot(data, std::move(root));
+
+  forEachInodeMapSegmentEntry(
+      takeoverSegment, [&](const InodeMapSegmentEntry& entry) {
+        if (entry.numFsReferences < 0) {
+          auto message = folly::to<std::string>(
+              "inode number ",
+              entry.inodeNumber,
+              " has a negative numFsReferences number");
+          XLOG(ERR) << message;
+          throw std::runtime_error(message);
+        }
+
+        std::optional<ObjectId> hash;
+        if (entry.hash.has_value() && !entry.hash.value().empty()) {
+          // LEGACY: as with the thrift path, an empty hash means
+          // materialized.
+          hash = ObjectId{folly::ByteRange{entry.hash.value()}};
+        }
+        initializeUnloadedInode(
+            data,
+            InodeNumber::fromThrift(folly::to<int64_t>(entry.parentInode)),
+            InodeNumber::fromThrift(folly::to<int64_t>(entry.inodeNumber)),
+            PathComponentPiece{entry.name},
+            entry.isUnlinked,
+            entry.mode,
+            std::move(hash),
+            folly::to<uint32_t>(entry.numFsReferences));
+      });
+
+  XLOG(DBG2) << "InodeMap initialized mount " << mount_->getPath()
+             << " from takeover segment, " << data->unloadedInodes_.size()
+             << " inodes registered";
+}
+#endif // !_WIN32
+
 void InodeMap::initializeFromTakeover(
     TreeInodePtr root,
     const SerializedInodeMap& takeover) {
@@ -217,10 +264,15 @@ void InodeMap::initializeFromTakeover(
 }
 
 void InodeMap::initializeFromOverlay(TreeInodePtr root, Overlay& overlay) {
-  XCHECK(mount_->isWorkingCopyPersistent());
-
   XLOG(DBG2) << "Initializing InodeMap for " << mount_->getPath();
 
+  // On Windows the files in the working copy survive the mount and refer to
+  // these inodes, so record an FS reference for each of them. On other
+  // platforms nothing is known to reference the inodes yet: the kernel
+  // acquires references through lookups, so starting at zero lets inodes be
+  // forgotten normally once they are loaded and unloaded again.
+  uint32_t numFsReferences = mount_->isWorkingCopyPersistent() ? 1 : 0;
+
   auto data = data_.wlock();
   initializeRoot(data, std::move(root));
 
@@ -256,7 +308,7 @@ void InodeMap::initializeFromOverlay(TreeInodePtr root, Overlay& overlay) {
           false,
           dirent.getInitialMode(),
           dirent.getOptionalHash(),
-          1);
+          numFsReferences);
     }
   }
 
@@ -266,13 +318,32 @@ void InodeMap::initializeFromOverlay(TreeInodePtr root, Overlay& overlay) {
 }
 
 ImmediateFuture<InodePtr> InodeMap::lookupInode(InodeNumber number) {
-  // Lock the data.
+  // Times the synchronous part of the lookup: the map probes and, on a miss,
+  // setting up the load. The asynchronous load itself is not included.
+  SampledDurationScope stageScope{
+      mount_->getStats(), &StageStats::inodeMapLookup};
+
+  // Already-loaded inodes are by far the common case on a warm mount, and
+  // looking one up only reads loadedInodes_, so serve that from a read lock.
+  // Every FUSE lookup funnels through here, and taking the exclusive lock
+  // for the read-only hit path made this the most contended lock in the
+  // process under highly parallel builds.
+  {
+    auto data = data_.rlock();
+    auto loadedIter = data->loadedInodes_.find(number);
+    if (loadedIter != data->loadedInodes_.end()) {
+      return loadedIter->second.getPtr();
+    }
+  }
+
+  // Lock the data exclusively.
   // We hold it while doing most of our work below, but explicitly unlock it
   // before triggering inode loading or before fulfilling any Promises.
   auto data = data_.wlock();
   std::vector<InodeTraceEvent> startLoadEvents;
 
-  // Check to see if this Inode is already loaded
+  // Check the loaded map again: the inode may have finished loading between
+  // releasing the read lock and acquiring the write lock.
   auto loadedIter = data->loadedInodes_.find(number);
   if (loadedIter != data->loadedInodes_.end()) {
     return loadedIter->second.getPtr();
@@ -935,6 +1006,51 @@ Future<SerializedInodeMap> InodeMap::shutdown(
   });
 }
 
+SerializedInodeMap InodeMap::serializeTakeoverRehearsal(
+    const RenameLock& renameLock) const {
+  auto data = data_.rlock();
+  SerializedInodeMap result;
+  result.unloadedInodes_ref()->reserve(
+      data->unloadedInodes_.size() + data->loadedInodes_.size());
+
+  for (const auto& [inodeNumber, entry] : data->unloadedInodes_) {
+    SerializedInodeMapEntry serializedEntry;
+    serializedEntry.inodeNumber_ref() = inodeNumber.get();
+    serializedEntry.parentInode_ref() = entry.parent.get();
+    serializedEntry.name() = entry.name.asString();
+    serializedEntry.isUnlinked_ref() = entry.isUnlinked;
+    serializedEntry.numFsReferences_ref() = entry.numFsReferences;
+    if (entry.hash.has_value()) {
+      serializedEntry.hash_ref() = entry.hash.value().asString();
+    }
+    serializedEntry.mode_ref() = entry.mode;
+    result.unloadedInodes_ref()->emplace_back(std::move(serializedEntry));
+  }
+
+  for (const auto& [inodeNumber, entry] : data->loadedInodes_) {
+    // The root is reconstructed by the new process rather than transferred,
+    // so it does not contribute an entry.
+    if (inodeNumber == kRootNodeId) {
+      continue;
+    }
+    auto location = entry->getLocationInfo(renameLock);
+    SerializedInodeMapEntry serializedEntry;
+    serializedEntry.inodeNumber_ref() = inodeNumber.get();
+    serializedEntry.parentInode_ref() =
+        location.parent ? location.parent->getNodeId().get() : 0;
+    serializedEntry.name() = location.name.asString();
+    serializedEntry.isUnlinked_ref() = location.unlinked;
+    serializedEntry.numFsReferences_ref() = entry->getFsRefcount();
+    // No hash: the entry serializes the way a materialized inode would.
+    // Clean files would carry a hash in a real takeover, so the rehearsal
+    // payload runs a few bytes short per loaded clean inode.
+    serializedEntry.mode_ref() = dtype_to_mode(entry->getType());
+    result.unloadedInodes_ref()->emplace_back(std::move(serializedEntry));
+  }
+
+  return result;
+}
+
 void InodeMap::shutdownComplete(
     folly::Synchronized<Members>::LockedPtr&& data) {
   // We manually dropped our reference count to the root inode in
@@ -1136,11 +1252,34 @@ optional<InodeMap::UnloadedInode> InodeMap::updateOverlayForUnload(
     // the contents can be directly accessed here.
     auto& treeContents = asTree->getContents().unsafeGetUnlocked();
 
+    // A tree-backed directory may have deferred writing its entries to the
+    // overlay (overlay:defer-unmaterialized-dir-save). If this inode is
+    // about to be remembered, its children's inode numbers must survive the
+    // unload so a later reload resolves them to the same entries, so write
+    // the entries now.
+    auto persistDeferredEntries = [&] {
+      if (treeContents.isMaterialized() || treeContents.overlayDirPersisted) {
+        return;
+      }
+      try {
+        mount_->getOverlay()->saveOverlayDir(
+            inode->getNodeId(), treeContents.entries);
+        treeContents.overlayDirPersisted = true;
+      } catch (const std::exception& ex) {
+        // Proceed with the unload on error; a later reload will rebuild the
+        // directory from its source control Tree with fresh inode numbers.
+        XLOG(ERR) << "error saving deferred overlay state while unloading "
+                  << "inode " << inode->getNodeId() << " ("
+                  << inode->getLogPath() << "): " << folly::exceptionStr(ex);
+      }
+    };
+
     // If the fs refcount is non-zero we have to remember this inode.
     if (fsCount > 0) {
       XLOG(DBG5) << "unloading tree inode " << inode->getNodeId()
                  << " with Fs refcount=" << fsCount << ": "
                  << inode->getLogPath();
+      persistDeferredEntries();
       return UnloadedInode(
           parent, name, isUnlinked, treeContents.treeHash, fsCount);
     }
@@ -1154,6 +1293,7 @@ optional<InodeMap::UnloadedInode> InodeMap::updateOverlayForUnload(
         XLOG(DBG5) << "remembering inode " << asTree->getNodeId() << " ("
                    << asTree->getLogPath() << ") because its child "
                    << childName << " was remembered";
+        persistDeferredEntries();
         return UnloadedInode(
             parent, name, isUnlinked, treeContents.treeHash, fsCount);
       }
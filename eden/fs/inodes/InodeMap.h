@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <folly/File.h>
 #include <folly/Synchronized.h>
 #include <folly/futures/Future.h>
 #include <list>
@@ -132,6 +133,22 @@ class InodeMap {
       TreeInodePtr root,
       const SerializedInodeMap& takeover);
 
+#ifndef _WIN32
+  /**
+   * Initialize the InodeMap from a memory-backed inode map segment handed
+   * over from a process being taken over.
+   *
+   * The segment is mapped and the unloaded inode entries are built directly
+   * from the mapped records, skipping the thrift decode of the takeover
+   * message entirely.
+   *
+   * This method has the same constraints and concerns as initialize().
+   */
+  void initializeFromTakeover(
+      TreeInodePtr root,
+      const folly::File& takeoverSegment);
+#endif // !_WIN32
+
   /**
    * Initialize the InodeMap from the content of the overlay.
    *
@@ -140,7 +157,11 @@ class InodeMap {
    * that are already present on disk. This needs to be called before the
    * FsChannel is initialized for the mount.
    *
-   * The only platform where this applies is Windows.
+   * This always applies on Windows. On other platforms it can be requested
+   * via `mount:initialize-inode-map-from-overlay` so that inode numbers
+   * handed out before an ungraceful restart (NFS file handles, FUSE dentry
+   * revalidation) resolve from the persisted overlay mapping instead of
+   * failing with ESTALE.
    */
   void initializeFromOverlay(TreeInodePtr root, Overlay& overlay);
 
@@ -268,6 +289,23 @@ class InodeMap {
    */
   FOLLY_NODISCARD folly::Future<SerializedInodeMap> shutdown(bool doTakeover);
 
+  /**
+   * Build a SerializedInodeMap approximating what a graceful takeover would
+   * transfer right now, without unloading or stopping anything.
+   *
+   * Unloaded inodes serialize exactly as they would during a takeover
+   * shutdown. Loaded inodes - which a real takeover unloads first - are
+   * approximated from their in-memory state; they serialize without a source
+   * control hash, as a materialized inode would. The result is only suitable
+   * for measuring serialization cost and payload size (see
+   * debugRehearseTakeover); it must never be handed to a new process.
+   *
+   * The caller must hold the mount's rename lock so that inode locations
+   * cannot change while the snapshot is taken.
+   */
+  SerializedInodeMap serializeTakeoverRehearsal(
+      const RenameLock& renameLock) const;
+
   /**
    * Returns true if we have stored information about this inode that may
    * need to be updated if the inode's state changes.
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/inodes/MountWarmup.h"
+
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/logging/xlog.h>
+
+#include "eden/fs/config/CheckoutConfig.h"
+#include "eden/fs/inodes/EdenMount.h"
+#include "eden/fs/inodes/InodePtr.h"
+#include "eden/fs/model/Tree.h"
+#include "eden/fs/store/ObjectFetchContext.h"
+#include "eden/fs/store/ObjectStore.h"
+#include "eden/fs/store/PathLoader.h"
+#include "eden/fs/store/TreePrefetcher.h"
+
+namespace facebook::eden {
+
+namespace {
+
+/**
+ * Fetch context for warm-up walks. Cause::Prefetch keeps these fetches out
+ * of the FUSE fastpath accounting, and Class::Low lets any live import jump
+ * ahead of them in the backing store queues and on the server thread pool.
+ */
+class WarmupFetchContext : public ObjectFetchContext {
+ public:
+  Cause getCause() const override {
+    return ObjectFetchContext::Cause::Prefetch;
+  }
+
+  std::optional<std::string_view> getCauseDetail() const override {
+    return "mountWarmup";
+  }
+
+  ImportPriority getPriority() const override {
+    return ImportPriority{ImportPriority::Class::Low};
+  }
+
+  const std::unordered_map<std::string, std::string>* FOLLY_NULLABLE
+  getRequestInfo() const override {
+    return nullptr;
+  }
+};
+
+/**
+ * Warm a single working-set path: load its inode so the TreeInodes along
+ * the path are present in the InodeMap, then walk the subtree fetching
+ * trees and blobs. Failures (most commonly a manifest entry that no longer
+ * exists in the checked-out revision) are logged and swallowed so the rest
+ * of the working set is still warmed.
+ */
+ImmediateFuture<folly::Unit> warmPath(
+    const std::shared_ptr<EdenMount>& mount,
+    RelativePath path,
+    const std::shared_ptr<WarmupState>& state,
+    const ObjectFetchContextPtr& context) {
+  auto* store = mount->getObjectStore();
+  return mount->getInodeSlow(path, context)
+      .thenValue([store,
+                  rootId = mount->getCheckedOutRootId(),
+                  context = context.copy()](InodePtr&&) {
+        return store->getRootTree(rootId, context);
+      })
+      .thenValue(
+          [store, context = context.copy(), path](
+              std::shared_ptr<const Tree>&& rootTree) {
+            return resolveTree(*store, context, std::move(rootTree), path);
+          })
+      .thenValue([store, context = context.copy()](
+                     std::shared_ptr<const Tree>&& tree) {
+        return prefetchTreeRecursive(
+            *store, context, std::move(tree), std::nullopt, true);
+      })
+      .thenValue([state](TreePrefetchStats&& stats) {
+        state->treesWalked.fetch_add(
+            stats.treesWalked, std::memory_order_relaxed);
+        state->blobsPrefetched.fetch_add(
+            stats.blobsPrefetched, std::memory_order_relaxed);
+        return folly::unit;
+      })
+      .thenTry([mount, path, state](folly::Try<folly::Unit> result) {
+        if (result.hasException()) {
+          XLOG(DBG3) << "skipping warm-up path " << path << " in "
+                     << mount->getPath() << ": "
+                     << result.exception().what();
+        }
+        state->pathsCompleted.fetch_add(1, std::memory_order_relaxed);
+        return folly::unit;
+      });
+}
+
+} // namespace
+
+std::vector<RelativePath> readWarmupManifest(const CheckoutConfig& config) {
+  auto manifestPath = config.getClientDirectory() + "warmup-paths"_pc;
+  std::string contents;
+  if (!folly::readFile(manifestPath.c_str(), contents)) {
+    return {};
+  }
+
+  std::vector<RelativePath> paths;
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', contents, lines);
+  for (auto line : lines) {
+    auto trimmed = folly::trimWhitespace(line);
+    if (trimmed.empty() || trimmed.startsWith('#')) {
+      continue;
+    }
+    try {
+      paths.emplace_back(trimmed);
+    } catch (const std::domain_error& ex) {
+      XLOG(WARN) << "ignoring invalid path in warm-up manifest "
+                 << manifestPath << ": " << ex.what();
+    }
+  }
+  return paths;
+}
+
+ImmediateFuture<folly::Unit> warmupMount(
+    std::shared_ptr<EdenMount> mount,
+    std::vector<RelativePath> paths,
+    std::shared_ptr<WarmupState> state) {
+  XDCHECK(state->running.load(std::memory_order_relaxed));
+  state->pathsTotal.store(paths.size(), std::memory_order_relaxed);
+  state->pathsCompleted.store(0, std::memory_order_relaxed);
+  state->treesWalked.store(0, std::memory_order_relaxed);
+  state->blobsPrefetched.store(0, std::memory_order_relaxed);
+
+  XLOG(DBG2) << "warming " << paths.size() << " working-set paths in "
+             << mount->getPath();
+
+  ObjectFetchContextPtr context = makeRefPtr<WarmupFetchContext>();
+
+  // Walk the paths one at a time; the walk of a single path is already
+  // internally concurrent, and serializing across paths keeps the warm-up
+  // from flooding the backing store queues.
+  ImmediateFuture<folly::Unit> fut{folly::unit};
+  for (auto& path : paths) {
+    fut = std::move(fut).thenValue(
+        [mount, path = std::move(path), state, context = context.copy()](
+            auto&&) { return warmPath(mount, path, state, context); });
+  }
+  return std::move(fut).ensure([mount, state, context = context.copy()] {
+    XLOG(DBG2) << "finished warming working set in " << mount->getPath();
+    state->running.store(false, std::memory_order_relaxed);
+  });
+}
+
+} // namespace facebook::eden
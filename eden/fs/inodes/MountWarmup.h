@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <folly/Unit.h>
+
+#include "eden/fs/utils/ImmediateFuture.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+namespace facebook::eden {
+
+class CheckoutConfig;
+class EdenMount;
+
+/**
+ * Shared progress state for a working-set warm-up, updated by the walk and
+ * read by the getMountWarmupProgress() Thrift call. One instance lives on
+ * each EdenMount for its whole lifetime; the counters describe the most
+ * recently started warm-up.
+ */
+struct WarmupState {
+  std::atomic<bool> running{false};
+  std::atomic<uint64_t> pathsTotal{0};
+  std::atomic<uint64_t> pathsCompleted{0};
+  std::atomic<uint64_t> treesWalked{0};
+  std::atomic<uint64_t> blobsPrefetched{0};
+};
+
+/**
+ * Read the recorded working-set manifest for this checkout: a
+ * newline-separated list of repo-relative paths in
+ * <clientDirectory>/warmup-paths, typically the top directories by
+ * historical access counts as recorded by tooling. Blank lines and lines
+ * starting with '#' are skipped, as are entries that do not parse as
+ * relative paths. Returns an empty vector when no manifest was recorded.
+ */
+std::vector<RelativePath> readWarmupManifest(const CheckoutConfig& config);
+
+/**
+ * Warm the given working-set paths by loading each path's inode and then
+ * walking its subtree with prefetchTreeRecursive(), fetching trees and
+ * blobs into the local store. All fetches run with Cause::Prefetch at
+ * ImportPriority::Class::Low, so a warm-up never competes with live
+ * filesystem requests for import slots or executor time.
+ *
+ * Paths are walked one at a time to keep the background load gentle; the
+ * walk of a single path is already internally concurrent. Paths that no
+ * longer exist in the checked-out revision are logged and skipped rather
+ * than failing the warm-up.
+ *
+ * The caller must have claimed `state` by flipping `running` to true;
+ * warmupMount updates the remaining counters as it goes and clears
+ * `running` when it finishes.
+ */
+ImmediateFuture<folly::Unit> warmupMount(
+    std::shared_ptr<EdenMount> mount,
+    std::vector<RelativePath> paths,
+    std::shared_ptr<WarmupState> state);
+
+} // namespace facebook::eden
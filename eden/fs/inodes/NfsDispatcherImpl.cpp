@@ -15,24 +15,61 @@
 #include "eden/fs/inodes/InodeBase.h"
 #include "eden/fs/inodes/InodeMap.h"
 #include "eden/fs/inodes/TreeInode.h"
+#include "eden/fs/inodes/VirtualInode.h"
+#include "eden/fs/journal/Journal.h"
 #include "eden/fs/nfs/NfsUtils.h"
+#include "eden/fs/store/ObjectStore.h"
 
 namespace facebook::eden {
 
 NfsDispatcherImpl::NfsDispatcherImpl(EdenMount* mount)
     : NfsDispatcher(mount->getStats(), mount->getClock()),
       mount_(mount),
-      inodeMap_(mount_->getInodeMap()) {}
+      inodeMap_(mount_->getInodeMap()),
+      attributeCacheEnabled_(
+          mount_->getEdenConfig()->attributeCache.getValue()) {}
 
 ImmediateFuture<struct stat> NfsDispatcherImpl::getattr(
     InodeNumber ino,
     const ObjectFetchContextPtr& context) {
+  // The journal sequence is read before the stat is computed so that a
+  // concurrent modification prevents the entry recorded below from ever
+  // being served.
+  uint64_t journalSequence = 0;
+  if (attributeCacheEnabled_) {
+    journalSequence = mount_->getJournal().getLatestSequenceID();
+    if (auto st = attributeCache_.get(ino, journalSequence)) {
+      getStats()->increment(&NfsStats::getattrCacheHit);
+      return *st;
+    }
+    getStats()->increment(&NfsStats::getattrCacheMiss);
+  }
+
   return inodeMap_->lookupInode(ino).thenValue(
-      [context = context.copy()](const InodePtr& inode) {
-        return inode->stat(context);
+      [this, ino, journalSequence, context = context.copy()](
+          const InodePtr& inode) {
+        return inode->stat(context).thenValue(
+            [this, ino, journalSequence](struct stat st) {
+              if (attributeCacheEnabled_) {
+                attributeCache_.set(ino, journalSequence, st);
+              }
+              return st;
+            });
       });
 }
 
+std::optional<struct stat> NfsDispatcherImpl::getattrCached(InodeNumber ino) {
+  if (!attributeCacheEnabled_) {
+    return std::nullopt;
+  }
+  auto journalSequence = mount_->getJournal().getLatestSequenceID();
+  if (auto st = attributeCache_.get(ino, journalSequence)) {
+    getStats()->increment(&NfsStats::getattrCacheHit);
+    return st;
+  }
+  return std::nullopt;
+}
+
 ImmediateFuture<NfsDispatcher::SetattrRes> NfsDispatcherImpl::setattr(
     InodeNumber ino,
     DesiredMetadata desired,
@@ -298,41 +335,118 @@ ImmediateFuture<NfsDispatcher::ReaddirRes> NfsDispatcherImpl::readdirplus(
     off_t offset,
     uint32_t count,
     const ObjectFetchContextPtr& context) {
-  return inodeMap_->lookupTreeInode(dir).thenValue(
-      [context = context.copy(), offset, count, this](
-          const TreeInodePtr& inode) {
-        auto [dirList, isEof] = inode->nfsReaddir(
-            NfsDirList{count, nfsv3Procs::readdirplus}, offset, context);
-        auto& dirListRef = dirList.getListRef();
-        std::vector<ImmediateFuture<folly::Unit>> futuresVec{};
-        for (auto& entry : dirListRef) {
-          if (entry.name == "." || entry.name == "..") {
-            futuresVec.push_back(
-                this->getattr(InodeNumber{entry.fileid}, context)
-                    .thenTry([&entry](folly::Try<struct stat> st) {
-                      entry.name_attributes = statToPostOpAttr(st);
-                      return folly::unit;
-                    }));
-          } else {
-            futuresVec.push_back(
-                inode->getOrLoadChild(PathComponent{entry.name}, context)
-                    .thenValue(
-                        [entry, context = context.copy()](InodePtr&& inodep) {
-                          return inodep->stat(context);
-                        })
-                    .thenTry([&entry](folly::Try<struct stat> st) {
-                      entry.name_attributes = statToPostOpAttr(st);
-                      return folly::unit;
-                    }));
+  return inodeMap_->lookupTreeInode(dir).thenValue([context = context.copy(),
+                                                    offset,
+                                                    count,
+                                                    this](
+                                                       const TreeInodePtr&
+                                                           inode) {
+    auto [dirList, isEof] = inode->nfsReaddir(
+        NfsDirList{count, nfsv3Procs::readdirplus}, offset, context);
+    auto& dirListRef = dirList.getListRef();
+
+    // Attributes for unloaded entries can be served straight from the Tree
+    // and BlobMetadata through VirtualInode. Loading an inode per entry just
+    // to stat it made a readdirplus of a wide directory instantiate
+    // thousands of inodes that the client immediately forgets.
+    //
+    // Resolve every entry of this page to a VirtualInode first so that the
+    // blob metadata needed for the unloaded entries can be fetched from the
+    // ObjectStore as one batch rather than one fetch per entry.
+    std::vector<ImmediateFuture<std::optional<VirtualInode>>> children;
+    children.reserve(dirListRef.size());
+    for (auto& entry : dirListRef) {
+      if (entry.name == "." || entry.name == "..") {
+        children.emplace_back(std::optional<VirtualInode>{});
+      } else {
+        children.push_back(inode
+                               ->getOrFindChild(
+                                   PathComponentPiece{entry.name},
+                                   context,
+                                   /*loadInodes=*/false)
+                               .thenValue([](VirtualInode&& virtualInode) {
+                                 return std::make_optional(
+                                     std::move(virtualInode));
+                               }));
+      }
+    }
+
+    return collectAll(std::move(children))
+        .thenValue([this,
+                    context = context.copy(),
+                    dirList = std::move(dirList),
+                    isEof = isEof](
+                       std::vector<folly::Try<std::optional<VirtualInode>>>&&
+                           children) mutable {
+          std::vector<ObjectId> blobIds;
+          for (auto& child : children) {
+            if (child.hasValue() && child.value().has_value()) {
+              if (auto blobId = child.value()->getBlobObjectId()) {
+                blobIds.push_back(std::move(*blobId));
+              }
+            }
           }
-        }
-        auto res = collectAllSafe(std::move(futuresVec));
-        return std::move(res).thenValue(
-            [dirList = std::move(dirList),
-             isEof = isEof](std::vector<folly::Unit>&&) mutable {
-              return ReaddirRes{std::move(dirList), isEof};
-            });
-      });
+
+          // Warm the metadata cache for the whole page in one batch. Fetch
+          // errors are ignored here: the per-entry stat below will rediscover
+          // them and mark only the affected entries as lacking attributes.
+          auto warm = blobIds.empty()
+              ? ImmediateFuture<folly::Unit>{folly::unit}
+              : mount_->getObjectStore()
+                    ->getBlobMetadatas(blobIds, context)
+                    .thenTry([](folly::Try<std::vector<BlobMetadata>>&&) {
+                      return folly::unit;
+                    });
+
+          return std::move(warm).thenValue([this,
+                                            context = context.copy(),
+                                            dirList = std::move(dirList),
+                                            isEof,
+                                            children = std::move(children)](
+                                               folly::Unit) mutable {
+            auto& dirListRef = dirList.getListRef();
+            auto lastCheckoutTime = mount_->getLastCheckoutTime().toTimespec();
+            auto* objectStore = mount_->getObjectStore();
+            std::vector<ImmediateFuture<folly::Unit>> futuresVec{};
+            futuresVec.reserve(dirListRef.size());
+            for (size_t i = 0; i < dirListRef.size(); ++i) {
+              auto& entry = dirListRef[i];
+              auto& child = children[i];
+              if (entry.name == "." || entry.name == "..") {
+                futuresVec.push_back(
+                    this->getattr(InodeNumber{entry.fileid}, context)
+                        .thenTry([&entry](folly::Try<struct stat> st) {
+                          entry.name_attributes = statToPostOpAttr(st);
+                          return folly::unit;
+                        }));
+              } else if (child.hasException()) {
+                entry.name_attributes = statToPostOpAttr(
+                    folly::Try<struct stat>{child.exception()});
+              } else {
+                futuresVec.push_back(
+                    child.value()
+                        ->stat(lastCheckoutTime, objectStore, context)
+                        .thenTry([&entry](folly::Try<struct stat> st) {
+                          if (st.hasValue()) {
+                            // A stat computed without an inode doesn't know
+                            // the entry's inode number; fill in the one
+                            // readdir already allocated so the fileid fields
+                            // agree.
+                            st.value().st_ino = entry.fileid;
+                          }
+                          entry.name_attributes = statToPostOpAttr(st);
+                          return folly::unit;
+                        }));
+              }
+            }
+            return collectAllSafe(std::move(futuresVec))
+                .thenValue([dirList = std::move(dirList), isEof](
+                               std::vector<folly::Unit>&&) mutable {
+                  return ReaddirRes{std::move(dirList), isEof};
+                });
+          });
+        });
+  });
 }
 
 ImmediateFuture<struct statfs> NfsDispatcherImpl::statfs(
@@ -9,6 +9,7 @@
 
 #ifndef _WIN32
 
+#include "eden/fs/inodes/InodeAttributeCache.h"
 #include "eden/fs/nfs/NfsDispatcher.h"
 
 namespace facebook::eden {
@@ -23,6 +24,8 @@ class NfsDispatcherImpl : public NfsDispatcher {
       InodeNumber ino,
       const ObjectFetchContextPtr& context) override;
 
+  std::optional<struct stat> getattrCached(InodeNumber ino) override;
+
   ImmediateFuture<NfsDispatcher::SetattrRes> setattr(
       InodeNumber ino,
       DesiredMetadata desired,
@@ -115,6 +118,15 @@ class NfsDispatcherImpl : public NfsDispatcher {
   // The EdenMount associated with this dispatcher.
   EdenMount* const mount_;
   InodeMap* const inodeMap_;
+
+  // Whether attributeCache_ is consulted at all. Read from
+  // mount:attribute-cache at mount time.
+  const bool attributeCacheEnabled_;
+
+  // Caches computed stat results keyed by inode number, stamped with the
+  // journal sequence observed before the stat was computed. See
+  // InodeAttributeCache for the invalidation contract.
+  InodeAttributeCache attributeCache_;
 };
 } // namespace facebook::eden
 
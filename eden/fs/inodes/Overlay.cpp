@@ -29,6 +29,7 @@
 #include "eden/fs/inodes/sqlitecatalog/BufferedSqliteInodeCatalog.h"
 #include "eden/fs/inodes/sqlitecatalog/SqliteInodeCatalog.h"
 #include "eden/fs/sqlite/SqliteDatabase.h"
+#include "eden/fs/telemetry/RequestProbes.h"
 #include "eden/fs/utils/Bug.h"
 #include "eden/fs/utils/PathFuncs.h"
 
@@ -44,7 +45,10 @@ std::unique_ptr<InodeCatalog> makeInodeCatalog(
     const EdenConfig& config,
     IFileContentStore* fileContentStore) {
   if (inodeCatalogType == Overlay::InodeCatalogType::Tree) {
-    return std::make_unique<SqliteInodeCatalog>(localDir);
+    return std::make_unique<SqliteInodeCatalog>(
+        localDir,
+        SqliteTreeStore::SynchronousMode::Normal,
+        config.overlayWalAutocheckpointPages.getValue());
   } else if (inodeCatalogType == Overlay::InodeCatalogType::TreeInMemory) {
     XLOG(WARN) << "In-memory overlay requested. This will cause data loss.";
     return std::make_unique<SqliteInodeCatalog>(
@@ -52,7 +56,9 @@ std::unique_ptr<InodeCatalog> makeInodeCatalog(
   } else if (
       inodeCatalogType == Overlay::InodeCatalogType::TreeSynchronousOff) {
     return std::make_unique<SqliteInodeCatalog>(
-        localDir, SqliteTreeStore::SynchronousMode::Off);
+        localDir,
+        SqliteTreeStore::SynchronousMode::Off,
+        config.overlayWalAutocheckpointPages.getValue());
   } else if (inodeCatalogType == Overlay::InodeCatalogType::TreeBuffered) {
     XLOG(DBG4) << "Buffered tree overlay being used";
     return std::make_unique<BufferedSqliteInodeCatalog>(localDir, config);
@@ -75,7 +81,10 @@ std::unique_ptr<InodeCatalog> makeInodeCatalog(
     throw std::runtime_error(
         "Legacy overlay type is not supported. Please reclone.");
   }
-  return std::make_unique<SqliteInodeCatalog>(localDir);
+  return std::make_unique<SqliteInodeCatalog>(
+      localDir,
+      SqliteTreeStore::SynchronousMode::Normal,
+      config.overlayWalAutocheckpointPages.getValue());
 #else
   return std::make_unique<FsInodeCatalog>(
       static_cast<FileContentStore*>(fileContentStore));
@@ -247,37 +256,54 @@ void Overlay::initOverlay(
     //
     // Use OverlayChecker to scan the overlay for any issues, and also compute
     // correct next inode number as it does so.
-    XLOG(WARN) << "Overlay " << localDir_
-               << " was not shut down cleanly.  Performing fsck scan.";
-
-    // TODO(zeyi): `OverlayCheck` should be associated with the specific
-    // Overlay implementation. `static_cast` is a temporary workaround.
-    //
-    // Note: lookupCallback is a reference but is stored on OverlayChecker.
-    // Therefore OverlayChecker must not exist longer than this initOverlay
-    // call.
-    OverlayChecker checker(
-        static_cast<FsInodeCatalog*>(inodeCatalog_.get()),
-        static_cast<FileContentStore*>(fileContentStore_.get()),
-        std::nullopt,
-        lookupCallback);
-    folly::stop_watch<> fsckRuntime;
-    checker.scanForErrors(progressCallback);
-    auto result = checker.repairErrors();
-    auto fsckRuntimeInSeconds =
-        std::chrono::duration<double>{fsckRuntime.elapsed()}.count();
-    if (result) {
-      // If totalErrors - fixedErrors is nonzero, then we failed to
-      // fix all of the problems.
-      auto success = !(result->totalErrors - result->fixedErrors);
-      structuredLogger_->logEvent(
-          Fsck{fsckRuntimeInSeconds, success, true /*attempted_repair*/});
+    if (config->overlayLazyFsck.getValue()) {
+      // Bring the mount up without a full scan: recovering the next inode
+      // number only requires enumerating the shard directory entry names.
+      // Corrupt directories will surface as errors when they are first
+      // deserialized; orphan cleanup and repairs are deferred until the next
+      // full fsck run.
+      XLOG(WARN) << "Overlay " << localDir_
+                 << " was not shut down cleanly.  Skipping the fsck scan "
+                    "(overlay:lazy-fsck) and recovering the next inode "
+                    "number from the shard directories.";
+      optNextInodeNumber =
+          static_cast<FileContentStore*>(fileContentStore_.get())
+              ->scanForNextInodeNumber();
     } else {
-      structuredLogger_->logEvent(Fsck{
-          fsckRuntimeInSeconds, true /*success*/, false /*attempted_repair*/});
-    }
+      XLOG(WARN) << "Overlay " << localDir_
+                 << " was not shut down cleanly.  Performing fsck scan.";
+
+      // TODO(zeyi): `OverlayCheck` should be associated with the specific
+      // Overlay implementation. `static_cast` is a temporary workaround.
+      //
+      // Note: lookupCallback is a reference but is stored on OverlayChecker.
+      // Therefore OverlayChecker must not exist longer than this initOverlay
+      // call.
+      OverlayChecker checker(
+          static_cast<FsInodeCatalog*>(inodeCatalog_.get()),
+          static_cast<FileContentStore*>(fileContentStore_.get()),
+          std::nullopt,
+          lookupCallback);
+      folly::stop_watch<> fsckRuntime;
+      checker.scanForErrors(progressCallback);
+      auto result = checker.repairErrors();
+      auto fsckRuntimeInSeconds =
+          std::chrono::duration<double>{fsckRuntime.elapsed()}.count();
+      if (result) {
+        // If totalErrors - fixedErrors is nonzero, then we failed to
+        // fix all of the problems.
+        auto success = !(result->totalErrors - result->fixedErrors);
+        structuredLogger_->logEvent(
+            Fsck{fsckRuntimeInSeconds, success, true /*attempted_repair*/});
+      } else {
+        structuredLogger_->logEvent(Fsck{
+            fsckRuntimeInSeconds,
+            true /*success*/,
+            false /*attempted_repair*/});
+      }
 
-    optNextInodeNumber = checker.getNextInodeNumber();
+      optNextInodeNumber = checker.getNextInodeNumber();
+    }
 #else
     // SqliteInodeCatalog will always return the value of next Inode number, if
     // we end up here - it's a bug.
@@ -311,6 +337,10 @@ void Overlay::initOverlay(
 }
 
 InodeNumber Overlay::allocateInodeNumber() {
+  return allocateInodeNumberRange(1);
+}
+
+InodeNumber Overlay::allocateInodeNumberRange(uint64_t count) {
   // InodeNumber should generally be 64-bits wide, in which case it isn't even
   // worth bothering to handle the case where nextInodeNumber_ wraps.  We don't
   // need to bother checking for conflicts with existing inode numbers since
@@ -322,10 +352,13 @@ InodeNumber Overlay::allocateInodeNumber() {
   static_assert(
       sizeof(InodeNumber) >= 8, "expected InodeNumber to be at least 64 bits");
 
-  // This could be a relaxed atomic operation.  It doesn't matter on x86 but
-  // might on ARM.
-  auto previous = nextInodeNumber_++;
-  XDCHECK_NE(0u, previous) << "allocateInodeNumber called before initialize";
+  // The counter does not synchronize any other memory: allocated numbers are
+  // published through data structures with their own locking, so a relaxed
+  // bump is sufficient.
+  auto previous =
+      nextInodeNumber_.fetch_add(count, std::memory_order_relaxed);
+  XDCHECK_NE(0u, previous)
+      << "allocateInodeNumberRange called before initialize";
   return InodeNumber{previous};
 }
 
@@ -355,12 +388,18 @@ DirContents Overlay::loadOverlayDir(InodeNumber inodeNumber) {
     if (value.hash_ref() && !value.hash_ref()->empty()) {
       auto hash =
           ObjectId{folly::ByteRange{folly::StringPiece{*value.hash_ref()}}};
-      result.emplace(PathComponentPiece{name}, *value.mode_ref(), ino, hash);
+      result.unsortedAppend(
+          PathComponentPiece{name}, *value.mode_ref(), ino, hash);
     } else {
       // The inode is materialized
-      result.emplace(PathComponentPiece{name}, *value.mode_ref(), ino);
+      result.unsortedAppend(PathComponentPiece{name}, *value.mode_ref(), ino);
     }
   }
+  // The serialized entries are sorted byte-wise, which is not sorted order
+  // for a case insensitive mount; appending and sorting once avoids the
+  // quadratic rebuild that ordered inserts would do. This also repairs any
+  // case collisions a bug left behind: the first entry of each run wins.
+  result.sortAndDedupe();
 
   if (shouldMigrateToNewFormat) {
     saveOverlayDir(inodeNumber, result);
@@ -417,6 +456,7 @@ overlay::OverlayDir Overlay::serializeOverlayDir(
 }
 
 void Overlay::saveOverlayDir(InodeNumber inodeNumber, const DirContents& dir) {
+  EDEN_SDT(overlay_save_dir, inodeNumber.get(), dir.size());
   inodeCatalog_->saveOverlayDir(
       inodeNumber, serializeOverlayDir(inodeNumber, dir));
 }
@@ -171,10 +171,19 @@ class Overlay : public std::enable_shared_from_this<Overlay> {
    *   inodeCreated() should be called immediately afterwards to register the
    *   new child Inode object.
    *
-   * TODO: It would be easy to extend this function to allocate a range of
-   * inode values in one atomic operation.
    */
   InodeNumber allocateInodeNumber();
+
+  /**
+   * Allocate a contiguous range of inode numbers in one atomic operation.
+   *
+   * Returns the first number of the range; the allocated numbers span
+   * [first, first + count). This is useful when populating a directory from
+   * a source control tree, where every entry needs a number and paying one
+   * atomic bump per entry is wasted work. Like allocateInodeNumber(), this
+   * should only be called by TreeInode.
+   */
+  InodeNumber allocateInodeNumberRange(uint64_t count);
 #ifndef _WIN32
 
   /**
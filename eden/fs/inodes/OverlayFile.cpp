@@ -11,6 +11,8 @@
 
 #include <folly/FileUtil.h>
 
+#include <fcntl.h>
+
 #include "eden/fs/inodes/Overlay.h"
 
 namespace facebook::eden {
@@ -127,6 +129,32 @@ folly::Expected<int, int> OverlayFile::fallocate(off_t offset, off_t length)
 #endif
 }
 
+folly::Expected<int, int> OverlayFile::fadvise(
+    off_t offset,
+    off_t length,
+    int advice) const {
+#ifdef __linux__
+  std::shared_ptr<Overlay> overlay = overlay_.lock();
+  if (!overlay) {
+    return folly::makeUnexpected(EIO);
+  }
+  IORequest req{overlay.get()};
+
+  // posix_fadvise returns the error number directly rather than setting
+  // errno.
+  auto ret = ::posix_fadvise(file_.fd(), offset, length, advice);
+  if (ret != 0) {
+    return folly::makeUnexpected(ret);
+  }
+  return folly::makeExpected<int>(0);
+#else
+  (void)offset;
+  (void)length;
+  (void)advice;
+  return folly::makeUnexpected(ENOSYS);
+#endif
+}
+
 folly::Expected<int, int> OverlayFile::fdatasync() const {
 #ifndef __APPLE__
   std::shared_ptr<Overlay> overlay = overlay_.lock();
@@ -36,6 +36,8 @@ class OverlayFile {
   folly::Expected<int, int> ftruncate(off_t length) const;
   folly::Expected<int, int> fsync() const;
   folly::Expected<int, int> fallocate(off_t offset, off_t length) const;
+  folly::Expected<int, int> fadvise(off_t offset, off_t length, int advice)
+      const;
   folly::Expected<int, int> fdatasync() const;
   folly::Expected<std::string, int> readFile() const;
 
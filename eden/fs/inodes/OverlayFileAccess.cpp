@@ -9,12 +9,17 @@
 
 #include "eden/fs/inodes/OverlayFileAccess.h"
 
+#include <fcntl.h>
+
 #include <folly/Expected.h>
 #include <folly/Range.h>
 #include <folly/logging/xlog.h>
 #include <folly/portability/GFlags.h>
 #include <folly/portability/OpenSSL.h>
 
+#include "eden/fs/config/EdenConfig.h"
+#include "eden/fs/config/ReloadableConfig.h"
+#include "eden/fs/inodes/EdenMount.h"
 #include "eden/fs/inodes/FileInode.h"
 #include "eden/fs/inodes/InodeError.h"
 #include "eden/fs/inodes/InodePtr.h"
@@ -22,6 +27,8 @@
 #include "eden/fs/inodes/OverlayFile.h"
 #include "eden/fs/inodes/TreeInode.h"
 #include "eden/fs/model/Blob.h"
+#include "eden/fs/telemetry/EdenStats.h"
+#include "eden/fs/telemetry/RequestProbes.h"
 #include "eden/fs/utils/Bug.h"
 #include "folly/FileUtil.h"
 
@@ -47,8 +54,14 @@ OverlayFileAccess::State::State(size_t cacheSize) : entries{cacheSize} {
   }
 }
 
-OverlayFileAccess::OverlayFileAccess(Overlay* overlay)
-    : overlay_{overlay}, state_{folly::in_place, FLAGS_overlayFileCacheSize} {}
+OverlayFileAccess::OverlayFileAccess(
+    Overlay* overlay,
+    std::shared_ptr<ReloadableConfig> config,
+    EdenStats* stats)
+    : overlay_{overlay},
+      config_{config},
+      ioScheduler_{std::move(config), stats},
+      state_{folly::in_place, FLAGS_overlayFileCacheSize} {}
 
 OverlayFileAccess::~OverlayFileAccess() = default;
 
@@ -64,7 +77,9 @@ void OverlayFileAccess::createEmptyFile(InodeNumber ino) {
 void OverlayFileAccess::createFile(
     InodeNumber ino,
     const Blob& blob,
-    const std::optional<Hash20>& sha1) {
+    const std::optional<Hash20>& sha1,
+    OverlayIoScheduler::IoClass ioClass) {
+  ioScheduler_.acquire(ioClass, blob.getSize());
   auto file = overlay_->createOverlayFile(ino, blob.getContents());
   auto state = state_.wlock();
   XCHECK(!state->entries.exists(ino))
@@ -175,33 +190,40 @@ Hash20 OverlayFileAccess::getSha1(FileInode& inode) {
 std::string OverlayFileAccess::readAllContents(FileInode& inode) {
   auto entry = getEntryForInode(inode.getNodeId());
 
-  // Note that this code requires a write lock on the entry because the lseek()
-  // call modifies the file offset of the file descriptor. Otherwise, concurrent
-  // readAllContents() calls would step on each other.
-  //
-  // This violates our rule of not doing IO while locks are held, but
-  // readAllContents() is rare, primarily for files like .gitignore that Eden
-  // must read.
-  //
-  // TODO: implement readFile with pread instead of lseek.
-  auto info = entry->info.wlock();
-
-  auto rc = entry->file.lseek(FileContentStore::kHeaderLength, SEEK_SET);
-  if (rc.hasError()) {
+  // Read with pread rather than lseek-then-read: pread doesn't modify the
+  // shared file descriptor's offset, so no entry lock needs to be held
+  // across the IO and concurrent reads and writes through this entry can
+  // proceed freely.
+  auto st = entry->file.fstat();
+  if (st.hasError()) {
     throw InodeError(
-        rc.error(),
+        st.error(),
         inode.inodePtrFromThis(),
-        "unable to seek in materialized FileInode");
+        "unable to fstat overlay file");
+  }
+  std::string result;
+  auto fileSize = st.value().st_size;
+  if (fileSize > static_cast<off_t>(FileContentStore::kHeaderLength)) {
+    result.reserve(fileSize - FileContentStore::kHeaderLength);
   }
-  auto result = entry->file.readFile();
 
-  if (result.hasError()) {
-    throw InodeError(
-        result.error(),
-        inode.inodePtrFromThis(),
-        "unable to read overlay file");
+  off_t off = FileContentStore::kHeaderLength;
+  while (true) {
+    uint8_t buf[8192];
+    auto ret = entry->file.preadNoInt(&buf, sizeof(buf), off);
+    if (ret.hasError()) {
+      throw InodeError(
+          ret.error(),
+          inode.inodePtrFromThis(),
+          "unable to read overlay file");
+    }
+    auto len = ret.value();
+    if (len == 0) {
+      return result;
+    }
+    result.append(reinterpret_cast<char*>(buf), len);
+    off += len;
   }
-  return result.value();
 }
 
 BufVec OverlayFileAccess::read(FileInode& inode, size_t size, off_t off) {
@@ -219,14 +241,90 @@ BufVec OverlayFileAccess::read(FileInode& inode, size_t size, off_t off) {
   }
 
   buf->append(res.value());
+  adviseAfterRead(*entry, off, res.value());
   return BufVec{std::move(buf)};
 }
 
+void OverlayFileAccess::adviseAfterRead(Entry& entry, off_t off, size_t len) {
+#ifdef __linux__
+  auto config = config_->getEdenConfig();
+  if (!config->overlayReadFadvise.getValue()) {
+    return;
+  }
+  const auto dontneedBytes = config->overlayReadFadviseDontneedBytes.getValue();
+
+  // A file is classified once a handful of reads have been observed:
+  // mostly-contiguous files get kernel readahead turned up, files hopping
+  // around (databases, mmap-style access via FUSE) get readahead turned
+  // off. The counters are cheap enough to keep updating afterwards, so a
+  // file that changes behavior is eventually reclassified.
+  constexpr uint64_t kClassifyAfterReads = 8;
+
+  std::optional<int> newAdvice;
+  std::optional<std::pair<off_t, off_t>> dropRange;
+  {
+    auto pattern = entry.readPattern.wlock();
+    if (off == pattern->nextSequentialOffset) {
+      ++pattern->sequentialReads;
+    } else {
+      ++pattern->randomReads;
+      // A seek starts a new sweep; anything dropped before stays dropped.
+      pattern->sweepStart = off;
+    }
+    pattern->nextSequentialOffset = off + static_cast<off_t>(len);
+
+    if (pattern->sequentialReads + pattern->randomReads >=
+        kClassifyAfterReads) {
+      if (pattern->randomReads > pattern->sequentialReads &&
+          pattern->advice != Entry::ReadAdvice::Random) {
+        pattern->advice = Entry::ReadAdvice::Random;
+        newAdvice = POSIX_FADV_RANDOM;
+      } else if (
+          pattern->sequentialReads >= 4 * pattern->randomReads &&
+          pattern->advice != Entry::ReadAdvice::Sequential) {
+        pattern->advice = Entry::ReadAdvice::Sequential;
+        newAdvice = POSIX_FADV_SEQUENTIAL;
+      }
+    }
+
+    if (pattern->advice == Entry::ReadAdvice::Sequential &&
+        dontneedBytes != 0 &&
+        pattern->nextSequentialOffset - pattern->sweepStart >=
+            static_cast<off_t>(dontneedBytes)) {
+      // A large sweep has accumulated behind the read position; drop those
+      // pages so streaming a big file cannot evict the rest of the page
+      // cache. The drop happens outside the pattern lock.
+      dropRange = {pattern->sweepStart, pattern->nextSequentialOffset};
+      pattern->sweepStart = pattern->nextSequentialOffset;
+    }
+  }
+
+  // Advice failures are ignored: these are pure hints and the read itself
+  // already succeeded.
+  if (newAdvice.has_value()) {
+    (void)entry.file.fadvise(0, 0, *newAdvice);
+  }
+  if (dropRange.has_value()) {
+    (void)entry.file.fadvise(
+        dropRange->first + FileContentStore::kHeaderLength,
+        dropRange->second - dropRange->first,
+        POSIX_FADV_DONTNEED);
+  }
+#else
+  (void)entry;
+  (void)off;
+  (void)len;
+#endif
+}
+
 size_t OverlayFileAccess::write(
     FileInode& inode,
     const struct iovec* iov,
     size_t iovcnt,
     off_t off) {
+  SampledDurationScope stageScope{
+      inode.getMount()->getStats(), &StageStats::overlayWrite};
+  EDEN_SDT(overlay_write, inode.getNodeId().get(), off);
   auto entry = getEntryForInode(inode.getNodeId());
 
   auto xfer =
@@ -286,6 +384,11 @@ void OverlayFileAccess::fallocate(
   }
 }
 
+void OverlayFileAccess::forget(InodeNumber ino) {
+  auto state = state_.wlock();
+  state->entries.erase(ino);
+}
+
 OverlayFileAccess::EntryPtr OverlayFileAccess::getEntryForInode(
     InodeNumber ino) {
   {
@@ -14,14 +14,17 @@
 #include "eden/fs/inodes/InodeNumber.h"
 #include "eden/fs/inodes/InodePtr.h"
 #include "eden/fs/inodes/OverlayFile.h"
+#include "eden/fs/inodes/OverlayIoScheduler.h"
 #include "eden/fs/model/Hash.h"
 #include "eden/fs/utils/BufVec.h"
 
 namespace facebook::eden {
 
 class Blob;
+class EdenStats;
 class FileInode;
 class Overlay;
+class ReloadableConfig;
 
 /**
  * Provides a file handle caching layer between FileInode and the Overlay. Read
@@ -30,7 +33,10 @@ class Overlay;
  */
 class OverlayFileAccess {
  public:
-  explicit OverlayFileAccess(Overlay* overlay);
+  OverlayFileAccess(
+      Overlay* overlay,
+      std::shared_ptr<ReloadableConfig> config,
+      EdenStats* stats);
   ~OverlayFileAccess();
 
   /**
@@ -46,6 +52,10 @@ class OverlayFileAccess {
    * Creates a new file in the overlay populated with the contents of the given
    * blob. If a sha1 is given, it is cached in memory.
    *
+   * The ioClass describes what is driving this materialization; bulk
+   * classes may be rate limited by the I/O scheduler to keep interactive
+   * writes responsive.
+   *
    * The caller must verify the overlay file does not already exist. Calls to
    * any other OverlayFileAccess functions for this inode must occur after
    * createEmptyFile returns.
@@ -53,7 +63,8 @@ class OverlayFileAccess {
   void createFile(
       InodeNumber ino,
       const Blob& blob,
-      const std::optional<Hash20>& sha1);
+      const std::optional<Hash20>& sha1,
+      OverlayIoScheduler::IoClass ioClass);
 
   /**
    * Return the size of the overlay file at the given inode number. The result
@@ -104,6 +115,16 @@ class OverlayFileAccess {
    */
   void fallocate(FileInode& inode, uint64_t offset, uint64_t size);
 
+  /**
+   * Drops any cached file handle and metadata for the given inode number.
+   *
+   * This must be called when an inode's overlay file is removed while the
+   * inode itself remains known to the mount (for example when an unloaded
+   * entry is dematerialized), so that a later re-materialization does not
+   * find a stale handle to the unlinked file.
+   */
+  void forget(InodeNumber ino);
+
  private:
   /*
    * OverlayFileAccess can be accessed concurrently. There are two types of data
@@ -142,8 +163,30 @@ class OverlayFileAccess {
       uint64_t version{0};
     };
 
+    /**
+     * The readahead advice currently applied to this entry's fd.
+     */
+    enum class ReadAdvice : uint8_t { None, Sequential, Random };
+
+    /**
+     * Classifier state for the read access pattern observed on this file,
+     * used to drive posix_fadvise on the overlay fd. Kept separate from
+     * Info so the read path does not contend with the size/SHA-1 cache
+     * lock.
+     */
+    struct ReadPattern {
+      /** Where the next read would start if the file is read in order. */
+      off_t nextSequentialOffset{0};
+      uint64_t sequentialReads{0};
+      uint64_t randomReads{0};
+      /** Start of the current contiguous sweep, for DONTNEED drops. */
+      off_t sweepStart{0};
+      ReadAdvice advice{ReadAdvice::None};
+    };
+
     const OverlayFile file;
     folly::Synchronized<Info> info;
+    folly::Synchronized<ReadPattern> readPattern;
   };
 
   using EntryPtr = std::shared_ptr<Entry>;
@@ -162,7 +205,16 @@ class OverlayFileAccess {
    */
   EntryPtr getEntryForInode(InodeNumber);
 
+  /**
+   * Feeds one completed read into the entry's access-pattern classifier and
+   * applies any resulting posix_fadvise hints to the overlay fd. No-op off
+   * Linux or when overlay:read-fadvise is disabled.
+   */
+  void adviseAfterRead(Entry& entry, off_t off, size_t len);
+
   Overlay* overlay_ = nullptr;
+  std::shared_ptr<ReloadableConfig> config_;
+  OverlayIoScheduler ioScheduler_;
   folly::Synchronized<State> state_;
 };
 
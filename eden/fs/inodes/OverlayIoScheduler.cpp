@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifndef _WIN32
+
+#include "eden/fs/inodes/OverlayIoScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "eden/fs/config/EdenConfig.h"
+#include "eden/fs/config/ReloadableConfig.h"
+#include "eden/fs/telemetry/EdenStats.h"
+
+namespace facebook::eden {
+
+OverlayIoScheduler::OverlayIoScheduler(
+    std::shared_ptr<ReloadableConfig> config,
+    EdenStats* stats)
+    : config_{std::move(config)}, stats_{stats} {}
+
+void OverlayIoScheduler::acquire(IoClass ioClass, size_t bytes) {
+  if (ioClass == IoClass::Interactive) {
+    return;
+  }
+
+  auto config = config_->getEdenConfig();
+  uint64_t rate;
+  folly::DynamicTokenBucket* bucket;
+  switch (ioClass) {
+    case IoClass::CheckoutBulk:
+      rate = config->overlayCheckoutBulkIoThroughput.getValue();
+      bucket = &checkoutBucket_;
+      break;
+    case IoClass::Background:
+      rate = config->overlayBackgroundIoThroughput.getValue();
+      bucket = &backgroundBucket_;
+      break;
+    case IoClass::Interactive:
+      return;
+  }
+  if (rate == 0) {
+    return;
+  }
+
+  // Allow a second's worth of burst so short bursts pass untouched and only
+  // sustained bulk traffic is paced. An I/O larger than the burst consumes
+  // the whole burst: the deadline bounds its wait like any other.
+  auto burst = static_cast<double>(rate);
+  auto toConsume = std::min(static_cast<double>(bytes), burst);
+  auto napTime =
+      bucket->consumeWithBorrowNonBlocking(toConsume, rate, burst);
+  if (!napTime || *napTime <= 0.0) {
+    return;
+  }
+
+  auto deadline = std::chrono::duration_cast<std::chrono::duration<double>>(
+                      config->overlayIoThrottleDeadline.getValue())
+                      .count();
+  auto wait = *napTime;
+  if (wait > deadline) {
+    // Deadline promotion: don't delay any single I/O past the deadline,
+    // the debt stays in the bucket and paces whatever bulk work follows.
+    wait = deadline;
+    stats_->increment(&OverlayStats::deadlinePromotions);
+  }
+
+  /* sleep override */ std::this_thread::sleep_for(
+      std::chrono::duration<double>(wait));
+  stats_->addDuration(
+      &OverlayStats::throttleWait, std::chrono::duration<double>(wait));
+}
+
+} // namespace facebook::eden
+
+#endif
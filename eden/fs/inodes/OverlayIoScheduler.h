@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <folly/TokenBucket.h>
+
+namespace facebook::eden {
+
+class EdenStats;
+class ReloadableConfig;
+
+/**
+ * Rate limits bulk overlay I/O so it doesn't starve interactive writes.
+ *
+ * Overlay operations all land on the same disk: a user saving a file in
+ * their editor competes with checkout materializing file contents in bulk.
+ * On slow disks the bulk writer wins and interactive saves stutter. The
+ * scheduler divides overlay writes into classes and meters the bulk classes
+ * with per-class token buckets, leaving interactive writes untouched.
+ *
+ * A throttled write never waits longer than the configured deadline: once
+ * it has waited that long it is promoted and proceeds regardless of the
+ * token bucket, so the throttle bounds added latency rather than
+ * serializing bulk work behind an arbitrarily deep queue.
+ *
+ * Rates and the deadline come from EdenConfig and are re-read on every
+ * acquisition, so config changes apply without remounting. A rate of 0
+ * leaves that class unthrottled. Waits are recorded in EdenStats.
+ *
+ * This class is thread safe.
+ */
+class OverlayIoScheduler {
+ public:
+  enum class IoClass {
+    /** User-driven filesystem writes. Never throttled. */
+    Interactive,
+    /** Bulk materialization on behalf of checkout. */
+    CheckoutBulk,
+    /** Prefetch and other background-driven materialization. */
+    Background,
+  };
+
+  OverlayIoScheduler(
+      std::shared_ptr<ReloadableConfig> config,
+      EdenStats* stats);
+
+  /**
+   * Wait until the given class may perform an I/O of the given size.
+   *
+   * Returns immediately for the Interactive class and for classes whose
+   * configured rate is 0. May block the calling thread up to the configured
+   * deadline otherwise.
+   */
+  void acquire(IoClass ioClass, size_t bytes);
+
+ private:
+  std::shared_ptr<ReloadableConfig> config_;
+  EdenStats* stats_;
+
+  folly::DynamicTokenBucket checkoutBucket_;
+  folly::DynamicTokenBucket backgroundBucket_;
+};
+
+} // namespace facebook::eden
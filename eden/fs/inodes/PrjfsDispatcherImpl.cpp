@@ -20,6 +20,7 @@
 #include "eden/fs/inodes/FileInode.h"
 #include "eden/fs/inodes/ServerState.h"
 #include "eden/fs/inodes/TreeInode.h"
+#include "eden/fs/journal/Journal.h"
 #include "eden/fs/store/ObjectFetchContext.h"
 #include "eden/fs/store/ObjectStore.h"
 #include "eden/fs/utils/FaultInjector.h"
@@ -59,6 +60,8 @@ std::string makeDotEdenConfig(EdenMount& mount) {
   return stream.str();
 }
 
+constexpr size_t kEnumerationCacheMaxEntries = 256;
+
 } // namespace
 
 PrjfsDispatcherImpl::PrjfsDispatcherImpl(EdenMount* mount)
@@ -67,11 +70,29 @@ PrjfsDispatcherImpl::PrjfsDispatcherImpl(EdenMount* mount)
       executor_{1, "PrjfsDispatcher"},
       notificationExecutor_{
           folly::SerialExecutor::create(folly::getKeepAliveToken(&executor_))},
-      dotEdenConfig_{makeDotEdenConfig(*mount)} {}
+      dotEdenConfig_{makeDotEdenConfig(*mount)},
+      enumerationCacheEnabled_{
+          mount_->getEdenConfig()->prjfsEnumerationCache.getValue()},
+      enumerationCache_{std::in_place, kEnumerationCacheMaxEntries} {}
 
-ImmediateFuture<std::vector<PrjfsDirEntry>> PrjfsDispatcherImpl::opendir(
+ImmediateFuture<std::shared_ptr<std::vector<PrjfsDirEntry>>>
+PrjfsDispatcherImpl::opendir(
     RelativePath path,
     const ObjectFetchContextPtr& context) {
+  // Sample the journal sequence before reading the directory content: a
+  // mutation that races with the read bumps the sequence and simply turns
+  // the cached snapshot into a miss on the next enumeration.
+  uint64_t journalSequence = 0;
+  if (enumerationCacheEnabled_) {
+    journalSequence = mount_->getJournal().getLatestSequenceID();
+
+    auto cache = enumerationCache_.wlock();
+    auto it = cache->find(path);
+    if (it != cache->end() && it->second.journalSequence == journalSequence) {
+      return it->second.snapshot;
+    }
+  }
+
   bool isRoot = path.empty();
   return mount_->getTreeOrTreeEntry(path, context)
       .thenValue([isRoot,
@@ -101,7 +122,7 @@ ImmediateFuture<std::vector<PrjfsDirEntry>> PrjfsDispatcherImpl::opendir(
 
         return ret;
       })
-      .thenTry([this, path = std::move(path)](
+      .thenTry([this, path = std::move(path), journalSequence](
                    folly::Try<std::vector<PrjfsDirEntry>> dirEntries) {
         if (auto* exc = dirEntries.tryGetExceptionObject<std::system_error>()) {
           if (isEnoent(*exc)) {
@@ -111,7 +132,7 @@ ImmediateFuture<std::vector<PrjfsDirEntry>> PrjfsDispatcherImpl::opendir(
                   PathComponent{kConfigTable},
                   false,
                   ImmediateFuture<uint64_t>(dotEdenConfig_.size()));
-              return folly::Try{ret};
+              return folly::Try{Enumerator::makeSortedSnapshot(std::move(ret))};
             } else {
               // An update to a commit not containing a directory but with
               // materialized and ignored subdirectories/files will still be
@@ -119,11 +140,23 @@ ImmediateFuture<std::vector<PrjfsDirEntry>> PrjfsDispatcherImpl::opendir(
               // due to EdenFS not being able to make the directory full. We
               // thus simply return an empty directory and ProjectedFS will
               // combine it with the on-disk materialized state.
-              return folly::Try{std::vector<PrjfsDirEntry>{}};
+              return folly::Try{Enumerator::makeSortedSnapshot({})};
             }
           }
         }
-        return dirEntries;
+
+        if (dirEntries.hasException()) {
+          return folly::Try<std::shared_ptr<std::vector<PrjfsDirEntry>>>{
+              dirEntries.exception()};
+        }
+
+        auto snapshot =
+            Enumerator::makeSortedSnapshot(std::move(dirEntries).value());
+        if (enumerationCacheEnabled_) {
+          enumerationCache_.wlock()->set(
+              path, EnumerationCacheEntry{journalSequence, snapshot});
+        }
+        return folly::Try{std::move(snapshot)};
       });
 }
 
@@ -657,6 +690,61 @@ ImmediateFuture<folly::Unit> fileNotificationImpl(
       });
 }
 
+ImmediateFuture<folly::Unit> directoryRenamedImpl(
+    const EdenMount& mount,
+    RelativePath oldPath,
+    RelativePath newPath,
+    std::chrono::steady_clock::time_point receivedAt,
+    const ObjectFetchContextPtr& context) {
+  // Try to move the directory in one step: TreeInode::rename relinks the
+  // entry in the two parents and renames the child in the overlay catalog,
+  // so renaming a 50k-file directory costs the same as renaming an empty
+  // one and the journal gets a single rename record. Descendant inodes and
+  // their overlay state are left untouched.
+  auto srcParentFut = mount.getInodeSlow(oldPath.dirname().copy(), context)
+                          .thenValue([](const InodePtr inode) {
+                            return inode.asTreePtr();
+                          });
+  auto destParentFut = createDirInode(mount, newPath.dirname().copy(), context);
+
+  return collectAllSafe(std::move(srcParentFut), std::move(destParentFut))
+      .thenValue([oldName = oldPath.basename().copy(),
+                  newName = newPath.basename().copy(),
+                  context = context.copy()](
+                     std::tuple<TreeInodePtr, TreeInodePtr> parents) {
+        auto& [srcParent, destParent] = parents;
+        return srcParent->rename(
+            oldName, destParent, newName, InvalidationRequired::No, context);
+      })
+      .thenTry([&mount,
+                oldPath = std::move(oldPath),
+                newPath = std::move(newPath),
+                receivedAt,
+                context = context.copy()](folly::Try<folly::Unit> try_) mutable
+               -> ImmediateFuture<folly::Unit> {
+        if (!try_.hasException()) {
+          return folly::unit;
+        }
+        // The direct move can legitimately fail: the source may never have
+        // made it into the inode hierarchy, notifications may have been
+        // reordered, or something already sits at the destination. Fall
+        // back to reconciling both paths against the on-disk state.
+        XLOG(DBG4) << "Directory rename " << oldPath << " -> " << newPath
+                   << " falling back to per-entry reconciliation: "
+                   << try_.exception().what();
+        auto oldNotification =
+            fileNotificationImpl(mount, std::move(oldPath), receivedAt, context);
+        auto newNotification =
+            fileNotificationImpl(mount, std::move(newPath), receivedAt, context);
+        return collectAllSafe(
+                   std::move(oldNotification), std::move(newNotification))
+            .thenValue(
+                [](std::tuple<folly::Unit, folly::Unit>&&) {
+                  return folly::unit;
+                });
+      });
+}
+
 ImmediateFuture<folly::Unit> fileNotification(
     EdenMount& mount,
     RelativePath path,
@@ -735,6 +823,50 @@ ImmediateFuture<folly::Unit> PrjfsDispatcherImpl::fileRenamed(
           [](std::tuple<folly::Unit, folly::Unit>&&) { return folly::unit; });
 }
 
+ImmediateFuture<folly::Unit> PrjfsDispatcherImpl::dirRenamed(
+    RelativePath oldPath,
+    RelativePath newPath,
+    const ObjectFetchContextPtr& context) {
+  auto receivedAt = std::chrono::steady_clock::now();
+  folly::stop_watch<std::chrono::milliseconds> watch;
+
+  folly::via(
+      notificationExecutor_,
+      [&mount = *mount_,
+       oldPath = std::move(oldPath),
+       newPath = std::move(newPath),
+       receivedAt,
+       context = context.copy(),
+       watch]() mutable {
+        auto fault = ImmediateFuture{
+            mount.getServerState()->getFaultInjector().checkAsync(
+                "PrjfsDispatcherImpl::fileNotification", oldPath)};
+
+        std::move(fault)
+            .thenValue([&mount,
+                        oldPath = std::move(oldPath),
+                        newPath = std::move(newPath),
+                        receivedAt,
+                        context = context.copy()](auto&&) mutable {
+              return directoryRenamedImpl(
+                  mount,
+                  std::move(oldPath),
+                  std::move(newPath),
+                  receivedAt,
+                  context);
+            })
+            .get();
+        mount.getStats()->addDuration(
+            &PrjfsStats::queuedFileNotification, watch.elapsed());
+      })
+      .thenError([](const folly::exception_wrapper& ew) {
+        // See the comment in fileNotification for why errors are only
+        // logged here.
+        XLOG(DFATAL) << "While handling directory rename: " << ew;
+      });
+  return folly::unit;
+}
+
 ImmediateFuture<folly::Unit> PrjfsDispatcherImpl::preFileRename(
     RelativePath oldPath,
     RelativePath newPath,
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
 #include <folly/executors/SequencedExecutor.h>
 #include "eden/fs/prjfs/PrjfsDispatcher.h"
 #include "eden/fs/service/gen-cpp2/eden_types.h"
@@ -20,7 +22,7 @@ class PrjfsDispatcherImpl : public PrjfsDispatcher {
  public:
   explicit PrjfsDispatcherImpl(EdenMount* mount);
 
-  ImmediateFuture<std::vector<PrjfsDirEntry>> opendir(
+  ImmediateFuture<std::shared_ptr<std::vector<PrjfsDirEntry>>> opendir(
       RelativePath path,
       const ObjectFetchContextPtr& context) override;
 
@@ -53,6 +55,11 @@ class PrjfsDispatcherImpl : public PrjfsDispatcher {
       RelativePath newPath,
       const ObjectFetchContextPtr& context) override;
 
+  ImmediateFuture<folly::Unit> dirRenamed(
+      RelativePath oldPath,
+      RelativePath newPath,
+      const ObjectFetchContextPtr& context) override;
+
   ImmediateFuture<folly::Unit> preDirRename(
       RelativePath oldPath,
       RelativePath newPath,
@@ -82,6 +89,16 @@ class PrjfsDispatcherImpl : public PrjfsDispatcher {
   ImmediateFuture<folly::Unit> waitForPendingNotifications() override;
 
  private:
+  /**
+   * An enumeration snapshot along with the journal sequence number that was
+   * current when it was built. The snapshot is only valid while the journal
+   * hasn't moved past that sequence.
+   */
+  struct EnumerationCacheEntry {
+    uint64_t journalSequence;
+    std::shared_ptr<std::vector<PrjfsDirEntry>> snapshot;
+  };
+
   // The EdenMount associated with this dispatcher.
   EdenMount* const mount_;
 
@@ -92,6 +109,22 @@ class PrjfsDispatcherImpl : public PrjfsDispatcher {
   folly::Executor::KeepAlive<folly::SequencedExecutor> notificationExecutor_;
 
   const std::string dotEdenConfig_;
+
+  /**
+   * Whether opendir may serve enumeration snapshots from enumerationCache_.
+   * Controlled by the prjfs:enumeration-cache setting.
+   */
+  const bool enumerationCacheEnabled_;
+
+  /**
+   * Cache of sorted enumeration snapshots, keyed by directory path. Entries
+   * are validated against the journal sequence number sampled before they
+   * were built, so a directory change simply turns the next enumeration into
+   * a miss.
+   */
+  folly::Synchronized<
+      folly::EvictingCacheMap<RelativePath, EnumerationCacheEntry>>
+      enumerationCache_;
 };
 
 } // namespace facebook::eden
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <folly/CancellationToken.h>
 #include <folly/futures/Future.h>
 #include <atomic>
 #include <utility>
@@ -61,6 +62,19 @@ class FsObjectFetchContext : public ObjectFetchContext {
     return nullptr;
   }
 
+  folly::CancellationToken getCancellationToken() const override {
+    return cancellationSource_.getToken();
+  }
+
+  /**
+   * Signal that the channel request driving this fetch was aborted (e.g.
+   * FUSE_INTERRUPT). Backing store fetches that every subscriber has
+   * abandoned can then be dropped before they occupy an import slot.
+   */
+  void requestCancellation() {
+    cancellationSource_.requestCancellation();
+  }
+
   void deprioritize(uint64_t delta) override {
     ImportPriority prev = priority_.load(std::memory_order_acquire);
     priority_.compare_exchange_strong(
@@ -82,6 +96,8 @@ class FsObjectFetchContext : public ObjectFetchContext {
    * at the same time.
    */
   std::atomic<ImportPriority> priority_{kDefaultFsImportPriority};
+
+  folly::CancellationSource cancellationSource_;
 };
 
 using FsObjectFetchContextPtr = RefPtr<FsObjectFetchContext>;
@@ -121,6 +137,10 @@ class RequestContext {
     return *fsObjectFetchContext_;
   }
 
+  const FsObjectFetchContextPtr& getFsObjectFetchContextPtr() const {
+    return fsObjectFetchContext_;
+  }
+
  private:
   // RequestContext is used for every FsChannel implementation, each of which
   // has its own statistics. If non-empty, this function returns a Duration
@@ -97,6 +97,16 @@ class ServerState {
     return config_->getEdenConfig(reload);
   }
 
+  /**
+   * Get the settings consulted on per-request hot paths.
+   *
+   * Unlike getEdenConfig() this doesn't bounce the config shared_ptr
+   * refcount and never reloads; see ReloadableConfig::getHotSettings().
+   */
+  ReloadableConfig::HotSettings getHotConfigSettings() const {
+    return config_->getHotSettings();
+  }
+
   /**
    * Get the TopLevelIgnores. It is based on the system and user git ignore
    * files.
@@ -9,10 +9,12 @@
 
 #include <boost/polymorphic_cast.hpp>
 #include <folly/FileUtil.h>
+#include <folly/String.h>
 #include <folly/chrono/Conv.h>
 #include <folly/futures/Future.h>
 #include <folly/io/async/EventBase.h>
 #include <folly/logging/xlog.h>
+#include <folly/portability/OpenSSL.h>
 #include <vector>
 
 #include "eden/common/utils/Synchronized.h"
@@ -29,6 +31,7 @@
 #include "eden/fs/inodes/InodeTable.h"
 #include "eden/fs/inodes/Overlay.h"
 #include "eden/fs/inodes/OverlayFile.h"
+#include "eden/fs/inodes/OverlayFileAccess.h"
 #include "eden/fs/inodes/ServerState.h"
 #include "eden/fs/inodes/TreePrefetchLease.h"
 #include "eden/fs/journal/Journal.h"
@@ -152,8 +155,13 @@ TreeInode::TreeInode(
           name,
           initialMode,
           std::nullopt,
-          saveDirFromTree(ino, tree.get(), parent->getMount()),
-          tree->getHash()) {}
+          buildDirFromTree(
+              tree.get(),
+              parent->getMount()->getOverlay(),
+              parent->getMount()->getCheckoutConfig()->getCaseSensitive()),
+          tree->getHash()) {
+  persistTreeBackedDir();
+}
 
 TreeInode::TreeInode(
     InodeNumber ino,
@@ -171,8 +179,13 @@ TreeInode::TreeInode(
 TreeInode::TreeInode(EdenMount* mount, std::shared_ptr<const Tree>&& tree)
     : TreeInode(
           mount,
-          saveDirFromTree(kRootNodeId, tree.get(), mount),
-          tree->getHash()) {}
+          buildDirFromTree(
+              tree.get(),
+              mount->getOverlay(),
+              mount->getCheckoutConfig()->getCaseSensitive()),
+          tree->getHash()) {
+  persistTreeBackedDir();
+}
 
 TreeInode::TreeInode(
     EdenMount* mount,
@@ -472,12 +485,71 @@ ImmediateFuture<InodePtr> TreeInode::getChildRecursive(
     return inodePtrFromThis();
   }
 
-  auto processor = std::make_unique<LookupProcessor>(path, context.copy());
-  auto future = processor->next(inodePtrFromThis());
-  // This ensure() callback serves to hold onto the unique_ptr,
-  // and makes sure it only gets destroyed when the future is finally resolved.
-  return std::move(future).ensure(
-      [p = std::move(processor)]() mutable { p.reset(); });
+  auto runSlowPath = [&](TreeInodePtr tree, RelativePathPiece remainder) {
+    auto processor =
+        std::make_unique<LookupProcessor>(remainder, context.copy());
+    auto future = processor->next(std::move(tree));
+    // This ensure() callback serves to hold onto the unique_ptr,
+    // and makes sure it only gets destroyed when the future is finally
+    // resolved.
+    return std::move(future).ensure(
+        [p = std::move(processor)]() mutable { p.reset(); });
+  };
+
+  // Fast path: walk components whose inodes are already loaded with a single
+  // read lock acquisition per level and no future machinery. Build tools
+  // stat millions of deep paths whose intermediate directories are almost
+  // always loaded already, and allocating a LookupProcessor plus binding a
+  // callback per component made every such resolution pay one heap
+  // allocation and future chain per level. Fall back to the slow path above
+  // at the first component that needs to be loaded.
+  TreeInodePtr current = inodePtrFromThis();
+  auto componentRange = path.components();
+  for (auto iter = componentRange.begin(); iter != componentRange.end();
+       ++iter) {
+    auto name = *iter;
+    auto remainder = RelativePathPiece{
+        folly::StringPiece{name.view().data(), pathStr.data() + pathStr.size()},
+        detail::SkipPathSanityCheck{}};
+
+#ifndef _WIN32
+    if (name == kDotEdenName && current->getNodeId() != kRootNodeId) {
+      // The magic .eden entries are synthesized by getOrFindChild.
+      return runSlowPath(std::move(current), remainder);
+    }
+#endif // !_WIN32
+
+    InodePtr child;
+    {
+      auto contents = current->contents_.rlock();
+      auto it = contents->entries.find(name);
+      if (it == contents->entries.end()) {
+        return ImmediateFuture<InodePtr>{
+            folly::Try<InodePtr>{InodeError(ENOENT, current, name)}};
+      }
+      child = it->second.getInodePtr();
+    }
+    if (!child) {
+      return runSlowPath(std::move(current), remainder);
+    }
+
+    auto next = iter;
+    ++next;
+    if (next == componentRange.end()) {
+      return child;
+    }
+
+    auto childTree = child.asTreePtrOrNull();
+    if (!childTree) {
+      return ImmediateFuture<InodePtr>{
+          folly::Try<InodePtr>{InodeError(ENOTDIR, child)}};
+    }
+    current = std::move(childTree);
+  }
+
+  // The loop above returns on the last path component, and path is
+  // non-empty, so this is unreachable.
+  EDEN_BUG() << "unreachable: ran out of path components resolving " << path;
 }
 
 InodeNumber TreeInode::getChildInodeNumber(PathComponentPiece name) {
@@ -1044,16 +1116,18 @@ void TreeInode::saveOverlayDir(
   return getOverlay()->saveOverlayDir(inodeNumber, contents);
 }
 
-DirContents TreeInode::saveDirFromTree(
-    InodeNumber inodeNumber,
-    const Tree* tree,
-    EdenMount* mount) {
-  auto overlay = mount->getOverlay();
-  auto dir = buildDirFromTree(
-      tree, overlay, mount->getCheckoutConfig()->getCaseSensitive());
+void TreeInode::persistTreeBackedDir() {
+  auto contents = contents_.wlock();
+  if (getMount()->getEdenConfig()->deferUnmaterializedDirSave.getValue()) {
+    // Leave the freshly allocated inode numbers in memory only. If this
+    // directory is only ever enumerated, the overlay is never touched; the
+    // entries are written on demand when the inode must be remembered
+    // across an unload, or when it materializes.
+    contents->overlayDirPersisted = false;
+    return;
+  }
   // buildDirFromTree just allocated inode numbers; they should be saved.
-  overlay->saveOverlayDir(inodeNumber, dir);
-  return dir;
+  saveOverlayDir(contents->entries);
 }
 
 DirContents TreeInode::buildDirFromTree(
@@ -1062,20 +1136,27 @@ DirContents TreeInode::buildDirFromTree(
     CaseSensitivity caseSensitive) {
   XCHECK(tree);
 
-  // A future optimization is for this code to allocate all of the inode numbers
-  // at once and then dole them out, one per entry. It would reduce the number
-  // of atomic operations from N to 1, though if the atomic is issued with the
-  // other work this loop is doing it may not matter much.
+  // Allocate all of the inode numbers in one atomic operation and dole them
+  // out, one per entry, rather than bumping the allocator once per entry.
+  auto nextInode = overlay->allocateInodeNumberRange(tree->size()).get();
 
   DirContents dir(caseSensitive);
-  // TODO: O(N^2)
+  dir.reserve(tree->size());
+  // The scm tree is sorted case sensitively, which is not sorted order for
+  // a case insensitive mount, so ordered inserts would shift the vector on
+  // nearly every entry. Append everything and sort once instead.
   for (const auto& treeEntry : *tree) {
-    dir.emplace(
+    dir.unsortedAppend(
         treeEntry.first,
         modeFromTreeEntryType(treeEntry.second.getType()),
-        overlay->allocateInodeNumber(),
+        InodeNumber{nextInode++},
         treeEntry.second.getHash());
   }
+  if (auto dropped = dir.sortAndDedupe()) {
+    XLOG(WARN) << "tree " << tree->getHash().toLogString() << " contains "
+               << dropped
+               << " case-colliding entries; keeping the first of each";
+  }
   return dir;
 }
 
@@ -2297,32 +2378,52 @@ bool TreeInode::readdirImpl(
     }
   }
 
-  auto dir = contents_.rlock();
-  auto& entries = dir->entries;
-
-  // Compute an index into the PathMap by InodeNumber, only including the
-  // entries that are greater than the given offset.
-  std::vector<std::pair<InodeNumber, size_t>> indices;
-  indices.reserve(entries.size());
-  size_t index = 0;
-  for (auto& entry : entries) {
-    auto inodeNumber = entry.second.getInodeNumber();
-    if (static_cast<off_t>(inodeNumber.get() + 2) > off) {
-      indices.emplace_back(entry.second.getInodeNumber(), index);
+  // Take a snapshot of the fields readdir serves (name, inode number, and
+  // dtype) under the contents lock, and do everything else against the
+  // snapshot. Heapifying and serializing a directory with 100k+ entries
+  // (generated-code directories) takes long enough that doing it under the
+  // lock makes `ls` block writers, and mutations block concurrent readdirs,
+  // for the duration of the whole listing. Only entries that are greater
+  // than the given offset are copied.
+  struct SnapshotEntry {
+    PathComponent name;
+    InodeNumber inodeNumber;
+    dtype_t dtype;
+  };
+  std::vector<SnapshotEntry> snapshot;
+  {
+    auto dir = contents_.rlock();
+    auto& entries = dir->entries;
+    snapshot.reserve(entries.size());
+    for (auto& entry : entries) {
+      auto inodeNumber = entry.second.getInodeNumber();
+      if (static_cast<off_t>(inodeNumber.get() + 2) > off) {
+        snapshot.push_back(
+            SnapshotEntry{entry.first, inodeNumber, entry.second.getDtype()});
+      }
     }
-    ++index;
   }
-  std::make_heap(indices.begin(), indices.end(), std::greater<>{});
 
-  // The provided FuseDirList has limited space. Add entries until no more fit.
-  while (indices.size()) {
-    std::pop_heap(indices.begin(), indices.end(), std::greater<>{});
-    auto& [name, entry] = entries.begin()[indices.back().second];
-    indices.pop_back();
+  // Order the snapshot by InodeNumber, the offset ordering. A heap is used
+  // rather than a full sort since the provided DirList has limited space and
+  // listing typically stops well before the directory is exhausted.
+  auto byInodeNumber = [](const SnapshotEntry& lhs, const SnapshotEntry& rhs) {
+    return lhs.inodeNumber > rhs.inodeNumber;
+  };
+  std::make_heap(snapshot.begin(), snapshot.end(), byInodeNumber);
 
-    if (!add(name.view(), entry, entry.getInodeNumber().get() + 2)) {
+  // The provided FuseDirList has limited space. Add entries until no more fit.
+  while (snapshot.size()) {
+    std::pop_heap(snapshot.begin(), snapshot.end(), byInodeNumber);
+    auto& entry = snapshot.back();
+
+    if (!add(
+            entry.name.view(),
+            DirEntry{dtype_to_mode(entry.dtype), entry.inodeNumber},
+            entry.inodeNumber.get() + 2)) {
       return false;
     }
+    snapshot.pop_back();
   }
 
   return true;
@@ -2519,22 +2620,39 @@ ImmediateFuture<Unit> TreeInode::loadGitIgnoreThenDiff(
     const GitIgnoreStack* parentIgnore,
     bool isIgnored) {
   return makeImmediateFutureWith([gitignoreInode = std::move(gitignoreInode),
-                                  context] {
+                                  context]() -> ImmediateFuture<GitIgnore> {
            auto fileInode = gitignoreInode.asFileOrNull();
            if (!fileInode) {
              XLOG(WARN)
                  << "loadGitIgnoreThenDiff() invoked with a non-file inode: "
                  << gitignoreInode->getLogPath();
-             return makeImmediateFuture<std::string>(
+             return makeImmediateFuture<GitIgnore>(
                  InodeError(EISDIR, gitignoreInode));
            } else {
 #ifndef _WIN32
              if (fileInode->getType() == dtype_t::Symlink) {
-               return makeImmediateFuture<std::string>(
+               return makeImmediateFuture<GitIgnore>(
                    InodeError(EMLINK, gitignoreInode));
              }
 #endif
-             return fileInode->readAll(context->getFetchContext());
+             // A non-materialized .gitignore is backed by an immutable blob,
+             // so a previous diff may well have parsed it already.
+             auto blobHash = fileInode->getBlobHash();
+             if (blobHash.has_value()) {
+               if (auto cached = DiffContext::getCachedGitIgnore(*blobHash)) {
+                 return *cached;
+               }
+             }
+             return fileInode->readAll(context->getFetchContext())
+                 .thenValue([blobHash = std::move(blobHash)](
+                                std::string&& ignoreFileContents) {
+                   auto ignore = std::make_shared<GitIgnore>();
+                   ignore->loadFile(ignoreFileContents);
+                   if (blobHash.has_value()) {
+                     DiffContext::putCachedGitIgnore(*blobHash, ignore);
+                   }
+                   return GitIgnore{*ignore};
+                 });
            }
          })
       .thenTry([self = inodePtrFromThis(),
@@ -2542,21 +2660,20 @@ ImmediateFuture<Unit> TreeInode::loadGitIgnoreThenDiff(
                 currentPath = RelativePath{currentPath}, // deep copy
                 trees = std::move(trees),
                 parentIgnore,
-                isIgnored](
-                   folly::Try<std::string> ignoreFileContentsTry) mutable {
-        std::string ignoreFileContents;
-        if (ignoreFileContentsTry.hasException()) {
+                isIgnored](folly::Try<GitIgnore> ignoreTry) mutable {
+        GitIgnore ignore;
+        if (ignoreTry.hasException()) {
           XLOG(WARN) << "error reading ignore file: "
-                     << folly::exceptionStr(ignoreFileContentsTry.exception());
+                     << folly::exceptionStr(ignoreTry.exception());
         } else {
-          ignoreFileContents = std::move(ignoreFileContentsTry).value();
+          ignore = std::move(ignoreTry).value();
         }
         return self->computeDiff(
             self->contents_.wlock(),
             context,
             currentPath,
             std::move(trees),
-            make_unique<GitIgnoreStack>(parentIgnore, ignoreFileContents),
+            make_unique<GitIgnoreStack>(parentIgnore, std::move(ignore)),
             isIgnored);
       });
 }
@@ -2992,7 +3109,14 @@ Future<Unit> TreeInode::checkout(
              << " --> "
              << (toTree ? toTree->getHash().toLogString() : "<none>");
 
-  vector<unique_ptr<CheckoutAction>> actions;
+  // A stop-on-first-conflict dry run prunes entire subtrees once a conflict
+  // has been recorded; nothing has been modified in a dry run, so there is
+  // no state to unwind.
+  if (ctx->shouldStopEarly()) {
+    return folly::makeFuture();
+  }
+
+  auto actions = std::make_shared<vector<unique_ptr<CheckoutAction>>>();
   vector<IncompleteInodeLoad> pendingLoads;
   bool wasDirectoryListModified = false;
 
@@ -3000,7 +3124,7 @@ Future<Unit> TreeInode::checkout(
       ctx,
       fromTree.get(),
       toTree.get(),
-      actions,
+      *actions,
       pendingLoads,
       wasDirectoryListModified);
 
@@ -3009,10 +3133,32 @@ Future<Unit> TreeInode::checkout(
     load.finish();
   }
 
-  // Now start all of the checkout actions
+  // Now start all of the checkout actions. Actions for different entries are
+  // independent, and an action for a modified subtree runs the entire
+  // recursive checkout of that subtree, so starting them inline runs a
+  // large checkout mostly on one core. Dispatch them to the server thread
+  // pool in a bounded window instead; every directory applies its own
+  // window, and the fixed-size pool bounds the total parallelism.
   vector<Future<InvalidationRequired>> actionFutures;
-  for (const auto& action : actions) {
-    actionFutures.emplace_back(action->run(ctx, &getObjectStore()));
+  auto concurrency = getMount()
+                         ->getServerState()
+                         ->getHotConfigSettings()
+                         .checkoutActionConcurrency;
+  if (concurrency == 0 || actions->size() <= 1) {
+    for (const auto& action : *actions) {
+      actionFutures.emplace_back(action->run(ctx, &getObjectStore()));
+    }
+  } else {
+    auto* objectStore = &getObjectStore();
+    auto* pool = getMount()->getServerThreadPool().get();
+    actionFutures = folly::window(
+        actions->size(),
+        [actions, ctx, objectStore, pool](size_t i) {
+          return folly::via(pool, [actions, ctx, objectStore, i] {
+            return (*actions)[i]->run(ctx, objectStore);
+          });
+        },
+        concurrency);
   }
 
   folly::SemiFuture<Unit> faultFuture =
@@ -3045,7 +3191,9 @@ Future<Unit> TreeInode::checkout(
               }
               ++numErrors;
               ctx->addError(
-                  self.get(), actions[n]->getEntryName(), result.exception());
+                  self.get(),
+                  (*actions)[n]->getEntryName(),
+                  result.exception());
             }
 
             auto invalidation = ImmediateFuture<folly::Unit>{folly::unit};
@@ -3174,6 +3322,12 @@ void TreeInode::computeCheckoutActions(
   // Note that we completely ignore entries in our current contents_ that don't
   // appear in either fromTree or toTree.  These are untracked in both the old
   // and new trees.
+  //
+  // Kernel invalidations for entries without a loaded inode are not issued
+  // during the walk: processCheckoutEntry() collects them into
+  // deferredInvalidations so they can be issued as one per-directory batch
+  // below.
+  std::vector<DeferredEntryInvalidation> deferredInvalidations;
   Tree::container emptyEntries{
       getMount()->getCheckoutConfig()->getCaseSensitive()};
   auto oldIter = fromTree ? fromTree->cbegin() : emptyEntries.cbegin();
@@ -3183,6 +3337,12 @@ void TreeInode::computeCheckoutActions(
   while (true) {
     unique_ptr<CheckoutAction> action;
 
+    // In a stop-on-first-conflict dry run, stop scanning this directory as
+    // soon as any walker has recorded a conflict.
+    if (ctx->shouldStopEarly()) {
+      break;
+    }
+
     if (oldIter == oldEnd) {
       if (newIter == newEnd) {
         // All Done
@@ -3196,7 +3356,8 @@ void TreeInode::computeCheckoutActions(
           nullptr,
           &*newIter,
           pendingLoads,
-          wasDirectoryListModified);
+          wasDirectoryListModified,
+          deferredInvalidations);
       ++newIter;
     } else if (newIter == newEnd) {
       // This entry is present in the old tree but not the old one.
@@ -3206,7 +3367,8 @@ void TreeInode::computeCheckoutActions(
           &*oldIter,
           nullptr,
           pendingLoads,
-          wasDirectoryListModified);
+          wasDirectoryListModified,
+          deferredInvalidations);
       ++oldIter;
     } else {
       auto compare = comparePathPiece(
@@ -3221,7 +3383,8 @@ void TreeInode::computeCheckoutActions(
             &*oldIter,
             nullptr,
             pendingLoads,
-            wasDirectoryListModified);
+            wasDirectoryListModified,
+            deferredInvalidations);
         ++oldIter;
       } else if (compare == CompareResult::AFTER) {
         action = processCheckoutEntry(
@@ -3230,7 +3393,8 @@ void TreeInode::computeCheckoutActions(
             nullptr,
             &*newIter,
             pendingLoads,
-            wasDirectoryListModified);
+            wasDirectoryListModified,
+            deferredInvalidations);
         ++newIter;
       } else {
         action = processCheckoutEntry(
@@ -3239,7 +3403,8 @@ void TreeInode::computeCheckoutActions(
             &*oldIter,
             &*newIter,
             pendingLoads,
-            wasDirectoryListModified);
+            wasDirectoryListModified,
+            deferredInvalidations);
         ++oldIter;
         ++newIter;
       }
@@ -3249,15 +3414,81 @@ void TreeInode::computeCheckoutActions(
       actions.push_back(std::move(action));
     }
   }
+
+  if (!deferredInvalidations.empty()) {
+    // Issue the whole directory's invalidation batch (with its completion
+    // barrier), then apply the corresponding contents updates in order.
+    issueDeferredEntryInvalidations(*contents, deferredInvalidations);
+    for (auto& deferred : deferredInvalidations) {
+      auto action = applyDeferredEntryInvalidation(
+          ctx, *contents, deferred, pendingLoads, wasDirectoryListModified);
+      if (action) {
+        actions.push_back(std::move(action));
+      }
+    }
+  }
+}
+
+void TreeInode::issueDeferredEntryInvalidations(
+    TreeInodeState& state,
+    std::vector<DeferredEntryInvalidation>& deferredInvalidations) {
+#ifdef _WIN32
+  if (deferredInvalidations.size() > 1 && getMount()->getPrjfsChannel()) {
+    // Each invalidation is a blocking PrjDeleteFile call, so issuing a large
+    // directory's worth serially dominates checkout time. Fan the batch out
+    // across the dedicated invalidation pool; the pool only ever runs
+    // invalidation work, so blocking this thread on it cannot deadlock, and
+    // the serial loop this replaces blocked for the same syscalls anyway.
+    auto* pool = getMount()->getInvalidationThreadPool().get();
+    std::vector<folly::Future<folly::Unit>> futures;
+    futures.reserve(deferredInvalidations.size());
+    for (auto& deferred : deferredInvalidations) {
+      futures.push_back(folly::via(pool, [this, &deferred] {
+        deferred.result = sendChannelEntryInvalidation(deferred.name);
+      }));
+    }
+    // Completion barrier: every invalidation in the batch has finished
+    // before any result is inspected or any contents update is applied.
+    folly::collectAll(std::move(futures)).wait();
+
+    // The fs refcount half of invalidateChannelEntryCache() must run on this
+    // thread, while the contents_ lock is still held; see the ordering
+    // comment in that function.
+    auto& inodeMap = *getInodeMap();
+    for (auto& deferred : deferredInvalidations) {
+      if (deferred.result.hasValue() && deferred.ino &&
+          inodeMap.isInodeLoadedOrRemembered(*deferred.ino)) {
+        inodeMap.decFsRefcount(*deferred.ino);
+      }
+    }
+    return;
+  }
+#endif
+
+  // On FUSE, invalidations are queued to the FuseChannel's invalidation
+  // thread, and on NFS they are a no-op, so issuing them inline is cheap.
+  for (auto& deferred : deferredInvalidations) {
+    deferred.result =
+        invalidateChannelEntryCache(state, deferred.name, deferred.ino);
+  }
 }
 
+namespace {
+// If true, preserve inode numbers for files that have been accessed and
+// still remain when a tree transitions from A -> B.  This is really expensive
+// because it means we must load TreeInodes for all trees that have ever
+// allocated inode numbers.
+constexpr bool kPreciseInodeNumberMemory = false;
+} // namespace
+
 unique_ptr<CheckoutAction> TreeInode::processCheckoutEntry(
     CheckoutContext* ctx,
     TreeInodeState& state,
     const Tree::value_type* oldScmEntry,
     const Tree::value_type* newScmEntry,
     vector<IncompleteInodeLoad>& pendingLoads,
-    bool& wasDirectoryListModified) {
+    bool& wasDirectoryListModified,
+    vector<DeferredEntryInvalidation>& deferredInvalidations) {
   XLOG(DBG5) << "processCheckoutEntry(" << getLogPath() << "): "
              << (oldScmEntry
                      ? oldScmEntry->second.toLogString(oldScmEntry->first)
@@ -3323,31 +3554,16 @@ unique_ptr<CheckoutAction> TreeInode::processCheckoutEntry(
       // do want to invalidate the kernel's dcache and inode caches.
       wasDirectoryListModified = true;
 
-      auto success = invalidateChannelEntryCache(state, name, std::nullopt);
-      if (success.hasValue()) {
-        auto [it, inserted] = contents.emplace(
-            newScmEntry->first,
-            modeFromTreeEntryType(newScmEntry->second.getType()),
-            getOverlay()->allocateInodeNumber(),
-            newScmEntry->second.getHash());
-        XDCHECK(inserted);
-      } else {
-        if (folly::kIsWindows) {
-          if (auto* exc = success.tryGetExceptionObject<std::system_error>();
-              exc && isEnotempty(*exc)) {
-            XLOG(DBG6)
-                << "entry was created on disk while checkout is in progress: "
-                << getLogPath() << "/" << name;
-            if (oldScmEntry) {
-              ctx->addConflict(ConflictType::MODIFIED_MODIFIED, this, name);
-            } else {
-              ctx->addConflict(ConflictType::UNTRACKED_ADDED, this, name);
-            }
-            return nullptr;
-          }
-        }
-        ctx->addError(this, name, success.exception());
-      }
+      // Defer the invalidation so the whole directory's batch can be issued
+      // at once; the entry is added in applyDeferredEntryInvalidation() once
+      // the invalidation has succeeded.
+      deferredInvalidations.push_back(DeferredEntryInvalidation{
+          DeferredEntryInvalidation::Kind::AddEntry,
+          PathComponent{name},
+          std::nullopt,
+          oldScmEntry,
+          newScmEntry,
+          folly::Try<folly::Unit>{}});
     }
 
     // Nothing else to do when there is no local inode.
@@ -3361,12 +3577,6 @@ unique_ptr<CheckoutAction> TreeInode::processCheckoutEntry(
         ctx, oldScmEntry, newScmEntry, std::move(childPtr));
   }
 
-  // If true, preserve inode numbers for files that have been accessed and
-  // still remain when a tree transitions from A -> B.  This is really expensive
-  // because it means we must load TreeInodes for all trees that have ever
-  // allocated inode numbers.
-  constexpr bool kPreciseInodeNumberMemory = false;
-
   // If a load for this entry is in progress, then we have to wait for the
   // load to finish.  Loading the inode ourself will wait for the existing
   // attempt to finish.
@@ -3444,12 +3654,66 @@ unique_ptr<CheckoutAction> TreeInode::processCheckoutEntry(
     return nullptr;
   }
 
-  auto oldEntryInodeNumber = entry.getInodeNumber();
+  // We are removing or replacing an entry - it must be invalidated before
+  // the contents are updated. Defer the invalidation so the whole
+  // directory's batch can be issued at once; the contents update happens in
+  // applyDeferredEntryInvalidation() once the result is known.
+  deferredInvalidations.push_back(DeferredEntryInvalidation{
+      DeferredEntryInvalidation::Kind::ReplaceEntry,
+      PathComponent{name},
+      entry.getInodeNumber(),
+      oldScmEntry,
+      newScmEntry,
+      folly::Try<folly::Unit>{}});
+  return nullptr;
+}
+
+unique_ptr<CheckoutAction> TreeInode::applyDeferredEntryInvalidation(
+    CheckoutContext* ctx,
+    TreeInodeState& state,
+    DeferredEntryInvalidation& deferred,
+    vector<IncompleteInodeLoad>& pendingLoads,
+    bool& wasDirectoryListModified) {
+  auto& contents = state.entries;
+  const auto& name = deferred.name;
+
+  if (deferred.kind == DeferredEntryInvalidation::Kind::AddEntry) {
+    if (deferred.result.hasValue()) {
+      auto [it, inserted] = contents.emplace(
+          deferred.newScmEntry->first,
+          modeFromTreeEntryType(deferred.newScmEntry->second.getType()),
+          getOverlay()->allocateInodeNumber(),
+          deferred.newScmEntry->second.getHash());
+      XDCHECK(inserted);
+    } else {
+      if (folly::kIsWindows) {
+        if (auto* exc =
+                deferred.result.tryGetExceptionObject<std::system_error>();
+            exc && isEnotempty(*exc)) {
+          XLOG(DBG6)
+              << "entry was created on disk while checkout is in progress: "
+              << getLogPath() << "/" << name;
+          if (deferred.oldScmEntry) {
+            ctx->addConflict(ConflictType::MODIFIED_MODIFIED, this, name);
+          } else {
+            ctx->addConflict(ConflictType::UNTRACKED_ADDED, this, name);
+          }
+          return nullptr;
+        }
+      }
+      ctx->addError(this, name, deferred.result.exception());
+    }
+    return nullptr;
+  }
+
+  // ReplaceEntry: the entry was present and unloaded when the invalidation
+  // was deferred; names are only deferred once per directory, so it must
+  // still be here.
+  auto it = contents.find(name);
+  XCHECK(it != contents.end());
+  auto& entry = it->second;
 
-  // We are removing or replacing an entry - attempt to invalidate it while the
-  // write lock is held and before the contents are updated.
-  auto success = invalidateChannelEntryCache(state, name, oldEntryInodeNumber);
-  if (success.hasException()) {
+  if (deferred.result.hasException()) {
     if (folly::kIsWindows) {
       // On Windows, reads aren't being done on the inodes, but on the Trees
       // directly, when a file/directory is looked up, the dispatcher will
@@ -3462,32 +3726,39 @@ unique_ptr<CheckoutAction> TreeInode::processCheckoutEntry(
       // loading inodes. In that case, the invalidateChannelEntryCache will
       // fail with an ENOTEMPTY error. Let's catch this and recurse down as if
       // the directory was already loaded.
-      if (auto* exc = success.tryGetExceptionObject<std::system_error>();
+      if (auto* exc =
+              deferred.result.tryGetExceptionObject<std::system_error>();
           exc && isEnotempty(*exc)) {
         XLOG(DBG6) << "loading child inode after invalidation failed: inode="
                    << getNodeId() << " child=" << name;
         auto inodeFuture = loadChildLocked(
             contents, name, entry, pendingLoads, ctx->getFetchContext());
         return make_unique<CheckoutAction>(
-            ctx, oldScmEntry, newScmEntry, std::move(inodeFuture));
+            ctx,
+            deferred.oldScmEntry,
+            deferred.newScmEntry,
+            std::move(inodeFuture));
       }
     }
-    ctx->addError(this, name, success.exception());
+    ctx->addError(this, name, deferred.result.exception());
     return nullptr;
   }
 
+  auto oldEntryInodeNumber = *deferred.ino;
+  bool wasDirectory = entry.isDirectory();
+
   // TODO: remove entry.getInodeNumber() from both the overlay and the
   // InodeTable.  Or at least verify that it's already done in a test.
   //
   // This logic could potentially be unified with TreeInode::tryRemoveChild
   // and TreeInode::checkoutUpdateEntry.
   contents.erase(it);
-  if (newScmEntry) {
+  if (deferred.newScmEntry) {
     contents.emplace(
-        newScmEntry->first,
-        modeFromTreeEntryType(newScmEntry->second.getType()),
+        deferred.newScmEntry->first,
+        modeFromTreeEntryType(deferred.newScmEntry->second.getType()),
         getOverlay()->allocateInodeNumber(),
-        newScmEntry->second.getHash());
+        deferred.newScmEntry->second.getHash());
   }
 
   wasDirectoryListModified = true;
@@ -3498,7 +3769,7 @@ unique_ptr<CheckoutAction> TreeInode::processCheckoutEntry(
   // filesystem, it's as if the entire subtree got deleted and checked out
   // from scratch.  (Note: if anything uses Watchman and cares precisely about
   // inode numbers, it could miss changes.)
-  if (!kPreciseInodeNumberMemory && entry.isDirectory()) {
+  if (!kPreciseInodeNumberMemory && wasDirectory) {
     XLOG(DBG5) << "recursively removing overlay data for "
                << oldEntryInodeNumber << "(" << getLogPath() << " / " << name
                << ")";
@@ -3768,10 +4039,8 @@ bool needDecFsRefcount(InodeMap& inodeMap, InodeNumber ino) {
 } // namespace
 #endif
 
-folly::Try<folly::Unit> TreeInode::invalidateChannelEntryCache(
-    TreeInodeState&,
-    PathComponentPiece name,
-    FOLLY_MAYBE_UNUSED std::optional<InodeNumber> ino) {
+folly::Try<folly::Unit> TreeInode::sendChannelEntryInvalidation(
+    PathComponentPiece name) {
 #ifndef _WIN32
   if (auto* fuseChannel = getMount()->getFuseChannel()) {
     fuseChannel->invalidateEntry(getNodeId(), name);
@@ -3782,26 +4051,10 @@ folly::Try<folly::Unit> TreeInode::invalidateChannelEntryCache(
   if (auto* fsChannel = getMount()->getPrjfsChannel()) {
     const auto path = getPath();
     if (path.has_value()) {
-      // Try to remove the file first, and then call decFsRefcount if needed.
-      // When no inode number is passed in, we still need to invalidate the
-      // ProjectedFS file, as tombstones are a special kind of placeholder
-      // that EdenFS doesn't have inodes for.
-      auto ret = fsChannel->removeCachedFile(path.value() + name);
-      if (ret.hasValue()) {
-        auto& inodeMap = *getInodeMap();
-        if (ino && needDecFsRefcount(inodeMap, *ino)) {
-          // At this point, the file is now virtual, that is no placeholder or
-          // full file are present on disk. If at this point, the file is being
-          // looked up, EdenFS will service the lookup in
-          // PrjfsDispatcherImpl::lookup, and then try to increment the
-          // refcount. The refcount increment is guarantee to happen after the
-          // decrement below due to the increment needing to traverse the inode
-          // hierarchy and thus acquiring the content lock. The same content
-          // lock that is held in this function.
-          getInodeMap()->decFsRefcount(*ino);
-        }
-      }
-      return ret;
+      // We still need to invalidate the ProjectedFS file even when the
+      // caller has no inode number for it, as tombstones are a special kind
+      // of placeholder that EdenFS doesn't have inodes for.
+      return fsChannel->removeCachedFile(path.value() + name);
     }
   }
 #endif
@@ -3809,6 +4062,30 @@ folly::Try<folly::Unit> TreeInode::invalidateChannelEntryCache(
   return folly::Try<folly::Unit>{folly::unit};
 }
 
+folly::Try<folly::Unit> TreeInode::invalidateChannelEntryCache(
+    TreeInodeState&,
+    PathComponentPiece name,
+    FOLLY_MAYBE_UNUSED std::optional<InodeNumber> ino) {
+  auto ret = sendChannelEntryInvalidation(name);
+#ifdef _WIN32
+  if (ret.hasValue() && ino) {
+    auto& inodeMap = *getInodeMap();
+    if (needDecFsRefcount(inodeMap, *ino)) {
+      // At this point, the file is now virtual, that is no placeholder or
+      // full file are present on disk. If at this point, the file is being
+      // looked up, EdenFS will service the lookup in
+      // PrjfsDispatcherImpl::lookup, and then try to increment the
+      // refcount. The refcount increment is guarantee to happen after the
+      // decrement below due to the increment needing to traverse the inode
+      // hierarchy and thus acquiring the content lock. The same content
+      // lock that is held in this function.
+      inodeMap.decFsRefcount(*ino);
+    }
+  }
+#endif
+  return ret;
+}
+
 ImmediateFuture<folly::Unit> TreeInode::invalidateChannelDirCache(
     TreeInodeState& state) {
 #ifndef _WIN32
@@ -3964,6 +4241,7 @@ void TreeInode::saveOverlayPostCheckout(
 
     // Update the overlay to include the new entries, even if dematerialized.
     saveOverlayDir(contents->entries);
+    contents->overlayDirPersisted = true;
   }
 
   if (stateChanged) {
@@ -4229,6 +4507,219 @@ ImmediateFuture<uint64_t> TreeInode::invalidateChildrenNotMaterialized(
       });
 }
 
+#ifndef _WIN32
+namespace {
+/**
+ * Compute the SHA-1 of an overlay file's contents, skipping the overlay
+ * header. Returns std::nullopt if the overlay file cannot be read.
+ */
+std::optional<Hash20> computeOverlayFileSha1(
+    Overlay* overlay,
+    InodeNumber number) {
+  std::optional<OverlayFile> file;
+  try {
+    file = overlay->openFileNoVerify(number);
+  } catch (const std::exception& ex) {
+    XLOG(WARN) << "unable to open overlay file for inode " << number << ": "
+               << folly::exceptionStr(ex);
+    return std::nullopt;
+  }
+
+  SHA_CTX ctx;
+  SHA1_Init(&ctx);
+  off_t off = FileContentStore::kHeaderLength;
+  while (true) {
+    uint8_t buf[8192];
+    auto ret = file->preadNoInt(&buf, sizeof(buf), off);
+    if (ret.hasError()) {
+      XLOG(WARN) << "error reading overlay file for inode " << number << ": "
+                 << folly::errnoStr(ret.error());
+      return std::nullopt;
+    }
+    auto len = ret.value();
+    if (len == 0) {
+      break;
+    }
+    SHA1_Update(&ctx, buf, len);
+    off += len;
+  }
+
+  static_assert(Hash20::RAW_SIZE == SHA_DIGEST_LENGTH);
+  Hash20 sha1;
+  SHA1_Final(sha1.mutableBytes().begin(), &ctx);
+  return sha1;
+}
+
+struct DematerializeCandidate {
+  PathComponent name;
+  InodeNumber number;
+  ObjectId scmHash;
+};
+} // namespace
+
+ImmediateFuture<uint64_t> TreeInode::dematerializeUnmodifiedChildren(
+    std::shared_ptr<const Tree> scmTree,
+    std::shared_ptr<std::atomic<int64_t>> budget,
+    const ObjectFetchContextPtr& context) {
+  if (budget->load(std::memory_order_relaxed) <= 0) {
+    return uint64_t{0};
+  }
+
+  std::vector<DematerializeCandidate> candidates;
+  std::vector<std::pair<PathComponent, ObjectId>> subdirectories;
+  {
+    auto contents = contents_.rlock();
+    if (!contents->isMaterialized()) {
+      // A non-materialized directory cannot have materialized descendants.
+      return uint64_t{0};
+    }
+    for (auto& entry : contents->entries) {
+      auto scmIter = scmTree->find(entry.first);
+      if (scmIter == scmTree->cend()) {
+        // The entry does not exist in the current commit, so there is no
+        // source control object to dematerialize it against.
+        continue;
+      }
+
+      if (entry.second.isDirectory()) {
+        if (entry.second.isMaterialized() && scmIter->second.isTree()) {
+          subdirectories.emplace_back(entry.first, scmIter->second.getHash());
+        }
+        continue;
+      }
+
+      if (!entry.second.isMaterialized() || entry.second.getInode()) {
+        // Only unloaded entries are eligible: a loaded FileInode tracks its
+        // own materialization state and may have writes in flight.
+        continue;
+      }
+
+      // Only regular files can be compared against a blob by SHA-1, and the
+      // file type recorded in the entry must match the source control entry.
+      // (The mode itself lives in the inode metadata table, which is keyed by
+      // inode number and survives dematerialization, so a chmod does not
+      // prevent reclaiming the file contents.)
+      auto mode = entry.second.getInitialMode();
+      auto expectedType = (mode & S_IXUSR) ? TreeEntryType::EXECUTABLE_FILE
+                                           : TreeEntryType::REGULAR_FILE;
+      if (!S_ISREG(mode) || scmIter->second.getType() != expectedType) {
+        continue;
+      }
+
+      candidates.emplace_back(DematerializeCandidate{
+          PathComponent{entry.first},
+          entry.second.getInodeNumber(),
+          scmIter->second.getHash()});
+    }
+  }
+
+  std::vector<ImmediateFuture<uint64_t>> futures;
+  for (auto& subdirectory : subdirectories) {
+    futures.push_back(
+        collectAllSafe(
+            getOrLoadChildTree(subdirectory.first, context),
+            getObjectStore().getTree(subdirectory.second, context))
+            .thenValue(
+                [budget, context = context.copy()](
+                    std::tuple<TreeInodePtr, std::shared_ptr<const Tree>>
+                        result) {
+                  auto& [child, childScmTree] = result;
+                  return child->dematerializeUnmodifiedChildren(
+                      std::move(childScmTree), budget, context);
+                }));
+  }
+
+  if (!candidates.empty()) {
+    std::vector<ImmediateFuture<Hash20>> blobSha1Futures;
+    blobSha1Futures.reserve(candidates.size());
+    for (auto& candidate : candidates) {
+      blobSha1Futures.push_back(
+          getObjectStore().getBlobSha1(candidate.scmHash, context));
+    }
+
+    futures.push_back(
+        collectAll(std::move(blobSha1Futures))
+            .thenValue([self = inodePtrFromThis(),
+                        candidates = std::move(candidates),
+                        budget](std::vector<folly::Try<Hash20>> blobSha1s) {
+              uint64_t numDematerialized = 0;
+              std::vector<InodeNumber> overlayFilesToRemove;
+              auto* overlay = self->getOverlay();
+              {
+                auto contents = self->contents_.wlock();
+                for (size_t i = 0; i < candidates.size(); ++i) {
+                  if (budget->load(std::memory_order_relaxed) <= 0) {
+                    break;
+                  }
+                  if (blobSha1s[i].hasException()) {
+                    continue;
+                  }
+
+                  auto iter = contents->entries.find(candidates[i].name);
+                  if (iter == contents->entries.end()) {
+                    continue;
+                  }
+                  auto& dirEntry = iter->second;
+                  // Re-verify under the lock: the entry may have been
+                  // loaded, replaced, or modified since it was scanned.
+                  // Loading a child requires this lock, and the overlay
+                  // SHA-1 is computed below while it is held, so a
+                  // concurrent write cannot slip in between the comparison
+                  // and the flip.
+                  if (!dirEntry.isMaterialized() || dirEntry.getInode() ||
+                      dirEntry.getInodeNumber() != candidates[i].number) {
+                    continue;
+                  }
+
+                  auto overlaySha1 =
+                      computeOverlayFileSha1(overlay, candidates[i].number);
+                  if (!overlaySha1 || *overlaySha1 != blobSha1s[i].value()) {
+                    continue;
+                  }
+
+                  dirEntry.setDematerialized(candidates[i].scmHash);
+                  overlayFilesToRemove.push_back(candidates[i].number);
+                  budget->fetch_sub(1, std::memory_order_relaxed);
+                  ++numDematerialized;
+                }
+
+                if (numDematerialized > 0) {
+                  self->saveOverlayDir(contents->entries);
+                }
+              }
+
+              // Remove the overlay files only after the updated directory
+              // has been written, so a crash in between leaks an
+              // unreferenced overlay file rather than losing an entry's
+              // contents.
+              auto* fileAccess = self->getMount()->getOverlayFileAccess();
+              for (auto number : overlayFilesToRemove) {
+                fileAccess->forget(number);
+                try {
+                  overlay->removeOverlayFile(number);
+                } catch (const std::exception& ex) {
+                  XLOG(WARN) << "unable to remove overlay file for "
+                             << "dematerialized inode " << number << ": "
+                             << folly::exceptionStr(ex);
+                }
+              }
+              return numDematerialized;
+            }));
+  }
+
+  return collectAll(std::move(futures))
+      .thenValue([](std::vector<folly::Try<uint64_t>> counts) {
+        uint64_t numDematerialized = 0;
+        for (auto& count : counts) {
+          if (count.hasValue()) {
+            numDematerialized += count.value();
+          }
+        }
+        return numDematerialized;
+      });
+}
+#endif // !_WIN32
+
 void TreeInode::updateAtime() {
   auto lock = contents_.wlock();
   InodeBaseMetadata::updateAtimeLocked(lock->entries);
@@ -4376,8 +4867,7 @@ void TreeInode::prefetch(const ObjectFetchContextPtr& context) {
   // prefetch to the punch and cause a full blob fetch.
   // So when metadata prefetching is turned on we can
   // just skip this.
-  auto config = getMount()->getServerState()->getEdenConfig();
-  if (config->useAuxMetadata.getValue()) {
+  if (getMount()->getServerState()->getHotConfigSettings().useAuxMetadata) {
     XLOG(DBG4) << "skipping prefetch for " << getLogPath()
                << ": metadata prefetching is turned on in the backing store";
     return;
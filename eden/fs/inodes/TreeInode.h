@@ -9,6 +9,7 @@
 #include <folly/File.h>
 #include <folly/Portability.h>
 #include <folly/Synchronized.h>
+#include <atomic>
 #include <optional>
 #include "eden/fs/fuse/Invalidation.h"
 #include "eden/fs/inodes/CheckoutAction.h"
@@ -64,6 +65,19 @@ struct TreeInodeState {
    * treeHash will be none.
    */
   std::optional<ObjectId> treeHash;
+
+  /**
+   * True once this directory's entries (and their freshly allocated inode
+   * numbers) have been written to the overlay.
+   *
+   * Directories built from a source control Tree defer that write when
+   * overlay:defer-unmaterialized-dir-save is set; enumeration-only access
+   * then never touches the overlay. The entries are persisted on demand by
+   * InodeMap::updateOverlayForUnload when the inode must be remembered
+   * across an unload, and by the normal materialization paths, which always
+   * save. Directories loaded from the overlay start out persisted.
+   */
+  bool overlayDirPersisted = true;
 };
 
 /**
@@ -453,6 +467,30 @@ class TreeInode final : public InodeBaseMetadata<DirContents> {
   ImmediateFuture<uint64_t> invalidateChildrenNotMaterialized(
       const ObjectFetchContextPtr& context);
 
+#ifndef _WIN32
+  /**
+   * Dematerialize unloaded file children whose overlay contents are identical
+   * to the corresponding file in the given source control Tree, recursing
+   * into materialized descendant directories.
+   *
+   * scmTree is the source control Tree at this directory's path in the
+   * currently checked out commit. Only file entries that are materialized and
+   * have no loaded inode are considered: each one's overlay contents are
+   * compared by SHA-1 against the source control blob, and on a match the
+   * entry is flipped back to the blob's ID and its overlay file is removed.
+   * Directories themselves are left materialized; the next checkout
+   * dematerializes them through the usual saveOverlayPostCheckout path.
+   *
+   * budget is decremented once per dematerialized file; the walk stops
+   * descending when it reaches zero. Returns the number of files
+   * dematerialized in this subtree.
+   */
+  ImmediateFuture<uint64_t> dematerializeUnmodifiedChildren(
+      std::shared_ptr<const Tree> scmTree,
+      std::shared_ptr<std::atomic<int64_t>> budget,
+      const ObjectFetchContextPtr& context);
+#endif
+
   /*
    * Update a tree entry as part of a checkout operation.
    *
@@ -570,11 +608,12 @@ class TreeInode final : public InodeBaseMetadata<DirContents> {
       const;
 
   /**
-   * Converts a Tree to a Dir and saves it to the Overlay under the given inode
-   * number.
+   * Persist entries just built from a Tree to the Overlay, or mark them
+   * deferred when overlay:defer-unmaterialized-dir-save is set; see
+   * TreeInodeState::overlayDirPersisted. Called from the constructors that
+   * take a Tree, before the inode is visible to anyone else.
    */
-  static DirContents
-  saveDirFromTree(InodeNumber inodeNumber, const Tree* tree, EdenMount* mount);
+  void persistTreeBackedDir();
 
   /** Translates a Tree object from our store into a Dir object
    * used to track the directory in the inode */
@@ -755,10 +794,39 @@ class TreeInode final : public InodeBaseMetadata<DirContents> {
       std::vector<std::unique_ptr<CheckoutAction>>& actions,
       std::vector<IncompleteInodeLoad>& pendingLoads,
       bool& wasDirectoryListModified);
+
+  /**
+   * A kernel cache invalidation that processCheckoutEntry() deferred so that
+   * computeCheckoutActions() can issue an entire directory's worth of
+   * invalidations as one batch. The corresponding contents_ update is only
+   * performed once the invalidation result is known, when the record is
+   * passed to applyDeferredEntryInvalidation().
+   */
+  struct DeferredEntryInvalidation {
+    enum class Kind {
+      /** No local inode exists for this name; add the new entry on success. */
+      AddEntry,
+      /** An unloaded, unmodified entry is being replaced or removed. */
+      ReplaceEntry,
+    };
+    Kind kind;
+    PathComponent name;
+    /** The entry's inode number for ReplaceEntry; unset for AddEntry. */
+    std::optional<InodeNumber> ino;
+    const Tree::value_type* oldScmEntry;
+    const Tree::value_type* newScmEntry;
+    /** Filled in by issueDeferredEntryInvalidations(). */
+    folly::Try<folly::Unit> result;
+  };
+
   /**
    * Sets wasDirectoryListModified true if this checkout entry operation has
    * modified the directory contents, which implies the return value is nullptr.
    *
+   * Entry invalidations that the kernel must be told about are not issued
+   * here: they are appended to deferredInvalidations so the caller can issue
+   * the whole directory's batch at once.
+   *
    * This function could return a std::variant of InvalidationRequired and
    * std::unique_ptr<CheckoutAction> instead of setting a boolean.
    */
@@ -768,6 +836,35 @@ class TreeInode final : public InodeBaseMetadata<DirContents> {
       const Tree::value_type* oldScmEntry,
       const Tree::value_type* newScmEntry,
       std::vector<IncompleteInodeLoad>& pendingLoads,
+      bool& wasDirectoryListModified,
+      std::vector<DeferredEntryInvalidation>& deferredInvalidations);
+
+  /**
+   * Issue the kernel invalidations for every record in the batch, filling in
+   * each record's result.
+   *
+   * On Windows each invalidation is a blocking PrjDeleteFile call, so the
+   * batch is fanned out across the mount's invalidation thread pool and this
+   * function acts as the completion barrier: it only returns once every
+   * invalidation in the batch has finished. The caller must hold the
+   * contents_ write lock, which also preserves the fs refcount ordering
+   * guarantee described in invalidateChannelEntryCache().
+   */
+  void issueDeferredEntryInvalidations(
+      TreeInodeState& state,
+      std::vector<DeferredEntryInvalidation>& deferredInvalidations);
+
+  /**
+   * Apply the contents_ update for one completed invalidation record:
+   * add/replace/remove the entry on success, or record a conflict or error.
+   * Returns a CheckoutAction when a failed invalidation requires loading the
+   * child to recurse into it (Windows ENOTEMPTY handling).
+   */
+  std::unique_ptr<CheckoutAction> applyDeferredEntryInvalidation(
+      CheckoutContext* ctx,
+      TreeInodeState& state,
+      DeferredEntryInvalidation& deferred,
+      std::vector<IncompleteInodeLoad>& pendingLoads,
       bool& wasDirectoryListModified);
   void saveOverlayPostCheckout(CheckoutContext* ctx, const Tree* tree);
 
@@ -807,6 +904,15 @@ class TreeInode final : public InodeBaseMetadata<DirContents> {
       PathComponentPiece name,
       std::optional<InodeNumber> ino);
 
+  /**
+   * The channel half of invalidateChannelEntryCache(): queue or perform the
+   * kernel invalidation for the given entry name without touching the
+   * InodeMap. Safe to call from the invalidation thread pool while the
+   * caller holds the contents_ lock.
+   */
+  FOLLY_NODISCARD folly::Try<folly::Unit> sendChannelEntryInvalidation(
+      PathComponentPiece name);
+
   /**
    * Attempts to find the child inode or other identifying information about
    * the inode with out performing any write operations. `loadInodes` indicates
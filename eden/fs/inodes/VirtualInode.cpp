@@ -190,6 +190,22 @@ ImmediateFuture<BlobMetadata> VirtualInode::getBlobMetadata(
       variant_);
 }
 
+std::optional<ObjectId> VirtualInode::getBlobObjectId() const {
+  return std::visit(
+      [](auto&& arg) -> std::optional<ObjectId> {
+        using T = std::decay_t<decltype(arg)>;
+        if constexpr (
+            std::is_same_v<T, UnmaterializedUnloadedBlobDirEntry> ||
+            std::is_same_v<T, TreeEntry>) {
+          return arg.getHash();
+        } else {
+          // Loaded inodes serve their own metadata, and trees have none.
+          return std::nullopt;
+        }
+      },
+      variant_);
+}
+
 ImmediateFuture<EntryAttributes> VirtualInode::getEntryAttributes(
     EntryAttributeFlags requestedAttributes,
     RelativePathPiece path,
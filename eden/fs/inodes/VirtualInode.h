@@ -8,6 +8,7 @@
 #pragma once
 
 #include <sys/stat.h>
+#include <optional>
 #include <variant>
 
 #include <folly/String.h>
@@ -135,6 +136,15 @@ class VirtualInode {
       ObjectStore* objectStore,
       const ObjectFetchContextPtr& fetchContext) const;
 
+  /**
+   * Return the ObjectId of the blob backing this entry, or std::nullopt when
+   * the entry is a directory or is backed by a loaded inode.
+   *
+   * This is intended for callers that want to batch blob metadata fetches for
+   * several entries before stat'ing them individually.
+   */
+  std::optional<ObjectId> getBlobObjectId() const;
+
   /**
    * Emulate stat in a way that works for source control.
    *
@@ -10,9 +10,11 @@
 #include "eden/fs/inodes/fscatalog/FsInodeCatalog.h"
 
 #include <boost/filesystem.hpp>
+#include <fcntl.h>
 #include <algorithm>
 #include <chrono>
 
+#include <folly/Conv.h>
 #include <folly/Exception.h>
 #include <folly/File.h>
 #include <folly/FileUtil.h>
@@ -395,6 +397,40 @@ std::optional<overlay::OverlayDir> FileContentStore::deserializeOverlayDir(
   return CompactSerializer::deserialize<overlay::OverlayDir>(contents);
 }
 
+InodeNumber FileContentStore::scanForNextInodeNumber() {
+  uint64_t maxInode = kRootNodeId.get();
+
+  for (ShardID shardID = 0; shardID < kNumShards; ++shardID) {
+    std::array<char, kShardDirPathLength> subdirBuffer;
+    MutableStringPiece subdir{subdirBuffer.data(), subdirBuffer.size()};
+    formatSubdirShardPath(shardID, subdir);
+    auto path = localDir_ + PathComponentPiece{subdir};
+
+    boost::system::error_code error;
+    auto iterator = boost::filesystem::directory_iterator(
+        boost::filesystem::path{path.value().c_str()}, error);
+    if (error.value() != 0) {
+      folly::throwSystemErrorExplicit(
+          error.value(),
+          "error reading overlay shard directory ",
+          path.view());
+    }
+
+    auto endIterator = boost::filesystem::directory_iterator();
+    for (; iterator != endIterator; ++iterator) {
+      auto entryInodeNumber =
+          folly::tryTo<uint64_t>(iterator->path().filename().string());
+      if (entryInodeNumber.hasValue()) {
+        maxInode = std::max(maxInode, *entryInodeNumber);
+      }
+      // Entries with unexpected names are left for a future full fsck run
+      // to report.
+    }
+  }
+
+  return InodeNumber{maxInode + 1};
+}
+
 std::array<uint8_t, FileContentStore::kHeaderLength>
 FileContentStore::createHeader(
     folly::StringPiece identifier,
@@ -463,6 +499,14 @@ using InodeTmpPath = std::array<
     char,
     tmpPrefix.size() + FileContentStore::kMaxDecimalInodeNumberLength + 1>;
 
+/**
+ * Size above which a new overlay file's full extent is preallocated before
+ * the contents are written, so the file system can lay large materialized
+ * files out contiguously rather than growing them one writeback chunk at a
+ * time.
+ */
+constexpr size_t kPreallocateThreshold = 1024 * 1024;
+
 InodeTmpPath getFileTmpPath(InodeNumber inodeNumber) {
   // It's substantially faster on XFS to create this temporary file in
   // an empty directory and then move it into its destination rather
@@ -515,6 +559,28 @@ folly::File FileContentStore::createOverlayFileImpl(
     }
   };
 
+#ifdef __linux__
+  size_t totalSize = 0;
+  for (size_t i = 0; i < iovCount; ++i) {
+    totalSize += iov[i].iov_len;
+  }
+  if (totalSize >= kPreallocateThreshold) {
+    // Don't use posix_fallocate, because glibc may try to emulate it with
+    // writes to each chunk, and we definitely don't want that.
+    // Preallocation is only a layout hint, so file systems that don't
+    // support fallocate are simply skipped.
+    auto rc = ::fallocate(tmpFD, 0, 0, totalSize);
+    if (rc == -1 && errno != EOPNOTSUPP && errno != ENOSYS) {
+      folly::checkUnixError(
+          rc,
+          "failed to preallocate overlay file for inode ",
+          inodeNumber,
+          " in ",
+          localDir_.view());
+    }
+  }
+#endif
+
   auto sizeWritten = folly::writevFull(tmpFD, iov, iovCount);
   folly::checkUnixError(
       sizeWritten,
@@ -76,6 +76,17 @@ class FileContentStore : public IFileContentStore {
    */
   struct statfs statFs() const override;
 
+  /**
+   * Recover the next inode number by enumerating the entry names in each
+   * shard directory, without opening or reading any of the overlay files.
+   *
+   * This is much cheaper than a full fsck scan after an unclean shutdown,
+   * but performs no validation or repair: corrupt directories are only
+   * detected when they are first deserialized, and orphaned inodes are left
+   * in place.
+   */
+  InodeNumber scanForNextInodeNumber();
+
   /**
    * Helper function that creates an overlay file for a new FileInode.
    */
@@ -13,6 +13,10 @@
 #include <fcntl.h>
 #include <folly/portability/Unistd.h>
 #include <time.h>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 #include <folly/Conv.h>
 #include <folly/ExceptionWrapper.h>
@@ -974,10 +978,25 @@ std::unique_ptr<OverlayChecker::Error> make_error(Args&&... args) {
   return std::make_unique<ErrorType>(std::forward<Args>(args)...);
 }
 
+namespace {
+/**
+ * Number of threads to use for the parallel portions of an fsck scan.
+ *
+ * The scan is mostly bound by small-file read latency, so use more threads
+ * than cores to keep requests in flight. hardware_concurrency() may return
+ * 0 if it cannot determine the core count; fall back to a fixed width of 4
+ * in that case, and cap the width so very large hosts don't swamp the disk
+ * with hundreds of concurrent reads.
+ */
+uint32_t fsckScanThreads() {
+  return std::min(32u, std::max(4u, 2 * std::thread::hardware_concurrency()));
+}
+} // namespace
+
 void OverlayChecker::readInodes(const ProgressCallback& progressCallback) {
   using namespace folly::gen;
 
-  auto threads = 4;
+  auto threads = fsckScanThreads();
   uint32_t progress10pct = 0;
 
   folly::Synchronized<std::vector<std::unique_ptr<Error>>> errors;
@@ -1180,39 +1199,81 @@ std::optional<OverlayChecker::InodeInfo> OverlayChecker::loadInodeInfo(
 }
 
 void OverlayChecker::linkInodeChildren() {
-  for (const auto& [parentInodeNumber, parent] : impl_->inodes) {
-    for (const auto& [childName, child] : *parent.children.entries_ref()) {
-      auto childRawInode = *child.inodeNumber_ref();
-      if (childRawInode == 0) {
-        // Older versions of edenfs would leave the inode number set to 0
-        // if the child inode has never been loaded.  The child can't be
-        // present in the overlay if it doesn't have an inode number
-        // allocated for it yet.
-        //
-        // Newer versions of edenfs always allocate an inode number for all
-        // children, even if they haven't been loaded yet.
-        continue;
-      }
+  using namespace folly::gen;
 
-      auto childInodeNumber = InodeNumber(childRawInode);
-      updateMaxInodeNumber(childInodeNumber);
-      auto childInfo = getInodeInfo(childInodeNumber);
-      if (!childInfo) {
-        const auto& hash = child.hash_ref();
-        if (!hash.has_value() || hash->empty()) {
-          // This child is materialized (since it doesn't have a hash
-          // linking it to a source control object).  It's a problem if the
-          // materialized data isn't actually present in the overlay.
-          addError<MissingMaterializedInode>(
-              parentInodeNumber, childName, child);
-        }
-      } else {
-        childInfo->addParent(parentInodeNumber, *child.mode_ref());
+  // Partition the linkage pass across threads by parent directory. The inode
+  // table itself is not modified here, so concurrent lookups are safe; the
+  // only mutable state is each child's parents list, which is guarded by a
+  // mutex stripe chosen from the child's inode number, and the running
+  // maximum inode number, which is folded into an atomic.
+  constexpr size_t kNumParentStripes = 64;
+  std::array<std::mutex, kNumParentStripes> parentStripes;
+  std::atomic<uint64_t> maxInodeNumber{kRootNodeId.get()};
+  folly::Synchronized<std::vector<std::unique_ptr<Error>>> errors;
 
-        // TODO: It would be nice to also check for mismatch between
-        // childInfo->type and child.mode
-      }
-    }
+  from(impl_->inodes) |
+      map([](const std::pair<const InodeNumber, InodeInfo>& entry) {
+        return &entry;
+      }) |
+      pmap(
+          [this, &parentStripes, &maxInodeNumber, &errors](
+              const std::pair<const InodeNumber, InodeInfo>* entry) -> bool {
+            const auto& parentInodeNumber = entry->first;
+            const auto& parent = entry->second;
+            uint64_t localMax = 0;
+            for (const auto& [childName, child] :
+                 *parent.children.entries_ref()) {
+              auto childRawInode = *child.inodeNumber_ref();
+              if (childRawInode == 0) {
+                // Older versions of edenfs would leave the inode number set
+                // to 0 if the child inode has never been loaded.  The child
+                // can't be present in the overlay if it doesn't have an
+                // inode number allocated for it yet.
+                //
+                // Newer versions of edenfs always allocate an inode number
+                // for all children, even if they haven't been loaded yet.
+                continue;
+              }
+
+              auto childInodeNumber = InodeNumber(childRawInode);
+              localMax = std::max(localMax, childRawInode);
+              auto childInfo = getInodeInfo(childInodeNumber);
+              if (!childInfo) {
+                const auto& hash = child.hash_ref();
+                if (!hash.has_value() || hash->empty()) {
+                  // This child is materialized (since it doesn't have a hash
+                  // linking it to a source control object).  It's a problem
+                  // if the materialized data isn't actually present in the
+                  // overlay.
+                  errors.wlock()->push_back(
+                      make_error<MissingMaterializedInode>(
+                          parentInodeNumber, childName, child));
+                }
+              } else {
+                std::lock_guard<std::mutex> guard{
+                    parentStripes[childRawInode % kNumParentStripes]};
+                childInfo->addParent(parentInodeNumber, *child.mode_ref());
+
+                // TODO: It would be nice to also check for mismatch between
+                // childInfo->type and child.mode
+              }
+            }
+
+            uint64_t prevMax = maxInodeNumber.load(std::memory_order_relaxed);
+            while (prevMax < localMax &&
+                   !maxInodeNumber.compare_exchange_weak(
+                       prevMax, localMax, std::memory_order_relaxed)) {
+            }
+            return true;
+          },
+          fsckScanThreads()) |
+      count;
+
+  updateMaxInodeNumber(InodeNumber(maxInodeNumber.load()));
+  auto errorsLock = errors.wlock();
+  while (!errorsLock->empty()) {
+    addError(std::move(errorsLock->back()));
+    errorsLock->pop_back();
   }
 }
 
@@ -87,13 +87,19 @@ class BufferedSqliteInodeCatalog : public SqliteInodeCatalog {
     explicit Work(
         folly::Function<bool()> operation,
         std::optional<overlay::OverlayDir> odir,
-        size_t estimateIndirectMemoryUsage)
+        size_t estimateIndirectMemoryUsage,
+        bool isControlEvent)
         : operation(std::move(operation)),
           odir(std::move(odir)),
-          estimateIndirectMemoryUsage(estimateIndirectMemoryUsage) {}
+          estimateIndirectMemoryUsage(estimateIndirectMemoryUsage),
+          isControlEvent(isControlEvent) {}
     folly::Function<bool()> operation;
     std::optional<overlay::OverlayDir> odir;
     size_t estimateIndirectMemoryUsage;
+    // Control events (shutdown, pause, flush) may block or stop the worker
+    // thread instead of writing to the database. The worker thread commits
+    // any open transaction before running one.
+    bool isControlEvent;
   };
 
   /**
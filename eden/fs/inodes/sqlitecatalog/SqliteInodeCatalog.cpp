@@ -17,8 +17,9 @@ namespace facebook::eden {
 
 SqliteInodeCatalog::SqliteInodeCatalog(
     AbsolutePathPiece path,
-    SqliteTreeStore::SynchronousMode mode)
-    : store_{path, mode} {}
+    SqliteTreeStore::SynchronousMode mode,
+    uint32_t walAutocheckpointPages)
+    : store_{path, mode, walAutocheckpointPages} {}
 
 std::optional<InodeNumber> SqliteInodeCatalog::initOverlay(
     bool createIfNonExisting) {
@@ -33,7 +33,9 @@ class SqliteInodeCatalog : public InodeCatalog {
   explicit SqliteInodeCatalog(
       AbsolutePathPiece path,
       SqliteTreeStore::SynchronousMode mode =
-          SqliteTreeStore::SynchronousMode::Normal);
+          SqliteTreeStore::SynchronousMode::Normal,
+      uint32_t walAutocheckpointPages =
+          SqliteTreeStore::kDefaultWalAutocheckpointPages);
 
   explicit SqliteInodeCatalog(std::unique_ptr<SqliteDatabase> store)
       : store_(std::move(store)) {}
@@ -106,6 +108,11 @@ class SqliteInodeCatalog : public InodeCatalog {
     store_.maintenance();
   }
 
+ protected:
+  SqliteTreeStore& treeStore() {
+    return store_;
+  }
+
  private:
   SqliteTreeStore store_;
 
@@ -8,6 +8,7 @@
 #include "eden/fs/inodes/sqlitecatalog/SqliteTreeStore.h"
 
 #include <folly/Range.h>
+#include <algorithm>
 #include <array>
 #include "eden/fs/inodes/InodeNumber.h"
 #include "eden/fs/inodes/overlay/gen-cpp2/overlay_types.h"
@@ -19,8 +20,11 @@ namespace facebook::eden {
 
 namespace {
 
-// SQLite table names
-constexpr folly::StringPiece kEntryTable = "entries";
+// Name of the single inode table used by schema version 1, kept for
+// migration.
+constexpr folly::StringPiece kLegacyEntryTable = "entries";
+
+// SQLite metadata table name
 constexpr folly::StringPiece kMetadataTable = "metadata";
 
 // Filename of the tree overlay database
@@ -32,96 +36,125 @@ constexpr auto kInitialNodeId = kRootNodeId.getRawValue() + 1;
 
 // Schema version of the SQLite database, everytime we changes the schema we
 // must bump this number.
-constexpr uint32_t kSchemaVersion = 1;
+//
+// Version 2 sharded the single `entries` table into
+// `SqliteTreeStore::kNumInodeShards` tables hashed by parent inode.
+constexpr uint32_t kSchemaVersion = 2;
 
 // Maximum number of values when we do batch insertion
 constexpr size_t kBatchInsertSize = 8;
 
+std::string shardTableName(size_t shard) {
+  return fmt::format("entries_{}", shard);
+}
+
+size_t shardOf(InodeNumber inode) {
+  return inode.get() % SqliteTreeStore::kNumInodeShards;
+}
+
 } // namespace
 
 struct SqliteTreeStore::StatementCache {
-  explicit StatementCache(LockedSqliteConnection& db)
-      : selectTree{db, "SELECT name, dtype, inode, hash FROM ", kEntryTable, " WHERE parent = ? ORDER BY name"},
-        countChildren{
-            db,
-            "SELECT COUNT(*) FROM ",
-            kEntryTable,
-            " WHERE parent = ?"},
-        deleteTree{db, "DELETE FROM ", kEntryTable, " WHERE parent = ?"},
-        hasTree{db, "SELECT 1 FROM ", kEntryTable, " WHERE parent = ?"},
-        insertChild{
-            db,
-            "INSERT INTO ",
-            kEntryTable,
-            " (parent, name, dtype, inode, sequence_id, hash) ",
-            " VALUES (?, ?, ?, ?, ?, ?)"},
-        deleteChild{
-            db,
-            "DELETE FROM ",
-            kEntryTable,
-            " WHERE parent = ? AND name = ?"},
-        hasChild{
-            db,
-            "SELECT COUNT(1) FROM ",
-            kEntryTable,
-            " WHERE parent = ? and name = ?"},
-        hasChildren{
-            db,
-            "SELECT COUNT(1) FROM ",
-            kEntryTable,
-            " WHERE `parent` = (SELECT `inode` FROM ",
-            kEntryTable,
-            " WHERE `parent` = ? AND `name` = ?)"},
-        renameChild{
-            db,
-            "UPDATE ",
-            kEntryTable,
-            " SET parent = ?, name = ? WHERE parent = ? AND name = ?"},
-        batchInsert{
-            makeBatchInsert(db, 1),
-            makeBatchInsert(db, 2),
-            makeBatchInsert(db, 3),
-            makeBatchInsert(db, 4),
-            makeBatchInsert(db, 5),
-            makeBatchInsert(db, 6),
-            makeBatchInsert(db, 7),
-            makeBatchInsert(db, 8),
-        } {}
-
-  PersistentSqliteStatement makeBatchInsert(
-      LockedSqliteConnection& db,
-      size_t size) {
-    constexpr folly::StringPiece values_fmt = "(?,?,?,?,?,?)";
-    fmt::memory_buffer stmt_buffer;
-    fmt::format_to(
-        stmt_buffer,
-        "INSERT INTO {} (parent, name, dtype, inode, sequence_id, hash) VALUES ",
-        kEntryTable);
-
-    for (size_t i = 0; i < size; i++) {
-      if (i != 0) {
-        fmt::format_to(stmt_buffer, ","); // delimiter
+  /**
+   * The prepared statements for one shard table. Every statement here is
+   * keyed by parent inode, so a given directory's rows live entirely within
+   * one shard.
+   */
+  struct Shard {
+    Shard(LockedSqliteConnection& db, const std::string& table)
+        : selectTree{db, "SELECT name, dtype, inode, hash FROM ", table, " WHERE parent = ? ORDER BY name"},
+          countChildren{
+              db,
+              "SELECT COUNT(*) FROM ",
+              table,
+              " WHERE parent = ?"},
+          deleteTree{db, "DELETE FROM ", table, " WHERE parent = ?"},
+          insertChild{
+              db,
+              "INSERT INTO ",
+              table,
+              " (parent, name, dtype, inode, sequence_id, hash) ",
+              " VALUES (?, ?, ?, ?, ?, ?)"},
+          deleteChild{
+              db,
+              "DELETE FROM ",
+              table,
+              " WHERE parent = ? AND name = ?"},
+          hasChild{
+              db,
+              "SELECT COUNT(1) FROM ",
+              table,
+              " WHERE parent = ? and name = ?"},
+          selectChild{
+              db,
+              "SELECT dtype, inode, sequence_id, hash FROM ",
+              table,
+              " WHERE parent = ? AND name = ?"},
+          renameChild{
+              db,
+              "UPDATE ",
+              table,
+              " SET parent = ?, name = ? WHERE parent = ? AND name = ?"},
+          batchInsert{
+              makeBatchInsert(db, table, 1),
+              makeBatchInsert(db, table, 2),
+              makeBatchInsert(db, table, 3),
+              makeBatchInsert(db, table, 4),
+              makeBatchInsert(db, table, 5),
+              makeBatchInsert(db, table, 6),
+              makeBatchInsert(db, table, 7),
+              makeBatchInsert(db, table, 8),
+          } {}
+
+    static PersistentSqliteStatement makeBatchInsert(
+        LockedSqliteConnection& db,
+        const std::string& table,
+        size_t size) {
+      constexpr folly::StringPiece values_fmt = "(?,?,?,?,?,?)";
+      fmt::memory_buffer stmt_buffer;
+      fmt::format_to(
+          stmt_buffer,
+          "INSERT INTO {} (parent, name, dtype, inode, sequence_id, hash) VALUES ",
+          table);
+
+      for (size_t i = 0; i < size; i++) {
+        if (i != 0) {
+          fmt::format_to(stmt_buffer, ","); // delimiter
+        }
+        fmt::format_to(stmt_buffer, values_fmt.data());
       }
-      fmt::format_to(stmt_buffer, values_fmt.data());
+      return PersistentSqliteStatement{db, fmt::to_string(stmt_buffer)};
     }
-    return PersistentSqliteStatement{db, fmt::to_string(stmt_buffer)};
+
+    PersistentSqliteStatement selectTree;
+    PersistentSqliteStatement countChildren;
+    PersistentSqliteStatement deleteTree;
+    PersistentSqliteStatement insertChild;
+    PersistentSqliteStatement deleteChild;
+    PersistentSqliteStatement hasChild;
+    PersistentSqliteStatement selectChild;
+    PersistentSqliteStatement renameChild;
+    std::array<PersistentSqliteStatement, kBatchInsertSize> batchInsert;
+  };
+
+  explicit StatementCache(LockedSqliteConnection& db) {
+    shards.reserve(SqliteTreeStore::kNumInodeShards);
+    for (size_t shard = 0; shard < SqliteTreeStore::kNumInodeShards; shard++) {
+      shards.emplace_back(db, shardTableName(shard));
+    }
+  }
+
+  Shard& shardFor(InodeNumber parent) {
+    return shards[shardOf(parent)];
   }
 
-  PersistentSqliteStatement selectTree;
-  PersistentSqliteStatement countChildren;
-  PersistentSqliteStatement deleteTree;
-  PersistentSqliteStatement hasTree;
-  PersistentSqliteStatement insertChild;
-  PersistentSqliteStatement deleteChild;
-  PersistentSqliteStatement hasChild;
-  PersistentSqliteStatement hasChildren;
-  PersistentSqliteStatement renameChild;
-  std::array<PersistentSqliteStatement, kBatchInsertSize> batchInsert;
+  std::vector<Shard> shards;
 };
 
 SqliteTreeStore::SqliteTreeStore(
     AbsolutePathPiece path,
-    SqliteTreeStore::SynchronousMode synchronous_mode) {
+    SqliteTreeStore::SynchronousMode synchronous_mode,
+    uint32_t walAutocheckpointPages) {
   ensureDirectoryExists(path);
 
   db_ = std::make_unique<SqliteDatabase>(path + kTreeStorePath);
@@ -131,6 +164,11 @@ SqliteTreeStore::SqliteTreeStore(
   auto dbLock = db_->lock();
   SqliteStatement(dbLock, "PRAGMA journal_mode=WAL").step();
 
+  // Raising the threshold batches more writes between automatic checkpoints;
+  // the overlay maintenance task still checkpoints on idle.
+  SqliteStatement(dbLock, "PRAGMA wal_autocheckpoint=", walAutocheckpointPages)
+      .step();
+
   if (synchronous_mode == SqliteTreeStore::SynchronousMode::Off) {
     XLOG(INFO)
         << "Synchronous mode is off. Data loss may happen when system crashes.";
@@ -158,17 +196,24 @@ std::unique_ptr<SqliteDatabase> SqliteTreeStore::takeDatabase() {
 }
 
 void SqliteTreeStore::createTableIfNonExisting() {
-  // TODO: check `user_version` and migrate schema if necessary
   db_->transaction([&](auto& txn) {
-    // `name` column in this table being `STRING` data type essentially capped
-    // our ability to support non-UTF-8 path. Currently we do enforce this rule
-    // elsewhere but moving forward if we ever need to support non-UTF-8 path we
-    // would need to migrate this column.
-    SqliteStatement(
-        txn,
-        "CREATE TABLE IF NOT EXISTS ",
-        kEntryTable,
-        R"(
+    // Inode rows are hash-sharded by parent inode across kNumInodeShards
+    // tables. A directory's rows always share a parent, so every operation
+    // touches exactly one shard (renames across directories touch two) and
+    // the hot btrees stay small instead of concentrating every insert on
+    // one rightmost page.
+    //
+    // `name` column in these tables being `STRING` data type essentially
+    // capped our ability to support non-UTF-8 path. Currently we do enforce
+    // this rule elsewhere but moving forward if we ever need to support
+    // non-UTF-8 path we would need to migrate this column.
+    for (size_t shard = 0; shard < kNumInodeShards; shard++) {
+      auto table = shardTableName(shard);
+      SqliteStatement(
+          txn,
+          "CREATE TABLE IF NOT EXISTS ",
+          table,
+          R"(
   (
     parent INTEGER NOT NULL,
     name STRING NOT NULL,
@@ -179,24 +224,30 @@ void SqliteTreeStore::createTableIfNonExisting() {
     PRIMARY KEY (parent, name)
 ) WITHOUT ROWID;
   )")
-        .step();
-
-    // This is an optimization for future. If we want to implement readdir
-    // support in overlay, we would be adding queries to filter by sequence_id.
-    SqliteStatement(
-        txn,
-        "CREATE INDEX IF NOT EXISTS entries_sequence_id_idx ON ",
-        kEntryTable,
-        " (sequence_id)")
-        .step();
-
-    // Optimizing `max(inode)`
-    SqliteStatement(
-        txn,
-        "CREATE INDEX IF NOT EXISTS entries_inode_idx ON ",
-        kEntryTable,
-        " (inode)")
-        .step();
+          .step();
+
+      // This is an optimization for future. If we want to implement readdir
+      // support in overlay, we would be adding queries to filter by
+      // sequence_id.
+      SqliteStatement(
+          txn,
+          "CREATE INDEX IF NOT EXISTS ",
+          table,
+          "_sequence_id_idx ON ",
+          table,
+          " (sequence_id)")
+          .step();
+
+      // Optimizing `max(inode)`
+      SqliteStatement(
+          txn,
+          "CREATE INDEX IF NOT EXISTS ",
+          table,
+          "_inode_idx ON ",
+          table,
+          " (inode)")
+          .step();
+    }
 
     // Metadata table
     SqliteStatement(txn, "CREATE TABLE IF NOT EXISTS ", kMetadataTable, R"(
@@ -212,6 +263,32 @@ void SqliteTreeStore::createTableIfNonExisting() {
   )")
         .step();
 
+    // Schema version 1 kept every row in a single `entries` table. Move any
+    // such rows into their shard; the rows themselves (including
+    // sequence_id) are unchanged, so the counters loaded by loadCounters are
+    // unaffected.
+    auto legacy = SqliteStatement(
+        txn,
+        "SELECT COUNT(1) FROM sqlite_master WHERE type = 'table' AND name = '",
+        kLegacyEntryTable,
+        "'");
+    if (legacy.step() && legacy.columnUint64(0) != 0) {
+      for (size_t shard = 0; shard < kNumInodeShards; shard++) {
+        SqliteStatement(
+            txn,
+            "INSERT INTO ",
+            shardTableName(shard),
+            " SELECT parent, name, dtype, inode, sequence_id, hash FROM ",
+            kLegacyEntryTable,
+            " WHERE parent % ",
+            kNumInodeShards,
+            " = ",
+            shard)
+            .step();
+      }
+      SqliteStatement(txn, "DROP TABLE ", kLegacyEntryTable).step();
+    }
+
     SqliteStatement(txn, "PRAGMA user_version = ", kSchemaVersion).step();
   });
 
@@ -227,31 +304,25 @@ InodeNumber SqliteTreeStore::loadCounters() {
   // load ids
   auto db = db_->lock();
 
-  {
-    auto stmt =
-        SqliteStatement(db, "SELECT max(sequence_id) FROM ", kEntryTable);
+  uint64_t maxSequenceId = 0;
+  uint64_t maxInode = 0;
+  for (size_t shard = 0; shard < kNumInodeShards; shard++) {
+    auto stmt = SqliteStatement(
+        db,
+        "SELECT max(sequence_id), max(inode) FROM ",
+        shardTableName(shard));
 
     if (stmt.step()) {
-      nextEntryId_ = stmt.columnUint64(0) + 1;
+      maxSequenceId = std::max(maxSequenceId, stmt.columnUint64(0));
+      maxInode = std::max(maxInode, stmt.columnUint64(1));
     } else {
-      throw std::runtime_error("unable to get max(sequence_id) from the table");
+      throw std::runtime_error(
+          "unable to get max(sequence_id) and max(inode) from the table");
     }
   }
 
-  {
-    auto stmt = SqliteStatement(db, "SELECT max(inode) FROM ", kEntryTable);
-
-    if (stmt.step()) {
-      auto inode = stmt.columnUint64(0);
-      if (inode == 0) {
-        nextInode_ = kInitialNodeId;
-      } else {
-        nextInode_ = inode + 1;
-      }
-    } else {
-      throw std::runtime_error("unable to get max(inode) from the table");
-    }
-  }
+  nextEntryId_ = maxSequenceId + 1;
+  nextInode_ = maxInode == 0 ? kInitialNodeId : maxInode + 1;
 
   return InodeNumber{nextInode_.load()};
 }
@@ -263,10 +334,11 @@ InodeNumber SqliteTreeStore::nextInodeNumber() {
 void SqliteTreeStore::saveTree(
     InodeNumber inodeNumber,
     overlay::OverlayDir&& odir) {
+  auto& shard = cache_->shardFor(inodeNumber);
   db_->transaction([&](auto& txn) {
     // When `saveTree` gets called, caller is expected to rewrite the tree
     // content. So we need to remove the previously stored version.
-    auto stmt = cache_->deleteTree.get(txn);
+    auto stmt = shard.deleteTree.get(txn);
     stmt->bind(1, inodeNumber.get());
     stmt->step();
 
@@ -284,7 +356,7 @@ void SqliteTreeStore::saveTree(
     auto entries_iter = odir.entries_ref()->cbegin();
 
     if (batch_count != 0) {
-      auto batch_insert = cache_->batchInsert[kBatchInsertSize - 1].get(txn);
+      auto batch_insert = shard.batchInsert[kBatchInsertSize - 1].get(txn);
       for (size_t i = 0; i < batch_count; i++) {
         // One batch
         for (size_t n = 0; n < kBatchInsertSize; n++, entries_iter++) {
@@ -299,7 +371,7 @@ void SqliteTreeStore::saveTree(
     }
 
     if (remaining != 0) {
-      auto insert = cache_->batchInsert[remaining - 1].get(txn);
+      auto insert = shard.batchInsert[remaining - 1].get(txn);
       for (size_t n = 0; entries_iter != odir.entries_ref()->cend();
            entries_iter++, n++) {
         auto name = PathComponentPiece{entries_iter->first};
@@ -314,20 +386,28 @@ void SqliteTreeStore::saveTree(
 overlay::OverlayDir SqliteTreeStore::loadTree(InodeNumber inode) {
   overlay::OverlayDir dir;
 
-  db_->transaction([&](auto& txn) {
-    auto query = cache_->selectTree.get(txn);
-    query->bind(1, inode.get());
-
-    while (query->step()) {
-      auto name = query->columnBlob(0);
-      overlay::OverlayEntry entry;
-      entry.mode_ref() =
-          dtype_to_mode(static_cast<dtype_t>(query->columnUint64(1)));
-      entry.inodeNumber_ref() = query->columnUint64(2);
-      entry.hash_ref() = query->columnBlob(3).toString();
-      dir.entries_ref()->emplace(std::make_pair(name, entry));
-    }
-  });
+  // Read through the reader pool so directory loads (mount initialization,
+  // fsck scans) don't serialize against writes on the main connection. The
+  // statement is prepared per call because cached statements are bound to
+  // the connection they were prepared on; this is a single SELECT so no
+  // transaction is needed.
+  auto db = db_->lockRead();
+  auto query = SqliteStatement(
+      db,
+      "SELECT name, dtype, inode, hash FROM ",
+      shardTableName(shardOf(inode)),
+      " WHERE parent = ? ORDER BY name");
+  query.bind(1, inode.get());
+
+  while (query.step()) {
+    auto name = query.columnBlob(0);
+    overlay::OverlayEntry entry;
+    entry.mode_ref() =
+        dtype_to_mode(static_cast<dtype_t>(query.columnUint64(1)));
+    entry.inodeNumber_ref() = query.columnUint64(2);
+    entry.hash_ref() = query.columnBlob(3).toString();
+    dir.entries_ref()->emplace(std::make_pair(name, entry));
+  }
 
   return dir;
 }
@@ -335,9 +415,10 @@ overlay::OverlayDir SqliteTreeStore::loadTree(InodeNumber inode) {
 overlay::OverlayDir SqliteTreeStore::loadAndRemoveTree(InodeNumber inode) {
   overlay::OverlayDir dir;
 
+  auto& shard = cache_->shardFor(inode);
   db_->transaction([&](auto& txn) {
     // SQLite does not support select-and-delete in one query.
-    auto query = cache_->selectTree.get(txn);
+    auto query = shard.selectTree.get(txn);
     query->bind(1, inode.get());
 
     while (query->step()) {
@@ -350,7 +431,7 @@ overlay::OverlayDir SqliteTreeStore::loadAndRemoveTree(InodeNumber inode) {
       dir.entries_ref()->emplace(std::make_pair(name, entry));
     }
 
-    auto deleteInode = cache_->deleteTree.get(txn);
+    auto deleteInode = shard.deleteTree.get(txn);
     deleteInode->reset();
     deleteInode->bind(1, inode.get());
     deleteInode->step();
@@ -360,15 +441,16 @@ overlay::OverlayDir SqliteTreeStore::loadAndRemoveTree(InodeNumber inode) {
 }
 
 void SqliteTreeStore::removeTree(InodeNumber inode) {
+  auto& shard = cache_->shardFor(inode);
   db_->transaction([&](auto& txn) {
-    auto children = cache_->countChildren.get(txn);
+    auto children = shard.countChildren.get(txn);
     children->bind(1, inode.get());
 
     if (!children->step() || children->columnUint64(0) != 0) {
       throw SqliteTreeStoreNonEmptyError("cannot delete non-empty directory");
     }
 
-    auto deleteInode = cache_->deleteTree.get(txn);
+    auto deleteInode = shard.deleteTree.get(txn);
     deleteInode->reset();
     deleteInode->bind(1, inode.get());
     deleteInode->step();
@@ -376,11 +458,17 @@ void SqliteTreeStore::removeTree(InodeNumber inode) {
 }
 
 bool SqliteTreeStore::hasTree(InodeNumber inode) {
-  auto db = db_->lock();
-  auto query = cache_->hasTree.get(db);
-  query->bind(1, inode.get());
-  if (query->step()) {
-    return query->columnUint64(0) == 1;
+  // Like loadTree, this reads through the reader pool so it doesn't
+  // serialize against writes on the main connection.
+  auto db = db_->lockRead();
+  auto query = SqliteStatement(
+      db,
+      "SELECT 1 FROM ",
+      shardTableName(shardOf(inode)),
+      " WHERE parent = ?");
+  query.bind(1, inode.get());
+  if (query.step()) {
+    return query.columnUint64(0) == 1;
   }
   return false;
 }
@@ -390,7 +478,7 @@ void SqliteTreeStore::addChild(
     PathComponentPiece name,
     overlay::OverlayEntry entry) {
   auto db = db_->lock();
-  auto stmt = cache_->insertChild.get(db);
+  auto stmt = cache_->shardFor(parent).insertChild.get(db);
   insertInodeEntry(*stmt, 0, parent, name, entry);
   stmt->step();
 }
@@ -399,7 +487,7 @@ void SqliteTreeStore::removeChild(
     InodeNumber parent,
     PathComponentPiece childName) {
   auto db = db_->lock();
-  auto stmt = cache_->deleteChild.get(db);
+  auto stmt = cache_->shardFor(parent).deleteChild.get(db);
   stmt->bind(1, parent.get());
   stmt->bind(2, childName.view());
   stmt->step();
@@ -409,7 +497,7 @@ bool SqliteTreeStore::hasChild(
     InodeNumber parent,
     PathComponentPiece childName) {
   auto db = db_->lock();
-  auto stmt = cache_->hasChild.get(db);
+  auto stmt = cache_->shardFor(parent).hasChild.get(db);
   stmt->bind(1, parent.get());
   stmt->bind(2, childName.view());
   stmt->step();
@@ -421,30 +509,70 @@ void SqliteTreeStore::renameChild(
     InodeNumber dst,
     PathComponentPiece srcName,
     PathComponentPiece dstName) {
+  auto& srcShard = cache_->shardFor(src);
+  auto& dstShard = cache_->shardFor(dst);
+
   // When rename also overwrites some file in the destination, we need to make
   // sure this is transactional.
   db_->transaction([&](auto& txn) {
-    auto overwriteEmpty = cache_->hasChildren.get(txn);
-    overwriteEmpty->bind(1, dst.get());
-    overwriteEmpty->bind(2, dstName.view());
-
-    if (!(overwriteEmpty->step() && overwriteEmpty->columnUint64(0) == 0)) {
-      throw SqliteTreeStoreNonEmptyError(
-          "cannot overwrite non-empty directory");
+    // If the rename overwrites a directory, it must be empty. The
+    // overwritten entry's children live in the shard keyed by its own inode,
+    // so look the inode up first and count its children there.
+    {
+      auto overwritten = dstShard.selectChild.get(txn);
+      overwritten->bind(1, dst.get());
+      overwritten->bind(2, dstName.view());
+      if (overwritten->step()) {
+        auto overwrittenInode = InodeNumber{overwritten->columnUint64(1)};
+        auto children =
+            cache_->shardFor(overwrittenInode).countChildren.get(txn);
+        children->bind(1, overwrittenInode.get());
+
+        if (!(children->step() && children->columnUint64(0) == 0)) {
+          throw SqliteTreeStoreNonEmptyError(
+              "cannot overwrite non-empty directory");
+        }
+      }
     }
 
     // If all the check passes, we delete the child being overwritten
-    auto deleteStmt = cache_->deleteChild.get(txn);
+    auto deleteStmt = dstShard.deleteChild.get(txn);
     deleteStmt->bind(1, dst.get());
     deleteStmt->bind(2, dstName.view());
     deleteStmt->step();
 
-    auto stmt = cache_->renameChild.get(txn);
-    stmt->bind(1, dst.get());
-    stmt->bind(2, dstName.view());
-    stmt->bind(3, src.get());
-    stmt->bind(4, srcName.view());
-    stmt->step();
+    if (&srcShard == &dstShard) {
+      auto stmt = srcShard.renameChild.get(txn);
+      stmt->bind(1, dst.get());
+      stmt->bind(2, dstName.view());
+      stmt->bind(3, src.get());
+      stmt->bind(4, srcName.view());
+      stmt->step();
+    } else {
+      // The source and destination directories hash to different shards, so
+      // move the row across tables. The row keeps its identity, including
+      // its sequence_id.
+      auto select = srcShard.selectChild.get(txn);
+      select->bind(1, src.get());
+      select->bind(2, srcName.view());
+      if (select->step()) {
+        auto insert = dstShard.insertChild.get(txn);
+        insert->bind(1, dst.get());
+        insert->bind(2, dstName.view());
+        insert->bind(3, select->columnUint64(0));
+        insert->bind(4, select->columnUint64(1));
+        insert->bind(5, select->columnUint64(2));
+        // The blob points into the select statement's current row, which
+        // stays valid until the select is stepped or reset.
+        insert->bind(6, select->columnBlob(3));
+        insert->step();
+
+        auto deleteSrc = srcShard.deleteChild.get(txn);
+        deleteSrc->bind(1, src.get());
+        deleteSrc->bind(2, srcName.view());
+        deleteSrc->step();
+      }
+    }
   });
 }
 
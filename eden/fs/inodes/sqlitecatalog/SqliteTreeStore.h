@@ -50,10 +50,25 @@ class SqliteTreeStore {
     Normal = 1,
   };
 
+  /**
+   * SQLite's default WAL auto-checkpoint threshold, in pages. See
+   * `overlay:wal-autocheckpoint-pages` in EdenConfig for tuning.
+   */
+  static constexpr uint32_t kDefaultWalAutocheckpointPages = 1000;
+
+  /**
+   * Number of tables the inode rows are sharded across, hashed by parent
+   * inode. Keeps each btree small so inserts don't all contend on one hot
+   * rightmost page. The shard assignment is baked into the on-disk schema,
+   * so changing this value requires a schema migration.
+   */
+  static constexpr size_t kNumInodeShards = 8;
+
   explicit SqliteTreeStore(
       AbsolutePathPiece dir,
       SqliteTreeStore::SynchronousMode mode =
-          SqliteTreeStore::SynchronousMode::Normal);
+          SqliteTreeStore::SynchronousMode::Normal,
+      uint32_t walAutocheckpointPages = kDefaultWalAutocheckpointPages);
 
   explicit SqliteTreeStore(std::unique_ptr<SqliteDatabase> db);
 
@@ -141,6 +156,14 @@ class SqliteTreeStore {
 
   std::unique_ptr<SqliteDatabase> takeDatabase();
 
+  /**
+   * Access the underlying database, which remains owned by this store. This
+   * allows callers to group several store operations into one transaction.
+   */
+  SqliteDatabase* getDatabase() {
+    return db_.get();
+  }
+
   void maintenance() {
     db_->checkpoint();
   }
@@ -10,6 +10,8 @@
 
 #ifdef _WIN32
 #include <boost/filesystem.hpp>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
 #include <folly/portability/Windows.h>
 
 #include <ProjectedFSLib.h> // @manual
@@ -511,6 +513,12 @@ std::optional<InodeNumber> fixup(
 }
 
 // Returns true if the given path is considered materialized.
+//
+// When `childExecutor` is non-null, the children of this directory are
+// reconciled concurrently on it. Only the top-level call may pass an
+// executor: tasks block on their subtree's completion, so handing nested
+// levels to the same bounded pool could leave every thread waiting on work
+// that cannot start.
 bool processChildren(
     SqliteInodeCatalog& inodeCatalog,
     RelativePathPiece path,
@@ -520,15 +528,17 @@ bool processChildren(
     const std::shared_ptr<const Tree>& scmTree,
     const SqliteInodeCatalog::LookupCallback& callback,
     uint64_t logFrequency,
-    uint64_t& traversedDirectories) {
+    std::atomic<uint64_t>& traversedDirectories,
+    folly::Executor* childExecutor) {
   XLOGF(DBG9, "processChildren - {}", path);
 
-  traversedDirectories++;
-  if (traversedDirectories % logFrequency == 0) {
+  auto traversed =
+      traversedDirectories.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (traversed % logFrequency == 0) {
     // TODO: We could also report the progress to the StartupLogger to be
     // displayed in the user console. That however requires a percent and it's
     // a bit unclear how we can compute this percent.
-    XLOGF(INFO, "{} directories scanned", traversedDirectories);
+    XLOGF(INFO, "{} directories scanned", traversed);
   }
 
   // Handle children
@@ -590,8 +600,15 @@ bool processChildren(
   }
 
   // Recurse for any children.
-  bool anyChildMaterialized = false;
-  for (auto& [childName, childState] : children) {
+  //
+  // Each child is reconciled independently: fix up its entry in this
+  // directory, recurse into its subtree when it is an on-disk directory, and
+  // re-mark this directory's entry when the subtree turned out to be
+  // materialized. A child only ever touches its own name in this directory,
+  // and the sqlite catalog serializes concurrent statements internally, so
+  // the children can safely run in parallel when an executor was provided.
+  auto processChild = [&](const PathComponent& childName,
+                          FsckFileState& childState) -> bool {
     auto childPath = path + childName;
     XLOGF(DBG9, "process child - {}", childPath);
 
@@ -602,7 +619,7 @@ bool processChildren(
         inodeNumber,
         insensitiveOverlayDir);
 
-    anyChildMaterialized |= childState.diskMaterialized;
+    bool materialized = childState.diskMaterialized;
 
     if (childState.desiredDtype == dtype_t::Dir && childState.onDisk &&
         !childState.diskEmptyPlaceholder && childInodeNumberOpt.has_value()) {
@@ -631,8 +648,9 @@ bool processChildren(
           childScmTree,
           callback,
           logFrequency,
-          traversedDirectories);
-      anyChildMaterialized |= childMaterialized;
+          traversedDirectories,
+          /*childExecutor=*/nullptr);
+      materialized |= childMaterialized;
 
       if (childMaterialized && childState.desiredHash != std::nullopt) {
         XLOGF(
@@ -655,11 +673,33 @@ bool processChildren(
             updatedInsensitiveOverlayDir);
       }
     }
+    return materialized;
+  };
+
+  bool anyChildMaterialized = false;
+  if (childExecutor && children.size() > 1) {
+    std::vector<folly::Future<bool>> futures;
+    futures.reserve(children.size());
+    for (auto& child : children) {
+      futures.push_back(folly::via(childExecutor, [&processChild, &child] {
+        return processChild(child.first, child.second);
+      }));
+    }
+    for (auto& result : folly::collectAll(std::move(futures)).get()) {
+      anyChildMaterialized |= std::move(result).value();
+    }
+  } else {
+    for (auto& [childName, childState] : children) {
+      anyChildMaterialized |= processChild(childName, childState);
+    }
   }
 
   return anyChildMaterialized;
 }
 
+// When `childExecutor` is non-null, subdirectories are scanned concurrently
+// on it. As with processChildren, only the top-level call may pass an
+// executor since the caller blocks on the spawned scans.
 void scanCurrentDir(
     SqliteInodeCatalog& inodeCatalog,
     AbsolutePathPiece dir,
@@ -667,7 +707,8 @@ void scanCurrentDir(
     const overlay::OverlayDir& parentOverlayDir,
     const PathMap<overlay::OverlayEntry>& parentInsensitiveOverlayDir,
     bool recordDeletion,
-    SqliteInodeCatalog::LookupCallback& callback) {
+    SqliteInodeCatalog::LookupCallback& callback,
+    folly::Executor* childExecutor) {
   auto boostPath = boost::filesystem::path(dir.asString());
   if (!boost::filesystem::is_directory(boostPath)) {
     XLOGF(WARN, "Attempting to scan '{}' which is not a directory", dir);
@@ -764,6 +805,7 @@ void scanCurrentDir(
 
   // Now that this overlay directory is consistent with the on-disk state,
   // proceed to its children.
+  std::vector<folly::Future<folly::Unit>> childScans;
   for (const auto& entry : boost::filesystem::directory_iterator(boostPath)) {
     auto path = AbsolutePath{entry.path().c_str()};
     auto mode = dtypeFromPath(entry.path());
@@ -789,16 +831,36 @@ void scanCurrentDir(
           InodeNumber::fromThrift(*overlayEntry->inodeNumber_ref());
       auto entryDir = *inodeCatalog.loadOverlayDir(entryInode);
       auto entryInsensitiveOverlayDir = toPathMap(entryDir);
-      scanCurrentDir(
-          inodeCatalog,
-          path,
-          entryInode,
-          entryDir,
-          entryInsensitiveOverlayDir,
-          isFull,
-          callback);
+      // Subtrees under different children are disjoint, so they can be
+      // scanned concurrently when the top-level call provided an executor.
+      auto scanChild = [&inodeCatalog,
+                        &callback,
+                        path,
+                        entryInode,
+                        entryDir = std::move(entryDir),
+                        entryInsensitiveOverlayDir =
+                            std::move(entryInsensitiveOverlayDir),
+                        isFull] {
+        scanCurrentDir(
+            inodeCatalog,
+            path,
+            entryInode,
+            entryDir,
+            entryInsensitiveOverlayDir,
+            isFull,
+            callback,
+            /*childExecutor=*/nullptr);
+      };
+      if (childExecutor) {
+        childScans.push_back(folly::via(childExecutor, std::move(scanChild)));
+      } else {
+        scanChild();
+      }
     }
   }
+  for (auto& result : folly::collectAll(std::move(childScans)).get()) {
+    std::move(result).throwUnlessValue();
+  }
 }
 } // namespace
 
@@ -810,6 +872,18 @@ void windowsFsckScanLocalChanges(
   XLOGF(INFO, "Start scanning {}", mountPath);
   if (auto view = inodeCatalog.loadOverlayDir(kRootNodeId)) {
     auto insensitiveOverlayDir = toPathMap(*view);
+
+    // Scan the top-level subtrees of the mount concurrently. The top of the
+    // repository tends to fan out widely, so handing each top-level
+    // directory to the pool keeps every scanner thread busy without the
+    // deadlock hazards of blocking on nested work.
+    auto numScannerThreads = config->fsckNumScannerThreads.getValue();
+    std::unique_ptr<folly::CPUThreadPoolExecutor> scannerPool;
+    if (numScannerThreads > 1) {
+      scannerPool =
+          std::make_unique<folly::CPUThreadPoolExecutor>(numScannerThreads);
+    }
+
     if (config->useThoroughFsck.getValue()) {
       // TODO: Handler errors or no trees
       auto scmEntryTry = callback(""_relpath).getTry();
@@ -818,7 +892,7 @@ void windowsFsckScanLocalChanges(
           facebook::eden::TreeEntry>& scmEntry = scmEntryTry.value();
       std::shared_ptr<const Tree> scmTree =
           std::get<std::shared_ptr<const Tree>>(scmEntry);
-      uint64_t traversedDirectories = 1;
+      std::atomic<uint64_t> traversedDirectories = 1;
       processChildren(
           inodeCatalog,
           ""_relpath,
@@ -828,7 +902,8 @@ void windowsFsckScanLocalChanges(
           scmTree,
           callback,
           config->fsckLogFrequency.getValue(),
-          traversedDirectories);
+          traversedDirectories,
+          scannerPool.get());
     } else {
       scanCurrentDir(
           inodeCatalog,
@@ -837,7 +912,8 @@ void windowsFsckScanLocalChanges(
           *view,
           insensitiveOverlayDir,
           false,
-          callback);
+          callback,
+          scannerPool.get());
     }
     XLOGF(INFO, "Scanning complete for {}", mountPath);
   } else {
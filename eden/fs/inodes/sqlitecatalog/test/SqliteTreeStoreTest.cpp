@@ -15,6 +15,7 @@
 #include "eden/fs/inodes/overlay/gen-cpp2/overlay_types.h"
 #include "eden/fs/model/Hash.h"
 #include "eden/fs/sqlite/SqliteDatabase.h"
+#include "eden/fs/sqlite/SqliteStatement.h"
 #include "eden/fs/utils/DirType.h"
 #include "eden/fs/utils/PathFuncs.h"
 
@@ -274,4 +275,39 @@ TEST_F(SqliteTreeStoreTest, testRenameChild) {
     expect_entry(it->second, entry);
   }
 }
+
+TEST(SqliteTreeStoreMigrationTest, migratesUnshardedSchema) {
+  // Build a schema version 1 database by hand: a single `entries` table
+  // holding rows for two directories.
+  auto db = std::make_unique<SqliteDatabase>(SqliteDatabase::inMemory);
+  {
+    auto conn = db->lock();
+    SqliteStatement(
+        conn,
+        "CREATE TABLE entries (parent INTEGER NOT NULL, name STRING NOT NULL, "
+        "dtype INTEGER NOT NULL, inode INTEGER NOT NULL, "
+        "sequence_id INTEGER NOT NULL, hash BLOB, "
+        "PRIMARY KEY (parent, name)) WITHOUT ROWID")
+        .step();
+    SqliteStatement(
+        conn,
+        "INSERT INTO entries (parent, name, dtype, inode, sequence_id, hash) "
+        "VALUES (2, 'hello', 8, 3, 1, x''), (2, 'world', 8, 4, 2, x''), "
+        "(5, 'other', 8, 6, 3, x'')")
+        .step();
+    SqliteStatement(conn, "PRAGMA user_version = 1").step();
+  }
+
+  auto store = std::make_unique<SqliteTreeStore>(std::move(db));
+  store->createTableIfNonExisting();
+
+  // Counters must survive the migration: max(inode) was 6, so 7 is next.
+  EXPECT_EQ(store->loadCounters(), InodeNumber{7});
+
+  auto dir = store->loadTree(InodeNumber{2});
+  EXPECT_EQ(dir.entries_ref()->size(), 2);
+  EXPECT_EQ(dir.entries_ref()->count("hello"), 1);
+  EXPECT_EQ(dir.entries_ref()->count("world"), 1);
+  EXPECT_EQ(store->loadTree(InodeNumber{5}).entries_ref()->size(), 1);
+}
 } // namespace facebook::eden
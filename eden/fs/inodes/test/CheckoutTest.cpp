@@ -712,6 +712,45 @@ TEST(Checkout, modifyThenRevert) {
 #endif
 }
 
+TEST(Checkout, prepareCheckoutRecordsConflictCandidates) {
+  auto builder1 = FakeTreeBuilder();
+  builder1.setFile("src/main.c", "int main() { return 0; }\n");
+  builder1.setFile("src/test/test.c", "testy tests");
+  TestMount testMount{builder1};
+  auto originalCommit = testMount.getEdenMount()->getCheckedOutRootId();
+
+  // Prepare a second commit that modifies one file and adds another.
+  auto builder2 = builder1.clone();
+  builder2.replaceFile("src/main.c", "int main() { return 1; }\n");
+  builder2.setFile("src/new.c", "this file is new\n");
+  builder2.finalize(testMount.getBackingStore(), true);
+  auto commit2 = testMount.getBackingStore()->putCommit(RootId{"2"}, builder2);
+  commit2->setReady();
+
+  auto executor = testMount.getServerExecutor().get();
+  auto prepareFut = testMount.getEdenMount()
+                        ->prepareCheckout(RootId{"2"})
+                        .semi()
+                        .via(executor);
+  while (!prepareFut.isReady()) {
+    testMount.drainServerExecutor();
+  }
+  std::move(prepareFut).get(0ms);
+
+  auto precomputed = testMount.getEdenMount()->takePrecomputedCheckout(
+      originalCommit, RootId{"2"});
+  ASSERT_TRUE(precomputed.has_value());
+  EXPECT_THAT(
+      precomputed->conflictCandidates,
+      UnorderedElementsAre(
+          RelativePath{"src/main.c"}, RelativePath{"src/new.c"}));
+
+  // The result is consumed by the first take.
+  EXPECT_FALSE(testMount.getEdenMount()
+                   ->takePrecomputedCheckout(originalCommit, RootId{"2"})
+                   .has_value());
+}
+
 TEST(Checkout, modifyThenCheckoutRevisionWithoutFile) {
   auto builder1 = FakeTreeBuilder();
   builder1.setFile("src/main.c", "// Some code.\n");
@@ -9,6 +9,7 @@
 #include <folly/portability/GTest.h>
 
 #include "eden/fs/inodes/FileInode.h"
+#include "eden/fs/inodes/Overlay.h"
 #include "eden/fs/inodes/TreeInode.h"
 #include "eden/fs/model/TestOps.h"
 #include "eden/fs/service/PrettyPrinters.h"
@@ -136,4 +137,103 @@ TEST(Dematerialize, test_dematerialization_migrates_to_the_new_ID_scheme) {
   EXPECT_TRUE(inode->isUnlinked());
 }
 
+#ifndef _WIN32
+TEST(Dematerialize, background_scan_dematerializes_unmodified_unloaded_files) {
+  TestMount mount;
+
+  FakeTreeBuilder builder;
+  builder.setFile("a/test.txt"_relpath, "contents\n", false, ObjectId{"blob1"});
+  mount.initialize(RootId{"1"}, builder);
+
+  auto executor = mount.getServerExecutor().get();
+  auto edenMount = mount.getEdenMount();
+
+  // Materialize the file without changing its contents, then unload it so
+  // only its overlay data remains.
+  auto inode = mount.overwriteFile("a/test.txt", "contents\n");
+  EXPECT_EQ(std::nullopt, inode->getBlobHash());
+  auto fileInodeNumber = inode->getNodeId();
+  inode.reset();
+  edenMount->getRootInode()->unloadChildrenNow();
+
+  // The journal advanced since the mount started, so the first scan defers
+  // until the working copy has been idle for a full interval.
+  EXPECT_EQ(
+      0,
+      edenMount->dematerializeUnmodifiedFiles(100)
+          .semi()
+          .via(executor)
+          .getVia(executor));
+
+  // The second scan sees a quiet journal and reclaims the file.
+  EXPECT_EQ(
+      1,
+      edenMount->dematerializeUnmodifiedFiles(100)
+          .semi()
+          .via(executor)
+          .getVia(executor));
+
+  {
+    auto contents = mount.getTreeInode("a")->getContents().rlock();
+    auto iter = contents->entries.find("test.txt"_pc);
+    ASSERT_TRUE(iter != contents->entries.end());
+    EXPECT_FALSE(iter->second.isMaterialized());
+    EXPECT_EQ(ObjectId{"blob1"}, iter->second.getHash());
+    EXPECT_EQ(fileInodeNumber, iter->second.getInodeNumber());
+  }
+  EXPECT_FALSE(edenMount->getOverlay()->hasOverlayFile(fileInodeNumber));
+
+  // The reclaimed file reads back through the source control blob.
+  EXPECT_EQ(
+      "contents\n",
+      mount.getFileInode("a/test.txt")
+          ->readAll(ObjectFetchContext::getNullContext())
+          .get());
+}
+
+TEST(Dematerialize, background_scan_leaves_modified_files_materialized) {
+  TestMount mount;
+
+  FakeTreeBuilder builder;
+  builder.setFile("a/test.txt"_relpath, "contents\n", false, ObjectId{"blob1"});
+  mount.initialize(RootId{"1"}, builder);
+
+  auto executor = mount.getServerExecutor().get();
+  auto edenMount = mount.getEdenMount();
+
+  auto inode = mount.overwriteFile("a/test.txt", "different contents\n");
+  auto fileInodeNumber = inode->getNodeId();
+  inode.reset();
+  edenMount->getRootInode()->unloadChildrenNow();
+
+  // Run twice so the second scan observes a quiet journal; the modified file
+  // must still not be reclaimed.
+  EXPECT_EQ(
+      0,
+      edenMount->dematerializeUnmodifiedFiles(100)
+          .semi()
+          .via(executor)
+          .getVia(executor));
+  EXPECT_EQ(
+      0,
+      edenMount->dematerializeUnmodifiedFiles(100)
+          .semi()
+          .via(executor)
+          .getVia(executor));
+
+  {
+    auto contents = mount.getTreeInode("a")->getContents().rlock();
+    auto iter = contents->entries.find("test.txt"_pc);
+    ASSERT_TRUE(iter != contents->entries.end());
+    EXPECT_TRUE(iter->second.isMaterialized());
+  }
+  EXPECT_TRUE(edenMount->getOverlay()->hasOverlayFile(fileInodeNumber));
+  EXPECT_EQ(
+      "different contents\n",
+      mount.getFileInode("a/test.txt")
+          ->readAll(ObjectFetchContext::getNullContext())
+          .get());
+}
+#endif // !_WIN32
+
 } // namespace
@@ -183,6 +183,35 @@ TEST(DiffTest, fileModified) {
           std::make_pair("src/1.txt", ScmFileStatus::MODIFIED)));
 }
 
+TEST(DiffTest, statusCachedUntilJournalMoves) {
+  DiffTest test;
+  auto& mount = test.getMount();
+
+  auto runStatus = [&] {
+    auto df = test.diffFuture().semi().via(mount.getServerExecutor().get());
+    mount.drainServerExecutor();
+    return EXPECT_FUTURE_RESULT(df);
+  };
+
+  // The first computation populates the status cache; with no intervening
+  // journal movement the second query must return the same (empty) result.
+  EXPECT_THAT(*runStatus().entries_ref(), UnorderedElementsAre());
+  EXPECT_THAT(*runStatus().entries_ref(), UnorderedElementsAre());
+
+  // Any journal movement must invalidate the cached status.
+  mount.overwriteFile("src/1.txt", "This file has been updated.\n");
+  EXPECT_THAT(
+      *runStatus().entries_ref(),
+      UnorderedElementsAre(
+          std::make_pair("src/1.txt", ScmFileStatus::MODIFIED)));
+
+  // The refreshed result is itself cached and served consistently.
+  EXPECT_THAT(
+      *runStatus().entries_ref(),
+      UnorderedElementsAre(
+          std::make_pair("src/1.txt", ScmFileStatus::MODIFIED)));
+}
+
 #ifndef _WIN32
 TEST(DiffTest, fileModeChanged) {
   DiffTest test;
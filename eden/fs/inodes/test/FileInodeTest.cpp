@@ -480,6 +480,24 @@ TEST_F(FileInodeTest, fallocate) {
 }
 #endif
 
+TEST_F(FileInodeTest, wholeFileOverwrite) {
+  auto inode = mount_.getFileInode("dir/a.txt");
+
+  // Cache the non-materialized size so the write below is recognized as
+  // replacing the entire file, taking the truncating materialization path
+  // rather than copying the blob into the overlay first.
+  auto attr = getFileAttr(mount_, inode);
+  EXPECT_EQ(15, attr.st_size);
+
+  auto newContents = "This was a.txt, now entirely rewritten.\n"_sp;
+  auto written =
+      inode->write(newContents, 0, ObjectFetchContext::getNullContext())
+          .get(0ms);
+  EXPECT_EQ(newContents.size(), written);
+
+  EXPECT_FILE_INODE(inode, newContents, 0644);
+}
+
 TEST(FileInode, truncatingDuringLoad) {
   FakeTreeBuilder builder;
   builder.setFiles({{"notready.txt", "Contents not ready.\n"}});
@@ -538,6 +556,41 @@ TEST(FileInode, readDuringLoad) {
   EXPECT_EQ(contents, std::move(dataFuture).get(0ms));
 }
 
+TEST(FileInode, repeatedPartialReadsSeeWrites) {
+  // Partial reads of a clean file publish the blob for the lock-free read
+  // fast path. Make sure subsequent reads return correct data and that a
+  // write invalidates the publication.
+  FakeTreeBuilder builder;
+  auto contents = "abcdefghijklmnopqrstuvwxyz"_sp;
+  builder.setFiles({{"file.txt", contents}});
+  TestMount mount_;
+  mount_.initialize(builder);
+
+  auto inode = mount_.getFileInode("file.txt");
+
+  auto readRange = [&](size_t size, off_t off) {
+    return inode->read(size, off, ObjectFetchContext::getNullContext())
+        .thenValue([](std::tuple<BufVec, bool> readRes) {
+          auto [data, isEof] = std::move(readRes);
+          return data->moveToFbString();
+        })
+        .get(0ms);
+  };
+
+  // The first partial read goes through the locked path and publishes the
+  // blob; the second is served from the publication.
+  EXPECT_EQ("abcde", readRange(5, 0));
+  EXPECT_EQ("fghij", readRange(5, 5));
+
+  // Materializing the file must invalidate the publication.
+  auto writeFuture =
+      inode->write("FGHIJ"_sp, 5, ObjectFetchContext::getNullContext());
+  EXPECT_EQ(5, std::move(writeFuture).get(0ms));
+
+  EXPECT_EQ("FGHIJ", readRange(5, 5));
+  EXPECT_EQ("abcde", readRange(5, 0));
+}
+
 TEST(FileInode, writeDuringLoad) {
   // Build a tree to test against, but do not mark the state ready yet
   FakeTreeBuilder builder;
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/inodes/InodeAttributeCache.h"
+
+#include <folly/portability/GTest.h>
+
+using namespace facebook::eden;
+
+TEST(InodeAttributeCacheTest, hitRequiresMatchingSequence) {
+  InodeAttributeCache cache;
+  InodeNumber ino{42};
+
+  struct stat st = {};
+  st.st_ino = ino.get();
+  st.st_size = 1234;
+
+  EXPECT_FALSE(cache.get(ino, 7).has_value());
+
+  cache.set(ino, 7, st);
+
+  auto cached = cache.get(ino, 7);
+  ASSERT_TRUE(cached.has_value());
+  EXPECT_EQ(1234, cached->st_size);
+
+  // Any journal activity bumps the sequence and makes the entry stale.
+  EXPECT_FALSE(cache.get(ino, 8).has_value());
+
+  // The stale entry was erased, so the old sequence no longer hits either.
+  EXPECT_FALSE(cache.get(ino, 7).has_value());
+}
+
+TEST(InodeAttributeCacheTest, entriesAreIndependentPerInode) {
+  InodeAttributeCache cache;
+
+  struct stat st = {};
+  st.st_size = 1;
+  cache.set(InodeNumber{1}, 3, st);
+  st.st_size = 2;
+  cache.set(InodeNumber{2}, 3, st);
+
+  auto first = cache.get(InodeNumber{1}, 3);
+  auto second = cache.get(InodeNumber{2}, 3);
+  ASSERT_TRUE(first.has_value());
+  ASSERT_TRUE(second.has_value());
+  EXPECT_EQ(1, first->st_size);
+  EXPECT_EQ(2, second->st_size);
+  EXPECT_FALSE(cache.get(InodeNumber{3}, 3).has_value());
+}
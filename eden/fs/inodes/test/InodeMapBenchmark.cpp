@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/inodes/InodeMap.h"
+
+#include <fmt/format.h>
+#include <vector>
+
+#include "eden/common/utils/benchharness/Bench.h"
+#include "eden/fs/inodes/EdenMount.h"
+#include "eden/fs/inodes/FileInode.h"
+#include "eden/fs/testharness/FakeTreeBuilder.h"
+#include "eden/fs/testharness/TestMount.h"
+
+namespace facebook::eden {
+
+namespace {
+
+constexpr size_t kFileCount = 1000;
+
+/**
+ * Benchmarks the InodeMap fast path: looking up inodes that are already
+ * loaded. This is what every FUSE request pays before it can do any real
+ * work.
+ */
+void lookup_loaded_inodes(benchmark::State& state) {
+  FakeTreeBuilder builder;
+  for (size_t i = 0; i < kFileCount; ++i) {
+    builder.setFile(fmt::format("dir/file{}.txt", i), "contents");
+  }
+  TestMount testMount{builder};
+
+  std::vector<InodeNumber> inodeNumbers;
+  inodeNumbers.reserve(kFileCount);
+  for (size_t i = 0; i < kFileCount; ++i) {
+    auto inode = testMount.getFileInode(fmt::format("dir/file{}.txt", i));
+    inodeNumbers.push_back(inode->getNodeId());
+  }
+
+  auto* inodeMap = testMount.getEdenMount()->getInodeMap();
+  size_t i = 0;
+  for (auto _ : state) {
+    auto inode = inodeMap->lookupInode(inodeNumbers[i]).get();
+    benchmark::DoNotOptimize(inode);
+    i = (i + 1) % inodeNumbers.size();
+  }
+}
+BENCHMARK(lookup_loaded_inodes);
+
+} // namespace
+
+} // namespace facebook::eden
+
+EDEN_BENCHMARK_MAIN();
@@ -685,6 +685,37 @@ TEST_F(
   EXPECT_EQ(oldFile1Id, file1->getNodeId());
   EXPECT_EQ(oldFile2Id, file2->getNodeId());
 }
+
+TEST_F(
+    InodePersistenceTreeTest,
+    initializeFromOverlayAnswersLookupsAfterNonGracefulRemount) {
+  TestMount testMount{builder};
+  testMount.getEdenConfig().initializeInodeMapFromOverlay.setValue(
+      true, ConfigSource::CommandLine, true);
+
+  auto tree = testMount.getInode("dir"_relpath);
+  auto file1 = testMount.getInode("dir/file1.txt"_relpath);
+
+  // Pretend the kernel is keeping references to these, so their inode
+  // numbers are written to the overlay when the mount shuts down.
+  tree->incFsRefcount();
+  file1->incFsRefcount();
+
+  auto oldFile1Id = file1->getNodeId();
+  tree.reset();
+  file1.reset();
+
+  // Remount without takeover data, as after an ungraceful restart.
+  testMount.remount();
+  auto edenMount = testMount.getEdenMount();
+
+  // The InodeMap was pre-populated from the overlay, so a lookup by inode
+  // number succeeds without any prior lookup by name.
+  auto file1Fut = edenMount->getInodeMap()->lookupInode(oldFile1Id).semi().via(
+      testMount.getServerExecutor().get());
+  testMount.drainServerExecutor();
+  EXPECT_EQ("dir/file1.txt", std::move(file1Fut).get(0ms)->getLogPath());
+}
 #endif
 
 /**
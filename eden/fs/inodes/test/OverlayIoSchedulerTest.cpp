@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifndef _WIN32
+
+#include "eden/fs/inodes/OverlayIoScheduler.h"
+
+#include <folly/portability/GTest.h>
+#include <folly/stop_watch.h>
+
+#include "eden/fs/config/EdenConfig.h"
+#include "eden/fs/config/ReloadableConfig.h"
+#include "eden/fs/telemetry/EdenStats.h"
+
+namespace facebook::eden {
+
+namespace {
+std::shared_ptr<ReloadableConfig> makeConfig(
+    uint64_t checkoutThroughput,
+    std::chrono::nanoseconds deadline) {
+  auto config = EdenConfig::createTestEdenConfig();
+  config->overlayCheckoutBulkIoThroughput.setValue(
+      checkoutThroughput, ConfigSource::CommandLine);
+  config->overlayIoThrottleDeadline.setValue(
+      deadline, ConfigSource::CommandLine);
+  return std::make_shared<ReloadableConfig>(std::move(config));
+}
+} // namespace
+
+TEST(OverlayIoSchedulerTest, interactiveIsNeverThrottled) {
+  EdenStats stats;
+  OverlayIoScheduler scheduler{
+      makeConfig(1, std::chrono::seconds(10)), &stats};
+
+  folly::stop_watch<std::chrono::milliseconds> watch;
+  for (int i = 0; i < 100; i++) {
+    scheduler.acquire(
+        OverlayIoScheduler::IoClass::Interactive, 10 * 1024 * 1024);
+  }
+  EXPECT_LT(watch.elapsed(), std::chrono::seconds(1));
+}
+
+TEST(OverlayIoSchedulerTest, zeroRateDisablesThrottle) {
+  EdenStats stats;
+  OverlayIoScheduler scheduler{
+      makeConfig(0, std::chrono::seconds(10)), &stats};
+
+  folly::stop_watch<std::chrono::milliseconds> watch;
+  for (int i = 0; i < 100; i++) {
+    scheduler.acquire(
+        OverlayIoScheduler::IoClass::CheckoutBulk, 10 * 1024 * 1024);
+  }
+  EXPECT_LT(watch.elapsed(), std::chrono::seconds(1));
+}
+
+TEST(OverlayIoSchedulerTest, sustainedBulkWritesAreThrottled) {
+  EdenStats stats;
+  // 1MiB/s with a 50ms deadline: after the burst allowance is exhausted,
+  // each further write must wait, but never longer than the deadline.
+  OverlayIoScheduler scheduler{
+      makeConfig(1024 * 1024, std::chrono::milliseconds(50)), &stats};
+
+  // Exhaust the one-second burst allowance.
+  scheduler.acquire(OverlayIoScheduler::IoClass::CheckoutBulk, 1024 * 1024);
+
+  folly::stop_watch<std::chrono::milliseconds> watch;
+  scheduler.acquire(OverlayIoScheduler::IoClass::CheckoutBulk, 512 * 1024);
+  auto elapsed = watch.elapsed();
+  EXPECT_GE(elapsed, std::chrono::milliseconds(10));
+  // Deadline promotion bounds the wait even though the bucket owes more.
+  EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+}
+
+} // namespace facebook::eden
+
+#endif
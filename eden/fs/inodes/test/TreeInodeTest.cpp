@@ -17,6 +17,7 @@
 #include <optional>
 #include "eden/fs/fuse/DirList.h"
 #include "eden/fs/inodes/FileInode.h"
+#include "eden/fs/inodes/Overlay.h"
 #include "eden/fs/model/Tree.h"
 #include "eden/fs/model/TreeEntry.h"
 #include "eden/fs/nfs/DirList.h"
@@ -416,6 +417,29 @@ TEST(TreeInode, createExists) {
 #endif
 }
 
+TEST(TreeInode, enumerationOnlyDirectoriesDeferOverlayWrites) {
+  FakeTreeBuilder builder;
+  builder.setFile("somedir/sub/foo.txt", "test\n");
+  TestMount mount{builder};
+  mount.getEdenConfig().deferUnmaterializedDirSave.setValue(
+      true, ConfigSource::CommandLine, true);
+
+  // Loading an unmaterialized directory only allocates inode numbers in
+  // memory; nothing is written to the overlay.
+  auto sub = mount.getTreeInode("somedir/sub"_relpath);
+  EXPECT_TRUE(mount.getEdenMount()
+                  ->getOverlay()
+                  ->loadOverlayDir(sub->getNodeId())
+                  .empty());
+
+  // Materializing a child writes the directory through.
+  mount.overwriteFile("somedir/sub/foo.txt", "modified\n");
+  EXPECT_FALSE(mount.getEdenMount()
+                   ->getOverlay()
+                   ->loadOverlayDir(sub->getNodeId())
+                   .empty());
+}
+
 #ifndef _WIN32
 
 TEST(TreeInode, createOverlayWriteError) {
@@ -7,7 +7,10 @@
 
 #include "Journal.h"
 #include <folly/logging/xlog.h>
+#include <folly/system/ThreadName.h>
 #include "eden/fs/journal/JournalDelta.h"
+#include "eden/fs/journal/JournalPersistentRing.h"
+#include "eden/fs/journal/JournalShmRing.h"
 
 namespace facebook::eden {
 
@@ -31,23 +34,6 @@ JournalDeltaPtr Journal::DeltaState::frontPtr() noexcept {
   }
 }
 
-void Journal::DeltaState::popFront() {
-  bool isFileChangeEmpty = fileChangeDeltas.empty();
-  bool isHashUpdateEmpty = hashUpdateDeltas.empty();
-  if (!isFileChangeEmpty && !isHashUpdateEmpty) {
-    if (fileChangeDeltas.front().sequenceID <
-        hashUpdateDeltas.front().sequenceID) {
-      fileChangeDeltas.pop_front();
-    } else {
-      hashUpdateDeltas.pop_front();
-    }
-  } else if (!isFileChangeEmpty) {
-    fileChangeDeltas.pop_front();
-  } else if (!isHashUpdateEmpty) {
-    hashUpdateDeltas.pop_front();
-  }
-}
-
 JournalDeltaPtr Journal::DeltaState::backPtr() noexcept {
   bool isFileChangeEmpty = fileChangeDeltas.empty();
   bool isHashUpdateEmpty = hashUpdateDeltas.empty();
@@ -89,6 +75,20 @@ bool Journal::DeltaState::isFileChangeInBack() const {
 }
 
 void Journal::DeltaState::appendDelta(FileChangeJournalDelta&& delta) {
+  // Front-code the new entry against the previous one, restarting whenever
+  // there is no previous entry and every kJournalPathRestartInterval
+  // entries so rebuilding a path only ever walks a bounded distance back.
+  auto fullPath1 =
+      delta.isPath1Valid ? delta.path1().copy() : RelativePath{};
+  if (fileChangeDeltas.empty() ||
+      entriesSinceRestart >= kJournalPathRestartInterval) {
+    delta.frontCodeAgainst(RelativePathPiece{});
+    entriesSinceRestart = 0;
+  } else {
+    delta.frontCodeAgainst(lastFileChangePath1);
+    ++entriesSinceRestart;
+  }
+  lastFileChangePath1 = std::move(fullPath1);
   fileChangeDeltas.emplace_back(std::move(delta));
 }
 
@@ -100,6 +100,66 @@ Journal::Journal(std::shared_ptr<EdenStats> edenStats)
     : edenStats_{std::move(edenStats)} {
   // Add 0 so that this counter shows up in ODS
   edenStats_->increment(&JournalStats::truncatedReads, 0);
+  publisherThread_ = std::thread([this] { publisherThreadLoop(); });
+}
+
+Journal::~Journal() {
+  {
+    std::lock_guard<std::mutex> guard{stagingMutex_};
+    publisherStopped_ = true;
+  }
+  stagingCv_.notify_all();
+  publisherThread_.join();
+}
+
+void Journal::setShmRing(std::unique_ptr<JournalShmRing> shmRing) {
+  shmRing_ = std::move(shmRing);
+}
+
+void Journal::setPersistentRing(std::unique_ptr<JournalPersistentRing> ring) {
+  auto deltaState = deltaState_.lock();
+  // Continue numbering after the recovered watermark so a subscriber's
+  // pre-restart sequence number stays meaningful against this journal.
+  auto recovered = ring->recoveredSequence();
+  if (recovered >= deltaState->nextSequence) {
+    deltaState->nextSequence = recovered + 1;
+  }
+  persistentRing_ = std::move(ring);
+}
+
+void Journal::publishToPersistentRing(const FileChangeJournalDelta& delta) {
+  if (delta.isPath1Valid) {
+    persistentRing_->publish(
+        delta.sequenceID,
+        JournalPersistentRing::RecordKind::FileChange,
+        delta.path1());
+  }
+  if (delta.isPath2Valid) {
+    persistentRing_->publish(
+        delta.sequenceID,
+        JournalPersistentRing::RecordKind::FileChange,
+        delta.path2());
+  }
+}
+
+void Journal::publishToPersistentRing(const RootUpdateJournalDelta& delta) {
+  persistentRing_->publish(
+      delta.sequenceID, JournalPersistentRing::RecordKind::RootUpdate);
+}
+
+void Journal::publishToShmRing(const FileChangeJournalDelta& delta) {
+  if (delta.isPath1Valid) {
+    shmRing_->publish(
+        delta.sequenceID, JournalShmRing::RecordKind::FileChange, delta.path1());
+  }
+  if (delta.isPath2Valid) {
+    shmRing_->publish(
+        delta.sequenceID, JournalShmRing::RecordKind::FileChange, delta.path2());
+  }
+}
+
+void Journal::publishToShmRing(const RootUpdateJournalDelta& delta) {
+  shmRing_->publish(delta.sequenceID, JournalShmRing::RecordKind::RootUpdate);
 }
 
 void Journal::recordCreated(RelativePathPiece fileName) {
@@ -154,24 +214,122 @@ void Journal::recordUncleanPaths(
   addDelta(std::move(delta), std::move(toHash));
 }
 
+template <typename T>
+size_t getPaddingAmountForCount(size_t count) {
+  constexpr size_t numInDequeBuffer = 512 / sizeof(T);
+  constexpr size_t maxBufSize = numInDequeBuffer * sizeof(T);
+  size_t numBufs = (count + numInDequeBuffer - 1) / numInDequeBuffer;
+  size_t padding = folly::goodMallocSize(maxBufSize) - maxBufSize;
+  return padding * numBufs;
+}
+
+template <typename T>
+size_t getPaddingAmount(const std::deque<T>& deltaDeque) {
+  return getPaddingAmountForCount<T>(deltaDeque.size());
+}
+
 void Journal::truncateIfNecessary(DeltaState& deltaState) {
-  while (JournalDeltaPtr front = deltaState.frontPtr()) {
-    if (estimateMemoryUsage(deltaState) <= deltaState.memoryLimit) {
-      break;
+  // Rather than popping entries one at a time - each pop paying for deque
+  // bookkeeping, a stats update, and a recomputation of the fixed overhead -
+  // figure out in one pass over the oldest entries how many must be retired
+  // from each deque, then drop them with two bulk erases and a single stats
+  // adjustment. This keeps the time the deltaState lock is held to a minimum
+  // when the memory limit shrinks or a large burst of changes lands.
+  size_t numFileChanges = 0;
+  size_t numHashUpdates = 0;
+  size_t remainingFileChanges = deltaState.fileChangeDeltas.size();
+  size_t remainingHashUpdates = deltaState.hashUpdateDeltas.size();
+  size_t deltaUsage = deltaState.stats ? deltaState.deltaMemoryUsage : 0;
+  const size_t fixedUsage = folly::goodMallocSize(sizeof(Journal));
+
+  auto currentUsage = [&] {
+    return fixedUsage +
+        getPaddingAmountForCount<FileChangeJournalDelta>(
+               remainingFileChanges) +
+        getPaddingAmountForCount<RootUpdateJournalDelta>(
+               remainingHashUpdates) +
+        deltaUsage;
+  };
+
+  while ((remainingFileChanges + remainingHashUpdates) != 0 &&
+         currentUsage() > deltaState.memoryLimit) {
+    // Retire the entry with the oldest sequence number next, exactly as
+    // repeated popFront() calls would have.
+    bool takeFileChange;
+    if (remainingFileChanges != 0 && remainingHashUpdates != 0) {
+      takeFileChange = deltaState.fileChangeDeltas[numFileChanges].sequenceID <
+          deltaState.hashUpdateDeltas[numHashUpdates].sequenceID;
+    } else {
+      takeFileChange = remainingFileChanges != 0;
     }
-    deltaState.stats->entryCount--;
 
-    deltaState.deltaMemoryUsage -= front.estimateMemoryUsage();
-    deltaState.popFront();
+    if (takeFileChange) {
+      deltaUsage -=
+          deltaState.fileChangeDeltas[numFileChanges].estimateMemoryUsage();
+      ++numFileChanges;
+      --remainingFileChanges;
+    } else {
+      deltaUsage -=
+          deltaState.hashUpdateDeltas[numHashUpdates].estimateMemoryUsage();
+      ++numHashUpdates;
+      --remainingHashUpdates;
+    }
   }
+
+  if (numFileChanges + numHashUpdates == 0) {
+    return;
+  }
+
+  // The oldest retained file-change entry may be front-coded against an
+  // entry that is about to be dropped; rebuild its full path so the
+  // remaining sequence stays decodable from its front. This can nudge the
+  // usage back above the limit by at most one path, which is not worth a
+  // second pass over the deque.
+  if (numFileChanges > 0 &&
+      remainingFileChanges > 0 &&
+      deltaState.fileChangeDeltas[numFileChanges].isFrontCoded()) {
+    size_t restart = numFileChanges;
+    while (deltaState.fileChangeDeltas[restart].isFrontCoded()) {
+      XDCHECK_GT(restart, 0u);
+      --restart;
+    }
+    auto path =
+        deltaState.fileChangeDeltas[restart].decodePath1(RelativePathPiece{});
+    for (size_t i = restart + 1; i <= numFileChanges; ++i) {
+      path = deltaState.fileChangeDeltas[i].decodePath1(path);
+    }
+    auto& anchor = deltaState.fileChangeDeltas[numFileChanges];
+    deltaUsage -= anchor.estimateMemoryUsage();
+    anchor.restoreFullPath1(std::move(path));
+    deltaUsage += anchor.estimateMemoryUsage();
+  }
+
+  // The cached accumulation may have been built from entries that are being
+  // dropped; a later call for a now-truncated range must report truncation
+  // rather than serving stale data.
+  deltaState.cachedRange.reset();
+
+  auto& fileChangeDeltas = deltaState.fileChangeDeltas;
+  fileChangeDeltas.erase(
+      fileChangeDeltas.begin(), fileChangeDeltas.begin() + numFileChanges);
+  auto& hashUpdateDeltas = deltaState.hashUpdateDeltas;
+  hashUpdateDeltas.erase(
+      hashUpdateDeltas.begin(), hashUpdateDeltas.begin() + numHashUpdates);
+  deltaState.stats->entryCount -= numFileChanges + numHashUpdates;
+  deltaState.deltaMemoryUsage = deltaUsage;
 }
 
 bool Journal::compact(FileChangeJournalDelta& delta, DeltaState& deltaState) {
   auto back = deltaState.backPtr().getAsFileChangeJournalDelta();
-  if (back && delta.isModification() && delta.isSameAction(*back)) {
+  if (back && delta.isModification() &&
+      delta.isSameAction(
+          *back, delta.path1(), deltaState.lastFileChangePath1)) {
     deltaState.stats->latestTimestamp = delta.time;
     deltaState.deltaMemoryUsage -= back->estimateMemoryUsage();
     deltaState.deltaMemoryUsage += delta.estimateMemoryUsage();
+    // The replacement has not been front-coded, so the back entry becomes a
+    // restart; that is always safe, and lastFileChangePath1 already matches
+    // its path since the actions compared equal.
     *back = std::move(delta);
     return true;
   }
@@ -189,6 +347,13 @@ bool Journal::addDeltaBeforeNotifying(T&& delta, DeltaState& deltaState) {
   delta.sequenceID = deltaState.nextSequence++;
   delta.time = std::chrono::steady_clock::now();
 
+  if (shmRing_) {
+    publishToShmRing(delta);
+  }
+  if (persistentRing_) {
+    publishToPersistentRing(delta);
+  }
+
   truncateIfNecessary(deltaState);
 
   // We will compact the delta if possible. We can compact the delta if it is
@@ -205,14 +370,16 @@ bool Journal::addDeltaBeforeNotifying(T&& delta, DeltaState& deltaState) {
   if (!compact(delta, deltaState)) {
     if (deltaState.stats) {
       ++(deltaState.stats->entryCount);
-      deltaState.deltaMemoryUsage += delta.estimateMemoryUsage();
     } else {
       deltaState.stats = InternalJournalStats();
       deltaState.stats->entryCount = 1;
-      deltaState.deltaMemoryUsage = delta.estimateMemoryUsage();
+      deltaState.deltaMemoryUsage = 0;
     }
     deltaState.stats->latestTimestamp = delta.time;
     deltaState.appendDelta(std::forward<T>(delta));
+    // Measure after appending, so that the tracked usage reflects the
+    // front-coded storage rather than the full paths the entry carried in.
+    deltaState.deltaMemoryUsage += deltaState.backPtr().estimateMemoryUsage();
   }
 
   deltaState.stats->earliestTimestamp = deltaState.frontPtr()->time;
@@ -222,43 +389,207 @@ bool Journal::addDeltaBeforeNotifying(T&& delta, DeltaState& deltaState) {
   return shouldNotify;
 }
 
-void Journal::notifySubscribers() const {
-  auto subscribers = subscriberState_.rlock()->subscribers;
-  for (auto& sub : subscribers) {
-    sub.second();
+namespace {
+bool anyPrefixMatches(
+    const std::vector<RelativePath>& prefixes,
+    const std::vector<RelativePath>& changedPaths) {
+  for (const auto& prefix : prefixes) {
+    for (const auto& path : changedPaths) {
+      if (path == prefix || prefix.isParentDirOf(path)) {
+        return true;
+      }
+    }
   }
+  return false;
 }
+} // namespace
 
-void Journal::addDelta(FileChangeJournalDelta&& delta) {
-  bool shouldNotify;
+void Journal::notifySubscribers(
+    bool startNewCycle,
+    const std::vector<RelativePath>* changedPaths) {
+  // Copy the matching callbacks out so subscribers may call back into
+  // cancelSubscriber() without deadlocking.
+  std::vector<SubscriberCallback> toNotify;
   {
-    auto deltaState = deltaState_.lock();
-    shouldNotify = addDeltaBeforeNotifying(std::move(delta), *deltaState);
+    auto subscriberState = subscriberState_.wlock();
+    for (auto& entry : subscriberState->subscribers) {
+      auto& subscriber = entry.second;
+      if (startNewCycle) {
+        subscriber.notificationPending = false;
+      }
+      if (subscriber.notificationPending) {
+        continue;
+      }
+      if (!changedPaths || subscriber.prefixes.empty() ||
+          anyPrefixMatches(subscriber.prefixes, *changedPaths)) {
+        subscriber.notificationPending = true;
+        toNotify.push_back(subscriber.callback);
+      }
+    }
   }
-  if (shouldNotify) {
-    notifySubscribers();
+  for (auto& callback : toNotify) {
+    callback();
   }
 }
 
+void Journal::addDelta(FileChangeJournalDelta&& delta) {
+  stageChange(StagedChange{std::move(delta)});
+}
+
 void Journal::addDelta(RootUpdateJournalDelta&& delta, RootId newRootId) {
-  bool shouldNotify;
+  stageChange(
+      StagedChange{StagedRootUpdate{std::move(delta), std::move(newRootId)}});
+}
+
+void Journal::stageChange(StagedChange&& change) {
+  size_t stagedCount;
+  {
+    std::lock_guard<std::mutex> guard{stagingMutex_};
+    stagedChanges_.push_back(std::move(change));
+    stagedCount = stagedChanges_.size();
+  }
+  stagingCv_.notify_all();
+
+  if (stagedCount >= kMaxStagedChanges) {
+    drainStagedChanges();
+  }
+}
+
+void Journal::drainStagedChanges() {
+  // Serialize whole drains: a competing drain that swapped out a newer
+  // batch must not merge it before this batch. Recording threads never
+  // take this mutex, so staging stays cheap.
+  std::lock_guard<std::mutex> drainGuard{drainMutex_};
+
+  std::vector<StagedChange> batch;
+  {
+    std::lock_guard<std::mutex> guard{stagingMutex_};
+    batch.swap(stagedChanges_);
+  }
+  if (batch.empty()) {
+    return;
+  }
+
+  const bool haveFilteredSubscribers =
+      filteredSubscriberCount_.load(std::memory_order_acquire) > 0;
+  std::vector<PendingNotification> notifications;
   {
     auto deltaState = deltaState_.lock();
+    for (auto& change : batch) {
+      if (auto* fileChange = std::get_if<FileChangeJournalDelta>(&change)) {
+        // The delta is moved into the journal below, so copy out the paths
+        // that prefix-filtered subscribers will be matched against. Skip
+        // the copies when no filters are registered.
+        std::vector<RelativePath> changedPaths;
+        if (haveFilteredSubscribers) {
+          if (fileChange->isPath1Valid) {
+            changedPaths.push_back(fileChange->path1().copy());
+          }
+          if (fileChange->isPath2Valid) {
+            changedPaths.push_back(fileChange->path2().copy());
+          }
+        }
+        bool shouldNotify =
+            addDeltaBeforeNotifying(std::move(*fileChange), *deltaState);
+        // Even when this modification has been coalesced, a
+        // prefix-filtered subscriber may have been skipped earlier in the
+        // batch and still be owed a wakeup for this delta.
+        if (shouldNotify || haveFilteredSubscribers) {
+          notifications.push_back(PendingNotification{
+              shouldNotify,
+              /*matchesAllPrefixes=*/false,
+              std::move(changedPaths)});
+        }
+      } else {
+        auto& update = std::get<StagedRootUpdate>(change);
+        // If the hashes were not set to anything, default to copying
+        // the value from the prior journal entry
+        if (update.delta.fromHash == RootId{}) {
+          update.delta.fromHash = deltaState->currentHash;
+        }
+        bool shouldNotify =
+            addDeltaBeforeNotifying(std::move(update.delta), *deltaState);
+        deltaState->currentHash = std::move(update.newRootId);
+        if (shouldNotify || haveFilteredSubscribers) {
+          notifications.push_back(PendingNotification{
+              shouldNotify, /*matchesAllPrefixes=*/true, {}});
+        }
+      }
+    }
+  }
 
-    // If the hashes were not set to anything, default to copying
-    // the value from the prior journal entry
-    if (delta.fromHash == RootId{}) {
-      delta.fromHash = deltaState->currentHash;
+  if (persistentRing_) {
+    // One fsync covers the whole merged batch; drainMutex_ serializes this
+    // with other drains.
+    persistentRing_->sync();
+  }
+
+  if (!notifications.empty()) {
+    {
+      std::lock_guard<std::mutex> guard{stagingMutex_};
+      pendingNotifications_.insert(
+          pendingNotifications_.end(),
+          std::make_move_iterator(notifications.begin()),
+          std::make_move_iterator(notifications.end()));
     }
-    shouldNotify = addDeltaBeforeNotifying(std::move(delta), *deltaState);
-    deltaState->currentHash = std::move(newRootId);
+    // Wake the publisher thread to run them; notifications always run
+    // there, even when a reader performed the merge.
+    stagingCv_.notify_all();
   }
-  if (shouldNotify) {
-    notifySubscribers();
+}
+
+void Journal::publisherThreadLoop() {
+  folly::setThreadName("JournalPublish");
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock{stagingMutex_};
+      stagingCv_.wait(lock, [&] {
+        return publisherStopped_ || !stagedChanges_.empty() ||
+            !pendingNotifications_.empty();
+      });
+      if (publisherStopped_ && stagedChanges_.empty() &&
+          pendingNotifications_.empty()) {
+        return;
+      }
+    }
+
+    drainStagedChanges();
+
+    std::vector<PendingNotification> notifications;
+    {
+      std::lock_guard<std::mutex> guard{stagingMutex_};
+      notifications.swap(pendingNotifications_);
+      if (!notifications.empty()) {
+        notificationsInFlight_ = true;
+      }
+    }
+    if (!notifications.empty()) {
+      for (auto& notification : notifications) {
+        notifySubscribers(
+            notification.startNewCycle,
+            notification.matchesAllPrefixes ? nullptr
+                                            : &notification.changedPaths);
+      }
+      {
+        std::lock_guard<std::mutex> guard{stagingMutex_};
+        notificationsInFlight_ = false;
+      }
+      stagingCv_.notify_all();
+    }
   }
 }
 
+void Journal::waitForPublishedChanges() {
+  drainStagedChanges();
+  std::unique_lock<std::mutex> lock{stagingMutex_};
+  stagingCv_.wait(lock, [&] {
+    return stagedChanges_.empty() && pendingNotifications_.empty() &&
+        !notificationsInFlight_;
+  });
+}
+
 std::optional<JournalDeltaInfo> Journal::getLatest() {
+  drainStagedChanges();
   auto deltaState = deltaState_.lock();
   deltaState->lastModificationHasBeenObserved = true;
   if (deltaState->empty()) {
@@ -279,10 +610,26 @@ std::optional<JournalDeltaInfo> Journal::getLatest() {
   }
 }
 
+Journal::SequenceNumber Journal::getLatestSequenceID() {
+  drainStagedChanges();
+  auto deltaState = deltaState_.lock();
+  return deltaState->nextSequence - 1;
+}
+
 uint64_t Journal::registerSubscriber(SubscriberCallback&& callback) {
+  return registerSubscriber({}, std::move(callback));
+}
+
+uint64_t Journal::registerSubscriber(
+    std::vector<RelativePath> prefixes,
+    SubscriberCallback&& callback) {
   auto subscriberState = subscriberState_.wlock();
   auto id = subscriberState->nextSubscriberId++;
-  subscriberState->subscribers[id] = std::move(callback);
+  if (!prefixes.empty()) {
+    filteredSubscriberCount_.fetch_add(1, std::memory_order_release);
+  }
+  subscriberState->subscribers[id] =
+      Subscriber{std::move(callback), std::move(prefixes)};
   return id;
 }
 
@@ -293,19 +640,23 @@ void Journal::cancelSubscriber(uint64_t id) {
     return;
   }
   // Extend the lifetime of the value we're removing
-  auto callback = std::move(it->second);
+  auto subscriber = std::move(it->second);
   subscriberState->subscribers.erase(it);
+  if (!subscriber.prefixes.empty()) {
+    filteredSubscriberCount_.fetch_sub(1, std::memory_order_release);
+  }
   // release the lock before we trigger the destructor
   subscriberState.unlock();
-  // callback can now run its destructor outside the lock
+  // the subscriber's callback can now run its destructor outside the lock
 }
 
 void Journal::cancelAllSubscribers() {
   // Take care: some subscribers will attempt to call cancelSubscriber()
   // as part of their tear down, so we need to make sure that we aren't
   // holding the lock when we trigger that.
-  std::unordered_map<SubscriberId, SubscriberCallback> subscribers;
+  std::unordered_map<SubscriberId, Subscriber> subscribers;
   subscriberState_.wlock()->subscribers.swap(subscribers);
+  filteredSubscriberCount_.store(0, std::memory_order_release);
   subscribers.clear();
 }
 
@@ -316,6 +667,7 @@ bool Journal::isSubscriberValid(uint64_t id) const {
 }
 
 std::optional<InternalJournalStats> Journal::getStats() {
+  drainStagedChanges();
   return deltaState_.lock()->stats;
 }
 
@@ -343,20 +695,11 @@ size_t Journal::getMemoryLimit() const {
   return deltaState->memoryLimit;
 }
 
-size_t Journal::estimateMemoryUsage() const {
+size_t Journal::estimateMemoryUsage() {
+  drainStagedChanges();
   return estimateMemoryUsage(*deltaState_.lock());
 }
 
-template <typename T>
-size_t getPaddingAmount(const std::deque<T>& deltaDeque) {
-  constexpr size_t numInDequeBuffer = 512 / sizeof(T);
-  constexpr size_t maxBufSize = numInDequeBuffer * sizeof(T);
-  size_t numBufs =
-      (deltaDeque.size() + numInDequeBuffer - 1) / numInDequeBuffer;
-  size_t padding = folly::goodMallocSize(maxBufSize) - maxBufSize;
-  return padding * numBufs;
-}
-
 size_t Journal::estimateMemoryUsage(const DeltaState& deltaState) const {
   size_t memoryUsage = folly::goodMallocSize(sizeof(Journal));
   // Account for overhead of deques which have a maximum buffer size of 512.
@@ -370,7 +713,14 @@ size_t Journal::estimateMemoryUsage(const DeltaState& deltaState) const {
 }
 
 void Journal::flush() {
+  // Merge any staged-but-unpublished changes first so they are cleared
+  // along with everything else.
+  drainStagedChanges();
   bool shouldNotify;
+  // Hold the drain mutex across the delta and the ring sync below: every
+  // other ring access happens under it (inside drainStagedChanges), so this
+  // keeps the rings strictly single-writer.
+  std::lock_guard<std::mutex> drainGuard{drainMutex_};
   {
     auto deltaState = deltaState_.lock();
     ++deltaState->nextSequence;
@@ -378,6 +728,7 @@ void Journal::flush() {
     deltaState->fileChangeDeltas.clear();
     deltaState->hashUpdateDeltas.clear();
     deltaState->stats = std::nullopt;
+    deltaState->cachedRange.reset();
     auto delta = RootUpdateJournalDelta();
     /* Tracking the hash correctly when the journal is flushed is important
      * since Watchman uses the hash to correctly determine what additional files
@@ -389,14 +740,26 @@ void Journal::flush() {
     delta.fromHash = lastHash;
     shouldNotify = addDeltaBeforeNotifying(std::move(delta), *deltaState);
   }
-  if (shouldNotify) {
-    notifySubscribers();
+  if (persistentRing_) {
+    persistentRing_->sync();
+  }
+  if (shouldNotify ||
+      filteredSubscriberCount_.load(std::memory_order_acquire) > 0) {
+    // Queue the wakeup for the publisher thread like any other
+    // notification rather than invoking subscribers from here.
+    {
+      std::lock_guard<std::mutex> guard{stagingMutex_};
+      pendingNotifications_.push_back(
+          PendingNotification{shouldNotify, /*matchesAllPrefixes=*/true, {}});
+    }
+    stagingCv_.notify_all();
   }
 }
 
 std::unique_ptr<JournalDeltaRange> Journal::accumulateRange(
     SequenceNumber from) {
   XDCHECK(from > 0);
+  drainStagedChanges();
   std::unique_ptr<JournalDeltaRange> result = nullptr;
 
   size_t filesAccumulated = 0;
@@ -406,11 +769,22 @@ std::unique_ptr<JournalDeltaRange> Journal::accumulateRange(
     result = std::make_unique<JournalDeltaRange>();
     result->isTruncated = true;
   } else {
+    // If the last accumulation started from the same sequence number, only
+    // the deltas recorded since its toSequence need to be merged on top of
+    // it; the merge below then sees just that suffix.
+    const bool extendingCachedRange =
+        deltaState->cachedRange && deltaState->cachedRangeFrom == from;
+    const SequenceNumber mergeFrom = extendingCachedRange
+        ? deltaState->cachedRange->toSequence + 1
+        : from;
+
     forEachDelta(
         *deltaState,
-        from,
+        mergeFrom,
         std::nullopt,
-        [&](const FileChangeJournalDelta& current) -> void {
+        [&](const FileChangeJournalDelta& current,
+            RelativePathPiece path1,
+            RelativePathPiece path2) -> void {
           ++filesAccumulated;
           if (!result) {
             result = std::make_unique<JournalDeltaRange>();
@@ -422,7 +796,7 @@ std::unique_ptr<JournalDeltaRange> Journal::accumulateRange(
           result->fromSequence = current.sequenceID;
           result->fromTime = current.time;
 
-          for (auto& entry : current.getChangedFilesInOverlay()) {
+          for (auto& entry : current.getChangedFilesInOverlay(path1, path2)) {
             auto& name = entry.first;
             auto& currentInfo = entry.second;
             auto* resultInfo =
@@ -457,6 +831,52 @@ std::unique_ptr<JournalDeltaRange> Journal::accumulateRange(
           result->uncleanPaths.insert(
               current.uncleanPaths.begin(), current.uncleanPaths.end());
         });
+
+    if (result) {
+      std::reverse(
+          result->snapshotTransitions.begin(),
+          result->snapshotTransitions.end());
+    }
+
+    if (extendingCachedRange) {
+      auto& cached = deltaState->cachedRange;
+      if (result) {
+        // Merge the freshly accumulated suffix over the cached range. The
+        // suffix is strictly newer, so existedBefore state comes from the
+        // cached side and existedAfter from the suffix.
+        cached->toSequence = result->toSequence;
+        cached->toTime = result->toTime;
+        // The cached transition list ends with the snapshot hash as of its
+        // toSequence, which is exactly where the suffix's list begins.
+        XDCHECK(!cached->snapshotTransitions.empty());
+        cached->snapshotTransitions.pop_back();
+        cached->snapshotTransitions.insert(
+            cached->snapshotTransitions.end(),
+            result->snapshotTransitions.begin(),
+            result->snapshotTransitions.end());
+        for (const auto& [name, currentInfo] : result->changedFilesInOverlay) {
+          auto* cachedInfo =
+              folly::get_ptr(cached->changedFilesInOverlay, name);
+          if (!cachedInfo) {
+            cached->changedFilesInOverlay.emplace(name, currentInfo);
+          } else {
+            if (cachedInfo->existedAfter != currentInfo.existedBefore) {
+              auto event1 = eventCharacterizationFor(*cachedInfo);
+              auto event2 = eventCharacterizationFor(currentInfo);
+              XLOG(ERR) << "Journal for " << name << " holds invalid "
+                        << event1 << ", " << event2 << " sequence";
+            }
+            cachedInfo->existedAfter = currentInfo.existedAfter;
+          }
+        }
+        cached->uncleanPaths.insert(
+            result->uncleanPaths.begin(), result->uncleanPaths.end());
+      }
+      result = cached->clone();
+    } else if (result) {
+      deltaState->cachedRange = result->clone();
+      deltaState->cachedRangeFrom = from;
+    }
   }
 
   if (result) {
@@ -470,20 +890,127 @@ std::unique_ptr<JournalDeltaRange> Journal::accumulateRange(
       deltaState->stats->maxFilesAccumulated =
           std::max(deltaState->stats->maxFilesAccumulated, filesAccumulated);
     }
-
-    std::reverse(
-        result->snapshotTransitions.begin(), result->snapshotTransitions.end());
   }
 
   deltaState->lastModificationHasBeenObserved = true;
   return result;
 }
 
+std::unique_ptr<JournalDeltaRange> Journal::accumulateRange(
+    SequenceNumber from,
+    SequenceNumber through) {
+  XDCHECK(from > 0);
+  drainStagedChanges();
+  std::unique_ptr<JournalDeltaRange> result = nullptr;
+
+  size_t filesAccumulated = 0;
+  auto deltaState = deltaState_.lock();
+  // If this is going to be truncated, handle it before iterating.
+  if (!deltaState->empty() && deltaState->getFrontSequenceID() > from) {
+    result = std::make_unique<JournalDeltaRange>();
+    result->isTruncated = true;
+  } else {
+    // The snapshot hash as of `through`. forEachDelta walks newest to
+    // oldest, so every root update newer than the bound moves this back to
+    // that update's fromHash before any bounded delta is merged.
+    RootId endHash = deltaState->currentHash;
+
+    forEachDelta(
+        *deltaState,
+        from,
+        std::nullopt,
+        [&](const FileChangeJournalDelta& current,
+            RelativePathPiece path1,
+            RelativePathPiece path2) -> void {
+          if (current.sequenceID > through) {
+            return;
+          }
+          ++filesAccumulated;
+          if (!result) {
+            result = std::make_unique<JournalDeltaRange>();
+            result->toSequence = current.sequenceID;
+            result->toTime = current.time;
+            result->snapshotTransitions.push_back(endHash);
+          }
+          // Capture the lower bound.
+          result->fromSequence = current.sequenceID;
+          result->fromTime = current.time;
+
+          for (auto& entry : current.getChangedFilesInOverlay(path1, path2)) {
+            auto& name = entry.first;
+            auto& currentInfo = entry.second;
+            auto* resultInfo =
+                folly::get_ptr(result->changedFilesInOverlay, name);
+            if (!resultInfo) {
+              result->changedFilesInOverlay.emplace(name, currentInfo);
+            } else {
+              if (resultInfo->existedBefore != currentInfo.existedAfter) {
+                auto event1 = eventCharacterizationFor(currentInfo);
+                auto event2 = eventCharacterizationFor(*resultInfo);
+                XLOG(ERR) << "Journal for " << name << " holds invalid "
+                          << event1 << ", " << event2 << " sequence";
+              }
+
+              resultInfo->existedBefore = currentInfo.existedBefore;
+            }
+          }
+        },
+        [&](const RootUpdateJournalDelta& current) -> void {
+          if (current.sequenceID > through) {
+            endHash = current.fromHash;
+            return;
+          }
+          if (!result) {
+            result = std::make_unique<JournalDeltaRange>();
+            result->toSequence = current.sequenceID;
+            result->toTime = current.time;
+            result->snapshotTransitions.push_back(endHash);
+          }
+          // Capture the lower bound.
+          result->fromSequence = current.sequenceID;
+          result->fromTime = current.time;
+          result->snapshotTransitions.push_back(current.fromHash);
+
+          // Merge the unclean status list
+          result->uncleanPaths.insert(
+              current.uncleanPaths.begin(), current.uncleanPaths.end());
+        });
+
+    if (result) {
+      std::reverse(
+          result->snapshotTransitions.begin(),
+          result->snapshotTransitions.end());
+    }
+  }
+
+  if (result) {
+    if (edenStats_) {
+      if (result->isTruncated) {
+        edenStats_->increment(&JournalStats::truncatedReads);
+      }
+      edenStats_->increment(&JournalStats::filesAccumulated, filesAccumulated);
+    }
+    if (deltaState->stats) {
+      deltaState->stats->maxFilesAccumulated =
+          std::max(deltaState->stats->maxFilesAccumulated, filesAccumulated);
+    }
+  }
+
+  // A bounded read that stops short of the tip has not observed the most
+  // recent modifications, so it must not suppress subscriber notifications
+  // for them.
+  if (through + 1 >= deltaState->nextSequence) {
+    deltaState->lastModificationHasBeenObserved = true;
+  }
+  return result;
+}
+
 std::vector<DebugJournalDelta> Journal::getDebugRawJournalInfo(
     SequenceNumber from,
     std::optional<size_t> limit,
     long mountGeneration,
-    RootIdCodec& rootIdCodec) const {
+    RootIdCodec& rootIdCodec) {
+  drainStagedChanges();
   auto result = std::vector<DebugJournalDelta>();
   auto deltaState = deltaState_.lock();
   RootId currentHash = deltaState->currentHash;
@@ -491,7 +1018,9 @@ std::vector<DebugJournalDelta> Journal::getDebugRawJournalInfo(
       *deltaState,
       from,
       limit,
-      [&](const FileChangeJournalDelta& current) -> void {
+      [&](const FileChangeJournalDelta& current,
+          RelativePathPiece path1,
+          RelativePathPiece path2) -> void {
         DebugJournalDelta delta;
         JournalPosition fromPosition;
         fromPosition.mountGeneration_ref() = mountGeneration;
@@ -505,7 +1034,7 @@ std::vector<DebugJournalDelta> Journal::getDebugRawJournalInfo(
         toPosition.snapshotHash_ref() = rootIdCodec.renderRootId(currentHash);
         delta.toPosition_ref() = toPosition;
 
-        for (const auto& entry : current.getChangedFilesInOverlay()) {
+        for (const auto& entry : current.getChangedFilesInOverlay(path1, path2)) {
           auto& path = entry.first;
           auto& changeInfo = entry.second;
 
@@ -543,7 +1072,9 @@ std::vector<DebugJournalDelta> Journal::getDebugRawJournalInfo(
 }
 
 /**
- * FileChangeFunc: void(const FileChangeJournalDelta&)
+ * FileChangeFunc: void(const FileChangeJournalDelta&,
+ *                      RelativePathPiece path1,
+ *                      RelativePathPiece path2)
  * HashUpdateFunc: void(const RootUpdateJournalDelta&)
  */
 template <class FileChangeFunc, class HashUpdateFunc>
@@ -554,16 +1085,45 @@ void Journal::forEachDelta(
     FileChangeFunc&& fileChangeDeltaCallback,
     HashUpdateFunc&& hashUpdateDeltaCallback) const {
   size_t iters = 0;
-  auto fileChangeIt = deltaState.fileChangeDeltas.rbegin();
+  const auto& fileChangeDeltas = deltaState.fileChangeDeltas;
+  size_t fileChangeIdx = fileChangeDeltas.size();
   auto hashUpdateIt = deltaState.hashUpdateDeltas.rbegin();
-  auto fileChangeRend = deltaState.fileChangeDeltas.rend();
   auto hashUpdateRend = deltaState.hashUpdateDeltas.rend();
-  while (fileChangeIt != fileChangeRend || hashUpdateIt != hashUpdateRend) {
+
+  // Decoded first paths for the restart segment containing the entry
+  // currently being visited. The walk runs newest to oldest, so each
+  // segment is decoded once, front to back, when the walk first enters it;
+  // the per-segment memory is bounded by kJournalPathRestartInterval paths.
+  size_t segmentStart = 0;
+  std::vector<RelativePath> segmentPaths;
+  auto decodedPath1 = [&](size_t index) -> const RelativePath& {
+    if (segmentPaths.empty() || index < segmentStart ||
+        index - segmentStart >= segmentPaths.size()) {
+      size_t restart = index;
+      while (fileChangeDeltas[restart].isFrontCoded()) {
+        XDCHECK_GT(restart, 0u);
+        --restart;
+      }
+      segmentPaths.clear();
+      segmentPaths.push_back(
+          fileChangeDeltas[restart].decodePath1(RelativePathPiece{}));
+      for (size_t i = restart + 1; i <= index; ++i) {
+        segmentPaths.push_back(
+            fileChangeDeltas[i].decodePath1(segmentPaths.back()));
+      }
+      segmentStart = restart;
+    }
+    return segmentPaths[index - segmentStart];
+  };
+
+  while (fileChangeIdx != 0 || hashUpdateIt != hashUpdateRend) {
     bool isFileChange = hashUpdateIt == hashUpdateRend ||
-        (fileChangeIt != fileChangeRend &&
-         fileChangeIt->sequenceID > hashUpdateIt->sequenceID);
-    const Journal::SequenceNumber currentSequenceID =
-        isFileChange ? fileChangeIt->sequenceID : hashUpdateIt->sequenceID;
+        (fileChangeIdx != 0 &&
+         fileChangeDeltas[fileChangeIdx - 1].sequenceID >
+             hashUpdateIt->sequenceID);
+    const Journal::SequenceNumber currentSequenceID = isFileChange
+        ? fileChangeDeltas[fileChangeIdx - 1].sequenceID
+        : hashUpdateIt->sequenceID;
     if (currentSequenceID < from) {
       break;
     }
@@ -571,8 +1131,12 @@ void Journal::forEachDelta(
       break;
     }
     if (isFileChange) {
-      fileChangeDeltaCallback(*fileChangeIt);
-      ++fileChangeIt;
+      --fileChangeIdx;
+      const auto& current = fileChangeDeltas[fileChangeIdx];
+      const auto& path1 = decodedPath1(fileChangeIdx);
+      auto path2 = current.isPath2Valid ? current.decodePath2(path1)
+                                        : RelativePath{};
+      fileChangeDeltaCallback(current, path1.piece(), path2.piece());
     } else {
       hashUpdateDeltaCallback(*hashUpdateIt);
       ++hashUpdateIt;
@@ -10,10 +10,16 @@
 #include <folly/Function.h>
 #include <folly/Synchronized.h>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <thread>
 #include <unordered_map>
+#include <variant>
+#include <vector>
 #include "eden/fs/journal/JournalDelta.h"
 #include "eden/fs/model/RootId.h"
 #include "eden/fs/service/gen-cpp2/streamingeden_types.h"
@@ -21,6 +27,9 @@
 
 namespace facebook::eden {
 
+class JournalPersistentRing;
+class JournalShmRing;
+
 /** Contains statistics about the current state of the journal */
 struct InternalJournalStats {
   size_t entryCount = 0;
@@ -54,8 +63,15 @@ struct JournalDeltaInfo {
  * revisions (the prior and new revision hash) from which we can derive
  * the larger list of files.
  *
- * The Journal class is thread-safe.  Subscribers are called on the thread
- * that called addDelta.
+ * The Journal class is thread-safe.
+ *
+ * Recording a change stages a compact record and returns without touching
+ * the journal's main state, so the filesystem threads that complete writes
+ * never wait behind an in-progress merge or subscriber callback. A
+ * background publisher thread merges staged records into the journal and
+ * invokes subscribers; readers merge any still-staged records before
+ * answering, so a query issued after a record call always sees it.
+ * Subscribers are called on the publisher thread.
  */
 class Journal {
  public:
@@ -64,10 +80,28 @@ class Journal {
   using SubscriberCallback = std::function<void()>;
 
   explicit Journal(std::shared_ptr<EdenStats> edenStats);
+  ~Journal();
 
   Journal(const Journal&) = delete;
   Journal& operator=(const Journal&) = delete;
 
+  /**
+   * Attaches a shared-memory ring that every recorded delta is mirrored
+   * into, so external subscribers can follow the journal without a Thrift
+   * round trip. Must be called during mount setup, before any deltas are
+   * recorded.
+   */
+  void setShmRing(std::unique_ptr<JournalShmRing> shmRing);
+
+  /**
+   * Attaches a durable ring that every recorded delta is written to, with
+   * one fsync per merged batch. Sequence numbering resumes after the
+   * sequence recovered from the ring, so subscribers holding a pre-restart
+   * sequence number can resume instead of recrawling. Must be called
+   * during mount setup, before any deltas are recorded.
+   */
+  void setPersistentRing(std::unique_ptr<JournalPersistentRing> ring);
+
   // Functions to record writes:
 
   void recordCreated(RelativePathPiece fileName);
@@ -112,6 +146,17 @@ class Journal {
    */
   std::optional<JournalDeltaInfo> getLatest();
 
+  /**
+   * Returns the sequence number of the most recently recorded delta, or 0 if
+   * the journal is empty.
+   *
+   * Unlike getLatest(), this does not mark the current tip as observed, so it
+   * has no effect on subscriber notification coalescing. It is intended for
+   * callers that merely want a cheap "has anything changed?" generation
+   * counter, such as the readdir payload cache.
+   */
+  SequenceNumber getLatestSequenceID();
+
   /**
    * Returns an accumulation of all deltas with sequence number >= limitSequence
    * merged. If limitSequence is further back than the Journal remembers,
@@ -124,6 +169,20 @@ class Journal {
   std::unique_ptr<JournalDeltaRange> accumulateRange(
       SequenceNumber limitSequence = 1);
 
+  /**
+   * Like accumulateRange(limitSequence), but only merges deltas with
+   * sequence number <= through, so callers can fold a bounded page of the
+   * journal instead of everything up to the tip. The returned range's
+   * toSequence is a valid resume point: accumulating again from
+   * toSequence + 1 continues exactly where this page stopped.
+   *
+   * Bounded ranges bypass the memoized range cache, which only describes
+   * ranges that extend to the tip.
+   */
+  std::unique_ptr<JournalDeltaRange> accumulateRange(
+      SequenceNumber limitSequence,
+      SequenceNumber through);
+
   // Subscription functionality:
 
   /**
@@ -143,11 +202,38 @@ class Journal {
    * to cancelSubscriber to later remove the registration.
    */
   SubscriberId registerSubscriber(SubscriberCallback&& callback);
+
+  /**
+   * Registers a callback that is only invoked when a recorded change touches
+   * one of the given path prefixes. A file-change delta matches a prefix if
+   * one of its paths equals the prefix or lives under it; root updates and
+   * flushes match every subscriber, since any path may have changed. An empty
+   * prefix list behaves like the unfiltered overload above.
+   *
+   * Notification coalescing is tracked per subscriber: a subscriber that was
+   * skipped because a delta did not match its prefixes is still woken by the
+   * next matching delta, even if other subscribers have already been notified
+   * for the current batch of modifications.
+   */
+  SubscriberId registerSubscriber(
+      std::vector<RelativePath> prefixes,
+      SubscriberCallback&& callback);
+
   void cancelSubscriber(SubscriberId id);
 
   void cancelAllSubscribers();
   bool isSubscriberValid(SubscriberId id) const;
 
+  /**
+   * Blocks until every change recorded so far has been merged into the
+   * journal and its subscriber notifications have finished running.
+   *
+   * Recording and notification are asynchronous; this is the
+   * synchronization point for callers (primarily tests) that need to
+   * observe the subscriber side effects of earlier record calls.
+   */
+  void waitForPublishedChanges();
+
   // Statistics and debugging:
 
   /**
@@ -165,7 +251,7 @@ class Journal {
       SequenceNumber from,
       std::optional<size_t> limit,
       long mountGeneration,
-      RootIdCodec& rootIdCodec) const;
+      RootIdCodec& rootIdCodec);
 
   /** Removes all prior contents from the journal and sets up the journal in a
    * way such that when subscribers are notified they all get truncated results
@@ -176,7 +262,7 @@ class Journal {
 
   size_t getMemoryLimit() const;
 
-  size_t estimateMemoryUsage() const;
+  size_t estimateMemoryUsage();
 
  private:
   /** Add a delta to the journal and notify subscribers.
@@ -188,6 +274,15 @@ class Journal {
 
   static constexpr size_t kDefaultJournalMemoryLimit = 1000000000;
 
+  /**
+   * Number of consecutive front-coded file-change entries between restart
+   * points. Entries are stored as a suffix relative to their predecessor's
+   * first path (see FileChangeJournalDelta::frontCodeAgainst); a restart
+   * entry stores its first path in full, bounding how far a decode has to
+   * walk back and giving truncation a safe place to re-anchor.
+   */
+  static constexpr size_t kJournalPathRestartInterval = 32;
+
   struct DeltaState {
     /**
      * The sequence number that we'll use for the next entry that we link into
@@ -211,8 +306,30 @@ class Journal {
     // If true before calling addDelta, subscribers are notified.
     bool lastModificationHasBeenObserved = true;
 
+    /**
+     * Memoized result of the most recent accumulateRange() call, together
+     * with the `from` sequence number it was computed for. High-frequency
+     * readers like Watchman repeatedly accumulate overlapping ranges from
+     * the same starting point; when the starting point matches, only the
+     * deltas recorded since the cached range's toSequence need to be merged
+     * on top of it. Cleared whenever entries are removed from the journal
+     * (truncation or flush). Its memory is bounded by the size of the answer
+     * handed to the caller, and is not counted against the journal's memory
+     * limit.
+     */
+    std::unique_ptr<JournalDeltaRange> cachedRange;
+    SequenceNumber cachedRangeFrom{0};
+
+    /**
+     * Complete first path of fileChangeDeltas.back(), kept decoded so new
+     * entries can be front-coded against it - and compact() can compare
+     * against it - without walking back to a restart entry.
+     */
+    RelativePath lastFileChangePath1;
+    /** File-change entries appended since the last front-coding restart. */
+    size_t entriesSinceRestart = 0;
+
     JournalDeltaPtr frontPtr() noexcept;
-    void popFront();
     JournalDeltaPtr backPtr() noexcept;
 
     bool empty() const {
@@ -248,9 +365,24 @@ class Journal {
   bool compact(FileChangeJournalDelta& delta, DeltaState& deltaState);
   bool compact(RootUpdateJournalDelta& delta, DeltaState& deltaState);
 
+  struct Subscriber {
+    SubscriberCallback callback;
+    /**
+     * Path prefixes this subscriber cares about. Empty means every change is
+     * relevant.
+     */
+    std::vector<RelativePath> prefixes;
+    /**
+     * True once this subscriber has been woken for the current batch of
+     * modifications. Reset when a reader observes the journal (tracked via
+     * DeltaState::lastModificationHasBeenObserved) and a new delta arrives.
+     */
+    bool notificationPending = false;
+  };
+
   struct SubscriberState {
     SubscriberId nextSubscriberId{1};
-    std::unordered_map<SubscriberId, SubscriberCallback> subscribers;
+    std::unordered_map<SubscriberId, Subscriber> subscribers;
   };
 
   /**
@@ -264,18 +396,45 @@ class Journal {
   template <typename T>
   [[nodiscard]] bool addDeltaBeforeNotifying(T&& delta, DeltaState& deltaState);
 
+  /**
+   * Mirror a freshly sequenced delta into the shared-memory ring, if one is
+   * attached. Called with the deltaState lock held, which serializes the
+   * ring's single writer.
+   */
+  void publishToShmRing(const FileChangeJournalDelta& delta);
+  void publishToShmRing(const RootUpdateJournalDelta& delta);
+
+  /**
+   * Append a freshly sequenced delta to the persistent ring, if one is
+   * attached. Called with the deltaState lock held; durability is deferred
+   * to the per-batch sync in drainStagedChanges().
+   */
+  void publishToPersistentRing(const FileChangeJournalDelta& delta);
+  void publishToPersistentRing(const RootUpdateJournalDelta& delta);
+
   /**
    * Notify subscribers that a change has happened. Must not be called while
    * Journal locks are held.
+   *
+   * `startNewCycle` is true when a reader has observed the journal since the
+   * last notification, meaning every subscriber's pending flag should be
+   * cleared before deciding whom to wake. `changedPaths` holds the paths
+   * touched by the delta that triggered the notification; nullptr means the
+   * change is not attributable to specific paths (root updates, flushes) and
+   * matches every prefix filter.
    */
-  void notifySubscribers() const;
+  void notifySubscribers(
+      bool startNewCycle,
+      const std::vector<RelativePath>* changedPaths);
 
   size_t estimateMemoryUsage(const DeltaState& deltaState) const;
 
   /**
    * Runs from the latest delta to the delta with sequence ID (if 'lengthLimit'
    * is not nullopt then checks at most 'lengthLimit' entries) and runs
-   * deltaActor on each entry encountered.
+   * deltaActor on each entry encountered. File-change entries are handed to
+   * their callback together with their decoded complete paths, since the
+   * stored entries may be front-coded.
    * */
   template <class FileChangeFunc, class HashUpdateFunc>
   void forEachDelta(
@@ -287,6 +446,100 @@ class Journal {
 
   folly::Synchronized<SubscriberState> subscriberState_;
 
+  /**
+   * Number of subscribers registered with a non-empty prefix filter. Checked
+   * on the addDelta path without taking the subscriber lock so that, when no
+   * filters are in use, coalesced modifications skip notification entirely
+   * just as they did before filters existed.
+   */
+  std::atomic<size_t> filteredSubscriberCount_{0};
+
+  /**
+   * Optional shared-memory mirror of the change feed; written under the
+   * deltaState lock. See JournalShmRing.
+   */
+  std::unique_ptr<JournalShmRing> shmRing_;
+
+  /**
+   * Optional durable mirror of the change feed; written under the
+   * deltaState lock and synced once per merged batch. See
+   * JournalPersistentRing.
+   */
+  std::unique_ptr<JournalPersistentRing> persistentRing_;
+
   std::shared_ptr<EdenStats> edenStats_;
+
+  /**
+   * A root update staged for later merging; the new root takes effect when
+   * the record is merged, preserving its order relative to file changes.
+   */
+  struct StagedRootUpdate {
+    RootUpdateJournalDelta delta;
+    RootId newRootId;
+  };
+
+  using StagedChange = std::variant<FileChangeJournalDelta, StagedRootUpdate>;
+
+  /**
+   * A subscriber wakeup owed for an already-merged record. Notifications
+   * always run on the publisher thread, regardless of which thread merged
+   * the record that produced them.
+   */
+  struct PendingNotification {
+    bool startNewCycle;
+    /**
+     * True for changes that match every prefix filter (root updates,
+     * flushes); otherwise changedPaths holds the paths filters are matched
+     * against.
+     */
+    bool matchesAllPrefixes;
+    std::vector<RelativePath> changedPaths;
+  };
+
+  /**
+   * If the staging buffer reaches this many records the recording thread
+   * merges it inline rather than letting it grow further; this bounds the
+   * buffer when the publisher thread falls behind a sustained burst.
+   */
+  static constexpr size_t kMaxStagedChanges = 4096;
+
+  /**
+   * Hand a record to the publisher thread.
+   */
+  void stageChange(StagedChange&& change);
+
+  /**
+   * Merge all staged records into deltaState_, in staging order, and queue
+   * the subscriber notifications they produce. Called by the publisher
+   * thread and by readers that need to observe staged records.
+   */
+  void drainStagedChanges();
+
+  void publisherThreadLoop();
+
+  /**
+   * Serializes concurrent drains so records are always merged in staging
+   * order. Acquired before stagingMutex_ and the deltaState lock; never
+   * held while subscriber callbacks run.
+   */
+  std::mutex drainMutex_;
+
+  /**
+   * Guards stagedChanges_, pendingNotifications_, and the publisher
+   * lifecycle flags below. Recording threads only ever take this mutex,
+   * briefly.
+   */
+  std::mutex stagingMutex_;
+  std::condition_variable stagingCv_;
+  std::vector<StagedChange> stagedChanges_;
+  std::vector<PendingNotification> pendingNotifications_;
+  bool notificationsInFlight_ = false;
+  bool publisherStopped_ = false;
+
+  /**
+   * Declared last so every member it touches is initialized before the
+   * thread starts and still alive when it exits.
+   */
+  std::thread publisherThread_;
 };
 } // namespace facebook::eden
@@ -7,51 +7,124 @@
 
 #include "JournalDelta.h"
 #include <folly/logging/xlog.h>
+#include <algorithm>
 
 namespace facebook::eden {
 
+namespace {
+size_t commonPrefixLength(std::string_view a, std::string_view b) {
+  auto ends = std::mismatch(
+      a.begin(), a.begin() + std::min(a.size(), b.size()), b.begin());
+  return ends.first - a.begin();
+}
+} // namespace
+
 FileChangeJournalDelta::FileChangeJournalDelta(
     RelativePathPiece fileName,
     FileChangeJournalDelta::Created)
-    : path1{fileName.copy()},
-      info1{PathChangeInfo{false, true}},
-      isPath1Valid{true} {}
+    : info1{PathChangeInfo{false, true}},
+      isPath1Valid{true},
+      path1_{fileName.view()} {}
 
 FileChangeJournalDelta::FileChangeJournalDelta(
     RelativePathPiece fileName,
     FileChangeJournalDelta::Removed)
-    : path1{fileName.copy()},
-      info1{PathChangeInfo{true, false}},
-      isPath1Valid{true} {}
+    : info1{PathChangeInfo{true, false}},
+      isPath1Valid{true},
+      path1_{fileName.view()} {}
 
 FileChangeJournalDelta::FileChangeJournalDelta(
     RelativePathPiece fileName,
     FileChangeJournalDelta::Changed)
-    : path1{fileName.copy()},
-      info1{PathChangeInfo{true, true}},
-      isPath1Valid{true} {}
+    : info1{PathChangeInfo{true, true}},
+      isPath1Valid{true},
+      path1_{fileName.view()} {}
 
 FileChangeJournalDelta::FileChangeJournalDelta(
     RelativePathPiece oldName,
     RelativePathPiece newName,
     FileChangeJournalDelta::Renamed)
-    : path1{oldName.copy()},
-      path2{newName.copy()},
-      info1{PathChangeInfo{true, false}},
+    : info1{PathChangeInfo{true, false}},
       info2{PathChangeInfo{false, true}},
       isPath1Valid{true},
-      isPath2Valid{true} {}
+      isPath2Valid{true},
+      path1_{oldName.view()},
+      path2_{newName.view()} {}
 
 FileChangeJournalDelta::FileChangeJournalDelta(
     RelativePathPiece oldName,
     RelativePathPiece newName,
     FileChangeJournalDelta::Replaced)
-    : path1{oldName.copy()},
-      path2{newName.copy()},
-      info1{PathChangeInfo{true, false}},
+    : info1{PathChangeInfo{true, false}},
       info2{PathChangeInfo{true, true}},
       isPath1Valid{true},
-      isPath2Valid{true} {}
+      isPath2Valid{true},
+      path1_{oldName.view()},
+      path2_{newName.view()} {}
+
+RelativePathPiece FileChangeJournalDelta::path1() const {
+  XDCHECK_EQ(prefixLen1_, 0u);
+  return RelativePathPiece{path1_, detail::SkipPathSanityCheck{}};
+}
+
+RelativePathPiece FileChangeJournalDelta::path2() const {
+  XDCHECK_EQ(prefixLen2_, 0u);
+  return RelativePathPiece{path2_, detail::SkipPathSanityCheck{}};
+}
+
+void FileChangeJournalDelta::frontCodeAgainst(RelativePathPiece previousPath1) {
+  XDCHECK(!isFrontCoded());
+  XDCHECK_EQ(prefixLen2_, 0u);
+  // Code path2 first, while path1_ still holds the complete path it is
+  // coded against.
+  if (isPath2Valid) {
+    auto shared = commonPrefixLength(path1_, path2_);
+    if (shared > 0) {
+      path2_.erase(0, shared);
+      path2_.shrink_to_fit();
+      prefixLen2_ = static_cast<uint32_t>(shared);
+    }
+  }
+  if (isPath1Valid) {
+    auto shared = commonPrefixLength(previousPath1.view(), path1_);
+    if (shared > 0) {
+      path1_.erase(0, shared);
+      path1_.shrink_to_fit();
+      prefixLen1_ = static_cast<uint32_t>(shared);
+    }
+  }
+}
+
+RelativePath FileChangeJournalDelta::decodePath1(
+    RelativePathPiece previousPath1) const {
+  if (prefixLen1_ == 0) {
+    return RelativePath{std::string{path1_}, detail::SkipPathSanityCheck{}};
+  }
+  XDCHECK_LE(prefixLen1_, previousPath1.view().size());
+  std::string full;
+  full.reserve(prefixLen1_ + path1_.size());
+  full.append(previousPath1.view().substr(0, prefixLen1_));
+  full.append(path1_);
+  return RelativePath{std::move(full), detail::SkipPathSanityCheck{}};
+}
+
+RelativePath FileChangeJournalDelta::decodePath2(
+    RelativePathPiece ownPath1) const {
+  if (prefixLen2_ == 0) {
+    return RelativePath{std::string{path2_}, detail::SkipPathSanityCheck{}};
+  }
+  XDCHECK_LE(prefixLen2_, ownPath1.view().size());
+  std::string full;
+  full.reserve(prefixLen2_ + path2_.size());
+  full.append(ownPath1.view().substr(0, prefixLen2_));
+  full.append(path2_);
+  return RelativePath{std::move(full), detail::SkipPathSanityCheck{}};
+}
+
+void FileChangeJournalDelta::restoreFullPath1(RelativePath fullPath1) {
+  path1_ = std::move(fullPath1).value();
+  prefixLen1_ = 0;
+}
 
 size_t FileChangeJournalDelta::estimateMemoryUsage() const {
   size_t mem = sizeof(FileChangeJournalDelta);
@@ -61,10 +134,10 @@ size_t FileChangeJournalDelta::estimateMemoryUsage() const {
    * pointer, a key-value pair, and a stored hash
    */
   if (isPath1Valid) {
-    mem += facebook::eden::estimateIndirectMemoryUsage(path1);
+    mem += facebook::eden::estimateIndirectMemoryUsage(path1_);
   }
   if (isPath2Valid) {
-    mem += facebook::eden::estimateIndirectMemoryUsage(path2);
+    mem += facebook::eden::estimateIndirectMemoryUsage(path2_);
   }
 
   return mem;
@@ -98,13 +171,15 @@ size_t RootUpdateJournalDelta::estimateMemoryUsage() const {
 }
 
 std::unordered_map<RelativePath, PathChangeInfo>
-FileChangeJournalDelta::getChangedFilesInOverlay() const {
+FileChangeJournalDelta::getChangedFilesInOverlay(
+    RelativePathPiece path1,
+    RelativePathPiece path2) const {
   std::unordered_map<RelativePath, PathChangeInfo> changedFilesInOverlay;
   if (isPath1Valid) {
-    changedFilesInOverlay[path1] = info1;
+    changedFilesInOverlay[path1.copy()] = info1;
   }
   if (isPath2Valid) {
-    changedFilesInOverlay[path2] = info2;
+    changedFilesInOverlay[path2.copy()] = info2;
   }
   return changedFilesInOverlay;
 }
@@ -115,10 +190,29 @@ bool FileChangeJournalDelta::isModification() const {
 }
 
 bool FileChangeJournalDelta::isSameAction(
-    const FileChangeJournalDelta& other) const {
+    const FileChangeJournalDelta& other,
+    RelativePathPiece thisPath1,
+    RelativePathPiece otherPath1) const {
+  // This is only ever asked of single-path modifications (see
+  // Journal::compact()), so when the validity flags agree there is no
+  // second path to compare.
+  XDCHECK(!isPath2Valid || !other.isPath2Valid);
   return isPath1Valid == other.isPath1Valid && info1 == other.info1 &&
-      path1 == other.path1 && isPath2Valid == other.isPath2Valid &&
-      info2 == other.info2 && path2 == other.path2;
+      thisPath1 == otherPath1 && isPath2Valid == other.isPath2Valid &&
+      info2 == other.info2;
+}
+
+std::unique_ptr<JournalDeltaRange> JournalDeltaRange::clone() const {
+  auto copy = std::make_unique<JournalDeltaRange>();
+  copy->fromSequence = fromSequence;
+  copy->toSequence = toSequence;
+  copy->fromTime = fromTime;
+  copy->toTime = toTime;
+  copy->snapshotTransitions = snapshotTransitions;
+  copy->changedFilesInOverlay = changedFilesInOverlay;
+  copy->uncleanPaths = uncleanPaths;
+  copy->isTruncated = isTruncated;
+  return copy;
 }
 
 JournalDeltaPtr::JournalDeltaPtr(std::nullptr_t) {}
@@ -8,6 +8,9 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <type_traits>
 #include <unordered_set>
 #include <variant>
@@ -96,25 +99,89 @@ class FileChangeJournalDelta : public JournalDelta {
       Replaced);
 
   /** Which of these paths actually contain information */
-  RelativePath path1;
-  RelativePath path2;
   PathChangeInfo info1;
   PathChangeInfo info2;
   bool isPath1Valid = false;
   bool isPath2Valid = false;
 
-  std::unordered_map<RelativePath, PathChangeInfo> getChangedFilesInOverlay()
-      const;
+  /**
+   * The stored paths. Only complete paths while the entry has not been
+   * front-coded; the Journal publishes, compares, and compacts entries
+   * before encoding them, so those callers always see full paths here.
+   */
+  RelativePathPiece path1() const;
+  RelativePathPiece path2() const;
+
+  /**
+   * Replaces the stored paths with front-coded suffixes: path1 keeps only
+   * the bytes following its longest common prefix with previousPath1, and
+   * path2 (when valid) only the bytes following its common prefix with this
+   * entry's own full path1. Called by the Journal when the entry is
+   * appended; entries at segment restarts pass an empty previousPath1 and
+   * keep their complete first path.
+   */
+  void frontCodeAgainst(RelativePathPiece previousPath1);
+
+  /** True once path1 holds only a suffix and needs decodePath1() context. */
+  bool isFrontCoded() const {
+    return prefixLen1_ != 0;
+  }
+
+  /**
+   * Rebuilds the complete first path. previousPath1 is the decoded first
+   * path of the entry this one was front-coded against; it is ignored for
+   * restart entries, which store their first path in full.
+   */
+  RelativePath decodePath1(RelativePathPiece previousPath1) const;
+
+  /** Rebuilds the complete second path from this entry's decoded first
+   * path. Only meaningful when isPath2Valid. */
+  RelativePath decodePath2(RelativePathPiece ownPath1) const;
+
+  /**
+   * Replaces a front-coded first path with its rebuilt complete form,
+   * turning this entry back into a restart. Used when the entry it was
+   * coded against is truncated away.
+   */
+  void restoreFullPath1(RelativePath fullPath1);
+
+  /**
+   * The decoded paths are passed in rather than read from the entry so that
+   * callers iterating front-coded entries resolve them once (see
+   * Journal::forEachDelta).
+   */
+  std::unordered_map<RelativePath, PathChangeInfo> getChangedFilesInOverlay(
+      RelativePathPiece path1,
+      RelativePathPiece path2) const;
 
   /** Checks whether this delta is a modification */
   bool isModification() const;
 
   /** Checks whether this delta and other are the same disregarding time and
-   * sequenceID [whether they do the same action] */
-  bool isSameAction(const FileChangeJournalDelta& other) const;
+   * sequenceID [whether they do the same action]. The first paths are
+   * passed in decoded form so the comparison works on front-coded entries.
+   */
+  bool isSameAction(
+      const FileChangeJournalDelta& other,
+      RelativePathPiece thisPath1,
+      RelativePathPiece otherPath1) const;
 
   /** Get memory used (in bytes) by this Delta */
   size_t estimateMemoryUsage() const;
+
+ private:
+  /**
+   * Path storage. When prefixLenN_ is zero the string holds the complete
+   * relative path; otherwise it holds the suffix remaining after the first
+   * prefixLenN_ bytes of the reference path (the predecessor entry's first
+   * path for path1_, this entry's own first path for path2_). Journal
+   * entries for a build touching one deep subtree share long prefixes, so
+   * the suffixes are typically a small fraction of the full paths.
+   */
+  std::string path1_;
+  std::string path2_;
+  uint32_t prefixLen1_ = 0;
+  uint32_t prefixLen2_ = 0;
 };
 
 /** A delta that stores information about changing commits */
@@ -210,6 +277,13 @@ struct JournalDeltaRange {
   }
   JournalDeltaRange(JournalDeltaRange&&) = default;
   JournalDeltaRange& operator=(JournalDeltaRange&&) = default;
+
+  /**
+   * Deliberate deep copy. Copy construction is left deleted so accidental
+   * copies of these potentially-large ranges don't creep in; the journal's
+   * accumulation cache is the one place that needs one.
+   */
+  std::unique_ptr<JournalDeltaRange> clone() const;
 };
 
 } // namespace facebook::eden
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/journal/JournalPersistentRing.h"
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+
+#include <folly/Exception.h>
+#include <folly/lang/Bits.h>
+#include <folly/logging/xlog.h>
+#include <folly/system/MemoryMapping.h>
+
+namespace facebook::eden {
+
+namespace {
+constexpr uint32_t kJournalPersistentRingMagic = 0x454a5031; // "EJP1"
+} // namespace
+
+JournalPersistentRing::JournalPersistentRing(
+    AbsolutePathPiece path,
+    size_t recordCount)
+    : recordCount_{recordCount} {
+  XCHECK(folly::isPowTwo(recordCount)) << "recordCount must be a power of two";
+
+  // Open without O_TRUNC: recovering the previous process's records is the
+  // entire point of this ring.
+  std::string pathStr{path.view()};
+  file_ = folly::File{pathStr.c_str(), O_RDWR | O_CREAT, 0644};
+
+  auto size = sizeof(Header) + recordCount * sizeof(Record);
+
+  struct stat st;
+  folly::checkUnixError(
+      ::fstat(file_.fd(), &st), "failed to stat journal ring ", pathStr);
+  const bool sizeMatches = static_cast<size_t>(st.st_size) == size;
+  if (!sizeMatches) {
+    folly::checkUnixError(
+        ::ftruncate(file_.fd(), size), "failed to size journal ring ", pathStr);
+  }
+
+  mapping_ = std::make_unique<folly::MemoryMapping>(
+      folly::File{file_.fd(), /*ownsFd=*/false},
+      0,
+      size,
+      folly::MemoryMapping::writable());
+  header_ = reinterpret_cast<Header*>(mapping_->writableRange().data());
+
+  const bool valid = sizeMatches &&
+      header_->magic == kJournalPersistentRingMagic &&
+      header_->version == kVersion && header_->recordCount == recordCount &&
+      header_->recordSize == sizeof(Record);
+  if (valid) {
+    // Resume where the previous process left off. The durable watermark is
+    // what recovery trusts; latestIndex only positions the next append and
+    // an overshoot merely skips slots that held torn records anyway.
+    recoveredSequence_ = header_->durableSequence.load();
+    lastSyncedSequence_ = recoveredSequence_;
+    nextIndex_ = header_->latestIndex.load() + 1;
+  } else {
+    initializeFresh();
+  }
+}
+
+void JournalPersistentRing::initializeFresh() {
+  // Zero everything so stale records from an incompatible layout cannot be
+  // mistaken for recovered ones, then publish the magic word last so a
+  // crash mid-initialization reads back as invalid and is recreated.
+  auto range = mapping_->writableRange();
+  memset(range.data(), 0, range.size());
+  header_->version = kVersion;
+  header_->recordCount = static_cast<uint32_t>(recordCount_);
+  header_->recordSize = sizeof(Record);
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->magic = kJournalPersistentRingMagic;
+}
+
+JournalPersistentRing::~JournalPersistentRing() {
+  try {
+    sync();
+  } catch (const std::exception& ex) {
+    XLOG(WARN) << "failed to sync persistent journal ring on close: "
+               << ex.what();
+  }
+}
+
+JournalPersistentRing::Record& JournalPersistentRing::recordForIndex(
+    uint64_t index) {
+  auto* records = reinterpret_cast<Record*>(
+      mapping_->writableRange().data() + sizeof(Header));
+  return records[(index - 1) & (recordCount_ - 1)];
+}
+
+void JournalPersistentRing::publish(
+    JournalDelta::SequenceNumber sequence,
+    RecordKind kind,
+    RelativePathPiece path) {
+  auto index = nextIndex_++;
+  auto& record = recordForIndex(index);
+
+  // Invalidate the slot before rewriting it so a crash mid-write leaves it
+  // unambiguously torn rather than stale-but-plausible.
+  record.index.store(0, std::memory_order_release);
+  record.sequence = sequence;
+  record.kind = static_cast<uint8_t>(kind);
+  auto pathView = path.view();
+  auto copyLength = std::min(pathView.size(), kPathCapacity);
+  record.truncated = copyLength != pathView.size();
+  record.pathLength = static_cast<uint16_t>(copyLength);
+  memcpy(record.path, pathView.data(), copyLength);
+  record.index.store(index, std::memory_order_release);
+
+  header_->latestSequence.store(sequence, std::memory_order_release);
+  header_->latestIndex.store(index, std::memory_order_release);
+  lastPublishedSequence_ = sequence;
+}
+
+void JournalPersistentRing::sync() {
+  if (lastPublishedSequence_ == lastSyncedSequence_) {
+    return;
+  }
+  auto syncedTo = lastPublishedSequence_;
+  // fdatasync picks up the dirty mapped pages; no separate msync is needed.
+  folly::checkUnixError(
+      ::fdatasync(file_.fd()), "failed to sync journal ring");
+  // Advance the watermark only after the records it covers are on disk. The
+  // watermark itself rides to disk with the next sync (or close); losing it
+  // in a crash only makes recovery report an older, safe value.
+  header_->durableSequence.store(syncedTo, std::memory_order_release);
+  lastSyncedSequence_ = syncedTo;
+}
+
+} // namespace facebook::eden
+
+#else // _WIN32
+
+#include <stdexcept>
+
+namespace facebook::eden {
+
+JournalPersistentRing::JournalPersistentRing(
+    AbsolutePathPiece /*path*/,
+    size_t /*recordCount*/) {
+  throw std::runtime_error{
+      "the persistent journal ring is not supported on Windows"};
+}
+
+JournalPersistentRing::~JournalPersistentRing() = default;
+
+void JournalPersistentRing::publish(
+    JournalDelta::SequenceNumber /*sequence*/,
+    RecordKind /*kind*/,
+    RelativePathPiece /*path*/) {}
+
+void JournalPersistentRing::sync() {}
+
+} // namespace facebook::eden
+
+#endif // _WIN32
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include <folly/File.h>
+
+#include "eden/fs/journal/JournalDelta.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+namespace folly {
+class MemoryMapping;
+}
+
+namespace facebook::eden {
+
+/**
+ * A durable, crash-consistent ring of the journal's change feed.
+ *
+ * The in-memory journal dies with the edenfs process, so after a restart
+ * subscribers like Watchman cannot resume from their last seen sequence
+ * number and must recrawl the entire checkout. This ring persists the feed
+ * in a file in the checkout's client directory: on startup the previous
+ * contents are recovered rather than discarded, the journal continues
+ * numbering after the recovered sequence, and a subscriber holding a
+ * pre-restart sequence number can replay the records it missed instead of
+ * recrawling.
+ *
+ * File layout matches JournalShmRing: one 64-byte Header followed by a
+ * power-of-two number of 256-byte Records, each stamped with a monotonic
+ * record index and the journal sequence number. The slot-rewrite protocol
+ * (store 0 to the slot's index, write the payload, store the index with
+ * release semantics) doubles as the crash-consistency story: a record torn
+ * by a crash reads back with a zero or out-of-place index and is ignored
+ * during recovery.
+ *
+ * Durability is batched: publish() only dirties the mapping, and sync()
+ * issues one fdatasync for everything published since the previous sync,
+ * then advances the header's durableSequence watermark. The journal's
+ * publisher thread calls sync() once per merged batch, so the fsync rate
+ * tracks batch rate rather than write rate. durableSequence is
+ * deliberately conservative — after a crash it may undercount what
+ * actually reached disk — which only makes a resuming subscriber replay a
+ * little more than it strictly missed.
+ *
+ * There is a single writer: the Journal, which publishes while holding its
+ * delta lock. Not supported on Windows, like the shared-memory ring.
+ */
+class JournalPersistentRing {
+ public:
+  enum class RecordKind : uint8_t {
+    /** A path changed in the overlay; the record carries the path. */
+    FileChange = 1,
+    /**
+     * The working-copy parent moved (checkout, flush). Any path may have
+     * changed; readers must resync through Thrift.
+     */
+    RootUpdate = 2,
+  };
+
+  static constexpr uint32_t kVersion = 1;
+  static constexpr size_t kDefaultRecordCount = 4096;
+  /** Bytes of path stored inline in a record; longer paths are truncated. */
+  static constexpr size_t kPathCapacity = 232;
+
+  /**
+   * Opens the ring file at the given path, recovering its contents if a
+   * previous process left a valid ring behind, and creating a fresh one
+   * otherwise. recordCount must be a power of two; a valid existing ring
+   * with a different record count is recreated. Throws on Windows, where
+   * the ring is not supported.
+   */
+  explicit JournalPersistentRing(
+      AbsolutePathPiece path,
+      size_t recordCount = kDefaultRecordCount);
+  ~JournalPersistentRing();
+
+  JournalPersistentRing(const JournalPersistentRing&) = delete;
+  JournalPersistentRing& operator=(const JournalPersistentRing&) = delete;
+
+  /**
+   * The durable-sequence watermark recovered from the previous process, or
+   * 0 for a fresh ring. The journal resumes numbering after this value so
+   * sequence numbers stay continuous across restarts.
+   */
+  JournalDelta::SequenceNumber recoveredSequence() const {
+    return recoveredSequence_;
+  }
+
+  /**
+   * Appends one record to the ring. Does not touch disk; call sync() to
+   * make everything published so far durable. May only be called from one
+   * thread at a time; the Journal guarantees this by publishing under its
+   * delta lock.
+   */
+  void publish(
+      JournalDelta::SequenceNumber sequence,
+      RecordKind kind,
+      RelativePathPiece path = RelativePathPiece{});
+
+  /**
+   * Flushes all records published since the last sync to disk and advances
+   * the durable-sequence watermark past them. A no-op when nothing new has
+   * been published.
+   */
+  void sync();
+
+ private:
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordCount;
+    uint32_t recordSize;
+    std::atomic<uint64_t> latestIndex;
+    std::atomic<uint64_t> latestSequence;
+    /** Highest sequence number known to have reached disk. */
+    std::atomic<uint64_t> durableSequence;
+    uint32_t padding[4];
+  };
+  static_assert(sizeof(Header) == 64, "ring header must stay 64 bytes");
+
+  struct Record {
+    /** Record index, or 0 while the slot is being rewritten. */
+    std::atomic<uint64_t> index;
+    uint64_t sequence;
+    uint8_t kind;
+    uint8_t truncated;
+    uint16_t pathLength;
+    uint32_t padding;
+    char path[kPathCapacity];
+  };
+  static_assert(sizeof(Record) == 256, "ring records must stay 256 bytes");
+
+  void initializeFresh();
+  Record& recordForIndex(uint64_t index);
+
+  folly::File file_;
+  std::unique_ptr<folly::MemoryMapping> mapping_;
+  Header* header_ = nullptr;
+  size_t recordCount_ = 0;
+  uint64_t nextIndex_ = 1;
+  JournalDelta::SequenceNumber recoveredSequence_ = 0;
+  /** Most recent sequence passed to publish(); 0 when nothing published. */
+  JournalDelta::SequenceNumber lastPublishedSequence_ = 0;
+  /** Watermark already covered by a sync() call. */
+  JournalDelta::SequenceNumber lastSyncedSequence_ = 0;
+};
+
+} // namespace facebook::eden
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/journal/JournalShmRing.h"
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <limits>
+
+#include <folly/Exception.h>
+#include <folly/lang/Bits.h>
+#include <folly/logging/xlog.h>
+#include <folly/system/MemoryMapping.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace facebook::eden {
+
+namespace {
+constexpr uint32_t kJournalRingMagic = 0x454a5231; // "EJR1"
+} // namespace
+
+JournalShmRing::JournalShmRing(AbsolutePathPiece path, size_t recordCount)
+    : recordCount_{recordCount} {
+  XCHECK(folly::isPowTwo(recordCount)) << "recordCount must be a power of two";
+
+  // Replace any ring left behind by a previous edenfs process: its journal
+  // sequence numbers are meaningless to this one.
+  std::string pathStr{path.view()};
+  file_ = folly::File{pathStr.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644};
+
+  auto size = sizeof(Header) + recordCount * sizeof(Record);
+  folly::checkUnixError(
+      ::ftruncate(file_.fd(), size), "failed to size journal ring ", pathStr);
+
+  mapping_ = std::make_unique<folly::MemoryMapping>(
+      folly::File{file_.fd(), /*ownsFd=*/false},
+      0,
+      size,
+      folly::MemoryMapping::writable());
+  header_ = reinterpret_cast<Header*>(mapping_->writableRange().data());
+
+  // The freshly truncated file is zero-filled, so the counters and records
+  // already read as empty; fill in the descriptive fields and publish the
+  // magic word last so readers never see a half-initialized header.
+  header_->version = kVersion;
+  header_->recordCount = static_cast<uint32_t>(recordCount);
+  header_->recordSize = sizeof(Record);
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->magic = kJournalRingMagic;
+}
+
+JournalShmRing::~JournalShmRing() = default;
+
+JournalShmRing::Record& JournalShmRing::recordForIndex(uint64_t index) {
+  auto* records = reinterpret_cast<Record*>(
+      mapping_->writableRange().data() + sizeof(Header));
+  return records[(index - 1) & (recordCount_ - 1)];
+}
+
+void JournalShmRing::publish(
+    JournalDelta::SequenceNumber sequence,
+    RecordKind kind,
+    RelativePathPiece path) {
+  auto index = nextIndex_++;
+  auto& record = recordForIndex(index);
+
+  // Invalidate the slot before rewriting it so a reader racing with us sees
+  // the record as in-progress rather than stale-but-plausible.
+  record.index.store(0, std::memory_order_release);
+  record.sequence = sequence;
+  record.kind = static_cast<uint8_t>(kind);
+  auto pathView = path.view();
+  auto copyLength = std::min(pathView.size(), kPathCapacity);
+  record.truncated = copyLength != pathView.size();
+  record.pathLength = static_cast<uint16_t>(copyLength);
+  memcpy(record.path, pathView.data(), copyLength);
+  record.index.store(index, std::memory_order_release);
+
+  header_->latestSequence.store(sequence, std::memory_order_release);
+  header_->latestIndex.store(index, std::memory_order_release);
+  wakeReaders();
+}
+
+void JournalShmRing::wakeReaders() {
+  header_->doorbell.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+  // FUTEX_WAKE rather than FUTEX_WAKE_PRIVATE: the waiters are in other
+  // processes. Failure only delays pollers, so the result is ignored.
+  ::syscall(
+      SYS_futex,
+      &header_->doorbell,
+      FUTEX_WAKE,
+      std::numeric_limits<int>::max(),
+      nullptr,
+      nullptr,
+      0);
+#endif
+}
+
+} // namespace facebook::eden
+
+#else // _WIN32
+
+#include <stdexcept>
+
+namespace facebook::eden {
+
+JournalShmRing::JournalShmRing(
+    AbsolutePathPiece /*path*/,
+    size_t /*recordCount*/) {
+  throw std::runtime_error{
+      "the shared-memory journal ring is not supported on Windows"};
+}
+
+JournalShmRing::~JournalShmRing() = default;
+
+void JournalShmRing::publish(
+    JournalDelta::SequenceNumber /*sequence*/,
+    RecordKind /*kind*/,
+    RelativePathPiece /*path*/) {}
+
+} // namespace facebook::eden
+
+#endif // _WIN32
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include <folly/File.h>
+
+#include "eden/fs/journal/JournalDelta.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+namespace folly {
+class MemoryMapping;
+}
+
+namespace facebook::eden {
+
+/**
+ * A shared-memory export of the journal's change feed.
+ *
+ * The ring is a plain file in the checkout's client directory that external
+ * subscribers (e.g. Watchman) map read-only. Each recorded change is appended
+ * as a fixed-size record carrying the journal sequence number and the changed
+ * path, so a subscriber's hot loop can follow the feed with memory reads
+ * instead of a Thrift round trip per poll. The Thrift APIs remain the source
+ * of truth: readers fall back to them when a path was truncated or when they
+ * fall more than one ring behind the writer.
+ *
+ * File layout: one 64-byte Header followed by a power-of-two number of
+ * 256-byte Records. Records are identified by a monotonically increasing
+ * record index (separate from the journal sequence number, since a rename
+ * publishes one record per path) and live at slot (index - 1) % recordCount.
+ *
+ * Writer protocol, per record: store 0 to the slot's index field, write the
+ * payload, then store the record index with release semantics; finally
+ * advance the header's latestIndex and bump the doorbell. Readers load
+ * latestIndex with acquire semantics, copy the slot, and re-check that the
+ * slot's index still matches — a mismatch means the writer lapped them and
+ * they must resync through Thrift. On Linux the doorbell doubles as a futex
+ * word that readers may FUTEX_WAIT on; elsewhere readers poll latestIndex.
+ *
+ * There is a single writer: the Journal, which publishes while holding its
+ * delta lock. The file is truncated on creation since journal sequence
+ * numbers restart with each edenfs process.
+ */
+class JournalShmRing {
+ public:
+  enum class RecordKind : uint8_t {
+    /** A path changed in the overlay; the record carries the path. */
+    FileChange = 1,
+    /**
+     * The working-copy parent moved (checkout, flush). Any path may have
+     * changed; readers must resync through Thrift.
+     */
+    RootUpdate = 2,
+  };
+
+  static constexpr uint32_t kVersion = 1;
+  static constexpr size_t kDefaultRecordCount = 4096;
+  /** Bytes of path stored inline in a record; longer paths are truncated. */
+  static constexpr size_t kPathCapacity = 232;
+
+  /**
+   * Creates (or replaces) the ring file at the given path and maps it.
+   * recordCount must be a power of two. Throws on Windows, where the ring is
+   * not supported.
+   */
+  explicit JournalShmRing(
+      AbsolutePathPiece path,
+      size_t recordCount = kDefaultRecordCount);
+  ~JournalShmRing();
+
+  JournalShmRing(const JournalShmRing&) = delete;
+  JournalShmRing& operator=(const JournalShmRing&) = delete;
+
+  /**
+   * Appends one record and wakes any readers waiting on the doorbell.
+   * May only be called from one thread at a time; the Journal guarantees
+   * this by publishing under its delta lock.
+   */
+  void publish(
+      JournalDelta::SequenceNumber sequence,
+      RecordKind kind,
+      RelativePathPiece path = RelativePathPiece{});
+
+ private:
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordCount;
+    uint32_t recordSize;
+    std::atomic<uint64_t> latestIndex;
+    std::atomic<uint64_t> latestSequence;
+    std::atomic<uint32_t> doorbell;
+    uint32_t padding[7];
+  };
+  static_assert(sizeof(Header) == 64, "ring header must stay 64 bytes");
+
+  struct Record {
+    /** Record index, or 0 while the slot is being rewritten. */
+    std::atomic<uint64_t> index;
+    uint64_t sequence;
+    uint8_t kind;
+    uint8_t truncated;
+    uint16_t pathLength;
+    uint32_t padding;
+    char path[kPathCapacity];
+  };
+  static_assert(sizeof(Record) == 256, "ring records must stay 256 bytes");
+
+  Record& recordForIndex(uint64_t index);
+  void wakeReaders();
+
+  folly::File file_;
+  std::unique_ptr<folly::MemoryMapping> mapping_;
+  Header* header_ = nullptr;
+  size_t recordCount_ = 0;
+  uint64_t nextIndex_ = 1;
+};
+
+} // namespace facebook::eden
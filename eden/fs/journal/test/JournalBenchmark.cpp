@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/journal/Journal.h"
+
+#include <fmt/format.h>
+
+#include "eden/common/utils/benchharness/Bench.h"
+#include "eden/fs/model/RootId.h"
+
+namespace facebook::eden {
+
+namespace {
+
+void record_changed(benchmark::State& state) {
+  auto journal = Journal{std::make_shared<EdenStats>()};
+  auto path = RelativePath{"foo/bar/baz.txt"};
+  for (auto _ : state) {
+    journal.recordChanged(path);
+  }
+}
+BENCHMARK(record_changed);
+
+void record_changed_with_subscriber(benchmark::State& state) {
+  auto journal = Journal{std::make_shared<EdenStats>()};
+  uint64_t notifications = 0;
+  journal.registerSubscriber([&]() { ++notifications; });
+  auto path = RelativePath{"foo/bar/baz.txt"};
+  for (auto _ : state) {
+    journal.recordChanged(path);
+  }
+  benchmark::DoNotOptimize(notifications);
+}
+BENCHMARK(record_changed_with_subscriber);
+
+void add_root_update_delta(benchmark::State& state) {
+  auto journal = Journal{std::make_shared<EdenStats>()};
+  auto fromRoot = RootId{"1111111111111111111111111111111111111111"};
+  auto toRoot = RootId{"2222222222222222222222222222222222222222"};
+  for (auto _ : state) {
+    journal.recordHashUpdate(fromRoot, toRoot);
+  }
+}
+BENCHMARK(add_root_update_delta);
+
+void accumulate_range_after_many_deltas(benchmark::State& state) {
+  auto journal = Journal{std::make_shared<EdenStats>()};
+  for (uint64_t i = 0; i < 10000; ++i) {
+    journal.recordChanged(RelativePath{fmt::format("dir/file{}", i % 100)});
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(journal.accumulateRange(1));
+  }
+}
+BENCHMARK(accumulate_range_after_many_deltas);
+
+} // namespace
+
+} // namespace facebook::eden
+
+EDEN_BENCHMARK_MAIN();
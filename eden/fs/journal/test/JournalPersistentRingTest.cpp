@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifndef _WIN32
+
+#include "eden/fs/journal/JournalPersistentRing.h"
+
+#include <folly/experimental/TestUtil.h>
+#include <folly/portability/GTest.h>
+
+#include "eden/fs/journal/Journal.h"
+#include "eden/fs/utils/FileUtils.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+using namespace facebook::eden;
+
+namespace {
+AbsolutePath ringPath(const folly::test::TemporaryDirectory& dir) {
+  return canonicalPath(dir.path().string()) + "journal.persistent"_pc;
+}
+} // namespace
+
+TEST(JournalPersistentRingTest, fresh_ring_recovers_nothing) {
+  folly::test::TemporaryDirectory dir;
+  JournalPersistentRing ring{ringPath(dir)};
+  EXPECT_EQ(0, ring.recoveredSequence());
+}
+
+TEST(JournalPersistentRingTest, synced_sequence_is_recovered_across_reopen) {
+  folly::test::TemporaryDirectory dir;
+  {
+    JournalPersistentRing ring{ringPath(dir)};
+    ring.publish(
+        1, JournalPersistentRing::RecordKind::FileChange, "foo.txt"_relpath);
+    ring.publish(
+        2, JournalPersistentRing::RecordKind::FileChange, "bar.txt"_relpath);
+    ring.publish(3, JournalPersistentRing::RecordKind::RootUpdate);
+    ring.sync();
+  }
+  JournalPersistentRing ring{ringPath(dir)};
+  EXPECT_EQ(3, ring.recoveredSequence());
+}
+
+TEST(JournalPersistentRingTest, invalid_file_is_recreated) {
+  folly::test::TemporaryDirectory dir;
+  auto path = ringPath(dir);
+  writeFile(path, folly::StringPiece{"not a journal ring"}).value();
+
+  JournalPersistentRing ring{path};
+  EXPECT_EQ(0, ring.recoveredSequence());
+
+  // And the recreated ring must round-trip normally.
+  ring.publish(
+      7, JournalPersistentRing::RecordKind::FileChange, "foo.txt"_relpath);
+  ring.sync();
+  JournalPersistentRing reopened{path};
+  EXPECT_EQ(7, reopened.recoveredSequence());
+}
+
+TEST(JournalPersistentRingTest, journal_sequence_continues_across_restart) {
+  folly::test::TemporaryDirectory dir;
+  Journal::SequenceNumber lastSequence;
+  {
+    Journal journal{std::make_shared<EdenStats>()};
+    journal.setPersistentRing(
+        std::make_unique<JournalPersistentRing>(ringPath(dir)));
+    journal.recordChanged("foo/bar"_relpath);
+    journal.recordChanged("foo/baz"_relpath);
+    lastSequence = journal.getLatest()->sequenceID;
+    EXPECT_LT(0, lastSequence);
+  }
+  {
+    Journal journal{std::make_shared<EdenStats>()};
+    journal.setPersistentRing(
+        std::make_unique<JournalPersistentRing>(ringPath(dir)));
+    journal.recordChanged("foo/qux"_relpath);
+    // A subscriber resuming with lastSequence sees this change as new
+    // rather than colliding with a restarted sequence space.
+    EXPECT_LT(lastSequence, journal.getLatest()->sequenceID);
+  }
+}
+
+#endif
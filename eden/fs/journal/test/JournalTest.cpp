@@ -7,6 +7,7 @@
 
 #include "eden/fs/journal/Journal.h"
 
+#include <folly/Conv.h>
 #include <folly/portability/GMock.h>
 #include <folly/portability/GTest.h>
 
@@ -201,6 +202,49 @@ TEST_F(JournalTest, accumulate_range_with_hash_updates) {
   checkHashMatches({hash1}, journal);
 }
 
+TEST_F(JournalTest, accumulate_range_bounded_pages) {
+  RootId hash0;
+  RootId hash1{"1111111111111111111111111111111111111111"};
+
+  journal.recordChanged("a"_relpath); // sequence 1
+  journal.recordChanged("b"_relpath); // sequence 2
+  journal.recordHashUpdate(hash1); // sequence 3
+  journal.recordChanged("c"_relpath); // sequence 4
+
+  // The first page stops at the bound, before the hash update, so its
+  // transition list is just the snapshot as of sequence 2.
+  auto summed = journal.accumulateRange(1, 2);
+  ASSERT_NE(nullptr, summed);
+  EXPECT_EQ(1, summed->fromSequence);
+  EXPECT_EQ(2, summed->toSequence);
+  EXPECT_EQ(2, summed->changedFilesInOverlay.size());
+  ASSERT_EQ(1, summed->snapshotTransitions.size());
+  EXPECT_EQ(hash0, summed->snapshotTransitions[0]);
+
+  // Resuming from toSequence + 1 picks up the hash update and the final
+  // change with nothing lost between the pages.
+  summed = journal.accumulateRange(3, 100);
+  ASSERT_NE(nullptr, summed);
+  EXPECT_EQ(3, summed->fromSequence);
+  EXPECT_EQ(4, summed->toSequence);
+  EXPECT_EQ(1, summed->changedFilesInOverlay.size());
+  ASSERT_EQ(2, summed->snapshotTransitions.size());
+  EXPECT_EQ(hash0, summed->snapshotTransitions[0]);
+  EXPECT_EQ(hash1, summed->snapshotTransitions[1]);
+
+  // A bound past the tip accumulates everything, like the unbounded
+  // overload.
+  summed = journal.accumulateRange(1, 100);
+  ASSERT_NE(nullptr, summed);
+  EXPECT_EQ(1, summed->fromSequence);
+  EXPECT_EQ(4, summed->toSequence);
+  EXPECT_EQ(3, summed->changedFilesInOverlay.size());
+  ASSERT_EQ(2, summed->snapshotTransitions.size());
+
+  // A bound entirely before the first matching delta yields no range.
+  EXPECT_EQ(nullptr, journal.accumulateRange(5, 100));
+}
+
 TEST_F(JournalTest, debugRawJournalInfoRemoveCreateUpdate) {
   // Remove test.txt
   journal.recordRemoved("test.txt"_relpath);
@@ -512,6 +556,79 @@ TEST_F(JournalTest, truncation_nonzero) {
   } while (rememberedEntries + 5 > totalEntries);
 }
 
+TEST_F(JournalTest, front_coded_paths_decode_transparently) {
+  // Deeply nested paths sharing long prefixes are stored front-coded; make
+  // sure readers see the complete paths across several restart segments.
+  std::vector<RelativePath> paths;
+  for (int i = 0; i < 100; i++) {
+    paths.emplace_back(folly::to<std::string>(
+        "buck-out/gen/some/deeply/nested/project/out", i, ".o"));
+    journal.recordCreated(paths.back());
+  }
+  // Renames share a prefix between their own two paths as well.
+  journal.recordRenamed(
+      "buck-out/gen/some/deeply/nested/project/old.o"_relpath,
+      "buck-out/gen/some/deeply/nested/project/new.o"_relpath);
+
+  auto summed = journal.accumulateRange(1);
+  ASSERT_TRUE(summed);
+  EXPECT_FALSE(summed->isTruncated);
+  for (const auto& path : paths) {
+    EXPECT_EQ(1, summed->changedFilesInOverlay.count(path))
+        << "missing " << path;
+  }
+  EXPECT_EQ(
+      1,
+      summed->changedFilesInOverlay.count(
+          "buck-out/gen/some/deeply/nested/project/old.o"_relpath));
+  EXPECT_EQ(
+      1,
+      summed->changedFilesInOverlay.count(
+          "buck-out/gen/some/deeply/nested/project/new.o"_relpath));
+}
+
+TEST_F(JournalTest, front_coding_reduces_memory_usage) {
+  // The first entry pays for its full path; later entries that share a long
+  // prefix with their predecessor should only be charged for their suffix.
+  std::string prefix =
+      "buck-out/gen/some/deeply/nested/project/with/long/components/file";
+  journal.recordCreated(RelativePath{prefix + "0.o"});
+  auto baseline = journal.estimateMemoryUsage();
+  journal.recordCreated(RelativePath{prefix + "1.o"});
+  auto firstIncrement = journal.estimateMemoryUsage() - baseline;
+  // The suffix is a couple of bytes, so the increment should be well under
+  // the cost of storing the full path again.
+  EXPECT_LT(
+      firstIncrement,
+      sizeof(FileChangeJournalDelta) + folly::goodMallocSize(prefix.size()));
+}
+
+TEST_F(JournalTest, truncation_reanchors_front_coded_entries) {
+  // Push enough nested paths through a small journal that the front of the
+  // deque is repeatedly truncated mid-segment, then check that the
+  // remaining entries still decode to the right paths.
+  journal.setMemoryLimit(2000);
+  constexpr int kTotal = 200;
+  for (int i = 0; i < kTotal; i++) {
+    journal.recordCreated(RelativePath{folly::to<std::string>(
+        "buck-out/gen/some/deeply/nested/project/out", i, ".o")});
+  }
+  int rememberedEntries = journal.getStats()->entryCount;
+  ASSERT_LT(rememberedEntries, kTotal);
+  auto summed = journal.accumulateRange(kTotal - rememberedEntries + 1);
+  ASSERT_TRUE(summed);
+  EXPECT_FALSE(summed->isTruncated);
+  EXPECT_EQ(rememberedEntries, summed->changedFilesInOverlay.size());
+  for (int i = kTotal - rememberedEntries; i < kTotal; i++) {
+    EXPECT_EQ(
+        1,
+        summed->changedFilesInOverlay.count(
+            RelativePath{folly::to<std::string>(
+                "buck-out/gen/some/deeply/nested/project/out", i, ".o")}))
+        << "missing entry " << i;
+  }
+}
+
 TEST_F(JournalTest, compaction) {
   journal.recordCreated("file1.txt"_relpath);
   auto stats = journal.getStats();
@@ -603,10 +720,12 @@ TEST_F(JournalTest, subscribers_are_notified_of_changes) {
 
   EXPECT_EQ(0u, calls);
   journal.recordChanged("foo"_relpath);
+  journal.waitForPublishedChanges();
   EXPECT_EQ(1u, calls);
   EXPECT_EQ(1u, journal.getLatest()->sequenceID);
 
   journal.recordChanged("foo"_relpath);
+  journal.waitForPublishedChanges();
   EXPECT_EQ(2u, calls);
   EXPECT_EQ(2u, journal.getLatest()->sequenceID);
 }
@@ -620,11 +739,14 @@ TEST_F(
 
   EXPECT_EQ(0u, calls);
   journal.recordChanged("foo"_relpath);
+  journal.waitForPublishedChanges();
   EXPECT_EQ(1u, calls);
   journal.recordChanged("foo"_relpath);
+  journal.waitForPublishedChanges();
   EXPECT_EQ(1u, calls);
   EXPECT_EQ(2u, journal.getLatest()->sequenceID);
   journal.recordChanged("foo"_relpath);
+  journal.waitForPublishedChanges();
   EXPECT_EQ(2u, calls);
   EXPECT_EQ(3u, journal.getLatest()->sequenceID);
 }
@@ -642,17 +764,20 @@ TEST_F(JournalTest, all_subscribers_are_notified_after_any_observation) {
 
   journal.recordChanged("foo"_relpath);
   journal.recordChanged("foo"_relpath);
+  journal.waitForPublishedChanges();
 
   EXPECT_EQ(1u, calls1);
   EXPECT_EQ(1u, calls2);
 
   EXPECT_EQ(2u, journal.getLatest()->sequenceID);
   journal.recordChanged("foo"_relpath);
+  journal.waitForPublishedChanges();
 
   EXPECT_EQ(2u, calls1);
   EXPECT_EQ(2u, calls2);
 
   journal.recordChanged("foo"_relpath);
+  journal.waitForPublishedChanges();
 
   EXPECT_EQ(2u, calls1);
   EXPECT_EQ(2u, calls2);
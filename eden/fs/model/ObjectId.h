@@ -11,8 +11,13 @@
 #include <folly/FBString.h>
 #include <folly/Range.h>
 #include <stdint.h>
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <functional>
 #include <iosfwd>
+#include <limits>
+#include <string_view>
 
 namespace folly {
 class IOBuf;
@@ -24,6 +29,12 @@ namespace facebook::eden {
  * Identifies tree and blob objects.
  * This identifier is a variable length string.
  *
+ * The dominant formats are 20- and 32-byte hashes, so the bytes are stored
+ * in a fixed 32-byte inline buffer, falling back to a heap allocation only
+ * for longer exotic formats (e.g. proxy hashes carrying a path). The hash
+ * code is computed once at construction, so the tables keyed by ObjectId
+ * (ObjectCache, InodeMap, ...) probe without chasing a string pointer.
+ *
  * NOTE: The hash function assumes that ObjectID are stored in a specific
  * format to provide constant time hash functions. The high entropy data must
  * be stored in the 2nd to 9th bytes of the ObjectID. This property must be
@@ -31,19 +42,62 @@ namespace facebook::eden {
  */
 class ObjectId {
  public:
-  // fbstring has more SSO space (23 bytes!) than std::string and thus can hold
-  // 20-byte hashes inline.
+  /**
+   * Kept for callers that build variable-length ids incrementally before
+   * wrapping them in an ObjectId.
+   */
   using Storage = folly::fbstring;
 
+  /** Ids up to this many bytes are stored inline with no allocation. */
+  static constexpr size_t kInlineCapacity = 32;
+
   /**
    * Create an empty object id
    */
-  ObjectId() noexcept : bytes_{} {}
+  ObjectId() noexcept : size_{0}, hash_{hashOf(rep_.inlineBytes.data(), 0)} {}
+
+  explicit ObjectId(const Storage& fbs) {
+    init(fbs.data(), fbs.size());
+  }
+
+  explicit ObjectId(folly::ByteRange bytes) {
+    init(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  }
+
+  ObjectId(const ObjectId& that) {
+    init(that.data(), that.size_);
+  }
 
-  explicit ObjectId(Storage fbs) noexcept : bytes_{std::move(fbs)} {}
+  ObjectId(ObjectId&& that) noexcept
+      : rep_{that.rep_}, size_{that.size_}, hash_{that.hash_} {
+    // Leave the source valid and empty; it no longer owns any heap buffer.
+    that.size_ = 0;
+    that.hash_ = hashOf(that.rep_.inlineBytes.data(), 0);
+  }
+
+  ObjectId& operator=(const ObjectId& that) {
+    if (this != &that) {
+      reset();
+      init(that.data(), that.size_);
+    }
+    return *this;
+  }
+
+  ObjectId& operator=(ObjectId&& that) noexcept {
+    if (this != &that) {
+      reset();
+      rep_ = that.rep_;
+      size_ = that.size_;
+      hash_ = that.hash_;
+      that.size_ = 0;
+      that.hash_ = hashOf(that.rep_.inlineBytes.data(), 0);
+    }
+    return *this;
+  }
 
-  explicit ObjectId(folly::ByteRange bytes)
-      : bytes_{constructFromByteRange(bytes)} {}
+  ~ObjectId() {
+    reset();
+  }
 
   /**
    * Compute the SHA1 hash of an IOBuf chain.
@@ -66,18 +120,19 @@ class ObjectId {
    * Returns bytes content of the ObjectId
    */
   folly::ByteRange getBytes() const {
-    return folly::ByteRange{folly::StringPiece{bytes_}};
+    return folly::ByteRange{
+        reinterpret_cast<const uint8_t*>(data()), size_};
   }
 
   char operator[](size_t pos) const {
-    return bytes_[pos];
+    return data()[pos];
   }
 
   /**
    * Returns size of this ObjectId
    */
   size_t size() const {
-    return bytes_.size();
+    return size_;
   }
 
   /** @return [lowercase] hex representation of this ObjectId. */
@@ -107,8 +162,12 @@ class ObjectId {
    * [1,9].
    *
    * Smaller ObjectID will use `std::hash`.
+   *
+   * The value is computed once at construction and cached.
    */
-  size_t getHashCode() const noexcept;
+  size_t getHashCode() const noexcept {
+    return hash_;
+  }
 
   /**
    * Returns true if the two ObjectIds are equal, compared byte-by-byte. If
@@ -120,7 +179,10 @@ class ObjectId {
    * object IDs are compared.
    */
   bool bytesEqual(const ObjectId& that) const noexcept {
-    return bytes_ == that.bytes_;
+    // Equal bytes imply equal cached hash codes, so comparing the hashes
+    // first rejects almost all unequal ids with no memory indirection.
+    return hash_ == that.hash_ && size_ == that.size_ &&
+        memcmp(data(), that.data(), size_) == 0;
   }
 
   /**
@@ -129,7 +191,9 @@ class ObjectId {
    * Primarily intended for use by the std::less specialization.
    */
   bool bytesLess(const ObjectId& that) const noexcept {
-    return bytes_ < that.bytes_;
+    auto minSize = std::min(size_, that.size_);
+    int cmp = minSize == 0 ? 0 : memcmp(data(), that.data(), minSize);
+    return cmp < 0 || (cmp == 0 && size_ < that.size_);
   }
 
   static ObjectId fromHex(folly::StringPiece hex) {
@@ -137,9 +201,6 @@ class ObjectId {
   }
 
  private:
-  static Storage constructFromByteRange(folly::ByteRange bytes) {
-    return Storage{(const char*)bytes.data(), bytes.size()};
-  }
   static Storage constructFromHex(folly::StringPiece hex) {
     if (hex.size() % 2 != 0) {
       throwInvalidArgument(
@@ -174,7 +235,58 @@ class ObjectId {
       const char* message,
       size_t number);
 
-  Storage bytes_;
+  bool isInline() const noexcept {
+    return size_ <= kInlineCapacity;
+  }
+
+  const char* data() const noexcept {
+    return isInline() ? rep_.inlineBytes.data() : rep_.heapBytes;
+  }
+
+  /**
+   * Copy the given bytes into this id and compute the cached hash code.
+   * Must only be called on a freshly constructed or reset() id.
+   */
+  void init(const char* source, size_t size) {
+    if (size > std::numeric_limits<uint32_t>::max()) {
+      throwInvalidArgument("ObjectId too large: ", size);
+    }
+    size_ = static_cast<uint32_t>(size);
+    char* dest;
+    if (isInline()) {
+      dest = rep_.inlineBytes.data();
+    } else {
+      dest = rep_.heapBytes = new char[size];
+    }
+    if (size != 0) {
+      memcpy(dest, source, size);
+    }
+    hash_ = hashOf(dest, size);
+  }
+
+  void reset() noexcept {
+    if (!isInline()) {
+      delete[] rep_.heapBytes;
+    }
+    size_ = 0;
+  }
+
+  static size_t hashOf(const char* data, size_t size) noexcept {
+    if (size > sizeof(size_t) + 1) {
+      size_t ret;
+      memcpy(&ret, data + 1, sizeof(size_t));
+      return ret;
+    }
+    return std::hash<std::string_view>{}(std::string_view{data, size});
+  }
+
+  union Rep {
+    Rep() noexcept : inlineBytes{} {}
+    std::array<char, kInlineCapacity> inlineBytes;
+    char* heapBytes;
+  } rep_;
+  uint32_t size_;
+  size_t hash_;
 };
 
 using ObjectIdRange = folly::Range<const ObjectId*>;
@@ -20,7 +20,7 @@ bool operator!=(const TreeEntry& entry1, const TreeEntry& entry2) {
 
 bool operator==(const Tree& tree1, const Tree& tree2) {
   return (tree1.getHash() == tree2.getHash()) &&
-      (tree1.entries_ == tree2.entries_);
+      (tree1.entries_ == tree2.entries_ || *tree1.entries_ == *tree2.entries_);
 }
 
 bool operator!=(const Tree& tree1, const Tree& tree2) {
@@ -18,29 +18,47 @@ size_t Tree::getSizeBytes() const {
   // eden for this type of thing. D17174143 is one such idea.
   size_t internal_size = sizeof(*this);
 
+  // The entry container may be shared with other trees after TreeCache
+  // interning. We still charge each tree the full container size: counting
+  // shared entries once per tree over-estimates, which only makes the cache
+  // more conservative about its memory budget.
   size_t indirect_size =
-      folly::goodMallocSize(sizeof(TreeEntry) * entries_.capacity());
+      folly::goodMallocSize(sizeof(TreeEntry) * entries_->capacity());
 
-  for (auto& entry : entries_) {
+  for (auto& entry : *entries_) {
     indirect_size += estimateIndirectMemoryUsage(entry.first.value());
   }
   return internal_size + indirect_size;
 }
 
 IOBuf Tree::serialize() const {
-  size_t serialized_size = sizeof(uint32_t) + sizeof(uint32_t);
-  for (auto& entry : entries_) {
-    serialized_size += entry.second.serializedSize(entry.first);
+  XCHECK_LE(entries_->size(), std::numeric_limits<uint32_t>::max());
+  uint32_t numberOfEntries = static_cast<uint32_t>(entries_->size());
+
+  size_t serialized_size = sizeof(uint32_t) + sizeof(uint32_t) +
+      sizeof(uint32_t) * numberOfEntries;
+  size_t entry_data_size = 0;
+  for (auto& entry : *entries_) {
+    entry_data_size += entry.second.serializedSize(entry.first);
   }
+  serialized_size += entry_data_size;
+  XCHECK_LE(entry_data_size, std::numeric_limits<uint32_t>::max());
+
   IOBuf buf(IOBuf::CREATE, serialized_size);
   Appender appender(&buf, 0);
 
-  XCHECK_LE(entries_.size(), std::numeric_limits<uint32_t>::max());
-  uint32_t numberOfEntries = static_cast<uint32_t>(entries_.size());
-
-  appender.write<uint32_t>(V1_VERSION);
+  appender.write<uint32_t>(V2_VERSION);
   appender.write<uint32_t>(numberOfEntries);
-  for (auto& entry : entries_) {
+
+  // Offset table: each entry's byte offset from the start of the entry data,
+  // in the container's sorted order so the raw buffer can be binary searched.
+  uint32_t offset = 0;
+  for (auto& entry : *entries_) {
+    appender.write<uint32_t>(offset);
+    offset += static_cast<uint32_t>(entry.second.serializedSize(entry.first));
+  }
+
+  for (auto& entry : *entries_) {
     entry.second.serialize(entry.first, appender);
   }
   return buf;
@@ -56,7 +74,7 @@ std::unique_ptr<Tree> Tree::tryDeserialize(
   uint32_t version;
   memcpy(&version, data.data(), sizeof(uint32_t));
   data.advance(sizeof(uint32_t));
-  if (version != V1_VERSION) {
+  if (version != V1_VERSION && version != V2_VERSION) {
     return nullptr;
   }
 
@@ -68,6 +86,18 @@ std::unique_ptr<Tree> Tree::tryDeserialize(
   memcpy(&num_entries, data.data(), sizeof(uint32_t));
   data.advance(sizeof(uint32_t));
 
+  if (version == V2_VERSION) {
+    // The entry data is still stored sequentially, so a full deserialize
+    // simply skips past the offset table.
+    size_t table_size = sizeof(uint32_t) * size_t{num_entries};
+    if (data.size() < table_size) {
+      XLOG(ERR) << "Can not read tree offset table, bytes remaining "
+                << data.size();
+      return nullptr;
+    }
+    data.advance(table_size);
+  }
+
   Tree::container entries{kPathMapDefaultCaseSensitive};
   entries.reserve(num_entries);
   for (size_t i = 0; i < num_entries; i++) {
@@ -86,4 +116,63 @@ std::unique_ptr<Tree> Tree::tryDeserialize(
   return std::make_unique<Tree>(std::move(entries), std::move(hash));
 }
 
+std::optional<std::pair<PathComponent, TreeEntry>> Tree::findSerializedEntry(
+    folly::StringPiece data,
+    PathComponentPiece name,
+    CaseSensitivity caseSensitive) {
+  if (data.size() < 2 * sizeof(uint32_t)) {
+    return std::nullopt;
+  }
+  uint32_t version;
+  memcpy(&version, data.data(), sizeof(uint32_t));
+  if (version != V2_VERSION) {
+    return std::nullopt;
+  }
+  uint32_t num_entries;
+  memcpy(&num_entries, data.data() + sizeof(uint32_t), sizeof(uint32_t));
+
+  size_t table_start = 2 * sizeof(uint32_t);
+  size_t entry_data_start =
+      table_start + sizeof(uint32_t) * size_t{num_entries};
+  if (data.size() < entry_data_start) {
+    XLOG(ERR) << "Corrupted tree data, truncated offset table";
+    return std::nullopt;
+  }
+
+  auto decodeAt = [&](size_t index)
+      -> std::optional<std::pair<PathComponent, TreeEntry>> {
+    uint32_t offset;
+    memcpy(
+        &offset,
+        data.data() + table_start + sizeof(uint32_t) * index,
+        sizeof(uint32_t));
+    if (entry_data_start + offset > data.size()) {
+      XLOG(ERR) << "Corrupted tree data, entry offset out of bounds";
+      return std::nullopt;
+    }
+    auto entryData = data.subpiece(entry_data_start + offset);
+    return TreeEntry::deserialize(entryData);
+  };
+
+  // The offset table follows the container's sort order, so binary search
+  // decodes at most log2(num_entries) entries.
+  size_t low = 0;
+  size_t high = num_entries;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    auto entry = decodeAt(mid);
+    if (!entry) {
+      return std::nullopt;
+    }
+    if (isPathPieceLess(entry->first.piece(), name, caseSensitive)) {
+      low = mid + 1;
+    } else if (isPathPieceEqual(entry->first.piece(), name, caseSensitive)) {
+      return entry;
+    } else {
+      high = mid;
+    }
+  }
+  return std::nullopt;
+}
+
 } // namespace facebook::eden
@@ -8,6 +8,8 @@
 #pragma once
 
 #include <folly/io/IOBuf.h>
+#include <memory>
+#include <optional>
 #include "eden/fs/model/Hash.h"
 #include "eden/fs/model/TreeEntry.h"
 #include "eden/fs/utils/CaseSensitivity.h"
@@ -35,6 +37,18 @@ class Tree {
    * Tree with the case sensitivity flipped.
    */
   explicit Tree(container entries, ObjectId hash)
+      : hash_{std::move(hash)},
+        entries_{std::make_shared<const container>(std::move(entries))} {}
+
+  /**
+   * Construct a Tree sharing an existing entry container.
+   *
+   * Directory contents are frequently identical across commits, so TreeCache
+   * interns entry containers by their serialized hash and uses this
+   * constructor to make the trees for different ObjectIds share one
+   * allocation.
+   */
+  Tree(std::shared_ptr<const container> entries, ObjectId hash)
       : hash_{std::move(hash)}, entries_{std::move(entries)} {}
 
   const ObjectId& getHash() const {
@@ -51,11 +65,11 @@ class Tree {
    * Find an entry in this Tree whose name match the passed in path.
    */
   const_iterator find(PathComponentPiece name) const {
-    return entries_.find(name);
+    return entries_->find(name);
   }
 
   const_iterator cbegin() const {
-    return entries_.cbegin();
+    return entries_->cbegin();
   }
 
   const_iterator begin() const {
@@ -63,7 +77,7 @@ class Tree {
   }
 
   const_iterator cend() const {
-    return entries_.cend();
+    return entries_->cend();
   }
 
   const_iterator end() const {
@@ -71,18 +85,31 @@ class Tree {
   }
 
   size_t size() const {
-    return entries_.size();
+    return entries_->size();
   }
 
   /**
    * Returns the case sensitivity of this tree.
    */
   CaseSensitivity getCaseSensitivity() const {
-    return entries_.getCaseSensitivity();
+    return entries_->getCaseSensitivity();
+  }
+
+  /**
+   * Returns the underlying entry container. Used by TreeCache to share one
+   * container between trees with identical contents.
+   */
+  const std::shared_ptr<const container>& getEntries() const {
+    return entries_;
   }
 
   /**
    * Serialize tree using custom format.
+   *
+   * Writes the V2 indexed format: after the version and entry count, a table
+   * of byte offsets (one per entry, in the container's sorted order) precedes
+   * the serialized entries. The table lets findSerializedEntry() binary
+   * search the raw buffer without materializing the whole tree.
    */
   folly::IOBuf serialize() const;
 
@@ -92,20 +119,39 @@ class Tree {
    *
    * First byte is used to identify serialization format.
    * Git tree starts with 'tree', so we can use any bytes other then 't' as a
-   * version identifier. Currently only V1_VERSION is supported, along with
+   * version identifier. V1_VERSION and V2_VERSION are supported, along with
    * git tree format.
    */
   static std::unique_ptr<Tree> tryDeserialize(
       ObjectId hash,
       folly::StringPiece data);
 
+  /**
+   * Look up a single entry directly in serialized tree data.
+   *
+   * For V2 indexed data this binary searches the offset table and decodes
+   * only the probed entries, so a single-child lookup in a large directory
+   * does not pay for materializing every sibling. Returns std::nullopt when
+   * the name is not present or the data is not in the V2 format (callers
+   * should fall back to a full deserialize).
+   *
+   * The data must have been serialized from a container with the given case
+   * sensitivity, as the binary search relies on its sort order.
+   */
+  static std::optional<std::pair<PathComponent, TreeEntry>>
+  findSerializedEntry(
+      folly::StringPiece data,
+      PathComponentPiece name,
+      CaseSensitivity caseSensitive = kPathMapDefaultCaseSensitive);
+
  private:
   friend bool operator==(const Tree& tree1, const Tree& tree2);
 
   ObjectId hash_;
-  container entries_;
+  std::shared_ptr<const container> entries_;
 
   static constexpr uint32_t V1_VERSION = 1u;
+  static constexpr uint32_t V2_VERSION = 2u;
 };
 
 } // namespace facebook::eden
@@ -12,6 +12,8 @@
 #include <algorithm>
 #include <limits>
 
+#include "eden/fs/utils/AsciiCaseFold.h"
+
 using folly::Expected;
 using std::string;
 using std::vector;
@@ -146,12 +148,7 @@ bool isStringPieceEqual(
   if (caseSensitive == CaseSensitivity::Sensitive) {
     return left == right;
   } else {
-    return std::equal(
-        left.begin(),
-        left.end(),
-        right.begin(),
-        right.end(),
-        folly::AsciiCaseInsensitive{});
+    return equalsAsciiIgnoreCase(left, right);
   }
 }
 
@@ -185,7 +182,9 @@ bool operator&(GlobOptions a, GlobOptions b) {
 }
 
 GlobMatcher::GlobMatcher(vector<uint8_t> pattern, CaseSensitivity caseSensitive)
-    : pattern_(std::move(pattern)), caseSensitive_(caseSensitive) {}
+    : pattern_(std::move(pattern)), caseSensitive_(caseSensitive) {
+  computeFastPaths();
+}
 
 GlobMatcher::GlobMatcher() {}
 
@@ -607,7 +606,109 @@ bool GlobMatcher::addCharClass(
   return false;
 }
 
+void GlobMatcher::computeFastPaths() {
+  // Walk the opcode buffer once, computing a lower bound on the length of any
+  // matching text and finding the leading and trailing literal runs.  The
+  // layouts here must stay in sync with the opcode encodings documented at
+  // the top of this file.
+  size_t minLength = 0;
+  size_t idx = 0;
+  uint8_t lastOpcode = 0;
+  size_t lastOpcodeIdx = 0;
+  while (idx < pattern_.size()) {
+    lastOpcode = pattern_[idx];
+    lastOpcodeIdx = idx;
+    switch (pattern_[idx]) {
+      case GLOB_LITERAL: {
+        uint8_t length = pattern_[idx + 1];
+        minLength += length;
+        idx += 2 + length;
+        break;
+      }
+      case GLOB_STAR:
+      case GLOB_STAR_STAR_END:
+      case GLOB_STAR_STAR_SLASH:
+        // Opcode plus bool byte; matches 0 or more characters.
+        idx += 2;
+        break;
+      case GLOB_QMARK:
+        minLength += 1;
+        idx += 1;
+        break;
+      case GLOB_ENDS_WITH: {
+        // Opcode, bool byte, length byte, then the literal data.
+        uint8_t length = pattern_[idx + 2];
+        minLength += length;
+        idx += 3 + length;
+        break;
+      }
+      case GLOB_CHAR_CLASS:
+      case GLOB_CHAR_CLASS_NEGATED:
+        // Either flavor consumes exactly one character of text.
+        minLength += 1;
+        ++idx;
+        while (pattern_[idx] != GLOB_CHAR_CLASS_END) {
+          idx += pattern_[idx] == GLOB_CHAR_CLASS_RANGE ? 3 : 1;
+        }
+        ++idx;
+        break;
+      default:
+        XLOGF(
+            FATAL,
+            "unknown opcode {} in glob pattern buffer at index {}",
+            pattern_[idx],
+            idx);
+    }
+  }
+  minTextLength_ = minLength;
+
+  if (!pattern_.empty() && pattern_[0] == GLOB_LITERAL) {
+    prefixLength_ = pattern_[1];
+  }
+  if (lastOpcode == GLOB_LITERAL) {
+    suffixOffset_ = lastOpcodeIdx + 2;
+    suffixLength_ = pattern_[lastOpcodeIdx + 1];
+  } else if (lastOpcode == GLOB_ENDS_WITH) {
+    suffixOffset_ = lastOpcodeIdx + 3;
+    suffixLength_ = pattern_[lastOpcodeIdx + 2];
+  }
+
+  // A pattern that is one literal run and nothing else matches exactly one
+  // string.  (Literal runs longer than 255 bytes span multiple opcodes and
+  // take the interpreted path; they do not occur in practice.)
+  isExactLiteral_ =
+      !pattern_.empty() && pattern_.size() == 2 + size_t{prefixLength_};
+}
+
 bool GlobMatcher::match(std::string_view text) const {
+  // Cheap necessary conditions first: any matching text is at least
+  // minTextLength_ bytes, starts with the leading literal run, and ends with
+  // the trailing literal.  For the most common ignore rules - fixed strings
+  // and "*.ext" patterns - these checks resolve most candidates without
+  // running the opcode interpreter at all.
+  if (text.size() < minTextLength_) {
+    return false;
+  }
+  if (isExactLiteral_) {
+    return text.size() == prefixLength_ &&
+        isStringPieceEqual(text, prefixView(), caseSensitive_);
+  }
+  if (prefixLength_ != 0 &&
+      !isStringPieceEqual(
+          text.substr(0, prefixLength_), prefixView(), caseSensitive_)) {
+    return false;
+  }
+  if (suffixLength_ != 0 &&
+      !isStringPieceEqual(
+          text.substr(text.size() - suffixLength_),
+          suffixView(),
+          caseSensitive_)) {
+    return false;
+  }
+  if (prefixLength_ != 0) {
+    // The leading literal already matched; resume just past it.
+    return tryMatchAt(text, prefixLength_, 2 + size_t{prefixLength_});
+  }
   return tryMatchAt(text, 0, 0);
 }
 
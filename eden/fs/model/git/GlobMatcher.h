@@ -114,6 +114,24 @@ class GlobMatcher {
    */
   bool charClassMatch(uint8_t ch, size_t* patternIdx) const;
 
+  /**
+   * Walk the compiled pattern buffer once and fill in the pre-screen fields
+   * below (literal prefix/suffix, minimum length, exact-literal flag).
+   * Called from the constructor.
+   */
+  void computeFastPaths();
+
+  std::string_view prefixView() const {
+    return {
+        reinterpret_cast<const char*>(pattern_.data()) + 2, prefixLength_};
+  }
+
+  std::string_view suffixView() const {
+    return {
+        reinterpret_cast<const char*>(pattern_.data()) + suffixOffset_,
+        suffixLength_};
+  }
+
   /**
    * pattern_ is a pre-processed version of the glob pattern.
    *
@@ -127,6 +145,30 @@ class GlobMatcher {
   std::vector<uint8_t> pattern_;
 
   CaseSensitivity caseSensitive_;
+
+  /*
+   * Pre-screen data derived from pattern_ by computeFastPaths().
+   *
+   * Any text that matches the pattern must be at least minTextLength_ bytes,
+   * start with the leading literal run (if any), and end with the trailing
+   * literal (if any).  match() checks these with simple length and substring
+   * compares before falling back to opcode interpretation, which lets the
+   * common fixed-string and "ends with" ignore rules skip the interpreter
+   * entirely on a mismatch.
+   */
+
+  /** Number of literal bytes at the very start of the pattern. */
+  uint32_t prefixLength_{0};
+
+  /** Offset and length of a literal the text must end with, or length 0. */
+  uint32_t suffixOffset_{0};
+  uint32_t suffixLength_{0};
+
+  /** A lower bound on the length of any matching text. */
+  uint32_t minTextLength_{0};
+
+  /** True if the pattern is a single literal run with no wildcards. */
+  bool isExactLiteral_{false};
 };
 
 } // namespace facebook::eden
@@ -488,4 +488,29 @@ TEST(Glob, testCaseInsensitive) {
   EXPECT_CASE_INSENSITIVE_NOMATCH("!", "[Zz]");
 }
 
+TEST(Glob, testLiteralPreScreen) {
+  // These exercise the literal prefix/suffix and minimum-length pre-screen
+  // in match(), particularly texts right at the minimum matching length and
+  // texts where the prefix and suffix checks overlap.
+  EXPECT_MATCH("ab", "a*b");
+  EXPECT_NOMATCH("a", "a*b");
+  EXPECT_NOMATCH("b", "a*b");
+  EXPECT_MATCH("abcb", "ab*cb");
+  EXPECT_NOMATCH("abc", "ab*cb");
+  EXPECT_NOMATCH("acb", "ab*cb");
+
+  // Exact literal patterns, with and without escapes.
+  EXPECT_MATCH("exact-name.txt", "exact-name.txt");
+  EXPECT_NOMATCH("exact-name.txt2", "exact-name.txt");
+  EXPECT_NOMATCH("exact-name.tx", "exact-name.txt");
+  EXPECT_MATCH("lit*eral", "lit\\*eral");
+  EXPECT_CASE_INSENSITIVE_MATCH("Exact-Name.TXT", "exact-name.txt");
+  EXPECT_CASE_INSENSITIVE_MATCH("PRE.mid.POST", "pre*POST");
+
+  // Patterns whose tail is not a literal must not be suffix-screened.
+  EXPECT_MATCH("abc", "ab?");
+  EXPECT_MATCH("abc", "ab[c]");
+  EXPECT_MATCH("ab/cd/ef", "ab/**");
+}
+
 } // namespace
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/model/ObjectId.h"
+
+#include <folly/portability/GTest.h>
+
+using namespace facebook::eden;
+
+namespace {
+ObjectId idFromString(folly::StringPiece str) {
+  return ObjectId{folly::ByteRange{str}};
+}
+} // namespace
+
+TEST(ObjectId, inlineAndHeapRepresentationsBehaveIdentically) {
+  // 20- and 32-byte hashes fit the inline buffer; a proxy hash carrying a
+  // long path spills to the heap. The representations must be
+  // indistinguishable through the public API.
+  std::string shortId(20, 'a');
+  std::string boundaryId(ObjectId::kInlineCapacity, 'b');
+  std::string longId(100, 'c');
+
+  for (const auto& raw : {shortId, boundaryId, longId}) {
+    auto id = idFromString(raw);
+    EXPECT_EQ(raw.size(), id.size());
+    EXPECT_EQ(raw, id.asString());
+    EXPECT_EQ(raw[0], id[0]);
+    EXPECT_TRUE(id.bytesEqual(idFromString(raw)));
+    EXPECT_EQ(id.getHashCode(), idFromString(raw).getHashCode());
+  }
+}
+
+TEST(ObjectId, copyAndMovePreserveValue) {
+  std::string longId(100, 'x');
+  auto id = idFromString(longId);
+
+  auto copy = id;
+  EXPECT_TRUE(copy.bytesEqual(id));
+
+  auto moved = std::move(copy);
+  EXPECT_TRUE(moved.bytesEqual(id));
+  EXPECT_EQ(longId, moved.asString());
+
+  // The moved-from id must remain valid (empty is fine).
+  copy = moved;
+  EXPECT_TRUE(copy.bytesEqual(id));
+
+  id = ObjectId{};
+  EXPECT_EQ(0u, id.size());
+  EXPECT_FALSE(id.bytesEqual(moved));
+}
+
+TEST(ObjectId, orderingMatchesByteComparison) {
+  auto a = idFromString("aaaa");
+  auto ab = idFromString("aaaab");
+  auto b = idFromString("b");
+
+  EXPECT_TRUE(a.bytesLess(ab));
+  EXPECT_FALSE(ab.bytesLess(a));
+  EXPECT_TRUE(a.bytesLess(b));
+  EXPECT_TRUE(ab.bytesLess(b));
+  EXPECT_FALSE(a.bytesLess(a));
+  EXPECT_TRUE(ObjectId{}.bytesLess(a));
+}
+
+TEST(ObjectId, hexRoundTrip) {
+  auto id = ObjectId::fromHex("0123456789012345678901234567890123456789");
+  EXPECT_EQ("0123456789012345678901234567890123456789", id.asHexString());
+  EXPECT_EQ(20u, id.size());
+}
@@ -18,6 +18,7 @@
 #include "eden/fs/config/EdenConfig.h"
 #include "eden/fs/eden-config.h"
 #include "eden/fs/monitor/EdenInstance.h"
+#include "eden/fs/monitor/HealthMonitor.h"
 #include "eden/fs/monitor/LogFile.h"
 #include "eden/fs/monitor/LogRotation.h"
 #include "eden/fs/service/gen-cpp2/EdenServiceAsyncClient.h"
@@ -101,6 +102,11 @@ EdenMonitor::EdenMonitor(
   }
   log_ = std::make_shared<LogFile>(
       logDir + "edenfs.log"_relpath, maxLogSize, std::move(rotationStrategy));
+
+  if (config->monitorHealthPollInterval.getValue() >
+      std::chrono::nanoseconds::zero()) {
+    healthMonitor_ = make_unique<HealthMonitor>(this, *config);
+  }
 }
 
 EdenMonitor::~EdenMonitor() {}
@@ -122,6 +128,9 @@ Future<Unit> EdenMonitor::start() {
   return getEdenInstance().thenValue([this](auto&&) {
     XCHECK(edenfs_ != nullptr);
     state_ = State::Running;
+    if (healthMonitor_) {
+      healthMonitor_->start();
+    }
 #ifdef __linux__
     auto rc = sd_notify(/*unset_environment=*/false, "READY=1");
     if (rc < 0) {
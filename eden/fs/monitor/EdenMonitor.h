@@ -29,6 +29,7 @@ namespace facebook::eden {
 class EdenConfig;
 class EdenInstance;
 class EdenService;
+class HealthMonitor;
 class LogFile;
 
 /**
@@ -103,6 +104,10 @@ class EdenMonitor {
   std::unique_ptr<EdenInstance> edenfs_;
   std::shared_ptr<LogFile> log_;
 
+  // Polls daemon health counters and applies mitigations for sustained
+  // degradation. Null when monitor:health-poll-interval is zero.
+  std::unique_ptr<HealthMonitor> healthMonitor_;
+
   std::string selfExe_;
   std::vector<std::string> selfArgv_;
 
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/monitor/HealthMonitor.h"
+
+#include <fcntl.h>
+#include <time.h>
+
+#include <fmt/format.h>
+#include <folly/ExceptionString.h>
+#include <folly/FileUtil.h>
+#include <folly/futures/Future.h>
+#include <folly/logging/xlog.h>
+
+#include "eden/fs/config/EdenConfig.h"
+#include "eden/fs/monitor/EdenMonitor.h"
+#include "eden/fs/service/gen-cpp2/EdenServiceAsyncClient.h"
+
+using folly::StringPiece;
+using folly::Try;
+
+namespace facebook::eden {
+
+namespace {
+
+constexpr StringPiece kLiveImportMaxDuration{
+    "store.hg.live_import.max_duration_us"};
+constexpr StringPiece kPendingImportCount{"store.hg.pending_import.count"};
+constexpr StringPiece kFusePrefix{"fuse."};
+constexpr StringPiece kLiveRequestsSuffix{".live_requests.count"};
+
+/**
+ * A pending restart waits for a quiet moment, but only this many polls:
+ * if the checkout never goes idle the wedge is hurting someone right now
+ * and waiting longer only prolongs it.
+ */
+constexpr uint32_t kMaxRestartDeferrals = 10;
+
+int64_t lookupCounter(
+    const std::map<std::string, int64_t>& counters,
+    StringPiece name) {
+  auto it = counters.find(name.str());
+  return it == counters.end() ? 0 : it->second;
+}
+
+} // namespace
+
+HealthMonitor::HealthMonitor(EdenMonitor* monitor, const EdenConfig& config)
+    : AsyncTimeout{monitor->getEventBase()},
+      monitor_{monitor},
+      pollInterval_{std::chrono::duration_cast<std::chrono::milliseconds>(
+          config.monitorHealthPollInterval.getValue())},
+      importWedgeThreshold_{
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              config.monitorImportWedgeThreshold.getValue())},
+      unhealthyPollThreshold_{config.monitorUnhealthyPolls.getValue()},
+      autoRestart_{config.monitorAutoRestart.getValue()} {
+  auto logPath = monitor_->getEdenDir() + "logs"_relpath +
+      "monitor-health.log"_relpath;
+  eventLog_ = folly::File{
+      logPath.value(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644};
+}
+
+void HealthMonitor::start() {
+  logEvent(fmt::format(
+      "health supervision started: poll interval {}s, "
+      "import wedge threshold {}s, unhealthy polls {}, auto restart {}",
+      pollInterval_.count() / 1000,
+      importWedgeThreshold_.count() / 1000000,
+      unhealthyPollThreshold_,
+      autoRestart_ ? "enabled" : "disabled"));
+  schedulePoll();
+}
+
+void HealthMonitor::timeoutExpired() noexcept {
+  try {
+    poll();
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "unexpected error polling EdenFS health: "
+              << folly::exceptionStr(ex);
+    schedulePoll();
+  }
+}
+
+void HealthMonitor::schedulePoll() {
+  scheduleTimeout(pollInterval_);
+}
+
+void HealthMonitor::poll() {
+  auto client = monitor_->createEdenThriftClient();
+  client->future_getCounters().thenTry(
+      [this, client](Try<std::map<std::string, int64_t>> counters) {
+        if (counters.hasValue()) {
+          failedPolls_ = 0;
+          evaluate(counters.value());
+        } else {
+          ++failedPolls_;
+          // Liveness is handled by the process supervision half of the
+          // monitor; an unresponsive thrift endpoint is only worth
+          // recording once it is sustained.
+          if (failedPolls_ == unhealthyPollThreshold_) {
+            logEvent(fmt::format(
+                "counter poll failed {} consecutive times: {}",
+                failedPolls_,
+                counters.exception().what()));
+          }
+        }
+        schedulePoll();
+      });
+}
+
+void HealthMonitor::evaluate(const std::map<std::string, int64_t>& counters) {
+  auto liveImportAgeUs = lookupCounter(counters, kLiveImportMaxDuration);
+  auto pendingImports = lookupCounter(counters, kPendingImportCount);
+  bool wedged = pendingImports > 0 &&
+      liveImportAgeUs >= importWedgeThreshold_.count();
+
+  if (!wedged) {
+    if (wedgedPolls_ >= unhealthyPollThreshold_) {
+      logEvent("importer recovered");
+    }
+    wedgedPolls_ = 0;
+    cacheFlushAttempted_ = false;
+    restartPending_ = false;
+    return;
+  }
+
+  ++wedgedPolls_;
+  logEvent(fmt::format(
+      "importer wedge suspected ({} consecutive polls): "
+      "oldest live import {}s old, {} imports pending",
+      wedgedPolls_,
+      liveImportAgeUs / 1000000,
+      pendingImports));
+
+  if (wedgedPolls_ < unhealthyPollThreshold_ || restartRequested_) {
+    return;
+  }
+
+  if (!cacheFlushAttempted_) {
+    cacheFlushAttempted_ = true;
+    // Reset the streak so the flush gets a full observation window to
+    // prove itself before we escalate further.
+    wedgedPolls_ = 0;
+    flushLocalStoreCaches();
+    return;
+  }
+
+  if (!autoRestart_) {
+    logEvent(
+        "importer still wedged after cache flush; graceful restart "
+        "suppressed because monitor:auto-restart is disabled");
+    return;
+  }
+
+  if (!restartPending_) {
+    restartPending_ = true;
+    logEvent("importer still wedged after cache flush; restart pending");
+  }
+  // Count deferrals from the poll the restart became pending on:
+  // wedgedPolls_ keeps growing while we wait for a quiet moment.
+  if (looksQuiet(counters) ||
+      wedgedPolls_ >= unhealthyPollThreshold_ + kMaxRestartDeferrals) {
+    requestGracefulRestart();
+  } else {
+    logEvent("deferring restart: filesystem requests are in flight");
+  }
+}
+
+bool HealthMonitor::looksQuiet(
+    const std::map<std::string, int64_t>& counters) const {
+  // The importer queue is intentionally ignored here: when a restart is
+  // pending it is wedged by definition and will never drain on its own.
+  for (const auto& [name, value] : counters) {
+    if (StringPiece{name}.startsWith(kFusePrefix) &&
+        StringPiece{name}.endsWith(kLiveRequestsSuffix) && value > 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HealthMonitor::flushLocalStoreCaches() {
+  logEvent("mitigation: flushing local store caches");
+  auto client = monitor_->createEdenThriftClient();
+  client->future_debugClearLocalStoreCaches().thenTry(
+      [this, client](Try<folly::Unit> result) {
+        if (result.hasException()) {
+          logEvent(fmt::format(
+              "cache flush failed: {}", result.exception().what()));
+        } else {
+          logEvent("cache flush completed");
+        }
+      });
+}
+
+void HealthMonitor::requestGracefulRestart() {
+  restartRequested_ = true;
+  logEvent(
+      "mitigation: requesting graceful daemon shutdown; service "
+      "supervision will start a fresh daemon");
+  auto client = monitor_->createEdenThriftClient();
+  client
+      ->future_initiateShutdown(
+          "EdenFS monitor health check: SCM importer wedged")
+      .thenTry([this, client](Try<folly::Unit> result) {
+        if (result.hasException()) {
+          // Allow another attempt on a later poll.
+          restartRequested_ = false;
+          logEvent(fmt::format(
+              "shutdown request failed: {}", result.exception().what()));
+        }
+      });
+}
+
+void HealthMonitor::logEvent(StringPiece event) {
+  XLOG(WARN) << "health: " << event;
+
+  struct tm tm;
+  time_t now = time(nullptr);
+  gmtime_r(&now, &tm);
+  char timestamp[32];
+  strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", &tm);
+
+  auto line = fmt::format("{} {}\n", timestamp, event);
+  auto rc = folly::writeFull(eventLog_.fd(), line.data(), line.size());
+  if (rc == -1) {
+    XLOG(ERR) << "failed to append to health event log: "
+              << folly::errnoStr(errno);
+  }
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <folly/File.h>
+#include <folly/Range.h>
+#include <folly/io/async/AsyncTimeout.h>
+
+#include "eden/fs/utils/PathFuncs.h"
+
+namespace facebook::eden {
+
+class EdenConfig;
+class EdenMonitor;
+
+/**
+ * HealthMonitor periodically polls cheap fb303 counters from the edenfs
+ * daemon and watches for sustained performance degradation that crash
+ * supervision alone cannot see, most importantly a wedged SCM importer
+ * (imports pending while the oldest live import keeps aging).
+ *
+ * When a condition persists across several consecutive polls the monitor
+ * applies mitigations in escalating order: first a local store cache
+ * flush, then - only if monitor:auto-restart is enabled - a graceful
+ * daemon shutdown at a quiet moment, after which service supervision
+ * restarts the monitor and a fresh daemon. Every observation and
+ * mitigation is appended to logs/monitor-health.log in the eden state
+ * directory so a human can reconstruct what the monitor did and why.
+ *
+ * Like the rest of the monitor this class is single threaded: all of its
+ * work runs on the EdenMonitor's EventBase.
+ */
+class HealthMonitor : private folly::AsyncTimeout {
+ public:
+  HealthMonitor(EdenMonitor* monitor, const EdenConfig& config);
+  ~HealthMonitor() override = default;
+
+  /**
+   * Schedule the first poll. Separate from the constructor so the
+   * EdenMonitor can delay supervision until the daemon has finished
+   * starting.
+   */
+  void start();
+
+ private:
+  HealthMonitor(HealthMonitor const&) = delete;
+  HealthMonitor& operator=(HealthMonitor const&) = delete;
+
+  void timeoutExpired() noexcept override;
+  void schedulePoll();
+  void poll();
+  void evaluate(const std::map<std::string, int64_t>& counters);
+
+  /**
+   * A quiet moment: no live filesystem requests and nothing queued at the
+   * importer. Restarts are deferred, one poll at a time, until this holds.
+   */
+  bool looksQuiet(const std::map<std::string, int64_t>& counters) const;
+
+  void flushLocalStoreCaches();
+  void requestGracefulRestart();
+  void logEvent(folly::StringPiece event);
+
+  EdenMonitor* const monitor_;
+  std::chrono::milliseconds pollInterval_;
+  std::chrono::microseconds importWedgeThreshold_;
+  uint32_t unhealthyPollThreshold_;
+  bool autoRestart_;
+
+  /** Consecutive polls that observed a wedged importer. */
+  uint32_t wedgedPolls_{0};
+  /** Consecutive polls whose counter fetch itself failed. */
+  uint32_t failedPolls_{0};
+  bool cacheFlushAttempted_{false};
+  bool restartPending_{false};
+  bool restartRequested_{false};
+
+  folly::File eventLog_;
+};
+
+} // namespace facebook::eden
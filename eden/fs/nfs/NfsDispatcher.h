@@ -57,6 +57,21 @@ class NfsDispatcher {
       InodeNumber ino,
       const ObjectFetchContextPtr& context) = 0;
 
+  /**
+   * Return the cached attributes for the passed in InodeNumber if they are
+   * known to still be valid, without blocking or scheduling any work.
+   *
+   * GETATTR is the most frequent procedure on every NFS mount and usually
+   * hits the dispatcher's attribute cache; this hook lets the server
+   * serialize such replies directly on the RPC thread instead of paying for
+   * the future machinery of the getattr() path. Returns std::nullopt when
+   * the attributes are not cached, in which case the caller must fall back
+   * to getattr().
+   */
+  virtual std::optional<struct stat> getattrCached(InodeNumber /*ino*/) {
+    return std::nullopt;
+  }
+
   /**
    * Return value of the setattr method.
    */
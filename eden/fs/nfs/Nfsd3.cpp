@@ -73,6 +73,11 @@ class Nfsd3ServerProcessor final : public RpcServerProcessor {
       uint32_t progVersion,
       uint32_t procNumber) override;
 
+  size_t expectedReplySize(
+      uint32_t progNumber,
+      uint32_t progVersion,
+      uint32_t procNumber) override;
+
   void onShutdown(RpcStopData stopData) override;
   void clientConnected() override;
 
@@ -261,13 +266,17 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::null(
 /**
  * Convert the given string onto a PathComponent.
  *
+ * The bytes are copied out of the request's receive buffer here; this is the
+ * only copy the name makes on its way to the dispatcher.
+ *
  * Any raised exception that constructing the PathComponent may raise will be
  * captured by the returned ImmediateFuture.
  */
-ImmediateFuture<PathComponent> extractPathComponent(std::string str) {
+ImmediateFuture<PathComponent> extractPathComponent(const XdrStringView& str) {
   return makeImmediateFutureWith([&]() {
     try {
-      return PathComponent{str};
+      auto piece = str.piece();
+      return PathComponent{std::string_view{piece.data(), piece.size()}};
     } catch (const PathComponentNotUtf8& ex) {
       throw std::system_error(EINVAL, std::system_category(), ex.what());
     }
@@ -282,6 +291,16 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::getattr(
 
   auto args = XdrTrait<GETATTR3args>::deserialize(deser);
 
+  // For the vast majority of GETATTR calls the attributes are cached and
+  // the executor hops of the future path below cost more than the work
+  // itself; serialize those replies directly on this thread.
+  if (auto stat = dispatcher_->getattrCached(args.object.ino)) {
+    GETATTR3res res{
+        {{nfsstat3::NFS3_OK, GETATTR3resok{statToFattr3(*stat)}}}};
+    XdrTrait<GETATTR3res>::serialize(ser, res);
+    return folly::unit;
+  }
+
   return dispatcher_->getattr(args.object.ino, context.getObjectFetchContext())
       .thenTry(
           [ser = std::move(ser)](const folly::Try<struct stat>& try_) mutable {
@@ -439,7 +458,7 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::lookup(
                            });
                  });
            } else {
-             return extractPathComponent(std::move(args.what.name))
+             return extractPathComponent(args.what.name)
                  .thenValue([this, ino = args.what.dir.ino, &context](
                                 PathComponent&& name) {
                    return dispatcher_->lookup(
@@ -593,7 +612,9 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::read(
                           /*eof*/ read.isEof,
                           /*data*/ std::move(read.data),
                       }}}};
-                XdrTrait<READ3res>::serialize(ser, res);
+                // Serialize from an rvalue so the data chain is handed to the
+                // reply without being cloned.
+                XdrTrait<READ3res>::serialize(ser, std::move(res));
               }
               return folly::unit;
             });
@@ -705,7 +726,7 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::create(
   auto& attr = std::get<sattr3>(args.how.v);
   auto mode = S_IFREG | setMode3ToMode(attr.mode);
 
-  return extractPathComponent(std::move(args.where.name))
+  return extractPathComponent(args.where.name)
       .thenValue([this, ino = args.where.dir.ino, mode, &context](
                      PathComponent&& name) {
         return dispatcher_->create(
@@ -781,7 +802,7 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::mkdir(
   // TODO(xavierd): For now, all the other args.attributes are ignored, is it
   // OK?
 
-  return extractPathComponent(std::move(args.where.name))
+  return extractPathComponent(args.where.name)
       .thenValue([this, ino = args.where.dir.ino, mode, &context](
                      PathComponent&& name) {
         return dispatcher_->mkdir(
@@ -827,7 +848,7 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::symlink(
 
   // TODO(xavierd): set the attributes of the symlink with symlink_attr
 
-  return extractPathComponent(std::move(args.where.name))
+  return extractPathComponent(args.where.name)
       .thenValue([this,
                   ino = args.where.dir.ino,
                   symlink_data = std::move(args.symlink.symlink_data),
@@ -908,7 +929,7 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::mknod(
   // TODO(xavierd): we should probably respect the rest of the sattr3
   // attributes.
 
-  return extractPathComponent(std::move(args.where.name))
+  return extractPathComponent(args.where.name)
       .thenValue([this, ino = args.where.dir.ino, mode, rdev, &context](
                      PathComponent&& name) {
         return dispatcher_->mknod(
@@ -957,7 +978,7 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::remove(
   // here, "REMOVE can be used to remove directories, subject to restrictions
   // imposed by either the client or server interfaces"
 
-  return extractPathComponent(std::move(args.object.name))
+  return extractPathComponent(args.object.name)
       .thenValue(
           [this, ino = args.object.dir.ino, &context](PathComponent&& name) {
             return dispatcher_->unlink(
@@ -999,7 +1020,7 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::rmdir(
     return folly::unit;
   }
 
-  return extractPathComponent(std::move(args.object.name))
+  return extractPathComponent(args.object.name)
       .thenValue(
           [this, ino = args.object.dir.ino, &context](PathComponent&& name) {
             return dispatcher_->rmdir(
@@ -1045,9 +1066,9 @@ ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::rename(
     return folly::unit;
   }
 
-  return extractPathComponent(std::move(args.from.name))
+  return extractPathComponent(args.from.name)
       .thenValue([toName = args.to.name](PathComponent&& fromName) mutable {
-        return extractPathComponent(std::move(toName))
+        return extractPathComponent(toName)
             .thenValue(
                 [fromName = std::move(fromName)](PathComponent&& toName) mutable
                 -> std::tuple<PathComponent, PathComponent> {
@@ -1843,6 +1864,27 @@ SamplingGroup nfsProcSamplingGroup(uint32_t procNumber) {
 }
 } // namespace
 
+size_t Nfsd3ServerProcessor::expectedReplySize(
+    uint32_t progNumber,
+    uint32_t progVersion,
+    uint32_t procNumber) {
+  if (progNumber == kNfsdProgNumber && progVersion == kNfsd3ProgVersion) {
+    switch (static_cast<nfsv3Procs>(procNumber)) {
+      case nfsv3Procs::readdir:
+      case nfsv3Procs::readdirplus:
+        // Directory listings serialize their entries through the reply
+        // buffer and clients ask for up to an iosize worth of them. READ
+        // replies don't need this: the blob is spliced into the reply
+        // chain without being copied through the serializer.
+        return iosize_;
+      default:
+        break;
+    }
+  }
+  return RpcServerProcessor::expectedReplySize(
+      progNumber, progVersion, procNumber);
+}
+
 ImmediateFuture<folly::Unit> Nfsd3ServerProcessor::dispatchRpc(
     folly::io::Cursor deser,
     folly::io::QueueAppender ser,
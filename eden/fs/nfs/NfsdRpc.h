@@ -298,7 +298,10 @@ EDEN_XDR_SERDE_DECL(sattr3, mode, uid, gid, size, atime, mtime);
 
 struct diropargs3 {
   nfs_fh3 dir;
-  std::string name;
+  // Borrowed from the request's receive buffer when deserialized; LOOKUP and
+  // the other directory operations are hot enough for the copy to matter.
+  // See XdrStringView for the lifetime rules.
+  XdrStringView name;
 };
 EDEN_XDR_SERDE_DECL(diropargs3, dir, name);
 
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifndef _WIN32
+
+#include "eden/fs/nfs/rpc/ReplyBufferPool.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace facebook::eden {
+
+struct ReplyBufferPool::BufferHeader {
+  std::shared_ptr<ReplyBufferPool> pool;
+  size_t classIndex;
+};
+
+namespace {
+/**
+ * Size of the BufferHeader region, rounded up so the reply bytes that
+ * follow it stay suitably aligned for any use.
+ */
+constexpr size_t roundUpToMaxAlign(size_t size) {
+  constexpr auto align = alignof(std::max_align_t);
+  return (size + align - 1) & ~(align - 1);
+}
+} // namespace
+
+ReplyBufferPool::~ReplyBufferPool() {
+  auto cache = cache_.wlock();
+  for (auto& bucket : *cache) {
+    for (auto* block : bucket) {
+      std::free(block);
+    }
+    bucket.clear();
+  }
+}
+
+std::unique_ptr<folly::IOBuf> ReplyBufferPool::acquire(size_t sizeHint) {
+  size_t classIndex = 0;
+  while (classIndex < kClassSizes.size() &&
+         kClassSizes[classIndex] < sizeHint) {
+    classIndex++;
+  }
+  if (classIndex == kClassSizes.size()) {
+    // Larger than the largest size class, oversized buffers are rare
+    // enough that caching them isn't worth pinning the memory.
+    return folly::IOBuf::create(sizeHint);
+  }
+
+  constexpr size_t kHeaderSize = roundUpToMaxAlign(sizeof(BufferHeader));
+  auto capacity = kClassSizes[classIndex];
+
+  void* block = nullptr;
+  {
+    auto cache = cache_.wlock();
+    auto& bucket = (*cache)[classIndex];
+    if (!bucket.empty()) {
+      block = bucket.back();
+      bucket.pop_back();
+    }
+  }
+  if (!block) {
+    block = std::malloc(kHeaderSize + capacity);
+    if (!block) {
+      throw std::bad_alloc();
+    }
+  }
+
+  new (block) BufferHeader{shared_from_this(), classIndex};
+  auto* data = static_cast<uint8_t*>(block) + kHeaderSize;
+  return folly::IOBuf::takeOwnership(
+      data, capacity, size_t(0), &ReplyBufferPool::freeBuffer);
+}
+
+void ReplyBufferPool::freeBuffer(void* data, void* /*userData*/) {
+  constexpr size_t kHeaderSize = roundUpToMaxAlign(sizeof(BufferHeader));
+  void* block = static_cast<uint8_t*>(data) - kHeaderSize;
+  auto* header = static_cast<BufferHeader*>(block);
+
+  // Move the pool reference out of the header before destroying it: the
+  // local shared_ptr keeps the pool alive through release(), even if this
+  // buffer was the last thing referencing it.
+  auto pool = std::move(header->pool);
+  auto classIndex = header->classIndex;
+  header->~BufferHeader();
+
+  pool->release(block, classIndex);
+}
+
+void ReplyBufferPool::release(void* block, size_t classIndex) {
+  {
+    auto cache = cache_.wlock();
+    auto& bucket = (*cache)[classIndex];
+    if (bucket.size() < kMaxCachedPerClass) {
+      bucket.push_back(block);
+      return;
+    }
+  }
+  std::free(block);
+}
+
+size_t ReplyBufferPool::cachedBytes() const {
+  size_t total = 0;
+  auto cache = cache_.rlock();
+  for (size_t classIndex = 0; classIndex < kClassSizes.size(); classIndex++) {
+    total += (*cache)[classIndex].size() * kClassSizes[classIndex];
+  }
+  return total;
+}
+
+} // namespace facebook::eden
+
+#endif
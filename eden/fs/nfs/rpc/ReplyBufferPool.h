@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <folly/Synchronized.h>
+#include <folly/io/IOBuf.h>
+
+namespace facebook::eden {
+
+/**
+ * A pool of reply buffers for a single RPC connection.
+ *
+ * Serializing a reply needs a buffer to write into, and the buffer is only
+ * freed once the socket has written it out. Without a pool, every reply pays
+ * for a heap allocation of its backing storage; on a busy mount this
+ * allocator traffic is measurable. The pool recycles the backing storage
+ * instead: acquire() hands out an empty IOBuf whose memory is returned here
+ * when the IOBuf is destroyed, wherever that happens.
+ *
+ * Buffers are grouped into a small set of size classes. acquire() rounds the
+ * size hint up to the next class and prefers a cached buffer of that class
+ * over allocating a fresh one. On release, each class caches up to a
+ * high-water mark of buffers and frees the excess, so a burst of large
+ * replies doesn't pin memory for the lifetime of the connection. Hints
+ * larger than the largest class fall back to a plain unpooled allocation.
+ *
+ * This class is thread safe: replies for one connection are serialized
+ * concurrently on the server's thread pool, while the socket releases them
+ * on its EventBase thread. The pool is held via shared_ptr and each
+ * outstanding buffer keeps it alive, so buffers may safely outlive the
+ * connection that acquired them.
+ */
+class ReplyBufferPool : public std::enable_shared_from_this<ReplyBufferPool> {
+ public:
+  static std::shared_ptr<ReplyBufferPool> create() {
+    return std::shared_ptr<ReplyBufferPool>(new ReplyBufferPool());
+  }
+
+  ~ReplyBufferPool();
+
+  ReplyBufferPool(const ReplyBufferPool&) = delete;
+  ReplyBufferPool& operator=(const ReplyBufferPool&) = delete;
+
+  /**
+   * Obtain an empty IOBuf with at least sizeHint bytes of tailroom.
+   *
+   * The buffer behaves like any other IOBuf and can be appended to an
+   * IOBufQueue or handed to a socket; its storage comes back to the pool
+   * when the last IOBuf referencing it is destroyed.
+   */
+  std::unique_ptr<folly::IOBuf> acquire(size_t sizeHint);
+
+  /**
+   * Total bytes currently cached, across all size classes. Exposed for
+   * tests.
+   */
+  size_t cachedBytes() const;
+
+ private:
+  ReplyBufferPool() = default;
+
+  /**
+   * Control block placed in front of each pooled allocation. It keeps the
+   * pool alive while the buffer is in flight so that the IOBuf free
+   * callback can find its way back here.
+   */
+  struct BufferHeader;
+
+  /**
+   * folly::IOBuf::FreeFunction invoked when the last IOBuf referencing a
+   * pooled buffer is destroyed.
+   */
+  static void freeBuffer(void* data, void* userData);
+
+  /**
+   * Return a block to its size class, or free it if the class is already
+   * at its high-water mark.
+   */
+  void release(void* block, size_t classIndex);
+
+  static constexpr std::array<size_t, 4> kClassSizes{
+      1024,
+      4096,
+      16384,
+      65536};
+
+  /**
+   * High-water mark of cached buffers per size class.
+   */
+  static constexpr size_t kMaxCachedPerClass = 8;
+
+  /**
+   * Cached blocks, one bucket per entry in kClassSizes. Blocks include
+   * their BufferHeader storage, the header itself is only constructed
+   * while the buffer is in flight.
+   */
+  folly::Synchronized<std::array<std::vector<void*>, kClassSizes.size()>>
+      cache_;
+};
+
+} // namespace facebook::eden
+
+#endif
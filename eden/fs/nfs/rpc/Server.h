@@ -14,9 +14,11 @@
 #include <folly/SocketAddress.h>
 #include <folly/io/async/AsyncServerSocket.h>
 #include <folly/io/async/AsyncSocket.h>
+#include <folly/io/async/EventBase.h>
 #include <folly/net/NetworkSocket.h>
 
 #include "eden/fs/nfs/portmap/PortmapClient.h"
+#include "eden/fs/nfs/rpc/ReplyBufferPool.h"
 #include "eden/fs/nfs/rpc/Rpc.h"
 #include "eden/fs/nfs/rpc/Server.h"
 #include "eden/fs/utils/ImmediateFuture.h"
@@ -58,6 +60,22 @@ class RpcServerProcessor {
  public:
   virtual ~RpcServerProcessor() = default;
   virtual auth_stat checkAuthentication(const call_body& call_body);
+
+  /**
+   * How many bytes the reply to the given procedure is expected to need.
+   *
+   * This is only a sizing hint: the server pre-sizes the reply buffer from
+   * it so that serializing the common replies never needs to grow the
+   * buffer, but a reply larger than the hint simply falls back to chained
+   * allocation. Processors that know some procedures produce large replies
+   * (e.g. directory listings) should override this; the default covers
+   * typical fixed-size replies.
+   */
+  virtual size_t expectedReplySize(
+      uint32_t progNumber,
+      uint32_t progVersion,
+      uint32_t procNumber);
+
   virtual ImmediateFuture<folly::Unit> dispatchRpc(
       folly::io::Cursor deser,
       folly::io::QueueAppender ser,
@@ -150,9 +168,27 @@ class RpcTcpHandler : public folly::DelayedDestruction {
         const folly::AsyncSocketException& ex) noexcept override;
   };
 
+  class ReplyFlusher : public folly::EventBase::LoopCallback {
+   public:
+    explicit ReplyFlusher(RpcTcpHandler* handler) : handler_(handler) {}
+
+   private:
+    void runLoopCallback() noexcept override;
+
+    RpcTcpHandler* handler_;
+  };
+
   /**
    * Parse the buffer that was just read from the socket. Complete RPC buffers
    * will be dispatched to the RpcServerProcessor.
+   *
+   * Each complete fragment is handed to the servicing thread pool as soon as
+   * it is parsed, without waiting for earlier calls from the same connection
+   * to finish. Independent calls on one TCP connection therefore execute
+   * concurrently, and their replies are written back in completion order:
+   * RPC replies carry the xid of the call they answer, so the client matches
+   * them up regardless of ordering. This matters in particular for macOS
+   * clients which funnel the whole mount through a single connection.
    */
   void tryConsumeReadBuffer() noexcept;
 
@@ -202,6 +238,20 @@ class RpcTcpHandler : public folly::DelayedDestruction {
       RpcParsingError& err,
       std::unique_ptr<folly::IOBuf> input);
 
+  /**
+   * Queue a serialized reply to be written to the socket.
+   *
+   * This must be called on the socket's EventBase. All the replies queued
+   * during one loop iteration of the EventBase are coalesced and written to
+   * the socket with a single writev(2) rather than one syscall per reply.
+   */
+  void sendSerializedReply(std::unique_ptr<folly::IOBuf> reply);
+
+  /**
+   * Write all the queued replies to the socket in one batch.
+   */
+  void flushPendingReplies();
+
   /**
    * Processor to handle the requests.
    */
@@ -225,6 +275,14 @@ class RpcTcpHandler : public folly::DelayedDestruction {
    */
   std::shared_ptr<StructuredLogger> errorLogger_;
 
+  /**
+   * Pool of reply buffers for this connection. Reply serialization runs
+   * concurrently on threadPool_ and the socket frees the buffers on its
+   * EventBase, so the pool is thread safe and held via shared_ptr: replies
+   * in flight keep it alive past the connection if need be.
+   */
+  std::shared_ptr<ReplyBufferPool> replyBufferPool_{ReplyBufferPool::create()};
+
   /**
    * Reads raw data off the socket.
    */
@@ -235,8 +293,20 @@ class RpcTcpHandler : public folly::DelayedDestruction {
    */
   Writer writer_{};
 
+  /**
+   * Flushes pendingReplies_ at the end of the current EventBase loop
+   * iteration.
+   */
+  ReplyFlusher replyFlusher_{this};
+
   folly::IOBufQueue readBuf_{folly::IOBufQueue::cacheChainLength()};
 
+  /**
+   * Serialized replies waiting to be written to the socket. Like state_, this
+   * may only be accessed from the socket's EventBase thread.
+   */
+  folly::IOBufQueue pendingReplies_{folly::IOBufQueue::cacheChainLength()};
+
   /**
    * Status for the rpc connection. The State may only be accessed from the
    * socket's eventbase thread. We use this invariant so that we don't have to
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifndef _WIN32
+
+#include "eden/fs/nfs/rpc/ReplyBufferPool.h"
+
+#include <folly/portability/GTest.h>
+
+namespace facebook::eden {
+
+TEST(ReplyBufferPoolTest, acquireGivesEmptyBufferWithTailroom) {
+  auto pool = ReplyBufferPool::create();
+  auto buf = pool->acquire(100);
+  EXPECT_EQ(buf->length(), 0);
+  EXPECT_GE(buf->tailroom(), 100);
+}
+
+TEST(ReplyBufferPoolTest, releasedBuffersAreReused) {
+  auto pool = ReplyBufferPool::create();
+  auto buf = pool->acquire(100);
+  const void* data = buf->data();
+  buf.reset();
+  EXPECT_GT(pool->cachedBytes(), 0);
+
+  auto reused = pool->acquire(100);
+  EXPECT_EQ(reused->data(), data);
+  EXPECT_EQ(pool->cachedBytes(), 0);
+}
+
+TEST(ReplyBufferPoolTest, highWaterMarkBoundsCachedBytes) {
+  auto pool = ReplyBufferPool::create();
+
+  std::vector<std::unique_ptr<folly::IOBuf>> bufs;
+  for (int i = 0; i < 20; i++) {
+    bufs.push_back(pool->acquire(100));
+  }
+  auto capacity = bufs[0]->tailroom();
+  bufs.clear();
+
+  // Only the high-water mark worth of buffers stays cached, the rest are
+  // freed on release.
+  EXPECT_GT(pool->cachedBytes(), 0);
+  EXPECT_LT(pool->cachedBytes(), 20 * capacity);
+}
+
+TEST(ReplyBufferPoolTest, oversizedBuffersAreNotCached) {
+  auto pool = ReplyBufferPool::create();
+  auto buf = pool->acquire(1024 * 1024);
+  EXPECT_GE(buf->tailroom(), 1024 * 1024);
+  buf.reset();
+  EXPECT_EQ(pool->cachedBytes(), 0);
+}
+
+TEST(ReplyBufferPoolTest, buffersCanOutliveThePool) {
+  auto pool = ReplyBufferPool::create();
+  auto buf = pool->acquire(100);
+  pool.reset();
+
+  // The in-flight buffer keeps the pool state alive; releasing it after
+  // the last external reference is dropped must be safe.
+  buf.reset();
+}
+
+} // namespace facebook::eden
+
+#endif
@@ -48,6 +48,19 @@ void serialize_iobuf(
   addPadding(appender, len);
 }
 
+void serialize_iobuf(
+    folly::io::QueueAppender& appender,
+    std::unique_ptr<folly::IOBuf> buf) {
+  auto len = buf->computeChainDataLength();
+  if (len > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error(
+        "XDR cannot encode variable sized array bigger than 4GB");
+  }
+  XdrTrait<uint32_t>::serialize(appender, folly::to_narrow(len));
+  appender.insert(std::move(buf));
+  addPadding(appender, len);
+}
+
 } // namespace detail
 
 } // namespace facebook::eden
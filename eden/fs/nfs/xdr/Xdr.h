@@ -9,9 +9,11 @@
 
 #ifndef _WIN32
 
+#include <fmt/format.h>
 #include <folly/Preprocessor.h>
 #include <folly/io/Cursor.h>
 #include <optional>
+#include <utility>
 #include <variant>
 
 // https://tools.ietf.org/html/rfc4506
@@ -48,6 +50,11 @@
         const STRUCT& a) {                                    \
       FOLLY_PP_FOR_EACH(EDEN_XDR_SER, __VA_ARGS__)            \
     }                                                         \
+    static void serialize(                                    \
+        folly::io::QueueAppender& appender,                   \
+        STRUCT&& a) {                                         \
+      FOLLY_PP_FOR_EACH(EDEN_XDR_SER_MOVE, __VA_ARGS__)       \
+    }                                                         \
     static STRUCT deserialize(folly::io::Cursor& cursor) {    \
       STRUCT ret;                                             \
       FOLLY_PP_FOR_EACH(EDEN_XDR_DE, __VA_ARGS__)             \
@@ -70,6 +77,12 @@
 #define EDEN_XDR_SER(name) \
   XdrTrait<decltype(a.name)>::serialize(appender, a.name);
 
+// Same as EDEN_XDR_SER, but for serializing an rvalue struct. Fields whose
+// XdrTrait has an rvalue serialize overload (such as IOBuf chains) can then
+// hand their data to the appender without copying it.
+#define EDEN_XDR_SER_MOVE(name) \
+  XdrTrait<decltype(a.name)>::serialize(appender, std::move(a.name));
+
 // This is a helper called by FOLLY_PP_FOR_EACH. It emits a call to
 // the de-serializer for a given field name.
 #define EDEN_XDR_DE(name) \
@@ -209,6 +222,15 @@ void serialize_iobuf(
     folly::io::QueueAppender& appender,
     const folly::IOBuf& buf);
 
+/**
+ * Serialize an IOBuf chain, transferring ownership of the chain to the
+ * appender. This avoids cloning the chain, and thus should be preferred over
+ * the const reference version above when the buffer is no longer needed.
+ */
+void serialize_iobuf(
+    folly::io::QueueAppender& appender,
+    std::unique_ptr<folly::IOBuf> buf);
+
 /**
  * Skip the padding bytes that were written during serialization.
  */
@@ -310,6 +332,12 @@ struct XdrTrait<std::unique_ptr<folly::IOBuf>> {
     detail::serialize_iobuf(appender, *buf);
   }
 
+  static void serialize(
+      folly::io::QueueAppender& appender,
+      std::unique_ptr<folly::IOBuf>&& buf) {
+    detail::serialize_iobuf(appender, std::move(buf));
+  }
+
   static std::unique_ptr<folly::IOBuf> deserialize(folly::io::Cursor& cursor) {
     auto len = XdrTrait<uint32_t>::deserialize(cursor);
     auto ret = std::make_unique<folly::IOBuf>();
@@ -381,6 +409,92 @@ struct XdrTrait<std::string> {
   }
 };
 
+/**
+ * A string deserialized as a borrowed view into the receive buffer.
+ *
+ * Deserializing a std::string copies the bytes out of the cursor. For
+ * strings in request types on the per-request hot path that copy is
+ * avoidable: the RPC server keeps the receive buffer alive until the request
+ * handler's future completes, so the handler can read the bytes in place. An
+ * XdrStringView borrows the bytes when they are contiguous in the cursor's
+ * current buffer, and only falls back to an owned copy when the string
+ * straddles a chained-buffer boundary.
+ *
+ * A deserialized XdrStringView is invalidated when the buffer it was
+ * deserialized from is released; handlers must copy the bytes out (say, into
+ * a PathComponent) if they need them past the end of the request.
+ */
+class XdrStringView {
+ public:
+  XdrStringView() = default;
+  /* implicit */ XdrStringView(folly::StringPiece view) : storage_{view} {}
+  /* implicit */ XdrStringView(const char* str)
+      : storage_{folly::StringPiece{str}} {}
+  /* implicit */ XdrStringView(std::string owned)
+      : storage_{std::move(owned)} {}
+
+  folly::StringPiece piece() const {
+    if (auto* view = std::get_if<folly::StringPiece>(&storage_)) {
+      return *view;
+    }
+    return std::get<std::string>(storage_);
+  }
+
+  size_t size() const {
+    return piece().size();
+  }
+
+  size_t length() const {
+    return size();
+  }
+
+  bool empty() const {
+    return piece().empty();
+  }
+
+  std::string str() const {
+    return piece().str();
+  }
+
+ private:
+  std::variant<folly::StringPiece, std::string> storage_;
+};
+
+inline bool operator==(const XdrStringView& a, const XdrStringView& b) {
+  return a.piece() == b.piece();
+}
+
+inline bool operator==(const XdrStringView& a, folly::StringPiece b) {
+  return a.piece() == b;
+}
+
+template <>
+struct XdrTrait<XdrStringView> {
+  static void serialize(
+      folly::io::QueueAppender& appender,
+      const XdrStringView& value) {
+    detail::serialize_variable(appender, folly::ByteRange(value.piece()));
+  }
+
+  static XdrStringView deserialize(folly::io::Cursor& cursor) {
+    auto len = XdrTrait<uint32_t>::deserialize(cursor);
+    if (cursor.length() >= detail::roundUp(len)) {
+      folly::StringPiece view{
+          reinterpret_cast<const char*>(cursor.data()), len};
+      cursor.skip(detail::roundUp(len));
+      return XdrStringView{view};
+    }
+    auto ret = XdrStringView{cursor.readFixedString(len)};
+    detail::skipPadding(cursor, len);
+    return ret;
+  }
+
+  static size_t serializedSize(const XdrStringView& value) {
+    return XdrTrait<uint32_t>::serializedSize(0) +
+        detail::roundUp(value.size());
+  }
+};
+
 /**
  * Common implementation for XDR discriminated union. Creating a new variant
  * can be done by doing the following:
@@ -426,6 +540,20 @@ struct XdrTrait<XdrVariant<Enum, Vars...>> {
         value.v);
   }
 
+  static void serialize(
+      folly::io::QueueAppender& appender,
+      XdrVariant<Enum, Vars...>&& value) {
+    XdrTrait<Enum>::serialize(appender, value.tag);
+    std::visit(
+        [&appender](auto&& arg) {
+          using ArgType = std::decay_t<decltype(arg)>;
+          if constexpr (!std::is_same_v<ArgType, std::monostate>) {
+            XdrTrait<ArgType>::serialize(appender, std::move(arg));
+          }
+        },
+        std::move(value.v));
+  }
+
   static size_t serializedSize(const XdrVariant<Enum, Vars...>& value) {
     return XdrTrait<Enum>::serializedSize(value.tag) +
         std::visit(
@@ -627,4 +755,14 @@ struct XdrTrait<std::optional<T>> {
 
 } // namespace facebook::eden
 
+template <>
+struct fmt::formatter<facebook::eden::XdrStringView> : formatter<string_view> {
+  template <typename Context>
+  auto format(const facebook::eden::XdrStringView& str, Context& ctx) const {
+    auto piece = str.piece();
+    return formatter<string_view>::format(
+        string_view{piece.data(), piece.size()}, ctx);
+  }
+};
+
 #endif
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifndef _WIN32
+
+#include "eden/fs/nfs/xdr/Xdr.h"
+
+#include <folly/io/IOBufQueue.h>
+
+#include "eden/common/utils/benchharness/Bench.h"
+
+namespace facebook::eden {
+
+namespace {
+
+struct BenchStruct {
+  uint32_t number;
+  uint64_t bigNumber;
+  std::string str;
+  std::vector<uint32_t> numbers;
+};
+EDEN_XDR_SERDE_DECL(BenchStruct, number, bigNumber, str, numbers);
+EDEN_XDR_SERDE_IMPL(BenchStruct, number, bigNumber, str, numbers);
+
+BenchStruct makeBenchStruct() {
+  return BenchStruct{
+      42,
+      1ull << 40,
+      "the quick brown fox jumps over the lazy dog",
+      {1, 2, 3, 4, 5, 6, 7, 8}};
+}
+
+void serialize_struct(benchmark::State& state) {
+  auto value = makeBenchStruct();
+  for (auto _ : state) {
+    folly::IOBufQueue queue{folly::IOBufQueue::cacheChainLength()};
+    folly::io::QueueAppender appender{&queue, 1024};
+    XdrTrait<BenchStruct>::serialize(appender, value);
+    benchmark::DoNotOptimize(queue.chainLength());
+  }
+}
+BENCHMARK(serialize_struct);
+
+void deserialize_struct(benchmark::State& state) {
+  auto value = makeBenchStruct();
+  folly::IOBufQueue queue{folly::IOBufQueue::cacheChainLength()};
+  folly::io::QueueAppender appender{&queue, 1024};
+  XdrTrait<BenchStruct>::serialize(appender, value);
+  auto buf = queue.move();
+
+  for (auto _ : state) {
+    folly::io::Cursor cursor{buf.get()};
+    benchmark::DoNotOptimize(XdrTrait<BenchStruct>::deserialize(cursor));
+  }
+}
+BENCHMARK(deserialize_struct);
+
+void serialized_size_struct(benchmark::State& state) {
+  auto value = makeBenchStruct();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(XdrTrait<BenchStruct>::serializedSize(value));
+  }
+}
+BENCHMARK(serialized_size_struct);
+
+} // namespace
+
+} // namespace facebook::eden
+
+EDEN_BENCHMARK_MAIN();
+
+#endif
@@ -139,6 +139,36 @@ TEST(XdrSerialize, iobuf) {
   roundtrip(std::move(buf));
 }
 
+TEST(XdrSerialize, iobufMoveSerialize) {
+  auto makeBuf = [] { return folly::IOBuf::copyBuffer("This is a test"); };
+
+  // Serializing from an rvalue hands the chain to the appender without
+  // cloning it, but the bytes on the wire must be identical.
+  auto copySer = ser(makeBuf());
+
+  folly::IOBufQueue queue;
+  folly::io::QueueAppender appender(&queue, 1024);
+  XdrTrait<std::unique_ptr<folly::IOBuf>>::serialize(appender, makeBuf());
+  auto moveSer = queue.move();
+
+  EXPECT_TRUE(folly::IOBufEqualTo()(copySer, moveSer));
+
+  auto decoded = de<std::unique_ptr<folly::IOBuf>>(std::move(moveSer));
+  EXPECT_TRUE(folly::IOBufEqualTo()(decoded, makeBuf()));
+}
+
+TEST(XdrSerialize, structsMoveSerialize) {
+  MySerializableStruct s{123, "hello world"};
+
+  folly::IOBufQueue queue;
+  folly::io::QueueAppender appender(&queue, 1024);
+  XdrTrait<MySerializableStruct>::serialize(
+      appender, MySerializableStruct{123, "hello world"});
+
+  auto decoded = de<MySerializableStruct>(queue.move());
+  EXPECT_EQ(s, decoded);
+}
+
 struct ListElement {
   uint32_t value;
 };
@@ -163,6 +193,43 @@ TEST(XdrSerialize, list) {
   roundtrip(head);
 }
 
+TEST(XdrSerialize, stringView) {
+  XdrStringView str{"hello world"};
+  EXPECT_EQ(XdrTrait<XdrStringView>::serializedSize(str), 4 + 12);
+
+  auto encoded = ser(str);
+  folly::io::Cursor cursor(encoded.get());
+  auto decoded = XdrTrait<XdrStringView>::deserialize(cursor);
+  EXPECT_TRUE(cursor.isAtEnd());
+  EXPECT_EQ(str, decoded);
+
+  // The decoded string borrows from the serialized buffer rather than
+  // copying out of it.
+  EXPECT_EQ(
+      reinterpret_cast<const void*>(decoded.piece().data()),
+      reinterpret_cast<const void*>(encoded->data() + sizeof(uint32_t)));
+}
+
+TEST(XdrSerialize, stringViewChained) {
+  XdrStringView str{"hello world"};
+  auto encoded = ser(str);
+
+  // Split the serialized bytes mid-string to force the owned-copy fallback.
+  auto bytes = encoded->coalesce();
+  auto split = folly::IOBuf::copyBuffer(bytes.data(), 8);
+  split->appendChain(
+      folly::IOBuf::copyBuffer(bytes.data() + 8, bytes.size() - 8));
+
+  folly::io::Cursor cursor(split.get());
+  auto decoded = XdrTrait<XdrStringView>::deserialize(cursor);
+  EXPECT_TRUE(cursor.isAtEnd());
+  EXPECT_EQ(str, decoded);
+
+  // The fallback owns its bytes and must survive the buffer.
+  split.reset();
+  EXPECT_EQ(decoded, "hello world");
+}
+
 TEST(XdrSerialize, optional) {
   std::optional<uint32_t> nullOpt{std::nullopt};
   roundtrip(nullOpt);
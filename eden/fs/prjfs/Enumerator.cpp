@@ -41,25 +41,29 @@ bool PrjfsDirEntry::operator<(const PrjfsDirEntry& other) const {
   return PrjFileNameCompare(name_.c_str(), other.name_.c_str()) < 0;
 }
 
-Enumerator::Enumerator(std::vector<PrjfsDirEntry> entryList)
-    : metadataList_(std::move(entryList)), iter_{metadataList_.begin()} {
+Enumerator::Enumerator(std::shared_ptr<std::vector<PrjfsDirEntry>> entryList)
+    : metadataList_(std::move(entryList)), iter_{metadataList_->begin()} {}
+
+std::shared_ptr<std::vector<PrjfsDirEntry>> Enumerator::makeSortedSnapshot(
+    std::vector<PrjfsDirEntry> entryList) {
   std::sort(
-      metadataList_.begin(),
-      metadataList_.end(),
+      entryList.begin(),
+      entryList.end(),
       [](const PrjfsDirEntry& first, const PrjfsDirEntry& second) -> bool {
         return first < second;
       });
+  return std::make_shared<std::vector<PrjfsDirEntry>>(std::move(entryList));
 }
 
 void Enumerator::advanceEnumeration() {
-  XDCHECK_NE(iter_, metadataList_.end());
+  XDCHECK_NE(iter_, metadataList_->end());
 
-  while (iter_ != metadataList_.end() &&
+  while (iter_ != metadataList_->end() &&
          !iter_->matchPattern(searchExpression_)) {
     ++iter_;
   }
 
-  if (iter_ == metadataList_.end()) {
+  if (iter_ == metadataList_->end()) {
     return;
   }
 
@@ -69,7 +73,7 @@ void Enumerator::advanceEnumeration() {
 std::vector<ImmediateFuture<PrjfsDirEntry::Ready>>
 Enumerator::getPendingDirEntries() {
   std::vector<ImmediateFuture<PrjfsDirEntry::Ready>> ret;
-  for (auto it = iter_; it != metadataList_.end(); it++) {
+  for (auto it = iter_; it != metadataList_->end(); it++) {
     if (it->matchPattern(searchExpression_)) {
       ret.push_back(it->getFuture());
     }
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <folly/futures/FutureSplitter.h>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -74,17 +75,27 @@ class Enumerator {
   Enumerator(const Enumerator&) = delete;
   Enumerator& operator=(const Enumerator&) = delete;
 
-  explicit Enumerator(std::vector<PrjfsDirEntry> entryList);
+  explicit Enumerator(std::shared_ptr<std::vector<PrjfsDirEntry>> entryList);
   Enumerator(Enumerator&& other) = default;
 
   explicit Enumerator() = delete;
 
+  /**
+   * Sort the entries the way ProjectedFS expects them to be enumerated and
+   * wrap them in a snapshot that can back several Enumerator at once.
+   *
+   * The returned snapshot is never mutated: concurrent enumeration sessions
+   * of the same directory keep their own cursor and only read from it.
+   */
+  static std::shared_ptr<std::vector<PrjfsDirEntry>> makeSortedSnapshot(
+      std::vector<PrjfsDirEntry> entryList);
+
   std::vector<ImmediateFuture<PrjfsDirEntry::Ready>> getPendingDirEntries();
 
   void advanceEnumeration();
 
   void restartEnumeration() {
-    iter_ = metadataList_.begin();
+    iter_ = metadataList_->begin();
   }
 
   bool isSearchExpressionEmpty() const {
@@ -97,7 +108,14 @@ class Enumerator {
 
  private:
   std::wstring searchExpression_;
-  std::vector<PrjfsDirEntry> metadataList_;
+
+  /**
+   * Sorted directory entries, potentially shared with the enumeration cache
+   * and with other sessions enumerating the same directory. The vector itself
+   * is immutable after construction; PrjfsDirEntry::getFuture is safe to call
+   * from several sessions concurrently.
+   */
+  std::shared_ptr<std::vector<PrjfsDirEntry>> metadataList_;
 
   /**
    * Iterator on the first directory entry that didn't get send to ProjectedFS.
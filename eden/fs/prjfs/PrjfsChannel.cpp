@@ -9,6 +9,8 @@
 
 #include "eden/fs/prjfs/PrjfsChannel.h"
 #include <fmt/format.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <folly/logging/xlog.h>
 
 #include "eden/common/utils/StringConv.h"
@@ -17,6 +19,7 @@
 #include "eden/fs/prjfs/PrjfsDispatcher.h"
 #include "eden/fs/prjfs/PrjfsRequestContext.h"
 #include "eden/fs/utils/Bug.h"
+#include "eden/fs/utils/EdenTaskQueue.h"
 #include "eden/fs/utils/Guid.h"
 #include "eden/fs/utils/ImmediateFuture.h"
 #include "eden/fs/utils/NotImplemented.h"
@@ -32,6 +35,12 @@ namespace {
 // PrjfsTraceBus. TraceBus uses 2 * capacity * sizeof(TraceEvent) memory usage,
 // so limit total memory usage to around 1 MB per mount.
 constexpr size_t kTraceBusCapacity = 25000;
+
+// Sizing of the pool performing the blocking PrjWritePlaceholderInfo calls.
+// The queue bound applies backpressure on a runaway recursive enumeration
+// rather than letting placeholder work pile up unboundedly.
+constexpr size_t kNumPlaceholderThreads = 2;
+constexpr size_t kMaxInflightPlaceholders = 1024;
 static_assert(CheckSize<PrjfsTraceEvent, 48>());
 static_assert(
     CheckEqual<1200000, kTraceBusCapacity * sizeof(PrjfsTraceEvent)>());
@@ -358,6 +367,10 @@ PrjfsChannelInner::PrjfsChannelInner(
     std::shared_ptr<Notifier> notifier)
     : dispatcher_(std::move(dispatcher)),
       straceLogger_(straceLogger),
+      placeholderPool_(std::make_shared<folly::CPUThreadPoolExecutor>(
+          kNumPlaceholderThreads,
+          std::make_unique<EdenTaskQueue>(kMaxInflightPlaceholders),
+          std::make_unique<folly::NamedThreadFactory>("PrjfsPlaceholder"))),
       notifier_(std::move(notifier)),
       processAccessLog_(processAccessLog),
       deletedPromise_(std::move(deletedPromise)),
@@ -566,38 +579,49 @@ HRESULT PrjfsChannelInner::getPlaceholderInfo(
     return dispatcher_
         ->lookup(std::move(path), context->getObjectFetchContext())
         .thenValue(
-            [context, virtualizationContext = virtualizationContext](
+            [this, context, virtualizationContext = virtualizationContext](
                 std::optional<LookupResult>&& optLookupResult)
                 -> ImmediateFuture<folly::Unit> {
               if (!optLookupResult) {
                 context->sendError(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
                 return folly::unit;
               }
-              const auto& lookupResult = optLookupResult.value();
-
-              PRJ_PLACEHOLDER_INFO placeholderInfo{};
-              placeholderInfo.FileBasicInfo.IsDirectory = lookupResult.isDir;
-              placeholderInfo.FileBasicInfo.FileSize = lookupResult.size;
-              auto inodeName = lookupResult.path.wide();
-
-              HRESULT result = PrjWritePlaceholderInfo(
-                  virtualizationContext,
-                  inodeName.c_str(),
-                  &placeholderInfo,
-                  sizeof(placeholderInfo));
-
-              if (FAILED(result)) {
-                return makeImmediateFuture<folly::Unit>(
-                    makeHResultErrorExplicit(
-                        result,
-                        fmt::format(
-                            FMT_STRING("Writing placeholder for {}"),
-                            lookupResult.path)));
-              }
 
-              context->sendSuccess();
-
-              return folly::unit;
+              // PrjWritePlaceholderInfo blocks until the placeholder is on
+              // disk. Run it on the dedicated placeholder pool so that a
+              // lookup that resolved immediately doesn't perform disk IO on
+              // the ProjectedFS callback thread and serialize
+              // enumeration-triggered hydration.
+              return ImmediateFuture{
+                  folly::via(
+                      placeholderPool_.get(),
+                      [context,
+                       virtualizationContext,
+                       lookupResult = std::move(optLookupResult).value()] {
+                        PRJ_PLACEHOLDER_INFO placeholderInfo{};
+                        placeholderInfo.FileBasicInfo.IsDirectory =
+                            lookupResult.isDir;
+                        placeholderInfo.FileBasicInfo.FileSize =
+                            lookupResult.size;
+                        auto inodeName = lookupResult.path.wide();
+
+                        HRESULT result = PrjWritePlaceholderInfo(
+                            virtualizationContext,
+                            inodeName.c_str(),
+                            &placeholderInfo,
+                            sizeof(placeholderInfo));
+
+                        if (FAILED(result)) {
+                          throw makeHResultErrorExplicit(
+                              result,
+                              fmt::format(
+                                  FMT_STRING("Writing placeholder for {}"),
+                                  lookupResult.path));
+                        }
+
+                        context->sendSuccess();
+                      })
+                      .semi()};
             });
   });
 
@@ -1025,6 +1049,9 @@ ImmediateFuture<folly::Unit> PrjfsChannelInner::fileRenamed(
   } else if (newPath.empty()) {
     return fileHandleClosedFileDeleted(
         std::move(oldPath), RelativePath{}, isDirectory, context);
+  } else if (isDirectory) {
+    return dispatcher_->dirRenamed(
+        std::move(oldPath), std::move(newPath), context);
   } else {
     return dispatcher_->fileRenamed(
         std::move(oldPath), std::move(newPath), context);
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <folly/Executor.h>
 #include <folly/experimental/AtomicReadMostlyMainPtr.h>
 #include <folly/portability/Windows.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
@@ -348,7 +349,9 @@ class PrjfsChannelInner {
     return *straceLogger_;
   }
 
-  void addDirectoryEnumeration(Guid guid, std::vector<PrjfsDirEntry> dirents) {
+  void addDirectoryEnumeration(
+      Guid guid,
+      std::shared_ptr<std::vector<PrjfsDirEntry>> dirents) {
     auto [iterator, inserted] = enumSessions_.wlock()->emplace(
         std::move(guid), std::make_shared<Enumerator>(std::move(dirents)));
     XDCHECK(inserted);
@@ -381,6 +384,13 @@ class PrjfsChannelInner {
   std::unique_ptr<PrjfsDispatcher> dispatcher_;
   const folly::Logger* const straceLogger_{nullptr};
 
+  // Dedicated pool with a bounded queue on which the blocking
+  // PrjWritePlaceholderInfo calls are performed. Without it, a lookup that
+  // resolved immediately would write its placeholder inline on the
+  // ProjectedFS callback thread, serializing enumeration-triggered
+  // hydration on ProjectedFS's own small worker pool.
+  std::shared_ptr<folly::Executor> placeholderPool_;
+
   std::shared_ptr<Notifier> notifier_;
 
   // The processAccessLog_ is owned by PrjfsChannel which is guaranteed to have
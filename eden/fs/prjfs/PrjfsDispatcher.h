@@ -41,8 +41,11 @@ class PrjfsDispatcher {
 
   /**
    * Open a directory
+   *
+   * The returned snapshot is sorted in enumeration order and is immutable: it
+   * may be shared with other concurrent enumerations of the same directory.
    */
-  virtual ImmediateFuture<std::vector<PrjfsDirEntry>> opendir(
+  virtual ImmediateFuture<std::shared_ptr<std::vector<PrjfsDirEntry>>> opendir(
       RelativePath path,
       const ObjectFetchContextPtr& context) = 0;
 
@@ -101,6 +104,17 @@ class PrjfsDispatcher {
       RelativePath newPath,
       const ObjectFetchContextPtr& context) = 0;
 
+  /**
+   * Notification sent when a directory is renamed
+   *
+   * Separate from fileRenamed so implementations can move the whole
+   * directory in one step instead of reconciling every descendant.
+   */
+  virtual ImmediateFuture<folly::Unit> dirRenamed(
+      RelativePath oldPath,
+      RelativePath newPath,
+      const ObjectFetchContextPtr& context) = 0;
+
   /**
    * Notification sent when a directory is about to be renamed
    *
@@ -36,6 +36,8 @@
 #include "eden/fs/store/BackingStoreLogger.h"
 #include "eden/fs/store/EmptyBackingStore.h"
 #include "eden/fs/store/LocalStoreCachedBackingStore.h"
+#include "eden/fs/store/PeerCachedBackingStore.h"
+#include "eden/fs/store/PeerObjectCache.h"
 #include "eden/fs/store/hg/HgQueuedBackingStore.h"
 #include "eden/fs/telemetry/IHiveLogger.h"
 #include "eden/fs/telemetry/SessionInfo.h"
@@ -143,7 +145,7 @@ void EdenMain::registerStandardBackingStores() {
         reloadableConfig,
         params.sharedStats,
         params.serverState->getStructuredLogger());
-    return std::make_shared<LocalStoreCachedBackingStore>(
+    std::shared_ptr<BackingStore> hgStore =
         std::make_shared<HgQueuedBackingStore>(
             params.localStore,
             params.sharedStats,
@@ -152,9 +154,34 @@ void EdenMain::registerStandardBackingStores() {
             params.serverState->getStructuredLogger(),
             std::make_unique<BackingStoreLogger>(
                 params.serverState->getStructuredLogger(),
-                params.serverState->getProcessNameCache())),
-        params.localStore,
-        params.sharedStats);
+                params.serverState->getProcessNameCache()));
+
+    // When a LAN peer cache is configured, slot it in between the local
+    // store and the origin so the lookup order is RocksDB, peer, origin.
+    auto edenConfig = reloadableConfig->getEdenConfig();
+    auto peerAddress = edenConfig->peerCacheAddress.getValue();
+    if (!peerAddress.empty()) {
+      try {
+        folly::SocketAddress address;
+        address.setFromHostPort(peerAddress);
+        hgStore = std::make_shared<PeerCachedBackingStore>(
+            std::move(hgStore),
+            std::make_shared<PeerObjectCache>(
+                std::move(address),
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    edenConfig->peerCacheIoTimeout.getValue()),
+                params.serverState->getThreadPool()),
+            params.sharedStats);
+      } catch (const std::exception& ex) {
+        // The peer tier is an optimization; a bad address should not keep
+        // the repo from mounting.
+        XLOG(WARN) << "ignoring invalid peer-cache:address '" << peerAddress
+                   << "': " << ex.what();
+      }
+    }
+
+    return std::make_shared<LocalStoreCachedBackingStore>(
+        std::move(hgStore), params.localStore, params.sharedStats);
   });
 
   registerBackingStore(
@@ -11,6 +11,7 @@
 #include <chrono>
 
 #include <sys/stat.h>
+#include <array>
 #include <atomic>
 #include <fstream>
 #include <functional>
@@ -42,8 +43,11 @@
 #include "eden/fs/inodes/EdenMount.h"
 #include "eden/fs/inodes/InodeBase.h"
 #include "eden/fs/inodes/InodeMap.h"
+#include "eden/fs/inodes/MountWarmup.h"
 #include "eden/fs/inodes/TreeInode.h"
 #include "eden/fs/journal/Journal.h"
+#include "eden/fs/journal/JournalPersistentRing.h"
+#include "eden/fs/journal/JournalShmRing.h"
 #include "eden/fs/nfs/NfsServer.h"
 #include "eden/fs/notifications/NullNotifier.h"
 #include "eden/fs/service/EdenCPUThreadPool.h"
@@ -56,11 +60,13 @@
 #include "eden/fs/store/EmptyBackingStore.h"
 #include "eden/fs/store/LocalStore.h"
 #include "eden/fs/store/LocalStoreCachedBackingStore.h"
+#include "eden/fs/store/PeerCachedBackingStore.h"
 #include "eden/fs/store/MemoryLocalStore.h"
 #include "eden/fs/store/ObjectStore.h"
 #include "eden/fs/store/RocksDbLocalStore.h"
 #include "eden/fs/store/SqliteLocalStore.h"
 #include "eden/fs/store/TreeCache.h"
+#include "eden/fs/store/WorkingSetSnapshot.h"
 #include "eden/fs/store/hg/HgBackingStore.h"
 #include "eden/fs/store/hg/HgQueuedBackingStore.h"
 #include "eden/fs/telemetry/EdenStats.h"
@@ -74,6 +80,7 @@
 #include "eden/fs/utils/EnumValue.h"
 #include "eden/fs/utils/FileUtils.h"
 #include "eden/fs/utils/FsChannelTypes.h"
+#include "eden/fs/utils/Memory.h"
 #include "eden/fs/utils/NfsSocket.h"
 #include "eden/fs/utils/NotImplemented.h"
 #include "eden/fs/utils/PathFuncs.h"
@@ -85,6 +92,7 @@
 #include "eden/fs/fuse/FuseChannel.h"
 #include "eden/fs/inodes/Overlay.h"
 #include "eden/fs/notifications/CommandNotifier.h"
+#include "eden/fs/takeover/BlobCacheSegment.h"
 #include "eden/fs/takeover/TakeoverClient.h"
 #include "eden/fs/takeover/TakeoverData.h"
 #include "eden/fs/takeover/TakeoverServer.h"
@@ -132,6 +140,12 @@ DEFINE_int64(
     unload_age_minutes,
     6 * 60,
     "Minimum age of the inodes to be unloaded in background");
+DEFINE_uint64(
+    unload_soft_limit_inodes,
+    0,
+    "When non-zero, background inode unloading only sweeps mounts with more "
+    "loaded inodes than this, and keeps sweeping at a one minute cadence "
+    "while a mount stays above it");
 
 DEFINE_uint64(
     maximumBlobCacheSize,
@@ -141,6 +155,11 @@ DEFINE_uint64(
     minimumBlobCacheEntryCount,
     16,
     "The minimum number of recent blobs to keep cached. Trumps maximumBlobCacheSize");
+DEFINE_uint64(
+    maximumCompressedBlobCacheSize,
+    10 * 1024 * 1024,
+    "How many bytes worth of zstd-compressed evicted blobs to keep in memory "
+    "as a second-chance tier. Set to 0 to disable the compressed tier");
 
 using apache::thrift::ThriftServer;
 using folly::Future;
@@ -332,6 +351,15 @@ class EdenServer::ThriftServerEventHandler
 
 static constexpr folly::StringPiece kBlobCacheMemory{"blob_cache.memory"};
 
+/**
+ * Depth gauges for the priority lanes of the main CPU thread pool, lowest
+ * priority first.
+ */
+static constexpr std::array<folly::StringPiece, 3> kThreadPoolLaneDepths{
+    "thread_pool.lo_pri.depth",
+    "thread_pool.mid_pri.depth",
+    "thread_pool.hi_pri.depth"};
+
 EdenServer::EdenServer(
     std::vector<std::string> originalCommandLine,
     UserInfo userInfo,
@@ -348,7 +376,8 @@ EdenServer::EdenServer(
       backingStoreFactory_{backingStoreFactory},
       blobCache_{BlobCache::create(
           FLAGS_maximumBlobCacheSize,
-          FLAGS_minimumBlobCacheEntryCount)},
+          FLAGS_minimumBlobCacheEntryCount,
+          FLAGS_maximumCompressedBlobCacheSize)},
       config_{std::make_shared<ReloadableConfig>(edenConfig)},
       mountPoints_{std::make_shared<folly::Synchronized<MountMap>>(
           MountMap{kPathMapDefaultCaseSensitive})},
@@ -378,6 +407,13 @@ EdenServer::EdenServer(
     return this->getBlobCache()->getStats().totalSizeInBytes;
   });
 
+  for (size_t lane = 0; lane < kThreadPoolLaneDepths.size(); ++lane) {
+    counters->registerCallback(kThreadPoolLaneDepths[lane], [this, lane] {
+      auto depths = serverState_->getThreadPool()->getLaneDepths();
+      return lane < depths.size() ? depths[lane] : 0;
+    });
+  }
+
   registerInodePopulationReportsCallback();
 
   for (auto stage : RequestMetricsScope::requestStages) {
@@ -417,6 +453,10 @@ EdenServer::~EdenServer() {
   auto counters = fb303::ServiceData::get()->getDynamicCounters();
   counters->unregisterCallback(kBlobCacheMemory);
 
+  for (const auto& laneCounter : kThreadPoolLaneDepths) {
+    counters->unregisterCallback(laneCounter);
+  }
+
   unregisterInodePopulationReportsCallback();
 
   for (auto stage : RequestMetricsScope::requestStages) {
@@ -631,11 +671,14 @@ Future<TakeoverData> EdenServer::stopMountsForTakeover(
   // Use collectAll() rather than collect() to wait for all of the unmounts
   // to complete, and only check for errors once everything has finished.
   return folly::collectAll(futures).toUnsafeFuture().thenValue(
-      [takeoverPromise = std::move(takeoverPromise)](
+      [takeoverPromise = std::move(takeoverPromise), blobCache = blobCache_](
           std::vector<folly::Try<optional<TakeoverData::MountInfo>>>
               results) mutable {
         TakeoverData data;
         data.takeoverComplete = std::move(takeoverPromise);
+        // Hand the hot blob set to the new process; losing it would mean an
+        // I/O storm for the first minutes after takeover.
+        data.blobCacheSegment = serializeBlobCacheSegment(*blobCache);
         data.mountPoints.reserve(results.size());
         for (auto& result : results) {
           // If something went wrong shutting down a mount point,
@@ -669,6 +712,8 @@ void EdenServer::startPeriodicTasks() {
   memoryStatsTask_.updateInterval(30s);
   auto config = serverState_->getReloadableConfig()->getEdenConfig();
   updatePeriodicTaskIntervals(*config);
+  SampledDurationScope::setSamplingInterval(
+      config->stageSamplingInterval.getValue());
 
 #ifndef _WIN32
   // Schedule a periodic job to unload unused inodes based on the last access
@@ -707,6 +752,16 @@ void EdenServer::updatePeriodicTaskIntervals(const EdenConfig& config) {
   localStoreTask_.updateInterval(
       std::chrono::duration_cast<std::chrono::milliseconds>(
           config.localStoreManagementInterval.getValue()));
+
+  // rebalanceCacheBudget() is a no-op when store:cache-memory-budget is 0,
+  // so the task can run unconditionally at the configured interval.
+  cacheBudgetTask_.updateInterval(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          config.cacheBudgetRebalanceInterval.getValue()));
+
+  workingSetTask_.updateInterval(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          config.workingSetSnapshotInterval.getValue()));
 }
 
 void EdenServer::scheduleCallbackOnMainEventBase(
@@ -773,21 +828,47 @@ void EdenServer::unloadInodes() {
     }
   }
 
+  // When a soft limit is configured, the sweep only runs for mounts whose
+  // loaded-inode count exceeds it, so mounts with a small working set keep
+  // their warm inodes. Mounts still above the limit after a sweep are
+  // revisited at a one minute cadence instead of waiting out the full
+  // interval: the age cutoff spares anything accessed since the last pass,
+  // so repeated short sweeps trickle cold inodes out a slice at a time
+  // rather than unloading millions at once in one stall.
+  const uint64_t softLimit = FLAGS_unload_soft_limit_inodes;
+  auto loadedInodes = [](const std::shared_ptr<EdenMount>& mount) {
+    auto counts = mount->getInodeMap()->getInodeCounts();
+    return counts.fileCount + counts.treeCount;
+  };
+  bool overSoftLimit = false;
+
   if (!roots.empty()) {
     auto cutoff = std::chrono::system_clock::now() -
         std::chrono::minutes(FLAGS_unload_age_minutes);
     auto cutoff_ts = folly::to<timespec>(cutoff);
     for (auto& [name, rootInode, mount] : roots) {
+      if (softLimit != 0 && loadedInodes(mount) <= softLimit) {
+        continue;
+      }
       auto unloaded = rootInode->unloadChildrenLastAccessedBefore(cutoff_ts);
       if (unloaded) {
         XLOG(INFO) << "Unloaded " << unloaded
                    << " inodes in background from mount " << name;
       }
       mount->getInodeMap()->recordPeriodicInodeUnload(unloaded);
+      if (softLimit != 0 && loadedInodes(mount) > softLimit) {
+        overSoftLimit = true;
+      }
     }
   }
 
-  scheduleInodeUnload(std::chrono::minutes(FLAGS_unload_interval_minutes));
+  auto interval = std::chrono::milliseconds(
+      std::chrono::minutes(FLAGS_unload_interval_minutes));
+  if (overSoftLimit) {
+    interval = std::min(
+        interval, std::chrono::milliseconds(std::chrono::minutes(1)));
+  }
+  scheduleInodeUnload(interval);
 }
 
 void EdenServer::scheduleInodeUnload(std::chrono::milliseconds timeout) {
@@ -822,6 +903,14 @@ Future<Unit> EdenServer::recoverImpl(TakeoverData&& takeoverData) {
   edenDir_.takeoverLock(std::move(takeoverData.lockFile));
   server_->useExistingSocket(takeoverData.thriftSocket.release());
 
+  // Rehydrate the blob cache from the old process' cache segment, if one was
+  // transferred, so we don't start with a cold cache.
+  if (takeoverData.blobCacheSegment.has_value()) {
+    restoreBlobCacheSegment(
+        std::move(takeoverData.blobCacheSegment.value()), *blobCache_);
+    takeoverData.blobCacheSegment.reset();
+  }
+
   // Remount our mounts from our prepared takeoverData
   std::vector<Future<Unit>> mountFutures;
   mountFutures = prepareMountsTakeover(
@@ -886,7 +975,9 @@ Future<Unit> EdenServer::prepareImpl(std::shared_ptr<StartupLogger> logger) {
     logger->log(
         "Requesting existing edenfs process to gracefully "
         "transfer its mount points...");
+    folly::stop_watch<std::chrono::milliseconds> takeoverWatch;
     takeoverData = takeoverMounts(takeoverPath);
+    startupPhaseTimings_.record("takeover transfer", takeoverWatch.elapsed());
     logger->log(
         "Received takeover information for ",
         takeoverData.mountPoints.size(),
@@ -895,6 +986,14 @@ Future<Unit> EdenServer::prepareImpl(std::shared_ptr<StartupLogger> logger) {
     // Take over the eden lock file and the thrift server socket.
     edenDir_.takeoverLock(std::move(takeoverData.lockFile));
     server_->useExistingSocket(takeoverData.thriftSocket.release());
+
+    // Warm the blob cache from the old process' cache segment, if one was
+    // transferred.
+    if (takeoverData.blobCacheSegment.has_value()) {
+      restoreBlobCacheSegment(
+          std::move(takeoverData.blobCacheSegment.value()), *blobCache_);
+      takeoverData.blobCacheSegment.reset();
+    }
 #else
     NOT_IMPLEMENTED();
 #endif // !_WIN32
@@ -924,11 +1023,13 @@ Future<Unit> EdenServer::prepareImpl(std::shared_ptr<StartupLogger> logger) {
   // TODO: The "state config" only has one configuration knob now. When
   // another is required, introduce an EdenStateConfig class to manage
   // defaults and save on update.
+  folly::stop_watch<std::chrono::milliseconds> storageWatch;
   auto config = parseConfig();
   bool shouldSaveConfig = createStorageEngine(*config);
   if (shouldSaveConfig) {
     saveConfig(*config);
   }
+  startupPhaseTimings_.record("local store creation", storageWatch.elapsed());
 
 #ifndef _WIN32
   // Start listening for graceful takeover requests
@@ -951,6 +1052,12 @@ Future<Unit> EdenServer::prepareImpl(std::shared_ptr<StartupLogger> logger) {
        thriftRunningFuture = std::move(thriftRunningFuture)]() mutable {
         openStorageEngine(*logger);
 
+        // A takeover hands over a warm process, so only a cold start
+        // benefits from restoring the snapshotted working set.
+        if (!doingTakeover) {
+          prewarmCachesFromSnapshot();
+        }
+
         std::vector<Future<Unit>> mountFutures;
         if (doingTakeover) {
 #ifndef _WIN32
@@ -966,7 +1073,13 @@ Future<Unit> EdenServer::prepareImpl(std::shared_ptr<StartupLogger> logger) {
         // Return a future that will complete only when all mount points have
         // started and the thrift server is also running.
         mountFutures.emplace_back(std::move(thriftRunningFuture));
-        return folly::collectAllUnsafe(std::move(mountFutures)).unit();
+        folly::stop_watch<std::chrono::milliseconds> mountWatch;
+        return folly::collectAllUnsafe(std::move(mountFutures))
+            .thenValue([this, logger, mountWatch](auto&&) {
+              startupPhaseTimings_.record(
+                  "mount initialization", mountWatch.elapsed());
+              startupPhaseTimings_.logReport(*logger);
+            });
       });
 }
 
@@ -1030,10 +1143,18 @@ bool EdenServer::createStorageEngine(cpptoml::table& config) {
     localStore_ = make_shared<RocksDbLocalStore>(
         rocksPath,
         serverState_->getStructuredLogger(),
-        &serverState_->getFaultInjector());
+        &serverState_->getFaultInjector(),
+        RocksDBOpenMode::ReadWrite,
+        config_);
     localStore_->enableBlobCaching.store(
         serverState_->getEdenConfig()->enableBlobCaching.getValue(),
         std::memory_order_relaxed);
+    localStore_->blobChunkingThreshold.store(
+        serverState_->getEdenConfig()->localStoreBlobChunkingThreshold.getValue(),
+        std::memory_order_relaxed);
+    localStore_->compressBlobs.store(
+        serverState_->getEdenConfig()->localStoreCompressBlobs.getValue(),
+        std::memory_order_relaxed);
     XLOG(DBG2) << "Created RocksDB store in "
                << watch.elapsed().count() / 1000.0 << " seconds.";
   } else {
@@ -1041,6 +1162,10 @@ bool EdenServer::createStorageEngine(cpptoml::table& config) {
         folly::to<string>("invalid storage engine: ", storageEngine));
   }
 
+  // Deserialize large objects on the Eden CPU pool so a big prefetch does not
+  // parse every tree serially on the thread completing the store fetches.
+  localStore_->setDeserializationPool(serverState_->getThreadPool());
+
   return configUpdated;
 }
 
@@ -1048,10 +1173,28 @@ void EdenServer::openStorageEngine(StartupLogger& logger) {
   logger.log("Opening local store...");
   folly::stop_watch<std::chrono::milliseconds> watch;
   localStore_->open();
+  startupPhaseTimings_.record("local store open", watch.elapsed());
   logger.log(
       "Opened local store in ", watch.elapsed().count() / 1000.0, " seconds.");
 }
 
+void EdenServer::StartupPhaseTimings::record(
+    std::string_view phase,
+    std::chrono::milliseconds duration) {
+  phases_.wlock()->emplace_back(std::string{phase}, duration);
+}
+
+void EdenServer::StartupPhaseTimings::logReport(StartupLogger& logger) const {
+  auto phases = phases_.rlock();
+  if (phases->empty()) {
+    return;
+  }
+  logger.log("Startup phase timing:");
+  for (const auto& [phase, duration] : *phases) {
+    logger.log("  ", phase, ": ", duration.count() / 1000.0, " seconds");
+  }
+}
+
 std::vector<Future<Unit>> EdenServer::prepareMountsTakeover(
     shared_ptr<StartupLogger> logger,
     std::vector<TakeoverData::MountInfo>&& takeoverMounts) {
@@ -1065,6 +1208,7 @@ std::vector<Future<Unit>> EdenServer::prepareMountsTakeover(
 
   for (auto& info : takeoverMounts) {
     const auto stateDirectory = info.stateDirectory;
+    folly::stop_watch<std::chrono::milliseconds> mountWatch;
     auto mountFuture =
         makeFutureWith([&] {
           auto initialConfig = CheckoutConfig::loadFromClientDirectory(
@@ -1074,9 +1218,12 @@ std::vector<Future<Unit>> EdenServer::prepareMountsTakeover(
           return mount(
               std::move(initialConfig), false, [](auto) {}, std::move(info));
         })
-            .thenTry([logger, mountPath = info.mountPath](
+            .thenTry([this, logger, mountPath = info.mountPath, mountWatch](
                          folly::Try<std::shared_ptr<EdenMount>>&& result) {
               if (result.hasValue()) {
+                startupPhaseTimings_.record(
+                    fmt::format("takeover {}", mountPath),
+                    mountWatch.elapsed());
                 logger->log("Successfully took over mount ", mountPath);
                 return makeFuture();
               } else {
@@ -1128,6 +1275,7 @@ std::vector<Future<Unit>> EdenServer::prepareMounts(
       auto progressIndex = progressManager_->wlock()->registerEntry(
           client.first.asString(), initialConfig->getOverlayPath().c_str());
 
+      folly::stop_watch<std::chrono::milliseconds> mountWatch;
       return mount(
                  std::move(initialConfig),
                  false,
@@ -1135,9 +1283,12 @@ std::vector<Future<Unit>> EdenServer::prepareMounts(
                    progressManager_->wlock()->manageProgress(
                        logger, progressIndex, percent);
                  })
-          .thenTry([this, logger, mountPath, progressIndex](
+          .thenTry([this, logger, mountPath, progressIndex, mountWatch](
                        folly::Try<std::shared_ptr<EdenMount>>&& result) {
             if (result.hasValue()) {
+              startupPhaseTimings_.record(
+                  fmt::format("remount {}", mountPath),
+                  mountWatch.elapsed());
               auto wl = progressManager_->wlock();
               wl->finishProgress(progressIndex);
               wl->printProgresses(logger);
@@ -1401,6 +1552,64 @@ void EdenServer::unregisterStats(EdenMount* edenMount) {
 #endif // __linux__
 }
 
+void EdenServer::subscribeHgImportTracePerf(
+    const std::shared_ptr<EdenMount>& edenMount) {
+  const auto& aggregator = edenMount->getTracePerfAggregator();
+  if (!aggregator) {
+    return;
+  }
+
+  auto backingStore = edenMount->getObjectStore()->getBackingStore();
+  // TODO: remove these dynamic casts in favor of a QueryInterface method
+  auto hgBackingStore =
+      std::dynamic_pointer_cast<HgQueuedBackingStore>(backingStore);
+  if (!hgBackingStore) {
+    if (auto cachedStore =
+            std::dynamic_pointer_cast<LocalStoreCachedBackingStore>(
+                backingStore)) {
+      auto inner = cachedStore->getBackingStore();
+      if (auto peerStore =
+              std::dynamic_pointer_cast<PeerCachedBackingStore>(inner)) {
+        inner = peerStore->getBackingStore();
+      }
+      hgBackingStore = std::dynamic_pointer_cast<HgQueuedBackingStore>(inner);
+    }
+  }
+  if (!hgBackingStore) {
+    return;
+  }
+
+  auto handle = hgBackingStore->getTraceBus().subscribeFunction(
+      fmt::format("trace-perf-{}", edenMount->getPath().basename()),
+      [aggregator](const HgImportTraceEvent& event) {
+        const bool isTree =
+            event.resourceType == HgImportTraceEvent::ResourceType::TREE;
+        switch (event.eventType) {
+          case HgImportTraceEvent::QUEUE:
+            aggregator->recordImportQueue(
+                event.unique, isTree, event.monotonicTime);
+            break;
+          case HgImportTraceEvent::START:
+            aggregator->recordImportStart(
+                event.unique, isTree, event.monotonicTime);
+            break;
+          case HgImportTraceEvent::FINISH:
+            aggregator->recordImportFinish(
+                event.unique,
+                isTree,
+                event.importCause == ObjectFetchContext::Cause::Fs,
+                event.monotonicTime);
+            break;
+        }
+      });
+
+  const auto mountPoints = mountPoints_->wlock();
+  auto iter = mountPoints->find(edenMount->getPath());
+  if (iter != mountPoints->end()) {
+    iter->second.hgImportTracePerfHandle = std::move(handle);
+  }
+}
+
 void EdenServer::registerInodePopulationReportsCallback() {
   getServerState()->getNotifier()->registerInodePopulationReportCallback(
       [mountPoints = mountPoints_]() -> std::vector<InodePopulationReport> {
@@ -1515,6 +1724,32 @@ folly::Future<std::shared_ptr<EdenMount>> EdenServer::mount(
       serverState_->getReloadableConfig()->getEdenConfig(),
       initialConfig->getCaseSensitive());
   auto journal = std::make_unique<Journal>(getSharedStats());
+  if (serverState_->getReloadableConfig()
+          ->getEdenConfig()
+          ->journalShmRing.getValue()) {
+    try {
+      journal->setShmRing(std::make_unique<JournalShmRing>(
+          initialConfig->getClientDirectory() + "journal.ring"_pc));
+    } catch (const std::exception& ex) {
+      // The ring is an optimization for external subscribers; the Thrift
+      // journal APIs still work without it.
+      XLOG(WARN) << "unable to create shared-memory journal ring for "
+                 << initialConfig->getMountPath() << ": " << ex.what();
+    }
+  }
+  if (serverState_->getReloadableConfig()
+          ->getEdenConfig()
+          ->journalPersistentRing.getValue()) {
+    try {
+      journal->setPersistentRing(std::make_unique<JournalPersistentRing>(
+          initialConfig->getClientDirectory() + "journal.persistent"_pc));
+    } catch (const std::exception& ex) {
+      // Without the ring the journal still works; subscribers just cannot
+      // resume across a restart and will recrawl as before.
+      XLOG(WARN) << "unable to open persistent journal ring for "
+                 << initialConfig->getMountPath() << ": " << ex.what();
+    }
+  }
 
   // Create the EdenMount object and insert the mount into the mountPoints_ map.
   auto edenMount = EdenMount::create(
@@ -1527,12 +1762,29 @@ folly::Future<std::shared_ptr<EdenMount>> EdenServer::mount(
 
   registerStats(edenMount);
 
+  // Subscribe before initialize() so imports issued while the mount starts
+  // up are already aggregated.
+  subscribeHgImportTracePerf(edenMount);
+
   const bool doTakeover = optionalTakeover.has_value();
 
+  // When the old daemon transferred the inode map as a memory-backed
+  // segment, hand the fd straight to EdenMount so the InodeMap is built
+  // from the mapped records; this also avoids copying the thrift inode map
+  // for the common case.
+  std::optional<folly::File> takeoverInodeMapSegment;
+  if (doTakeover && optionalTakeover->inodeMapSegment.has_value()) {
+    takeoverInodeMapSegment =
+        std::move(optionalTakeover->inodeMapSegment.value());
+    optionalTakeover->inodeMapSegment.reset();
+  }
+
   auto initFuture = edenMount->initialize(
       std::move(progressCallback),
-      doTakeover ? std::make_optional(optionalTakeover->inodeMap)
-                 : std::nullopt);
+      doTakeover && !takeoverInodeMapSegment.has_value()
+          ? std::make_optional(optionalTakeover->inodeMap)
+          : std::nullopt,
+      std::move(takeoverInodeMapSegment));
 
   // Now actually begin starting the mount point
   return std::move(initFuture)
@@ -1617,11 +1869,36 @@ folly::Future<std::shared_ptr<EdenMount>> EdenServer::mount(
               event.success = !t.hasException();
               event.clean = edenMount->getOverlay()->hadCleanStartup();
               serverState_->getStructuredLogger()->logEvent(event);
+              // A takeover mount arrives with warm caches; only freshly
+              // started mounts benefit from walking the working set.
+              if (!doTakeover && !t.hasException()) {
+                maybeStartMountWarmup(edenMount);
+              }
               return makeFuture(std::move(t));
             });
       });
 }
 
+void EdenServer::maybeStartMountWarmup(
+    const std::shared_ptr<EdenMount>& edenMount) {
+  if (!serverState_->getReloadableConfig()
+           ->getEdenConfig()
+           ->warmupAfterClone.getValue()) {
+    return;
+  }
+  auto paths = readWarmupManifest(*edenMount->getCheckoutConfig());
+  if (paths.empty()) {
+    return;
+  }
+  auto state = edenMount->getWarmupState();
+  if (state->running.exchange(true)) {
+    return;
+  }
+  folly::futures::detachOn(
+      getServerState()->getThreadPool().get(),
+      warmupMount(edenMount, std::move(paths), std::move(state)).semi());
+}
+
 Future<Unit> EdenServer::unmount(AbsolutePathPiece mountPath) {
   return makeFutureWith([&] {
            auto future = Future<Unit>::makeEmpty();
@@ -1760,7 +2037,8 @@ Future<CheckoutResult> EdenServer::checkOutRevision(
     std::optional<folly::StringPiece> rootHgManifest,
     std::optional<pid_t> clientPid,
     StringPiece callerName,
-    CheckoutMode checkoutMode) {
+    CheckoutMode checkoutMode,
+    bool stopOnFirstConflict) {
   auto edenMount = getMount(mountPath);
   auto rootId = edenMount->getObjectStore()->parseRootId(rootHash);
   if (rootHgManifest.has_value()) {
@@ -1779,7 +2057,9 @@ Future<CheckoutResult> EdenServer::checkOutRevision(
   // the +1 is so we count the current checkout that hasn't quite started yet
   getServerState()->getNotifier()->signalCheckout(
       enumerateInProgressCheckouts() + 1);
-  return edenMount->checkout(rootId, clientPid, callerName, checkoutMode)
+  return edenMount
+      ->checkout(
+          rootId, clientPid, callerName, checkoutMode, stopOnFirstConflict)
       .via(mainEventBase_)
       .thenValue([this, checkoutMode, edenMount, mountPath = mountPath.copy()](
                      CheckoutResult&& result) {
@@ -1882,8 +2162,15 @@ EdenServer::getHgQueuedBackingStores() {
       } else if (
           auto store = std::dynamic_pointer_cast<LocalStoreCachedBackingStore>(
               entry.second)) {
-        auto inner_store = std::dynamic_pointer_cast<HgQueuedBackingStore>(
-            store->getBackingStore());
+        auto inner = store->getBackingStore();
+        // A peer cache tier may sit between the local-store cache and the
+        // hg store; look through it.
+        if (auto peerStore =
+                std::dynamic_pointer_cast<PeerCachedBackingStore>(inner)) {
+          inner = peerStore->getBackingStore();
+        }
+        auto inner_store =
+            std::dynamic_pointer_cast<HgQueuedBackingStore>(inner);
         if (inner_store) {
           // dynamic_pointer_cast returns a copy of the shared pointer, so it is
           // safe to be moved
@@ -2146,6 +2433,21 @@ void EdenServer::reportMemoryStats() {
     fb303::ServiceData::get()->addStatValue(
         kRssBytes, memoryStats->resident, fb303::AVG);
   }
+
+  for (const auto& arena : getMemoryArenaStats()) {
+    if (!arena.supported) {
+      continue;
+    }
+    fb303::ServiceData::get()->setCounter(
+        fmt::format("memory_arena.{}.allocated_bytes", arena.name),
+        arena.allocatedBytes);
+    fb303::ServiceData::get()->setCounter(
+        fmt::format("memory_arena.{}.active_bytes", arena.name),
+        arena.activeBytes);
+    fb303::ServiceData::get()->setCounter(
+        fmt::format("memory_arena.{}.mapped_bytes", arena.name),
+        arena.mappedBytes);
+  }
 }
 
 void EdenServer::manageLocalStore() {
@@ -2154,6 +2456,166 @@ void EdenServer::manageLocalStore() {
   localStore_->periodicManagementTask(*config);
 }
 
+void EdenServer::rebalanceCacheBudget() {
+  auto config = serverState_->getReloadableConfig()->getEdenConfig(
+      ConfigReloadBehavior::NoReload);
+  auto budget = config->cacheMemoryBudget.getValue();
+  if (budget == 0) {
+    // No unified budget configured; each cache keeps its statically
+    // configured maximum size.
+    return;
+  }
+
+  // Estimate the memory pinned by loaded inodes and reserve it off the top
+  // of the budget.  InodeMap does not track exact per-inode memory, so use a
+  // rough per-inode constant; the clamp below keeps the caches from being
+  // starved entirely when a mount has a huge loaded-inode population.
+  constexpr size_t kEstimatedBytesPerLoadedInode = 1024;
+  size_t loadedInodes = 0;
+  for (const auto& mount : getMountPoints()) {
+    auto counts = mount->getInodeMap()->getInodeCounts();
+    loadedInodes += counts.fileCount + counts.treeCount;
+  }
+  auto inodeEstimate = loadedInodes * kEstimatedBytesPerLoadedInode;
+  auto available = std::max<uint64_t>(
+      budget > inodeEstimate ? budget - inodeEstimate : 0, budget / 4);
+
+  // Give the RocksDB block cache a fixed share when it is shared (see
+  // `store:block-cache-size`); it has no per-interval miss statistics, so we
+  // do not bid it against the in-memory caches.
+  auto rocksDbStore = std::dynamic_pointer_cast<RocksDbLocalStore>(localStore_);
+  if (rocksDbStore && rocksDbStore->getBlockCacheCapacity() > 0) {
+    auto blockCacheShare = available / 4;
+    rocksDbStore->setBlockCacheCapacity(blockCacheShare);
+    available -= blockCacheShare;
+  }
+
+  // Split the remainder between the blob and tree caches in proportion to
+  // their recent miss pressure: the number of misses since the last
+  // rebalance, weighted by the cache's average object size so a blob miss
+  // (typically far more bytes refetched) counts for more than a tree miss.
+  // An exponential moving average smooths out bursty intervals.
+  constexpr double kPressureDecay = 0.5;
+  constexpr size_t kDefaultObjectSizeEstimate = 4096;
+  auto computePressure = [&](const auto& stats,
+                             uint64_t& lastMissCount,
+                             double& pressure) {
+    auto deltaMisses = stats.missCount - lastMissCount;
+    lastMissCount = stats.missCount;
+    auto avgObjectSize = stats.objectCount > 0
+        ? stats.totalSizeInBytes / stats.objectCount
+        : kDefaultObjectSizeEstimate;
+    pressure = kPressureDecay * pressure +
+        (1.0 - kPressureDecay) *
+            static_cast<double>(deltaMisses * avgObjectSize);
+  };
+  computePressure(
+      blobCache_->getStats(), lastBlobCacheMissCount_, blobCacheMissPressure_);
+  computePressure(
+      treeCache_->getStats(), lastTreeCacheMissCount_, treeCacheMissPressure_);
+
+  // Keep a 10% floor for each cache so a temporarily idle cache can still
+  // serve hits and generate the miss signal needed to win budget back.
+  auto totalPressure = blobCacheMissPressure_ + treeCacheMissPressure_;
+  double blobFraction = totalPressure > 0.0
+      ? blobCacheMissPressure_ / totalPressure
+      : 0.5;
+  blobFraction = std::min(std::max(blobFraction, 0.1), 0.9);
+  auto blobBudget = static_cast<size_t>(available * blobFraction);
+  blobCache_->setMaximumCacheSizeBytes(blobBudget);
+  treeCache_->setMaximumCacheSizeBytes(available - blobBudget);
+
+  XLOG(DBG4) << "cache budget rebalance: budget=" << budget
+             << " inodeEstimate=" << inodeEstimate
+             << " blobBudget=" << blobBudget
+             << " treeBudget=" << (available - blobBudget)
+             << " blobPressure=" << blobCacheMissPressure_
+             << " treePressure=" << treeCacheMissPressure_;
+}
+
+void EdenServer::snapshotWorkingSet() {
+  // Collect the IDs on the main thread; getAllObjects only copies pointers
+  // and hashes.  Serialization and the store write move to the background
+  // pool.
+  WorkingSet workingSet;
+  for (const auto& blob : blobCache_->getAllObjects()) {
+    workingSet.blobs.push_back(blob->getHash());
+  }
+  for (const auto& tree : treeCache_->getAllObjects()) {
+    workingSet.trees.push_back(tree->getHash());
+  }
+  if (workingSet.blobs.empty() && workingSet.trees.empty()) {
+    return;
+  }
+
+  folly::futures::detachOn(
+      getServerState()->getThreadPool().get(),
+      folly::makeSemiFuture().deferValue(
+          [this, workingSet = std::move(workingSet)](auto&&) {
+            auto data = serializeWorkingSet(workingSet);
+            localStore_->put(
+                KeySpace::WorkingSetFamily,
+                folly::ByteRange{kWorkingSetKey},
+                folly::ByteRange{folly::StringPiece{data}});
+            XLOG(DBG4) << "snapshotted working set: "
+                       << workingSet.blobs.size() << " blobs, "
+                       << workingSet.trees.size() << " trees";
+          }));
+}
+
+void EdenServer::prewarmCachesFromSnapshot() {
+  auto config = serverState_->getReloadableConfig()->getEdenConfig();
+  if (config->workingSetSnapshotInterval.getValue() <=
+      std::chrono::nanoseconds::zero()) {
+    return;
+  }
+
+  folly::futures::detachOn(
+      getServerState()->getThreadPool().get(),
+      folly::makeSemiFuture().deferValue([this](auto&&) {
+        auto result = localStore_->get(
+            KeySpace::WorkingSetFamily, folly::ByteRange{kWorkingSetKey});
+        if (!result.isValid()) {
+          return;
+        }
+        WorkingSet workingSet;
+        try {
+          workingSet = deserializeWorkingSet(result.bytes());
+        } catch (const std::invalid_argument& ex) {
+          XLOG(WARN) << "ignoring unreadable working set snapshot: "
+                     << ex.what();
+          return;
+        }
+
+        // Load the objects one at a time on this single background lane so
+        // pre-warming never competes with live requests for store threads.
+        // Only the LocalStore is consulted; an object that has been garbage
+        // collected since the snapshot is skipped, not refetched.
+        size_t loaded = 0;
+        try {
+          for (const auto& id : workingSet.trees) {
+            if (auto tree = localStore_->getTree(id).get()) {
+              treeCache_->insert(std::shared_ptr<const Tree>{std::move(tree)});
+              ++loaded;
+            }
+          }
+          for (const auto& id : workingSet.blobs) {
+            if (auto blob = localStore_->getBlob(id).get()) {
+              blobCache_->insert(
+                  std::shared_ptr<const Blob>{std::move(blob)},
+                  BlobCache::Interest::LikelyNeededAgain);
+              ++loaded;
+            }
+          }
+        } catch (const std::exception& ex) {
+          XLOG(WARN) << "cache pre-warm aborted: " << folly::exceptionStr(ex);
+        }
+        XLOG(DBG2) << "cache pre-warm restored " << loaded << " of "
+                   << (workingSet.blobs.size() + workingSet.trees.size())
+                   << " snapshotted objects";
+      }));
+}
+
 void EdenServer::refreshBackingStore() {
   std::vector<shared_ptr<BackingStore>> backingStores;
   {
@@ -2169,11 +2631,44 @@ void EdenServer::refreshBackingStore() {
 }
 
 void EdenServer::manageOverlay() {
+  auto config = serverState_->getReloadableConfig()->getEdenConfig(
+      ConfigReloadBehavior::NoReload);
+
   const auto mountPoints = mountPoints_->rlock();
   for (const auto& [_, info] : *mountPoints) {
     const auto& mount = info.edenMount;
 
     mount->getOverlay()->maintenance();
+
+#ifndef _WIN32
+    if (config->overlayDematerializeUnmodifiedFiles.getValue()) {
+      // Run the scan on the server thread pool rather than the main event
+      // base: hashing overlay files is blocking disk I/O.
+      auto* pool = serverState_->getThreadPool().get();
+      folly::futures::detachOn(
+          pool,
+          folly::via(
+              pool,
+              [mount = mount,
+               maxFiles =
+                   config->overlayDematerializeMaxFilesPerRun.getValue()] {
+                return mount->dematerializeUnmodifiedFiles(maxFiles).semi();
+              })
+              .thenValue([mountPath = mount->getPath()](
+                             uint64_t numDematerialized) {
+                if (numDematerialized > 0) {
+                  XLOG(DBG2) << "dematerialized " << numDematerialized
+                             << " unmodified files in " << mountPath;
+                }
+              })
+              .thenError([mountPath = mount->getPath()](
+                             folly::exception_wrapper&& ew) {
+                XLOG(WARN) << "error dematerializing unmodified files in "
+                           << mountPath << ": " << ew;
+              })
+              .semi());
+    }
+#endif
   }
 }
 
@@ -2189,6 +2684,8 @@ void EdenServer::reloadConfig() {
   mainEventBase_->runImmediatelyOrRunInEventBaseThreadAndWait(
       [this, config = std::move(config)] {
         updatePeriodicTaskIntervals(*config);
+        SampledDurationScope::setSamplingInterval(
+            config->stageSamplingInterval.getValue());
       });
 }
 
@@ -13,6 +13,7 @@
 #include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -38,6 +39,7 @@
 #include "eden/fs/telemetry/EdenStats.h"
 #include "eden/fs/telemetry/IActivityRecorder.h"
 #include "eden/fs/telemetry/RequestMetricsScope.h"
+#include "eden/fs/telemetry/TraceBus.h"
 #include "eden/fs/utils/Clock.h"
 #include "eden/fs/utils/PathFuncs.h"
 #include "eden/fs/utils/PathMap.h"
@@ -62,6 +64,7 @@ namespace facebook::eden {
 
 class BackingStore;
 class HgQueuedBackingStore;
+struct HgImportTraceEvent;
 class IHiveLogger;
 class BlobCache;
 class TreeCache;
@@ -312,7 +315,8 @@ class EdenServer : private TakeoverHandler {
       std::optional<folly::StringPiece> rootHgManifest,
       std::optional<pid_t> clientPid,
       folly::StringPiece callerName,
-      CheckoutMode checkoutMode);
+      CheckoutMode checkoutMode,
+      bool stopOnFirstConflict = false);
 
   std::shared_ptr<LocalStore> getLocalStore() const {
     return localStore_;
@@ -468,6 +472,13 @@ class EdenServer : private TakeoverHandler {
     std::shared_ptr<EdenMount> edenMount;
     folly::SharedPromise<folly::Unit> unmountPromise;
     std::optional<folly::Promise<TakeoverData::MountInfo>> takeoverPromise;
+    /**
+     * Keeps the mount's TracePerfAggregator subscribed to its backing
+     * store's hg import trace bus for the mount's lifetime. Held here
+     * rather than in EdenMount because the backing store is owned at the
+     * server level; see subscribeHgImportTracePerf.
+     */
+    TraceSubscriptionHandle<HgImportTraceEvent> hgImportTracePerfHandle;
 
     explicit EdenMountInfo(const std::shared_ptr<EdenMount>& mount)
         : edenMount(mount),
@@ -525,6 +536,23 @@ class EdenServer : private TakeoverHandler {
       std::shared_ptr<StartupLogger> logger);
   static void incrementStartupMountFailures();
 
+  /**
+   * Records how long each phase of daemon startup took so that prepare() can
+   * log a breakdown through the StartupLogger once all mounts are up.
+   *
+   * Thread-safe: mount initialization phases complete on multiple threads.
+   */
+  class StartupPhaseTimings {
+   public:
+    void record(std::string_view phase, std::chrono::milliseconds duration);
+    void logReport(StartupLogger& logger) const;
+
+   private:
+    folly::Synchronized<
+        std::vector<std::pair<std::string, std::chrono::milliseconds>>>
+        phases_;
+  };
+
 #ifndef _WIN32
   /**
    * recoverImpl() contains the bulk of the implementation of recover()
@@ -592,6 +620,24 @@ class EdenServer : private TakeoverHandler {
   void registerStats(std::shared_ptr<EdenMount> edenMount);
   void unregisterStats(EdenMount* edenMount);
 
+  /**
+   * Subscribe the mount's TracePerfAggregator to the hg import trace bus of
+   * the mount's backing store, so import queue-wait and fetch stages feed
+   * the mount's rolling per-operation aggregation. A no-op for mounts with
+   * trace perf disabled or a backing store that is not hg-backed. Import
+   * events are per-store, so a store shared by several mounts reports its
+   * imports to each of their aggregations.
+   */
+  void subscribeHgImportTracePerf(const std::shared_ptr<EdenMount>& edenMount);
+
+  /**
+   * Kick off a background working-set warm-up for a freshly started mount
+   * when mount:warmup-after-clone is enabled and the checkout has a recorded
+   * manifest. See MountWarmup.h. Does nothing when either is missing or a
+   * warm-up is already running.
+   */
+  void maybeStartMountWarmup(const std::shared_ptr<EdenMount>& edenMount);
+
   // Registers inode population reports callback with the notifier.
   void registerInodePopulationReportsCallback();
   void unregisterInodePopulationReportsCallback();
@@ -603,6 +649,32 @@ class EdenServer : private TakeoverHandler {
   // necessary
   void manageLocalStore();
 
+  /**
+   * Rebalance the unified cache memory budget (`store:cache-memory-budget`)
+   * across the RocksDB block cache, BlobCache and TreeCache, reserving an
+   * estimate of loaded inode memory off the top. Cache limits are shifted
+   * toward whichever cache shows the most recent miss pressure, weighted by
+   * its average object size.
+   */
+  void rebalanceCacheBudget();
+
+  /**
+   * Snapshot the object IDs currently resident in the BlobCache and
+   * TreeCache into the LocalStore (`store:working-set-snapshot-interval`).
+   * Serialization and the store write happen on the background thread pool.
+   */
+  void snapshotWorkingSet();
+
+  /**
+   * Load the most recent working set snapshot from the LocalStore and
+   * stream the named objects back into the BlobCache and TreeCache, so a
+   * restarted or rebooted daemon does not start the day with cold caches.
+   * Runs entirely on the background thread pool and only reads from the
+   * LocalStore; objects no longer present locally are skipped, never
+   * fetched.
+   */
+  void prewarmCachesFromSnapshot();
+
   // some backing store may require periodic maintenance, specifically rust
   // datapack store needs to release file descriptor it holds every once in a
   // while.
@@ -759,6 +831,8 @@ class EdenServer : private TakeoverHandler {
 
   const std::unique_ptr<folly::Synchronized<ProgressManager>> progressManager_;
 
+  StartupPhaseTimings startupPhaseTimings_;
+
   PeriodicFnTask<&EdenServer::reloadConfig> reloadConfigTask_{
       this,
       "reload_config"};
@@ -775,5 +849,25 @@ class EdenServer : private TakeoverHandler {
       this,
       "backing_store"};
   PeriodicFnTask<&EdenServer::manageOverlay> overlayTask_{this, "overlay"};
+  PeriodicFnTask<&EdenServer::rebalanceCacheBudget> cacheBudgetTask_{
+      this,
+      "cache_budget"};
+  PeriodicFnTask<&EdenServer::snapshotWorkingSet> workingSetTask_{
+      this,
+      "working_set"};
+
+  /**
+   * Miss counts observed by the previous rebalanceCacheBudget run, used to
+   * compute per-interval miss pressure.
+   */
+  uint64_t lastBlobCacheMissCount_{0};
+  uint64_t lastTreeCacheMissCount_{0};
+
+  /**
+   * Exponential moving averages of miss pressure (recent misses weighted by
+   * average object size), smoothing the budget split across intervals.
+   */
+  double blobCacheMissPressure_{0.0};
+  double treeCacheMissPressure_{0.0};
 };
 } // namespace facebook::eden
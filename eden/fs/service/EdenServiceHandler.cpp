@@ -24,6 +24,8 @@
 #include <folly/logging/Logger.h>
 #include <folly/logging/LoggerDB.h>
 #include <folly/logging/xlog.h>
+#include <folly/portability/Fcntl.h>
+#include <folly/portability/Stat.h>
 #include <folly/stop_watch.h>
 #include <folly/system/Shell.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
@@ -37,6 +39,7 @@
 #include "eden/fs/inodes/InodeError.h"
 #include "eden/fs/inodes/InodeMap.h"
 #include "eden/fs/inodes/InodeTable.h"
+#include "eden/fs/inodes/MountWarmup.h"
 #include "eden/fs/inodes/Overlay.h"
 #include "eden/fs/inodes/Traverse.h"
 #include "eden/fs/inodes/TreeInode.h"
@@ -45,6 +48,7 @@
 #include "eden/fs/model/Blob.h"
 #include "eden/fs/model/BlobMetadata.h"
 #include "eden/fs/model/Hash.h"
+#include "eden/fs/model/git/GlobMatcher.h"
 #include "eden/fs/model/Tree.h"
 #include "eden/fs/model/TreeEntry.h"
 #include "eden/fs/nfs/Nfsd3.h"
@@ -61,17 +65,25 @@
 #include "eden/fs/store/Diff.h"
 #include "eden/fs/store/LocalStore.h"
 #include "eden/fs/store/LocalStoreCachedBackingStore.h"
+#include "eden/fs/store/PeerCachedBackingStore.h"
 #include "eden/fs/store/ObjectFetchContext.h"
 #include "eden/fs/store/ObjectStore.h"
 #include "eden/fs/store/PathLoader.h"
 #include "eden/fs/store/ScmStatusDiffCallback.h"
+#include "eden/fs/store/TreePrefetcher.h"
 #include "eden/fs/store/hg/HgQueuedBackingStore.h"
+#ifndef _WIN32
+#include "eden/fs/takeover/TakeoverData.h"
+#endif
 #include "eden/fs/telemetry/SessionInfo.h"
+#include "eden/fs/telemetry/TracePerfAggregator.h"
 #include "eden/fs/telemetry/Tracing.h"
 #include "eden/fs/utils/Bug.h"
 #include "eden/fs/utils/Clock.h"
 #include "eden/fs/utils/EdenError.h"
 #include "eden/fs/utils/FaultInjector.h"
+#include "eden/fs/utils/ImmediateFutureAudit.h"
+#include "eden/fs/utils/Memory.h"
 #include "eden/fs/utils/NotImplemented.h"
 #include "eden/fs/utils/ProcUtil.h"
 #include "eden/fs/utils/SourceLocation.h"
@@ -456,7 +468,9 @@ EdenServiceHandler::EdenServiceHandler(
       thriftRequestActivityBuffer_(initThriftRequestActivityBuffer()),
       thriftRequestTraceBus_(TraceBus<ThriftRequestTraceEvent>::create(
           "ThriftRequestTrace",
-          kTraceBusCapacity)) {
+          kTraceBusCapacity)),
+      thriftRequestGovernor_{
+          server->getServerState()->getReloadableConfig()} {
   struct HistConfig {
     int64_t bucketSize{250};
     int64_t min{0};
@@ -607,7 +621,8 @@ EdenServiceHandler::semifuture_checkOutRevision(
                               params->hgRootManifest_ref().to_optional(),
                               helper->getFetchContext()->getClientPid(),
                               helper->getFunctionName(),
-                              checkoutMode)
+                              checkoutMode,
+                              *params->stopOnFirstConflict())
                           .semi()};
 
   return wrapImmediateFuture(
@@ -713,21 +728,94 @@ EdenServiceHandler::semifuture_getSHA1(
   return wrapImmediateFuture(
              std::move(helper),
              std::move(notificationFuture)
-                 .thenValue([this,
-                             mount = std::move(mount),
+                 .thenValue([mount = std::move(mount),
                              paths = std::move(paths),
                              fetchContext =
                                  fetchContext.copy()](auto&&) mutable {
-                   std::vector<ImmediateFuture<Hash20>> futures;
-                   futures.reserve(paths->size());
-                   for (auto& path : *paths) {
-                     futures.push_back(makeImmediateFutureWith([&]() mutable {
-                       return getSHA1ForPath(
-                           *mount, RelativePath{std::move(path)}, fetchContext);
-                     }));
-                   }
-
-                   return collectAll(std::move(futures))
+                   auto rootInode = mount->getRootInode();
+                   auto* objectStore = mount->getObjectStore();
+                   // Resolve every path with a single tree-shaped walk so
+                   // that shared directory prefixes are traversed once
+                   // rather than once per path; getSHA1 calls arrive in
+                   // large batches and the per-path root-to-leaf walk used
+                   // to dominate them.
+                   return ImmediateFuture{collectAll(applyToVirtualInode(
+                              rootInode,
+                              *paths,
+                              [](const VirtualInode& inode) { return inode; },
+                              objectStore,
+                              fetchContext))}
+                       .thenValue(
+                           [paths = std::move(paths),
+                            objectStore,
+                            fetchContext = fetchContext.copy()](
+                               std::vector<folly::Try<VirtualInode>>&&
+                                   inodes) mutable {
+                             // Warm the metadata cache for every entry
+                             // backed by an unmaterialized blob with one
+                             // batched fetch; the per-entry getSHA1 calls
+                             // below then hit the cache instead of issuing
+                             // one fetch each.
+                             std::vector<ObjectId> blobIds;
+                             for (const auto& inode : inodes) {
+                               if (inode.hasValue()) {
+                                 if (auto blobId = inode->getBlobObjectId()) {
+                                   blobIds.push_back(
+                                       std::move(blobId).value());
+                                 }
+                               }
+                             }
+                             auto warmFuture = blobIds.empty()
+                                 ? ImmediateFuture<folly::Unit>{folly::unit}
+                                 : objectStore
+                                       ->getBlobMetadatas(
+                                           blobIds, fetchContext)
+                                       .thenTry(
+                                           [](folly::Try<std::vector<
+                                                  BlobMetadata>>&&) {
+                                             return folly::unit;
+                                           });
+                             return std::move(warmFuture)
+                                 .thenValue([paths = std::move(paths),
+                                             objectStore,
+                                             fetchContext =
+                                                 fetchContext.copy(),
+                                             inodes = std::move(inodes)](
+                                                auto&&) mutable {
+                                   std::vector<ImmediateFuture<Hash20>>
+                                       futures;
+                                   futures.reserve(inodes.size());
+                                   for (size_t i = 0; i < inodes.size();
+                                        ++i) {
+                                     if (paths->at(i).empty()) {
+                                       futures.emplace_back(
+                                           ImmediateFuture<Hash20>(
+                                               newEdenError(
+                                                   EINVAL,
+                                                   EdenErrorType::
+                                                       ARGUMENT_ERROR,
+                                                   "path cannot be the empty string")));
+                                     } else if (inodes[i].hasException()) {
+                                       futures.emplace_back(
+                                           ImmediateFuture<Hash20>{
+                                               inodes[i].exception()});
+                                     } else {
+                                       futures.emplace_back(
+                                           makeImmediateFutureWith([&]() {
+                                             return inodes[i]
+                                                 .value()
+                                                 .getSHA1(
+                                                     RelativePathPiece{
+                                                         paths->at(i)},
+                                                     objectStore,
+                                                     fetchContext);
+                                           }));
+                                     }
+                                   }
+                                   return facebook::eden::collectAll(
+                                       std::move(futures));
+                                 });
+                           })
                        .ensure([mount = std::move(mount)] {});
                  })
                  .thenValue([](std::vector<folly::Try<Hash20>> results) {
@@ -748,58 +836,6 @@ EdenServiceHandler::semifuture_getSHA1(
       .semi();
 }
 
-ImmediateFuture<Hash20> EdenServiceHandler::getSHA1ForPath(
-    const EdenMount& edenMount,
-    RelativePath path,
-    const ObjectFetchContextPtr& fetchContext) {
-  if (path.empty()) {
-    return ImmediateFuture<Hash20>(newEdenError(
-        EINVAL,
-        EdenErrorType::ARGUMENT_ERROR,
-        "path cannot be the empty string"));
-  }
-
-  auto* objectStore = edenMount.getObjectStore();
-  auto inodeFut = edenMount.getVirtualInode(path, fetchContext);
-  return std::move(inodeFut).thenValue(
-      [path = std::move(path), objectStore, fetchContext = fetchContext.copy()](
-          const VirtualInode& virtualInode) {
-        return virtualInode.getSHA1(path, objectStore, fetchContext);
-      });
-}
-
-ImmediateFuture<EntryAttributes> EdenServiceHandler::getEntryAttributesForPath(
-    EntryAttributeFlags reqBitmask,
-    AbsolutePathPiece mountPoint,
-    StringPiece path,
-    const ObjectFetchContextPtr& fetchContext) {
-  if (path.empty()) {
-    return ImmediateFuture<EntryAttributes>(newEdenError(
-        EINVAL,
-        EdenErrorType::ARGUMENT_ERROR,
-        "path cannot be the empty string"));
-  }
-
-  try {
-    auto edenMount = server_->getMount(mountPoint);
-    auto objectStore = edenMount->getObjectStore();
-    auto relativePath = RelativePathPiece{path};
-
-    return edenMount->getVirtualInode(relativePath, fetchContext)
-        .thenValue([reqBitmask,
-                    relativePath,
-                    objectStore,
-                    fetchContext =
-                        fetchContext.copy()](const VirtualInode& virtualInode) {
-          return virtualInode.getEntryAttributes(
-              reqBitmask, relativePath, objectStore, fetchContext);
-        });
-  } catch (const std::exception& e) {
-    return ImmediateFuture<EntryAttributes>(
-        newEdenError(EINVAL, EdenErrorType::ARGUMENT_ERROR, e.what()));
-  }
-}
-
 void EdenServiceHandler::addBindMount(
     FOLLY_MAYBE_UNUSED std::unique_ptr<std::string> mountPoint,
     FOLLY_MAYBE_UNUSED std::unique_ptr<std::string> repoPath,
@@ -1323,9 +1359,14 @@ std::shared_ptr<HgQueuedBackingStore> castToHgQueuedBackingStore(
     hgBackingStore =
         std::dynamic_pointer_cast<HgQueuedBackingStore>(backingStore);
   } else {
-    // LocalStoreCachedBackingStore -> HgQueuedBackingStore
-    hgBackingStore = std::dynamic_pointer_cast<HgQueuedBackingStore>(
-        localStoreCachedBackingStore->getBackingStore());
+    // LocalStoreCachedBackingStore -> HgQueuedBackingStore, possibly
+    // through an intermediate PeerCachedBackingStore tier
+    auto inner = localStoreCachedBackingStore->getBackingStore();
+    if (auto peerCachedBackingStore =
+            std::dynamic_pointer_cast<PeerCachedBackingStore>(inner)) {
+      inner = peerCachedBackingStore->getBackingStore();
+    }
+    hgBackingStore = std::dynamic_pointer_cast<HgQueuedBackingStore>(inner);
   }
 
   if (!hgBackingStore) {
@@ -1699,6 +1740,234 @@ EdenServiceHandler::streamChangesSince(
   return {std::move(result), std::move(serverStream)};
 }
 
+void EdenServiceHandler::changesSinceV2(
+    ChangesSinceV2Result& out,
+    std::unique_ptr<ChangesSinceV2Params> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG3, *params->mountPoint_ref());
+  auto mountPath = absolutePathFromThrift(*params->mountPoint_ref());
+  auto edenMount = server_->getMount(mountPath);
+  const auto& fromPosition = *params->fromPosition_ref();
+
+  checkMountGeneration(fromPosition, edenMount, "fromPosition"sv);
+
+  auto& journal = edenMount->getJournal();
+  const auto fromSequence = *fromPosition.sequenceNumber_ref();
+
+  // Entirely unlike streamChangesSince, nothing here outlives this call:
+  // each page is folded from the journal on demand and the journal itself
+  // holds whatever the client has not consumed yet. The only daemon-side
+  // buffering is the single page being returned.
+  // The configured cap bounds the page even when the client does not ask
+  // for one, so a single response can never materialize an unbounded range.
+  const auto cap = static_cast<Journal::SequenceNumber>(
+      server_->getServerState()
+          ->getEdenConfig()
+          ->journalPagedQueryMaxEntries.getValue());
+  Journal::SequenceNumber pageSize = cap;
+  if (auto maxDeltas = params->maxDeltas_ref();
+      maxDeltas.has_value() && *maxDeltas > 0) {
+    pageSize =
+        std::min(cap, static_cast<Journal::SequenceNumber>(*maxDeltas));
+  }
+  Journal::SequenceNumber through = fromSequence + pageSize;
+
+  // The +1 is because the core merge stops at the item prior to
+  // its limitSequence parameter and we want the changes *since*
+  // the provided sequence number.
+  auto summed = journal.accumulateRange(fromSequence + 1, through);
+
+  // If the page is empty the client is caught up; resume from where it was.
+  out.toPosition_ref() = fromPosition;
+  out.toPosition_ref()->mountGeneration_ref() =
+      edenMount->getMountGeneration();
+  out.hasMore_ref() = false;
+
+  if (!summed) {
+    return;
+  }
+
+  if (summed->isTruncated) {
+    throw newEdenError(
+        EDOM,
+        EdenErrorType::JOURNAL_TRUNCATED,
+        "Journal entry range has been truncated.");
+  }
+
+  RootIdCodec& rootIdCodec = *edenMount->getObjectStore();
+
+  out.toPosition_ref()->sequenceNumber_ref() = summed->toSequence;
+  out.toPosition_ref()->snapshotHash_ref() =
+      rootIdCodec.renderRootId(summed->snapshotTransitions.back());
+  out.hasMore_ref() = summed->toSequence < journal.getLatestSequenceID();
+
+  auto& changes = *out.changes_ref();
+  changes.reserve(
+      summed->changedFilesInOverlay.size() + summed->uncleanPaths.size());
+  for (const auto& entry : summed->changedFilesInOverlay) {
+    const auto& changeInfo = entry.second;
+
+    ScmFileStatus status;
+    if (!changeInfo.existedBefore && changeInfo.existedAfter) {
+      status = ScmFileStatus::ADDED;
+    } else if (changeInfo.existedBefore && !changeInfo.existedAfter) {
+      status = ScmFileStatus::REMOVED;
+    } else {
+      status = ScmFileStatus::MODIFIED;
+    }
+
+    ChangedFileResult& change = changes.emplace_back();
+    change.name_ref() = entry.first.asString();
+    change.status_ref() = status;
+    change.dtype_ref() = static_cast<Dtype>(dtype_t::Unknown);
+  }
+
+  for (const auto& name : summed->uncleanPaths) {
+    ChangedFileResult& change = changes.emplace_back();
+    change.name_ref() = name.asString();
+    change.status_ref() = ScmFileStatus::MODIFIED;
+    change.dtype_ref() = static_cast<Dtype>(dtype_t::Unknown);
+  }
+
+  out.commitTransitions_ref()->reserve(summed->snapshotTransitions.size());
+  for (const auto& hash : summed->snapshotTransitions) {
+    out.commitTransitions_ref()->push_back(rootIdCodec.renderRootId(hash));
+  }
+}
+
+apache::thrift::ResponseAndServerStream<StreamStatusResult, ChangedFileResult>
+EdenServiceHandler::streamStatus(std::unique_ptr<GetScmStatusParams> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL(
+      DBG2,
+      *params->mountPoint_ref(),
+      folly::to<std::string>("commitHash=", logHash(*params->commit_ref())),
+      folly::to<std::string>("listIgnored=", *params->listIgnored_ref()));
+
+  auto mountPath = absolutePathFromThrift(*params->mountPoint_ref());
+  auto edenMount = server_->getMount(mountPath);
+  auto rootId = edenMount->getObjectStore()->parseRootId(*params->commit_ref());
+  auto listIgnored = *params->listIgnored_ref();
+  const auto& enforceParents = server_->getServerState()
+                                   ->getReloadableConfig()
+                                   ->getEdenConfig()
+                                   ->enforceParents.getValue();
+
+  // See streamChangesSince for the tradeoff between a Stream Generator and a
+  // Stream Publisher: a publisher lets the diff walk run at full speed, at
+  // the cost of unbounded daemon memory when the client reads slower than
+  // entries are produced.
+  auto cancellationSource = std::make_shared<folly::CancellationSource>();
+  auto [serverStream, publisher] =
+      apache::thrift::ServerStream<ChangedFileResult>::createPublisher(
+          [cancellationSource] { cancellationSource->requestCancellation(); });
+  auto sharedPublisher = std::make_shared<
+      folly::Synchronized<ThriftStreamPublisherOwner<ChangedFileResult>>>(
+      ThriftStreamPublisherOwner{std::move(publisher)});
+
+  auto callback = std::make_shared<StreamingDiffCallback>(sharedPublisher);
+
+  // Kick the diff off from a background thread so the Thrift client can
+  // interrupt us whenever desired, starting from a not ready ImmediateFuture.
+  auto future = makeNotReadyImmediateFuture().thenValue(
+      [edenMount = edenMount.get(),
+       rootId = std::move(rootId),
+       listIgnored,
+       enforceParents,
+       token = cancellationSource->getToken(),
+       callback = callback.get()](auto&&) {
+        return edenMount->diff(
+            callback, rootId, listIgnored, enforceParents, token);
+      });
+
+  folly::futures::detachOn(
+      server_->getServerState()->getThreadPool().get(),
+      std::move(future)
+          // Make sure that the edenMount, callback, helper and
+          // cancellationSource lives for the duration of the stream by
+          // copying them.
+          .thenTry([edenMount,
+                    sharedPublisher,
+                    callback = std::move(callback),
+                    helper = std::move(helper),
+                    cancellationSource](folly::Try<folly::Unit>&& result) {
+            if (result.hasException()) {
+              auto publisher = std::move(*sharedPublisher->wlock());
+              std::move(publisher).next(
+                  newEdenError(std::move(result).exception()));
+            }
+          })
+          .semi());
+
+  StreamStatusResult result;
+  result.version_ref() = server_->getVersion();
+  return {std::move(result), std::move(serverStream)};
+}
+
+namespace {
+
+/**
+ * Populate a FileDelta from an accumulated journal range. When summed is
+ * null, both positions are left at fromPosition so the caller resumes from
+ * where it was. Throws JOURNAL_TRUNCATED when the journal no longer reaches
+ * back to fromPosition.
+ */
+void fillFileDelta(
+    FileDelta& out,
+    const std::shared_ptr<EdenMount>& edenMount,
+    const JournalPosition& fromPosition,
+    const JournalDeltaRange* summed) {
+  // We set the default toPosition to be where we where if summed is null
+  out.toPosition_ref()->sequenceNumber_ref() =
+      *fromPosition.sequenceNumber_ref();
+  out.toPosition_ref()->snapshotHash_ref() = *fromPosition.snapshotHash_ref();
+  out.toPosition_ref()->mountGeneration_ref() = edenMount->getMountGeneration();
+
+  out.fromPosition_ref() = *out.toPosition_ref();
+
+  if (summed) {
+    if (summed->isTruncated) {
+      throw newEdenError(
+          EDOM,
+          EdenErrorType::JOURNAL_TRUNCATED,
+          "Journal entry range has been truncated.");
+    }
+
+    RootIdCodec& rootIdCodec = *edenMount->getObjectStore();
+
+    out.toPosition_ref()->sequenceNumber_ref() = summed->toSequence;
+    out.toPosition_ref()->snapshotHash_ref() =
+        rootIdCodec.renderRootId(summed->snapshotTransitions.back());
+    out.toPosition_ref()->mountGeneration_ref() =
+        edenMount->getMountGeneration();
+
+    out.fromPosition_ref()->sequenceNumber_ref() = summed->fromSequence;
+    out.fromPosition_ref()->snapshotHash_ref() =
+        rootIdCodec.renderRootId(summed->snapshotTransitions.front());
+    out.fromPosition_ref()->mountGeneration_ref() =
+        *out.toPosition_ref()->mountGeneration_ref();
+
+    for (const auto& entry : summed->changedFilesInOverlay) {
+      auto& path = entry.first;
+      auto& changeInfo = entry.second;
+      if (changeInfo.isNew()) {
+        out.createdPaths_ref()->emplace_back(path.asString());
+      } else {
+        out.changedPaths_ref()->emplace_back(path.asString());
+      }
+    }
+
+    for (auto& path : summed->uncleanPaths) {
+      out.uncleanPaths_ref()->emplace_back(path.asString());
+    }
+
+    out.snapshotTransitions_ref()->reserve(summed->snapshotTransitions.size());
+    for (auto& hash : summed->snapshotTransitions) {
+      out.snapshotTransitions_ref()->push_back(rootIdCodec.renderRootId(hash));
+    }
+  }
+}
+
+} // namespace
+
 void EdenServiceHandler::getFilesChangedSince(
     FileDelta& out,
     std::unique_ptr<std::string> mountPoint,
@@ -1715,10 +1984,119 @@ void EdenServiceHandler::getFilesChangedSince(
   auto summed = edenMount->getJournal().accumulateRange(
       *fromPosition->sequenceNumber_ref() + 1);
 
-  // We set the default toPosition to be where we where if summed is null
+  fillFileDelta(out, edenMount, *fromPosition, summed.get());
+}
+
+void EdenServiceHandler::getFilesChangedSincePaged(
+    FilesChangedPage& out,
+    std::unique_ptr<FilesChangedPageParams> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG3, *params->mountPoint_ref());
+  auto mountPath = absolutePathFromThrift(*params->mountPoint_ref());
+  auto edenMount = server_->getMount(mountPath);
+  const auto& fromPosition = *params->fromPosition_ref();
+
+  checkMountGeneration(fromPosition, edenMount, "fromPosition"sv);
+
+  auto maxEntries = *params->maxEntries_ref();
+  const auto cap = static_cast<int64_t>(server_->getServerState()
+                                            ->getEdenConfig()
+                                            ->journalPagedQueryMaxEntries.getValue());
+  if (maxEntries < 1) {
+    maxEntries = 1;
+  } else if (maxEntries > cap) {
+    maxEntries = cap;
+  }
+
+  auto& journal = edenMount->getJournal();
+  const auto fromSequence = *fromPosition.sequenceNumber_ref();
+
+  // The +1 matches getFilesChangedSince: the core merge stops at the item
+  // prior to its limitSequence parameter and we want the changes *since*
+  // the provided sequence number. The bounded overload folds at most
+  // maxEntries deltas, so a page's cost does not depend on how far behind
+  // the caller is.
+  auto summed = journal.accumulateRange(
+      fromSequence + 1,
+      fromSequence + static_cast<Journal::SequenceNumber>(maxEntries));
+
+  fillFileDelta(*out.delta_ref(), edenMount, fromPosition, summed.get());
+  out.hasMore_ref() =
+      summed && summed->toSequence < journal.getLatestSequenceID();
+}
+
+void EdenServiceHandler::sinceQuery(
+    SinceQueryResult& out,
+    std::unique_ptr<SinceQueryParams> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG3, *params->mountPoint_ref());
+  auto mountPath = absolutePathFromThrift(*params->mountPoint_ref());
+  auto edenMount = server_->getMount(mountPath);
+
+  checkMountGeneration(
+      *params->fromPosition_ref(), edenMount, "fromPosition"sv);
+
+  // Compile the filters before accumulating anything so a bad pattern
+  // fails the query cheaply.
+  std::vector<RelativePath> prefixes;
+  prefixes.reserve(params->prefixes_ref()->size());
+  for (auto& prefix : *params->prefixes_ref()) {
+    prefixes.emplace_back(prefix);
+  }
+  auto globOptions = GlobOptions::DEFAULT;
+  if (edenMount->getCheckoutConfig()->getCaseSensitive() ==
+      CaseSensitivity::Insensitive) {
+    globOptions |= GlobOptions::CASE_INSENSITIVE;
+  }
+  std::vector<GlobMatcher> matchers;
+  matchers.reserve(params->globs_ref()->size());
+  for (auto& glob : *params->globs_ref()) {
+    auto compiled = GlobMatcher::create(glob, globOptions);
+    if (compiled.hasError()) {
+      throw newEdenError(
+          EINVAL,
+          EdenErrorType::ARGUMENT_ERROR,
+          fmt::format(
+              "failed to compile pattern `{}` to GlobMatcher: {}",
+              glob,
+              compiled.error()));
+    }
+    matchers.push_back(std::move(compiled.value()));
+  }
+
+  auto matches = [&](const RelativePath& path) {
+    if (!prefixes.empty()) {
+      bool anyPrefix = false;
+      for (const auto& prefix : prefixes) {
+        if (path == prefix || prefix.isParentDirOf(path)) {
+          anyPrefix = true;
+          break;
+        }
+      }
+      if (!anyPrefix) {
+        return false;
+      }
+    }
+    if (!matchers.empty()) {
+      for (const auto& matcher : matchers) {
+        if (matcher.match(path.view())) {
+          return true;
+        }
+      }
+      return false;
+    }
+    return true;
+  };
+
+  // The +1 is because the core merge stops at the item prior to
+  // its limitSequence parameter and we want the changes *since*
+  // the provided sequence number.
+  auto summed = edenMount->getJournal().accumulateRange(
+      *params->fromPosition_ref()->sequenceNumber_ref() + 1);
+
+  // We set the default toPosition to be where we were if summed is null
   out.toPosition_ref()->sequenceNumber_ref() =
-      *fromPosition->sequenceNumber_ref();
-  out.toPosition_ref()->snapshotHash_ref() = *fromPosition->snapshotHash_ref();
+      *params->fromPosition_ref()->sequenceNumber_ref();
+  out.toPosition_ref()->snapshotHash_ref() =
+      *params->fromPosition_ref()->snapshotHash_ref();
   out.toPosition_ref()->mountGeneration_ref() = edenMount->getMountGeneration();
 
   out.fromPosition_ref() = *out.toPosition_ref();
@@ -1748,6 +2126,9 @@ void EdenServiceHandler::getFilesChangedSince(
     for (const auto& entry : summed->changedFilesInOverlay) {
       auto& path = entry.first;
       auto& changeInfo = entry.second;
+      if (!matches(path)) {
+        continue;
+      }
       if (changeInfo.isNew()) {
         out.createdPaths_ref()->emplace_back(path.asString());
       } else {
@@ -1756,7 +2137,9 @@ void EdenServiceHandler::getFilesChangedSince(
     }
 
     for (auto& path : summed->uncleanPaths) {
-      out.uncleanPaths_ref()->emplace_back(path.asString());
+      if (matches(path)) {
+        out.uncleanPaths_ref()->emplace_back(path.asString());
+      }
     }
 
     out.snapshotTransitions_ref()->reserve(summed->snapshotTransitions.size());
@@ -1816,6 +2199,19 @@ void EdenServiceHandler::debugGetRawJournal(
       *edenMount->getObjectStore());
 }
 
+void EdenServiceHandler::debugGetMemoryArenaStats(
+    std::vector<MemoryArenaStats>& out) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG3);
+  for (auto& arena : getMemoryArenaStats()) {
+    auto& stats = out.emplace_back();
+    stats.name_ref() = std::move(arena.name);
+    stats.supported_ref() = arena.supported;
+    stats.allocatedBytes_ref() = static_cast<int64_t>(arena.allocatedBytes);
+    stats.activeBytes_ref() = static_cast<int64_t>(arena.activeBytes);
+    stats.mappedBytes_ref() = static_cast<int64_t>(arena.mappedBytes);
+  }
+}
+
 folly::SemiFuture<std::unique_ptr<std::vector<EntryInformationOrError>>>
 EdenServiceHandler::semifuture_getEntryInformation(
     std::unique_ptr<std::string> mountPoint,
@@ -2134,6 +2530,26 @@ EdenServiceHandler::semifuture_readdir(std::unique_ptr<ReaddirParams> params) {
       .semi();
 }
 
+namespace {
+/**
+ * Move the tail of a response future onto the given executor.
+ *
+ * The continuation that assembles a Thrift result struct runs on whichever
+ * thread completes the future it is attached to. For large results
+ * (attribute batches, status of a big rebase) that can mean copying many
+ * megabytes of strings on a backing store EventBase or import thread,
+ * stalling every other request serviced by that thread. Hopping through
+ * the CPU pool keeps those threads free for I/O; Thrift then serializes
+ * the result wherever the returned future completes.
+ */
+template <typename T>
+ImmediateFuture<T> completeOnExecutor(
+    ImmediateFuture<T> future,
+    folly::Executor* executor) {
+  return ImmediateFuture{std::move(future).semi().via(executor).semi()};
+}
+} // namespace
+
 // TODO(kmancini): we shouldn't need this for the long term, but needs to be
 // updated if attributes are added.
 constexpr EntryAttributeFlags kAllEntryAttributes =
@@ -2146,20 +2562,79 @@ EdenServiceHandler::getEntryAttributes(
     EntryAttributeFlags reqBitmask,
     SyncBehavior sync,
     const ObjectFetchContextPtr& fetchContext) {
-  return waitForPendingNotifications(*server_->getMount(mountPath), sync)
-      .thenValue([this,
-                  &paths,
+  auto edenMount = server_->getMount(mountPath);
+  auto rootInode = edenMount->getRootInode();
+  auto objectStore = edenMount->getObjectStore();
+  return waitForPendingNotifications(*edenMount, sync)
+      .thenValue([&paths,
+                  rootInode = std::move(rootInode),
+                  objectStore,
                   fetchContext = fetchContext.copy(),
-                  mountPath = mountPath.copy(),
                   reqBitmask](auto&&) mutable {
-        vector<ImmediateFuture<EntryAttributes>> futures;
-        for (const auto& p : paths) {
-          futures.emplace_back(getEntryAttributesForPath(
-              reqBitmask, mountPath, p, fetchContext));
-        }
-
-        // Collect all futures into a single tuple
-        return facebook::eden::collectAll(std::move(futures));
+        // Resolve all the paths with a single tree-shaped walk so that
+        // shared directory prefixes are only looked up once, rather than
+        // once per path that contains them.
+        return ImmediateFuture{collectAll(applyToVirtualInode(
+                   rootInode,
+                   paths,
+                   [](const VirtualInode& inode) { return inode; },
+                   objectStore,
+                   fetchContext))}
+            .thenValue([&paths,
+                        objectStore,
+                        fetchContext = fetchContext.copy(),
+                        reqBitmask](
+                           std::vector<folly::Try<VirtualInode>>&& inodes) {
+              // Warm the metadata cache for every entry that is backed by
+              // an unmaterialized blob with one batched fetch before the
+              // attributes are queried entry by entry below.
+              std::vector<ObjectId> blobIds;
+              for (const auto& inode : inodes) {
+                if (inode.hasValue()) {
+                  if (auto blobId = inode->getBlobObjectId()) {
+                    blobIds.push_back(std::move(blobId).value());
+                  }
+                }
+              }
+              auto warmFuture = blobIds.empty()
+                  ? ImmediateFuture<folly::Unit>{folly::unit}
+                  : objectStore->getBlobMetadatas(blobIds, fetchContext)
+                        .thenTry([](folly::Try<std::vector<BlobMetadata>>&&) {
+                          return folly::unit;
+                        });
+              return std::move(warmFuture)
+                  .thenValue([&paths,
+                              objectStore,
+                              fetchContext = fetchContext.copy(),
+                              reqBitmask,
+                              inodes = std::move(inodes)](auto&&) mutable {
+                    vector<ImmediateFuture<EntryAttributes>> futures;
+                    futures.reserve(inodes.size());
+                    for (size_t i = 0; i < inodes.size(); ++i) {
+                      if (paths.at(i).empty()) {
+                        futures.emplace_back(
+                            ImmediateFuture<EntryAttributes>(newEdenError(
+                                EINVAL,
+                                EdenErrorType::ARGUMENT_ERROR,
+                                "path cannot be the empty string")));
+                      } else if (inodes[i].hasException()) {
+                        futures.emplace_back(ImmediateFuture<EntryAttributes>{
+                            inodes[i].exception()});
+                      } else {
+                        futures.emplace_back(makeImmediateFutureWith([&]() {
+                          return inodes[i].value().getEntryAttributes(
+                              reqBitmask,
+                              RelativePathPiece{paths.at(i)},
+                              objectStore,
+                              fetchContext);
+                        }));
+                      }
+                    }
+
+                    // Collect all futures into a single tuple
+                    return facebook::eden::collectAll(std::move(futures));
+                  });
+            });
       });
 }
 
@@ -2181,8 +2656,12 @@ EdenServiceHandler::semifuture_getAttributesFromFiles(
   // TODO(kmancini): When Buck2 migrates to our
   // explicit type information, we can get shape up
   // this API better.
-  auto entryAttributesFuture = getEntryAttributes(
-      mountPath, paths, kAllEntryAttributes, *params->sync(), fetchContext);
+  // Assemble the result on the CPU pool instead of whatever thread
+  // completed the last attribute fetch.
+  auto entryAttributesFuture = completeOnExecutor(
+      getEntryAttributes(
+          mountPath, paths, kAllEntryAttributes, *params->sync(), fetchContext),
+      server_->getServerState()->getThreadPool().get());
 
   return wrapImmediateFuture(
              std::move(helper),
@@ -2277,8 +2756,10 @@ EdenServiceHandler::semifuture_getAttributesFromFilesV2(
       DBG3, mountPoint, getSyncTimeout(*params->sync()), toLogArg(paths));
   auto& fetchContext = helper->getFetchContext();
 
-  auto entryAttributesFuture = getEntryAttributes(
-      mountPath, paths, reqBitmask, *params->sync(), fetchContext);
+  auto entryAttributesFuture = completeOnExecutor(
+      getEntryAttributes(
+          mountPath, paths, reqBitmask, *params->sync(), fetchContext),
+      server_->getServerState()->getThreadPool().get());
 
   return wrapImmediateFuture(
              std::move(helper),
@@ -2647,6 +3128,12 @@ EdenServiceHandler::semifuture_globFiles(std::unique_ptr<GlobParams> params) {
   auto& context = helper->getFetchContext();
   auto isBackground = *params->background();
 
+  // Globs can walk large subtrees; count them against the heavy-request
+  // limits (shedding with EBUSY when saturated) even when the caller
+  // detaches, since background globs consume the same resources.
+  auto qosSlot =
+      thriftRequestGovernor_.acquireHeavySlot(getAndRegisterClientPid());
+
   ImmediateFuture<folly::Unit> backgroundFuture;
   if (isBackground) {
     backgroundFuture = makeNotReadyImmediateFuture();
@@ -2670,7 +3157,9 @@ EdenServiceHandler::semifuture_globFiles(std::unique_ptr<GlobParams> params) {
             return globber.glob(mount, serverState, std::move(globs), context);
           });
   globFut = std::move(globFut).ensure(
-      [helper = std::move(helper), params = std::move(params)] {});
+      [helper = std::move(helper),
+       params = std::move(params),
+       qosSlot = std::move(qosSlot)] {});
   return detachIfBackgrounded(
              std::move(globFut), server_->getServerState(), isBackground)
       .semi();
@@ -2718,6 +3207,404 @@ folly::SemiFuture<folly::Unit> EdenServiceHandler::semifuture_prefetchFiles(
       .semi();
 }
 
+folly::SemiFuture<std::unique_ptr<PrefetchTreeResult>>
+EdenServiceHandler::semifuture_prefetchTreeRecursive(
+    std::unique_ptr<PrefetchTreeParams> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL(
+      DBG2,
+      *params->mountPoint(),
+      *params->path(),
+      logHash(*params->revision()),
+      *params->depth());
+  auto isBackground = *params->background();
+
+  auto mount = server_->getMount(absolutePathFromThrift(*params->mountPoint()));
+  auto* store = mount->getObjectStore();
+
+  auto path = RelativePath{*params->path()};
+  auto depth = *params->depth();
+  if (depth < -1) {
+    throw newEdenError(
+        EINVAL,
+        EdenErrorType::ARGUMENT_ERROR,
+        "invalid prefetch depth: ",
+        depth);
+  }
+  std::optional<uint32_t> maxDepth;
+  if (depth >= 0) {
+    maxDepth = static_cast<uint32_t>(depth);
+  }
+  auto rootId = params->revision()->empty()
+      ? mount->getCheckedOutRootId()
+      : store->parseRootId(*params->revision());
+  auto directoriesOnly = *params->directoriesOnly();
+
+  ImmediateFuture<folly::Unit> backgroundFuture;
+  if (isBackground) {
+    backgroundFuture = makeNotReadyImmediateFuture();
+  }
+
+  auto prefetchFut =
+      std::move(backgroundFuture)
+          .thenValue([mount,
+                      rootId = std::move(rootId),
+                      path = std::move(path),
+                      maxDepth,
+                      directoriesOnly,
+                      context = helper->getPrefetchFetchContext().copy()](
+                         auto&&) mutable {
+            auto* store = mount->getObjectStore();
+            return store->getRootTree(rootId, context)
+                .thenValue([store,
+                            context = context.copy(),
+                            path = std::move(path)](
+                               std::shared_ptr<const Tree>&& rootTree) {
+                  return resolveTree(
+                      *store, context, std::move(rootTree), path);
+                })
+                .thenValue([store,
+                            context = context.copy(),
+                            maxDepth,
+                            directoriesOnly](
+                               std::shared_ptr<const Tree>&& tree) {
+                  return prefetchTreeRecursive(
+                      *store,
+                      context,
+                      std::move(tree),
+                      maxDepth,
+                      !directoriesOnly);
+                })
+                .thenValue([mount](TreePrefetchStats&& stats) {
+                  auto result = std::make_unique<PrefetchTreeResult>();
+                  result->treesWalked() =
+                      static_cast<int64_t>(stats.treesWalked);
+                  result->blobsPrefetched() =
+                      static_cast<int64_t>(stats.blobsPrefetched);
+                  return result;
+                });
+          });
+  prefetchFut = std::move(prefetchFut)
+                    .ensure([helper = std::move(helper),
+                             params = std::move(params)] {});
+
+  if (isBackground) {
+    folly::futures::detachOn(
+        server_->getServerState()->getThreadPool().get(),
+        std::move(prefetchFut).semi());
+    return folly::makeSemiFuture(std::make_unique<PrefetchTreeResult>());
+  }
+  return std::move(prefetchFut).semi();
+}
+
+folly::SemiFuture<std::unique_ptr<PrefetchPathsResult>>
+EdenServiceHandler::semifuture_prefetchPaths(
+    std::unique_ptr<PrefetchPathsParams> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL(
+      DBG2,
+      *params->mountPoint(),
+      folly::to<string>("numPaths=", params->paths()->size()),
+      folly::to<string>("depth=", *params->depth()),
+      folly::to<string>("metadataOnly=", *params->metadataOnly()));
+  auto isBackground = *params->background();
+
+  auto mount = server_->getMount(absolutePathFromThrift(*params->mountPoint()));
+
+  auto depth = *params->depth();
+  if (depth < -1) {
+    throw newEdenError(
+        EINVAL,
+        EdenErrorType::ARGUMENT_ERROR,
+        "invalid prefetch depth: ",
+        depth);
+  }
+  std::optional<uint32_t> maxDepth;
+  if (depth >= 0) {
+    maxDepth = static_cast<uint32_t>(depth);
+  }
+  auto metadataOnly = *params->metadataOnly();
+
+  auto paths = std::make_shared<std::vector<RelativePath>>();
+  paths->reserve(params->paths()->size());
+  for (const auto& path : *params->paths()) {
+    if (path.empty()) {
+      throw newEdenError(
+          EINVAL,
+          EdenErrorType::ARGUMENT_ERROR,
+          "prefetchPaths hints must name a path inside the repository");
+    }
+    paths->emplace_back(path);
+  }
+
+  // Drop hints the journal shows as changed locally: their content lives in
+  // the overlay, so a backing store fetch would warm nothing. Only the most
+  // recent deltas are consulted, bounded by the same cap the paged journal
+  // queries use; older changes simply fall back to a redundant fetch.
+  int64_t pathsSkipped = 0;
+  {
+    auto& journal = mount->getJournal();
+    auto window = server_->getServerState()
+                      ->getReloadableConfig()
+                      ->getEdenConfig()
+                      ->journalPagedQueryMaxEntries.getValue();
+    auto latest = journal.getLatestSequenceID();
+    auto from = latest > window ? latest - window + 1 : 1;
+    if (auto summed = journal.accumulateRange(from)) {
+      paths->erase(
+          std::remove_if(
+              paths->begin(),
+              paths->end(),
+              [&](const RelativePath& path) {
+                if (summed->changedFilesInOverlay.count(path) ||
+                    summed->uncleanPaths.count(path)) {
+                  ++pathsSkipped;
+                  return true;
+                }
+                return false;
+              }),
+          paths->end());
+    }
+  }
+
+  ImmediateFuture<folly::Unit> backgroundFuture;
+  if (isBackground) {
+    backgroundFuture = makeNotReadyImmediateFuture();
+  }
+
+  auto prefetchFut =
+      std::move(backgroundFuture)
+          .thenValue([mount,
+                      paths,
+                      maxDepth,
+                      metadataOnly,
+                      pathsSkipped,
+                      context = helper->getPrefetchFetchContext().copy()](
+                         auto&&) mutable {
+            auto* store = mount->getObjectStore();
+            return store->getRootTree(mount->getCheckedOutRootId(), context)
+                .thenValue([store, paths, context = context.copy()](
+                               std::shared_ptr<const Tree>&& rootTree) {
+                  // Resolve every hint's parent directory as one batched
+                  // level-lockstep walk so shared path prefixes are fetched
+                  // once.
+                  std::vector<RelativePath> parents;
+                  parents.reserve(paths->size());
+                  for (const auto& path : *paths) {
+                    parents.emplace_back(path.dirname());
+                  }
+                  return resolveTrees(
+                      *store, context, std::move(rootTree), parents);
+                })
+                .thenValue(
+                    [store,
+                     paths,
+                     maxDepth,
+                     metadataOnly,
+                     mount,
+                     context = context.copy()](
+                        std::vector<folly::Try<std::shared_ptr<const Tree>>>&&
+                            parents) {
+                      std::vector<ImmediateFuture<TreePrefetchStats>> work;
+                      auto blobIds =
+                          std::make_shared<std::vector<ObjectId>>();
+
+                      for (size_t i = 0; i < paths->size(); ++i) {
+                        const auto& path = (*paths)[i];
+                        if (parents[i].hasException()) {
+                          XLOG(DBG3) << "skipping prefetch hint " << path
+                                     << " in " << mount->getPath() << ": "
+                                     << parents[i].exception().what();
+                          continue;
+                        }
+                        const auto& parent = parents[i].value();
+                        auto entry = parent->find(path.basename());
+                        if (entry == parent->end()) {
+                          XLOG(DBG3) << "skipping prefetch hint " << path
+                                     << " in " << mount->getPath()
+                                     << ": not present in current revision";
+                          continue;
+                        }
+                        if (entry->second.isTree()) {
+                          work.push_back(
+                              store->getTree(entry->second.getHash(), context)
+                                  .thenValue(
+                                      [store,
+                                       maxDepth,
+                                       metadataOnly,
+                                       context = context.copy()](
+                                          std::shared_ptr<const Tree>&&
+                                              tree) {
+                                        return prefetchTreeRecursive(
+                                            *store,
+                                            context,
+                                            std::move(tree),
+                                            maxDepth,
+                                            !metadataOnly);
+                                      }));
+                        } else if (metadataOnly) {
+                          work.push_back(
+                              store
+                                  ->getBlobMetadata(
+                                      entry->second.getHash(), context)
+                                  .thenValue([](BlobMetadata&&) {
+                                    return TreePrefetchStats{0, 1};
+                                  }));
+                        } else {
+                          blobIds->push_back(entry->second.getHash());
+                        }
+                      }
+
+                      if (!blobIds->empty()) {
+                        auto count = blobIds->size();
+                        work.push_back(
+                            store
+                                ->prefetchBlobs(
+                                    ObjectIdRange{
+                                        blobIds->data(),
+                                        blobIds->size()},
+                                    context)
+                                .thenValue([blobIds, count](folly::Unit) {
+                                  return TreePrefetchStats{0, count};
+                                }));
+                      }
+
+                      return collectAll(std::move(work))
+                          .thenValue(
+                              [](std::vector<folly::Try<TreePrefetchStats>>&&
+                                     results) {
+                                TreePrefetchStats total;
+                                for (auto& result : results) {
+                                  if (result.hasValue()) {
+                                    total.treesWalked +=
+                                        result->treesWalked;
+                                    total.blobsPrefetched +=
+                                        result->blobsPrefetched;
+                                  }
+                                }
+                                return total;
+                              });
+                    })
+                .thenValue([mount, paths, context = context.copy()](
+                               TreePrefetchStats&& stats) {
+                  // Load the hinted paths' inodes so the InodeMap is warm
+                  // too; the trees backing them were just fetched, so this
+                  // is served from the caches.
+                  std::vector<ImmediateFuture<InodePtr>> loads;
+                  loads.reserve(paths->size());
+                  for (const auto& path : *paths) {
+                    loads.push_back(mount->getInodeSlow(path, context));
+                  }
+                  return collectAll(std::move(loads))
+                      .thenValue([stats](std::vector<folly::Try<InodePtr>>&&) {
+                        return stats;
+                      });
+                })
+                .thenValue([pathsSkipped](TreePrefetchStats&& stats) {
+                  auto result = std::make_unique<PrefetchPathsResult>();
+                  result->pathsSkipped() = pathsSkipped;
+                  result->treesWalked() =
+                      static_cast<int64_t>(stats.treesWalked);
+                  result->blobsPrefetched() =
+                      static_cast<int64_t>(stats.blobsPrefetched);
+                  return result;
+                });
+          });
+  prefetchFut = std::move(prefetchFut)
+                    .ensure([helper = std::move(helper),
+                             params = std::move(params)] {});
+
+  if (isBackground) {
+    folly::futures::detachOn(
+        server_->getServerState()->getThreadPool().get(),
+        std::move(prefetchFut).semi());
+    return folly::makeSemiFuture(std::make_unique<PrefetchPathsResult>());
+  }
+  return std::move(prefetchFut).semi();
+}
+
+void EdenServiceHandler::startMountWarmup(
+    std::unique_ptr<std::string> mountPoint,
+    std::unique_ptr<std::vector<std::string>> paths) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG2, *mountPoint, toLogArg(*paths));
+  auto mount = server_->getMount(absolutePathFromThrift(*mountPoint));
+
+  std::vector<RelativePath> warmupPaths;
+  if (paths->empty()) {
+    warmupPaths = readWarmupManifest(*mount->getCheckoutConfig());
+  } else {
+    warmupPaths.reserve(paths->size());
+    for (auto& path : *paths) {
+      warmupPaths.emplace_back(path);
+    }
+  }
+  if (warmupPaths.empty()) {
+    throw newEdenError(
+        EINVAL,
+        EdenErrorType::ARGUMENT_ERROR,
+        "no warm-up paths given and no working-set manifest recorded for ",
+        *mountPoint);
+  }
+
+  auto state = mount->getWarmupState();
+  if (state->running.exchange(true)) {
+    throw newEdenError(
+        EBUSY,
+        EdenErrorType::POSIX_ERROR,
+        "a warm-up is already running for ",
+        *mountPoint);
+  }
+
+  // warmupMount creates its own low-priority fetch context, so nothing from
+  // this request needs to stay alive for the background walk.
+  folly::futures::detachOn(
+      server_->getServerState()->getThreadPool().get(),
+      warmupMount(std::move(mount), std::move(warmupPaths), std::move(state))
+          .semi());
+}
+
+void EdenServiceHandler::getMountWarmupProgress(
+    MountWarmupProgress& progress,
+    std::unique_ptr<std::string> mountPoint) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG3, *mountPoint);
+  auto mount = server_->getMount(absolutePathFromThrift(*mountPoint));
+  const auto& state = mount->getWarmupState();
+  progress.running() = state->running.load(std::memory_order_relaxed);
+  progress.pathsTotal() =
+      static_cast<int64_t>(state->pathsTotal.load(std::memory_order_relaxed));
+  progress.pathsCompleted() = static_cast<int64_t>(
+      state->pathsCompleted.load(std::memory_order_relaxed));
+  progress.treesWalked() =
+      static_cast<int64_t>(state->treesWalked.load(std::memory_order_relaxed));
+  progress.blobsPrefetched() = static_cast<int64_t>(
+      state->blobsPrefetched.load(std::memory_order_relaxed));
+}
+
+folly::SemiFuture<folly::Unit> EdenServiceHandler::semifuture_prepareCheckout(
+    std::unique_ptr<PrepareCheckoutParams> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL(
+      DBG2, *params->mountPoint(), logHash(*params->snapshotHash()));
+  auto isBackground = *params->background();
+
+  ImmediateFuture<folly::Unit> backgroundFuture;
+  if (isBackground) {
+    backgroundFuture = makeNotReadyImmediateFuture();
+  }
+
+  auto prepareFut =
+      std::move(backgroundFuture)
+          .thenValue([mount = server_->getMount(
+                          absolutePathFromThrift(*params->mountPoint())),
+                      hash = std::move(*params->snapshotHash())](auto&&) {
+            return mount->prepareCheckout(
+                mount->getObjectStore()->parseRootId(hash));
+          });
+  prepareFut = std::move(prepareFut)
+                   .ensure([helper = std::move(helper),
+                            params = std::move(params)] {});
+  return detachIfBackgrounded(
+             std::move(prepareFut), server_->getServerState(), isBackground)
+      .semi();
+}
+
 folly::SemiFuture<struct folly::Unit> EdenServiceHandler::semifuture_chown(
     FOLLY_MAYBE_UNUSED std::unique_ptr<std::string> mountPoint,
     FOLLY_MAYBE_UNUSED int32_t uid,
@@ -2742,6 +3629,12 @@ EdenServiceHandler::semifuture_getScmStatusV2(
       folly::to<string>("commitHash=", logHash(*params->commit_ref())),
       folly::to<string>("listIgnored=", *params->listIgnored_ref()));
 
+  // Working copy diffs are among the most expensive requests we serve;
+  // acquire a heavy-request slot (or shed with EBUSY) so a burst of status
+  // calls cannot starve cheap requests of Thrift workers.
+  auto qosSlot =
+      thriftRequestGovernor_.acquireHeavySlot(getAndRegisterClientPid());
+
   auto mountPath = absolutePathFromThrift(*params->mountPoint_ref());
   auto mount = server_->getMount(mountPath);
   auto rootId = mount->getObjectStore()->parseRootId(*params->commit_ref());
@@ -2751,18 +3644,20 @@ EdenServiceHandler::semifuture_getScmStatusV2(
                                    ->enforceParents.getValue();
   return wrapImmediateFuture(
              std::move(helper),
-             mount
-                 ->diff(
+             completeOnExecutor(
+                 mount->diff(
                      rootId,
                      context->getConnectionContext()->getCancellationToken(),
                      *params->listIgnored_ref(),
-                     enforceParents)
+                     enforceParents),
+                 server_->getServerState()->getThreadPool().get())
                  .thenValue([this, mount](std::unique_ptr<ScmStatus>&& status) {
                    auto result = std::make_unique<GetScmStatusResult>();
                    result->status_ref() = std::move(*status);
                    result->version_ref() = server_->getVersion();
                    return result;
                  }))
+      .ensure([qosSlot = std::move(qosSlot)] {})
       .semi();
 }
 
@@ -3254,6 +4149,95 @@ void EdenServiceHandler::debugOutstandingThriftRequests(
   }
 }
 
+void EdenServiceHandler::debugRehearseTakeover(
+    TakeoverRehearsalResult& result,
+    std::unique_ptr<std::string> outputPath) {
+#ifndef _WIN32
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG2, *outputPath);
+
+  TakeoverData data;
+  for (const auto& mount : server_->getMountPoints()) {
+    folly::stop_watch<std::chrono::microseconds> snapshotWatch;
+    SerializedInodeMap serializedInodeMap;
+    {
+      // Hold the rename lock only for the snapshot itself, not for the
+      // serialization below; a real takeover freezes the mount entirely, so
+      // this undercounts nothing that matters for trending.
+      auto renameLock = mount->acquireRenameLock();
+      serializedInodeMap =
+          mount->getInodeMap()->serializeTakeoverRehearsal(renameLock);
+    }
+
+    TakeoverRehearsalMountInfo info;
+    info.mountPoint() = mount->getPath().asString();
+    info.inodeCount() =
+        static_cast<int64_t>(serializedInodeMap.unloadedInodes_ref()->size());
+    info.snapshotDurationUs() = snapshotWatch.elapsed().count();
+    result.mounts()->push_back(std::move(info));
+
+    // Stand in for the channel state with an empty fd and zeroed connection
+    // info; neither contributes meaningfully to the payload size and the fd
+    // is never actually sent anywhere.
+    std::vector<AbsolutePath> bindMounts;
+    if (mount->getFuseChannel()) {
+      data.mountPoints.emplace_back(
+          mount->getPath(),
+          mount->getCheckoutConfig()->getClientDirectory(),
+          bindMounts,
+          FuseChannelData{folly::File{}, fuse_init_out{}},
+          std::move(serializedInodeMap));
+    } else if (mount->getNfsdChannel()) {
+      data.mountPoints.emplace_back(
+          mount->getPath(),
+          mount->getCheckoutConfig()->getClientDirectory(),
+          bindMounts,
+          NfsChannelData{folly::File{}},
+          std::move(serializedInodeMap));
+    }
+  }
+
+  folly::stop_watch<std::chrono::microseconds> serializeWatch;
+  UnixSocket::Message msg;
+  data.serialize(kSupportedCapabilities, msg);
+  result.serializeDurationUs() = serializeWatch.elapsed().count();
+  result.messageBytes() =
+      static_cast<int64_t>(msg.data.computeChainDataLength());
+  result.fileDescriptorCount() = static_cast<int64_t>(msg.files.size());
+
+  // Memory segments (inode maps, the blob cache) travel as file descriptors
+  // rather than message bytes; account for them separately since they are
+  // copied by the kernel, not through the socket buffer.
+  int64_t segmentBytes = 0;
+  for (const auto& file : msg.files) {
+    if (!file) {
+      continue;
+    }
+    struct stat st;
+    if (::fstat(file.fd(), &st) == 0) {
+      segmentBytes += st.st_size;
+    }
+  }
+  result.segmentBytes() = segmentBytes;
+
+  if (!outputPath->empty()) {
+    folly::stop_watch<std::chrono::microseconds> writeWatch;
+    auto contents = msg.data.coalesce();
+    if (!folly::writeFile(contents, outputPath->c_str())) {
+      throw newEdenError(
+          errno,
+          EdenErrorType::POSIX_ERROR,
+          "failed to write takeover rehearsal payload to ",
+          *outputPath);
+    }
+    result.writeDurationUs() = writeWatch.elapsed().count();
+  }
+#else
+  (void)result;
+  (void)outputPath;
+  NOT_IMPLEMENTED();
+#endif
+}
+
 void EdenServiceHandler::debugStartRecordingActivity(
     ActivityRecorderResult& result,
     std::unique_ptr<std::string> mountPoint,
@@ -3327,6 +4311,55 @@ void EdenServiceHandler::debugListActivityRecordings(
   result.recordings_ref() = recordings;
 }
 
+int64_t EdenServiceHandler::debugDumpFlightRecorder(
+    std::unique_ptr<std::string> mountPoint,
+    std::unique_ptr<std::string> outputPath,
+    int64_t seconds) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG2, *mountPoint, *outputPath);
+
+  AbsolutePathPiece path;
+  try {
+    path = absolutePathFromThrift(*outputPath);
+  } catch (const std::exception&) {
+    throw newEdenError(
+        EINVAL, EdenErrorType::ARGUMENT_ERROR, "output path is invalid");
+  }
+  if (seconds < 0) {
+    throw newEdenError(
+        EINVAL, EdenErrorType::ARGUMENT_ERROR, "seconds must be non-negative");
+  }
+
+  auto mount = server_->getMount(absolutePathFromThrift(*mountPoint));
+  const auto& flightRecorder = mount->getFlightRecorder();
+  if (!flightRecorder) {
+    throw newEdenError(
+        ENOTSUP,
+        EdenErrorType::POSIX_ERROR,
+        "the flight recorder is disabled; "
+        "see telemetry:enable-flight-recorder");
+  }
+
+  folly::File output{
+      path.asString(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644};
+  return static_cast<int64_t>(
+      flightRecorder->dump(output, std::chrono::seconds{seconds}));
+}
+
+void EdenServiceHandler::debugGetImmediateFutureAudit(
+    std::vector<ImmediateFutureCallSite>& result) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG3);
+  for (const auto& snapshot : ImmediateFutureAudit::snapshot()) {
+    ImmediateFutureCallSite callSite;
+    callSite.file_ref() = std::string{snapshot.location.file_name()};
+    callSite.line_ref() = static_cast<int32_t>(snapshot.location.line());
+    callSite.function_ref() = std::string{snapshot.location.function_name()};
+    callSite.immediateCount_ref() =
+        static_cast<int64_t>(snapshot.immediateCount);
+    callSite.semiCount_ref() = static_cast<int64_t>(snapshot.semiCount);
+    result.push_back(std::move(callSite));
+  }
+}
+
 void EdenServiceHandler::debugGetInodePath(
     InodePathDebugInfo& info,
     std::unique_ptr<std::string> mountPoint,
@@ -3383,9 +4416,14 @@ void EdenServiceHandler::stopRecordingBackingStoreFetch(
       hgBackingStore =
           std::dynamic_pointer_cast<HgQueuedBackingStore>(backingStore);
     } else {
-      // LocalStoreCachedBackingStore -> HgQueuedBackingStore
-      hgBackingStore = std::dynamic_pointer_cast<HgQueuedBackingStore>(
-          localStoreCachedBackingStore->getBackingStore());
+      // LocalStoreCachedBackingStore -> HgQueuedBackingStore, possibly
+      // through an intermediate PeerCachedBackingStore tier
+      auto inner = localStoreCachedBackingStore->getBackingStore();
+      if (auto peerCachedBackingStore =
+              std::dynamic_pointer_cast<PeerCachedBackingStore>(inner)) {
+        inner = peerCachedBackingStore->getBackingStore();
+      }
+      hgBackingStore = std::dynamic_pointer_cast<HgQueuedBackingStore>(inner);
     }
     if (hgBackingStore) {
       (*results.fetchedFilePaths_ref())["HgQueuedBackingStore"].insert(
@@ -3422,6 +4460,35 @@ void EdenServiceHandler::getAccessCounts(
   }
 }
 
+void EdenServiceHandler::getFetchOriginStats(
+    FetchOriginStats& result,
+    std::unique_ptr<std::string> mountPoint) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG3, *mountPoint);
+  auto mount = server_->getMount(absolutePathFromThrift(*mountPoint));
+  const auto* store = mount->getObjectStore();
+
+  auto count = [store](
+                   ObjectFetchContext::ObjectType type,
+                   ObjectFetchContext::Origin origin) {
+    return static_cast<int64_t>(store->getFetchCountByOrigin(type, origin));
+  };
+  using Type = ObjectFetchContext::ObjectType;
+  using Origin = ObjectFetchContext::Origin;
+
+  result.treesFromMemoryCache() = count(Type::Tree, Origin::FromMemoryCache);
+  result.treesFromDiskCache() = count(Type::Tree, Origin::FromDiskCache);
+  result.treesFromNetwork() = count(Type::Tree, Origin::FromNetworkFetch);
+  result.blobsFromMemoryCache() = count(Type::Blob, Origin::FromMemoryCache);
+  result.blobsFromDiskCache() = count(Type::Blob, Origin::FromDiskCache);
+  result.blobsFromNetwork() = count(Type::Blob, Origin::FromNetworkFetch);
+  result.blobMetadataFromMemoryCache() =
+      count(Type::BlobMetadata, Origin::FromMemoryCache);
+  result.blobMetadataFromDiskCache() =
+      count(Type::BlobMetadata, Origin::FromDiskCache);
+  result.blobMetadataFromNetwork() =
+      count(Type::BlobMetadata, Origin::FromNetworkFetch);
+}
+
 void EdenServiceHandler::clearAndCompactLocalStore() {
   auto helper = INSTRUMENT_THRIFT_CALL(DBG1);
   server_->getLocalStore()->clearCachesAndCompactAll();
@@ -3612,6 +4679,388 @@ void EdenServiceHandler::getStatInfo(
   }
 }
 
+namespace {
+/**
+ * Accumulates per-operation request counts and latencies for one
+ * profileMount sampling window. Latencies are computed by correlating START
+ * and FINISH trace events through the channel's request identifier.
+ */
+struct FsProfileAccumulator {
+  struct OpStats {
+    uint64_t count = 0;
+    uint64_t totalDurationUs = 0;
+    uint64_t maxDurationUs = 0;
+  };
+
+  struct State {
+    /** Start times of requests in flight, keyed by request identifier. */
+    std::unordered_map<
+        uint64_t,
+        std::pair<uint64_t, std::chrono::steady_clock::time_point>>
+        pending;
+    std::unordered_map<uint64_t, OpStats> operations;
+    uint64_t totalRequests = 0;
+  };
+
+  void recordStart(
+      uint64_t requestId,
+      uint64_t opcode,
+      std::chrono::steady_clock::time_point startTime) {
+    auto state = state_.wlock();
+    state->totalRequests += 1;
+    state->operations[opcode].count += 1;
+    state->pending[requestId] = {opcode, startTime};
+  }
+
+  void recordFinish(
+      uint64_t requestId,
+      std::chrono::steady_clock::time_point finishTime) {
+    auto state = state_.wlock();
+    auto iter = state->pending.find(requestId);
+    if (iter == state->pending.end()) {
+      // The request started before the sampling window opened.
+      return;
+    }
+    auto [opcode, startTime] = iter->second;
+    state->pending.erase(iter);
+    auto durationUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            finishTime - startTime)
+            .count());
+    auto& stats = state->operations[opcode];
+    stats.totalDurationUs += durationUs;
+    stats.maxDurationUs = std::max(stats.maxDurationUs, durationUs);
+  }
+
+  folly::Synchronized<State> state_;
+};
+} // namespace
+
+folly::SemiFuture<std::unique_ptr<MountProfileReport>>
+EdenServiceHandler::semifuture_profileMount(
+    std::unique_ptr<ProfileMountParams> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG2, *params->mountPoint());
+  auto mountPath = absolutePathFromThrift(*params->mountPoint());
+  auto edenMount = server_->getMount(mountPath);
+
+  auto durationSeconds = std::clamp<int64_t>(*params->durationSeconds(), 1, 60);
+
+  struct ProfileContext {
+    // Shared with the TraceBus subscriber lambdas rather than owned directly
+    // so the subscription handle below does not keep the context alive.
+    std::shared_ptr<FsProfileAccumulator> accumulator =
+        std::make_shared<FsProfileAccumulator>();
+    /** Translates an accumulated opcode to a human-readable name. */
+    folly::Function<std::string(uint64_t) const> opcodeName;
+#ifdef _WIN32
+    TraceSubscriptionHandle<PrjfsTraceEvent> subHandle;
+#else
+    std::variant<
+        TraceSubscriptionHandle<FuseTraceEvent>,
+        TraceSubscriptionHandle<NfsTraceEvent>>
+        subHandle;
+#endif // _WIN32
+  };
+  auto context = std::make_shared<ProfileContext>();
+
+  auto subscriberName =
+      fmt::format("profile-{}", edenMount->getPath().basename());
+#ifdef _WIN32
+  auto prjfsChannel = edenMount->getPrjfsChannel()->getInner();
+  if (!prjfsChannel) {
+    throw newEdenError(
+        EdenErrorType::GENERIC_ERROR,
+        fmt::format("mount {} does not have a running channel", mountPath));
+  }
+  context->opcodeName = [](uint64_t opcode) {
+    return apache::thrift::util::enumNameSafe(
+        static_cast<PrjfsTraceCallType>(opcode));
+  };
+  context->subHandle = prjfsChannel->getTraceBusPtr()->subscribeFunction(
+      std::move(subscriberName),
+      [accumulator = context->accumulator](const PrjfsTraceEvent& event) {
+        auto commandId = static_cast<uint64_t>(event.getData().commandId);
+        switch (event.getType()) {
+          case PrjfsTraceEvent::START:
+            accumulator->recordStart(
+                commandId,
+                static_cast<uint64_t>(event.getCallType()),
+                event.monotonicTime);
+            break;
+          case PrjfsTraceEvent::FINISH:
+            accumulator->recordFinish(commandId, event.monotonicTime);
+            break;
+        }
+      });
+#else
+  auto* fuseChannel = edenMount->getFuseChannel();
+  auto* nfsdChannel = edenMount->getNfsdChannel();
+  if (fuseChannel) {
+    context->opcodeName = [](uint64_t opcode) {
+      return fuseOpcodeName(static_cast<uint32_t>(opcode)).str();
+    };
+    context->subHandle = fuseChannel->getTraceBus().subscribeFunction(
+        std::move(subscriberName),
+        [accumulator = context->accumulator](const FuseTraceEvent& event) {
+          switch (event.getType()) {
+            case FuseTraceEvent::START:
+              accumulator->recordStart(
+                  event.getUnique(),
+                  event.getRequest().opcode,
+                  event.monotonicTime);
+              break;
+            case FuseTraceEvent::FINISH:
+              accumulator->recordFinish(event.getUnique(), event.monotonicTime);
+              break;
+          }
+        });
+  } else if (nfsdChannel) {
+    context->opcodeName = [](uint64_t opcode) {
+      return nfsProcName(static_cast<uint32_t>(opcode)).str();
+    };
+    context->subHandle = nfsdChannel->getTraceBus().subscribeFunction(
+        std::move(subscriberName),
+        [accumulator = context->accumulator](const NfsTraceEvent& event) {
+          switch (event.getType()) {
+            case NfsTraceEvent::START:
+              accumulator->recordStart(
+                  event.getXid(), event.getProcNumber(), event.monotonicTime);
+              break;
+            case NfsTraceEvent::FINISH:
+              accumulator->recordFinish(event.getXid(), event.monotonicTime);
+              break;
+          }
+        });
+  } else {
+    throw newEdenError(
+        EdenErrorType::GENERIC_ERROR,
+        fmt::format("mount {} does not have a running channel", mountPath));
+  }
+#endif // _WIN32
+
+  auto blobStatsBefore = server_->getBlobCache()->getStats();
+  auto treeStatsBefore = server_->getTreeCache()->getStats();
+
+  auto sampleFuture =
+      folly::futures::sleep(std::chrono::seconds(durationSeconds))
+          .deferValue([this,
+                       context,
+                       edenMount,
+                       durationSeconds,
+                       blobStatsBefore,
+                       treeStatsBefore](folly::Unit) {
+        // Stop sampling before reading the accumulated state.
+#ifdef _WIN32
+        context->subHandle.reset();
+#else
+        std::visit(
+            [](auto& handle) { handle.reset(); }, context->subHandle);
+#endif // _WIN32
+
+        auto report = std::make_unique<MountProfileReport>();
+        report->sampledDurationSeconds_ref() = durationSeconds;
+
+        uint64_t totalRequests = 0;
+        uint64_t totalDurationUs = 0;
+        std::vector<ProfiledFsOperation> operations;
+        {
+          auto state = context->accumulator->state_.rlock();
+          totalRequests = state->totalRequests;
+          operations.reserve(state->operations.size());
+          for (const auto& [opcode, stats] : state->operations) {
+            ProfiledFsOperation operation;
+            operation.name_ref() = context->opcodeName(opcode);
+            operation.count_ref() = stats.count;
+            operation.totalDurationUs_ref() = stats.totalDurationUs;
+            operation.maxDurationUs_ref() = stats.maxDurationUs;
+            totalDurationUs += stats.totalDurationUs;
+            operations.push_back(std::move(operation));
+          }
+        }
+        std::sort(
+            operations.begin(),
+            operations.end(),
+            [](const ProfiledFsOperation& a, const ProfiledFsOperation& b) {
+              return *a.totalDurationUs() > *b.totalDurationUs();
+            });
+        report->totalFsRequests_ref() = totalRequests;
+        report->fsOperations_ref() = std::move(operations);
+
+        auto blobStats = server_->getBlobCache()->getStats();
+        auto treeStats = server_->getTreeCache()->getStats();
+        ProfiledCacheStats cacheStats;
+        cacheStats.blobCacheHits_ref() =
+            blobStats.hitCount - blobStatsBefore.hitCount;
+        cacheStats.blobCacheMisses_ref() =
+            blobStats.missCount - blobStatsBefore.missCount;
+        cacheStats.treeCacheHits_ref() =
+            treeStats.hitCount - treeStatsBefore.hitCount;
+        cacheStats.treeCacheMisses_ref() =
+            treeStats.missCount - treeStatsBefore.missCount;
+        report->cacheStats_ref() = cacheStats;
+
+        uint64_t pendingImports = 0;
+        uint64_t liveImports = 0;
+        uint64_t maxPendingImportUs = 0;
+        auto backingStore = edenMount->getObjectStore()->getBackingStore();
+        std::shared_ptr<HgQueuedBackingStore> hgBackingStore;
+        try {
+          hgBackingStore =
+              castToHgQueuedBackingStore(backingStore, edenMount->getPath());
+        } catch (const EdenError&) {
+          // Not an hg-backed mount; leave the import fields at zero.
+        }
+        if (hgBackingStore) {
+          for (auto object : HgBackingStore::hgImportObjects) {
+            pendingImports += hgBackingStore->getImportMetric(
+                RequestMetricsScope::RequestStage::PENDING,
+                object,
+                RequestMetricsScope::RequestMetric::COUNT);
+            liveImports += hgBackingStore->getImportMetric(
+                RequestMetricsScope::RequestStage::LIVE,
+                object,
+                RequestMetricsScope::RequestMetric::COUNT);
+            maxPendingImportUs = std::max<uint64_t>(
+                maxPendingImportUs,
+                hgBackingStore->getImportMetric(
+                    RequestMetricsScope::RequestStage::PENDING,
+                    object,
+                    RequestMetricsScope::RequestMetric::MAX_DURATION_US));
+          }
+        }
+        report->pendingImports_ref() = pendingImports;
+        report->liveImports_ref() = liveImports;
+        report->maxPendingImportDurationUs_ref() = maxPendingImportUs;
+
+        // Rank the likely bottleneck. This is a heuristic: imports stalled
+        // for over a second dominate anything the caches or channel do, a
+        // miss-heavy cache means data is being refetched rather than served
+        // from memory, and otherwise the per-operation breakdown above is
+        // the best lead.
+        auto cacheMisses = *cacheStats.blobCacheMisses_ref() +
+            *cacheStats.treeCacheMisses_ref();
+        auto cacheHits =
+            *cacheStats.blobCacheHits_ref() + *cacheStats.treeCacheHits_ref();
+        std::string bottleneck;
+        if (totalRequests == 0) {
+          bottleneck =
+              "no filesystem requests were observed; the mount looks idle";
+        } else if (pendingImports > 0 && maxPendingImportUs > 1000000) {
+          bottleneck = fmt::format(
+              "SCM imports: {} imports are queued and the oldest has been "
+              "pending for {}ms",
+              pendingImports,
+              maxPendingImportUs / 1000);
+        } else if (cacheMisses > cacheHits) {
+          bottleneck = fmt::format(
+              "object cache misses: {} misses vs {} hits during the window; "
+              "objects are being refetched rather than served from memory",
+              cacheMisses,
+              cacheHits);
+        } else {
+          const auto& fsOperations = *report->fsOperations_ref();
+          bottleneck = fmt::format(
+              "filesystem processing: {} requests took {}ms total{}",
+              totalRequests,
+              totalDurationUs / 1000,
+              fsOperations.empty() ? std::string{}
+                                   : fmt::format(
+                                         ", mostly in {}",
+                                         *fsOperations.front().name()));
+        }
+        report->likelyBottleneck_ref() = bottleneck;
+
+        return report;
+      });
+
+  return wrapImmediateFuture(
+             std::move(helper),
+             ImmediateFuture<std::unique_ptr<MountProfileReport>>{
+                 std::move(sampleFuture)})
+      .semi();
+}
+
+void EdenServiceHandler::getTracePerfStats(
+    GetTracePerfStatsResponse& result,
+    std::unique_ptr<GetTracePerfStatsParams> params) {
+  auto helper = INSTRUMENT_THRIFT_CALL(DBG3, *params->mountPoint());
+  auto mountPath = absolutePathFromThrift(*params->mountPoint());
+  auto edenMount = server_->getMount(mountPath);
+
+  const auto& aggregator = edenMount->getTracePerfAggregator();
+  if (!aggregator) {
+    throw newEdenError(
+        EdenErrorType::GENERIC_ERROR,
+        fmt::format(
+            "trace perf aggregation is disabled for {}; enable "
+            "telemetry:enable-trace-perf and remount",
+            mountPath));
+  }
+
+  auto windowSeconds = std::clamp<int64_t>(
+      *params->windowSeconds(), 1, TracePerfAggregator::kMaxWindow.count());
+  auto reports = aggregator->read(std::chrono::seconds{windowSeconds});
+
+  // The aggregator stores raw operation codes; translate fs rows with the
+  // mount's channel type, which fixes the code's namespace.
+  folly::Function<std::string(uint32_t) const> fsOperationName;
+#ifdef _WIN32
+  fsOperationName = [](uint32_t code) {
+    return apache::thrift::util::enumNameSafe(
+        static_cast<PrjfsTraceCallType>(code));
+  };
+#else
+  if (edenMount->getNfsdChannel()) {
+    fsOperationName = [](uint32_t code) { return nfsProcName(code).str(); };
+  } else {
+    fsOperationName = [](uint32_t code) { return fuseOpcodeName(code).str(); };
+  }
+#endif // _WIN32
+
+  std::vector<TracePerfOperation> operations;
+  operations.reserve(reports.size());
+  for (const auto& report : reports) {
+    TracePerfOperation operation;
+    switch (report.operation) {
+      case TracePerfAggregator::Operation::FsRequest:
+        operation.subsystem_ref() = "fs";
+        operation.name_ref() = fsOperationName(report.code);
+        break;
+      case TracePerfAggregator::Operation::HgBlobImport:
+        operation.subsystem_ref() = "hg";
+        operation.name_ref() = "blob_import";
+        break;
+      case TracePerfAggregator::Operation::HgTreeImport:
+        operation.subsystem_ref() = "hg";
+        operation.name_ref() = "tree_import";
+        break;
+      case TracePerfAggregator::Operation::InodeMaterialization:
+        operation.subsystem_ref() = "inode";
+        operation.name_ref() = "materialization";
+        break;
+      case TracePerfAggregator::Operation::InodeLoad:
+        operation.subsystem_ref() = "inode";
+        operation.name_ref() = "load";
+        break;
+    }
+    operation.count_ref() = report.totals.count;
+    operation.totalDurationUs_ref() = report.totals.totalNs / 1000;
+    operation.maxDurationUs_ref() = report.totals.maxNs / 1000;
+    operation.queueWaitUs_ref() = report.totals.queueWaitNs / 1000;
+    operation.storeFetchUs_ref() = report.totals.storeFetchNs / 1000;
+    operations.push_back(std::move(operation));
+  }
+  std::sort(
+      operations.begin(),
+      operations.end(),
+      [](const TracePerfOperation& a, const TracePerfOperation& b) {
+        return *a.totalDurationUs() > *b.totalDurationUs();
+      });
+
+  result.windowSeconds_ref() = windowSeconds;
+  result.operations_ref() = std::move(operations);
+}
+
 void EdenServiceHandler::flushStatsNow() {
   auto helper = INSTRUMENT_THRIFT_CALL(DBG3);
   server_->flushStatsNow();
@@ -10,6 +10,7 @@
 #include <fb303/BaseService.h>
 #include <optional>
 #include "eden/fs/eden-config.h"
+#include "eden/fs/service/ThriftRequestGovernor.h"
 #include "eden/fs/service/gen-cpp2/StreamingEdenService.h"
 #include "eden/fs/telemetry/ActivityBuffer.h"
 #include "eden/fs/telemetry/TraceBus.h"
@@ -139,13 +140,8 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
       std::unique_ptr<std::vector<std::string>> paths,
       std::unique_ptr<SyncBehavior> sync) override;
 
-  // the caller should ensure the relativePath is valid until the returned
+  // the caller should ensure the paths are valid until the returned
   // futures complete.
-  ImmediateFuture<EntryAttributes> getEntryAttributesForPath(
-      EntryAttributeFlags reqBitmask,
-      AbsolutePathPiece mountPoint,
-      folly::StringPiece path,
-      const ObjectFetchContextPtr& fetchContext);
   ImmediateFuture<std::vector<folly::Try<EntryAttributes>>> getEntryAttributes(
       AbsolutePathPiece mountPath,
       std::vector<std::string>& paths,
@@ -162,6 +158,14 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
       std::unique_ptr<std::string> mountPoint,
       std::unique_ptr<JournalPosition> fromPosition) override;
 
+  void getFilesChangedSincePaged(
+      FilesChangedPage& out,
+      std::unique_ptr<FilesChangedPageParams> params) override;
+
+  void sinceQuery(
+      SinceQueryResult& out,
+      std::unique_ptr<SinceQueryParams> params) override;
+
   void setJournalMemoryLimit(
       std::unique_ptr<PathString> mountPoint,
       int64_t limit) override;
@@ -175,6 +179,8 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
       DebugGetRawJournalResponse& out,
       std::unique_ptr<DebugGetRawJournalParams> params) override;
 
+  void debugGetMemoryArenaStats(std::vector<MemoryArenaStats>& out) override;
+
   folly::SemiFuture<std::unique_ptr<std::vector<EntryInformationOrError>>>
   semifuture_getEntryInformation(
       std::unique_ptr<std::string> mountPoint,
@@ -204,6 +210,25 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
   folly::SemiFuture<folly::Unit> semifuture_prefetchFiles(
       std::unique_ptr<PrefetchParams> params) override;
 
+  folly::SemiFuture<std::unique_ptr<PrefetchTreeResult>>
+  semifuture_prefetchTreeRecursive(
+      std::unique_ptr<PrefetchTreeParams> params) override;
+
+  folly::SemiFuture<std::unique_ptr<PrefetchPathsResult>>
+  semifuture_prefetchPaths(
+      std::unique_ptr<PrefetchPathsParams> params) override;
+
+  void startMountWarmup(
+      std::unique_ptr<std::string> mountPoint,
+      std::unique_ptr<std::vector<std::string>> paths) override;
+
+  void getMountWarmupProgress(
+      MountWarmupProgress& progress,
+      std::unique_ptr<std::string> mountPoint) override;
+
+  folly::SemiFuture<folly::Unit> semifuture_prepareCheckout(
+      std::unique_ptr<PrepareCheckoutParams> params) override;
+
   folly::SemiFuture<std::unique_ptr<Glob>> semifuture_predictiveGlobFiles(
       std::unique_ptr<GlobParams> params) override;
 
@@ -235,6 +260,13 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
   apache::thrift::ResponseAndServerStream<ChangesSinceResult, ChangedFileResult>
   streamChangesSince(std::unique_ptr<StreamChangesSinceParams> params) override;
 
+  apache::thrift::ResponseAndServerStream<StreamStatusResult, ChangedFileResult>
+  streamStatus(std::unique_ptr<GetScmStatusParams> params) override;
+
+  void changesSinceV2(
+      ChangesSinceV2Result& out,
+      std::unique_ptr<ChangesSinceV2Params> params) override;
+
   folly::SemiFuture<std::unique_ptr<ScmStatus>> semifuture_getScmStatus(
       std::unique_ptr<std::string> mountPoint,
       bool listIgnored,
@@ -290,6 +322,10 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
   void debugOutstandingThriftRequests(
       std::vector<ThriftRequestMetadata>& outstandingCalls) override;
 
+  void debugRehearseTakeover(
+      TakeoverRehearsalResult& result,
+      std::unique_ptr<std::string> outputPath) override;
+
   void debugStartRecordingActivity(
       ActivityRecorderResult& result,
       std::unique_ptr<std::string> mountPoint,
@@ -304,6 +340,14 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
       ListActivityRecordingsResult& result,
       std::unique_ptr<std::string> mountPoint) override;
 
+  int64_t debugDumpFlightRecorder(
+      std::unique_ptr<std::string> mountPoint,
+      std::unique_ptr<std::string> outputPath,
+      int64_t seconds) override;
+
+  void debugGetImmediateFutureAudit(
+      std::vector<ImmediateFutureCallSite>& result) override;
+
   void debugGetInodePath(
       InodePathDebugInfo& inodePath,
       std::unique_ptr<std::string> mountPoint,
@@ -313,6 +357,10 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
 
   void clearFetchCountsByMount(std::unique_ptr<std::string> mountPath) override;
 
+  void getFetchOriginStats(
+      FetchOriginStats& result,
+      std::unique_ptr<std::string> mountPoint) override;
+
   void getAccessCounts(GetAccessCountsResult& result, int64_t duration)
       override;
 
@@ -343,6 +391,13 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
       InternalStats& result,
       std::unique_ptr<GetStatInfoParams> params) override;
 
+  folly::SemiFuture<std::unique_ptr<MountProfileReport>>
+  semifuture_profileMount(std::unique_ptr<ProfileMountParams> params) override;
+
+  void getTracePerfStats(
+      GetTracePerfStatsResponse& result,
+      std::unique_ptr<GetTracePerfStatsParams> params) override;
+
   void enableTracing() override;
   void disableTracing() override;
   void getTracePoints(std::vector<TracePoint>& result) override;
@@ -417,11 +472,6 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
  private:
   std::shared_ptr<EdenMount> lookupMount(MountId& mountId);
 
-  ImmediateFuture<Hash20> getSHA1ForPath(
-      const EdenMount& edenMount,
-      RelativePath path,
-      const ObjectFetchContextPtr& fetchContext);
-
   folly::Synchronized<std::unordered_map<uint64_t, ThriftRequestTraceEvent>>
       outstandingThriftRequests_;
 #ifdef EDEN_HAVE_USAGE_SERVICE
@@ -443,5 +493,7 @@ class EdenServiceHandler : virtual public StreamingEdenServiceSvIf,
   std::shared_ptr<ThriftRequestTraceHandle> thriftRequestTraceHandle_;
 
   std::shared_ptr<TraceBus<ThriftRequestTraceEvent>> thriftRequestTraceBus_;
+
+  ThriftRequestGovernor thriftRequestGovernor_;
 };
 } // namespace facebook::eden
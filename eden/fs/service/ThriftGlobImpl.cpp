@@ -7,22 +7,126 @@
 
 #include "eden/fs/service/ThriftGlobImpl.h"
 
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <folly/executors/ExecutorWithPriority.h>
 #include <folly/futures/Future.h>
 #include <folly/logging/LogLevel.h>
 #include <folly/logging/xlog.h>
+
+#include <optional>
+
 #include "eden/fs/inodes/EdenMount.h"
 #include "eden/fs/inodes/GlobNode.h"
 #include "eden/fs/inodes/ServerState.h"
 #include "eden/fs/inodes/TreeInode.h"
+#include "eden/fs/journal/Journal.h"
+#include "eden/fs/model/Hash.h"
 #include "eden/fs/model/RootId.h"
 #include "eden/fs/service/gen-cpp2/eden_types.h"
 #include "eden/fs/store/ObjectFetchContext.h"
 #include "eden/fs/store/PathLoader.h"
+#include "eden/fs/telemetry/EdenStats.h"
 #include "eden/fs/utils/EdenError.h"
 #include "eden/fs/utils/UnboundedQueueExecutor.h"
 
 namespace facebook::eden {
 
+namespace {
+
+/**
+ * Cache of compiled glob trees, keyed by a hash of the glob list and the
+ * options it was compiled with.
+ *
+ * Prefetch profiles resend the same multi-hundred-entry glob list on every
+ * call, and compiling it into a GlobNode tree is pure CPU on the request
+ * path. A GlobNode tree is immutable once parsed and evaluate() is const,
+ * so one compiled tree can be shared by any number of concurrent calls.
+ */
+constexpr size_t kCompiledGlobCacheSize = 32;
+
+using CompiledGlobCache =
+    folly::EvictingCacheMap<Hash20, std::shared_ptr<const GlobNode>>;
+
+folly::Synchronized<CompiledGlobCache>& compiledGlobCache() {
+  static folly::Synchronized<CompiledGlobCache> cache{
+      CompiledGlobCache{kCompiledGlobCacheSize}};
+  return cache;
+}
+
+Hash20 computeCompiledGlobCacheKey(
+    const std::vector<std::string>& globs,
+    bool includeDotfiles,
+    CaseSensitivity caseSensitive) {
+  std::string buffer;
+  buffer.push_back(includeDotfiles ? 1 : 0);
+  buffer.push_back(caseSensitive == CaseSensitivity::Insensitive ? 1 : 0);
+  for (const auto& glob : globs) {
+    buffer.append(glob);
+    buffer.push_back('\0');
+  }
+  return Hash20::sha1(buffer);
+}
+
+/**
+ * Cache of fully evaluated glob results, keyed by a hash of everything the
+ * answer depends on: the mount, the compiled glob and its options, the
+ * roots it was evaluated against and — for working copy globs — the
+ * journal sequence at the time of evaluation.
+ *
+ * Buck2 sends the exact same globFiles query many times within a single
+ * build. As long as the journal has not advanced in between, the previous
+ * answer is still valid and can be returned without walking any trees.
+ * Results computed against explicit commit hashes never depend on the
+ * working copy and stay valid for as long as they remain cached.
+ */
+constexpr size_t kGlobResultCacheSize = 128;
+
+using GlobResultCache =
+    folly::EvictingCacheMap<Hash20, std::shared_ptr<const Glob>>;
+
+folly::Synchronized<GlobResultCache>& globResultCache() {
+  static folly::Synchronized<GlobResultCache> cache{
+      GlobResultCache{kGlobResultCacheSize}};
+  return cache;
+}
+
+Hash20 computeGlobResultCacheKey(
+    AbsolutePathPiece mountPath,
+    const Hash20& compiledGlobKey,
+    const std::vector<std::string>& rootHashes,
+    folly::StringPiece searchRoot,
+    bool wantDtype,
+    bool listOnlyFiles,
+    bool suppressFileList,
+    folly::StringPiece checkedOutRoot,
+    uint64_t journalSequence) {
+  std::string buffer;
+  buffer.append(mountPath.stringPiece().data(), mountPath.stringPiece().size());
+  buffer.push_back('\0');
+  auto compiledBytes = compiledGlobKey.getBytes();
+  buffer.append(
+      reinterpret_cast<const char*>(compiledBytes.data()),
+      compiledBytes.size());
+  buffer.push_back(wantDtype ? 1 : 0);
+  buffer.push_back(listOnlyFiles ? 1 : 0);
+  buffer.push_back(suppressFileList ? 1 : 0);
+  buffer.append(searchRoot.data(), searchRoot.size());
+  buffer.push_back('\0');
+  for (const auto& rootHash : rootHashes) {
+    buffer.append(rootHash);
+    buffer.push_back('\0');
+  }
+  buffer.append(checkedOutRoot.data(), checkedOutRoot.size());
+  buffer.push_back('\0');
+  buffer.append(
+      reinterpret_cast<const char*>(&journalSequence),
+      sizeof(journalSequence));
+  return Hash20::sha1(buffer);
+}
+
+} // namespace
+
 ThriftGlobImpl::ThriftGlobImpl(const GlobParams& params)
     : includeDotfiles_{*params.includeDotfiles_ref()},
       prefetchFiles_{*params.prefetchFiles_ref()},
@@ -43,27 +147,77 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
     std::shared_ptr<ServerState> serverState,
     std::vector<std::string> globs,
     const ObjectFetchContextPtr& fetchContext) {
-  // Compile the list of globs into a tree
-  auto globRoot = std::make_shared<GlobNode>(
-      includeDotfiles_,
+  auto caseSensitive =
       serverState->getEdenConfig()->globUseMountCaseSensitivity.getValue()
-          ? edenMount->getCheckoutConfig()->getCaseSensitive()
-          : CaseSensitivity::Sensitive);
-  try {
-    for (auto& globString : globs) {
-      try {
-        globRoot->parse(globString);
-      } catch (const std::domain_error& exc) {
-        throw newEdenError(
-            EdenErrorType::ARGUMENT_ERROR,
-            "Invalid glob (",
-            exc.what(),
-            "): ",
-            globString);
+      ? edenMount->getCheckoutConfig()->getCaseSensitive()
+      : CaseSensitivity::Sensitive;
+
+  // Compile the list of globs into a tree, reusing a previously compiled
+  // tree if the same glob list was evaluated recently.
+  auto cacheKey =
+      computeCompiledGlobCacheKey(globs, includeDotfiles_, caseSensitive);
+  std::shared_ptr<const GlobNode> globRoot;
+  {
+    auto cache = compiledGlobCache().wlock();
+    if (auto cached = cache->find(cacheKey); cached != cache->end()) {
+      globRoot = cached->second;
+    }
+  }
+  serverState->getStats().increment(
+      globRoot ? &ThriftStats::globCompiledCacheHit
+               : &ThriftStats::globCompiledCacheMiss);
+  if (!globRoot) {
+    auto newRoot = std::make_shared<GlobNode>(includeDotfiles_, caseSensitive);
+    try {
+      for (auto& globString : globs) {
+        try {
+          newRoot->parse(globString);
+        } catch (const std::domain_error& exc) {
+          throw newEdenError(
+              EdenErrorType::ARGUMENT_ERROR,
+              "Invalid glob (",
+              exc.what(),
+              "): ",
+              globString);
+        }
       }
+    } catch (const std::system_error& exc) {
+      throw newEdenError(exc);
+    }
+    globRoot = newRoot;
+    compiledGlobCache().wlock()->set(cacheKey, globRoot);
+  }
+
+  // Reuse a previously computed answer when nothing it depends on can have
+  // changed. Prefetching is a side effect the caller wants re-run, so only
+  // pure queries are memoized. The journal sequence is sampled before the
+  // walk starts: a write racing with the evaluation advances the sequence
+  // and turns the stored entry into a miss rather than a stale hit.
+  std::optional<Hash20> resultCacheKey;
+  if (!prefetchFiles_) {
+    uint64_t journalSequence = 0;
+    std::string checkedOutRoot;
+    if (rootHashes_.empty()) {
+      journalSequence = edenMount->getJournal().getLatestSequenceID();
+      checkedOutRoot = edenMount->getObjectStore()->renderRootId(
+          edenMount->getCheckedOutRootId());
     }
-  } catch (const std::system_error& exc) {
-    throw newEdenError(exc);
+    resultCacheKey = computeGlobResultCacheKey(
+        edenMount->getPath(),
+        cacheKey,
+        rootHashes_,
+        searchRootUser_,
+        wantDtype_,
+        listOnlyFiles_,
+        suppressFileList_,
+        checkedOutRoot,
+        journalSequence);
+    auto cache = globResultCache().wlock();
+    if (auto cached = cache->find(*resultCacheKey); cached != cache->end()) {
+      serverState->getStats().increment(&ThriftStats::globResultCacheHit);
+      return std::make_unique<Glob>(*cached->second);
+    }
+    serverState->getStats().increment(&ThriftStats::globResultCacheMiss);
   }
 
   auto fileBlobsToPrefetch =
@@ -83,6 +237,14 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
     searchRoot = RelativePath{searchRootUser_};
   }
 
+  // Fan the evaluation out over the server thread pool so that globs over
+  // already-fetched trees aren't serialized onto a single thread. The tasks
+  // run at the priority implied by the calling context, so a background
+  // prefetch's evaluation cannot queue ahead of an interactive query's.
+  auto globExecutor = folly::ExecutorWithPriority::create(
+      folly::getKeepAliveToken(serverState->getThreadPool().get()),
+      fetchContext->getExecutorPriority());
+
   if (!rootHashes_.empty()) {
     // Note that we MUST reserve here, otherwise while emplacing we might
     // invalidate the earlier commitHash refrences
@@ -111,6 +273,7 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
                    fetchContext = fetchContext.copy(),
                    fileBlobsToPrefetch,
                    globResults,
+                   globExecutor,
                    &originRootId](std::shared_ptr<const Tree>&& tree) mutable {
                     return globRoot->evaluate(
                         edenMount->getObjectStore(),
@@ -119,7 +282,8 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
                         std::move(tree),
                         fileBlobsToPrefetch.get(),
                         *globResults,
-                        originRootId);
+                        originRootId,
+                        globExecutor.get());
                   }));
     }
   } else {
@@ -132,6 +296,7 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
                         edenMount,
                         fileBlobsToPrefetch,
                         globResults,
+                        globExecutor,
                         &originRootId](InodePtr inode) mutable {
               return globRoot->evaluate(
                   edenMount->getObjectStore(),
@@ -140,12 +305,20 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
                   inode.asTreePtr(),
                   fileBlobsToPrefetch.get(),
                   *globResults,
-                  originRootId);
+                  originRootId,
+                  globExecutor.get());
             }));
   }
 
+  // Assemble the response on the thread pool rather than on whichever
+  // thread happens to complete the last glob future (often a backing store
+  // EventBase): sorting and copying a very large result set there would
+  // stall unrelated work sharing that thread.
   auto prefetchFuture =
-      collectAll(std::move(globFutures))
+      ImmediateFuture{collectAll(std::move(globFutures))
+                          .semi()
+                          .via(globExecutor.get())
+                          .semi()}
           .thenValue([fileBlobsToPrefetch,
                       globResults = std::move(globResults),
                       suppressFileList = suppressFileList_](
@@ -188,12 +361,21 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
                suppressFileList = suppressFileList_,
                listOnlyFiles = listOnlyFiles_,
                fetchContext = fetchContext.copy(),
+               resultCacheKey,
                config = serverState->getEdenConfig()](
                   std::vector<GlobNode::GlobResult>&& results) mutable
               -> ImmediateFuture<std::unique_ptr<Glob>> {
                 auto out = std::make_unique<Glob>();
 
                 if (!suppressFileList) {
+                  // Size the output arrays up front; growing them
+                  // incrementally reallocates several times for
+                  // multi-hundred-thousand entry results.
+                  out->matchingFiles_ref()->reserve(results.size());
+                  if (wantDtype) {
+                    out->dtypes_ref()->reserve(results.size());
+                  }
+                  out->originHashes_ref()->reserve(results.size());
                   // already deduplicated at this point, no need to de-dup
                   for (auto& entry : results) {
                     if (!listOnlyFiles || entry.dtype != dtype_t::Dir) {
@@ -235,6 +417,10 @@ ImmediateFuture<std::unique_ptr<Glob>> ThriftGlobImpl::glob(
                         return std::move(glob);
                       });
                 }
+                if (resultCacheKey) {
+                  globResultCache().wlock()->set(
+                      *resultCacheKey, std::make_shared<const Glob>(*out));
+                }
                 return std::move(out);
               })
           .ensure([globRoot, originRootIds = std::move(originRootIds)]() {
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/service/ThriftRequestGovernor.h"
+
+#include <fb303/ServiceData.h>
+
+#include "eden/fs/config/ReloadableConfig.h"
+#include "eden/fs/utils/EdenError.h"
+
+namespace facebook::eden {
+
+namespace {
+
+constexpr folly::StringPiece kActiveCounter{"thrift.heavy_requests.active"};
+constexpr folly::StringPiece kShedCounter{"thrift.heavy_requests.shed"};
+
+} // namespace
+
+ThriftRequestGovernor::ThriftRequestGovernor(
+    std::shared_ptr<ReloadableConfig> config)
+    : config_{std::move(config)} {}
+
+ThriftRequestGovernor::Slot::~Slot() {
+  owner_->release(clientPid_);
+}
+
+std::unique_ptr<ThriftRequestGovernor::Slot>
+ThriftRequestGovernor::acquireHeavySlot(std::optional<pid_t> clientPid) {
+  auto edenConfig = config_->getEdenConfig();
+  auto globalLimit = edenConfig->thriftHeavyRequestLimit.getValue();
+  auto perClientLimit =
+      edenConfig->thriftHeavyRequestPerClientLimit.getValue();
+
+  {
+    auto state = state_.wlock();
+    if (globalLimit != 0 && state->activeHeavy >= globalLimit) {
+      fb303::fbData->incrementCounter(kShedCounter);
+      throw newEdenError(
+          EBUSY,
+          EdenErrorType::POSIX_ERROR,
+          "too many expensive Thrift requests are already running (",
+          state->activeHeavy,
+          "); try again shortly");
+    }
+    if (clientPid.has_value() && perClientLimit != 0) {
+      auto it = state->activeByClient.find(*clientPid);
+      if (it != state->activeByClient.end() &&
+          it->second >= perClientLimit) {
+        fb303::fbData->incrementCounter(kShedCounter);
+        throw newEdenError(
+            EBUSY,
+            EdenErrorType::POSIX_ERROR,
+            "process ",
+            *clientPid,
+            " already has ",
+            it->second,
+            " expensive Thrift requests running; try again shortly");
+      }
+    }
+
+    ++state->activeHeavy;
+    if (clientPid.has_value()) {
+      ++state->activeByClient[*clientPid];
+    }
+    fb303::fbData->setCounter(kActiveCounter, state->activeHeavy);
+  }
+
+  return std::make_unique<Slot>(this, clientPid);
+}
+
+void ThriftRequestGovernor::release(std::optional<pid_t> clientPid) {
+  auto state = state_.wlock();
+  --state->activeHeavy;
+  if (clientPid.has_value()) {
+    auto it = state->activeByClient.find(*clientPid);
+    if (it != state->activeByClient.end() && --it->second == 0) {
+      state->activeByClient.erase(it);
+    }
+  }
+  fb303::fbData->setCounter(kActiveCounter, state->activeHeavy);
+}
+
+} // namespace facebook::eden
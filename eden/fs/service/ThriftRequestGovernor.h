@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <memory>
+#include <optional>
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+namespace facebook::eden {
+
+class ReloadableConfig;
+
+/**
+ * Admission control for expensive Thrift endpoints.
+ *
+ * Every Thrift client shares the same worker threads, so one tool issuing
+ * heavy calls (working copy status, large globs) can head-of-line block
+ * everyone's cheap calls like getDaemonInfo. Handlers for heavy endpoints
+ * acquire a slot here before doing any work. Slots are bounded globally
+ * and per client - identified by the caller pid from the connection's
+ * peer credentials - and acquisition never queues: when a bound is hit
+ * the request is shed immediately with EBUSY so cheap traffic is never
+ * stuck waiting behind heavy traffic. Shed callers are expected to retry
+ * with backoff.
+ *
+ * Both bounds come from reloadable config (thrift:heavy-request-limit and
+ * thrift:heavy-request-per-client-limit); zero means unlimited.
+ */
+class ThriftRequestGovernor {
+ public:
+  explicit ThriftRequestGovernor(std::shared_ptr<ReloadableConfig> config);
+
+  /**
+   * RAII ownership of one heavy-request slot; the slot is returned to the
+   * governor when this is destroyed. Handlers keep it alive for the
+   * duration of the request, typically via an ensure() on their future
+   * chain.
+   */
+  class Slot {
+   public:
+    Slot(ThriftRequestGovernor* owner, std::optional<pid_t> clientPid)
+        : owner_{owner}, clientPid_{clientPid} {}
+    ~Slot();
+
+    Slot(Slot&&) = delete;
+    Slot& operator=(Slot&&) = delete;
+    Slot(const Slot&) = delete;
+    Slot& operator=(const Slot&) = delete;
+
+   private:
+    ThriftRequestGovernor* const owner_;
+    std::optional<pid_t> const clientPid_;
+  };
+
+  /**
+   * Acquire a heavy-request slot for the given client, or throw an
+   * EdenError carrying EBUSY when either the global or the per-client
+   * bound is saturated.
+   */
+  std::unique_ptr<Slot> acquireHeavySlot(std::optional<pid_t> clientPid);
+
+ private:
+  friend class Slot;
+
+  void release(std::optional<pid_t> clientPid);
+
+  struct State {
+    uint32_t activeHeavy{0};
+    /** In-flight heavy requests per client pid. Erased when zero. */
+    folly::F14FastMap<pid_t, uint32_t> activeByClient;
+  };
+
+  std::shared_ptr<ReloadableConfig> config_;
+  folly::Synchronized<State> state_;
+};
+
+} // namespace facebook::eden
@@ -505,6 +505,63 @@ struct FileDelta {
   7: list<ThriftRootId> snapshotTransitions;
 }
 
+struct SinceQueryParams {
+  1: PathString mountPoint;
+  /** Only changes recorded after this position are returned. */
+  2: JournalPosition fromPosition;
+  /**
+   * Restrict results to paths equal to or under one of these prefixes,
+   * relative to the mount root. An empty list matches every path.
+   */
+  3: list<PathString> prefixes;
+  /**
+   * Restrict results to paths matching one of these glob patterns,
+   * evaluated against the full path relative to the mount root. An empty
+   * list matches every path. Patterns follow the same syntax as
+   * globFiles(); case sensitivity follows the checkout.
+   */
+  4: list<string> globs;
+}
+
+/**
+ * The filtered analogue of FileDelta: only paths that survived the
+ * query's prefix and glob filters are present. The position fields and
+ * uncleanPaths/snapshotTransitions carry the same meaning as in
+ * FileDelta.
+ */
+struct SinceQueryResult {
+  1: JournalPosition fromPosition;
+  2: JournalPosition toPosition;
+  /** Matching changed paths; disjoint with createdPaths. */
+  3: list<PathString> changedPaths;
+  /** Matching created paths; disjoint with changedPaths. */
+  4: list<PathString> createdPaths;
+  5: list<PathString> uncleanPaths;
+  6: list<ThriftRootId> snapshotTransitions;
+}
+
+struct FilesChangedPageParams {
+  1: PathString mountPoint;
+  /** Only changes recorded after this position are returned. */
+  2: JournalPosition fromPosition;
+  /**
+   * Upper bound on the number of journal entries merged into this page.
+   * Values below 1 are treated as 1; the server additionally caps this
+   * with the journal:paged-query-max-entries config value.
+   */
+  3: i64 maxEntries = 10000;
+}
+
+/**
+ * One page of getFilesChangedSincePaged results. When hasMore is true,
+ * pass delta.toPosition as the next call's fromPosition to fetch the
+ * following page.
+ */
+struct FilesChangedPage {
+  1: FileDelta delta;
+  2: bool hasMore;
+}
+
 struct DebugGetRawJournalParams {
   1: PathString mountPoint;
   2: optional i32 limit;
@@ -796,6 +853,19 @@ struct SetLogLevelResult {
   1: bool categoryCreated;
 }
 
+/**
+ * Counters for one EDEN_AUDIT_IMMEDIATE_FUTURE call site: how often the
+ * audited ImmediateFuture chain held an immediate value versus having
+ * degraded to a heap-allocated SemiFuture.
+ */
+struct ImmediateFutureCallSite {
+  1: string file;
+  2: i32 line;
+  3: string function;
+  4: i64 immediateCount;
+  5: i64 semiCount;
+}
+
 struct JournalInfo {
   1: i64 entryCount;
   // The estimated memory used by the journal in bytes
@@ -891,6 +961,25 @@ struct InternalStats {
   9: optional CacheStats treeCacheStats;
 }
 
+/**
+ * Allocator statistics for one subsystem memory arena. See
+ * debugGetMemoryArenaStats().
+ */
+struct MemoryArenaStats {
+  1: string name;
+  /**
+   * False when the daemon is not running under jemalloc and per-arena
+   * accounting is unavailable; the byte counts are meaningless then.
+   */
+  2: bool supported;
+  /** Bytes in live allocations. */
+  3: i64 allocatedBytes;
+  /** Bytes in active pages; the gap to allocatedBytes is fragmentation. */
+  4: i64 activeBytes;
+  /** Bytes of address space mapped by the arena. */
+  5: i64 mappedBytes;
+}
+
 /**
  * Common timestamps for every trace event, used to measure durations and
  * display wall clock time.
@@ -1092,6 +1181,43 @@ struct ThriftRequestMetadata {
   3: pid_t clientPid;
 }
 
+struct TakeoverRehearsalMountInfo {
+  1: PathString mountPoint;
+  /**
+   * Number of inode entries the takeover payload for this mount would
+   * carry, counting both currently loaded and already-unloaded inodes.
+   */
+  2: i64 inodeCount;
+  /**
+   * Time spent snapshotting this mount's inode map, in microseconds.
+   */
+  3: i64 snapshotDurationUs;
+}
+
+struct TakeoverRehearsalResult {
+  1: list<TakeoverRehearsalMountInfo> mounts;
+  /**
+   * Time spent serializing the full takeover payload, in microseconds.
+   */
+  2: i64 serializeDurationUs;
+  /**
+   * Size of the serialized takeover message in bytes, excluding data
+   * carried in transferred file descriptors.
+   */
+  3: i64 messageBytes;
+  /**
+   * Total size in bytes of the memory segments (inode maps, caches) that
+   * would be transferred as file descriptors alongside the message.
+   */
+  4: i64 segmentBytes;
+  5: i64 fileDescriptorCount;
+  /**
+   * Time spent writing the serialized message to outputPath, in
+   * microseconds. Zero when no output path was given.
+   */
+  6: i64 writeDurationUs;
+}
+
 struct GetConfigParams {
   // Whether to reload the config from disk to make sure it is up-to-date
   1: eden_config.ConfigReloadBehavior reload = eden_config.ConfigReloadBehavior.AutoReload;
@@ -1102,6 +1228,92 @@ struct GetStatInfoParams {
   1: i64 statsMask;
 }
 
+struct ProfileMountParams {
+  1: PathString mountPoint;
+  // How long to sample filesystem activity, in seconds. Clamped to [1, 60].
+  2: i64 durationSeconds = 10;
+}
+
+/**
+ * Aggregated statistics for one filesystem operation (a FUSE opcode or NFS
+ * procedure) observed during profileMount's sampling window.
+ */
+struct ProfiledFsOperation {
+  1: string name;
+  // Number of requests that started during the window.
+  2: i64 count;
+  // Total and maximum wall-clock duration of the requests that completed
+  // within the window, in microseconds.
+  3: i64 totalDurationUs;
+  4: i64 maxDurationUs;
+}
+
+/**
+ * In-memory object cache activity observed during profileMount's sampling
+ * window.
+ */
+struct ProfiledCacheStats {
+  1: i64 blobCacheHits;
+  2: i64 blobCacheMisses;
+  3: i64 treeCacheHits;
+  4: i64 treeCacheMisses;
+}
+
+struct MountProfileReport {
+  1: i64 sampledDurationSeconds;
+  // Number of filesystem requests that started during the window.
+  2: i64 totalFsRequests;
+  // Operations ordered by total time spent, most expensive first.
+  3: list<ProfiledFsOperation> fsOperations;
+  4: ProfiledCacheStats cacheStats;
+  // SCM importer queue state at the end of the window. All zero for mounts
+  // whose backing store does not expose import queue metrics.
+  5: i64 pendingImports;
+  6: i64 liveImports;
+  7: i64 maxPendingImportDurationUs;
+  // Human-readable summary of which layer the numbers above point at.
+  8: string likelyBottleneck;
+}
+
+struct GetTracePerfStatsParams {
+  1: PathString mountPoint;
+  // How many trailing seconds of the rolling aggregation to report.
+  // Clamped to [1, 60]; the daemon only retains 60 seconds.
+  2: i64 windowSeconds = 60;
+}
+
+/**
+ * One row of the rolling trace aggregation: a filesystem operation, an hg
+ * import kind, or an inode event kind, with its latency broken into stages.
+ */
+struct TracePerfOperation {
+  // "fs", "hg", or "inode".
+  1: string subsystem;
+  // FUSE opcode / NFS procedure / PrjFS callback name for fs rows;
+  // "blob_import" or "tree_import" for hg rows; "materialization" or
+  // "load" for inode rows.
+  2: string name;
+  // Number of operations that completed during the window.
+  3: i64 count;
+  // Total and maximum wall-clock duration of those operations, in
+  // microseconds.
+  4: i64 totalDurationUs;
+  5: i64 maxDurationUs;
+  // Portion of totalDurationUs spent waiting in the hg import queue and
+  // fetching from the backing store. For fs rows these are the stages of
+  // the imports charged to the row's requests, so totalDurationUs minus
+  // both is time spent outside the importer. Zero for inode rows.
+  6: i64 queueWaitUs;
+  7: i64 storeFetchUs;
+}
+
+struct GetTracePerfStatsResponse {
+  // The window actually served, after clamping.
+  1: i64 windowSeconds;
+  // Rows ordered by total time spent, most expensive first.
+  2: list<TracePerfOperation> operations;
+}
+
 struct DebugInvalidateRequest {
   1: MountId mount;
   // Relative path in the repo to recursively invalidate
@@ -1166,7 +1378,15 @@ struct PredictiveFetch {
   6: optional unsigned64 endTime;
 }
 
-/** Params for prefetchFiles(). */
+/**
+ * Params for prefetchFiles().
+ *
+ * Matching blobs are requested from the backing store in large batches, so
+ * this is the supported way to bulk-warm a working copy, including on
+ * Windows: ProjectedFS only accepts file contents from within its own
+ * GetFileData callback, so files cannot be pre-hydrated on disk, but reads
+ * of prefetched files are served without talking to the server.
+ */
 struct PrefetchParams {
   1: PathString mountPoint;
   2: list<string> globs;
@@ -1186,6 +1406,84 @@ struct PrefetchParams {
   7: optional PredictiveFetch predictiveGlob;
 }
 
+/**
+ * Params for prefetchTreeRecursive().
+ */
+struct PrefetchTreeParams {
+  1: PathString mountPoint;
+  // The directory to walk, relative to the repository root. An empty path
+  // walks the whole repository.
+  2: PathString path;
+  // Commit hash for the revision to walk. If empty, the current revision
+  // is walked.
+  3: ThriftRootId revision;
+  // How many directory levels below `path` to descend. -1 descends all the
+  // way to the leaves; 0 prefetches only the entries of `path` itself.
+  4: i32 depth = -1;
+  // If set, don't prefetch blobs. Only prefetch trees.
+  5: bool directoriesOnly = false;
+  // If set, will run the prefetch but will not wait for the result.
+  6: bool background = false;
+}
+
+struct PrefetchTreeResult {
+  // Number of trees visited during the walk, including the starting
+  // directory.
+  1: i64 treesWalked;
+  // Number of distinct blobs handed to the backing store for prefetch.
+  2: i64 blobsPrefetched;
+}
+
+/**
+ * Params for prefetchPaths().
+ */
+struct PrefetchPathsParams {
+  1: PathString mountPoint;
+  // Repo-relative paths the caller expects to open soon. Files and
+  // directories may be mixed; paths that don't exist in the current
+  // revision are ignored, since hints are advisory.
+  2: list<PathString> paths;
+  // For directory paths, how many levels below the directory to descend.
+  // -1 descends all the way to the leaves; 0 prefetches only the
+  // directory's own entries.
+  3: i32 depth = 0;
+  // If true, fetch only trees and blob metadata (sizes and hashes), not
+  // blob contents. Enough to warm stat()-heavy phases cheaply.
+  4: bool metadataOnly = false;
+  // If set, will run the prefetch but will not wait for the result.
+  5: bool background = false;
+}
+
+struct PrefetchPathsResult {
+  // Number of hinted paths skipped because the journal shows them changed
+  // locally; their content lives in the overlay, so there is nothing to
+  // fetch from the backing store.
+  1: i64 pathsSkipped;
+  // Number of trees visited while warming the hinted paths.
+  2: i64 treesWalked;
+  // Number of distinct blobs (or blob metadata entries, with metadataOnly)
+  // handed to the backing store for prefetch.
+  3: i64 blobsPrefetched;
+}
+
+/**
+ * Progress of a working-set warm-up, as started by startMountWarmup() or
+ * automatically after a fresh mount. Describes the most recently started
+ * warm-up; all counters are zero if none has run for this mount.
+ */
+struct MountWarmupProgress {
+  // True while a warm-up is still walking the working set.
+  1: bool running;
+  // Number of working-set paths the warm-up will visit.
+  2: i64 pathsTotal;
+  // Number of working-set paths whose subtrees have been fully walked.
+  3: i64 pathsCompleted;
+  // Number of trees fetched across all paths walked so far.
+  4: i64 treesWalked;
+  // Number of blobs handed to the backing store for prefetch so far.
+  5: i64 blobsPrefetched;
+}
+
 /** Params for globFiles(). */
 struct GlobParams {
   1: PathString mountPoint;
@@ -1250,6 +1548,8 @@ struct AccessCounts {
   5: i64 fsChannelDurationNs;
   6: i64 fsChannelMemoryCacheImports;
   7: i64 fsChannelDiskCacheImports;
+  8: i64 fsChannelBytesRead;
+  9: i64 fsChannelBytesWritten;
 }
 
 struct MountAccesses {
@@ -1264,6 +1564,24 @@ struct GetAccessCountsResult {
 // 3: map<pid_t, AccessCount> thriftAccesses
 }
 
+/**
+ * Per-mount object fetch counts broken down by object type and by where
+ * the fetch was satisfied, as returned by getFetchOriginStats(). "Disk
+ * cache" covers both the LocalStore and the backing store's on-disk cache
+ * (for example the hgcache).
+ */
+struct FetchOriginStats {
+  1: i64 treesFromMemoryCache;
+  2: i64 treesFromDiskCache;
+  3: i64 treesFromNetwork;
+  4: i64 blobsFromMemoryCache;
+  5: i64 blobsFromDiskCache;
+  6: i64 blobsFromNetwork;
+  7: i64 blobMetadataFromMemoryCache;
+  8: i64 blobMetadataFromDiskCache;
+  9: i64 blobMetadataFromNetwork;
+}
+
 enum TracePointEvent {
   // Start of a new block
   START = 0,
@@ -1402,6 +1720,18 @@ struct CheckOutRevisionParams {
    * need to look it up.
    */
   1: optional BinaryHash hgRootManifest;
+
+  /**
+   * Stop the checkout tree walk at the first conflict found.
+   *
+   * Only honored when checkoutMode is DRY_RUN: tooling can pre-validate a
+   * big checkout in a fraction of the time of a full dry run when it only
+   * needs to know whether any conflict exists. The returned conflict list
+   * is truncated and may contain a few conflicts found by concurrent
+   * walkers before the walk stopped. Ignored for real checkouts, which
+   * cannot abandon a half-applied update.
+   */
+  2: bool stopOnFirstConflict = false;
 }
 
 struct ResetParentCommitsParams {
@@ -1428,6 +1758,17 @@ struct SynchronizeWorkingCopyParams {
   1: SyncBehavior sync;
 }
 
+/**
+ * Params for prepareCheckout().
+ */
+struct PrepareCheckoutParams {
+  1: PathString mountPoint;
+  /** The snapshot an upcoming checkout is expected to move to. */
+  2: ThriftRootId snapshotHash;
+  /** If set, return immediately and run the preparation in the background. */
+  3: bool background = true;
+}
+
 struct EnsureMaterializedParams {
   1: PathString mountPoint;
   2: list<PathString> paths;
@@ -1474,6 +1815,23 @@ service EdenService extends fb303_core.BaseService {
     4: CheckOutRevisionParams params,
   ) throws (1: EdenError ex);
 
+  /**
+   * Warm the caches for an expected future checkout to snapshotHash.
+   *
+   * This diffs the currently checked out snapshot against snapshotHash at
+   * low priority and prefetches the changed trees and blobs, so a later
+   * checkOutRevision() call starts with a hot cache instead of a cold one.
+   * It is an optimization only: it modifies neither the working copy nor
+   * the current snapshot, and checking out a different snapshot afterwards
+   * is always safe.
+   *
+   * Intended to be called after a pull moves a remote bookmark, when the
+   * destination of the next checkout is predictable.
+   */
+  void prepareCheckout(1: PrepareCheckoutParams params) throws (
+    1: EdenError ex,
+  ) (priority = 'BEST_EFFORT');
+
   /**
    * Reset the working directory's parent commits, without changing the working
    * directory contents.
@@ -1583,6 +1941,27 @@ service EdenService extends fb303_core.BaseService {
     2: JournalPosition fromPosition,
   ) throws (1: EdenError ex);
 
+  /** The paginated form of getFilesChangedSince: at most params.maxEntries
+   * journal entries are merged into each page, so both server memory and
+   * response size stay bounded no matter how far behind the caller is.
+   * When hasMore is true, pass delta.toPosition as the next call's
+   * fromPosition to continue. Position handling and the ERANGE/EDOM error
+   * behavior match getFilesChangedSince.
+   */
+  FilesChangedPage getFilesChangedSincePaged(
+    1: FilesChangedPageParams params,
+  ) throws (1: EdenError ex);
+
+  /** Returns the paths changed since a prior point that match the given
+   * prefix and glob filters. The filters run inside the daemon against the
+   * accumulated journal range, so paths the caller does not care about are
+   * never serialized. Position handling and the ERANGE/EDOM error behavior
+   * match getFilesChangedSince.
+   */
+  SinceQueryResult sinceQuery(1: SinceQueryParams params) throws (
+    1: EdenError ex,
+  );
+
   /** Sets the memory limit on the journal such that the journal will forget
    * old data to keep itself under a certain estimated memory use.
    */
@@ -1608,6 +1987,14 @@ service EdenService extends fb303_core.BaseService {
     1: DebugGetRawJournalParams params,
   ) throws (1: EdenError ex);
 
+  /**
+   * Returns allocator statistics for each subsystem memory arena, so heap
+   * growth and fragmentation can be attributed to the subsystem causing it.
+   */
+  list<MemoryArenaStats> debugGetMemoryArenaStats() throws (
+    1: EdenError ex,
+  );
+
   /**
    * Returns the subset of information about a list of paths that can
    * be determined from each's parent directory tree. For now, that
@@ -1722,6 +2109,56 @@ service EdenService extends fb303_core.BaseService {
     priority = 'BEST_EFFORT',
   );
 
+  /**
+   * Recursively prefetches a directory without requiring the caller to
+   * enumerate it first: the daemon walks the trees under the given path
+   * breadth-first, fetching each level's subtrees in parallel and streaming
+   * the discovered blobs to the backing store at low priority as the walk
+   * proceeds. Like prefetchFiles this is an optimization hint and may be
+   * deprioritized.
+   */
+  PrefetchTreeResult prefetchTreeRecursive(
+    1: PrefetchTreeParams params,
+  ) throws (1: EdenError ex) (priority = 'BEST_EFFORT');
+
+  /**
+   * Warms a specific set of paths the caller expects to open soon -- a hint
+   * channel for build tools that know their file accesses ahead of time.
+   * The parent directories of all hinted paths are resolved as one batched
+   * tree walk, then each path's trees and blobs (or just blob metadata,
+   * with metadataOnly) are fetched at low priority and the path's inodes
+   * are loaded so first-open is served entirely from warm caches. Paths
+   * the journal shows as locally changed are skipped: their content lives
+   * in the overlay and needs no fetching. Like prefetchFiles this is an
+   * optimization hint and may be deprioritized.
+   */
+  PrefetchPathsResult prefetchPaths(
+    1: PrefetchPathsParams params,
+  ) throws (1: EdenError ex) (priority = 'BEST_EFFORT');
+
+  /**
+   * Kicks off a background warm-up of the checkout's working set and
+   * returns immediately. Each path's subtree is walked with the same
+   * machinery as prefetchTreeRecursive, fetching trees and blobs at low
+   * priority so the warm-up never competes with live filesystem requests.
+   * If `paths` is empty, the paths are read from the working-set manifest
+   * recorded in the client directory; throws EINVAL if no paths are
+   * available from either source, and EBUSY if a warm-up is already
+   * running for this mount.
+   */
+  void startMountWarmup(
+    1: PathString mountPoint,
+    2: list<PathString> paths,
+  ) throws (1: EdenError ex) (priority = 'BEST_EFFORT');
+
+  /**
+   * Reports progress of the running (or most recently finished) working-set
+   * warm-up for the given mount.
+   */
+  MountWarmupProgress getMountWarmupProgress(
+    1: PathString mountPoint,
+  ) throws (1: EdenError ex);
+
   /**
    * Gets a list of a user's most accessed directories, performs
    * prefetching as specified by PredictiveGlobParams, and returns
@@ -1939,6 +2376,21 @@ service EdenService extends fb303_core.BaseService {
    */
   list<ThriftRequestMetadata> debugOutstandingThriftRequests();
 
+  /**
+   * Rehearse a graceful takeover without stopping any mounts.
+   *
+   * This serializes the same takeover payload a real graceful restart would
+   * hand to the new daemon - snapshotting each mount's inode map and running
+   * the full serialization path - and reports per-phase timings and payload
+   * sizes, so restart blackout windows can be predicted and trended without
+   * actually restarting. The mounts keep running; the serialized data is
+   * discarded, or written to outputPath when one is given (e.g. /dev/null to
+   * include write cost without keeping the data).
+   */
+  TakeoverRehearsalResult debugRehearseTakeover(
+    1: PathString outputPath,
+  ) throws (1: EdenError ex);
+
   /**
    * Start recording performance metrics such as files read
    *
@@ -1970,6 +2422,28 @@ service EdenService extends fb303_core.BaseService {
     1: PathString mountPoint,
   );
 
+  /**
+   * Dump the mount's flight recorder - an always-on in-memory ring of
+   * compact records of recent channel and inode trace events - to a binary
+   * file at outputPath for post-hoc analysis of stalls.
+   *
+   * Only the events recorded during the last `seconds` seconds are written;
+   * 0 dumps the entire ring. Returns the number of events written.
+   */
+  i64 debugDumpFlightRecorder(
+    1: PathString mountPoint,
+    2: PathString outputPath,
+    3: i64 seconds,
+  ) throws (1: EdenError ex);
+
+  /**
+   * Report, for every ImmediateFuture call site instrumented with
+   * EDEN_AUDIT_IMMEDIATE_FUTURE, how often the chain completed immediately
+   * versus degrading to a SemiFuture allocation. Counters accumulate since
+   * process start.
+   */
+  list<ImmediateFutureCallSite> debugGetImmediateFutureAudit();
+
   /**
    * Get the InodePathDebugInfo for the inode that corresponds to the given
    * inode number. This provides the path for the inode and also indicates
@@ -2000,6 +2474,17 @@ service EdenService extends fb303_core.BaseService {
     1: EdenError ex,
   );
 
+  /**
+   * Returns this mount's object fetch counts broken down by object type and
+   * by where the fetch was satisfied (in-memory cache, disk caches, or the
+   * network). Counts accumulate from mount initialization; the
+   * remote-to-total ratio gives cache effectiveness per mount without log
+   * scraping.
+   */
+  FetchOriginStats getFetchOriginStats(1: PathString mountPoint) throws (
+    1: EdenError ex,
+  );
+
   /**
    * Start recording paths of the files fetched from the backing store.
    *
@@ -2098,6 +2583,32 @@ service EdenService extends fb303_core.BaseService {
     1: EdenError ex,
   );
 
+  /**
+   * Run a short built-in performance profile of a mount.
+   *
+   * This samples the mount's filesystem request stream for the requested
+   * duration, correlating request start and finish events to compute
+   * per-operation latencies, and combines the result with object cache hit
+   * rates and SCM importer queue depths to report where time is being spent.
+   * Intended for doctor-style tooling so a slow mount can be diagnosed
+   * without external profiling access.
+   */
+  MountProfileReport profileMount(1: ProfileMountParams params) throws (
+    1: EdenError ex,
+  );
+
+  /**
+   * Read a mount's rolling per-operation trace aggregation.
+   *
+   * Unlike profileMount, which samples for a window after it is called,
+   * this returns statistics the daemon has already been aggregating
+   * continuously from the mount's trace buses, so it answers "what was
+   * slow just now" retroactively. Rendered by `eden trace perf`.
+   */
+  GetTracePerfStatsResponse getTracePerfStats(
+    1: GetTracePerfStatsParams params,
+  ) throws (1: EdenError ex);
+
   void enableTracing();
   void disableTracing();
   list<TracePoint> getTracePoints();
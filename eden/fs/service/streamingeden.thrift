@@ -82,6 +82,57 @@ struct ChangesSinceResult {
   1: eden.JournalPosition toPosition;
 }
 
+/**
+ * Argument to changesSinceV2.
+ */
+struct ChangesSinceV2Params {
+  1: eden.PathString mountPoint;
+  /** Only changes recorded after this position are returned. */
+  2: eden.JournalPosition fromPosition;
+  /**
+   * Upper bound on the number of journal entries folded into one page.
+   * Unset or 0 means the server default; either way the server caps the
+   * page with the journal:paged-query-max-entries config value. Note that
+   * the bound is on journal entries, not on returned files: one entry can
+   * touch several paths, so a page may contain somewhat more than
+   * maxDeltas changes.
+   */
+  3: optional i64 maxDeltas;
+}
+
+/**
+ * One page of changes from changesSinceV2.
+ */
+struct ChangesSinceV2Result {
+  /**
+   * The position this page stopped at. Pass it back as fromPosition to
+   * fetch the next page; doing so is the acknowledgement that this page
+   * was consumed.
+   */
+  1: eden.JournalPosition toPosition;
+  2: list<ChangedFileResult> changes;
+  /**
+   * True when entries newer than toPosition existed at the time the page
+   * was built, i.e. another call will return more changes immediately.
+   */
+  3: bool hasMore;
+  /**
+   * The commit hash transitions within this page, oldest first. Commit
+   * transitions are not expanded into per-file changes; clients that need
+   * the files differing between two commits should diff between these
+   * roots themselves.
+   */
+  4: list<eden.ThriftRootId> commitTransitions;
+}
+
+/**
+ * Initial response of streamStatus. The status entries are delivered on the
+ * stream.
+ */
+struct StreamStatusResult {
+  1: string version;
+}
+
 /**
  * Argument to streamChangesSince API.
  */
@@ -177,4 +228,43 @@ service StreamingEdenService extends eden.EdenService {
   > streamChangesSince(1: StreamChangesSinceParams params) throws (
     1: eden.EdenError ex,
   );
+
+  /**
+   * Pull-based alternative to streamChangesSince with client-acknowledged
+   * checkpoints.
+   *
+   * Each call returns one bounded page of changes folded from at most
+   * maxDeltas journal entries, plus the position to pass back as
+   * fromPosition for the next page. Nothing is buffered in the daemon
+   * between calls: the journal itself holds the unconsumed changes, so a
+   * slow or wedged consumer costs the daemon no memory and can resume from
+   * its last acknowledged checkpoint at any time, until the journal
+   * truncates the range (reported as a JOURNAL_TRUNCATED error, exactly as
+   * in streamChangesSince, at which point the client must do a full
+   * resync).
+   */
+  ChangesSinceV2Result changesSinceV2(1: ChangesSinceV2Params params) throws (
+    1: eden.EdenError ex,
+  );
+
+  /**
+   * Streaming version of getScmStatusV2.
+   *
+   * Status entries are emitted on the stream as the diff walk produces them
+   * instead of being accumulated into a single ScmStatus reply: on a very
+   * dirty working copy the client can start processing (and displaying)
+   * entries immediately, and the daemon never holds the complete result in
+   * memory.
+   *
+   * Like getScmStatusV2, the commit in the params must match the current
+   * working directory parent unless enforceParents is disabled in the config.
+   *
+   * Note that like in streamChangesSince, the stream may not be ordered:
+   * dirty files may appear in any order.
+   */
+  StreamStatusResult, stream<
+    ChangedFileResult throws (1: eden.EdenError ex)
+  > streamStatus(1: eden.GetScmStatusParams params) throws (
+    1: eden.EdenError ex,
+  );
 }
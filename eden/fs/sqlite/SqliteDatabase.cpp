@@ -8,6 +8,7 @@
 #include "eden/fs/sqlite/SqliteDatabase.h"
 
 #include <folly/logging/xlog.h>
+#include <thread>
 #include "eden/fs/sqlite/PersistentSqliteStatement.h"
 
 namespace facebook::eden {
@@ -52,6 +53,10 @@ SqliteDatabase::SqliteDatabase(std::string addr)
   openDb();
 }
 
+namespace {
+constexpr folly::StringPiece kInMemoryPath{":memory:"};
+} // namespace
+
 void SqliteDatabase::openDb() {
   auto lockedState = db_.wlock();
   switch (lockedState->status) {
@@ -78,6 +83,16 @@ void SqliteDatabase::openDb() {
   lockedState->db = db;
 
   cache_ = std::make_unique<StatementCache>(lockedState);
+
+  // In-memory databases cannot share their contents across connections, so
+  // a reader pool only makes sense for on-disk databases.
+  if (dbPath_ != kInMemoryPath) {
+    readers_.reserve(kNumReaderConnections);
+    for (size_t i = 0; i < kNumReaderConnections; i++) {
+      readers_.push_back(
+          std::make_unique<folly::Synchronized<SqliteConnection>>());
+    }
+  }
 }
 
 void SqliteDatabase::close() {
@@ -91,6 +106,14 @@ void SqliteDatabase::close() {
     sqlite3_close(db->db);
     db->db = nullptr;
   }
+  for (auto& reader : readers_) {
+    auto conn = reader->wlock();
+    conn->status = SqliteDbStatus::CLOSED;
+    if (conn->db) {
+      sqlite3_close(conn->db);
+      conn->db = nullptr;
+    }
+  }
 }
 
 SqliteDatabase::~SqliteDatabase() {
@@ -115,6 +138,67 @@ LockedSqliteConnection SqliteDatabase::lock() {
   return db;
 }
 
+bool SqliteDatabase::openReaderConnection(LockedSqliteConnection& conn) {
+  switch (conn->status) {
+    case SqliteDbStatus::OPEN:
+      return true;
+    case SqliteDbStatus::CLOSED:
+      throw std::runtime_error(
+          "the SqliteDatabase database has already been closed");
+    case SqliteDbStatus::NOT_YET_OPENED:
+    case SqliteDbStatus::FAILED_TO_OPEN:
+      // A previous failure is retried: the database file may simply not have
+      // existed yet the last time we tried.
+      break;
+  }
+
+  sqlite3* db = nullptr;
+  auto result =
+      sqlite3_open_v2(dbPath_.c_str(), &db, SQLITE_OPEN_READONLY, nullptr);
+  if (result != SQLITE_OK) {
+    conn->status = SqliteDbStatus::FAILED_TO_OPEN;
+    XLOG(DBG4) << "unable to open read-only connection to " << dbPath_ << ": "
+               << sqlite3_errstr(result);
+    // sqlite3_close handles nullptr fine
+    // @lint-ignore CLANGTIDY
+    sqlite3_close(db);
+    return false;
+  }
+  conn->db = db;
+  conn->status = SqliteDbStatus::OPEN;
+  return true;
+}
+
+LockedSqliteConnection SqliteDatabase::lockRead() {
+  if (readers_.empty()) {
+    return lock();
+  }
+
+  // Start at a per-thread slot so concurrent readers spread across the pool,
+  // then try-lock forward to find an idle connection.
+  auto start =
+      std::hash<std::thread::id>{}(std::this_thread::get_id()) %
+      readers_.size();
+  for (size_t i = 0; i < readers_.size(); i++) {
+    auto conn = readers_[(start + i) % readers_.size()]->tryWLock();
+    if (conn) {
+      if (openReaderConnection(conn)) {
+        return conn;
+      }
+      // Fall back to the main connection when no read-only connection can
+      // be opened.
+      return lock();
+    }
+  }
+
+  // Every reader connection is busy; wait for this thread's slot.
+  auto conn = readers_[start]->wlock();
+  if (openReaderConnection(conn)) {
+    return conn;
+  }
+  return lock();
+}
+
 void SqliteDatabase::transaction(
     const std::function<void(LockedSqliteConnection&)>& func) {
   auto conn = lock();
@@ -129,6 +213,42 @@ void SqliteDatabase::transaction(
   }
 }
 
+void SqliteDatabase::writeBatch(
+    folly::StringPiece query,
+    size_t numRows,
+    const std::function<void(SqliteStatement&, size_t)>& bind) {
+  auto conn = lock();
+  SqliteStatement stmt{conn, query};
+  try {
+    cache_->beginTransaction.get(conn)->step();
+    for (size_t row = 0; row < numRows; ++row) {
+      bind(stmt, row);
+      stmt.step();
+      stmt.reset();
+    }
+    cache_->commitTransaction.get(conn)->step();
+  } catch (const std::exception& ex) {
+    cache_->rollbackTransaction.get(conn)->step();
+    XLOG(WARN) << "SQLite write batch failed: " << ex.what();
+    throw;
+  }
+}
+
+void SqliteDatabase::beginTransaction() {
+  auto conn = lock();
+  cache_->beginTransaction.get(conn)->step();
+}
+
+void SqliteDatabase::commitTransaction() {
+  auto conn = lock();
+  cache_->commitTransaction.get(conn)->step();
+}
+
+void SqliteDatabase::rollbackTransaction() {
+  auto conn = lock();
+  cache_->rollbackTransaction.get(conn)->step();
+}
+
 void SqliteDatabase::checkpoint() {
   if (auto conn = db_.tryWLock()) {
     XLOG(DBG6) << "Checkpoint thread acquired SQLite lock";
@@ -14,6 +14,8 @@
 #include "eden/fs/utils/PathFuncs.h"
 
 namespace facebook::eden {
+class SqliteStatement;
+
 // Given a sqlite result code, if the result was not successful
 // (SQLITE_OK), format an error message and throw an exception.
 void checkSqliteResult(sqlite3* db, int result);
@@ -70,6 +72,22 @@ class SqliteDatabase {
    * to the SqliteStatement class. */
   LockedSqliteConnection lock();
 
+  /**
+   * Obtain a locked connection for read-only queries.
+   *
+   * On-disk databases keep a small pool of read-only connections in addition
+   * to the main read-write connection, so with WAL enabled readers can
+   * proceed concurrently with each other and with writes made through
+   * `lock`. Reader connections only see committed data: do not use this for
+   * queries that must observe writes made inside a transaction that has not
+   * committed yet.
+   *
+   * In-memory databases cannot share state across connections, so this
+   * falls back to `lock` for them (as it does when a read-only connection
+   * cannot be opened).
+   */
+  LockedSqliteConnection lockRead();
+
   /**
    * Executes a SQLite transaction. If the lambda body throws any error, the
    * transaction will be rolled back. This function returns a boolean to
@@ -86,17 +104,71 @@ class SqliteDatabase {
    */
   void transaction(const std::function<void(LockedSqliteConnection&)>& func);
 
+  /**
+   * Execute a prepared write statement once per row of a batch, inside one
+   * transaction and under a single connection lock acquisition.
+   *
+   * The query is prepared once. For each row index in [0, numRows), the bind
+   * callback is invoked to bind that row's parameters, after which the
+   * statement is stepped and reset. If binding or stepping any row throws,
+   * the whole transaction is rolled back and the exception is rethrown.
+   *
+   * This is cheaper than issuing the rows through individual `lock`
+   * acquisitions: the connection mutex is taken once, the statement is
+   * prepared once, and all rows commit as a single WAL append.
+   */
+  void writeBatch(
+      folly::StringPiece query,
+      size_t numRows,
+      const std::function<void(SqliteStatement&, size_t)>& bind);
+
+  /**
+   * Begin a transaction without holding the connection lock for its duration.
+   *
+   * Unlike `transaction`, this only briefly acquires the connection lock to
+   * issue BEGIN and then releases it. Since SQLite transactions are a
+   * property of the connection, statements run through separate `lock`
+   * acquisitions afterwards become part of the transaction. The caller is
+   * responsible for eventually calling `commitTransaction` or
+   * `rollbackTransaction`.
+   */
+  void beginTransaction();
+
+  /** Commit a transaction started with `beginTransaction`. */
+  void commitTransaction();
+
+  /** Roll back a transaction started with `beginTransaction`. */
+  void rollbackTransaction();
+
   void checkpoint();
 
  private:
   struct StatementCache;
 
+  /** The number of read-only connections kept for lockRead(). */
+  constexpr static size_t kNumReaderConnections = 4;
+
   explicit SqliteDatabase(std::string address);
 
+  /**
+   * Ensure the given reader slot holds an open read-only connection,
+   * opening one if necessary. Returns false if the connection could not be
+   * opened (the caller should fall back to the main connection).
+   */
+  bool openReaderConnection(LockedSqliteConnection& conn);
+
   std::string dbPath_;
 
   folly::Synchronized<SqliteConnection> db_;
 
+  /**
+   * Read-only connections handed out by lockRead(). Empty for in-memory
+   * databases. Connections are opened lazily: the database file may not
+   * exist yet when openDb() runs, and many databases never see concurrent
+   * readers.
+   */
+  std::vector<std::unique_ptr<folly::Synchronized<SqliteConnection>>> readers_;
+
   std::unique_ptr<StatementCache> cache_;
 };
 } // namespace facebook::eden
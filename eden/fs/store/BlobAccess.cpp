@@ -9,6 +9,7 @@
 #include <folly/MapUtil.h>
 #include "eden/fs/model/Blob.h"
 #include "eden/fs/store/BlobCache.h"
+#include "eden/fs/store/BlobSpillStore.h"
 #include "eden/fs/store/IObjectStore.h"
 #include "eden/fs/utils/ImmediateFuture.h"
 
@@ -16,8 +17,11 @@ namespace facebook::eden {
 
 BlobAccess::BlobAccess(
     std::shared_ptr<IObjectStore> objectStore,
-    std::shared_ptr<BlobCache> blobCache)
-    : objectStore_{std::move(objectStore)}, blobCache_{std::move(blobCache)} {}
+    std::shared_ptr<BlobCache> blobCache,
+    std::shared_ptr<BlobSpillStore> spillStore)
+    : objectStore_{std::move(objectStore)},
+      blobCache_{std::move(blobCache)},
+      spillStore_{std::move(spillStore)} {}
 
 BlobAccess::~BlobAccess() {}
 
@@ -30,9 +34,59 @@ folly::Future<BlobCache::GetResult> BlobAccess::getBlob(
     return folly::Future<BlobCache::GetResult>{std::move(result)};
   }
 
-  return objectStore_->getBlob(hash, context)
-      .thenValue([blobCache = blobCache_,
-                  interest](std::shared_ptr<const Blob> blob) {
+  // Large blobs never enter the BlobCache; a previously spilled blob is
+  // served straight from its memory mapping.
+  if (spillStore_) {
+    if (auto blob = spillStore_->get(hash)) {
+      return folly::Future<BlobCache::GetResult>{
+          BlobCache::GetResult{std::move(blob), BlobInterestHandle{}}};
+    }
+  }
+
+  // Singleflight: only the first miss for a given blob issues the fetch;
+  // concurrent misses subscribe to its promise. The promise is fulfilled
+  // after the entry is erased, so a miss arriving later starts a new fetch
+  // rather than observing a stale entry.
+  folly::Future<std::shared_ptr<const Blob>> blobFuture =
+      folly::Future<std::shared_ptr<const Blob>>::makeEmpty();
+  bool fetchNeeded = false;
+  {
+    auto inflight = inflightFetches_->wlock();
+    auto [it, inserted] = inflight->try_emplace(hash);
+    fetchNeeded = inserted;
+    blobFuture = it->second.getFuture();
+  }
+
+  if (fetchNeeded) {
+    objectStore_->getBlob(hash, context)
+        .thenTry([inflightFetches = inflightFetches_,
+                  hash](folly::Try<std::shared_ptr<const Blob>> blob) {
+          auto promise = [&] {
+            auto inflight = inflightFetches->wlock();
+            auto it = inflight->find(hash);
+            auto promise = std::move(it->second);
+            inflight->erase(it);
+            return promise;
+          }();
+          // Fulfilled outside the lock: subscriber callbacks run inline and
+          // must not deadlock against a concurrent getBlob taking the lock.
+          promise.setTry(std::move(blob));
+        })
+        .semi()
+        .via(&folly::QueuedImmediateExecutor::instance());
+  }
+
+  return std::move(blobFuture)
+      .thenValue([blobCache = blobCache_, spillStore = spillStore_, interest](
+                     std::shared_ptr<const Blob> blob) {
+        if (spillStore && blob->getSize() >= spillStore->getThreshold()) {
+          if (auto spilled = spillStore->store(*blob)) {
+            // Drop the fetched copy and serve the mapped one so the blob's
+            // memory is backed by the page cache, not the edenfs heap.
+            return BlobCache::GetResult{
+                std::move(spilled), BlobInterestHandle{}};
+          }
+        }
         auto interestHandle = blobCache->insert(blob, interest);
         return BlobCache::GetResult{std::move(blob), std::move(interestHandle)};
       })
@@ -7,14 +7,18 @@
 
 #pragma once
 
+#include <folly/Synchronized.h>
 #include <folly/futures/Future.h>
+#include <folly/futures/SharedPromise.h>
 #include <memory>
+#include <unordered_map>
 #include "eden/fs/store/BlobCache.h"
 #include "eden/fs/store/ObjectFetchContext.h"
 
 namespace facebook::eden {
 
 class Blob;
+class BlobSpillStore;
 class IObjectStore;
 
 /**
@@ -38,10 +42,16 @@ class BlobAccess {
    * - recentBlobCacheLength specifies how many recently-accessed blobs should
    *   be kept around, even if they are larger than cacheSizeBytes. This is
    *   important to avoid reloading large files.
+   *
+   * If a spill store is given, blobs at or above its threshold bypass the
+   * BlobCache entirely: they are written once to the spill store and served
+   * from a read-only memory mapping of the spill file instead, so one huge
+   * artifact cannot evict the working set of small hot blobs.
    */
   BlobAccess(
       std::shared_ptr<IObjectStore> objectStore,
-      std::shared_ptr<BlobCache> blobCache);
+      std::shared_ptr<BlobCache> blobCache,
+      std::shared_ptr<BlobSpillStore> spillStore = nullptr);
   ~BlobAccess();
 
   /**
@@ -62,8 +72,26 @@ class BlobAccess {
   BlobAccess(const BlobAccess&) = delete;
   BlobAccess& operator=(const BlobAccess&) = delete;
 
+  /**
+   * Fetches currently in flight, keyed by blob id. The first cache miss for
+   * a blob starts the ObjectStore fetch and records a promise here; misses
+   * that arrive before it completes subscribe to the same promise instead of
+   * issuing duplicate fetch chains. Each subscriber still inserts into the
+   * BlobCache with its own interest, so interest-handle semantics are
+   * unchanged.
+   *
+   * Held by shared_ptr so the fetch completion callback can erase its entry
+   * even if this BlobAccess has been destroyed in the meantime.
+   */
+  using InflightFetchMap = folly::Synchronized<std::unordered_map<
+      ObjectId,
+      folly::SharedPromise<std::shared_ptr<const Blob>>>>;
+
   const std::shared_ptr<IObjectStore> objectStore_;
   const std::shared_ptr<BlobCache> blobCache_;
+  const std::shared_ptr<BlobSpillStore> spillStore_;
+  const std::shared_ptr<InflightFetchMap> inflightFetches_{
+      std::make_shared<InflightFetchMap>()};
 };
 
 } // namespace facebook::eden
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/BlobCache.h"
+
+#include <folly/compression/Compression.h>
+#include <folly/logging/xlog.h>
+
+namespace facebook::eden {
+
+void BlobCache::onEvictedItem(const ObjectPtr& blob) noexcept {
+  if (compressedTierMaximumSizeBytes_ == 0) {
+    return;
+  }
+
+  // This runs under the shard lock of the primary cache, so keep the work
+  // bounded: one compression pass and a tier insertion. Compression may
+  // allocate and thus throw; an eviction must never propagate an exception,
+  // so on failure the blob is simply dropped as before.
+  try {
+    auto codec = folly::io::getCodec(folly::io::CodecType::ZSTD);
+    auto compressed = codec->compress(&blob->getContents());
+    auto compressedSize = compressed->computeChainDataLength();
+    if (compressedSize >= blob->getSizeBytes()) {
+      // Incompressible content isn't worth keeping a second copy of.
+      return;
+    }
+
+    auto tier = compressedTier_.wlock();
+    auto [iter, inserted] = tier->index.try_emplace(blob->getHash());
+    if (!inserted) {
+      return;
+    }
+    tier->evictionQueue.push_back(CompressedBlob{
+        blob->getHash(), std::move(compressed), blob->getSizeBytes()});
+    iter->second = std::prev(tier->evictionQueue.end());
+    tier->totalSize += compressedSize;
+
+    while (tier->totalSize > compressedTierMaximumSizeBytes_) {
+      auto& front = tier->evictionQueue.front();
+      tier->totalSize -= front.compressed->computeChainDataLength();
+      tier->index.erase(front.hash);
+      tier->evictionQueue.pop_front();
+    }
+  } catch (const std::exception& ex) {
+    XLOG(DBG4) << "unable to move blob " << blob->getHash()
+               << " into the compressed tier: " << ex.what();
+  }
+}
+
+BlobCache::ObjectPtr BlobCache::getFromCompressedTier(const ObjectId& hash) {
+  std::unique_ptr<folly::IOBuf> compressed;
+  size_t uncompressedSize;
+  {
+    auto tier = compressedTier_.wlock();
+    auto iter = tier->index.find(hash);
+    if (iter == tier->index.end()) {
+      return nullptr;
+    }
+    // The blob is about to be promoted back into the uncompressed cache, so
+    // remove it from the tier rather than keeping two copies alive.
+    compressed = std::move(iter->second->compressed);
+    uncompressedSize = iter->second->uncompressedSize;
+    tier->totalSize -= compressed->computeChainDataLength();
+    tier->evictionQueue.erase(iter->second);
+    tier->index.erase(iter);
+  }
+
+  auto codec = folly::io::getCodec(folly::io::CodecType::ZSTD);
+  auto contents = codec->uncompress(compressed.get(), uncompressedSize);
+  return std::make_shared<const Blob>(hash, std::move(*contents));
+}
+
+} // namespace facebook::eden
@@ -6,6 +6,9 @@
  */
 
 #pragma once
+#include <folly/container/F14Map.h>
+#include <list>
+
 #include "eden/fs/model/Blob.h"
 #include "eden/fs/store/ObjectCache.h"
 
@@ -29,13 +32,15 @@ class BlobCache : public ObjectCache<Blob, ObjectCacheFlavor::InterestHandle> {
  public:
   static std::shared_ptr<BlobCache> create(
       size_t maximumCacheSizeBytes,
-      size_t minimumEntryCount) {
+      size_t minimumEntryCount,
+      size_t compressedTierMaximumSizeBytes = 0) {
     struct BC : BlobCache {
-      BC(size_t x, size_t y) : BlobCache{x, y} {}
+      BC(size_t x, size_t y, size_t z) : BlobCache{x, y, z} {}
     };
-    return std::make_shared<BC>(maximumCacheSizeBytes, minimumEntryCount);
+    return std::make_shared<BC>(
+        maximumCacheSizeBytes, minimumEntryCount, compressedTierMaximumSizeBytes);
   }
-  ~BlobCache() = default;
+  ~BlobCache() override = default;
 
   /**
    * If a blob for the given hash is in cache, return it. If the blob is not in
@@ -52,7 +57,18 @@ class BlobCache : public ObjectCache<Blob, ObjectCacheFlavor::InterestHandle> {
   GetResult get(
       const ObjectId& hash,
       Interest interest = Interest::LikelyNeededAgain) {
-    return getInterestHandle(hash, interest);
+    auto result = getInterestHandle(hash, interest);
+    if (result.object || compressedTierMaximumSizeBytes_ == 0) {
+      return result;
+    }
+    // Second chance: the blob may have been evicted into the compressed
+    // tier. Decompressing is orders of magnitude cheaper than re-fetching
+    // from RocksDB or the backing store.
+    if (auto blob = getFromCompressedTier(hash)) {
+      auto interestHandle = insertInterestHandle(blob, interest);
+      return GetResult{std::move(blob), std::move(interestHandle)};
+    }
+    return result;
   }
 
   /**
@@ -70,10 +86,43 @@ class BlobCache : public ObjectCache<Blob, ObjectCacheFlavor::InterestHandle> {
   }
 
  private:
-  explicit BlobCache(size_t maximumCacheSizeBytes, size_t minimumEntryCount)
-      : ObjectCache<Blob, ObjectCacheFlavor::InterestHandle>{
-            maximumCacheSizeBytes,
-            minimumEntryCount} {}
+  explicit BlobCache(
+      size_t maximumCacheSizeBytes,
+      size_t minimumEntryCount,
+      size_t compressedTierMaximumSizeBytes)
+      : ObjectCache<Blob, ObjectCacheFlavor::InterestHandle>{maximumCacheSizeBytes, minimumEntryCount},
+        compressedTierMaximumSizeBytes_{compressedTierMaximumSizeBytes} {}
+
+  /**
+   * Evicted blobs get zstd-compressed and stashed in the compressed tier
+   * instead of being dropped outright, so hot-but-large files survive memory
+   * pressure. The tier has its own byte budget and LRU order; since blobs
+   * are content-addressed, entries never need invalidation.
+   */
+  void onEvictedItem(const ObjectPtr& blob) noexcept override;
+
+  /**
+   * If a compressed copy of the blob is present, remove it from the tier,
+   * decompress it and return the reconstructed blob. Returns nullptr
+   * otherwise.
+   */
+  ObjectPtr getFromCompressedTier(const ObjectId& hash);
+
+  struct CompressedBlob {
+    ObjectId hash;
+    std::unique_ptr<folly::IOBuf> compressed;
+    size_t uncompressedSize;
+  };
+
+  struct CompressedTierState {
+    size_t totalSize{0};
+    /// Entries are evicted from the front of the list.
+    std::list<CompressedBlob> evictionQueue;
+    folly::F14FastMap<ObjectId, std::list<CompressedBlob>::iterator> index;
+  };
+
+  const size_t compressedTierMaximumSizeBytes_;
+  folly::Synchronized<CompressedTierState> compressedTier_;
 };
 
 } // namespace facebook::eden
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/BlobChunking.h"
+
+#include <folly/Conv.h>
+#include <folly/io/Cursor.h>
+#include <folly/logging/xlog.h>
+#include <array>
+#include <cstring>
+
+namespace facebook::eden {
+
+namespace {
+
+constexpr folly::StringPiece kManifestPrefix{"chunks "};
+
+/*
+ * Masks for the FastCDC boundary test, applied to the high bits of the gear
+ * fingerprint since the `(fp << 1) + gear` update pushes entropy upward.
+ * Before the average size we require more matching bits (cutting less often)
+ * and after it fewer, which normalizes the chunk size distribution around
+ * kAvgBlobChunkSize (2^20): 22 high bits before, 18 after.
+ */
+constexpr uint64_t kMaskStrict = 0xFFFF'FFC0'0000'0000ULL;
+constexpr uint64_t kMaskRelaxed = 0xFFFF'C000'0000'0000ULL;
+
+/**
+ * Per-byte random values for the gear hash, generated with SplitMix64 from a
+ * fixed seed. These constants determine where chunk boundaries fall and are
+ * baked into on-disk data; they must never change.
+ */
+std::array<uint64_t, 256> buildGearTable() {
+  std::array<uint64_t, 256> table;
+  uint64_t state = 0x7b909f125d461f21ULL;
+  for (auto& value : table) {
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    value = z ^ (z >> 31);
+  }
+  return table;
+}
+
+/**
+ * Return the length of the first chunk of `data`.
+ */
+size_t findChunkBoundary(folly::ByteRange data) {
+  static const std::array<uint64_t, 256> kGearTable = buildGearTable();
+
+  if (data.size() <= kMinBlobChunkSize) {
+    return data.size();
+  }
+  size_t normalEnd = std::min(data.size(), kAvgBlobChunkSize);
+  size_t end = std::min(data.size(), kMaxBlobChunkSize);
+
+  // Skipping the first kMinBlobChunkSize bytes both enforces the minimum and
+  // skips fingerprinting bytes that cannot produce a boundary.
+  uint64_t fp = 0;
+  size_t idx = kMinBlobChunkSize;
+  for (; idx < normalEnd; ++idx) {
+    fp = (fp << 1) + kGearTable[data[idx]];
+    if ((fp & kMaskStrict) == 0) {
+      return idx + 1;
+    }
+  }
+  for (; idx < end; ++idx) {
+    fp = (fp << 1) + kGearTable[data[idx]];
+    if ((fp & kMaskRelaxed) == 0) {
+      return idx + 1;
+    }
+  }
+  return end;
+}
+
+} // namespace
+
+std::vector<folly::ByteRange> chunkBlob(folly::ByteRange data) {
+  std::vector<folly::ByteRange> chunks;
+  chunks.reserve(data.size() / kAvgBlobChunkSize + 1);
+  while (!data.empty()) {
+    auto length = findChunkBoundary(data);
+    chunks.push_back(data.subpiece(0, length));
+    data.advance(length);
+  }
+  return chunks;
+}
+
+folly::IOBuf serializeChunkedBlobManifest(
+    uint64_t blobSize,
+    const std::vector<Hash20>& chunks) {
+  auto prefix = folly::to<std::string>(kManifestPrefix, blobSize);
+  prefix.push_back('\0');
+
+  XCHECK_LE(chunks.size(), std::numeric_limits<uint32_t>::max());
+  size_t serializedSize = prefix.size() + sizeof(uint32_t) +
+      Hash20::RAW_SIZE * chunks.size();
+
+  folly::IOBuf buf(folly::IOBuf::CREATE, serializedSize);
+  folly::io::Appender appender(&buf, 0);
+  appender.push(folly::StringPiece{prefix});
+  appender.write<uint32_t>(static_cast<uint32_t>(chunks.size()));
+  for (const auto& chunk : chunks) {
+    appender.push(chunk.getBytes());
+  }
+  return buf;
+}
+
+std::optional<ChunkedBlobManifest> parseChunkedBlobManifest(
+    folly::ByteRange data) {
+  folly::StringPiece piece{data};
+  if (!piece.startsWith(kManifestPrefix)) {
+    return std::nullopt;
+  }
+  piece.advance(kManifestPrefix.size());
+
+  auto nulIdx = piece.find('\0');
+  if (nulIdx == std::string::npos) {
+    return std::nullopt;
+  }
+  auto sizeStr = piece.subpiece(0, nulIdx);
+  auto blobSize = folly::tryTo<uint64_t>(sizeStr);
+  if (!blobSize.hasValue()) {
+    return std::nullopt;
+  }
+  piece.advance(nulIdx + 1);
+
+  if (piece.size() < sizeof(uint32_t)) {
+    XLOG(ERR) << "Corrupted chunked blob manifest, missing chunk count";
+    return std::nullopt;
+  }
+  uint32_t numChunks;
+  memcpy(&numChunks, piece.data(), sizeof(uint32_t));
+  piece.advance(sizeof(uint32_t));
+
+  if (piece.size() != Hash20::RAW_SIZE * size_t{numChunks}) {
+    XLOG(ERR) << "Corrupted chunked blob manifest, expected " << numChunks
+              << " chunk hashes in " << piece.size() << " bytes";
+    return std::nullopt;
+  }
+
+  ChunkedBlobManifest manifest;
+  manifest.blobSize = blobSize.value();
+  manifest.chunks.reserve(numChunks);
+  for (uint32_t i = 0; i < numChunks; ++i) {
+    manifest.chunks.emplace_back(folly::ByteRange{
+        reinterpret_cast<const uint8_t*>(piece.data()), Hash20::RAW_SIZE});
+    piece.advance(Hash20::RAW_SIZE);
+  }
+  return manifest;
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/io/IOBuf.h>
+#include <optional>
+#include <vector>
+#include "eden/fs/model/Hash.h"
+
+namespace facebook::eden {
+
+/*
+ * Content-defined chunking for large blobs stored in the LocalStore.
+ *
+ * Large generated artifacts tend to change only slightly between commits.
+ * Splitting them at content-defined boundaries (FastCDC-style gear hash)
+ * means an insertion or edit only shifts the boundaries near the change, so
+ * most chunks of the new version hash identically to chunks of the old one
+ * and are shared in the chunk key space instead of stored again.
+ */
+
+/** Chunks are never smaller than this, except for the final chunk. */
+constexpr size_t kMinBlobChunkSize = 512 * 1024;
+
+/** Target average chunk size. */
+constexpr size_t kAvgBlobChunkSize = 1024 * 1024;
+
+/** Chunks are cut here even if no content boundary was found. */
+constexpr size_t kMaxBlobChunkSize = 2 * 1024 * 1024;
+
+/**
+ * Split blob contents at content-defined boundaries.
+ *
+ * The returned ranges point into `data`, cover it exactly, and each is
+ * between kMinBlobChunkSize and kMaxBlobChunkSize bytes except possibly the
+ * last. Chunking is deterministic: the same bytes always produce the same
+ * boundaries, which on-disk dedup relies on.
+ */
+std::vector<folly::ByteRange> chunkBlob(folly::ByteRange data);
+
+/**
+ * The parsed form of a chunked blob manifest stored in the blob key space.
+ */
+struct ChunkedBlobManifest {
+  /** Total size of the reconstructed blob, for integrity checking. */
+  uint64_t blobSize = 0;
+
+  /** SHA-1 keys of the chunks in the blob chunk key space, in order. */
+  std::vector<Hash20> chunks;
+};
+
+/**
+ * Serialize a chunk list into the manifest bytes stored under the blob's ID.
+ *
+ * The manifest starts with "chunks <size>\0", which cannot collide with the
+ * "blob <size>\0" prefix of git-style blob data in the same key space.
+ */
+folly::IOBuf serializeChunkedBlobManifest(
+    uint64_t blobSize,
+    const std::vector<Hash20>& chunks);
+
+/**
+ * Parse manifest bytes previously produced by serializeChunkedBlobManifest.
+ *
+ * Returns std::nullopt if the data does not carry the manifest prefix (i.e.
+ * it is an ordinary serialized blob) or is truncated.
+ */
+std::optional<ChunkedBlobManifest> parseChunkedBlobManifest(
+    folly::ByteRange data);
+
+} // namespace facebook::eden
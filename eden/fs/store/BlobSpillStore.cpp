@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/BlobSpillStore.h"
+
+#include <cerrno>
+#include <vector>
+
+#include <folly/File.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/io/IOBuf.h>
+#include <folly/logging/xlog.h>
+#include <folly/system/MemoryMapping.h>
+
+#include "eden/fs/model/Blob.h"
+
+namespace facebook::eden {
+
+namespace {
+
+void releaseMapping(void* /*buf*/, void* userData) {
+  delete static_cast<std::shared_ptr<folly::MemoryMapping>*>(userData);
+}
+
+} // namespace
+
+BlobSpillStore::BlobSpillStore(AbsolutePathPiece dir, size_t thresholdBytes)
+    : dir_{dir.copy()}, thresholdBytes_{thresholdBytes} {
+  ensureDirectoryExists(dir_);
+}
+
+AbsolutePath BlobSpillStore::spillPath(const ObjectId& hash) const {
+  return dir_ + PathComponent{hash.asHexString()};
+}
+
+std::shared_ptr<const Blob> BlobSpillStore::get(const ObjectId& hash) {
+  return mapBlob(hash);
+}
+
+std::shared_ptr<const Blob> BlobSpillStore::store(const Blob& blob) {
+  // Another thread or a previous run may have spilled this blob already.
+  // Spill files are written atomically, so an existing file is complete and
+  // its contents match the object id.
+  if (auto mapped = mapBlob(blob.getHash())) {
+    return mapped;
+  }
+
+  std::vector<iovec> iov;
+  for (auto range : blob.getContents()) {
+    iov.push_back(
+        {const_cast<uint8_t*>(range.data()), static_cast<size_t>(range.size())});
+  }
+  auto path = spillPath(blob.getHash());
+  if (auto err = folly::writeFileAtomicNoThrow(
+          path.view(), iov.data(), static_cast<int>(iov.size()))) {
+    XLOG(WARN) << "unable to write blob spill file " << path << ": "
+               << folly::errnoStr(err);
+    return nullptr;
+  }
+
+  return mapBlob(blob.getHash());
+}
+
+std::shared_ptr<const Blob> BlobSpillStore::mapBlob(const ObjectId& hash) {
+  auto path = spillPath(hash);
+  try {
+    folly::File file{path.c_str()};
+    auto mapping =
+        std::make_shared<folly::MemoryMapping>(std::move(file), 0, -1);
+    // Large artifacts are typically read front to back: keep the kernel's
+    // readahead aggressive so sequential reads stream from disk.
+    mapping->hintLinearScan();
+    auto range = mapping->range();
+
+    // Wrap the mapped bytes directly rather than copying them; the blob
+    // holds a reference to the mapping so it stays alive until the last
+    // reader releases the contents.
+    auto contents = folly::IOBuf::takeOwnership(
+        const_cast<uint8_t*>(range.data()),
+        range.size(),
+        releaseMapping,
+        new std::shared_ptr<folly::MemoryMapping>(mapping));
+    return std::make_shared<const Blob>(hash, std::move(*contents));
+  } catch (const std::system_error& ex) {
+    if (ex.code().value() != ENOENT) {
+      XLOG(WARN) << "unable to map blob spill file " << path << ": "
+                 << ex.what();
+    }
+    return nullptr;
+  } catch (const std::exception& ex) {
+    XLOG(WARN) << "unable to map blob spill file " << path << ": "
+               << ex.what();
+    return nullptr;
+  }
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "eden/fs/model/ObjectId.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+namespace facebook::eden {
+
+class Blob;
+
+/**
+ * An on-disk spill store for blobs too large to sensibly live in BlobCache.
+ *
+ * A multi-gigabyte artifact read through FileInode::read either pins a huge
+ * allocation in BlobCache -- evicting the working set of small hot blobs --
+ * or is refetched from the backing store on every cache miss. Instead, blobs
+ * at or above the configured threshold are written once to a file in the
+ * spill directory and served from a read-only memory mapping of that file.
+ * The kernel's page cache then decides how much of the blob stays resident,
+ * and BlobCache accounting is bypassed entirely.
+ *
+ * Spill files are keyed by object id, so they are content-addressed and can
+ * be reused across edenfs restarts. Returned blobs keep their mapping alive
+ * for as long as any reader holds a reference to the blob's contents.
+ */
+class BlobSpillStore {
+ public:
+  /**
+   * Create a spill store rooted at the given directory, which is created if
+   * it does not already exist. Blobs of at least thresholdBytes belong in
+   * the spill store; smaller blobs should go through BlobCache as usual.
+   */
+  BlobSpillStore(AbsolutePathPiece dir, size_t thresholdBytes);
+
+  BlobSpillStore(const BlobSpillStore&) = delete;
+  BlobSpillStore& operator=(const BlobSpillStore&) = delete;
+
+  size_t getThreshold() const {
+    return thresholdBytes_;
+  }
+
+  /**
+   * If a spill file for the given id exists, return a blob backed by a
+   * memory mapping of it, else nullptr.
+   */
+  std::shared_ptr<const Blob> get(const ObjectId& hash);
+
+  /**
+   * Write the blob's contents to a spill file (unless one already exists)
+   * and return a blob backed by a memory mapping of that file.
+   *
+   * Returns nullptr if the spill file cannot be written or mapped; the
+   * caller should fall back to serving the in-memory blob.
+   */
+  std::shared_ptr<const Blob> store(const Blob& blob);
+
+ private:
+  AbsolutePath spillPath(const ObjectId& hash) const;
+
+  /**
+   * Map the spill file for the given id and wrap it in a Blob. Returns
+   * nullptr if the file cannot be opened or mapped.
+   */
+  std::shared_ptr<const Blob> mapBlob(const ObjectId& hash);
+
+  const AbsolutePath dir_;
+  const size_t thresholdBytes_;
+};
+
+} // namespace facebook::eden
@@ -8,6 +8,7 @@
 #include "eden/fs/store/Diff.h"
 
 #include <folly/Portability.h>
+#include <folly/ScopeGuard.h>
 #include <folly/Synchronized.h>
 #include <folly/logging/xlog.h>
 #include <memory>
@@ -331,9 +332,13 @@ FOLLY_NODISCARD ImmediateFuture<Unit> computeTreeDiff(
 }
 
 /**
- * Load the content of the .gitignore file and return it.
+ * Load and parse the .gitignore file for a directory.
+ *
+ * Parsed files are cached across diff operations keyed by blob id, so a
+ * repeated status only pays the blob fetch and parse for ignore files it
+ * hasn't seen before.
  */
-ImmediateFuture<std::string> loadGitIgnore(
+ImmediateFuture<GitIgnore> loadGitIgnore(
     DiffContext* context,
     const TreeEntry& treeEntry,
     RelativePath gitIgnorePath) {
@@ -342,12 +347,15 @@ ImmediateFuture<std::string> loadGitIgnore(
       type != TreeEntryType::EXECUTABLE_FILE) {
     XLOG(WARN) << "error loading gitignore at " << gitIgnorePath
                << ": not a regular file";
-    return std::string{};
+    return GitIgnore{};
   } else {
     const auto& hash = treeEntry.getHash();
+    if (auto cached = DiffContext::getCachedGitIgnore(hash)) {
+      return *cached;
+    }
     return context->store->getBlob(hash, context->getFetchContext())
-        .thenTry([entryPath = std::move(gitIgnorePath)](
-                     folly::Try<std::shared_ptr<const Blob>> blobTry) {
+        .thenTry([entryPath = std::move(gitIgnorePath),
+                  hash](folly::Try<std::shared_ptr<const Blob>> blobTry) {
           if (blobTry.hasException()) {
             // TODO: add an API to DiffCallback to report user
             // errors like this (errors that do not indicate a
@@ -356,11 +364,16 @@ ImmediateFuture<std::string> loadGitIgnore(
             XLOG(WARN) << "error loading gitignore at " << entryPath << ": "
                        << folly::exceptionStr(blobTry.exception());
 
-            return std::string{};
+            return GitIgnore{};
           }
           const auto& contentsBuf = blobTry.value()->getContents();
           folly::io::Cursor cursor(&contentsBuf);
-          return cursor.readFixedString(contentsBuf.computeChainDataLength());
+          auto contents =
+              cursor.readFixedString(contentsBuf.computeChainDataLength());
+          auto ignore = std::make_shared<GitIgnore>();
+          ignore->loadFile(contents);
+          DiffContext::putCachedGitIgnore(hash, ignore);
+          return GitIgnore{*ignore};
         });
   }
 }
@@ -396,7 +409,7 @@ FOLLY_NODISCARD ImmediateFuture<Unit> diffTrees(
         isIgnored);
   }
 
-  ImmediateFuture<std::string> gitIgnore{};
+  ImmediateFuture<GitIgnore> gitIgnore{};
   if (wdTree) {
     // If this directory has a .gitignore file, load it first.
     const auto it = wdTree->find(kIgnoreFilename);
@@ -411,9 +424,9 @@ FOLLY_NODISCARD ImmediateFuture<Unit> diffTrees(
        scmTree = std::move(scmTree),
        wdTree = std::move(wdTree),
        parentIgnore,
-       isIgnored](std::string gitIgnore) mutable {
-        auto gitIgnoreStack =
-            std::make_unique<GitIgnoreStack>(parentIgnore, gitIgnore);
+       isIgnored](GitIgnore gitIgnore) mutable {
+        auto gitIgnoreStack = std::make_unique<GitIgnoreStack>(
+            parentIgnore, std::move(gitIgnore));
         return computeTreeDiff(
             context,
             currentPath,
@@ -433,21 +446,43 @@ FOLLY_NODISCARD ImmediateFuture<Unit> diffTrees(
     bool isIgnored) {
   auto treesFuture = collectAllSafe(std::move(scmFuture), std::move(wdFuture));
 
+  // When the context has an executor, walk this subtree on it instead of
+  // inline on whichever thread completed the tree fetches. Without this the
+  // entire CPU-bound portion of the diff (ignore matching, entry comparison)
+  // funnels through the backing store's completion threads, effectively
+  // serializing the walk no matter how many cores are idle. The slot claim
+  // bounds how many walks one diff may have outstanding on the executor; at
+  // the cap we fall back to the old inline behavior rather than queueing.
+  bool offloaded = false;
+  if (context->executor != nullptr && !treesFuture.isReady() &&
+      context->tryClaimWalkSlot()) {
+    offloaded = true;
+    treesFuture = std::move(treesFuture).semi().via(context->executor).semi();
+  }
+
   // Optimization for the case when the trees are immediately ready. We can
   // avoid copying the input path in this case.
   auto copiedCurrentPath =
       !treesFuture.isReady() ? std::optional{currentPath.copy()} : std::nullopt;
   return std::move(treesFuture)
-      .thenValue(
+      .thenTry(
           [context,
            copiedCurrentPath = std::move(copiedCurrentPath),
            currentPath,
            ignore,
-           isIgnored](std::tuple<
-                      std::shared_ptr<const Tree>,
-                      std::shared_ptr<const Tree>> tup)
+           isIgnored,
+           offloaded](folly::Try<std::tuple<
+                          std::shared_ptr<const Tree>,
+                          std::shared_ptr<const Tree>>> tryTup)
               -> ImmediateFuture<folly::Unit> {
-            auto [scmTree, wdTree] = std::move(tup);
+            // The slot only covers fanning out this directory's walk; the
+            // children schedule (or claim their own slots for) the rest.
+            SCOPE_EXIT {
+              if (offloaded) {
+                context->releaseWalkSlot();
+              }
+            };
+            auto [scmTree, wdTree] = std::move(tryTup).value();
 
             // Shortcut in the case where we're trying to diff the same tree.
             // This happens in the case in which the CLI (during eden doctor)
@@ -7,25 +7,56 @@
 
 #include "eden/fs/store/DiffContext.h"
 
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+
+#include "eden/fs/model/ObjectId.h"
 #include "eden/fs/model/git/GitIgnoreStack.h"
 #include "eden/fs/model/git/TopLevelIgnores.h"
 #include "eden/fs/store/IObjectStore.h"
 
 namespace facebook::eden {
 
+namespace {
+
+/**
+ * How many parsed .gitignore files to retain across diff operations. Few
+ * directories carry an ignore file, so even a modest limit covers every
+ * ignore file in a large repository.
+ */
+constexpr size_t kParsedGitIgnoreCacheSize = 2048;
+
+using ParsedGitIgnoreCache =
+    folly::EvictingCacheMap<ObjectId, std::shared_ptr<const GitIgnore>>;
+
+folly::Synchronized<ParsedGitIgnoreCache>& parsedGitIgnoreCache() {
+  static folly::Synchronized<ParsedGitIgnoreCache> cache{
+      ParsedGitIgnoreCache{kParsedGitIgnoreCacheSize}};
+  return cache;
+}
+
+} // namespace
+
 DiffContext::DiffContext(
     DiffCallback* cb,
     folly::CancellationToken cancellation,
     bool listIgnored,
     CaseSensitivity caseSensitive,
     const ObjectStore* os,
-    std::unique_ptr<TopLevelIgnores> topLevelIgnores)
+    std::unique_ptr<TopLevelIgnores> topLevelIgnores,
+    folly::Executor* executor,
+    uint64_t walkParallelism,
+    ImportPriority fetchPriority)
     : callback{cb},
       store{os},
       listIgnored{listIgnored},
+      executor{executor},
       topLevelIgnores_(std::move(topLevelIgnores)),
       cancellation_{std::move(cancellation)},
-      caseSensitive_{caseSensitive} {}
+      walkParallelism_{walkParallelism},
+      caseSensitive_{caseSensitive} {
+  statsContext_->setFetchPriority(fetchPriority);
+}
 
 DiffContext::~DiffContext() = default;
 
@@ -37,4 +68,40 @@ bool DiffContext::isCancelled() const {
   return cancellation_.isCancellationRequested();
 }
 
+bool DiffContext::tryClaimWalkSlot() {
+  if (walkParallelism_ == 0) {
+    return true;
+  }
+  auto current = activeWalks_.load(std::memory_order_relaxed);
+  while (current < walkParallelism_) {
+    if (activeWalks_.compare_exchange_weak(
+            current, current + 1, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void DiffContext::releaseWalkSlot() {
+  if (walkParallelism_ != 0) {
+    activeWalks_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+std::shared_ptr<const GitIgnore> DiffContext::getCachedGitIgnore(
+    const ObjectId& blobId) {
+  auto cache = parsedGitIgnoreCache().wlock();
+  auto it = cache->find(blobId);
+  if (it == cache->end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+void DiffContext::putCachedGitIgnore(
+    const ObjectId& blobId,
+    std::shared_ptr<const GitIgnore> ignore) {
+  parsedGitIgnoreCache().wlock()->set(blobId, std::move(ignore));
+}
+
 } // namespace facebook::eden
@@ -8,8 +8,12 @@
 #pragma once
 
 #include <folly/CancellationToken.h>
+#include <folly/Executor.h>
 #include <folly/Range.h>
 
+#include <atomic>
+#include <memory>
+
 #include "eden/fs/store/StatsFetchContext.h"
 #include "eden/fs/utils/PathFuncs.h"
 
@@ -18,7 +22,9 @@ namespace facebook::eden {
 template <typename T>
 class ImmediateFuture;
 class DiffCallback;
+class GitIgnore;
 class GitIgnoreStack;
+class ObjectId;
 class ObjectStore;
 class UserInfo;
 class TopLevelIgnores;
@@ -41,7 +47,10 @@ class DiffContext {
       bool listIgnored,
       CaseSensitivity caseSensitive,
       const ObjectStore* os,
-      std::unique_ptr<TopLevelIgnores> topLevelIgnores);
+      std::unique_ptr<TopLevelIgnores> topLevelIgnores,
+      folly::Executor* executor = nullptr,
+      uint64_t walkParallelism = 0,
+      ImportPriority fetchPriority = kDefaultImportPriority);
 
   DiffContext(const DiffContext&) = delete;
   DiffContext& operator=(const DiffContext&) = delete;
@@ -59,9 +68,42 @@ class DiffContext {
    */
   bool const listIgnored;
 
+  /**
+   * Executor for the CPU-bound portion of the diff. When null the tree walk
+   * runs inline on whichever thread completed the tree fetches.
+   */
+  folly::Executor* const executor;
+
   const GitIgnoreStack* getToplevelIgnore() const;
   bool isCancelled() const;
 
+  /**
+   * Try to claim a slot for offloading a subtree walk to the executor.
+   *
+   * Returns false once walkParallelism walks are already queued or running,
+   * in which case the caller should walk the subtree inline. Callers that
+   * claimed a slot must release it with releaseWalkSlot().
+   */
+  bool tryClaimWalkSlot();
+  void releaseWalkSlot();
+
+  /**
+   * Look up a previously parsed .gitignore file in the process-wide cache.
+   *
+   * The cache is keyed by the source blob id, and blob contents are
+   * immutable, so entries never go stale; they only age out. Returns nullptr
+   * when this blob hasn't been parsed before.
+   */
+  static std::shared_ptr<const GitIgnore> getCachedGitIgnore(
+      const ObjectId& blobId);
+
+  /**
+   * Record a parsed .gitignore file in the process-wide cache.
+   */
+  static void putCachedGitIgnore(
+      const ObjectId& blobId,
+      std::shared_ptr<const GitIgnore> ignore);
+
   const StatsFetchContext& getStatsContext() {
     return *statsContext_;
   }
@@ -79,6 +121,11 @@ class DiffContext {
   std::unique_ptr<TopLevelIgnores> topLevelIgnores_;
   const folly::CancellationToken cancellation_;
 
+  // Bounds the number of subtree walks this diff may have outstanding on the
+  // executor. Zero means unbounded.
+  const uint64_t walkParallelism_;
+  std::atomic<uint64_t> activeWalks_{0};
+
   // TODO: We could populate pid and cause here.
   StatsFetchContextPtr statsContext_ = makeRefPtr<StatsFetchContext>();
 
@@ -166,6 +166,8 @@ inline constexpr ImportPriority kReaddirPrefetchPriority{
     ImportPriority::Class::Low};
 inline constexpr ImportPriority kThriftPrefetchPriority{
     ImportPriority::Class::Low};
+inline constexpr ImportPriority kCheckoutPrepPriority{
+    ImportPriority::Class::Low};
 
 } // namespace facebook::eden
 
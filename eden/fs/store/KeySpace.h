@@ -44,6 +44,14 @@ struct KeySpaceRecord {
   folly::StringPiece name;
   Persistence persistence;
 
+  /**
+   * Optional EdenConfig setting holding a
+   * rocksdb::GetColumnFamilyOptionsFromString-formatted override for this key
+   * space's column family options. Null for key spaces that cannot be tuned
+   * (e.g. deprecated ones).
+   */
+  ConfigSetting<std::string> EdenConfig::*columnFamilyOptions = nullptr;
+
   constexpr bool isEphemeral() const noexcept {
     return std::holds_alternative<Ephemeral>(persistence);
   }
@@ -69,25 +77,30 @@ class KeySpace {
   static constexpr KeySpaceRecord BlobFamily{
       0,
       "blob",
-      Ephemeral{&EdenConfig::localStoreBlobSizeLimit}};
+      Ephemeral{&EdenConfig::localStoreBlobSizeLimit},
+      &EdenConfig::localStoreBlobColumnFamilyOptions};
   static constexpr KeySpaceRecord BlobMetaDataFamily{
       1,
       "blobmeta",
-      Ephemeral{&EdenConfig::localStoreBlobMetaSizeLimit}};
+      Ephemeral{&EdenConfig::localStoreBlobMetaSizeLimit},
+      &EdenConfig::localStoreBlobMetaColumnFamilyOptions};
   static constexpr KeySpaceRecord TreeFamily{
       2,
       "tree",
-      Ephemeral{&EdenConfig::localStoreTreeSizeLimit}};
+      Ephemeral{&EdenConfig::localStoreTreeSizeLimit},
+      &EdenConfig::localStoreTreeColumnFamilyOptions};
   // Proxy hashes are required to fetch objects from hg from a hash.
   // Deleting them breaks re-importing after an inode is unloaded.
   static constexpr KeySpaceRecord HgProxyHashFamily{
       3,
       "hgproxyhash",
-      Persistent{}};
+      Persistent{},
+      &EdenConfig::localStoreHgProxyHashColumnFamilyOptions};
   static constexpr KeySpaceRecord HgCommitToTreeFamily{
       4,
       "hgcommit2tree",
-      Ephemeral{&EdenConfig::localStoreHgCommit2TreeSizeLimit}};
+      Ephemeral{&EdenConfig::localStoreHgCommit2TreeSizeLimit},
+      &EdenConfig::localStoreHgCommit2TreeColumnFamilyOptions};
   static constexpr KeySpaceRecord BlobSizeFamily{5, "blobsize", Deprecated{}};
 
   static constexpr KeySpaceRecord ScsProxyHashFamily{
@@ -102,6 +115,29 @@ class KeySpace {
       8,
       "recasdigestproxyhash",
       Deprecated{}};
+  // Maps a blob's content SHA-1 to the ObjectId it was last cached under,
+  // letting blobs whose IDs change (e.g. across a rebase) be recovered from
+  // the local cache by content instead of refetched.
+  static constexpr KeySpaceRecord BlobSha1Family{
+      9,
+      "blobsha1",
+      Ephemeral{&EdenConfig::localStoreBlobSha1SizeLimit}};
+  // Content-defined chunks of large blobs, keyed by the chunk's SHA-1.
+  // Blobs above the chunking threshold are stored in BlobFamily as a chunk
+  // list referencing this family, deduplicating repeated chunks.
+  static constexpr KeySpaceRecord BlobChunkFamily{
+      10,
+      "blobchunk",
+      Ephemeral{&EdenConfig::localStoreBlobChunkSizeLimit},
+      &EdenConfig::localStoreBlobChunkColumnFamilyOptions};
+  // A periodic snapshot of the object IDs resident in the in-memory blob and
+  // tree caches, streamed back into those caches after a cold start. Holds a
+  // single small value that is overwritten in place, so there is nothing to
+  // garbage collect.
+  static constexpr KeySpaceRecord WorkingSetFamily{
+      11,
+      "workingset",
+      Persistent{}};
 
   static constexpr const KeySpaceRecord* kAll[] = {
       &BlobFamily,
@@ -112,7 +148,10 @@ class KeySpace {
       &BlobSizeFamily,
       &ScsProxyHashFamily,
       &TreeMetaDataFamily,
-      &ReCasDigestProxyHashFamily};
+      &ReCasDigestProxyHashFamily,
+      &BlobSha1Family,
+      &BlobChunkFamily,
+      &WorkingSetFamily};
   static constexpr size_t kTotalCount = std::size(kAll);
 
  private:
@@ -11,17 +11,22 @@
 #include <folly/futures/Future.h>
 #include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
+#include <folly/io/IOBufQueue.h>
 #include <folly/lang/Bits.h>
 #include <folly/logging/xlog.h>
 #include <array>
+#include <cstring>
 
 #include "eden/fs/model/Blob.h"
 #include "eden/fs/model/Tree.h"
 #include "eden/fs/model/git/GitBlob.h"
 #include "eden/fs/model/git/GitTree.h"
+#include "eden/fs/store/BlobChunking.h"
 #include "eden/fs/store/SerializedBlobMetadata.h"
+#include "eden/fs/store/StoreCompression.h"
 #include "eden/fs/store/StoreResult.h"
 #include "eden/fs/store/TreeMetadata.h"
+#include "eden/fs/utils/UnboundedQueueExecutor.h"
 
 using folly::ByteRange;
 using folly::IOBuf;
@@ -30,12 +35,48 @@ using folly::io::Cursor;
 using std::optional;
 using std::string;
 
+namespace {
+
+using namespace facebook::eden;
+
+/**
+ * Payloads at least this large are deserialized on the deserialization pool
+ * (when one is configured) rather than inline on the thread that completed
+ * the store fetch. Below this size the parse is cheaper than a thread hop.
+ */
+constexpr size_t kDeserializeOffloadThreshold = 8 * 1024;
+
+/**
+ * Size of each per-key-space presence filter. 2^23 bits is 1MiB and keeps
+ * the false positive rate around 1% while tracking several hundred
+ * thousand keys, comfortably more than a large prefetch sweep.
+ */
+constexpr size_t kPresenceFilterBits = size_t{1} << 23;
+
+std::unique_ptr<Tree> deserializeTree(
+    const ObjectId& id,
+    const StoreResult& data) {
+  auto tree = Tree::tryDeserialize(id, StringPiece{data.bytes()});
+  if (tree) {
+    return tree;
+  }
+  return deserializeGitTree(id, data.bytes());
+}
+
+} // namespace
+
 namespace facebook::eden {
 
+void LocalStore::setDeserializationPool(
+    std::shared_ptr<UnboundedQueueExecutor> pool) {
+  *deserializationPool_.wlock() = std::move(pool);
+}
+
 void LocalStore::clearDeprecatedKeySpaces() {
   for (auto& ks : KeySpace::kAll) {
     if (ks->isDeprecated()) {
       clearKeySpace(ks);
+      resetPresenceFilter(ks);
       compactKeySpace(ks);
     }
   }
@@ -45,6 +86,7 @@ void LocalStore::clearCachesAndCompactAll() {
   for (auto& ks : KeySpace::kAll) {
     if (ks->isEphemeral()) {
       clearKeySpace(ks);
+      resetPresenceFilter(ks);
     }
     compactKeySpace(ks);
   }
@@ -54,6 +96,7 @@ void LocalStore::clearCaches() {
   for (auto& ks : KeySpace::kAll) {
     if (ks->isEphemeral()) {
       clearKeySpace(ks);
+      resetPresenceFilter(ks);
     }
   }
 }
@@ -89,21 +132,73 @@ folly::Future<std::vector<StoreResult>> LocalStore::getBatch(
   });
 }
 
+ImmediateFuture<std::unique_ptr<Tree>> LocalStore::parseStoredTree(
+    const ObjectId& id,
+    StoreResult&& data) const {
+  if (!data.isValid()) {
+    return std::unique_ptr<Tree>(nullptr);
+  }
+  auto pool = *deserializationPool_.rlock();
+  if (!pool || data.bytes().size() < kDeserializeOffloadThreshold) {
+    return deserializeTree(id, data);
+  }
+  // Large trees are expensive to parse. Move the parse onto the pool
+  // so it overlaps with other outstanding store fetches instead of
+  // serializing them all on the fetch thread during a prefetch.
+  return ImmediateFuture<std::unique_ptr<Tree>>{
+      folly::via(
+          pool.get(),
+          [id, data = std::move(data)] { return deserializeTree(id, data); })
+          .semi()};
+}
+
 ImmediateFuture<std::unique_ptr<Tree>> LocalStore::getTree(
     const ObjectId& id) const {
   return getImmediateFuture(KeySpace::TreeFamily, id)
-      .thenValue([id](StoreResult&& data) {
-        if (!data.isValid()) {
-          return std::unique_ptr<Tree>(nullptr);
-        }
-        auto tree = Tree::tryDeserialize(id, StringPiece{data.bytes()});
-        if (tree) {
-          return tree;
+      .thenValue([id, self = shared_from_this()](StoreResult&& data) {
+        return self->parseStoredTree(id, std::move(data));
+      });
+}
+
+ImmediateFuture<std::vector<std::unique_ptr<Tree>>> LocalStore::getTrees(
+    const std::vector<ObjectId>& ids) const {
+  std::vector<ByteRange> keys;
+  keys.reserve(ids.size());
+  for (const auto& id : ids) {
+    keys.push_back(id.getBytes());
+  }
+  return ImmediateFuture{getBatch(KeySpace::TreeFamily, keys).semi()}
+      .thenValue([ids, self = shared_from_this()](
+                     std::vector<StoreResult>&& results) {
+        std::vector<ImmediateFuture<std::unique_ptr<Tree>>> trees;
+        trees.reserve(results.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+          trees.push_back(
+              self->parseStoredTree(ids[i], std::move(results[i])));
         }
-        return deserializeGitTree(id, data.bytes());
+        return collectAllSafe(std::move(trees));
       });
 }
 
+ImmediateFuture<std::unique_ptr<Blob>> LocalStore::parseStoredBlob(
+    const ObjectId& id,
+    StoreResult&& data) const {
+  if (!data.isValid()) {
+    return std::unique_ptr<Blob>(nullptr);
+  }
+  auto buf = data.extractIOBuf();
+  // Values written while store:compress-blobs was enabled carry a
+  // compression header; everything else is stored plain. Both forms
+  // coexist in the key space.
+  if (auto raw = decompressStoreValue(buf.coalesce())) {
+    buf = std::move(raw.value());
+  }
+  if (auto manifest = parseChunkedBlobManifest(buf.coalesce())) {
+    return getChunkedBlob(id, std::move(manifest.value()));
+  }
+  return deserializeGitBlob(id, &buf);
+}
+
 ImmediateFuture<std::unique_ptr<Blob>> LocalStore::getBlob(
     const ObjectId& id) const {
   if (!enableBlobCaching) {
@@ -111,15 +206,88 @@ ImmediateFuture<std::unique_ptr<Blob>> LocalStore::getBlob(
   }
 
   return getImmediateFuture(KeySpace::BlobFamily, id)
-      .thenValue([id](StoreResult&& data) {
-        if (!data.isValid()) {
-          return std::unique_ptr<Blob>(nullptr);
+      .thenValue([id, self = shared_from_this()](StoreResult&& data) {
+        return self->parseStoredBlob(id, std::move(data));
+      });
+}
+
+ImmediateFuture<std::vector<std::unique_ptr<Blob>>> LocalStore::getBlobs(
+    const std::vector<ObjectId>& ids) const {
+  if (!enableBlobCaching) {
+    return std::vector<std::unique_ptr<Blob>>(ids.size());
+  }
+
+  std::vector<ByteRange> keys;
+  keys.reserve(ids.size());
+  for (const auto& id : ids) {
+    keys.push_back(id.getBytes());
+  }
+  return ImmediateFuture{getBatch(KeySpace::BlobFamily, keys).semi()}
+      .thenValue([ids, self = shared_from_this()](
+                     std::vector<StoreResult>&& results) {
+        std::vector<ImmediateFuture<std::unique_ptr<Blob>>> blobs;
+        blobs.reserve(results.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+          blobs.push_back(
+              self->parseStoredBlob(ids[i], std::move(results[i])));
         }
-        auto buf = data.extractIOBuf();
-        return deserializeGitBlob(id, &buf);
+        return collectAllSafe(std::move(blobs));
       });
 }
 
+ImmediateFuture<std::unique_ptr<Blob>> LocalStore::getChunkedBlob(
+    const ObjectId& id,
+    ChunkedBlobManifest manifest) const {
+  std::vector<ByteRange> keys;
+  keys.reserve(manifest.chunks.size());
+  for (const auto& chunk : manifest.chunks) {
+    keys.push_back(chunk.getBytes());
+  }
+  return ImmediateFuture{
+      getBatch(KeySpace::BlobChunkFamily, keys)
+          .semi()
+          .deferValue([id, manifest = std::move(manifest)](
+                          std::vector<StoreResult>&& results)
+                          -> std::unique_ptr<Blob> {
+            folly::IOBufQueue chain;
+            for (size_t i = 0; i < results.size(); ++i) {
+              if (!results[i].isValid()) {
+                // The chunk family is collected independently of the blob
+                // family, so a chunk may be gone while the manifest
+                // remains. Treat the whole blob as a cache miss.
+                return nullptr;
+              }
+              auto chunkBuf = results[i].extractIOBuf();
+              auto chunkBytes = chunkBuf.coalesce();
+              // Chunk values are raw content unless they were compressed
+              // at write time, and content-defined boundaries mean a raw
+              // chunk can legitimately begin with the compression header
+              // string. Chunk keys are the SHA-1 of the raw bytes, so a
+              // value that hashes to its own key is plain content; only
+              // then is a header prefix actually a header.
+              if (hasStoreCompressionHeader(chunkBytes) &&
+                  Hash20::sha1(chunkBytes) != manifest.chunks[i]) {
+                if (auto raw = decompressStoreValue(chunkBytes)) {
+                  chunkBuf = std::move(raw.value());
+                }
+              }
+              chain.append(std::make_unique<IOBuf>(std::move(chunkBuf)));
+            }
+            auto contents = chain.move();
+            if (!contents) {
+              contents = IOBuf::create(0);
+            }
+            auto blob = std::make_unique<Blob>(id, std::move(*contents));
+            if (blob->getSize() != manifest.blobSize) {
+              XLOG(ERR) << "Chunked blob " << id << " reassembled to "
+                        << blob->getSize() << " bytes, expected "
+                        << manifest.blobSize << "; discarding";
+              return nullptr;
+            }
+            return blob;
+          })};
+}
+
 ImmediateFuture<optional<BlobMetadata>> LocalStore::getBlobMetadata(
     const ObjectId& id) const {
   return getImmediateFuture(KeySpace::BlobMetaDataFamily, id)
@@ -140,11 +308,54 @@ bool LocalStore::hasKey(KeySpace keySpace, const ObjectId& id) const {
   return hasKey(keySpace, id.getBytes());
 }
 
+std::vector<ObjectId> LocalStore::filterMissing(
+    KeySpace keySpace,
+    ObjectIdRange ids) const {
+  auto& slot = presenceFilters_[keySpace->index];
+  if (!*slot.rlock()) {
+    auto wlock = slot.wlock();
+    if (!*wlock) {
+      *wlock = std::make_unique<BloomFilter>(kPresenceFilterBits);
+    }
+  }
+  // The filter is never deallocated once created, so it is safe to use it
+  // outside the lock.
+  auto* filter = slot.rlock()->get();
+
+  std::vector<ObjectId> missing;
+  for (const auto& id : ids) {
+    if (filter->mayContain(id.getHashCode())) {
+      // Almost certainly present; a rare false positive only skips a
+      // prefetch.
+      continue;
+    }
+    if (hasKey(keySpace, id)) {
+      filter->add(id.getHashCode());
+      continue;
+    }
+    missing.push_back(id);
+  }
+  return missing;
+}
+
+void LocalStore::recordPresence(KeySpace keySpace, const ObjectId& id) const {
+  if (auto* filter = presenceFilters_[keySpace->index].rlock()->get()) {
+    filter->add(id.getHashCode());
+  }
+}
+
+void LocalStore::resetPresenceFilter(KeySpace keySpace) const {
+  if (auto* filter = presenceFilters_[keySpace->index].rlock()->get()) {
+    filter->clear();
+  }
+}
+
 void LocalStore::putTree(const Tree& tree) {
   auto serialized = LocalStore::serializeTree(tree);
   ByteRange treeData = serialized.coalesce();
 
   put(KeySpace::TreeFamily, tree.getHash().getBytes(), treeData);
+  recordPresence(KeySpace::TreeFamily, tree.getHash());
 }
 
 void LocalStore::WriteBatch::putTree(const Tree& tree) {
@@ -158,16 +369,76 @@ void LocalStore::putBlob(const ObjectId& id, const Blob* blob) {
   if (!enableBlobCaching) {
     XLOG(DBG8) << "Skipping caching " << id
                << " because blob cache is disabled via config";
-  } else {
-    // Since blob serialization is moderately complex, just delegate
-    // the immediate putBlob to the method on the WriteBatch.
-    // Pre-allocate a buffer of approximately the right size; it
-    // needs to hold the blob content plus have room for a couple of
-    // hashes for the keys, plus some padding.
-    auto batch = beginWrite(blob->getSize() + 64);
-    batch->putBlob(id, blob);
-    batch->flush();
+    return;
+  }
+
+  auto chunkingThreshold = blobChunkingThreshold.load(std::memory_order_relaxed);
+  if (chunkingThreshold != 0 && blob->getSize() >= chunkingThreshold) {
+    putChunkedBlob(id, blob);
+    recordPresence(KeySpace::BlobFamily, id);
+    return;
+  }
+
+  if (compressBlobs.load(std::memory_order_relaxed)) {
+    // Serialize the git-style value contiguously so it can be compressed as
+    // a unit; the write batch's slice-based path would leave it fragmented.
+    auto contents = blob->getContents().cloneCoalescedAsValue();
+    auto prefix = folly::to<string>("blob ", blob->getSize());
+    prefix.push_back('\0');
+    folly::IOBuf serialized{
+        IOBuf::CREATE, prefix.size() + contents.length()};
+    memcpy(serialized.writableTail(), prefix.data(), prefix.size());
+    serialized.append(prefix.size());
+    memcpy(serialized.writableTail(), contents.data(), contents.length());
+    serialized.append(contents.length());
+
+    if (auto compressed = compressStoreValue(serialized.coalesce())) {
+      put(KeySpace::BlobFamily, id.getBytes(), compressed->coalesce());
+    } else {
+      put(KeySpace::BlobFamily, id.getBytes(), serialized.coalesce());
+    }
+    recordPresence(KeySpace::BlobFamily, id);
+    return;
+  }
+
+  // Since blob serialization is moderately complex, just delegate
+  // the immediate putBlob to the method on the WriteBatch.
+  // Pre-allocate a buffer of approximately the right size; it
+  // needs to hold the blob content plus have room for a couple of
+  // hashes for the keys, plus some padding.
+  auto batch = beginWrite(blob->getSize() + 64);
+  batch->putBlob(id, blob);
+  batch->flush();
+  recordPresence(KeySpace::BlobFamily, id);
+}
+
+void LocalStore::putChunkedBlob(const ObjectId& id, const Blob* blob) {
+  auto contents = blob->getContents().cloneCoalescedAsValue();
+  auto chunks = chunkBlob(ByteRange{contents.data(), contents.length()});
+
+  std::vector<Hash20> chunkHashes;
+  chunkHashes.reserve(chunks.size());
+  for (auto chunk : chunks) {
+    auto chunkHash = Hash20::sha1(chunk);
+    // Chunks are content addressed, so a key that is already present holds
+    // identical bytes. Skipping the write is what deduplicates
+    // near-identical large blobs.
+    if (!hasKey(KeySpace::BlobChunkFamily, chunkHash.getBytes())) {
+      // Chunk keys hash the uncompressed bytes, so compressing the stored
+      // value does not affect deduplication.
+      std::optional<folly::IOBuf> compressed;
+      if (compressBlobs.load(std::memory_order_relaxed)) {
+        compressed = compressStoreValue(chunk);
+      }
+      put(KeySpace::BlobChunkFamily,
+          chunkHash.getBytes(),
+          compressed ? compressed->coalesce() : chunk);
+    }
+    chunkHashes.push_back(chunkHash);
   }
+
+  auto manifest = serializeChunkedBlobManifest(blob->getSize(), chunkHashes);
+  put(KeySpace::BlobFamily, id.getBytes(), manifest.coalesce());
 }
 
 void LocalStore::putBlobMetadata(
@@ -177,6 +448,21 @@ void LocalStore::putBlobMetadata(
   SerializedBlobMetadata metadataBytes(metadata);
 
   put(KeySpace::BlobMetaDataFamily, hashBytes, metadataBytes.slice());
+  recordPresence(KeySpace::BlobMetaDataFamily, id);
+
+  // Also index the blob by content so it can be found again if its ID
+  // changes, e.g. when a rebase rewrites filenodes without changing file
+  // contents.
+  put(KeySpace::BlobSha1Family, metadata.sha1.getBytes(), hashBytes);
+}
+
+std::optional<ObjectId> LocalStore::getBlobIdForSha1(
+    const Hash20& contentSha1) const {
+  auto result = get(KeySpace::BlobSha1Family, contentSha1.getBytes());
+  if (!result.isValid()) {
+    return std::nullopt;
+  }
+  return ObjectId{result.bytes()};
 }
 
 void LocalStore::put(
@@ -186,6 +472,7 @@ void LocalStore::put(
   XCHECK(!keySpace->isDeprecated())
       << "Write to deprecated keyspace " << keySpace->name;
   put(keySpace, id.getBytes(), value);
+  recordPresence(keySpace, id);
 }
 
 void LocalStore::WriteBatch::put(
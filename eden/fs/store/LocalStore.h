@@ -8,12 +8,15 @@
 #pragma once
 
 #include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <array>
 #include <atomic>
 #include <memory>
 #include <optional>
 #include "eden/fs/model/BlobMetadata.h"
 #include "eden/fs/model/ObjectId.h"
 #include "eden/fs/store/KeySpace.h"
+#include "eden/fs/utils/BloomFilter.h"
 #include "eden/fs/utils/ImmediateFuture.h"
 #include "eden/fs/utils/PathFuncs.h"
 
@@ -25,10 +28,12 @@ class Future;
 namespace facebook::eden {
 
 class Blob;
+struct ChunkedBlobManifest;
 class EdenConfig;
 class StoreResult;
 class Tree;
 class TreeMetadata;
+class UnboundedQueueExecutor;
 
 /*
  * LocalStore stores objects (trees and blobs) locally on disk.
@@ -133,6 +138,18 @@ class LocalStore : public std::enable_shared_from_this<LocalStore> {
    */
   ImmediateFuture<std::unique_ptr<Tree>> getTree(const ObjectId& id) const;
 
+  /**
+   * Get several Trees from the store with a single getBatch() read.
+   *
+   * The result vector parallels ids; entries not present in the store are
+   * nullptr. Prefer this over a loop of getTree() calls when the ids are
+   * known up front: RocksDbLocalStore services getBatch() with MultiGet,
+   * which shares one iteration over the index blocks rather than paying a
+   * full point lookup per key.
+   */
+  ImmediateFuture<std::vector<std::unique_ptr<Tree>>> getTrees(
+      const std::vector<ObjectId>& ids) const;
+
   /**
    * Get a Blob from the store.
    *
@@ -144,6 +161,15 @@ class LocalStore : public std::enable_shared_from_this<LocalStore> {
    */
   ImmediateFuture<std::unique_ptr<Blob>> getBlob(const ObjectId& id) const;
 
+  /**
+   * Get several Blobs from the store with a single getBatch() read.
+   *
+   * The result vector parallels ids; entries not present in the store are
+   * nullptr. See getTrees() for when to prefer this over per-id calls.
+   */
+  ImmediateFuture<std::vector<std::unique_ptr<Blob>>> getBlobs(
+      const std::vector<ObjectId>& ids) const;
+
   /**
    * Get the size of a blob and the SHA-1 hash of its contents.
    *
@@ -159,6 +185,21 @@ class LocalStore : public std::enable_shared_from_this<LocalStore> {
   virtual bool hasKey(KeySpace keySpace, folly::ByteRange key) const = 0;
   bool hasKey(KeySpace keySpace, const ObjectId& id) const;
 
+  /**
+   * Strip ids that are already present in the given key space from a
+   * prefetch batch, returning the ids that still need to be fetched.
+   *
+   * Presence is tracked in an in-memory Bloom filter per key space,
+   * seeded by writes and by the probes this method performs, so repeated
+   * sweeps over a warm repository skip the per-key existence checks
+   * entirely. The filter's false positives can occasionally strip an id
+   * that is actually missing; callers must only use this for
+   * optimizations like prefetching, where a skipped id is later fetched
+   * on demand.
+   */
+  std::vector<ObjectId> filterMissing(KeySpace keySpace, ObjectIdRange ids)
+      const;
+
   /**
    * Store a Tree into the TreeFamily KeySpace.
    */
@@ -174,6 +215,16 @@ class LocalStore : public std::enable_shared_from_this<LocalStore> {
    */
   void putBlobMetadata(const ObjectId& id, const BlobMetadata& metadata);
 
+  /**
+   * Look up the ID a blob with the given content SHA-1 was last cached
+   * under.
+   *
+   * The index is maintained by putBlobMetadata() and is advisory: an entry
+   * may refer to a blob that was never cached or has since been collected,
+   * so callers must confirm the blob is still present via getBlob().
+   */
+  std::optional<ObjectId> getBlobIdForSha1(const Hash20& contentSha1) const;
+
   /**
    * Put arbitrary data in the store.
    */
@@ -254,6 +305,18 @@ class LocalStore : public std::enable_shared_from_this<LocalStore> {
 
   virtual void periodicManagementTask(const EdenConfig& config);
 
+  /**
+   * Set an executor on which large objects read from the store are
+   * deserialized.
+   *
+   * Without a pool, deserialization runs inline on whichever thread completes
+   * the store fetch, so a large prefetch parses every object serially on one
+   * core. With a pool set, parsing of large payloads overlaps with other
+   * outstanding fetches and spreads across the pool's threads. Small payloads
+   * are still parsed inline since a thread hop costs more than the parse.
+   */
+  void setDeserializationPool(std::shared_ptr<UnboundedQueueExecutor> pool);
+
   /*
    * We keep this field to avoid making `LocalStore` holding a reference to
    * `EdenConfig`, which will require us to change all the subclasses. We update
@@ -263,6 +326,24 @@ class LocalStore : public std::enable_shared_from_this<LocalStore> {
    */
   std::atomic<bool> enableBlobCaching = true;
 
+  /**
+   * Blobs at least this many bytes are stored as deduplicated chunk lists
+   * (see BlobChunking.h); 0 disables chunked storage. Like
+   * enableBlobCaching, this mirrors an EdenConfig value
+   * (store:blob-chunking-threshold) and is refreshed by
+   * periodicManagementTask.
+   */
+  std::atomic<uint64_t> blobChunkingThreshold = 0;
+
+  /**
+   * Whether newly written blob and blob chunk values are compressed above
+   * the storage engine (see StoreCompression.h). Reads always handle both
+   * compressed and plain values, so this can be toggled at any time without
+   * migrating existing data. Mirrors store:compress-blobs and is refreshed
+   * by periodicManagementTask.
+   */
+  std::atomic<bool> compressBlobs = false;
+
  private:
   /**
    * Compute the serialized version of the tree in a (not coalesced) IOBuf.
@@ -272,6 +353,68 @@ class LocalStore : public std::enable_shared_from_this<LocalStore> {
    * two phase import.
    */
   static folly::IOBuf serializeTree(const Tree& tree);
+
+  /**
+   * Store a blob as a manifest in the blob key space plus content-defined
+   * chunks in the blob chunk key space, deduplicating chunks that are
+   * already present. Used by putBlob for blobs at least
+   * blobChunkingThreshold bytes.
+   */
+  void putChunkedBlob(const ObjectId& id, const Blob* blob);
+
+  /**
+   * Reconstruct a chunked blob from its manifest by fetching and chaining
+   * its chunks. Returns nullptr (a cache miss) if any chunk has been
+   * evicted.
+   */
+  ImmediateFuture<std::unique_ptr<Blob>> getChunkedBlob(
+      const ObjectId& id,
+      ChunkedBlobManifest manifest) const;
+
+  /**
+   * Deserialize one stored tree value, offloading large payloads to the
+   * deserialization pool. Shared by getTree() and getTrees().
+   */
+  ImmediateFuture<std::unique_ptr<Tree>> parseStoredTree(
+      const ObjectId& id,
+      StoreResult&& data) const;
+
+  /**
+   * Deserialize one stored blob value, handling compressed and chunked
+   * forms. Shared by getBlob() and getBlobs().
+   */
+  ImmediateFuture<std::unique_ptr<Blob>> parseStoredBlob(
+      const ObjectId& id,
+      StoreResult&& data) const;
+
+  /**
+   * Record that the given id is present in the key space, if a presence
+   * filter has been allocated for it. See filterMissing().
+   */
+  void recordPresence(KeySpace keySpace, const ObjectId& id) const;
+
+  /**
+   * Reset the presence filter for the given key space, typically because
+   * the key space was cleared.
+   */
+  void resetPresenceFilter(KeySpace keySpace) const;
+
+  /**
+   * Executor for deserializing large payloads, or null to always parse
+   * inline. See setDeserializationPool().
+   */
+  folly::Synchronized<std::shared_ptr<UnboundedQueueExecutor>>
+      deserializationPool_;
+
+  /**
+   * Per-key-space presence filters backing filterMissing(). Each filter
+   * is allocated on its first filterMissing() call, so stores that never
+   * filter prefetch batches pay nothing.
+   */
+  mutable std::array<
+      folly::Synchronized<std::unique_ptr<BloomFilter>>,
+      KeySpace::kTotalCount>
+      presenceFilters_;
 };
 
 } // namespace facebook::eden
@@ -7,6 +7,7 @@
 
 #include "eden/fs/store/LocalStoreCachedBackingStore.h"
 #include "eden/fs/model/Blob.h"
+#include "eden/fs/model/BlobMetadata.h"
 #include "eden/fs/model/Tree.h"
 #include "eden/fs/store/LocalStore.h"
 #include "eden/fs/telemetry/EdenStats.h"
@@ -14,6 +15,31 @@
 
 namespace facebook::eden {
 
+namespace {
+
+folly::SemiFuture<BackingStore::GetBlobResult> fetchBlobFromBackingStore(
+    const ObjectId& id,
+    std::shared_ptr<LocalStore> localStore,
+    std::shared_ptr<BackingStore> backingStore,
+    std::shared_ptr<EdenStats> stats,
+    const ObjectFetchContextPtr& context) {
+  return backingStore
+      ->getBlob(id, context)
+      // TODO: This is a good use for toUnsafeFuture to ensure the tree is
+      // cached even if the resulting future is never consumed.
+      .deferValue([localStore = std::move(localStore),
+                   stats = std::move(stats),
+                   id](BackingStore::GetBlobResult result) {
+        if (result.blob) {
+          localStore->putBlob(id, result.blob.get());
+          stats->increment(&ObjectStoreStats::getBlobFromBackingStore);
+        }
+        return result;
+      });
+}
+
+} // namespace
+
 LocalStoreCachedBackingStore::LocalStoreCachedBackingStore(
     std::shared_ptr<BackingStore> backingStore,
     std::shared_ptr<LocalStore> localStore,
@@ -97,31 +123,63 @@ LocalStoreCachedBackingStore::getBlob(
     const ObjectId& id,
     const ObjectFetchContextPtr& context) {
   return localStore_->getBlob(id)
-      .thenValue([id = id,
-                  context = context.copy(),
-                  localStore = localStore_,
-                  backingStore = backingStore_,
-                  stats = stats_](std::unique_ptr<Blob> blob) mutable {
-        if (blob) {
-          stats->increment(&ObjectStoreStats::getBlobFromLocalStore);
-          return folly::makeSemiFuture(GetBlobResult{
-              std::move(blob), ObjectFetchContext::FromDiskCache});
-        }
-
-        return backingStore
-            ->getBlob(id, context)
-            // TODO: This is a good use for toUnsafeFuture to ensure the tree is
-            // cached even if the resulting future is never consumed.
-            .deferValue([localStore = std::move(localStore),
-                         stats = std::move(stats),
-                         id](GetBlobResult result) {
-              if (result.blob) {
-                localStore->putBlob(id, result.blob.get());
-                stats->increment(&ObjectStoreStats::getBlobFromBackingStore);
-              }
-              return result;
-            });
-      })
+      .thenValue(
+          [id = id,
+           context = context.copy(),
+           localStore = localStore_,
+           backingStore = backingStore_,
+           stats = stats_](std::unique_ptr<Blob> blob) mutable
+          -> folly::SemiFuture<GetBlobResult> {
+            if (blob) {
+              stats->increment(&ObjectStoreStats::getBlobFromLocalStore);
+              return folly::makeSemiFuture(GetBlobResult{
+                  std::move(blob), ObjectFetchContext::FromDiskCache});
+            }
+
+            // An ID miss doesn't imply a content miss: a rebase rewrites
+            // object IDs while leaving most file contents untouched. If the
+            // backing store knows this ID's content SHA-1 without a remote
+            // fetch, check whether the same content is already cached under
+            // its pre-rebase ID and re-key it rather than refetching.
+            std::optional<ObjectId> sameContentId;
+            if (auto metadata =
+                    backingStore->getLocalBlobMetadata(id, context)) {
+              sameContentId = localStore->getBlobIdForSha1(metadata->sha1);
+            }
+            if (!sameContentId) {
+              return fetchBlobFromBackingStore(
+                  id,
+                  std::move(localStore),
+                  std::move(backingStore),
+                  std::move(stats),
+                  context);
+            }
+
+            return localStore->getBlob(*sameContentId)
+                .thenValue(
+                    [id,
+                     context = std::move(context),
+                     localStore = std::move(localStore),
+                     backingStore = std::move(backingStore),
+                     stats = std::move(stats)](std::unique_ptr<Blob> cached)
+                    -> folly::SemiFuture<GetBlobResult> {
+                      if (cached) {
+                        localStore->putBlob(id, cached.get());
+                        stats->increment(
+                            &ObjectStoreStats::getBlobFromLocalStore);
+                        return folly::makeSemiFuture(GetBlobResult{
+                            std::move(cached),
+                            ObjectFetchContext::FromDiskCache});
+                      }
+                      return fetchBlobFromBackingStore(
+                          id,
+                          std::move(localStore),
+                          std::move(backingStore),
+                          std::move(stats),
+                          context);
+                    })
+                .semi();
+          })
       .semi();
 }
 
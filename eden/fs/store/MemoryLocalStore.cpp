@@ -7,22 +7,29 @@
 
 #include "eden/fs/store/MemoryLocalStore.h"
 #include <folly/String.h>
+#include <folly/hash/SpookyHashV2.h>
 #include "eden/fs/store/StoreResult.h"
 
 namespace facebook::eden {
 
 using folly::StringPiece;
 
-namespace {
-class MemoryWriteBatch : public LocalStore::WriteBatch {
+/**
+ * Buffers puts per (key space, shard) so flush() can move each group into
+ * the store with one lock acquisition per shard, instead of taking a lock
+ * for every key.
+ */
+class MemoryLocalStoreWriteBatch : public LocalStore::WriteBatch {
  public:
-  explicit MemoryWriteBatch(MemoryLocalStore* store) : store_(store) {
+  explicit MemoryLocalStoreWriteBatch(MemoryLocalStore* store)
+      : store_(store) {
     storage_.resize(KeySpace::kTotalCount);
   }
 
   void put(KeySpace keySpace, folly::ByteRange key, folly::ByteRange value)
       override {
-    storage_[keySpace->index][StringPiece(key)] = StringPiece(value).str();
+    storage_[keySpace->index][MemoryLocalStore::shardIndex(key)][StringPiece(
+        key)] = StringPiece(value).str();
   }
 
   void put(
@@ -38,58 +45,90 @@ class MemoryWriteBatch : public LocalStore::WriteBatch {
 
   void flush() override {
     for (auto& ks : KeySpace::kAll) {
-      for (const auto& it : storage_[ks->index]) {
-        store_->put(ks, folly::StringPiece(it.first), StringPiece(it.second));
+      auto& shards = storage_[ks->index];
+      for (size_t shard = 0; shard < MemoryLocalStore::kShardCount; ++shard) {
+        if (shards[shard].empty()) {
+          continue;
+        }
+        store_->absorbShard(ks, shard, std::move(shards[shard]));
+        shards[shard] = {};
       }
-      storage_[ks->index].clear();
     }
   }
 
  private:
   MemoryLocalStore* store_;
-  std::vector<folly::StringKeyedUnorderedMap<std::string>> storage_;
+  std::vector<std::array<
+      folly::StringKeyedUnorderedMap<std::string>,
+      MemoryLocalStore::kShardCount>>
+      storage_;
 };
-} // namespace
 
-MemoryLocalStore::MemoryLocalStore() {
-  storage_.wlock()->resize(KeySpace::kTotalCount);
-}
+MemoryLocalStore::MemoryLocalStore() : storage_(KeySpace::kTotalCount) {}
 
 void MemoryLocalStore::open() {}
 void MemoryLocalStore::close() {}
 
+size_t MemoryLocalStore::shardIndex(folly::ByteRange key) noexcept {
+  return folly::hash::SpookyHashV2::Hash64(key.data(), key.size(), 0) &
+      (kShardCount - 1);
+}
+
+MemoryLocalStore::Shard& MemoryLocalStore::shardFor(
+    KeySpace keySpace,
+    folly::ByteRange key) {
+  return storage_[keySpace->index][shardIndex(key)];
+}
+
+const MemoryLocalStore::Shard& MemoryLocalStore::shardFor(
+    KeySpace keySpace,
+    folly::ByteRange key) const {
+  return storage_[keySpace->index][shardIndex(key)];
+}
+
 void MemoryLocalStore::clearKeySpace(KeySpace keySpace) {
-  (*storage_.wlock())[keySpace->index].clear();
+  for (auto& shard : storage_[keySpace->index]) {
+    shard.wlock()->clear();
+  }
 }
 
 void MemoryLocalStore::compactKeySpace(KeySpace) {}
 
 StoreResult MemoryLocalStore::get(KeySpace keySpace, folly::ByteRange key)
     const {
-  auto store = storage_.rlock();
-  auto it = (*store)[keySpace->index].find(StringPiece(key));
-  if (it == (*store)[keySpace->index].end()) {
+  auto shard = shardFor(keySpace, key).rlock();
+  auto it = shard->find(StringPiece(key));
+  if (it == shard->end()) {
     return StoreResult::missing(keySpace, key);
   }
   return StoreResult(std::string(it->second));
 }
 
 bool MemoryLocalStore::hasKey(KeySpace keySpace, folly::ByteRange key) const {
-  auto store = storage_.rlock();
-  auto it = (*store)[keySpace->index].find(StringPiece(key));
-  return it != (*store)[keySpace->index].end();
+  auto shard = shardFor(keySpace, key).rlock();
+  return shard->find(StringPiece(key)) != shard->end();
 }
 
 void MemoryLocalStore::put(
     KeySpace keySpace,
     folly::ByteRange key,
     folly::ByteRange value) {
-  (*storage_.wlock())[keySpace->index][StringPiece(key)] =
+  (*shardFor(keySpace, key).wlock())[StringPiece(key)] =
       StringPiece(value).str();
 }
 
+void MemoryLocalStore::absorbShard(
+    KeySpace keySpace,
+    size_t shard,
+    folly::StringKeyedUnorderedMap<std::string>&& entries) {
+  auto locked = storage_[keySpace->index][shard].wlock();
+  for (auto& entry : entries) {
+    (*locked)[StringPiece(entry.first)] = std::move(entry.second);
+  }
+}
+
 std::unique_ptr<LocalStore::WriteBatch> MemoryLocalStore::beginWrite(size_t) {
-  return std::make_unique<MemoryWriteBatch>(this);
+  return std::make_unique<MemoryLocalStoreWriteBatch>(this);
 }
 
 } // namespace facebook::eden
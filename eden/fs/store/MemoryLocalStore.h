@@ -8,15 +8,23 @@
 #pragma once
 #include <folly/Synchronized.h>
 #include <folly/experimental/StringKeyedUnorderedMap.h>
+#include <array>
 #include "eden/fs/store/LocalStore.h"
 
 namespace facebook::eden {
 
+class MemoryLocalStoreWriteBatch;
+
 /** An implementation of LocalStore that stores values in memory.
  * Stored values remain in memory for the lifetime of the
  * MemoryLocalStore instance.
  * MemoryLocalStore is thread safe, allowing concurrent reads and
  * writes from any thread.
+ *
+ * Each key space is split into a fixed number of lock shards selected by a
+ * hash of the key, so concurrent readers and writers only contend when they
+ * land on the same shard. Write batches group their entries by shard and
+ * are absorbed with one lock acquisition per shard at flush time.
  * */
 class MemoryLocalStore final : public LocalStore {
  public:
@@ -33,8 +41,33 @@ class MemoryLocalStore final : public LocalStore {
       size_t bufSize = 0) override;
 
  private:
-  folly::Synchronized<std::vector<folly::StringKeyedUnorderedMap<std::string>>>
-      storage_;
+  friend class MemoryLocalStoreWriteBatch;
+
+  /**
+   * Number of lock shards per key space. Must be a power of two. Sized for
+   * the thread counts of a parallel integration run; each shard only costs
+   * a map plus a lock.
+   */
+  static constexpr size_t kShardCount = 16;
+
+  using Shard =
+      folly::Synchronized<folly::StringKeyedUnorderedMap<std::string>>;
+
+  static size_t shardIndex(folly::ByteRange key) noexcept;
+
+  Shard& shardFor(KeySpace keySpace, folly::ByteRange key);
+  const Shard& shardFor(KeySpace keySpace, folly::ByteRange key) const;
+
+  /**
+   * Move a write batch's accumulated entries for one shard into the store
+   * under a single lock acquisition.
+   */
+  void absorbShard(
+      KeySpace keySpace,
+      size_t shard,
+      folly::StringKeyedUnorderedMap<std::string>&& entries);
+
+  std::vector<std::array<Shard, kShardCount>> storage_;
 };
 
 } // namespace facebook::eden
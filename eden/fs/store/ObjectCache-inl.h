@@ -74,7 +74,11 @@ ObjectCache<ObjectType, Flavor>::ObjectCache(
     size_t maximumCacheSizeBytes,
     size_t minimumEntryCount)
     : maximumCacheSizeBytes_{maximumCacheSizeBytes},
-      minimumEntryCount_{minimumEntryCount} {}
+      minimumEntryCount_{minimumEntryCount},
+      shardMask_{computeShardCount(maximumCacheSizeBytes) - 1},
+      maximumShardSizeBytes_{maximumCacheSizeBytes / (shardMask_ + 1)},
+      minimumShardEntryCount_{minimumEntryCount / (shardMask_ + 1)},
+      shards_{shardMask_ + 1} {}
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 template <ObjectCacheFlavor F>
@@ -90,7 +94,7 @@ ObjectCache<ObjectType, Flavor>::getInterestHandle(
   // runs after the lock is released.
   ObjectInterestHandle<ObjectType> interestHandle;
 
-  auto state = state_.lock();
+  auto state = shardFor(hash).lock();
 
   auto item = getImpl(hash, *state);
   if (!item) {
@@ -129,7 +133,7 @@ typename std::enable_if_t<
     typename ObjectCache<ObjectType, Flavor>::ObjectPtr>
 ObjectCache<ObjectType, Flavor>::getSimple(const ObjectId& hash) {
   XLOG(DBG6) << "BlobCache::getSimple " << hash;
-  auto state = state_.lock();
+  auto state = shardFor(hash).lock();
 
   if (auto item = getImpl(hash, *state)) {
     return item->object;
@@ -190,7 +194,7 @@ ObjectCache<ObjectType, Flavor>::insertInterestHandle(
 
   XLOG(DBG6) << "  creating entry with generation=" << cacheItemGeneration;
 
-  auto state = state_.lock();
+  auto state = shardFor(object->getHash()).lock();
   auto [item, inserted] = insertImpl(std::move(object), *state);
   switch (interest) {
     case Interest::UnlikelyNeededAgain:
@@ -219,7 +223,7 @@ typename std::enable_if_t<F == ObjectCacheFlavor::Simple, void>
 ObjectCache<ObjectType, Flavor>::insertSimple(
     ObjectCache<ObjectType, Flavor>::ObjectPtr object) {
   XLOG(DBG6) << "ObjectCache::insertSimple " << object->getHash();
-  auto state = state_.lock();
+  auto state = shardFor(object->getHash()).lock();
   insertImpl(std::move(object), *state);
 }
 
@@ -257,39 +261,59 @@ ObjectCache<ObjectType, Flavor>::insertImpl(ObjectPtr object, State& state) {
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 bool ObjectCache<ObjectType, Flavor>::contains(const ObjectId& hash) const {
-  auto state = state_.lock();
+  auto state = shardFor(hash).lock();
   return 1 == state->items.count(hash);
 }
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 void ObjectCache<ObjectType, Flavor>::clear() {
   XLOG(DBG6) << "ObjectCache::clear";
-  auto state = state_.lock();
-  state->totalSize = 0;
-  state->evictionQueue.clear();
-  state->items.clear();
+  for (auto& shard : shards_) {
+    auto state = shard.lock();
+    state->totalSize = 0;
+    state->evictionQueue.clear();
+    state->items.clear();
+  }
 }
 
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 typename ObjectCache<ObjectType, Flavor>::Stats
 ObjectCache<ObjectType, Flavor>::getStats() const {
-  auto state = state_.lock();
+  // Shards are locked one at a time, so the result is not a single atomic
+  // snapshot of the whole cache, which is fine for reporting purposes.
   Stats stats;
-  stats.objectCount = state->items.size();
-  stats.totalSizeInBytes = state->totalSize;
-  stats.hitCount = state->hitCount;
-  stats.missCount = state->missCount;
-  stats.evictionCount = state->evictionCount;
-  stats.dropCount = state->dropCount;
+  for (const auto& shard : shards_) {
+    auto state = shard.lock();
+    stats.objectCount += state->items.size();
+    stats.totalSizeInBytes += state->totalSize;
+    stats.hitCount += state->hitCount;
+    stats.missCount += state->missCount;
+    stats.evictionCount += state->evictionCount;
+    stats.dropCount += state->dropCount;
+  }
   return stats;
 }
 
+template <typename ObjectType, ObjectCacheFlavor Flavor>
+std::vector<typename ObjectCache<ObjectType, Flavor>::ObjectPtr>
+ObjectCache<ObjectType, Flavor>::getAllObjects() const {
+  std::vector<ObjectPtr> objects;
+  for (const auto& shard : shards_) {
+    auto state = shard.lock();
+    objects.reserve(objects.size() + state->items.size());
+    for (const auto& [hash, item] : state->items) {
+      objects.push_back(item.object);
+    }
+  }
+  return objects;
+}
+
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 void ObjectCache<ObjectType, Flavor>::dropInterestHandle(
     const ObjectId& hash,
     uint64_t generation) noexcept {
   XLOG(DBG6) << "dropInterestHandle " << hash << " generation=" << generation;
-  auto state = state_.lock();
+  auto state = shardFor(hash).lock();
 
   auto* item = folly::get_ptr(state->items, hash);
   if (!item) {
@@ -317,15 +341,31 @@ void ObjectCache<ObjectType, Flavor>::dropInterestHandle(
   }
 }
 
+template <typename ObjectType, ObjectCacheFlavor Flavor>
+void ObjectCache<ObjectType, Flavor>::setMaximumCacheSizeBytes(
+    size_t maximumCacheSizeBytes) {
+  maximumCacheSizeBytes_.store(
+      maximumCacheSizeBytes, std::memory_order_relaxed);
+  maximumShardSizeBytes_.store(
+      maximumCacheSizeBytes / (shardMask_ + 1), std::memory_order_relaxed);
+  // When shrinking, trim each shard down to its new slice of the budget.
+  for (auto& shard : shards_) {
+    auto state = shard.lock();
+    evictUntilFits(*state);
+  }
+}
+
 template <typename ObjectType, ObjectCacheFlavor Flavor>
 void ObjectCache<ObjectType, Flavor>::evictUntilFits(State& state) noexcept {
+  auto maximumShardSizeBytes =
+      maximumShardSizeBytes_.load(std::memory_order_relaxed);
   XLOG(DBG6) << "ObjectCache::evictUntilFits "
              << "state.totalSize=" << state.totalSize
-             << ", maximumCacheSizeBytes_=" << maximumCacheSizeBytes_
+             << ", maximumShardSizeBytes=" << maximumShardSizeBytes
              << ", evictionQueue.size()=" << state.evictionQueue.size()
-             << ", minimumEntryCount_=" << minimumEntryCount_;
-  while (state.totalSize > maximumCacheSizeBytes_ &&
-         state.evictionQueue.size() > minimumEntryCount_) {
+             << ", minimumShardEntryCount_=" << minimumShardEntryCount_;
+  while (state.totalSize > maximumShardSizeBytes &&
+         state.evictionQueue.size() > minimumShardEntryCount_) {
     evictOne(state);
   }
 }
@@ -351,6 +391,9 @@ void ObjectCache<ObjectType, Flavor>::evictItem(
   // could be scheduled for deletion in a deletion queue but then it's hard to
   // ensure that scheduling is noexcept. Instead, ObjectPtr should be replaced
   // with an refcounted pointer that doesn't allow running custom deleters.
+  // Give subclasses a chance to retain the object in a second-chance tier
+  // before the cache drops its reference.
+  onEvictedItem(item.object);
   state.items.erase(item.object->getHash());
   state.totalSize -= size;
 }
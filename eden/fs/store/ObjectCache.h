@@ -11,8 +11,11 @@
 #include <folly/Synchronized.h>
 #include <folly/container/F14Map.h>
 #include <folly/synchronization/DistributedMutex.h>
+#include <algorithm>
+#include <atomic>
 #include <list>
 #include <mutex>
+#include <vector>
 
 #include "eden/fs/model/ObjectId.h"
 
@@ -150,7 +153,7 @@ class ObjectCache
   static std::shared_ptr<ObjectCache<ObjectType, Flavor>> create(
       size_t maximumCacheSizeBytes,
       size_t minimumEntryCount);
-  ~ObjectCache() {
+  virtual ~ObjectCache() {
     clear();
   }
 
@@ -225,9 +228,43 @@ class ObjectCache
    */
   Stats getStats() const;
 
+  /**
+   * Return the current maximum cache size in bytes. This can change at
+   * runtime via setMaximumCacheSizeBytes.
+   */
+  size_t getMaximumCacheSizeBytes() const {
+    return maximumCacheSizeBytes_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Adjust the maximum cache size at runtime. Shrinking the budget evicts
+   * entries until every shard fits its new slice. The shard count is fixed
+   * at construction time from the initial size, so growing the budget does
+   * not add shards.
+   */
+  void setMaximumCacheSizeBytes(size_t maximumCacheSizeBytes);
+
+  /**
+   * Returns a snapshot of every object currently in the cache, in no
+   * particular order. Intended for bulk export, e.g. preserving the hot
+   * object set across a graceful restart.
+   */
+  std::vector<ObjectPtr> getAllObjects() const;
+
  protected:
   explicit ObjectCache(size_t maximumCacheSizeBytes, size_t minimumEntryCount);
 
+  /**
+   * Called for each object as it is evicted, either due to size pressure or
+   * because its last interest handle was dropped. Invoked while the shard
+   * lock for the object is held, so implementations must not call back into
+   * the cache and should be quick.
+   *
+   * Subclasses can override this to implement a second-chance tier for
+   * evicted objects.
+   */
+  virtual void onEvictedItem(const ObjectPtr&) noexcept {}
+
  private:
   /*
    * TODO: This data structure could be implemented more efficiently. But since
@@ -304,9 +341,54 @@ class ObjectCache
   void evictOne(State& state) noexcept;
   void evictItem(State&, const CacheItem& item) noexcept;
 
-  const size_t maximumCacheSizeBytes_;
+  /**
+   * The cache is sharded by ObjectId hash so concurrent lookups of distinct
+   * objects don't serialize on one lock. Each shard owns its own index, LRU
+   * eviction queue and size accounting, and is given an equal slice of the
+   * overall size budget and minimum entry count.
+   *
+   * The shard count scales with the size budget: each shard gets at least
+   * kMinimumShardSizeBytes so per-shard eviction accounting stays meaningful.
+   * Small caches (notably in tests) end up with a single shard and thus
+   * retain exact global LRU semantics.
+   */
+  static constexpr size_t kMinimumShardSizeBytes = 1024 * 1024;
+  static constexpr size_t kMaximumShardCount = 64;
+
+  /**
+   * Returns the largest power of two shard count such that every shard gets
+   * at least kMinimumShardSizeBytes, capped at kMaximumShardCount.
+   */
+  static size_t computeShardCount(size_t maximumCacheSizeBytes) noexcept {
+    size_t target = std::min(
+        maximumCacheSizeBytes / kMinimumShardSizeBytes, kMaximumShardCount);
+    size_t shards = 1;
+    while (shards * 2 <= target) {
+      shards *= 2;
+    }
+    return shards;
+  }
+
+  size_t shardIndex(const ObjectId& hash) const noexcept {
+    return hash.getHashCode() & shardMask_;
+  }
+
+  folly::Synchronized<State, folly::DistributedMutex>& shardFor(
+      const ObjectId& hash) {
+    return shards_[shardIndex(hash)];
+  }
+
+  const folly::Synchronized<State, folly::DistributedMutex>& shardFor(
+      const ObjectId& hash) const {
+    return shards_[shardIndex(hash)];
+  }
+
+  std::atomic<size_t> maximumCacheSizeBytes_;
   const size_t minimumEntryCount_;
-  folly::Synchronized<State, folly::DistributedMutex> state_;
+  const size_t shardMask_;
+  std::atomic<size_t> maximumShardSizeBytes_;
+  const size_t minimumShardEntryCount_;
+  std::vector<folly::Synchronized<State, folly::DistributedMutex>> shards_;
 
   friend class ObjectInterestHandle<ObjectType>;
 };
@@ -11,6 +11,8 @@
 #include <string_view>
 #include <unordered_map>
 
+#include <folly/CancellationToken.h>
+#include <folly/Executor.h>
 #include <folly/portability/SysTypes.h>
 
 #include "eden/fs/store/ImportPriority.h"
@@ -87,6 +89,24 @@ class ObjectFetchContext : public RefCounted {
     return kDefaultImportPriority;
   }
 
+  /**
+   * The executor priority that CPU work performed on behalf of this fetch
+   * should run at. Filesystem-triggered requests and explicitly
+   * high-priority imports map to HI_PRI so their continuations are not
+   * stuck behind queued background work; prefetches and deprioritized
+   * imports map to LO_PRI.
+   */
+  int8_t getExecutorPriority() const {
+    auto cls = getPriority().getClass();
+    if (cls == ImportPriority::Class::Low || getCause() == Cause::Prefetch) {
+      return folly::Executor::LO_PRI;
+    }
+    if (cls == ImportPriority::Class::High || getCause() == Cause::Fs) {
+      return folly::Executor::HI_PRI;
+    }
+    return folly::Executor::MID_PRI;
+  }
+
   virtual const std::unordered_map<std::string, std::string>* getRequestInfo()
       const = 0;
 
@@ -102,6 +122,20 @@ class ObjectFetchContext : public RefCounted {
    */
   virtual void deprioritize(uint64_t) {}
 
+  /**
+   * A token that becomes signalled when the client that triggered this fetch
+   * is no longer waiting for the result, e.g. a FUSE request that received
+   * FUSE_INTERRUPT. Backing stores may drop a still-queued fetch once every
+   * context subscribed to it has requested cancellation, freeing the import
+   * slot for live work.
+   *
+   * The default token can never be signalled, so fetches from contexts that
+   * do not override this (Thrift, prefetch) are never dropped.
+   */
+  virtual folly::CancellationToken getCancellationToken() const {
+    return {};
+  }
+
   /**
    * Return a no-op fetch context suitable when no tracking is desired.
    */
@@ -19,6 +19,7 @@
 #include "eden/fs/store/LocalStore.h"
 #include "eden/fs/store/ObjectFetchContext.h"
 #include "eden/fs/telemetry/EdenStats.h"
+#include "eden/fs/telemetry/RequestProbes.h"
 #include "eden/fs/utils/ImmediateFuture.h"
 #include "eden/fs/utils/Throw.h"
 
@@ -32,7 +33,33 @@ namespace facebook::eden {
 
 namespace {
 constexpr uint64_t kImportPriorityDeprioritizeAmount = 1;
-}
+
+constexpr std::string_view kTreeReadaheadCauseDetail = "tree-readahead";
+
+/**
+ * Fetch context for speculative child-tree readahead. Uses a low import
+ * priority so warming the cache never competes with interactive requests.
+ */
+class TreeReadaheadFetchContext : public ObjectFetchContext {
+ public:
+  Cause getCause() const override {
+    return Cause::Prefetch;
+  }
+
+  std::optional<std::string_view> getCauseDetail() const override {
+    return kTreeReadaheadCauseDetail;
+  }
+
+  ImportPriority getPriority() const override {
+    return ImportPriority{ImportPriority::Class::Low};
+  }
+
+  const std::unordered_map<std::string, std::string>* getRequestInfo()
+      const override {
+    return nullptr;
+  }
+};
+} // namespace
 
 std::shared_ptr<ObjectStore> ObjectStore::create(
     shared_ptr<LocalStore> localStore,
@@ -64,6 +91,7 @@ ObjectStore::ObjectStore(
     std::shared_ptr<const EdenConfig> edenConfig,
     CaseSensitivity caseSensitive)
     : metadataCache_{folly::in_place, kCacheSize},
+      negativeMetadataCache_{folly::in_place, kNegativeCacheSize},
       treeCache_{std::move(treeCache)},
       localStore_{std::move(localStore)},
       backingStore_{std::move(backingStore)},
@@ -83,6 +111,10 @@ ObjectStore::~ObjectStore() {}
 void ObjectStore::updateProcessFetch(
     const ObjectFetchContext& fetchContext) const {
   if (auto pid = fetchContext.getClientPid()) {
+    if (edenConfig_->fetchDeprioritizeMaxFactor.getValue() != 0) {
+      pidFetchCounts_->maybeDecay(
+          edenConfig_->fetchCountDecayInterval.getValue());
+    }
     auto fetch_count = pidFetchCounts_->recordProcessFetch(pid.value());
     auto threshold = edenConfig_->fetchHeavyThreshold.getValue();
     // indicate heavy event when fetch_count reaches multiple of threshold
@@ -113,7 +145,18 @@ void ObjectStore::deprioritizeWhenFetchHeavy(
     auto fetch_count = pidFetchCounts_->getCountByPid(pid.value());
     auto threshold = edenConfig_->fetchHeavyThreshold.getValue();
     if (threshold && fetch_count >= threshold) {
-      context.deprioritize(kImportPriorityDeprioritizeAmount);
+      // When graduated deprioritization is enabled, each further threshold's
+      // worth of fetches from this process sinks its subsequent requests one
+      // more step in the import queue, so heavier consumers always queue
+      // behind lighter ones of the same priority class. Combined with the
+      // periodic decay of the counts this approximates fair queuing weighted
+      // by recent fetch rate.
+      auto maxFactor = edenConfig_->fetchDeprioritizeMaxFactor.getValue();
+      uint64_t factor = 1;
+      if (maxFactor != 0) {
+        factor = std::min<uint64_t>(fetch_count / threshold, maxFactor);
+      }
+      context.deprioritize(kImportPriorityDeprioritizeAmount * factor);
     }
   }
 }
@@ -215,6 +258,8 @@ ImmediateFuture<shared_ptr<const Tree>> ObjectStore::getTree(
   // we could avoid that case.
 
   if (auto maybeTree = treeCache_->get(id)) {
+    recordFetchOrigin(
+        ObjectFetchContext::Tree, ObjectFetchContext::FromMemoryCache);
     fetchContext->didFetch(
         ObjectFetchContext::Tree, id, ObjectFetchContext::FromMemoryCache);
 
@@ -225,6 +270,11 @@ ImmediateFuture<shared_ptr<const Tree>> ObjectStore::getTree(
 
   deprioritizeWhenFetchHeavy(*fetchContext);
 
+  EDEN_SDT(
+      object_fetch,
+      static_cast<uint32_t>(ObjectFetchContext::Tree),
+      static_cast<uint32_t>(fetchContext->getCause()));
+
   return ImmediateFuture{backingStore_->getTree(id, fetchContext)}.thenValue(
       [self = shared_from_this(),
        statScope = std::move(statScope),
@@ -240,26 +290,238 @@ ImmediateFuture<shared_ptr<const Tree>> ObjectStore::getTree(
         // promote to shared_ptr so we can store in the cache and return
         auto sharedTree = std::shared_ptr<const Tree>(std::move(result.tree));
         self->treeCache_->insert(sharedTree);
+        self->recordFetchOrigin(ObjectFetchContext::Tree, result.origin);
         fetchContext->didFetch(ObjectFetchContext::Tree, id, result.origin);
         self->updateProcessFetch(*fetchContext);
+        self->maybeReadaheadChildTrees(sharedTree, *fetchContext);
         return changeCaseSensitivity(sharedTree, self->caseSensitive_);
       });
 }
 
+void ObjectStore::maybeReadaheadChildTrees(
+    const std::shared_ptr<const Tree>& tree,
+    const ObjectFetchContext& context) const {
+  if (!edenConfig_->warmTreeCacheChildren.getValue()) {
+    return;
+  }
+  // Trees fetched by the readahead itself must not fan out further, otherwise
+  // a single fetch could speculatively pull in an entire subtree recursively.
+  if (context.getCauseDetail() == kTreeReadaheadCauseDetail) {
+    return;
+  }
+
+  size_t entryCount = 0;
+  std::vector<ObjectId> childTrees;
+  for (const auto& entry : *tree) {
+    ++entryCount;
+    if (entry.second.isTree()) {
+      childTrees.push_back(entry.second.getHash());
+    }
+  }
+  // Only directories that mostly contain subdirectories are worth warming:
+  // those are the ones a recursive walk will descend into next.
+  if (childTrees.empty() || childTrees.size() * 2 < entryCount) {
+    return;
+  }
+
+  auto readaheadContext = makeRefPtr<TreeReadaheadFetchContext>();
+  std::vector<ImmediateFuture<folly::Unit>> futures;
+  for (const auto& childId : childTrees) {
+    if (treeCache_->contains(childId)) {
+      continue;
+    }
+    futures.push_back(
+        getTree(childId, readaheadContext.as<ObjectFetchContext>())
+            .thenTry([childId](folly::Try<std::shared_ptr<const Tree>> result) {
+              if (result.hasException()) {
+                XLOG(DBG4) << "speculative readahead of tree " << childId
+                           << " failed: " << result.exception().what();
+              }
+            }));
+  }
+  if (futures.empty()) {
+    return;
+  }
+  XLOG(DBG4) << "readahead of " << futures.size() << " subtrees of "
+             << tree->getHash();
+  folly::futures::detachOnGlobalCPUExecutor(
+      collectAll(std::move(futures)).semi().unit());
+}
+
+ImmediateFuture<std::vector<shared_ptr<const Tree>>> ObjectStore::getTrees(
+    const std::vector<ObjectId>& ids,
+    const ObjectFetchContextPtr& fetchContext) const {
+  // Serve in-memory cache hits inline, then read everything else from the
+  // local store as one MultiGet, so a warm crawl pays a single batched
+  // RocksDB read rather than a point lookup and future chain per tree.
+  std::vector<shared_ptr<const Tree>> results(ids.size());
+  std::vector<size_t> missingIndices;
+  std::vector<ObjectId> missingIds;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (auto maybeTree = treeCache_->get(ids[i])) {
+      recordFetchOrigin(
+          ObjectFetchContext::Tree, ObjectFetchContext::FromMemoryCache);
+      fetchContext->didFetch(
+          ObjectFetchContext::Tree, ids[i], ObjectFetchContext::FromMemoryCache);
+      updateProcessFetch(*fetchContext);
+      results[i] = changeCaseSensitivity(std::move(maybeTree), caseSensitive_);
+    } else {
+      missingIndices.push_back(i);
+      missingIds.push_back(ids[i]);
+    }
+  }
+  if (missingIds.empty()) {
+    return results;
+  }
+
+  deprioritizeWhenFetchHeavy(*fetchContext);
+
+  auto self = shared_from_this();
+  return localStore_->getTrees(missingIds)
+      .thenValue(
+          [self,
+           results = std::move(results),
+           missingIndices = std::move(missingIndices),
+           missingIds = std::move(missingIds),
+           fetchContext = fetchContext.copy()](
+              std::vector<std::unique_ptr<Tree>> localTrees) mutable
+          -> ImmediateFuture<std::vector<shared_ptr<const Tree>>> {
+            std::vector<ImmediateFuture<shared_ptr<const Tree>>> stillMissing;
+            std::vector<size_t> stillMissingIndices;
+            for (size_t j = 0; j < localTrees.size(); ++j) {
+              auto idx = missingIndices[j];
+              if (localTrees[j]) {
+                auto sharedTree =
+                    std::shared_ptr<const Tree>(std::move(localTrees[j]));
+                self->treeCache_->insert(sharedTree);
+                self->recordFetchOrigin(
+                    ObjectFetchContext::Tree, ObjectFetchContext::FromDiskCache);
+                fetchContext->didFetch(
+                    ObjectFetchContext::Tree,
+                    missingIds[j],
+                    ObjectFetchContext::FromDiskCache);
+                self->updateProcessFetch(*fetchContext);
+                // No child-tree readahead here: batch callers enumerate
+                // their own walk, so speculatively warming children would
+                // just fetch the next level twice.
+                results[idx] = changeCaseSensitivity(
+                    std::move(sharedTree), self->caseSensitive_);
+              } else {
+                // Kick off every remaining fetch before waiting on any of
+                // them. getTree() enqueues its BackingStore request
+                // synchronously, so the entire miss set lands in the import
+                // queue where it can be fetched as a single batch. The
+                // point read getTree() repeats against the local store is
+                // noise next to the import itself.
+                stillMissingIndices.push_back(idx);
+                stillMissing.push_back(
+                    self->getTree(missingIds[j], fetchContext));
+              }
+            }
+            if (stillMissing.empty()) {
+              return std::move(results);
+            }
+            return collectAllSafe(std::move(stillMissing))
+                .thenValue(
+                    [results = std::move(results),
+                     stillMissingIndices = std::move(stillMissingIndices)](
+                        std::vector<shared_ptr<const Tree>> fetched) mutable {
+                      for (size_t j = 0; j < fetched.size(); ++j) {
+                        results[stillMissingIndices[j]] = std::move(fetched[j]);
+                      }
+                      return std::move(results);
+                    });
+          });
+}
+
+ImmediateFuture<std::vector<shared_ptr<const Blob>>> ObjectStore::getBlobs(
+    const std::vector<ObjectId>& ids,
+    const ObjectFetchContextPtr& fetchContext) const {
+  if (ids.empty()) {
+    return std::vector<shared_ptr<const Blob>>{};
+  }
+
+  deprioritizeWhenFetchHeavy(*fetchContext);
+
+  // Read the whole batch from the local store as one MultiGet. Blobs have
+  // no in-memory cache tier, so on a warm repository this replaces a point
+  // lookup and future chain per blob with a single batched RocksDB read.
+  auto self = shared_from_this();
+  return localStore_->getBlobs(ids)
+      .thenValue(
+          [self, ids, fetchContext = fetchContext.copy()](
+              std::vector<std::unique_ptr<Blob>> localBlobs) mutable
+          -> ImmediateFuture<std::vector<shared_ptr<const Blob>>> {
+            std::vector<shared_ptr<const Blob>> results(ids.size());
+            std::vector<ImmediateFuture<shared_ptr<const Blob>>> stillMissing;
+            std::vector<size_t> stillMissingIndices;
+            for (size_t i = 0; i < ids.size(); ++i) {
+              if (!localBlobs[i]) {
+                // As in getTrees, issue every miss eagerly so the whole set
+                // coalesces in the import queue. The miss also gives
+                // LocalStoreCachedBackingStore its chance at the SHA-1
+                // re-key lookup the batch read skips.
+                stillMissingIndices.push_back(i);
+                stillMissing.push_back(self->getBlob(ids[i], fetchContext));
+                continue;
+              }
+              auto blob = std::shared_ptr<const Blob>(std::move(localBlobs[i]));
+              // Mirror the single-blob path: make sure the metadata caches
+              // cover every blob we hand out.
+              if (!self->metadataCache_.rlock()->exists(ids[i])) {
+                auto metadata = computeBlobMetadata(*blob);
+                self->localStore_->putBlobMetadata(ids[i], metadata);
+                self->metadataCache_.wlock()->set(ids[i], metadata);
+                self->negativeMetadataCache_.wlock()->erase(ids[i]);
+              }
+              self->stats_->increment(&ObjectStoreStats::getBlobFromLocalStore);
+              self->updateProcessFetch(*fetchContext);
+              self->recordFetchOrigin(
+                  ObjectFetchContext::Blob, ObjectFetchContext::FromDiskCache);
+              fetchContext->didFetch(
+                  ObjectFetchContext::Blob,
+                  ids[i],
+                  ObjectFetchContext::FromDiskCache);
+              results[i] = std::move(blob);
+            }
+            if (stillMissing.empty()) {
+              return std::move(results);
+            }
+            return collectAllSafe(std::move(stillMissing))
+                .thenValue(
+                    [results = std::move(results),
+                     stillMissingIndices = std::move(stillMissingIndices)](
+                        std::vector<shared_ptr<const Blob>> fetched) mutable {
+                      for (size_t j = 0; j < fetched.size(); ++j) {
+                        results[stillMissingIndices[j]] = std::move(fetched[j]);
+                      }
+                      return std::move(results);
+                    });
+          });
+}
+
 ImmediateFuture<folly::Unit> ObjectStore::prefetchBlobs(
     ObjectIdRange ids,
     const ObjectFetchContextPtr& fetchContext) const {
-  // In theory we could/should ask the localStore_ to filter the list
-  // of ids down to just the set that we need to load, but there is no
-  // bulk key existence check in rocksdb, so we would need to cause it
-  // to load all the blocks of those keys into memory.
-  // So for the moment we are committing a layering violation in the
-  // interest of making things faster in practice by just asking the
-  // mercurial backing store to ensure that its local hgcache storage
-  // has entries for all of the requested keys.
   if (ids.empty()) {
     return folly::unit;
   }
+  if (localStore_->enableBlobCaching.load(std::memory_order_relaxed)) {
+    // Strip blobs the local store already has before asking the backing
+    // store to warm its cache. The presence filter makes repeated sweeps
+    // over a warm repository cheap; its rare false positives only skip a
+    // prefetch, and the blob is fetched on demand if it is ever read.
+    auto missing = localStore_->filterMissing(KeySpace::BlobFamily, ids);
+    if (missing.empty()) {
+      return folly::unit;
+    }
+    if (missing.size() != ids.size()) {
+      auto range = ObjectIdRange{missing.data(), missing.size()};
+      return ImmediateFuture<folly::Unit>{
+          backingStore_->prefetchBlobs(range, fetchContext)}
+          .ensure([missing = std::move(missing)] {});
+    }
+  }
   return backingStore_->prefetchBlobs(ids, fetchContext);
 }
 
@@ -269,35 +531,44 @@ ImmediateFuture<shared_ptr<const Blob>> ObjectStore::getBlob(
   DurationScope statScope{stats_, &ObjectStoreStats::getBlob};
 
   deprioritizeWhenFetchHeavy(*fetchContext);
+  auto continuation =
+      [self = shared_from_this(),
+       statScope = std::move(statScope),
+       id,
+       fetchContext = fetchContext.copy()](BackingStore::GetBlobResult result)
+      -> std::shared_ptr<const Blob> {
+    if (!result.blob) {
+      // TODO: Perhaps we should do some short-term negative caching?
+      XLOG(DBG2) << "unable to find blob " << id;
+      throwf<std::domain_error>("blob {} not found", id);
+    }
+    // Quick check in-memory cache first, before doing expensive
+    // calculations. If metadata is present in cache, it most certainly
+    // exists in local store too.
+    // We always cache metadata in LocalStore because it's faster to
+    // query than the BackingStore, and metadata is very small (~28
+    // bytes per blob).
+    if (!self->metadataCache_.rlock()->exists(id)) {
+      auto metadata = computeBlobMetadata(*result.blob);
+      self->localStore_->putBlobMetadata(id, metadata);
+      self->metadataCache_.wlock()->set(id, metadata);
+      self->negativeMetadataCache_.wlock()->erase(id);
+    }
+    self->updateProcessFetch(*fetchContext);
+    self->recordFetchOrigin(ObjectFetchContext::Blob, result.origin);
+    fetchContext->didFetch(ObjectFetchContext::Blob, id, result.origin);
+    return std::move(result.blob);
+  };
+  // This chain always defers: getBlob goes to the backing store, so the
+  // continuation capture size directly controls the per-fetch allocation.
+  EDEN_ASSERT_CONTINUATION_CAPTURE_LE(continuation, 128);
+  EDEN_SDT(
+      object_fetch,
+      static_cast<uint32_t>(ObjectFetchContext::Blob),
+      static_cast<uint32_t>(fetchContext->getCause()));
   return ImmediateFuture<BackingStore::GetBlobResult>{
       backingStore_->getBlob(id, fetchContext)}
-      .thenValue(
-          [self = shared_from_this(),
-           statScope = std::move(statScope),
-           id,
-           fetchContext =
-               fetchContext.copy()](BackingStore::GetBlobResult result)
-              -> std::shared_ptr<const Blob> {
-            if (!result.blob) {
-              // TODO: Perhaps we should do some short-term negative caching?
-              XLOG(DBG2) << "unable to find blob " << id;
-              throwf<std::domain_error>("blob {} not found", id);
-            }
-            // Quick check in-memory cache first, before doing expensive
-            // calculations. If metadata is present in cache, it most certainly
-            // exists in local store too.
-            // We always cache metadata in LocalStore because it's faster to
-            // query than the BackingStore, and metadata is very small (~28
-            // bytes per blob).
-            if (!self->metadataCache_.rlock()->exists(id)) {
-              auto metadata = computeBlobMetadata(*result.blob);
-              self->localStore_->putBlobMetadata(id, metadata);
-              self->metadataCache_.wlock()->set(id, metadata);
-            }
-            self->updateProcessFetch(*fetchContext);
-            fetchContext->didFetch(ObjectFetchContext::Blob, id, result.origin);
-            return std::move(result.blob);
-          });
+      .thenValue(std::move(continuation));
 }
 
 ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
@@ -307,10 +578,15 @@ ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
 
   // Check in-memory cache
   {
+    SampledDurationScope stageScope{
+        stats_.get(), &StageStats::objectStoreCacheProbe};
     auto metadataCache = metadataCache_.wlock();
     auto cacheIter = metadataCache->find(id);
     if (cacheIter != metadataCache->end()) {
       stats_->increment(&ObjectStoreStats::getBlobMetadataFromMemory);
+      recordFetchOrigin(
+          ObjectFetchContext::BlobMetadata,
+          ObjectFetchContext::FromMemoryCache);
       context->didFetch(
           ObjectFetchContext::BlobMetadata,
           id,
@@ -321,6 +597,23 @@ ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
     }
   }
 
+  // If this ID was found missing a moment ago, fail fast rather than walking
+  // the LocalStore and import path again just to rediscover the miss.
+  {
+    auto negativeCache = negativeMetadataCache_.wlock();
+    auto negativeIter = negativeCache->find(id);
+    if (negativeIter != negativeCache->end()) {
+      if (std::chrono::steady_clock::now() - negativeIter->second <
+          kNegativeCacheTTL) {
+        stats_->increment(
+            &ObjectStoreStats::getBlobMetadataMissFromNegativeCache);
+        return makeImmediateFuture<BlobMetadata>(
+            std::domain_error{fmt::format("blob {} not found", id)});
+      }
+      negativeCache->erase(negativeIter);
+    }
+  }
+
   auto self = shared_from_this();
 
   // Check local store
@@ -336,6 +629,9 @@ ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
               self->stats_->increment(
                   &ObjectStoreStats::getBlobMetadataFromLocalStore);
               self->metadataCache_.wlock()->set(id, *metadata);
+              self->recordFetchOrigin(
+                  ObjectFetchContext::BlobMetadata,
+                  ObjectFetchContext::FromDiskCache);
               context->didFetch(
                   ObjectFetchContext::BlobMetadata,
                   id,
@@ -354,6 +650,9 @@ ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
                   &ObjectStoreStats::getLocalBlobMetadataFromBackingStore);
               self->metadataCache_.wlock()->set(id, *localMetadata);
               self->localStore_->putBlobMetadata(id, *localMetadata);
+              self->recordFetchOrigin(
+                  ObjectFetchContext::BlobMetadata,
+                  ObjectFetchContext::FromDiskCache);
               context->didFetch(
                   ObjectFetchContext::BlobMetadata,
                   id,
@@ -396,6 +695,8 @@ ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
                     // useful in context to know how many metadata fetches
                     // occurred. Also, since backing stores don't directly
                     // support fetching metadata, it should be clear.
+                    self->recordFetchOrigin(
+                        ObjectFetchContext::BlobMetadata, result.origin);
                     context->didFetch(
                         ObjectFetchContext::BlobMetadata, id, result.origin);
 
@@ -403,6 +704,8 @@ ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
                     return makeFuture(metadata);
                   }
 
+                  self->negativeMetadataCache_.wlock()->set(
+                      id, std::chrono::steady_clock::now());
                   throwf<std::domain_error>("blob {} not found", id);
                 })
                 .semi();
@@ -410,6 +713,18 @@ ImmediateFuture<BlobMetadata> ObjectStore::getBlobMetadata(
       .semi();
 }
 
+ImmediateFuture<std::vector<BlobMetadata>> ObjectStore::getBlobMetadatas(
+    const std::vector<ObjectId>& ids,
+    const ObjectFetchContextPtr& fetchContext) const {
+  // See getTrees for why all the fetches are issued eagerly.
+  std::vector<ImmediateFuture<BlobMetadata>> futures;
+  futures.reserve(ids.size());
+  for (const auto& id : ids) {
+    futures.push_back(getBlobMetadata(id, fetchContext));
+  }
+  return collectAllSafe(std::move(futures));
+}
+
 ImmediateFuture<uint64_t> ObjectStore::getBlobSize(
     const ObjectId& id,
     const ObjectFetchContextPtr& context) const {
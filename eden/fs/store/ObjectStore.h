@@ -9,6 +9,9 @@
 
 #include <folly/Synchronized.h>
 #include <folly/container/EvictingCacheMap.h>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <unordered_map>
 
@@ -55,6 +58,34 @@ struct PidFetchCounts {
       return 0;
     }
   }
+
+  /**
+   * Halve every process's fetch count once `interval` has elapsed since the
+   * last decay, dropping counts that reach zero. Used by the graduated
+   * fetch-heavy deprioritization so the penalty tracks a process's recent
+   * fetch rate rather than its lifetime total. lastDecay_ is only accessed
+   * while holding the map lock.
+   */
+  void maybeDecay(std::chrono::nanoseconds interval) {
+    auto now = std::chrono::steady_clock::now();
+    auto map_lock = map_.wlock();
+    if (now - lastDecay_ < interval) {
+      return;
+    }
+    lastDecay_ = now;
+    for (auto it = map_lock->begin(); it != map_lock->end();) {
+      it->second /= 2;
+      if (it->second == 0) {
+        it = map_lock->erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+ private:
+  std::chrono::steady_clock::time_point lastDecay_{
+      std::chrono::steady_clock::now()};
 };
 
 /**
@@ -108,6 +139,18 @@ class ObjectStore : public IObjectStore,
    */
   void deprioritizeWhenFetchHeavy(ObjectFetchContext& context) const;
 
+  /**
+   * Number of objects of the given type this mount has fetched from the
+   * given origin since the ObjectStore was created. The ObjectStore is
+   * per-mount, so these give a mount-level cache-effectiveness breakdown
+   * (memory cache vs disk caches vs network) without log scraping.
+   */
+  uint64_t getFetchCountByOrigin(
+      ObjectFetchContext::ObjectType type,
+      ObjectFetchContext::Origin origin) const {
+    return fetchCountsByOrigin_[type][origin].load(std::memory_order_relaxed);
+  }
+
   /**
    * Each BackingStore implementation defines its interpretation of root IDs.
    * This function gives the BackingStore a chance to parse and canonicalize the
@@ -168,6 +211,21 @@ class ObjectStore : public IObjectStore,
       const ObjectId& id,
       const ObjectFetchContextPtr& context) const override;
 
+  /**
+   * Get multiple Trees by ID in one call.
+   *
+   * In-memory cache hits are served inline, everything else is read from
+   * the LocalStore as a single batched (MultiGet) lookup, and only the
+   * trees missing from both tiers go to the BackingStore. Those remaining
+   * requests are all issued before any result is awaited, which lets the
+   * BackingStore's import queue batch and coalesce the whole set instead
+   * of seeing one request at a time interleaved with future callbacks.
+   * The returned Trees are in the same order as the passed in IDs.
+   */
+  ImmediateFuture<std::vector<std::shared_ptr<const Tree>>> getTrees(
+      const std::vector<ObjectId>& ids,
+      const ObjectFetchContextPtr& context) const;
+
   /**
    * Prefetch all the blobs represented by the HashRange.
    *
@@ -189,6 +247,19 @@ class ObjectStore : public IObjectStore,
       const ObjectId& id,
       const ObjectFetchContextPtr& context) const override;
 
+  /**
+   * Get multiple Blobs by ID in one call.
+   *
+   * Like getTrees, this reads the whole batch from the LocalStore with one
+   * MultiGet and issues the remaining backing store requests up front, so a
+   * readdir-triggered prefetch of many files turns into one batched local
+   * read plus a small number of batched imports rather than one lookup per
+   * blob. The returned Blobs are in the same order as the passed in IDs.
+   */
+  ImmediateFuture<std::vector<std::shared_ptr<const Blob>>> getBlobs(
+      const std::vector<ObjectId>& ids,
+      const ObjectFetchContextPtr& context) const;
+
   /**
    * Get metadata about a Blob.
    *
@@ -200,6 +271,18 @@ class ObjectStore : public IObjectStore,
       const ObjectId& id,
       const ObjectFetchContextPtr& context) const;
 
+  /**
+   * Get metadata about multiple Blobs in one call.
+   *
+   * Like getTrees and getBlobs, this issues all the fetches up front so that
+   * a readdirplus over a wide directory turns into one batched import rather
+   * than one import per entry. The returned metadata is in the same order as
+   * the passed in IDs.
+   */
+  ImmediateFuture<std::vector<BlobMetadata>> getBlobMetadatas(
+      const std::vector<ObjectId>& ids,
+      const ObjectFetchContextPtr& context) const;
+
   /**
    * Returns the size of the contents of the blob with the given ID.
    */
@@ -256,6 +339,22 @@ class ObjectStore : public IObjectStore,
   }
 
  private:
+  void recordFetchOrigin(
+      ObjectFetchContext::ObjectType type,
+      ObjectFetchContext::Origin origin) const {
+    fetchCountsByOrigin_[type][origin].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * If tree readahead is enabled and the passed in tree consists mostly of
+   * subtrees, kick off low-priority background fetches to warm those
+   * subtrees into the TreeCache. Directory walks otherwise serialize on a
+   * full fetch round trip per tree depth level.
+   */
+  void maybeReadaheadChildTrees(
+      const std::shared_ptr<const Tree>& tree,
+      const ObjectFetchContext& context) const;
+
   // Forbidden constructor. Use create().
   ObjectStore(
       std::shared_ptr<LocalStore> localStore,
@@ -289,6 +388,21 @@ class ObjectStore : public IObjectStore,
   mutable folly::Synchronized<folly::EvictingCacheMap<ObjectId, BlobMetadata>>
       metadataCache_;
 
+  static constexpr size_t kNegativeCacheSize = 100000;
+  static constexpr std::chrono::seconds kNegativeCacheTTL{10};
+
+  /**
+   * During status storms on freshly-rebased commits, the same missing blob
+   * metadata is frequently looked up again milliseconds after a miss. Each
+   * such miss walks the full LocalStore + importer path before failing again.
+   * Remember recent misses with a short TTL so repeated dead lookups
+   * short-circuit before touching RocksDB or the import queue. Entries are
+   * invalidated whenever metadata for the ID is successfully stored.
+   */
+  mutable folly::Synchronized<
+      folly::EvictingCacheMap<ObjectId, std::chrono::steady_clock::time_point>>
+      negativeMetadataCache_;
+
   /**
    * During glob, we need to read a lot of trees, but we avoid loading inodes,
    * so this means we go to RocksDB for each tree read. To avoid needing to hit
@@ -322,6 +436,15 @@ class ObjectStore : public IObjectStore,
    * from the beginning of the eden daemon progress */
   std::unique_ptr<PidFetchCounts> pidFetchCounts_;
 
+  /**
+   * Fetch counts indexed by object type and origin; bumped wherever a fetch
+   * completion is reported to the fetch context. See getFetchCountByOrigin().
+   */
+  mutable std::array<
+      std::array<std::atomic<uint64_t>, ObjectFetchContext::kOriginEnumMax>,
+      ObjectFetchContext::kObjectTypeEnumMax>
+      fetchCountsByOrigin_{};
+
   /* process name cache and structured logger used for
    * sending fetch heavy events, set to nullptr if not
    * initialized by create()
@@ -6,6 +6,7 @@
  */
 
 #include "eden/fs/store/PathLoader.h"
+#include <unordered_map>
 #include <vector>
 #include "eden/fs/model/Tree.h"
 #include "eden/fs/service/gen-cpp2/eden_constants.h"
@@ -58,6 +59,120 @@ ImmediateFuture<std::shared_ptr<const Tree>> resolveTree(
       });
 }
 
+struct BulkResolveContext {
+  struct PathState {
+    std::vector<PathComponent> components;
+    /** Tree reached so far; the final result once every component is
+     * consumed. */
+    std::shared_ptr<const Tree> tree;
+    /** Next component to look up within `tree`. */
+    size_t index = 0;
+    bool done = false;
+    folly::Try<std::shared_ptr<const Tree>> result;
+  };
+  std::vector<PathState> paths;
+};
+
+/**
+ * Advance every unfinished path by one level: look up each path's next
+ * component in its current tree, fetch the distinct child trees needed
+ * across all paths as one concurrent batch, and recurse until every path is
+ * either resolved or failed.
+ */
+ImmediateFuture<std::vector<folly::Try<std::shared_ptr<const Tree>>>>
+resolveTreesLevel(
+    std::shared_ptr<BulkResolveContext> ctx,
+    ObjectStore& objectStore,
+    const ObjectFetchContextPtr& fetchContext) {
+  // Distinct tree ids needed at this level, and which paths want each one.
+  std::vector<ObjectId> ids;
+  std::unordered_map<ObjectId, std::vector<size_t>> subscribers;
+
+  for (size_t pathIndex = 0; pathIndex < ctx->paths.size(); ++pathIndex) {
+    auto& state = ctx->paths[pathIndex];
+    if (state.done) {
+      continue;
+    }
+    if (state.index == state.components.size()) {
+      state.done = true;
+      state.result =
+          folly::Try<std::shared_ptr<const Tree>>{std::move(state.tree)};
+      continue;
+    }
+
+    const auto& name = state.components[state.index];
+    auto child = state.tree->find(name);
+    if (child == state.tree->end()) {
+      state.done = true;
+      state.result =
+          folly::Try<std::shared_ptr<const Tree>>{folly::exception_wrapper{
+              newEdenError(
+                  ENOENT,
+                  EdenErrorType::POSIX_ERROR,
+                  "no child with name ",
+                  name)}};
+      continue;
+    }
+    if (!child->second.isTree()) {
+      state.done = true;
+      state.result =
+          folly::Try<std::shared_ptr<const Tree>>{folly::exception_wrapper{
+              newEdenError(
+                  ENOTDIR,
+                  EdenErrorType::POSIX_ERROR,
+                  "child is not tree ",
+                  name)}};
+      continue;
+    }
+
+    auto [it, inserted] =
+        subscribers.try_emplace(child->second.getHash());
+    if (inserted) {
+      ids.push_back(child->second.getHash());
+    }
+    it->second.push_back(pathIndex);
+  }
+
+  if (ids.empty()) {
+    std::vector<folly::Try<std::shared_ptr<const Tree>>> results;
+    results.reserve(ctx->paths.size());
+    for (auto& state : ctx->paths) {
+      results.push_back(std::move(state.result));
+    }
+    return results;
+  }
+
+  std::vector<ImmediateFuture<std::shared_ptr<const Tree>>> fetches;
+  fetches.reserve(ids.size());
+  for (const auto& id : ids) {
+    fetches.push_back(objectStore.getTree(id, fetchContext));
+  }
+
+  return collectAll(std::move(fetches))
+      .thenValue([ctx = std::move(ctx),
+                  &objectStore,
+                  fetchContext = fetchContext.copy(),
+                  ids = std::move(ids),
+                  subscribers = std::move(subscribers)](
+                     std::vector<folly::Try<std::shared_ptr<const Tree>>>&&
+                         trees) mutable {
+        for (size_t i = 0; i < ids.size(); ++i) {
+          for (auto pathIndex : subscribers[ids[i]]) {
+            auto& state = ctx->paths[pathIndex];
+            if (trees[i].hasException()) {
+              state.done = true;
+              state.result = folly::Try<std::shared_ptr<const Tree>>{
+                  trees[i].exception()};
+            } else {
+              state.tree = trees[i].value();
+              ++state.index;
+            }
+          }
+        }
+        return resolveTreesLevel(std::move(ctx), objectStore, fetchContext);
+      });
+}
+
 } // namespace
 
 ImmediateFuture<std::shared_ptr<const Tree>> resolveTree(
@@ -76,4 +191,23 @@ ImmediateFuture<std::shared_ptr<const Tree>> resolveTree(
       std::move(ctx), objectStore, fetchContext, std::move(root), 0);
 }
 
+ImmediateFuture<std::vector<folly::Try<std::shared_ptr<const Tree>>>>
+resolveTrees(
+    ObjectStore& objectStore,
+    const ObjectFetchContextPtr& fetchContext,
+    std::shared_ptr<const Tree> root,
+    const std::vector<RelativePath>& paths) {
+  auto ctx = std::make_shared<BulkResolveContext>();
+  ctx->paths.reserve(paths.size());
+  for (const auto& path : paths) {
+    auto& state = ctx->paths.emplace_back();
+    for (auto c : path.components()) {
+      state.components.emplace_back(c);
+    }
+    state.tree = root;
+  }
+
+  return resolveTreesLevel(std::move(ctx), objectStore, fetchContext);
+}
+
 } // namespace facebook::eden
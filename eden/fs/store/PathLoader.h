@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <folly/Try.h>
+#include <vector>
 #include "eden/fs/store/ObjectFetchContext.h"
 #include "eden/fs/utils/ImmediateFuture.h"
 #include "eden/fs/utils/PathFuncs.h"
@@ -22,4 +24,24 @@ ImmediateFuture<std::shared_ptr<const Tree>> resolveTree(
     std::shared_ptr<const Tree> root,
     RelativePathPiece path);
 
+/**
+ * Resolve many paths against the same root in one walk.
+ *
+ * All paths advance level by level in lockstep: at each level the distinct
+ * child trees needed across every path are fetched as one concurrent batch,
+ * so paths sharing a prefix load each tree once instead of each walking from
+ * the root independently.
+ *
+ * Results are returned in the same order as the input paths. Each path
+ * resolves or fails independently; a path whose component is missing (ENOENT)
+ * or is not a tree (ENOTDIR) carries that error in its Try without affecting
+ * the other paths.
+ */
+ImmediateFuture<std::vector<folly::Try<std::shared_ptr<const Tree>>>>
+resolveTrees(
+    ObjectStore& objectStore,
+    const ObjectFetchContextPtr& fetchContext,
+    std::shared_ptr<const Tree> root,
+    const std::vector<RelativePath>& paths);
+
 } // namespace facebook::eden
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/PeerCachedBackingStore.h"
+
+#include <folly/io/IOBuf.h>
+
+#include "eden/fs/model/Blob.h"
+#include "eden/fs/model/Tree.h"
+#include "eden/fs/store/PeerObjectCache.h"
+#include "eden/fs/telemetry/EdenStats.h"
+#include "eden/fs/utils/ImmediateFuture.h"
+
+namespace facebook::eden {
+
+PeerCachedBackingStore::PeerCachedBackingStore(
+    std::shared_ptr<BackingStore> backingStore,
+    std::shared_ptr<PeerObjectCache> peerCache,
+    std::shared_ptr<EdenStats> stats)
+    : backingStore_{std::move(backingStore)},
+      peerCache_{std::move(peerCache)},
+      stats_{std::move(stats)} {}
+
+PeerCachedBackingStore::~PeerCachedBackingStore() {}
+
+std::string PeerCachedBackingStore::cacheKey(
+    folly::StringPiece kind,
+    const ObjectId& id) {
+  std::string key;
+  if (auto repoName = backingStore_->getRepoName()) {
+    key.append(repoName->data(), repoName->size());
+  }
+  key.push_back('/');
+  key.append(kind.data(), kind.size());
+  key.push_back('/');
+  key.append(backingStore_->renderObjectId(id));
+  return key;
+}
+
+ObjectComparison PeerCachedBackingStore::compareObjectsById(
+    const ObjectId& one,
+    const ObjectId& two) {
+  return backingStore_->compareObjectsById(one, two);
+}
+
+ImmediateFuture<std::unique_ptr<Tree>> PeerCachedBackingStore::getRootTree(
+    const RootId& rootId,
+    const ObjectFetchContextPtr& context) {
+  return backingStore_->getRootTree(rootId, context);
+}
+
+ImmediateFuture<std::unique_ptr<TreeEntry>>
+PeerCachedBackingStore::getTreeEntryForObjectId(
+    const ObjectId& objectId,
+    TreeEntryType treeEntryType,
+    const ObjectFetchContextPtr& context) {
+  return backingStore_->getTreeEntryForObjectId(
+      objectId, treeEntryType, context);
+}
+
+folly::SemiFuture<BackingStore::GetTreeResult>
+PeerCachedBackingStore::getTree(
+    const ObjectId& id,
+    const ObjectFetchContextPtr& context) {
+  auto key = cacheKey("tree", id);
+  return peerCache_->get(key)
+      .deferValue([id = id,
+                   key = std::move(key),
+                   context = context.copy(),
+                   peerCache = peerCache_,
+                   backingStore = backingStore_,
+                   stats = stats_](std::unique_ptr<folly::IOBuf> data) mutable
+                  -> folly::SemiFuture<GetTreeResult> {
+        if (data) {
+          data->coalesce();
+          if (auto tree = Tree::tryDeserialize(
+                  id,
+                  folly::StringPiece{
+                      reinterpret_cast<const char*>(data->data()),
+                      data->length()})) {
+            stats->increment(&ObjectStoreStats::getTreeFromPeerCache);
+            return folly::makeSemiFuture(GetTreeResult{
+                std::move(tree), ObjectFetchContext::FromNetworkFetch});
+          }
+          // An undeserializable value is treated as a miss; the origin's
+          // copy will overwrite it below.
+        }
+
+        return backingStore->getTree(id, context)
+            .deferValue([key = std::move(key),
+                         peerCache = std::move(peerCache)](
+                            GetTreeResult result) {
+              if (result.tree) {
+                peerCache->put(
+                    key,
+                    std::make_unique<folly::IOBuf>(result.tree->serialize()));
+              }
+              return result;
+            });
+      });
+}
+
+std::unique_ptr<BlobMetadata> PeerCachedBackingStore::getLocalBlobMetadata(
+    const ObjectId& id,
+    const ObjectFetchContextPtr& context) {
+  return backingStore_->getLocalBlobMetadata(id, context);
+}
+
+folly::SemiFuture<BackingStore::GetBlobResult>
+PeerCachedBackingStore::getBlob(
+    const ObjectId& id,
+    const ObjectFetchContextPtr& context) {
+  auto key = cacheKey("blob", id);
+  return peerCache_->get(key)
+      .deferValue([id = id,
+                   key = std::move(key),
+                   context = context.copy(),
+                   peerCache = peerCache_,
+                   backingStore = backingStore_,
+                   stats = stats_](std::unique_ptr<folly::IOBuf> data) mutable
+                  -> folly::SemiFuture<GetBlobResult> {
+        if (data) {
+          stats->increment(&ObjectStoreStats::getBlobFromPeerCache);
+          return folly::makeSemiFuture(GetBlobResult{
+              std::make_unique<Blob>(id, std::move(*data)),
+              ObjectFetchContext::FromNetworkFetch});
+        }
+
+        return backingStore->getBlob(id, context)
+            .deferValue([key = std::move(key),
+                         peerCache = std::move(peerCache)](
+                            GetBlobResult result) {
+              if (result.blob) {
+                peerCache->put(
+                    key,
+                    std::make_unique<folly::IOBuf>(
+                        result.blob->getContents()));
+              }
+              return result;
+            });
+      });
+}
+
+folly::SemiFuture<folly::Unit> PeerCachedBackingStore::prefetchBlobs(
+    ObjectIdRange ids,
+    const ObjectFetchContextPtr& context) {
+  return backingStore_->prefetchBlobs(ids, context);
+}
+
+void PeerCachedBackingStore::periodicManagementTask() {
+  backingStore_->periodicManagementTask();
+}
+
+void PeerCachedBackingStore::startRecordingFetch() {
+  backingStore_->startRecordingFetch();
+}
+
+std::unordered_set<std::string> PeerCachedBackingStore::stopRecordingFetch() {
+  return backingStore_->stopRecordingFetch();
+}
+
+folly::SemiFuture<folly::Unit> PeerCachedBackingStore::importManifestForRoot(
+    const RootId& rootId,
+    const Hash20& manifest) {
+  return backingStore_->importManifestForRoot(rootId, manifest);
+}
+
+RootId PeerCachedBackingStore::parseRootId(folly::StringPiece rootId) {
+  return backingStore_->parseRootId(rootId);
+}
+
+std::string PeerCachedBackingStore::renderRootId(const RootId& rootId) {
+  return backingStore_->renderRootId(rootId);
+}
+
+ObjectId PeerCachedBackingStore::parseObjectId(folly::StringPiece objectId) {
+  return backingStore_->parseObjectId(objectId);
+}
+
+std::string PeerCachedBackingStore::renderObjectId(const ObjectId& objectId) {
+  return backingStore_->renderObjectId(objectId);
+}
+
+std::optional<folly::StringPiece> PeerCachedBackingStore::getRepoName() {
+  return backingStore_->getRepoName();
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include "eden/fs/store/BackingStore.h"
+
+namespace facebook::eden {
+
+class EdenStats;
+class PeerObjectCache;
+
+/**
+ * A BackingStore tier that consults a LAN peer object cache before the
+ * wrapped store, and offers objects fetched from the wrapped store back to
+ * the peer.
+ *
+ * It composes like LocalStoreCachedBackingStore, sitting between it and
+ * the origin store:
+ *
+ *   LocalStoreCachedBackingStore -> PeerCachedBackingStore -> origin
+ *
+ * so the lookup order is RocksDB, then the office-local peer, then the
+ * origin, and each tier populates the tier above it. Offices typically
+ * have far more bandwidth to each other than to the origin, which makes
+ * the peer tier the difference between a cold clone bounded by the WAN
+ * and one bounded by the LAN. Per-tier hits are counted in
+ * ObjectStoreStats (object_store.get_{blob,tree}.peer_cache).
+ *
+ * Only blob and tree fetches go through the peer; everything else
+ * delegates to the wrapped store. The peer is strictly an optimization:
+ * any peer failure reads as a miss and the fetch proceeds to the origin.
+ * That holds for integrity as well as availability: every value carries a
+ * content digest on the wire that PeerObjectCache verifies before the
+ * value is surfaced, so a corrupt peer or transport reads as a miss
+ * instead of poisoning the local store tier above.
+ */
+class PeerCachedBackingStore : public BackingStore {
+ public:
+  PeerCachedBackingStore(
+      std::shared_ptr<BackingStore> backingStore,
+      std::shared_ptr<PeerObjectCache> peerCache,
+      std::shared_ptr<EdenStats> stats);
+  ~PeerCachedBackingStore() override;
+
+  ObjectComparison compareObjectsById(const ObjectId& one, const ObjectId& two)
+      override;
+
+  ImmediateFuture<std::unique_ptr<Tree>> getRootTree(
+      const RootId& rootId,
+      const ObjectFetchContextPtr& context) override;
+
+  ImmediateFuture<std::unique_ptr<TreeEntry>> getTreeEntryForObjectId(
+      const ObjectId& objectId,
+      TreeEntryType treeEntryType,
+      const ObjectFetchContextPtr& context) override;
+  folly::SemiFuture<GetTreeResult> getTree(
+      const ObjectId& id,
+      const ObjectFetchContextPtr& context) override;
+  folly::SemiFuture<GetBlobResult> getBlob(
+      const ObjectId& id,
+      const ObjectFetchContextPtr& context) override;
+
+  std::unique_ptr<BlobMetadata> getLocalBlobMetadata(
+      const ObjectId& id,
+      const ObjectFetchContextPtr& context) override;
+
+  FOLLY_NODISCARD folly::SemiFuture<folly::Unit> prefetchBlobs(
+      ObjectIdRange ids,
+      const ObjectFetchContextPtr& context) override;
+
+  void periodicManagementTask() override;
+
+  void startRecordingFetch() override;
+  std::unordered_set<std::string> stopRecordingFetch() override;
+
+  folly::SemiFuture<folly::Unit> importManifestForRoot(
+      const RootId& rootId,
+      const Hash20& manifest) override;
+
+  RootId parseRootId(folly::StringPiece rootId) override;
+  std::string renderRootId(const RootId& rootId) override;
+  ObjectId parseObjectId(folly::StringPiece objectId) override;
+  std::string renderObjectId(const ObjectId& objectId) override;
+
+  std::optional<folly::StringPiece> getRepoName() override;
+
+  /**
+   * Get the underlying BackingStore. This should only be used for
+   * operations that need to be made directly on the BackingStore, like
+   * getting a TraceBus
+   */
+  const std::shared_ptr<BackingStore>& getBackingStore() {
+    return backingStore_;
+  }
+
+  // TODO(T119221752): Implement for all BackingStore subclasses
+  int64_t dropAllPendingRequestsFromQueue() override {
+    return backingStore_->dropAllPendingRequestsFromQueue();
+  }
+
+ private:
+  /**
+   * The peer cache key for an object: the repo name (when known) plus the
+   * rendered object id, with a kind tag so blobs and trees with colliding
+   * ids cannot alias.
+   */
+  std::string cacheKey(folly::StringPiece kind, const ObjectId& id);
+
+  std::shared_ptr<BackingStore> backingStore_;
+  std::shared_ptr<PeerObjectCache> peerCache_;
+  std::shared_ptr<EdenStats> stats_;
+};
+
+} // namespace facebook::eden
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/PeerObjectCache.h"
+
+#ifndef _WIN32
+
+#include <cstring>
+
+#include <folly/Executor.h>
+#include <folly/io/IOBuf.h>
+#include <folly/lang/Bits.h>
+#include <folly/logging/xlog.h>
+#include <folly/portability/Sockets.h>
+
+#include "eden/fs/model/Hash.h"
+
+namespace facebook::eden {
+
+namespace {
+
+constexpr uint8_t kOpGet = 1;
+constexpr uint8_t kOpPut = 2;
+constexpr uint8_t kStatusHit = 1;
+
+/**
+ * Reads or writes exactly len bytes, looping over short transfers.
+ * Returns false on error, EOF, or timeout (the socket has SO_RCVTIMEO and
+ * SO_SNDTIMEO set).
+ */
+bool writeFull(int fd, const void* data, size_t len) {
+  auto* p = static_cast<const char*>(data);
+  while (len > 0) {
+    auto n = ::send(fd, p, len, 0);
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= n;
+  }
+  return true;
+}
+
+bool readFull(int fd, void* data, size_t len) {
+  auto* p = static_cast<char*>(data);
+  while (len > 0) {
+    auto n = ::recv(fd, p, len, 0);
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= n;
+  }
+  return true;
+}
+
+/**
+ * The digest that travels with a value covers the key as well as the
+ * value bytes. Hashing the value alone would only catch corruption of the
+ * bytes themselves: a peer whose key index is corrupt could return some
+ * other entry's (value, digest) pair, and it would self-verify. Binding
+ * the key into the digest makes a misassociated entry fail verification
+ * like any other corruption.
+ */
+Hash20 computeEntryDigest(const std::string& key, const folly::IOBuf& value) {
+  auto chain = folly::IOBuf::wrapBuffer(key.data(), key.size());
+  chain->appendChain(value.clone());
+  return Hash20::sha1(*chain);
+}
+
+} // namespace
+
+PeerObjectCache::PeerObjectCache(
+    folly::SocketAddress address,
+    std::chrono::milliseconds ioTimeout,
+    std::shared_ptr<folly::Executor> executor)
+    : address_{std::move(address)},
+      ioTimeout_{ioTimeout},
+      executor_{std::move(executor)} {}
+
+PeerObjectCache::~PeerObjectCache() {
+  auto connections = idleConnections_.wlock();
+  for (int fd : *connections) {
+    ::close(fd);
+  }
+  connections->clear();
+}
+
+int PeerObjectCache::getConnection() {
+  {
+    auto connections = idleConnections_.wlock();
+    if (!connections->empty()) {
+      int fd = connections->back();
+      connections->pop_back();
+      return fd;
+    }
+  }
+  if (std::chrono::steady_clock::now() < *retryAfter_.rlock()) {
+    return -1;
+  }
+
+  sockaddr_storage storage;
+  auto addrLen = address_.getAddress(&storage);
+  int fd = ::socket(storage.ss_family, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return -1;
+  }
+
+  timeval timeout;
+  timeout.tv_sec = ioTimeout_.count() / 1000;
+  timeout.tv_usec = (ioTimeout_.count() % 1000) * 1000;
+  ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&storage), addrLen) != 0) {
+    ::close(fd);
+    noteError(-1);
+    return -1;
+  }
+  return fd;
+}
+
+void PeerObjectCache::returnConnection(int fd) {
+  auto connections = idleConnections_.wlock();
+  if (connections->size() < kMaxIdleConnections) {
+    connections->push_back(fd);
+    return;
+  }
+  ::close(fd);
+}
+
+void PeerObjectCache::noteError(int fd) {
+  if (fd >= 0) {
+    ::close(fd);
+  }
+  *retryAfter_.wlock() = std::chrono::steady_clock::now() + kErrorBackoff;
+}
+
+folly::SemiFuture<std::unique_ptr<folly::IOBuf>> PeerObjectCache::get(
+    std::string key) {
+  return folly::via(
+             executor_.get(),
+             [this, key = std::move(key)] { return getImpl(key); })
+      .semi();
+}
+
+std::unique_ptr<folly::IOBuf> PeerObjectCache::getImpl(
+    const std::string& key) {
+  int fd = getConnection();
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  // u8 op, u16 keyLen, key
+  std::string request;
+  request.reserve(3 + key.size());
+  request.push_back(static_cast<char>(kOpGet));
+  uint16_t keyLen = folly::Endian::big(static_cast<uint16_t>(key.size()));
+  request.append(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
+  request.append(key);
+  if (!writeFull(fd, request.data(), request.size())) {
+    noteError(fd);
+    return nullptr;
+  }
+
+  uint8_t status;
+  if (!readFull(fd, &status, sizeof(status))) {
+    noteError(fd);
+    return nullptr;
+  }
+  if (status != kStatusHit) {
+    returnConnection(fd);
+    return nullptr;
+  }
+  uint32_t valueLen;
+  if (!readFull(fd, &valueLen, sizeof(valueLen))) {
+    noteError(fd);
+    return nullptr;
+  }
+  valueLen = folly::Endian::big(valueLen);
+  if (valueLen > kMaxValueSize) {
+    // The reply is not resynchronizable once we distrust its framing.
+    noteError(fd);
+    return nullptr;
+  }
+  Hash20::Storage digestBytes;
+  if (!readFull(fd, digestBytes.data(), digestBytes.size())) {
+    noteError(fd);
+    return nullptr;
+  }
+  auto value = folly::IOBuf::create(valueLen);
+  if (!readFull(fd, value->writableData(), valueLen)) {
+    noteError(fd);
+    return nullptr;
+  }
+  value->append(valueLen);
+
+  // The bytes we just read will be persisted into the local store by the
+  // tier above, so verify them end to end before reporting a hit. A
+  // mismatch means the peer or the transport corrupted the value, or the
+  // peer returned an entry that belongs to a different key; treat the
+  // connection as broken like any other protocol error.
+  Hash20 digest{folly::ByteRange{digestBytes.data(), digestBytes.size()}};
+  if (computeEntryDigest(key, *value) != digest) {
+    XLOG(WARN) << "peer cache value for " << key
+               << " failed digest verification; treating as a miss";
+    noteError(fd);
+    return nullptr;
+  }
+  returnConnection(fd);
+  return value;
+}
+
+void PeerObjectCache::put(std::string key, std::unique_ptr<folly::IOBuf> value) {
+  if (!value || value->computeChainDataLength() > kMaxValueSize) {
+    return;
+  }
+  executor_->add([this, key = std::move(key), value = std::move(value)] {
+    putImpl(key, *value);
+  });
+}
+
+void PeerObjectCache::putImpl(const std::string& key, const folly::IOBuf& value) {
+  int fd = getConnection();
+  if (fd < 0) {
+    return;
+  }
+
+  auto valueLength = value.computeChainDataLength();
+  auto digest = computeEntryDigest(key, value);
+  // u8 op, u16 keyLen, key, u32 valueLen, 20-byte SHA-1
+  std::string header;
+  header.reserve(7 + key.size() + Hash20::RAW_SIZE);
+  header.push_back(static_cast<char>(kOpPut));
+  uint16_t keyLen = folly::Endian::big(static_cast<uint16_t>(key.size()));
+  header.append(reinterpret_cast<const char*>(&keyLen), sizeof(keyLen));
+  header.append(key);
+  uint32_t valueLen = folly::Endian::big(static_cast<uint32_t>(valueLength));
+  header.append(reinterpret_cast<const char*>(&valueLen), sizeof(valueLen));
+  header.append(
+      reinterpret_cast<const char*>(digest.getBytes().data()),
+      Hash20::RAW_SIZE);
+  if (!writeFull(fd, header.data(), header.size())) {
+    noteError(fd);
+    return;
+  }
+  for (auto range : value) {
+    if (!writeFull(fd, range.data(), range.size())) {
+      noteError(fd);
+      return;
+    }
+  }
+
+  uint8_t status;
+  if (!readFull(fd, &status, sizeof(status))) {
+    noteError(fd);
+    return;
+  }
+  returnConnection(fd);
+}
+
+} // namespace facebook::eden
+
+#else // _WIN32
+
+#include <folly/io/IOBuf.h>
+
+namespace facebook::eden {
+
+// The peer cache is not wired up on Windows; every lookup misses so the
+// store pipeline behaves as if the tier were absent.
+
+PeerObjectCache::PeerObjectCache(
+    folly::SocketAddress address,
+    std::chrono::milliseconds ioTimeout,
+    std::shared_ptr<folly::Executor> executor)
+    : address_{std::move(address)},
+      ioTimeout_{ioTimeout},
+      executor_{std::move(executor)} {}
+
+PeerObjectCache::~PeerObjectCache() {}
+
+folly::SemiFuture<std::unique_ptr<folly::IOBuf>> PeerObjectCache::get(
+    std::string /*key*/) {
+  return folly::makeSemiFuture(std::unique_ptr<folly::IOBuf>{nullptr});
+}
+
+void PeerObjectCache::put(
+    std::string /*key*/,
+    std::unique_ptr<folly::IOBuf> /*value*/) {}
+
+} // namespace facebook::eden
+
+#endif // _WIN32
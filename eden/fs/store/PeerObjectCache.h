@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/SocketAddress.h>
+#include <folly/Synchronized.h>
+#include <folly/futures/Future.h>
+
+namespace folly {
+class Executor;
+class IOBuf;
+} // namespace folly
+
+namespace facebook::eden {
+
+/**
+ * Client for a LAN peer object cache speaking a small content-addressed
+ * protocol: objects are immutable values looked up and stored under an
+ * opaque string key. Offices typically have an order of magnitude more
+ * bandwidth to each other than to the origin, so a shared peer cache
+ * absorbs most cold-clone traffic; see PeerCachedBackingStore for how it
+ * slots into the store pipeline.
+ *
+ * Wire protocol, big-endian, one request per round trip on a pooled
+ * persistent connection:
+ *
+ *   GET:  u8 op=1, u16 keyLen, key
+ *         reply: u8 status (0 = miss, 1 = hit), u32 valueLen,
+ *                20-byte SHA-1 of key then value, value
+ *   PUT:  u8 op=2, u16 keyLen, key, u32 valueLen,
+ *         20-byte SHA-1 of key then value, value
+ *         reply: u8 status (1 = stored)
+ *
+ * Every value travels with a SHA-1 over the key followed by the value,
+ * computed by the writer and verified by the reader before a hit is
+ * returned. Callers above this tier persist peer-fetched bytes into the
+ * local store, so an unverified value from a corrupt peer or transport
+ * would silently poison working-copy content; the digest turns that into
+ * a detectable mismatch, which is treated as a miss plus a connection
+ * error. (TCP's 16-bit checksum is too weak to rely on at multi-gigabyte
+ * volumes.) Covering the key as well means an entry a peer returns under
+ * the wrong key — say, through a corrupt key index — fails verification
+ * too, rather than self-validating as an intact value for the wrong
+ * object.
+ *
+ * The cache is strictly an optimization: every network or protocol error
+ * closes the connection, reports a miss, and backs the client off for a
+ * few seconds so an unreachable peer costs one timed-out connect per
+ * backoff window rather than one per fetch. Lookups run on the supplied
+ * executor since the socket I/O is blocking; stores are fire-and-forget.
+ */
+class PeerObjectCache {
+ public:
+  PeerObjectCache(
+      folly::SocketAddress address,
+      std::chrono::milliseconds ioTimeout,
+      std::shared_ptr<folly::Executor> executor);
+  ~PeerObjectCache();
+
+  PeerObjectCache(const PeerObjectCache&) = delete;
+  PeerObjectCache& operator=(const PeerObjectCache&) = delete;
+
+  /**
+   * Looks the key up on the peer. Yields nullptr on a miss or on any
+   * error; never throws to the caller.
+   */
+  folly::SemiFuture<std::unique_ptr<folly::IOBuf>> get(std::string key);
+
+  /**
+   * Stores the value under the key, best effort. Returns immediately; the
+   * write happens on the executor and failures are silently dropped after
+   * arming the backoff.
+   */
+  void put(std::string key, std::unique_ptr<folly::IOBuf> value);
+
+ private:
+  /** Upper bound on pooled idle connections. */
+  static constexpr size_t kMaxIdleConnections = 4;
+  /** How long to treat the peer as unreachable after an error. */
+  static constexpr std::chrono::seconds kErrorBackoff{5};
+  /** Objects larger than this are not offered to the peer. */
+  static constexpr size_t kMaxValueSize = 100 * 1024 * 1024;
+
+  /**
+   * Returns a connected socket fd, reusing an idle one when available, or
+   * -1 when the peer is in backoff or unreachable.
+   */
+  int getConnection();
+  void returnConnection(int fd);
+  void noteError(int fd);
+
+  std::unique_ptr<folly::IOBuf> getImpl(const std::string& key);
+  void putImpl(const std::string& key, const folly::IOBuf& value);
+
+  const folly::SocketAddress address_;
+  const std::chrono::milliseconds ioTimeout_;
+  std::shared_ptr<folly::Executor> executor_;
+  folly::Synchronized<std::vector<int>> idleConnections_;
+  folly::Synchronized<std::chrono::steady_clock::time_point> retryAfter_;
+};
+
+} // namespace facebook::eden
@@ -17,12 +17,14 @@
 #include <folly/io/IOBuf.h>
 #include <folly/lang/Bits.h>
 #include <folly/logging/xlog.h>
+#include <rocksdb/cache.h>
 #include <rocksdb/convenience.h>
 #include <rocksdb/db.h>
 #include <rocksdb/filter_policy.h>
 #include <rocksdb/table.h>
 
 #include "eden/fs/config/EdenConfig.h"
+#include "eden/fs/config/ReloadableConfig.h"
 #include "eden/fs/rocksdb/RocksException.h"
 #include "eden/fs/rocksdb/RocksHandles.h"
 #include "eden/fs/store/KeySpace.h"
@@ -44,7 +46,9 @@ using std::chrono::duration_cast;
 namespace {
 using namespace facebook::eden;
 
-rocksdb::ColumnFamilyOptions makeColumnOptions(uint64_t LRUblockCacheSizeMB) {
+rocksdb::ColumnFamilyOptions makeColumnOptions(
+    uint64_t LRUblockCacheSizeMB,
+    const std::shared_ptr<rocksdb::Cache>& sharedBlockCache) {
   rocksdb::ColumnFamilyOptions options;
 
   // We'll never perform range scans on any of the keys that we store.
@@ -53,22 +57,87 @@ rocksdb::ColumnFamilyOptions makeColumnOptions(uint64_t LRUblockCacheSizeMB) {
   options.OptimizeForPointLookup(LRUblockCacheSizeMB);
 
   options.OptimizeLevelStyleCompaction();
+
+  if (sharedBlockCache) {
+    // Replace the private per-column-family block cache installed by
+    // OptimizeForPointLookup with the shared one so a single capacity knob
+    // governs all column families, keeping the same point-lookup table
+    // settings.
+    rocksdb::BlockBasedTableOptions tableOptions;
+    tableOptions.block_cache = sharedBlockCache;
+    tableOptions.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10, false));
+    tableOptions.data_block_index_type =
+        rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+    tableOptions.data_block_hash_table_util_ratio = 0.75;
+    options.table_factory.reset(
+        rocksdb::NewBlockBasedTableFactory(tableOptions));
+  }
   return options;
 }
 
+/**
+ * Create the block cache shared by every column family, or nullptr when the
+ * shared cache is not configured.
+ */
+std::shared_ptr<rocksdb::Cache> makeSharedBlockCache(
+    const std::shared_ptr<ReloadableConfig>& config) {
+  if (!config) {
+    return nullptr;
+  }
+  auto size = config->getEdenConfig()->localStoreBlockCacheSize.getValue();
+  if (size == 0) {
+    return nullptr;
+  }
+  return rocksdb::NewLRUCache(size);
+}
+
+/**
+ * Apply any configured `store:*-column-family-options` override for this key
+ * space on top of our built-in defaults. Returns the defaults unchanged if no
+ * override is configured or if the override fails to parse.
+ */
+rocksdb::ColumnFamilyOptions applyColumnOptionOverrides(
+    const std::shared_ptr<ReloadableConfig>& config,
+    const KeySpaceRecord* ks,
+    const rocksdb::ColumnFamilyOptions& defaults) {
+  if (!config || !ks->columnFamilyOptions) {
+    return defaults;
+  }
+  const auto& optionString =
+      ((*config->getEdenConfig()).*(ks->columnFamilyOptions)).getValue();
+  if (optionString.empty()) {
+    return defaults;
+  }
+  rocksdb::ColumnFamilyOptions overridden;
+  auto status = rocksdb::GetColumnFamilyOptionsFromString(
+      defaults, optionString, &overridden);
+  if (!status.ok()) {
+    XLOG(WARN) << "ignoring invalid column family options for " << ks->name
+               << ": \"" << optionString << "\": " << status.ToString();
+    return defaults;
+  }
+  XLOG(DBG2) << "applying column family option overrides for " << ks->name
+             << ": " << optionString;
+  return overridden;
+}
+
 /**
  * The different key spaces that we desire.
  * The ordering is coupled with the values of the KeySpace enum.
  */
 const std::vector<rocksdb::ColumnFamilyDescriptor> columnFamilies(
     const rocksdb::DBOptions& db_options,
-    const std::string& name) {
+    const std::string& name,
+    const std::shared_ptr<ReloadableConfig>& config,
+    const std::shared_ptr<rocksdb::Cache>& sharedBlockCache) {
   // Most of the column families will share the same cache.  We
   // want the blob data to live in its own smaller cache; the assumption
   // is that the vfs cache will compensate for that, together with the
   // idea that we shouldn't need to materialize a great many files.
-  auto options = makeColumnOptions(64);
-  auto blobOptions = makeColumnOptions(8);
+  // When a shared block cache is configured, every column family draws from
+  // it instead and the per-family sizes below are ignored.
+  auto options = makeColumnOptions(64, sharedBlockCache);
+  auto blobOptions = makeColumnOptions(8, sharedBlockCache);
 
   // We have to open all column families that currenly exists in our RocksDb.
   // Else we will get "Invalid argument: You have to open all column
@@ -81,9 +150,10 @@ const std::vector<rocksdb::ColumnFamilyDescriptor> columnFamilies(
 
   std::vector<rocksdb::ColumnFamilyDescriptor> families;
   for (auto& ks : KeySpace::kAll) {
+    const auto& defaults =
+        (ks->index == KeySpace::BlobFamily.index) ? blobOptions : options;
     families.emplace_back(
-        ks->name.str(),
-        (ks->index == KeySpace::BlobFamily.index) ? blobOptions : options);
+        ks->name.str(), applyColumnOptionOverrides(config, ks, defaults));
     auto oldFamily = find(
         oldUnopenedColumnFamilies.begin(),
         oldUnopenedColumnFamilies.end(),
@@ -249,10 +319,17 @@ rocksdb::Options getRocksdbOptions() {
   return options;
 }
 
-RocksHandles openDB(AbsolutePathPiece path, RocksDBOpenMode mode) {
+RocksHandles openDB(
+    AbsolutePathPiece path,
+    RocksDBOpenMode mode,
+    const std::shared_ptr<ReloadableConfig>& config,
+    const std::shared_ptr<rocksdb::Cache>& sharedBlockCache) {
   auto options = getRocksdbOptions();
-  const auto columnDescriptors =
-      columnFamilies(rocksdb::DBOptions{options}, path.stringWithoutUNC());
+  const auto columnDescriptors = columnFamilies(
+      rocksdb::DBOptions{options},
+      path.stringWithoutUNC(),
+      config,
+      sharedBlockCache);
   try {
     return RocksHandles(
         path.viewWithoutUNC(), mode, options, columnDescriptors);
@@ -285,12 +362,15 @@ RocksDbLocalStore::RocksDbLocalStore(
     AbsolutePathPiece pathToRocksDb,
     std::shared_ptr<StructuredLogger> structuredLogger,
     FaultInjector* faultInjector,
-    RocksDBOpenMode mode)
+    RocksDBOpenMode mode,
+    std::shared_ptr<ReloadableConfig> config)
     : structuredLogger_{std::move(structuredLogger)},
       faultInjector_(*faultInjector),
       ioPool_(12, "RocksLocalStore"),
       pathToDb_{pathToRocksDb.copy()},
-      mode_{mode} {
+      mode_{mode},
+      config_{std::move(config)} {
+  blockCache_ = makeSharedBlockCache(config_);
   XLOG(DBG2) << "Making a new RockDB localstore ( " << this
              << " ) . debug information for T136469251.";
 }
@@ -310,8 +390,8 @@ void RocksDbLocalStore::open() {
       case RockDbHandleStatus::NOT_YET_OPENED:
         break;
     }
-    handles->handles =
-        std::make_unique<RocksHandles>(openDB(pathToDb_.piece(), mode_));
+    handles->handles = std::make_unique<RocksHandles>(
+        openDB(pathToDb_.piece(), mode_, config_, blockCache_));
     handles->status = RockDbHandleStatus::OPEN;
   }
   // Publish fb303 stats once when we first open the DB.
@@ -361,6 +441,20 @@ RocksDbLocalStore::getHandles() const {
   return handles;
 }
 
+size_t RocksDbLocalStore::getBlockCacheCapacity() const {
+  return blockCache_ ? blockCache_->GetCapacity() : 0;
+}
+
+size_t RocksDbLocalStore::getBlockCacheUsage() const {
+  return blockCache_ ? blockCache_->GetUsage() : 0;
+}
+
+void RocksDbLocalStore::setBlockCacheCapacity(size_t capacityBytes) {
+  if (blockCache_) {
+    blockCache_->SetCapacity(capacityBytes);
+  }
+}
+
 void RocksDbLocalStore::repairDB(AbsolutePathPiece path) {
   XLOG(ERR) << "Attempting to repair RocksDB " << path;
   rocksdb::ColumnFamilyOptions unknownColumFamilyOptions;
@@ -370,8 +464,10 @@ void RocksDbLocalStore::repairDB(AbsolutePathPiece path) {
   auto dbPathStr = path.stringWithoutUNC();
   rocksdb::DBOptions dbOptions(getRocksdbOptions());
 
+  // Repair with the built-in column family options; configured overrides are
+  // not needed just to make the DB openable again.
   const auto columnDescriptors =
-      columnFamilies(dbOptions, path.stringWithoutUNC());
+      columnFamilies(dbOptions, path.stringWithoutUNC(), nullptr);
 
   auto status = RepairDB(
       dbPathStr, dbOptions, columnDescriptors, unknownColumFamilyOptions);
@@ -437,15 +533,26 @@ void RocksDbLocalStore::compactKeySpace(KeySpace keySpace) {
   }
 }
 
+namespace {
+void freePinnableSlice(void* /* buffer */, void* userData) {
+  delete static_cast<rocksdb::PinnableSlice*>(userData);
+}
+} // namespace
+
 StoreResult RocksDbLocalStore::get(KeySpace keySpace, ByteRange key) const {
   auto handlesLock = getHandles();
   auto& handles = handlesLock->handles;
-  string value;
+  // Use a PinnableSlice so that, when the value is already resident in the
+  // block cache, RocksDB pins the block instead of copying the value into a
+  // std::string. The StoreResult then wraps the pinned bytes zero-copy and
+  // releases the pin when the result (or the IOBuf extracted from it) is
+  // destroyed.
+  auto value = std::make_unique<rocksdb::PinnableSlice>();
   auto status = handles->db->Get(
       ReadOptions(),
       handles->columns[keySpace->index].get(),
       _createSlice(key),
-      &value);
+      value.get());
   if (!status.ok()) {
     if (status.IsNotFound()) {
       // Return an empty StoreResult
@@ -460,7 +567,16 @@ StoreResult RocksDbLocalStore::get(KeySpace keySpace, ByteRange key) const {
     throw RocksException::build(
         status, "failed to get ", folly::hexlify(key), " from local store");
   }
-  return StoreResult(std::move(value));
+  // Extract the data and size before we pass value.release() to the IOBuf
+  // constructor; arguments are evaluated in an arbitrary order.
+  auto data = const_cast<char*>(value->data());
+  auto size = value->size();
+  return StoreResult(folly::IOBuf(
+      folly::IOBuf::TAKE_OWNERSHIP,
+      data,
+      size,
+      freePinnableSlice,
+      value.release()));
 }
 
 FOLLY_NODISCARD folly::Future<std::vector<StoreResult>>
@@ -569,6 +685,38 @@ bool RocksDbLocalStore::hasKey(KeySpace keySpace, folly::ByteRange key) const {
   return true;
 }
 
+void RocksDbLocalStore::iterateKeySpace(
+    KeySpace keySpace,
+    const std::function<bool(folly::ByteRange key, folly::ByteRange value)>&
+        fn) const {
+  auto handlesLock = getHandles();
+  auto& handles = handlesLock->handles;
+  ReadOptions options;
+  // A full scan would otherwise wash everything useful out of the block
+  // cache.
+  options.fill_cache = false;
+  std::unique_ptr<rocksdb::Iterator> iter{handles->db->NewIterator(
+      options, handles->columns[keySpace->index].get())};
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    auto key = iter->key();
+    auto value = iter->value();
+    if (!fn(
+            folly::ByteRange{
+                reinterpret_cast<const unsigned char*>(key.data()),
+                key.size()},
+            folly::ByteRange{
+                reinterpret_cast<const unsigned char*>(value.data()),
+                value.size()})) {
+      return;
+    }
+  }
+  auto status = iter->status();
+  if (!status.ok()) {
+    throw RocksException::build(
+        status, "error iterating key space ", keySpace->name);
+  }
+}
+
 std::unique_ptr<LocalStore::WriteBatch> RocksDbLocalStore::beginWrite(
     size_t bufSize) {
   return std::make_unique<RocksDbWriteBatch>(getHandles(), bufSize);
@@ -636,6 +784,11 @@ uint64_t RocksDbLocalStore::getApproximateSize(KeySpace keySpace) const {
 void RocksDbLocalStore::periodicManagementTask(const EdenConfig& config) {
   enableBlobCaching.store(
       config.enableBlobCaching.getValue(), std::memory_order_relaxed);
+  blobChunkingThreshold.store(
+      config.localStoreBlobChunkingThreshold.getValue(),
+      std::memory_order_relaxed);
+  compressBlobs.store(
+      config.localStoreCompressBlobs.getValue(), std::memory_order_relaxed);
 
   // Compute and publish the stats
   auto before = computeStats(/*publish=*/true, &config);
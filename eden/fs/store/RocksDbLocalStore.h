@@ -15,9 +15,14 @@
 #include "eden/fs/store/LocalStore.h"
 #include "eden/fs/utils/UnboundedQueueExecutor.h"
 
+namespace rocksdb {
+class Cache;
+}
+
 namespace facebook::eden {
 
 class FaultInjector;
+class ReloadableConfig;
 class StructuredLogger;
 
 /** An implementation of LocalStore that uses RocksDB for the underlying
@@ -28,12 +33,17 @@ class RocksDbLocalStore final : public LocalStore {
   /**
    * The given FaultInjector must be valid during the lifetime of this
    * RocksDbLocalStore object.
+   *
+   * If a ReloadableConfig is supplied, per-key-space column family option
+   * overrides from the `store:*-column-family-options` settings are applied
+   * when the DB is opened.
    */
   explicit RocksDbLocalStore(
       AbsolutePathPiece pathToRocksDb,
       std::shared_ptr<StructuredLogger> structuredLogger,
       FaultInjector* FOLLY_NONNULL faultInjector,
-      RocksDBOpenMode mode = RocksDBOpenMode::ReadWrite);
+      RocksDBOpenMode mode = RocksDBOpenMode::ReadWrite,
+      std::shared_ptr<ReloadableConfig> config = nullptr);
   void open() override;
   ~RocksDbLocalStore();
   void close() override;
@@ -46,6 +56,19 @@ class RocksDbLocalStore final : public LocalStore {
   bool hasKey(KeySpace keySpace, folly::ByteRange key) const override;
   void put(KeySpace keySpace, folly::ByteRange key, folly::ByteRange value)
       override;
+
+  /**
+   * Iterate every key/value pair in keySpace in key order, invoking fn for
+   * each pair. Iteration stops early when fn returns false. The ranges
+   * passed to fn are only valid for the duration of that call.
+   *
+   * The scan bypasses the block cache so offline tooling (eden_store_util)
+   * can sweep whole column families without evicting hot data.
+   */
+  void iterateKeySpace(
+      KeySpace keySpace,
+      const std::function<bool(folly::ByteRange key, folly::ByteRange value)>&
+          fn) const;
   std::unique_ptr<WriteBatch> beginWrite(size_t bufSize = 0) override;
 
   // Call RocksDB's RepairDB() function on the DB at the specified location
@@ -57,6 +80,24 @@ class RocksDbLocalStore final : public LocalStore {
 
   void periodicManagementTask(const EdenConfig& config) override;
 
+  /**
+   * Capacity of the shared block cache in bytes, or 0 when the store is
+   * using per-column-family block caches (`store:block-cache-size` unset).
+   */
+  size_t getBlockCacheCapacity() const;
+
+  /**
+   * Current usage of the shared block cache in bytes, or 0 when there is no
+   * shared block cache.
+   */
+  size_t getBlockCacheUsage() const;
+
+  /**
+   * Resize the shared block cache, evicting blocks if it shrinks. A no-op
+   * when there is no shared block cache.
+   */
+  void setBlockCacheCapacity(size_t capacityBytes);
+
   enum class RockDbHandleStatus { NOT_YET_OPENED, OPEN, CLOSED };
 
   struct RockDBState {
@@ -127,6 +168,15 @@ class RocksDbLocalStore final : public LocalStore {
   folly::Synchronized<AutoGCState> autoGCState_;
   AbsolutePath pathToDb_;
   RocksDBOpenMode mode_;
+  std::shared_ptr<ReloadableConfig> config_;
+
+  /**
+   * Block cache shared by every column family, created at construction time
+   * when `store:block-cache-size` is non-zero. Null when each column family
+   * keeps its own private cache.
+   */
+  std::shared_ptr<rocksdb::Cache> blockCache_;
+
   folly::Synchronized<RockDBState> dbHandles_;
 };
 
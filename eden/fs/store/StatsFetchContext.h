@@ -74,9 +74,24 @@ class StatsFetchContext : public ObjectFetchContext {
     return &requestInfo_;
   }
 
+  ImportPriority getPriority() const override {
+    return priority_;
+  }
+
+  /**
+   * Set the priority for all fetches made through this context.
+   *
+   * Must be called before the context is handed to any fetch; the field is
+   * not synchronized.
+   */
+  void setFetchPriority(ImportPriority priority) {
+    priority_ = priority;
+  }
+
  private:
   std::atomic<uint64_t> counts_[ObjectFetchContext::kObjectTypeEnumMax]
                                [ObjectFetchContext::kOriginEnumMax] = {};
+  ImportPriority priority_ = kDefaultImportPriority;
   std::optional<pid_t> clientPid_ = std::nullopt;
   Cause cause_ = Cause::Unknown;
   std::string_view causeDetail_;
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/StoreCompression.h"
+
+#include <folly/Conv.h>
+#include <folly/compression/Compression.h>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace facebook::eden {
+
+namespace {
+
+constexpr folly::StringPiece kCompressionPrefix{"zblob "};
+
+/**
+ * At most this many bytes feed the entropy probe, sampled with a stride so
+ * the probe covers the whole value rather than just its head.
+ */
+constexpr size_t kEntropySampleSize = 8 * 1024;
+
+/**
+ * Values whose sampled entropy exceeds this many bits per byte are treated
+ * as already compressed and stored as-is. Source text measures around 4-5
+ * bits per byte; compressed or encrypted data sits close to 8.
+ */
+constexpr double kIncompressibleEntropyBits = 7.2;
+
+/**
+ * Compression must shave off at least 1/8 of the value's size to be worth
+ * the decompression cost on every future read.
+ */
+constexpr size_t kMinSavingsShift = 3;
+
+folly::io::CodecType codecType(StoreCodec codec) {
+  switch (codec) {
+    case StoreCodec::Lz4:
+      return folly::io::CodecType::LZ4;
+    case StoreCodec::Zstd:
+      return folly::io::CodecType::ZSTD;
+  }
+  throw std::invalid_argument(folly::to<std::string>(
+      "unknown store codec ", static_cast<uint32_t>(codec)));
+}
+
+} // namespace
+
+double estimateEntropy(folly::ByteRange data) {
+  if (data.empty()) {
+    return 0.0;
+  }
+  size_t stride = std::max<size_t>(1, data.size() / kEntropySampleSize);
+  std::array<size_t, 256> counts{};
+  size_t sampled = 0;
+  for (size_t i = 0; i < data.size(); i += stride) {
+    ++counts[data[i]];
+    ++sampled;
+  }
+
+  double entropy = 0.0;
+  for (auto count : counts) {
+    if (count == 0) {
+      continue;
+    }
+    double p = static_cast<double>(count) / static_cast<double>(sampled);
+    entropy -= p * std::log2(p);
+  }
+  return entropy;
+}
+
+std::optional<folly::IOBuf> compressStoreValue(folly::ByteRange value) {
+  if (value.size() < kMinCompressibleValueSize) {
+    return std::nullopt;
+  }
+  if (estimateEntropy(value) > kIncompressibleEntropyBits) {
+    return std::nullopt;
+  }
+
+  auto codec = value.size() >= kZstdValueSizeThreshold ? StoreCodec::Zstd
+                                                       : StoreCodec::Lz4;
+  auto compressed =
+      folly::io::getCodec(codecType(codec))->compress(folly::StringPiece{
+          reinterpret_cast<const char*>(value.data()), value.size()});
+
+  auto header = folly::to<std::string>(
+      kCompressionPrefix,
+      static_cast<uint32_t>(codec),
+      " ",
+      value.size());
+  header.push_back('\0');
+
+  // The entropy probe only samples, so it sometimes lets barely-compressible
+  // data through; require real savings before keeping the compressed form.
+  if (header.size() + compressed.size() >=
+      value.size() - (value.size() >> kMinSavingsShift)) {
+    return std::nullopt;
+  }
+
+  folly::IOBuf result{folly::IOBuf::CREATE, header.size() + compressed.size()};
+  memcpy(result.writableTail(), header.data(), header.size());
+  result.append(header.size());
+  memcpy(result.writableTail(), compressed.data(), compressed.size());
+  result.append(compressed.size());
+  return result;
+}
+
+bool hasStoreCompressionHeader(folly::ByteRange data) {
+  return data.size() >= kCompressionPrefix.size() &&
+      memcmp(data.data(),
+             kCompressionPrefix.data(),
+             kCompressionPrefix.size()) == 0;
+}
+
+std::optional<folly::IOBuf> decompressStoreValue(folly::ByteRange data) {
+  if (!hasStoreCompressionHeader(data)) {
+    return std::nullopt;
+  }
+
+  auto headerEnd = std::memchr(data.data(), '\0', data.size());
+  if (!headerEnd) {
+    throw std::invalid_argument(
+        "compressed store value header is not terminated");
+  }
+  folly::StringPiece header{
+      reinterpret_cast<const char*>(data.data()) + kCompressionPrefix.size(),
+      static_cast<const char*>(headerEnd)};
+
+  uint32_t codecValue = 0;
+  uint64_t rawSize = 0;
+  auto space = header.find(' ');
+  if (space == folly::StringPiece::npos) {
+    throw std::invalid_argument(folly::to<std::string>(
+        "malformed compressed store value header: ", header));
+  }
+  try {
+    codecValue = folly::to<uint32_t>(header.subpiece(0, space));
+    rawSize = folly::to<uint64_t>(header.subpiece(space + 1));
+  } catch (const folly::ConversionError&) {
+    throw std::invalid_argument(folly::to<std::string>(
+        "malformed compressed store value header: ", header));
+  }
+  if (codecValue != static_cast<uint32_t>(StoreCodec::Lz4) &&
+      codecValue != static_cast<uint32_t>(StoreCodec::Zstd)) {
+    throw std::invalid_argument(
+        folly::to<std::string>("unknown store codec ", codecValue));
+  }
+
+  auto payloadStart = static_cast<const char*>(headerEnd) + 1;
+  folly::StringPiece payload{
+      payloadStart,
+      reinterpret_cast<const char*>(data.data()) + data.size()};
+  auto raw =
+      folly::io::getCodec(codecType(static_cast<StoreCodec>(codecValue)))
+          ->uncompress(payload, rawSize);
+
+  folly::IOBuf result{folly::IOBuf::CREATE, raw.size()};
+  memcpy(result.writableTail(), raw.data(), raw.size());
+  result.append(raw.size());
+  return result;
+}
+
+} // namespace facebook::eden
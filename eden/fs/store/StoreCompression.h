@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/io/IOBuf.h>
+#include <optional>
+
+namespace facebook::eden {
+
+/*
+ * Application-level compression for values in the LocalStore blob key
+ * spaces.
+ *
+ * RocksDB's per-column-family compression applies a single codec to every
+ * value, but blob content wants different treatment by size: small blobs are
+ * read hot and want a cheap codec, large blobs are read rarely and want a
+ * dense one, and already-compressed artifacts want none at all. Compressing
+ * above the storage engine also keeps the choice engine-independent, so the
+ * Sqlite store benefits equally.
+ *
+ * Compressed values carry a "zblob <codec> <rawsize>\0" header ahead of the
+ * codec payload. The header cannot collide with the "blob <size>\0" prefix
+ * of git-style blob data or the "chunks <size>\0" prefix of chunked blob
+ * manifests stored in the blob key space, so compressed and plain values
+ * coexist there and old data needs no migration.
+ *
+ * Blob chunk values are different: they are raw file content with no
+ * framing, and chunk boundaries are content-defined, so a plain chunk can
+ * legitimately begin with the bytes "zblob ". The header sniff alone is
+ * therefore not sufficient for the chunk key space. Chunk keys are the
+ * SHA-1 of the raw bytes, so readers disambiguate by hashing: a value that
+ * hashes to its own key is plain content regardless of its prefix.
+ */
+
+/**
+ * Codec identifiers recorded in the value header. These are baked into
+ * on-disk data; entries must never be renumbered, only appended.
+ */
+enum class StoreCodec : uint8_t {
+  Lz4 = 1,
+  Zstd = 2,
+};
+
+/**
+ * Values smaller than this are never compressed; the header and codec
+ * overhead exceed any plausible savings.
+ */
+constexpr size_t kMinCompressibleValueSize = 256;
+
+/**
+ * Values at least this large are compressed with zstd; smaller ones use LZ4.
+ * Large blobs are read rarely enough that zstd's decompression cost is worth
+ * its better ratio, while small blobs sit on hot read paths.
+ */
+constexpr size_t kZstdValueSizeThreshold = 128 * 1024;
+
+/**
+ * Compress a value for storage, choosing a codec by size.
+ *
+ * Returns std::nullopt when the value should be stored as-is: it is too
+ * small, a cheap entropy probe says it is already compressed, or the
+ * compressed form failed to shrink it meaningfully. The returned buffer
+ * includes the value header.
+ */
+std::optional<folly::IOBuf> compressStoreValue(folly::ByteRange value);
+
+/**
+ * Undo compressStoreValue.
+ *
+ * Returns std::nullopt if the data does not carry the compression header,
+ * i.e. it is a plain value that was stored uncompressed. Throws
+ * std::invalid_argument if the header is present but malformed or names an
+ * unknown codec, which indicates corruption.
+ *
+ * Only call this on values that cannot legitimately begin with the header
+ * string when plain (framed values like the blob key space's). For raw
+ * values such as blob chunks, rule out plain content first with
+ * hasStoreCompressionHeader plus a content hash check.
+ */
+std::optional<folly::IOBuf> decompressStoreValue(folly::ByteRange data);
+
+/**
+ * Whether `data` begins with the compression header prefix. This is only a
+ * prefix sniff: raw content can begin with the same bytes, so callers whose
+ * key spaces hold unframed values must disambiguate before decompressing.
+ */
+bool hasStoreCompressionHeader(folly::ByteRange data);
+
+/**
+ * Estimate the Shannon entropy of `data` in bits per byte, sampling at most
+ * a few kilobytes. Exposed for testing.
+ */
+double estimateEntropy(folly::ByteRange data);
+
+} // namespace facebook::eden
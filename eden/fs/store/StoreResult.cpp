@@ -10,6 +10,7 @@
 #include "folly/String.h"
 
 #include <folly/io/IOBuf.h>
+#include <folly/logging/xlog.h>
 
 using folly::IOBuf;
 
@@ -22,6 +23,13 @@ void freeString(void* /* buffer */, void* userData) {
 
 namespace facebook::eden {
 
+StoreResult::StoreResult(folly::IOBuf data)
+    : valid_{true}, buf_{std::make_unique<IOBuf>(std::move(data))} {
+  XDCHECK(!buf_->isChained());
+}
+
+StoreResult::~StoreResult() = default;
+
 StoreResult StoreResult::missing(KeySpace keySpace, folly::ByteRange key) {
   return StoreResult{
       false,
@@ -31,6 +39,33 @@ StoreResult StoreResult::missing(KeySpace keySpace, folly::ByteRange key) {
           keySpace->name)};
 }
 
+const std::string& StoreResult::asString() const {
+  ensureValid();
+  if (buf_ && data_.empty() && buf_->length() != 0) {
+    data_.assign(reinterpret_cast<const char*>(buf_->data()), buf_->length());
+  }
+  return data_;
+}
+
+folly::ByteRange StoreResult::bytes() const {
+  ensureValid();
+  if (buf_) {
+    return folly::ByteRange{buf_->data(), buf_->length()};
+  }
+  return folly::StringPiece{data_};
+}
+
+std::string StoreResult::extractValue() {
+  ensureValid();
+  valid_ = false;
+  if (buf_) {
+    auto buf = std::move(buf_);
+    return std::string{
+        reinterpret_cast<const char*>(buf->data()), buf->length()};
+  }
+  return std::move(data_);
+}
+
 IOBuf StoreResult::iobufWrapper() const {
   ensureValid();
   return IOBuf{IOBuf::WRAP_BUFFER, bytes()};
@@ -39,9 +74,17 @@ IOBuf StoreResult::iobufWrapper() const {
 folly::IOBuf StoreResult::extractIOBuf() {
   ensureValid();
 
-  // Unfortunately RocksDB returns data to us in a std::string.  This makes it
-  // difficult for us to control the lifetime.  We end up having to allocate a
-  // new std::string on the heap, just to control when it will free the
+  if (buf_) {
+    // The buffer already owns its storage (possibly pinned store memory);
+    // hand it over without copying.
+    valid_ = false;
+    auto buf = std::move(buf_);
+    return std::move(*buf);
+  }
+
+  // Unfortunately RocksDB may return data to us in a std::string.  This makes
+  // it difficult for us to control the lifetime.  We end up having to allocate
+  // a new std::string on the heap, just to control when it will free the
   // underlying data it points to.
   auto stringPtr = std::make_unique<std::string>(std::move(data_));
   // Extract the data and size before we pass stringPtr.release()
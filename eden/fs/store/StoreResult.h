@@ -8,6 +8,7 @@
 #pragma once
 
 #include <folly/Range.h>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -22,15 +23,18 @@ class KeySpace;
 /*
  * StoreResult contains the result of a LocalStore lookup.
  *
- * RocksDB returns the data in a std::string (which is somewhat unfortunate,
- * since it gives us relatively poor memory management control).
+ * The result is backed either by a std::string, or by an owning IOBuf. The
+ * IOBuf form lets stores hand back storage-pinned memory (e.g. a RocksDB
+ * PinnableSlice wrapping a block cache block) without copying the value; the
+ * underlying storage is released when the result (or the IOBuf extracted
+ * from it) is destroyed.
  *
- * This class is a wrapper around the returned string, with a few benefits:
+ * This class is a wrapper around the returned data, with a few benefits:
  * - It can also represent a "not found" result, so we can efficiently handle
  *   key lookups that are not present, without throwing an exception.
  * - It is move-only, so prevents us from ever unintentionally copying the
- *   string data.
- * - It provides APIs for creating IOBuf objects around the string result.
+ *   data.
+ * - It provides APIs for creating IOBuf objects around the result.
  */
 class StoreResult {
  public:
@@ -44,10 +48,17 @@ class StoreResult {
    */
   explicit StoreResult(std::string data) : StoreResult{true, std::move(data)} {}
 
+  /**
+   * Construct a StoreResult from an owning IOBuf, without copying the
+   * payload. The IOBuf must be unchained.
+   */
+  explicit StoreResult(folly::IOBuf data);
+
   StoreResult(StoreResult&& that) noexcept
       : valid_{false}, data_{"moved-from"} {
     std::swap(valid_, that.valid_);
     std::swap(data_, that.data_);
+    std::swap(buf_, that.buf_);
   }
 
   StoreResult& operator=(StoreResult&& that) noexcept {
@@ -55,9 +66,12 @@ class StoreResult {
     // Allocate the new std::string before performing the no-except swaps.
     valid_ = std::exchange(that.valid_, false);
     data_ = std::exchange(that.data_, std::move(data));
+    buf_ = std::exchange(that.buf_, nullptr);
     return *this;
   }
 
+  ~StoreResult();
+
   /**
    * Returns true if the value was found in the store,
    * or false if the key was not present.
@@ -67,24 +81,21 @@ class StoreResult {
   }
 
   /**
-   * Get a reference to the std::string result.
+   * Get a reference to the result as a std::string.
+   *
+   * For an IOBuf-backed result this materializes (and caches) a string copy,
+   * so prefer bytes() or extractIOBuf() on hot paths.
    *
    * Throws std::domain_error if the key was not present in the store.
    */
-  const std::string& asString() const {
-    ensureValid();
-    return data_;
-  }
+  const std::string& asString() const;
 
   /**
    * Get a ByteRange pointing to the result.
    *
    * Throws std::domain_error if the key was not present in the store.
    */
-  folly::ByteRange bytes() const {
-    ensureValid();
-    return folly::StringPiece{data_};
-  }
+  folly::ByteRange bytes() const;
 
   /**
    * Get a StringPiece pointing to the result.
@@ -92,14 +103,14 @@ class StoreResult {
    * Throws std::domain_error if the key was not present in the store.
    */
   folly::StringPiece piece() const {
-    ensureValid();
-    return folly::StringPiece{data_};
+    auto b = bytes();
+    return folly::StringPiece{folly::ByteRange{b}};
   }
 
   /**
    * Return an IOBuf that temporarily wraps this StoreResult.
    *
-   * The IOBuf is unmanaged, and points to the string data contained in this
+   * The IOBuf is unmanaged, and points to the data contained in this
    * StoreResult.  It will be invalidated by any operation that invalidates the
    * StoreResult.
    */
@@ -107,12 +118,10 @@ class StoreResult {
 
   /**
    * Extract the std::string contained in this StoreResult.
+   *
+   * For an IOBuf-backed result this copies the payload into a string.
    */
-  std::string extractValue() {
-    ensureValid();
-    valid_ = false;
-    return std::move(data_);
-  }
+  std::string extractValue();
 
   /**
    * Extract the data as an IOBuf.
@@ -120,9 +129,9 @@ class StoreResult {
    * This will return a managed IOBuf, which will free the result data when
    * the last IOBuf clone is destroyed.
    *
-   * This does require a memory allocation to move the stored std::string onto
-   * the heap (but it just does a small allocation for the string object
-   * itself, and not the string data).
+   * For an IOBuf-backed result this is zero-copy; for a string-backed result
+   * it just does a small allocation to move the string object onto the heap,
+   * not a copy of the string data.
    */
   folly::IOBuf extractIOBuf();
 
@@ -147,12 +156,25 @@ class StoreResult {
   [[noreturn]] void throwInvalidError() const;
 
   /**
-   * If true, data_ contains the payload from the store.
-   * If false, it contains an error message that includes context about what was
-   * looked up.
+   * If true, the payload from the store is in buf_ if it is non-null, and in
+   * data_ otherwise.
+   * If false, data_ contains an error message that includes context about
+   * what was looked up.
    */
   bool valid_{false};
-  std::string data_;
+
+  /**
+   * Mutable so that asString() can lazily materialize a string copy of an
+   * IOBuf-backed payload.
+   */
+  mutable std::string data_;
+
+  /**
+   * When non-null, the payload lives in this (unchained) IOBuf rather than
+   * in data_. The IOBuf owns its storage, which may be pinned memory from
+   * the underlying store.
+   */
+  std::unique_ptr<folly::IOBuf> buf_;
 };
 
 } // namespace facebook::eden
@@ -7,9 +7,20 @@
 
 #include "eden/fs/store/TreeCache.h"
 
+#include <folly/hash/SpookyHashV2.h>
+
 #include "eden/fs/config/EdenConfig.h"
 
 namespace facebook::eden {
+
+namespace {
+/**
+ * Don't bother sweeping expired intern table entries until it has at least
+ * this many.
+ */
+constexpr size_t kMinInternPruneThreshold = 64;
+} // namespace
+
 std::shared_ptr<const Tree> TreeCache::get(const ObjectId& hash) {
   if (config_->getEdenConfig()->enableInMemoryTreeCaching.getValue()) {
     return getSimple(hash);
@@ -19,8 +30,57 @@ std::shared_ptr<const Tree> TreeCache::get(const ObjectId& hash) {
 
 void TreeCache::insert(std::shared_ptr<const Tree> tree) {
   if (config_->getEdenConfig()->enableInMemoryTreeCaching.getValue()) {
-    return insertSimple(tree);
+    return insertSimple(internContents(std::move(tree)));
+  }
+}
+
+std::shared_ptr<const Tree> TreeCache::internContents(
+    std::shared_ptr<const Tree> tree) {
+  // The key is a 128-bit hash of the exact serialized entry bytes, so a
+  // collision requires two distinct entry lists hashing identically. That is
+  // the same trust we already place in content addressing elsewhere.
+  auto serialized = tree->serialize();
+  uint64_t hash1 = 0;
+  uint64_t hash2 = 0;
+  folly::hash::SpookyHashV2::Hash128(
+      serialized.data(), serialized.length(), &hash1, &hash2);
+  auto key = ContentHash{hash1, hash2};
+
+  auto shared = internTable_.withWLock(
+      [&](InternTable& table) -> std::shared_ptr<const Tree::container> {
+        if (table.contents.size() >= table.pruneThreshold) {
+          for (auto it = table.contents.begin();
+               it != table.contents.end();) {
+            if (it->second.expired()) {
+              it = table.contents.erase(it);
+            } else {
+              ++it;
+            }
+          }
+          table.pruneThreshold =
+              std::max(kMinInternPruneThreshold, table.contents.size() * 2);
+        }
+
+        auto [it, inserted] = table.contents.try_emplace(key);
+        if (!inserted) {
+          if (auto existing = it->second.lock()) {
+            // A tree relocated to a case-insensitive mount serializes the
+            // same bytes but must not share a differently-keyed container.
+            if (existing->getCaseSensitivity() ==
+                tree->getCaseSensitivity()) {
+              return existing;
+            }
+            return nullptr;
+          }
+        }
+        it->second = tree->getEntries();
+        return nullptr;
+      });
+
+  if (!shared || shared == tree->getEntries()) {
+    return tree;
   }
+  return std::make_shared<const Tree>(std::move(shared), tree->getHash());
 }
 
 TreeCache::TreeCache(std::shared_ptr<ReloadableConfig> config)
@@ -7,6 +7,10 @@
 
 #pragma once
 
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/hash/Hash.h>
+
 #include "eden/fs/config/ReloadableConfig.h"
 #include "eden/fs/model/Tree.h"
 #include "eden/fs/store/ObjectCache.h"
@@ -56,11 +60,46 @@ class TreeCache : public ObjectCache<Tree, ObjectCacheFlavor::Simple> {
   void insert(std::shared_ptr<const Tree> tree);
 
  private:
+  /**
+   * Key for the interned-contents table: a 128-bit SpookyHash of the tree's
+   * serialized entry list.
+   */
+  using ContentHash = std::pair<uint64_t, uint64_t>;
+
+  /**
+   * Deduplicate the tree's entry container against previously inserted trees.
+   *
+   * Directory contents are frequently byte-identical across commits (think
+   * hundreds of unchanged node_modules trees reachable from different commit
+   * walks), but each commit's walk loads them under distinct ObjectIds. This
+   * hashes the tree's serialized contents and, if an identical container is
+   * already live in the cache, returns a tree sharing that container instead.
+   * Returns the input tree unchanged when its contents are new.
+   */
+  std::shared_ptr<const Tree> internContents(std::shared_ptr<const Tree> tree);
+
   /**
    * Reference to the eden config, may be a null pointer in unit tests.
    */
   std::shared_ptr<ReloadableConfig> config_;
 
+  struct InternTable {
+    folly::F14FastMap<
+        ContentHash,
+        std::weak_ptr<const Tree::container>,
+        folly::Hash>
+        contents;
+
+    /**
+     * Expired entries are swept whenever the table grows past this; it then
+     * resizes to twice the live count. Entries expire as the cache evicts the
+     * trees holding the underlying containers.
+     */
+    size_t pruneThreshold{0};
+  };
+
+  folly::Synchronized<InternTable> internTable_;
+
   explicit TreeCache(std::shared_ptr<ReloadableConfig> config);
 };
 
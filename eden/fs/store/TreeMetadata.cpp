@@ -134,6 +134,52 @@ IOBuf TreeMetadata::serializeV2(size_t serialized_size) const {
   return buf;
 }
 
+// V3 format stores only the entry hashes; the per-entry metadata lives in
+// its own content-addressed records keyed by those hashes (the same keying
+// BlobMetadata already uses). Since the same entry hash resolves to the same
+// record no matter how many tree versions reference it, metadata shared
+// across tree versions is stored once rather than once per tree.
+IOBuf TreeMetadata::serializeSplit() const {
+  auto hashIndexedEntries =
+      std::get_if<HashIndexedEntryMetadata>(&entryMetadata_);
+  if (!hashIndexedEntries) {
+    throw std::domain_error(
+        "Identifiers for entries are not hashes, can not serialize.");
+  }
+  // <NumberOfEntries> <Version>
+  size_t serialized_size = sizeof(uint32_t) + sizeof(uint32_t);
+  for (auto& [hash, _] : *hashIndexedEntries) {
+    serialized_size += sizeof(uint16_t) + hash.size();
+  }
+  IOBuf buf(IOBuf::CREATE, serialized_size);
+  Appender appender(&buf, 0);
+
+  auto numberOfEntries = getNumberOfEntries();
+  XCHECK_LT(numberOfEntries, SERIALIZED_V2_MARKER);
+  uint32_t numberOfEntries32 = folly::to_narrow(numberOfEntries);
+  appender.write<uint32_t>(numberOfEntries32 | SERIALIZED_V2_MARKER);
+  appender.write<uint32_t>(V3_VERSION);
+  for (auto& [hash, _] : *hashIndexedEntries) {
+    auto bytes = hash.getBytes();
+    XCHECK_LE(bytes.size(), std::numeric_limits<uint16_t>::max());
+    appender.write<uint16_t>(folly::to_narrow(bytes.size()));
+    appender.push(bytes);
+  }
+  return buf;
+}
+
+namespace {
+uint32_t peekVersion(folly::StringPiece data) {
+  if (data.size() < sizeof(uint32_t)) {
+    throw std::invalid_argument(
+        "buffer too small -- serialized tree has no version");
+  }
+  uint32_t version;
+  memcpy(&version, data.data(), sizeof(uint32_t));
+  return version;
+}
+} // namespace
+
 TreeMetadata TreeMetadata::deserialize(const StoreResult& result) {
   auto data = result.piece();
   if (data.size() < sizeof(uint32_t)) {
@@ -144,11 +190,114 @@ TreeMetadata TreeMetadata::deserialize(const StoreResult& result) {
   memcpy(&numberOfEntries, data.data(), sizeof(uint32_t));
   data.advance(sizeof(uint32_t));
   if ((numberOfEntries & SERIALIZED_V2_MARKER) == SERIALIZED_V2_MARKER) {
+    if (peekVersion(data) == V3_VERSION) {
+      throw std::invalid_argument(
+          "split tree metadata record carries no inline metadata -- use "
+          "deserializeEntryIds and look entries up individually");
+    }
     return deserializeV2(data, numberOfEntries - SERIALIZED_V2_MARKER);
   }
   return deserializeV1(data, numberOfEntries);
 }
 
+std::vector<ObjectId> TreeMetadata::deserializeEntryIds(
+    const StoreResult& result) {
+  auto data = result.piece();
+  if (data.size() < 2 * sizeof(uint32_t)) {
+    throw std::invalid_argument(
+        "buffer too small -- split tree metadata has no header");
+  }
+  uint32_t numberOfEntries;
+  memcpy(&numberOfEntries, data.data(), sizeof(uint32_t));
+  data.advance(sizeof(uint32_t));
+  if ((numberOfEntries & SERIALIZED_V2_MARKER) != SERIALIZED_V2_MARKER ||
+      peekVersion(data) != V3_VERSION) {
+    throw std::invalid_argument(
+        "not a split tree metadata record -- use deserialize");
+  }
+  data.advance(sizeof(uint32_t));
+  numberOfEntries -= SERIALIZED_V2_MARKER;
+
+  std::vector<ObjectId> entryIds;
+  entryIds.reserve(numberOfEntries);
+  for (uint32_t i = 0; i < numberOfEntries; ++i) {
+    if (data.size() < sizeof(uint16_t)) {
+      throw std::invalid_argument(
+          "buffer too small -- split tree metadata does not contain all "
+          "entry hashes");
+    }
+    uint16_t size;
+    memcpy(&size, data.data(), sizeof(uint16_t));
+    data.advance(sizeof(uint16_t));
+    if (data.size() < size) {
+      throw std::invalid_argument(
+          "buffer too small -- split tree metadata does not contain all "
+          "entry hashes");
+    }
+    entryIds.emplace_back(ByteRange{StringPiece{data, 0, size}});
+    data.advance(size);
+  }
+  return entryIds;
+}
+
+std::optional<BlobMetadata> TreeMetadata::findEntry(
+    folly::StringPiece data,
+    const ObjectId& id) {
+  if (data.size() < sizeof(uint32_t)) {
+    return std::nullopt;
+  }
+  uint32_t numberOfEntries;
+  memcpy(&numberOfEntries, data.data(), sizeof(uint32_t));
+  data.advance(sizeof(uint32_t));
+
+  if ((numberOfEntries & SERIALIZED_V2_MARKER) != SERIALIZED_V2_MARKER) {
+    // V1: fixed 20-byte hashes, fixed stride -- scan without decoding the
+    // metadata of entries we skip over.
+    if (id.size() != Hash20::RAW_SIZE ||
+        data.size() < numberOfEntries * ENTRY_SIZE_V1) {
+      return std::nullopt;
+    }
+    auto idBytes = id.getBytes();
+    for (uint32_t i = 0; i < numberOfEntries; ++i) {
+      if (memcmp(data.data(), idBytes.data(), Hash20::RAW_SIZE) == 0) {
+        data.advance(Hash20::RAW_SIZE);
+        return SerializedBlobMetadata::unslice(
+            ByteRange{StringPiece{data, 0, SerializedBlobMetadata::SIZE}});
+      }
+      data.advance(ENTRY_SIZE_V1);
+    }
+    return std::nullopt;
+  }
+
+  if (peekVersion(data) != V2_VERSION) {
+    // V3 split records hold no inline metadata to find.
+    return std::nullopt;
+  }
+  data.advance(sizeof(uint32_t));
+  numberOfEntries -= SERIALIZED_V2_MARKER;
+
+  auto idBytes = id.getBytes();
+  for (uint32_t i = 0; i < numberOfEntries; ++i) {
+    if (data.size() < sizeof(uint16_t)) {
+      return std::nullopt;
+    }
+    uint16_t size;
+    memcpy(&size, data.data(), sizeof(uint16_t));
+    data.advance(sizeof(uint16_t));
+    if (data.size() < size + SerializedBlobMetadata::SIZE) {
+      return std::nullopt;
+    }
+    if (size == idBytes.size() &&
+        memcmp(data.data(), idBytes.data(), size) == 0) {
+      data.advance(size);
+      return SerializedBlobMetadata::unslice(
+          ByteRange{StringPiece{data, 0, SerializedBlobMetadata::SIZE}});
+    }
+    data.advance(size + SerializedBlobMetadata::SIZE);
+  }
+  return std::nullopt;
+}
+
 TreeMetadata TreeMetadata::deserializeV1(
     folly::StringPiece data,
     uint32_t numberOfEntries) {
@@ -60,8 +60,38 @@ class TreeMetadata {
    */
   folly::IOBuf serialize() const;
 
+  /**
+   * Serializes only the entry hashes (the V3 split format). The per-entry
+   * metadata is not embedded: it is expected to be stored content-addressed
+   * under each entry's hash, the way BlobMetadata already is, so identical
+   * entry metadata repeated across tree versions is stored once instead of
+   * once per tree. Use deserializeEntryIds() to read it back and look each
+   * entry up individually.
+   */
+  folly::IOBuf serializeSplit() const;
+
   static TreeMetadata deserialize(const StoreResult& result);
 
+  /**
+   * Reads the entry hashes out of a V3 split record written by
+   * serializeSplit(). Throws std::invalid_argument for the embedded V1/V2
+   * formats; those carry their metadata inline and should go through
+   * deserialize() or findEntry().
+   */
+  static std::vector<ObjectId> deserializeEntryIds(const StoreResult& result);
+
+  /**
+   * Decodes the metadata for a single entry out of a serialized V1 or V2
+   * record without materializing the whole tree's worth of pairs. Wide
+   * trees probed for one or two entries by attribute queries pay for just
+   * the entries scanned rather than a full deserialize. Returns nullopt
+   * when the hash is not present or the record is the V3 split format
+   * (which carries no inline metadata).
+   */
+  static std::optional<BlobMetadata> findEntry(
+      folly::StringPiece data,
+      const ObjectId& id);
+
   const EntryMetadata& entries() const {
     return entryMetadata_;
   }
@@ -86,6 +116,7 @@ class TreeMetadata {
 
   static constexpr uint32_t SERIALIZED_V2_MARKER = 1u << 31;
   static constexpr uint32_t V2_VERSION = 2u;
+  static constexpr uint32_t V3_VERSION = 3u;
 
   EntryMetadata entryMetadata_;
 };
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/TreePrefetcher.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+#include "eden/fs/model/Tree.h"
+#include "eden/fs/store/ObjectStore.h"
+
+namespace facebook::eden {
+
+namespace {
+
+/**
+ * Matches the batch size ThriftGlobImpl feeds to prefetchBlobs; larger
+ * batches make single fetch requests unreasonably large.
+ */
+constexpr size_t kPrefetchBatchSize = 20480;
+
+struct WalkContext {
+  TreePrefetchStats stats;
+  bool prefetchBlobs = false;
+  /**
+   * Blob batches already handed to the store. They complete independently of
+   * the tree walk and are drained once the walk finishes.
+   */
+  std::vector<ImmediateFuture<folly::Unit>> blobFetches;
+};
+
+void startBlobPrefetch(
+    std::shared_ptr<WalkContext>& ctx,
+    ObjectStore& objectStore,
+    const ObjectFetchContextPtr& fetchContext,
+    std::vector<ObjectId> blobIds) {
+  // The BackingStore layer does not deduplicate fetches, so drop ids
+  // appearing several times within this level before handing them over.
+  std::sort(blobIds.begin(), blobIds.end());
+  blobIds.erase(std::unique(blobIds.begin(), blobIds.end()), blobIds.end());
+  ctx->stats.blobsPrefetched += blobIds.size();
+
+  // prefetchBlobs borrows the id storage for as long as the returned future
+  // is pending, so each batch keeps the vector alive.
+  auto ids = std::make_shared<std::vector<ObjectId>>(std::move(blobIds));
+  auto range = folly::Range{ids->data(), ids->size()};
+  while (range.size() > kPrefetchBatchSize) {
+    auto curRange = range.subpiece(0, kPrefetchBatchSize);
+    range.advance(kPrefetchBatchSize);
+    ctx->blobFetches.emplace_back(
+        objectStore.prefetchBlobs(curRange, fetchContext).ensure([ids] {}));
+  }
+  if (!range.empty()) {
+    ctx->blobFetches.emplace_back(
+        objectStore.prefetchBlobs(range, fetchContext).ensure([ids] {}));
+  }
+}
+
+/**
+ * Scan one level of trees: queue a blob prefetch for the files found there,
+ * fetch the distinct child trees as one concurrent batch, and recurse until
+ * the depth limit or the leaves are reached.
+ */
+ImmediateFuture<TreePrefetchStats> prefetchLevel(
+    std::shared_ptr<WalkContext> ctx,
+    ObjectStore& objectStore,
+    const ObjectFetchContextPtr& fetchContext,
+    std::vector<std::shared_ptr<const Tree>> level,
+    std::optional<uint32_t> depthRemaining) {
+  ctx->stats.treesWalked += level.size();
+
+  std::vector<ObjectId> blobIds;
+  std::vector<ObjectId> treeIds;
+  std::unordered_set<ObjectId> seenTrees;
+  bool descend = !depthRemaining.has_value() || *depthRemaining > 0;
+  for (const auto& tree : level) {
+    for (const auto& [name, entry] : *tree) {
+      if (entry.isTree()) {
+        if (descend && seenTrees.insert(entry.getHash()).second) {
+          treeIds.push_back(entry.getHash());
+        }
+      } else if (ctx->prefetchBlobs) {
+        blobIds.push_back(entry.getHash());
+      }
+    }
+  }
+
+  if (!blobIds.empty()) {
+    startBlobPrefetch(ctx, objectStore, fetchContext, std::move(blobIds));
+  }
+
+  if (treeIds.empty()) {
+    // The walk is done; wait for the blob batches still in flight.
+    auto blobFetches = std::move(ctx->blobFetches);
+    return collectAll(std::move(blobFetches))
+        .thenValue([ctx = std::move(ctx)](
+                       std::vector<folly::Try<folly::Unit>>&& tries) {
+          for (auto& try_ : tries) {
+            try_.throwUnlessValue();
+          }
+          return ctx->stats;
+        });
+  }
+
+  auto nextDepth = depthRemaining
+      ? std::optional<uint32_t>{*depthRemaining - 1}
+      : std::nullopt;
+  // Fetch the whole level in one call: trees already in the local store are
+  // served by a single batched read, and the rest coalesce in the import
+  // queue.
+  return objectStore.getTrees(treeIds, fetchContext)
+      .thenValue([ctx = std::move(ctx),
+                  &objectStore,
+                  fetchContext = fetchContext.copy(),
+                  nextDepth](
+                     std::vector<std::shared_ptr<const Tree>>&&
+                         nextLevel) mutable {
+        return prefetchLevel(
+            std::move(ctx),
+            objectStore,
+            fetchContext,
+            std::move(nextLevel),
+            nextDepth);
+      });
+}
+
+} // namespace
+
+ImmediateFuture<TreePrefetchStats> prefetchTreeRecursive(
+    ObjectStore& objectStore,
+    const ObjectFetchContextPtr& fetchContext,
+    std::shared_ptr<const Tree> root,
+    std::optional<uint32_t> maxDepth,
+    bool prefetchBlobs) {
+  auto ctx = std::make_shared<WalkContext>();
+  ctx->prefetchBlobs = prefetchBlobs;
+  std::vector<std::shared_ptr<const Tree>> level;
+  level.push_back(std::move(root));
+  return prefetchLevel(
+      std::move(ctx), objectStore, fetchContext, std::move(level), maxDepth);
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "eden/fs/store/ObjectFetchContext.h"
+#include "eden/fs/utils/ImmediateFuture.h"
+
+namespace facebook::eden {
+
+class ObjectStore;
+class Tree;
+
+struct TreePrefetchStats {
+  uint64_t treesWalked = 0;
+  uint64_t blobsPrefetched = 0;
+};
+
+/**
+ * Walk the trees under `root` breadth-first, prefetching as it goes.
+ *
+ * The distinct child trees of each level are fetched as one concurrent
+ * batch, and the blobs discovered at a level are handed to
+ * ObjectStore::prefetchBlobs as soon as the level has been scanned, so blob
+ * fetching overlaps the rest of the walk instead of waiting for discovery to
+ * finish.
+ *
+ * `maxDepth` bounds how many levels below `root` are descended; nullopt
+ * walks all the way to the leaves. Pass prefetchBlobs=false to fetch only
+ * the trees.
+ */
+ImmediateFuture<TreePrefetchStats> prefetchTreeRecursive(
+    ObjectStore& objectStore,
+    const ObjectFetchContextPtr& fetchContext,
+    std::shared_ptr<const Tree> root,
+    std::optional<uint32_t> maxDepth,
+    bool prefetchBlobs);
+
+} // namespace facebook::eden
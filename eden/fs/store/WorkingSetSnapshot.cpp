@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/WorkingSetSnapshot.h"
+
+#include <folly/logging/xlog.h>
+
+#include "eden/fs/model/Hash.h"
+#include "eden/fs/utils/Throw.h"
+
+namespace facebook::eden {
+
+namespace {
+
+constexpr uint8_t kWorkingSetFormatVersion = 1;
+
+// Per-record overhead: type byte and ID length byte.
+constexpr size_t kRecordHeaderSize = 2;
+
+void appendRecords(
+    std::string& out,
+    char type,
+    const std::vector<ObjectId>& ids) {
+  for (const auto& id : ids) {
+    auto bytes = id.getBytes();
+    XCHECK_LE(bytes.size(), size_t{0xff});
+    out.push_back(type);
+    out.push_back(static_cast<char>(bytes.size()));
+    out.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  }
+}
+
+} // namespace
+
+std::string serializeWorkingSet(const WorkingSet& workingSet) {
+  std::string out;
+  // IDs are almost always hash sized; reserving for 20-byte IDs avoids
+  // reallocation in the common case without being exact.
+  out.reserve(
+      1 +
+      (workingSet.blobs.size() + workingSet.trees.size()) *
+          (kRecordHeaderSize + Hash20::RAW_SIZE));
+  out.push_back(static_cast<char>(kWorkingSetFormatVersion));
+  appendRecords(out, 'b', workingSet.blobs);
+  appendRecords(out, 't', workingSet.trees);
+  return out;
+}
+
+WorkingSet deserializeWorkingSet(folly::ByteRange data) {
+  if (data.empty()) {
+    throw_<std::invalid_argument>("empty working set snapshot");
+  }
+  if (data.front() != kWorkingSetFormatVersion) {
+    throwf<std::invalid_argument>(
+        "unsupported working set snapshot version {}", data.front());
+  }
+  data.advance(1);
+
+  WorkingSet workingSet;
+  while (!data.empty()) {
+    if (data.size() < kRecordHeaderSize) {
+      throw_<std::invalid_argument>("truncated working set snapshot record");
+    }
+    char type = static_cast<char>(data[0]);
+    size_t idSize = data[1];
+    data.advance(kRecordHeaderSize);
+    if (data.size() < idSize) {
+      throw_<std::invalid_argument>("truncated working set snapshot ID");
+    }
+    ObjectId id{folly::ByteRange{data.data(), idSize}};
+    data.advance(idSize);
+    switch (type) {
+      case 'b':
+        workingSet.blobs.push_back(std::move(id));
+        break;
+      case 't':
+        workingSet.trees.push_back(std::move(id));
+        break;
+      default:
+        throwf<std::invalid_argument>(
+            "unknown working set snapshot record type {}", type);
+    }
+  }
+  return workingSet;
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <folly/Range.h>
+
+#include "eden/fs/model/ObjectId.h"
+
+namespace facebook::eden {
+
+/**
+ * The IDs of the objects resident in the in-memory blob and tree caches at
+ * the time a snapshot was taken. Periodically written to
+ * KeySpace::WorkingSetFamily and streamed back into the caches after a cold
+ * start; see EdenServer::snapshotWorkingSet.
+ */
+struct WorkingSet {
+  std::vector<ObjectId> blobs;
+  std::vector<ObjectId> trees;
+};
+
+/**
+ * The key under which the snapshot is stored in KeySpace::WorkingSetFamily.
+ * There is only ever one snapshot; each write replaces the previous one.
+ */
+constexpr folly::StringPiece kWorkingSetKey{"working-set"};
+
+/**
+ * Serialize a working set for storage in the LocalStore.
+ *
+ * The format is a one byte version followed by one record per object: a type
+ * byte ('b' for blobs, 't' for trees), a one byte ID length and the raw ID
+ * bytes. ObjectId lengths vary across backing stores, so they cannot be
+ * implied by the format.
+ */
+std::string serializeWorkingSet(const WorkingSet& workingSet);
+
+/**
+ * Parse a serialized working set.
+ *
+ * Throws std::invalid_argument if the data is truncated or from an
+ * unsupported version. Callers should treat that as an absent snapshot: the
+ * data is advisory and is regenerated on the next snapshot interval.
+ */
+WorkingSet deserializeWorkingSet(folly::ByteRange data);
+
+} // namespace facebook::eden
@@ -6,11 +6,15 @@
  */
 
 #include <sysexits.h>
+#include <atomic>
 #include <memory>
 #include <optional>
+#include <thread>
 
+#include <folly/MPMCQueue.h>
 #include <folly/Range.h>
 #include <folly/String.h>
+#include <folly/Synchronized.h>
 #include <folly/container/Array.h>
 #include <folly/container/Enumerate.h>
 #include <folly/init/Init.h>
@@ -20,10 +24,21 @@
 
 #include "eden/fs/config/EdenConfig.h"
 #include "eden/fs/config/ReloadableConfig.h"
+#include "eden/fs/model/Blob.h"
+#include "eden/fs/model/BlobMetadata.h"
+#include "eden/fs/model/Hash.h"
+#include "eden/fs/model/ObjectId.h"
+#include "eden/fs/model/Tree.h"
+#include "eden/fs/model/git/GitBlob.h"
+#include "eden/fs/model/git/GitTree.h"
 #include "eden/fs/service/EdenInit.h"
 #include "eden/fs/service/EdenStateDir.h"
+#include "eden/fs/store/BlobChunking.h"
 #include "eden/fs/store/KeySpace.h"
 #include "eden/fs/store/RocksDbLocalStore.h"
+#include "eden/fs/store/SerializedBlobMetadata.h"
+#include "eden/fs/store/StoreCompression.h"
+#include "eden/fs/store/StoreResult.h"
 #include "eden/fs/telemetry/NullStructuredLogger.h"
 #include "eden/fs/utils/FaultInjector.h"
 #include "eden/fs/utils/UserInfo.h"
@@ -37,6 +52,16 @@ using std::optional;
 FOLLY_INIT_LOGGING_CONFIG("eden=DBG2; default:async=true");
 
 DEFINE_string(keySpace, "", "operate on just a single key space");
+DEFINE_int32(
+    numThreads,
+    0,
+    "number of verification worker threads for the verify command "
+    "(0 means one per CPU)");
+DEFINE_bool(
+    repack,
+    false,
+    "while verifying, rewrite blob values with the current compression "
+    "codec policy");
 
 namespace {
 
@@ -206,13 +231,254 @@ class ShowSizesCommand : public Command {
   }
 };
 
+class VerifyCommand : public Command {
+ public:
+  static constexpr auto name = StringPiece("verify");
+  static constexpr auto help = StringPiece(
+      "Verify object integrity with parallel hash checks; with --repack, "
+      "rewrite blob values with the current compression codec policy");
+
+  void run() override {
+    auto mode =
+        FLAGS_repack ? RocksDBOpenMode::ReadWrite : RocksDBOpenMode::ReadOnly;
+    auto localStore = openLocalStore(mode);
+
+    std::vector<KeySpace> keySpaces;
+    if (auto keySpace = getKeySpace()) {
+      keySpaces.push_back(*keySpace);
+    } else {
+      // Only the object key spaces have application-level structure worth
+      // checking; the others are exercised by RocksDB block checksums
+      // during any scan.
+      keySpaces.push_back(KeySpace::BlobFamily);
+      keySpaces.push_back(KeySpace::TreeFamily);
+    }
+
+    for (auto& keySpace : keySpaces) {
+      verifyKeySpace(*localStore, keySpace);
+    }
+  }
+
+ private:
+  /**
+   * One scanned record, copied out of the RocksDB iterator so workers can
+   * process it after the iterator has moved on. An empty key is the
+   * end-of-scan sentinel; real keys are object IDs and never empty.
+   */
+  struct WorkItem {
+    std::string key;
+    std::string value;
+  };
+
+  static constexpr size_t kQueueCapacity = 2048;
+  static constexpr size_t kRepackBatchBytes = 4 * 1024 * 1024;
+  static constexpr size_t kMaxReportedKeys = 100;
+  static constexpr uint64_t kProgressInterval = 50000;
+
+  void verifyKeySpace(RocksDbLocalStore& store, KeySpace keySpace) {
+    size_t numThreads = FLAGS_numThreads > 0
+        ? FLAGS_numThreads
+        : std::max(1u, std::thread::hardware_concurrency());
+    bool repack = FLAGS_repack &&
+        keySpace->index == KeySpace::BlobFamily.index;
+
+    XLOG(INFO) << "Verifying key space \"" << keySpace->name << "\" with "
+               << numThreads << " threads"
+               << (repack ? " (repacking blob values)" : "");
+
+    // The scan thread is expected to be the disk-bound side; the bounded
+    // queue keeps it from buffering the whole column family in memory if
+    // the hash workers fall behind.
+    folly::MPMCQueue<WorkItem> queue{kQueueCapacity};
+    std::atomic<uint64_t> corrupt{0};
+    std::atomic<uint64_t> repackedCount{0};
+    std::atomic<uint64_t> repackedSavings{0};
+    folly::Synchronized<std::vector<std::string>> corruptKeys;
+
+    auto recordCorrupt = [&](const std::string& keyHex,
+                             const std::string& reason) {
+      ++corrupt;
+      XLOG(ERR) << "corrupt object " << keyHex << " in key space \""
+                << keySpace->name << "\": " << reason;
+      auto keys = corruptKeys.wlock();
+      if (keys->size() < kMaxReportedKeys) {
+        keys->push_back(keyHex);
+      }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+      workers.emplace_back([&] {
+        std::unique_ptr<LocalStore::WriteBatch> batch;
+        if (repack) {
+          batch = store.beginWrite(kRepackBatchBytes);
+        }
+        WorkItem item;
+        while (true) {
+          queue.blockingRead(item);
+          if (item.key.empty()) {
+            break;
+          }
+          verifyObject(store, keySpace, item, batch.get(), recordCorrupt, repackedCount, repackedSavings);
+        }
+        if (batch) {
+          batch->flush();
+        }
+      });
+    }
+
+    folly::stop_watch<std::chrono::milliseconds> watch;
+    uint64_t scanned = 0;
+    uint64_t scannedBytes = 0;
+    auto logProgress = [&] {
+      auto seconds = watch.elapsed().count() / 1000.0;
+      XLOG(INFO) << "  scanned " << scanned << " objects, "
+                 << folly::prettyPrint(scannedBytes, folly::PRETTY_BYTES_METRIC)
+                 << " in " << seconds << "s ("
+                 << folly::prettyPrint(
+                        seconds > 0 ? scannedBytes / seconds : 0,
+                        folly::PRETTY_BYTES_METRIC)
+                 << "/s)";
+    };
+
+    store.iterateKeySpace(
+        keySpace, [&](folly::ByteRange key, folly::ByteRange value) {
+          queue.blockingWrite(WorkItem{
+              std::string{reinterpret_cast<const char*>(key.data()), key.size()},
+              std::string{
+                  reinterpret_cast<const char*>(value.data()), value.size()}});
+          ++scanned;
+          scannedBytes += value.size();
+          if (scanned % kProgressInterval == 0) {
+            logProgress();
+          }
+          return true;
+        });
+
+    for (size_t i = 0; i < numThreads; ++i) {
+      queue.blockingWrite(WorkItem{});
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+
+    logProgress();
+    XLOG(INFO) << "Key space \"" << keySpace->name << "\": " << scanned
+               << " objects verified, " << corrupt.load() << " corrupt";
+    if (repack) {
+      XLOG(INFO) << "  repacked " << repackedCount.load()
+                 << " blob values, saving "
+                 << folly::prettyPrint(
+                        repackedSavings.load(), folly::PRETTY_BYTES_METRIC);
+    }
+    for (const auto& keyHex : *corruptKeys.rlock()) {
+      XLOG(INFO) << "  corrupt: " << keyHex;
+    }
+  }
+
+  template <typename RecordCorrupt>
+  void verifyObject(
+      RocksDbLocalStore& store,
+      KeySpace keySpace,
+      const WorkItem& item,
+      LocalStore::WriteBatch* batch,
+      const RecordCorrupt& recordCorrupt,
+      std::atomic<uint64_t>& repackedCount,
+      std::atomic<uint64_t>& repackedSavings) {
+    folly::ByteRange keyBytes{folly::StringPiece{item.key}};
+    folly::ByteRange valueBytes{folly::StringPiece{item.value}};
+    ObjectId id{keyBytes};
+
+    if (keySpace->index == KeySpace::TreeFamily.index) {
+      if (Tree::tryDeserialize(id, folly::StringPiece{item.value})) {
+        return;
+      }
+      try {
+        deserializeGitTree(id, valueBytes);
+      } catch (const std::exception& ex) {
+        recordCorrupt(
+            folly::hexlify(keyBytes),
+            fmt::format("undeserializable tree: {}", ex.what()));
+      }
+      return;
+    }
+
+    // Blob values may carry a compression header; peel it first.
+    folly::IOBuf contents{folly::IOBuf::WRAP_BUFFER, valueBytes};
+    bool storedPlain = true;
+    try {
+      if (auto raw = decompressStoreValue(valueBytes)) {
+        contents = std::move(*raw);
+        storedPlain = false;
+      }
+    } catch (const std::invalid_argument& ex) {
+      recordCorrupt(
+          folly::hexlify(keyBytes),
+          fmt::format("bad compression header: {}", ex.what()));
+      return;
+    }
+
+    auto contentBytes = contents.coalesce();
+    if (parseChunkedBlobManifest(contentBytes)) {
+      // The chunk payloads live under their own keys and are verified by
+      // scanning that key space; the manifest parse is the check here.
+      return;
+    }
+
+    std::unique_ptr<Blob> blob;
+    try {
+      blob = deserializeGitBlob(id, &contents);
+    } catch (const std::exception& ex) {
+      recordCorrupt(
+          folly::hexlify(keyBytes),
+          fmt::format("undeserializable blob: {}", ex.what()));
+      return;
+    }
+
+    // When a metadata row exists for this blob it records the content
+    // SHA-1; recomputing it catches bit rot that still deserializes.
+    auto metaResult = store.get(KeySpace::BlobMetaDataFamily, keyBytes);
+    if (metaResult.isValid()) {
+      try {
+        auto metadata = SerializedBlobMetadata::parse(id, metaResult);
+        auto actual = Hash20::sha1(blob->getContents());
+        if (actual != metadata.sha1) {
+          recordCorrupt(
+              folly::hexlify(keyBytes),
+              fmt::format(
+                  "content SHA-1 mismatch: expected {}, computed {}",
+                  metadata.sha1.toString(),
+                  actual.toString()));
+          return;
+        }
+      } catch (const std::exception& ex) {
+        recordCorrupt(
+            folly::hexlify(keyBytes),
+            fmt::format("unparseable blob metadata: {}", ex.what()));
+        return;
+      }
+    }
+
+    if (batch && storedPlain) {
+      if (auto compressed = compressStoreValue(valueBytes)) {
+        auto compressedBytes = compressed->coalesce();
+        batch->put(keySpace, keyBytes, compressedBytes);
+        ++repackedCount;
+        repackedSavings += valueBytes.size() - compressedBytes.size();
+      }
+    }
+  }
+};
+
 std::unique_ptr<Command> createCommand(StringPiece name) {
   auto commands = make_array<std::unique_ptr<CommandFactory>>(
       make_unique<CommandFactoryT<GcCommand>>(),
       make_unique<CommandFactoryT<ClearCommand>>(),
       make_unique<CommandFactoryT<CompactCommand>>(),
       make_unique<CommandFactoryT<RepairCommand>>(),
-      make_unique<CommandFactoryT<ShowSizesCommand>>());
+      make_unique<CommandFactoryT<ShowSizesCommand>>(),
+      make_unique<CommandFactoryT<VerifyCommand>>());
 
   std::unique_ptr<Command> command;
   for (const auto& factory : commands) {
@@ -558,7 +558,59 @@ folly::Future<std::unique_ptr<Tree>> HgBackingStore::importTreeManifestImpl(
       break;
   }
 
-  return importTreeImpl(manifestNode, objectId, path);
+  return importTreeImpl(manifestNode, objectId, path)
+      .thenValue([this](std::unique_ptr<Tree> rootTree) {
+        // A commit's root tree is almost always followed by fetches of its
+        // subtrees (checkout descends into them immediately), and a cold
+        // checkout would otherwise import them one at a time on demand.
+        // Start importing them now so the importer threads are saturated by
+        // the time checkout gets there.
+        prefetchTreeChildren(*rootTree);
+        return rootTree;
+      });
+}
+
+void HgBackingStore::prefetchTreeChildren(const Tree& rootTree) {
+  auto fanout = config_->getEdenConfig()->hgRootTreeImportFanout.getValue();
+  if (fanout == 0) {
+    return;
+  }
+
+  std::vector<std::pair<ObjectId, HgProxyHash>> children;
+  for (const auto& [name, entry] : rootTree) {
+    if (!entry.isTree()) {
+      continue;
+    }
+    auto proxyHash = HgProxyHash::tryParseEmbeddedProxyHash(entry.getHash());
+    if (!proxyHash) {
+      // Legacy object IDs need a LocalStore lookup to resolve; don't bother
+      // for a background warm-up.
+      continue;
+    }
+    children.emplace_back(entry.getHash(), std::move(*proxyHash));
+  }
+  if (children.empty()) {
+    return;
+  }
+
+  XLOG(DBG4) << "prefetching " << children.size()
+             << " child trees of imported root tree " << rootTree.getHash();
+
+  // Import at most `fanout` subtrees at a time so a huge root directory
+  // cannot monopolize the importer, and detach the whole batch: the imports
+  // only exist to populate the hgcache, so failures here are harmless and
+  // will surface on the on-demand fetch if the tree is actually needed.
+  auto futures = folly::window(
+      std::move(children),
+      [this](std::pair<ObjectId, HgProxyHash>&& child) {
+        return importTreeImpl(
+                   child.second.revHash(), child.first, child.second.path())
+            .thenTry(
+                [](folly::Try<std::unique_ptr<Tree>>) { return folly::unit; });
+      },
+      fanout);
+  folly::futures::detachOnGlobalCPUExecutor(
+      folly::collectAll(std::move(futures)).unit());
 }
 
 SemiFuture<std::unique_ptr<Blob>> HgBackingStore::fetchBlobFromHgImporter(
@@ -131,6 +131,14 @@ class HgBackingStore {
   folly::Future<std::unique_ptr<Tree>> importTreeManifestImpl(
       Hash20 manifestNode);
 
+  /**
+   * Kick off imports of the given root tree's child trees, importing up to
+   * `hg:root-tree-import-fanout` of them concurrently. The imports run in
+   * the background purely to warm the hgcache; their results and errors are
+   * discarded. See importTreeManifestImpl().
+   */
+  void prefetchTreeChildren(const Tree& rootTree);
+
   void initializeDatapackImport(AbsolutePathPiece repository);
   folly::Future<std::unique_ptr<Tree>> importTreeImpl(
       const Hash20& manifestNode,
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/hg/HgBootstrapBundle.h"
+
+#include <cstring>
+
+#include <fmt/format.h>
+#include <folly/lang/Bits.h>
+
+#include "eden/fs/model/ObjectId.h"
+#include "eden/fs/model/RootId.h"
+#include "eden/fs/model/Tree.h"
+#include "eden/fs/utils/Throw.h"
+
+namespace facebook::eden {
+
+namespace {
+
+// Bump when the record layout below changes; readers reject versions they
+// do not know.
+constexpr uint8_t kBundleFormatVersion = 1;
+
+// Every record is a tree: a length-prefixed object ID followed by the
+// length-prefixed output of Tree::serialize(). All integers are
+// little-endian so bundles can be produced on any host.
+void appendLe16(std::string& out, uint16_t value) {
+  value = folly::Endian::little(value);
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendLe32(std::string& out, uint32_t value) {
+  value = folly::Endian::little(value);
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T consumeLe(folly::ByteRange& data) {
+  if (data.size() < sizeof(T)) {
+    throw_<std::invalid_argument>("truncated bootstrap bundle");
+  }
+  T value;
+  memcpy(&value, data.data(), sizeof(T));
+  data.advance(sizeof(T));
+  return folly::Endian::little(value);
+}
+
+folly::ByteRange consumeBytes(folly::ByteRange& data, size_t length) {
+  if (data.size() < length) {
+    throw_<std::invalid_argument>("truncated bootstrap bundle");
+  }
+  auto bytes = data.subpiece(0, length);
+  data.advance(length);
+  return bytes;
+}
+
+} // namespace
+
+std::string bootstrapBundleFileName(const RootId& rootId) {
+  return fmt::format("{}.treebundle", rootId.value());
+}
+
+std::string serializeBootstrapBundle(const std::vector<const Tree*>& trees) {
+  std::string out;
+  out.push_back(static_cast<char>(kBundleFormatVersion));
+  appendLe32(out, static_cast<uint32_t>(trees.size()));
+  for (const auto* tree : trees) {
+    auto id = tree->getHash().getBytes();
+    appendLe16(out, static_cast<uint16_t>(id.size()));
+    out.append(reinterpret_cast<const char*>(id.data()), id.size());
+
+    auto buf = tree->serialize();
+    auto data = buf.coalesce();
+    appendLe32(out, static_cast<uint32_t>(data.size()));
+    out.append(reinterpret_cast<const char*>(data.data()), data.size());
+  }
+  return out;
+}
+
+std::vector<std::unique_ptr<Tree>> deserializeBootstrapBundle(
+    folly::ByteRange data) {
+  if (data.empty()) {
+    throw_<std::invalid_argument>("empty bootstrap bundle");
+  }
+  auto version = consumeLe<uint8_t>(data);
+  if (version != kBundleFormatVersion) {
+    throwf<std::invalid_argument>(
+        "unknown bootstrap bundle version {}", version);
+  }
+
+  auto count = consumeLe<uint32_t>(data);
+  std::vector<std::unique_ptr<Tree>> trees;
+  trees.reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    auto idLength = consumeLe<uint16_t>(data);
+    ObjectId id{consumeBytes(data, idLength)};
+    auto treeLength = consumeLe<uint32_t>(data);
+    auto treeData = consumeBytes(data, treeLength);
+    auto tree = Tree::tryDeserialize(
+        std::move(id),
+        folly::StringPiece{
+            reinterpret_cast<const char*>(treeData.data()), treeData.size()});
+    if (!tree) {
+      throwf<std::invalid_argument>(
+          "bootstrap bundle record {} is not a serialized tree", i);
+    }
+    trees.push_back(std::move(tree));
+  }
+  if (!data.empty()) {
+    throw_<std::invalid_argument>(
+        "trailing bytes after the last bootstrap bundle record");
+  }
+  return trees;
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <folly/Range.h>
+
+namespace facebook::eden {
+
+class RootId;
+class Tree;
+
+/**
+ * A bootstrap bundle packs full serialized trees for one commit into a
+ * single object, so a cold mount can seed its local store with the trees
+ * the commit's early workload is known to touch (typically the top-K most
+ * fetched trees, computed offline from aggregated fetch logs) instead of
+ * discovering them level by level over hundreds of sequential round trips.
+ *
+ * Bundles are produced by external tooling with serializeBootstrapBundle
+ * and distributed as files named bootstrapBundleFileName(rootId) in the
+ * directory named by the hg:bootstrap-bundle-dir config. EdenFS only reads
+ * them: HgQueuedBackingStore probes for a commit's bundle the first time
+ * that commit's root tree is requested.
+ */
+
+/**
+ * The file name a commit's bundle is looked up under. RootIds from hg are
+ * hex commit hashes, so the name is filesystem-safe.
+ */
+std::string bootstrapBundleFileName(const RootId& rootId);
+
+std::string serializeBootstrapBundle(const std::vector<const Tree*>& trees);
+
+/**
+ * Unpack a bundle into its trees. Throws std::invalid_argument if the data
+ * is not a bundle this version understands.
+ */
+std::vector<std::unique_ptr<Tree>> deserializeBootstrapBundle(
+    folly::ByteRange data);
+
+} // namespace facebook::eden
@@ -137,6 +137,11 @@ void HgDatapackStore::getBlobBatch(
       [&](size_t index, std::unique_ptr<folly::IOBuf> content) {
         XLOGF(DBG9, "Imported node={}", folly::hexlify(requests[index]));
         auto& importRequest = importRequests[index];
+        if (!importRequest->tryClaimFulfillment()) {
+          // A hedged import raced us and already satisfied this request.
+          auto watch = std::move(requestsWatches[index]);
+          return;
+        }
         auto* blobRequest =
             importRequest->getRequest<HgImportRequest::BlobImport>();
         auto blob = std::make_unique<Blob>(blobRequest->hash, *content);
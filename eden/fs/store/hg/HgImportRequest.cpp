@@ -43,16 +43,46 @@ std::shared_ptr<HgImportRequest> HgImportRequest::makeBlobImportRequest(
     ObjectId hash,
     HgProxyHash proxyHash,
     ImportPriority priority,
-    ObjectFetchContext::Cause cause) {
-  return makeRequest<BlobImport>(priority, cause, hash, std::move(proxyHash));
+    ObjectFetchContext::Cause cause,
+    folly::CancellationToken cancellationToken) {
+  auto request =
+      makeRequest<BlobImport>(priority, cause, hash, std::move(proxyHash));
+  request->addSubscriberToken(std::move(cancellationToken));
+  return request;
 }
 
 std::shared_ptr<HgImportRequest> HgImportRequest::makeTreeImportRequest(
     ObjectId hash,
     HgProxyHash proxyHash,
     ImportPriority priority,
-    ObjectFetchContext::Cause cause) {
-  return makeRequest<TreeImport>(priority, cause, hash, std::move(proxyHash));
+    ObjectFetchContext::Cause cause,
+    folly::CancellationToken cancellationToken) {
+  auto request =
+      makeRequest<TreeImport>(priority, cause, hash, std::move(proxyHash));
+  request->addSubscriberToken(std::move(cancellationToken));
+  return request;
+}
+
+void HgImportRequest::addSubscriberToken(folly::CancellationToken token) {
+  cancellationTokens_.wlock()->push_back(std::move(token));
+}
+
+std::vector<folly::CancellationToken> HgImportRequest::getSubscriberTokens()
+    const {
+  return *cancellationTokens_.rlock();
+}
+
+bool HgImportRequest::isCancelled() const {
+  auto tokens = cancellationTokens_.rlock();
+  if (tokens->empty()) {
+    return false;
+  }
+  for (const auto& token : *tokens) {
+    if (!token.isCancellationRequested()) {
+      return false;
+    }
+  }
+  return true;
 }
 
 } // namespace facebook::eden
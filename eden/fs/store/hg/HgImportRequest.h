@@ -7,7 +7,10 @@
 
 #pragma once
 
+#include <folly/CancellationToken.h>
+#include <folly/Synchronized.h>
 #include <folly/futures/Promise.h>
+#include <atomic>
 #include <utility>
 #include <variant>
 
@@ -63,7 +66,8 @@ class HgImportRequest {
       ObjectId hash,
       HgProxyHash proxyHash,
       ImportPriority priority,
-      ObjectFetchContext::Cause cause);
+      ObjectFetchContext::Cause cause,
+      folly::CancellationToken cancellationToken = {});
 
   /**
    * Allocate a tree request.
@@ -72,7 +76,8 @@ class HgImportRequest {
       ObjectId hash,
       HgProxyHash proxyHash,
       ImportPriority priority,
-      ObjectFetchContext::Cause cause);
+      ObjectFetchContext::Cause cause,
+      folly::CancellationToken cancellationToken = {});
 
   /**
    * Implementation detail of the make*Request functions from above. Do not use
@@ -134,6 +139,58 @@ class HgImportRequest {
     return requestTime_;
   }
 
+  /**
+   * Claim the exclusive right to launch the HgImporter fetch for this
+   * request. Returns true for the first caller only, so the batch fallback
+   * path and a hedged import cannot both fetch the same object.
+   */
+  bool tryClaimImporterFetch() noexcept {
+    return !importerFetchClaimed_.exchange(true, std::memory_order_acq_rel);
+  }
+
+  /**
+   * Claim the exclusive right to fulfill this request's promise. Returns
+   * true for the first caller only. With hedged imports enabled, the batch
+   * import and the hedged HgImporter fetch race to produce a result; the
+   * loser must discard its result instead of double-fulfilling the promise.
+   */
+  bool tryClaimFulfillment() noexcept {
+    return !fulfillmentClaimed_.exchange(true, std::memory_order_acq_rel);
+  }
+
+  /**
+   * Whether this request is still sitting in the import queue, as opposed to
+   * having been handed to an importer thread. Only read and written by
+   * HgImportRequestQueue under its state lock.
+   */
+  bool isInQueue() const noexcept {
+    return inQueue_;
+  }
+
+  void markDequeued() noexcept {
+    inQueue_ = false;
+  }
+
+  /**
+   * Record the cancellation token of a request that de-duplicated onto this
+   * one, so the import is only dropped when every subscriber has abandoned
+   * it.
+   */
+  void addSubscriberToken(folly::CancellationToken token);
+
+  /**
+   * Copy out this request's subscriber tokens, used to transfer them onto an
+   * existing tracked request when this one de-duplicates onto it.
+   */
+  std::vector<folly::CancellationToken> getSubscriberTokens() const;
+
+  /**
+   * True when every subscriber of this import has requested cancellation.
+   * A subscriber whose token can never be signalled (the default token used
+   * by Thrift and prefetch fetches) keeps the import alive.
+   */
+  bool isCancelled() const;
+
  private:
   /**
    * Implementation detail of the various make*Request functions.
@@ -159,11 +216,28 @@ class HgImportRequest {
   uint64_t unique_ = generateUniqueID();
   std::chrono::steady_clock::time_point requestTime_ =
       std::chrono::steady_clock::now();
+  bool inQueue_ = true;
+  std::atomic<bool> importerFetchClaimed_{false};
+  std::atomic<bool> fulfillmentClaimed_{false};
+
+  /**
+   * One token per subscriber: the originating fetch context's token plus
+   * one for each de-duplicated request. Synchronized because duplicates can
+   * attach while an importer thread inspects the request.
+   */
+  folly::Synchronized<std::vector<folly::CancellationToken>>
+      cancellationTokens_;
 
   friend bool operator<(
       const HgImportRequest& lhs,
       const HgImportRequest& rhs) {
-    return lhs.priority_ < rhs.priority_;
+    if (lhs.priority_ != rhs.priority_) {
+      return lhs.priority_ < rhs.priority_;
+    }
+    // Among requests of equal priority, older requests sort higher so a
+    // steady stream of new work cannot indefinitely starve requests that
+    // are already waiting.
+    return lhs.requestTime_ > rhs.requestTime_;
   }
 };
 
@@ -53,21 +53,33 @@ folly::Future<Ret> HgImportRequestQueue::enqueue(
     auto [promise, future] = folly::makePromiseContract<Ret>();
     trackedImport->promises.emplace_back(std::move(promise));
 
+    // The tracked import must stay alive until every subscriber has
+    // abandoned it, so transfer this request's cancellation token onto it.
+    for (auto& token : request->getSubscriberTokens()) {
+      existingRequest->addSubscriberToken(std::move(token));
+    }
+
     if (existingRequest->getPriority() < request->getPriority()) {
       existingRequest->setPriority(request->getPriority());
 
-      // Since the new request has a higher priority than the already present
-      // one, we need to re-order the heap.
+      // Re-order the heap, but only if the tracked request is actually
+      // still sitting in the queue. Requests that have already been handed
+      // to an importer thread stay in the tracker so late arrivals can
+      // attach to their promise, and bumping their priority cannot change
+      // anything anymore; a thundering herd of fetches for one in-flight
+      // object would otherwise pay this O(n) pass per duplicate.
       //
       // TODO(xavierd): this has a O(n) complexity, and enqueing tons of
       // duplicated requests will thus lead to a quadratic complexity.
-      std::make_heap(
-          queue->begin(),
-          queue->end(),
-          [](const std::shared_ptr<HgImportRequest>& lhs,
-             const std::shared_ptr<HgImportRequest>& rhs) {
-            return (*lhs) < (*rhs);
-          });
+      if (existingRequest->isInQueue()) {
+        std::make_heap(
+            queue->begin(),
+            queue->end(),
+            [](const std::shared_ptr<HgImportRequest>& lhs,
+               const std::shared_ptr<HgImportRequest>& rhs) {
+              return (*lhs) < (*rhs);
+            });
+      }
     }
 
     return std::move(future).toUnsafeFuture();
@@ -86,7 +98,12 @@ folly::Future<Ret> HgImportRequestQueue::enqueue(
         return (*lhs) < (*rhs);
       });
 
-  queueCV_.notify_one();
+  // Waiters are not interchangeable: a thread dequeuing with a raised
+  // minimum priority class cannot service this request if it is background
+  // work, so waking a single waiter could strand the request while an
+  // unrestricted thread keeps sleeping. Wake them all and let ineligible
+  // ones go back to waiting.
+  queueCV_.notify_all();
 
   return promise->getFuture();
 }
@@ -109,12 +126,18 @@ HgImportRequestQueue::combineAndClearRequestQueues() {
   state->treeQueue.clear();
   state->blobQueue.clear();
   XCHECK_EQ(res.size(), treeQSz + blobQSz);
+  for (auto& request : res) {
+    request->markDequeued();
+  }
   return res;
 }
 
-std::vector<std::shared_ptr<HgImportRequest>> HgImportRequestQueue::dequeue() {
+std::vector<std::shared_ptr<HgImportRequest>> HgImportRequestQueue::dequeue(
+    ImportPriority::Class minimumClass) {
   size_t count;
   std::vector<std::shared_ptr<HgImportRequest>>* queue = nullptr;
+  auto targetLatency =
+      config_->getEdenConfig()->importBatchTargetLatency.getValue();
 
   auto state = state_.lock();
   while (true) {
@@ -130,13 +153,15 @@ std::vector<std::shared_ptr<HgImportRequest>> HgImportRequestQueue::dequeue() {
     // order.  The reason for trees having a higher priority is due to trees
     // allowing a higher fan-out and thus increasing concurrency of fetches
     // which translate onto a higher overall throughput.
-    if (!state->treeQueue.empty()) {
+    if (!state->treeQueue.empty() &&
+        state->treeQueue.front()->getPriority().getClass() >= minimumClass) {
       count = config_->getEdenConfig()->importBatchSizeTree.getValue();
       highestPriority = state->treeQueue.front()->getPriority();
       queue = &state->treeQueue;
     }
 
-    if (!state->blobQueue.empty()) {
+    if (!state->blobQueue.empty() &&
+        state->blobQueue.front()->getPriority().getClass() >= minimumClass) {
       auto priority = state->blobQueue.front()->getPriority();
       if (!queue || priority > highestPriority) {
         queue = &state->blobQueue;
@@ -152,10 +177,28 @@ std::vector<std::shared_ptr<HgImportRequest>> HgImportRequestQueue::dequeue() {
     }
   }
 
+  if (targetLatency.count() != 0) {
+    auto cap = (queue == &state->treeQueue) ? state->treeBatchCap
+                                            : state->blobBatchCap;
+    if (cap != 0) {
+      count = std::min(count, cap);
+    }
+  }
+
   count = std::min(count, queue->size());
   std::vector<std::shared_ptr<HgImportRequest>> result;
   result.reserve(count);
+  const auto batchClass = queue->front()->getPriority().getClass();
   for (size_t i = 0; i < count; i++) {
+    if (i != 0 && queue->front()->getPriority().getClass() != batchClass) {
+      // Don't pad a batch led by a high-priority request with lower-class
+      // work. A batch is imported as a single fetch, so mixing a background
+      // prefetch burst into an interactive request's batch would delay the
+      // interactive response by the whole batch's import time. Cutting the
+      // batch at the class boundary lets high-priority requests preempt
+      // background work at the next batch boundary.
+      break;
+    }
     std::pop_heap(
         queue->begin(),
         queue->end(),
@@ -166,9 +209,66 @@ std::vector<std::shared_ptr<HgImportRequest>> HgImportRequestQueue::dequeue() {
 
     result.emplace_back(std::move(queue->back()));
     queue->pop_back();
+    result.back()->markDequeued();
   }
 
   return result;
 }
 
+void HgImportRequestQueue::reportBlobBatchDuration(
+    size_t batchSize,
+    std::chrono::nanoseconds duration) {
+  updateBatchCap(
+      &State::blobBatchCap,
+      config_->getEdenConfig()->importBatchSize.getValue(),
+      batchSize,
+      duration);
+}
+
+void HgImportRequestQueue::reportTreeBatchDuration(
+    size_t batchSize,
+    std::chrono::nanoseconds duration) {
+  updateBatchCap(
+      &State::treeBatchCap,
+      config_->getEdenConfig()->importBatchSizeTree.getValue(),
+      batchSize,
+      duration);
+}
+
+void HgImportRequestQueue::updateBatchCap(
+    size_t State::*capMember,
+    size_t configuredMax,
+    size_t batchSize,
+    std::chrono::nanoseconds duration) {
+  auto targetLatency =
+      config_->getEdenConfig()->importBatchTargetLatency.getValue();
+  if (targetLatency.count() == 0 || batchSize == 0) {
+    return;
+  }
+
+  auto state = state_.lock();
+  auto& cap = (*state).*capMember;
+  if (cap == 0 || cap > configuredMax) {
+    cap = configuredMax;
+  }
+
+  if (duration > targetLatency) {
+    // Remote round trips are dominating; halve the batch so queued
+    // requests are not stuck behind one slow import.
+    cap = std::max<size_t>(1, std::min(cap, batchSize) / 2);
+  } else if (duration <= targetLatency / 2 && batchSize >= cap) {
+    // The batch was full and imported well under the budget (typically
+    // local cache hits); grow multiplicatively back towards the
+    // configured size.
+    cap = std::min<size_t>(configuredMax, cap + std::max<size_t>(1, cap / 2));
+  }
+
+  XLOGF(
+      DBG6,
+      "import batch of {} took {}ms; batch cap now {}",
+      batchSize,
+      std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(),
+      cap);
+}
+
 } // namespace facebook::eden
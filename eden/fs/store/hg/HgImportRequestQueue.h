@@ -10,6 +10,7 @@
 #include <folly/Synchronized.h>
 #include <folly/Try.h>
 #include <folly/container/F14Map.h>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <vector>
@@ -50,8 +51,13 @@ class HgImportRequestQueue {
    * All requests in the vector are guaranteed to be the same type.
    * The number of the returned requests is controlled by `import-batch-size*`
    * options in the config. It may have fewer requests than configured.
+   *
+   * Requests below `minimumClass` are left in the queue; a thread dequeuing
+   * with a raised minimum blocks until eligible work arrives, which lets
+   * some servicing threads be reserved for interactive traffic.
    */
-  std::vector<std::shared_ptr<HgImportRequest>> dequeue();
+  std::vector<std::shared_ptr<HgImportRequest>> dequeue(
+      ImportPriority::Class minimumClass = ImportPriority::Class::Low);
 
   /**
    * Destroy the queue.
@@ -116,6 +122,29 @@ class HgImportRequestQueue {
    */
   std::vector<std::shared_ptr<HgImportRequest>> combineAndClearRequestQueues();
 
+  /* ====== Adaptive batch sizing ====== */
+
+  /**
+   * Report how long importing a dequeued blob batch took.
+   *
+   * When `hg:import-batch-target-latency` is non-zero, subsequent batches
+   * shrink when imports run over the target (remote round trips dominating)
+   * and grow back towards `hg:import-batch-size` when they run well under
+   * it (local cache hits), bounding head-of-line blocking behind one slow
+   * batch. With the target unset this is a no-op.
+   */
+  void reportBlobBatchDuration(
+      size_t batchSize,
+      std::chrono::nanoseconds duration);
+
+  /**
+   * Tree flavor of reportBlobBatchDuration, bounded by
+   * `hg:import-batch-size-tree`.
+   */
+  void reportTreeBatchDuration(
+      size_t batchSize,
+      std::chrono::nanoseconds duration);
+
  private:
   /**
    * Puts an item into the queue.
@@ -123,6 +152,19 @@ class HgImportRequestQueue {
   template <typename Ret, typename ImportType>
   folly::Future<Ret> enqueue(std::shared_ptr<HgImportRequest> request);
 
+  struct State;
+
+  /**
+   * Shared implementation of the report*BatchDuration methods; capMember
+   * selects which queue's adaptive cap to update and configuredMax bounds
+   * its growth.
+   */
+  void updateBatchCap(
+      size_t State::*capMember,
+      size_t configuredMax,
+      size_t batchSize,
+      std::chrono::nanoseconds duration);
+
   HgImportRequestQueue(HgImportRequestQueue&&) = delete;
   HgImportRequestQueue& operator=(HgImportRequestQueue&&) = delete;
 
@@ -140,6 +182,14 @@ class HgImportRequestQueue {
      */
     folly::F14FastMap<ObjectId, std::shared_ptr<HgImportRequest>>
         requestTracker;
+
+    /**
+     * Adaptive upper bounds on the dequeued batch sizes, maintained by
+     * updateBatchCap(). Zero means "not yet initialized"; the caps only
+     * take effect while `hg:import-batch-target-latency` is non-zero.
+     */
+    size_t blobBatchCap = 0;
+    size_t treeBatchCap = 0;
   };
   std::shared_ptr<ReloadableConfig> config_;
   folly::Synchronized<State, std::mutex> state_;
@@ -32,6 +32,7 @@
 #include "eden/fs/store/hg/HgImportPyError.h"
 #include "eden/fs/store/hg/HgProxyHash.h"
 #include "eden/fs/telemetry/EdenStats.h"
+#include "eden/fs/utils/Memory.h"
 #include "eden/fs/utils/PathFuncs.h"
 #include "eden/fs/utils/SpawnedProcess.h"
 
@@ -99,8 +100,11 @@ HgImporter::HgImporter(
   cmd.push_back(folly::to<string>(inFd));
   helperIn_ = std::move(childInPipe.write);
 
-  // Read responses from this pipe
+  // Read responses from this pipe. This is the bulk data channel, so ask
+  // for a larger kernel buffer (best effort) to keep the helper from
+  // stalling between our reads.
   Pipe childOutPipe;
+  childOutPipe.expandBufferSize(1024 * 1024);
   auto outFd = opts.inheritDescriptor(std::move(childOutPipe.write));
   cmd.push_back("--out-fd");
   cmd.push_back(folly::to<string>(outFd));
@@ -280,7 +284,9 @@ unique_ptr<Blob> HgImporter::importFileContents(
     XLOG(ERR) << msg;
     throw std::runtime_error(std::move(msg));
   }
-  auto buf = IOBuf(IOBuf::CREATE, header.dataLength);
+  // Blob payloads typically go on to live in the BlobCache, so allocate
+  // them from the blob arena for memory attribution.
+  auto buf = newArenaIOBuf(MemoryArena::BlobData, header.dataLength);
 
   readFromHelper(
       buf.writableTail(), header.dataLength, "CMD_CAT_FILE response body");
@@ -337,10 +343,58 @@ std::unique_ptr<IOBuf> HgImporter::fetchTree(
   auto requestID = sendFetchTreeRequest(
       CMD_CAT_TREE, path, pathManifestNode, "CMD_CAT_TREE");
 
+  return readTreeResponse(requestID, path, pathManifestNode);
+}
+
+std::vector<folly::Try<std::unique_ptr<IOBuf>>> HgImporter::fetchTrees(
+    const std::vector<std::pair<RelativePath, Hash20>>& requests) {
+  // Write every request before reading the first response.  The helper
+  // handles requests serially and responds in request order, so the
+  // transaction IDs let us match each response back to its request while the
+  // helper overlaps computing the next tree with sending the previous one
+  // down the pipe.
+  std::vector<TransactionID> txnIDs;
+  txnIDs.reserve(requests.size());
+  for (const auto& [path, manifestNode] : requests) {
+    txnIDs.push_back(sendFetchTreeRequest(
+        CMD_CAT_TREE, path, manifestNode, "CMD_CAT_TREE"));
+  }
+
+  std::vector<folly::Try<std::unique_ptr<IOBuf>>> results;
+  results.reserve(requests.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    results.push_back(folly::makeTryWith([&] {
+      return readTreeResponse(txnIDs[i], requests[i].first, requests[i].second);
+    }));
+
+    // A python-side failure only poisons its own entry; the stream stays
+    // framed and the remaining responses must still be drained.  Transport
+    // errors leave the pipe in an undefined state though, so rethrow them
+    // (and ResetRepoError, which asks for a restart) and let
+    // HgImporterManager replace the helper process.
+    if (results.back().hasException()) {
+      const auto& exception = results.back().exception();
+      if (exception.is_compatible_with<HgImporterError>()) {
+        exception.throw_exception();
+      }
+      if (auto* pyError = exception.get_exception<HgImportPyError>();
+          pyError && pyError->errorType() == "ResetRepoError") {
+        exception.throw_exception();
+      }
+    }
+  }
+  return results;
+}
+
+std::unique_ptr<IOBuf> HgImporter::readTreeResponse(
+    TransactionID txnID,
+    RelativePathPiece path,
+    Hash20 pathManifestNode) {
   ChunkHeader header;
-  header = readChunkHeader(requestID, "CMD_CAT_TREE");
+  header = readChunkHeader(txnID, "CMD_CAT_TREE");
 
-  auto buf = IOBuf::create(header.dataLength);
+  auto buf = std::make_unique<IOBuf>(
+      newArenaIOBuf(MemoryArena::TreeData, header.dataLength));
 
   readFromHelper(
       buf->writableTail(), header.dataLength, "CMD_CAT_TREE response body");
@@ -649,6 +703,15 @@ std::unique_ptr<IOBuf> HgImporterManager::fetchTree(
   });
 }
 
+std::vector<folly::Try<std::unique_ptr<IOBuf>>> HgImporterManager::fetchTrees(
+    const std::vector<std::pair<RelativePath, Hash20>>& requests) {
+  // On a communication error the entire batch is retried against the
+  // restarted helper; per-tree python errors are reported in the returned
+  // entries and do not trigger a retry.
+  return retryOnError(
+      [&](HgImporter* importer) { return importer->fetchTrees(requests); });
+}
+
 HgImporter* HgImporterManager::getImporter() {
   if (!importer_) {
     importer_ = make_unique<HgImporter>(repoPath_, stats_, importHelperScript_);
@@ -8,9 +8,11 @@
 #pragma once
 
 #include <folly/Range.h>
+#include <folly/Try.h>
 #include <folly/portability/GFlags.h>
 #include <folly/portability/IOVec.h>
 #include <optional>
+#include <utility>
 
 #include "eden/fs/eden-config.h"
 #include "eden/fs/telemetry/EdenStats.h"
@@ -88,6 +90,18 @@ class Importer {
   virtual std::unique_ptr<folly::IOBuf> fetchTree(
       RelativePathPiece path,
       Hash20 pathManifestNode) = 0;
+
+  /**
+   * Import several trees with pipelined requests.
+   *
+   * All of the CMD_CAT_TREE requests are written to the helper process before
+   * the first response is read, so the helper can start computing the next
+   * tree while earlier responses are still in flight on the pipe.  The
+   * returned vector is parallel to `requests`; entries whose import failed
+   * python-side hold the exception rather than failing the whole batch.
+   */
+  virtual std::vector<folly::Try<std::unique_ptr<folly::IOBuf>>> fetchTrees(
+      const std::vector<std::pair<RelativePath, Hash20>>& requests) = 0;
 };
 
 /**
@@ -129,6 +143,8 @@ class HgImporter : public Importer {
   std::unique_ptr<folly::IOBuf> fetchTree(
       RelativePathPiece path,
       Hash20 pathManifestNode) override;
+  std::vector<folly::Try<std::unique_ptr<folly::IOBuf>>> fetchTrees(
+      const std::vector<std::pair<RelativePath, Hash20>>& requests) override;
 
   const ImporterOptions& getOptions() const;
 
@@ -254,6 +270,14 @@ class HgImporter : public Importer {
       RelativePathPiece path,
       Hash20 pathManifestNode,
       folly::StringPiece context);
+  /**
+   * Read and validate the response body for an outstanding CMD_CAT_TREE
+   * request.  The path and manifest node are only used for error messages.
+   */
+  std::unique_ptr<folly::IOBuf> readTreeResponse(
+      TransactionID txnID,
+      RelativePathPiece path,
+      Hash20 pathManifestNode);
 
   SpawnedProcess helper_;
   std::shared_ptr<EdenStats> const stats_;
@@ -303,6 +327,8 @@ class HgImporterManager : public Importer {
   std::unique_ptr<folly::IOBuf> fetchTree(
       RelativePathPiece path,
       Hash20 pathManifestNode) override;
+  std::vector<folly::Try<std::unique_ptr<folly::IOBuf>>> fetchTrees(
+      const std::vector<std::pair<RelativePath, Hash20>>& requests) override;
 
  private:
   template <typename Fn>
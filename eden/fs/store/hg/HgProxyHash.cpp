@@ -9,6 +9,8 @@
 
 #include <fmt/core.h>
 #include <folly/String.h>
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
 #include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 
@@ -25,6 +27,30 @@ using std::string;
 
 namespace facebook::eden {
 
+namespace {
+
+/**
+ * In-memory cache of legacy proxy hash resolutions.
+ *
+ * Legacy 20-byte object IDs require a LocalStore read to recover their
+ * (path, manifest hash) pair, and that read sits in front of every tree and
+ * blob fetch using such an ID.  A legacy ID is the SHA-1 of the serialized
+ * mapping itself, so a resolution can never change and the cache needs no
+ * invalidation; the LRU bound only limits memory.  Embedded proxy hashes are
+ * decoded inline and never enter the cache.
+ */
+constexpr size_t kProxyHashCacheSize = 32 * 1024;
+
+using ProxyHashCache = folly::EvictingCacheMap<ObjectId, std::string>;
+
+folly::Synchronized<ProxyHashCache>& proxyHashCache() {
+  static folly::Synchronized<ProxyHashCache> cache{
+      ProxyHashCache{kProxyHashCacheSize}};
+  return cache;
+}
+
+} // namespace
+
 HgProxyHash::HgProxyHash(RelativePathPiece path, const Hash20& hgRevHash)
     : value_{serialize(path, hgRevHash)} {}
 
@@ -72,11 +98,16 @@ folly::Future<std::vector<HgProxyHash>> HgProxyHash::getBatch(
     EdenStats& edenStats) {
   std::vector<HgProxyHash> embedded_results;
   std::vector<ByteRange> byteRanges;
-  for (const auto& hash : blobHashes) {
-    if (auto embedded = tryParseEmbeddedProxyHash(hash)) {
-      embedded_results.push_back(*embedded);
-    } else {
-      byteRanges.push_back(hash.getBytes());
+  {
+    auto cache = proxyHashCache().wlock();
+    for (const auto& hash : blobHashes) {
+      if (auto embedded = tryParseEmbeddedProxyHash(hash)) {
+        embedded_results.push_back(*embedded);
+      } else if (auto cached = cache->find(hash); cached != cache->end()) {
+        embedded_results.push_back(HgProxyHash{hash, cached->second});
+      } else {
+        byteRanges.push_back(hash.getBytes());
+      }
     }
   }
   if (byteRanges.empty()) {
@@ -88,9 +119,11 @@ folly::Future<std::vector<HgProxyHash>> HgProxyHash::getBatch(
                   byteRanges](std::vector<StoreResult>&& data) {
         std::vector<HgProxyHash> results{embedded_results};
 
+        auto cache = proxyHashCache().wlock();
         for (size_t i = 0; i < byteRanges.size(); ++i) {
           results.emplace_back(HgProxyHash{
               ObjectId{byteRanges.at(i)}, data[i], "prefetchFiles getBatch"});
+          cache->set(ObjectId{byteRanges.at(i)}, results.back().getValue());
         }
 
         return results;
@@ -105,6 +138,12 @@ HgProxyHash HgProxyHash::load(
   if (auto embedded = tryParseEmbeddedProxyHash(edenObjectId)) {
     return *embedded;
   }
+  {
+    auto cache = proxyHashCache().wlock();
+    if (auto cached = cache->find(edenObjectId); cached != cache->end()) {
+      return HgProxyHash{edenObjectId, cached->second};
+    }
+  }
   edenStats.increment(&HgBackingStoreStats::loadProxyHash);
   // Read the path name and file rev hash
   auto infoResult = store->get(KeySpace::HgProxyHashFamily, edenObjectId);
@@ -114,7 +153,9 @@ HgProxyHash HgProxyHash::load(
     // Fall through and let infoResult.extractValue() throw
   }
 
-  return HgProxyHash{edenObjectId, infoResult.extractValue()};
+  auto proxyHash = HgProxyHash{edenObjectId, infoResult.extractValue()};
+  proxyHashCache().wlock()->set(edenObjectId, proxyHash.getValue());
+  return proxyHash;
 }
 
 ObjectId HgProxyHash::store(
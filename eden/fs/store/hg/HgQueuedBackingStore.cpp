@@ -7,15 +7,19 @@
 
 #include "eden/fs/store/hg/HgQueuedBackingStore.h"
 
+#include <cerrno>
 #include <chrono>
+#include <system_error>
 #include <thread>
 #include <utility>
 #include <variant>
 
 #include <re2/re2.h>
 
+#include <folly/FileUtil.h>
 #include <folly/Range.h>
 #include <folly/String.h>
+#include <folly/executors/GlobalExecutor.h>
 #include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 #include <folly/portability/GFlags.h>
@@ -28,6 +32,7 @@
 #include "eden/fs/store/LocalStore.h"
 #include "eden/fs/store/ObjectFetchContext.h"
 #include "eden/fs/store/hg/HgBackingStore.h"
+#include "eden/fs/store/hg/HgBootstrapBundle.h"
 #include "eden/fs/store/hg/HgImportRequest.h"
 #include "eden/fs/store/hg/HgProxyHash.h"
 #include "eden/fs/telemetry/EdenStats.h"
@@ -96,7 +101,8 @@ HgQueuedBackingStore::HgQueuedBackingStore(
   }
   threads_.reserve(numberThreads);
   for (uint16_t i = 0; i < numberThreads; i++) {
-    threads_.emplace_back(&HgQueuedBackingStore::processRequest, this);
+    threads_.emplace_back(
+        &HgQueuedBackingStore::processRequest, this, i, numberThreads);
   }
   subscribeActivityBuffer();
 }
@@ -134,12 +140,54 @@ void HgQueuedBackingStore::subscribeActivityBuffer() {
   }
 }
 
+template <typename T>
+std::vector<std::shared_ptr<HgImportRequest>>
+HgQueuedBackingStore::dropCancelledRequests(
+    std::vector<std::shared_ptr<HgImportRequest>>&& requests) {
+  std::vector<std::shared_ptr<HgImportRequest>> live;
+  live.reserve(requests.size());
+  for (auto& request : requests) {
+    if (!request->isCancelled()) {
+      live.emplace_back(std::move(request));
+      continue;
+    }
+
+    ObjectId hash;
+    if constexpr (std::is_same_v<T, Tree>) {
+      hash = request->getRequest<HgImportRequest::TreeImport>()->hash;
+    } else {
+      static_assert(
+          std::is_same_v<T, Blob>,
+          "dropCancelledRequests can only be called with Tree or Blob types");
+      hash = request->getRequest<HgImportRequest::BlobImport>()->hash;
+    }
+    XLOGF(DBG4, "Dropping cancelled import request for {}", hash);
+
+    auto result = folly::Try<std::unique_ptr<T>>{
+        folly::make_exception_wrapper<std::system_error>(
+            EINTR, std::generic_category(), "import cancelled")};
+    queue_.markImportAsFinished<T>(hash, result);
+    if (request->tryClaimFulfillment()) {
+      request->getPromise<std::unique_ptr<T>>()->setTry(
+          folly::Try<std::unique_ptr<T>>{result.exception()});
+    }
+  }
+  return live;
+}
+
 void HgQueuedBackingStore::processBlobImportRequests(
     std::vector<std::shared_ptr<HgImportRequest>>&& requests) {
   folly::stop_watch<std::chrono::milliseconds> watch;
 
   XLOG(DBG4) << "Processing blob import batch size=" << requests.size();
 
+  // An interrupted client request may have abandoned work that was queued
+  // on its behalf; shed it here, before it occupies an importer slot.
+  requests = dropCancelledRequests<Blob>(std::move(requests));
+  if (requests.empty()) {
+    return;
+  }
+
   for (auto& request : requests) {
     auto* blobImport = request->getRequest<HgImportRequest::BlobImport>();
 
@@ -153,6 +201,50 @@ void HgQueuedBackingStore::processBlobImportRequests(
     XLOGF(DBG4, "Processing blob request for {}", blobImport->hash);
   }
 
+  auto batchSize = requests.size();
+
+  // A single slow remote fetch inside getBlobBatch holds the whole batch
+  // hostage: the batch call is blocking and its results only come back when
+  // every object has been fetched. When hedging is enabled, arm a timer per
+  // request that fires a duplicate fetch through the hg importer if the
+  // batch has not produced the blob by then; whichever side finishes first
+  // claims the promise and the loser discards its result.
+  std::vector<folly::Future<folly::Unit>> hedges;
+  auto hedgeThreshold =
+      config_->getEdenConfig()->importHedgeThreshold.getValue();
+  if (hedgeThreshold.count() != 0) {
+    hedges.reserve(requests.size());
+    for (auto& request : requests) {
+      hedges.emplace_back(
+          folly::futures::sleep(hedgeThreshold)
+              .via(folly::getGlobalCPUExecutor())
+              .thenValue([this, request, watch, stats = stats_](folly::Unit)
+                             -> folly::SemiFuture<folly::Unit> {
+                if (request->getPromise<std::unique_ptr<Blob>>()
+                        ->isFulfilled() ||
+                    !request->tryClaimImporterFetch()) {
+                  return folly::makeSemiFuture();
+                }
+                auto* blobImport =
+                    request->getRequest<HgImportRequest::BlobImport>();
+                XLOGF(DBG4, "Hedging slow import of blob {}", blobImport->hash);
+                return backingStore_
+                    ->fetchBlobFromHgImporter(blobImport->proxyHash)
+                    .defer([request, watch, stats](auto&& result) mutable {
+                      if (!request->tryClaimFulfillment()) {
+                        // The batch import finished first; discard.
+                        return;
+                      }
+                      stats->addDuration(
+                          &HgBackingStoreStats::getBlob, watch.elapsed());
+                      request
+                          ->getPromise<HgImportRequest::BlobImport::Response>()
+                          ->setTry(std::forward<decltype(result)>(result));
+                    });
+              }));
+    }
+  }
+
   backingStore_->getDatapackStore().getBlobBatch(requests);
 
   {
@@ -166,6 +258,12 @@ void HgQueuedBackingStore::processBlobImportRequests(
         continue;
       }
 
+      if (!request->tryClaimImporterFetch()) {
+        // A hedged import is already fetching this blob; it will fulfill the
+        // promise, and the hedge join below waits for it.
+        continue;
+      }
+
       // The blobs were either not found locally, or, when EdenAPI is enabled,
       // not found on the server. Let's import the blob through the hg importer.
       // TODO(xavierd): remove when EdenAPI has been rolled out everywhere.
@@ -175,6 +273,9 @@ void HgQueuedBackingStore::processBlobImportRequests(
           std::move(fetchSemiFuture)
               .defer([request = std::move(request), watch, stats = stats_](
                          auto&& result) mutable {
+                if (!request->tryClaimFulfillment()) {
+                  return;
+                }
                 XLOG(DBG4)
                     << "Imported blob from HgImporter for "
                     << request->getRequest<HgImportRequest::BlobImport>()->hash;
@@ -187,12 +288,30 @@ void HgQueuedBackingStore::processBlobImportRequests(
 
     folly::collectAll(futures).wait();
   }
+
+  // Report before draining the hedges so adaptive batch sizing reflects the
+  // batch's own import time.
+  queue_.reportBlobBatchDuration(batchSize, watch.elapsed());
+
+  if (!hedges.empty()) {
+    // Wake hedges that are still sleeping (folly::futures::sleep honors
+    // interrupts), then join them all so no hedge outlives this call.
+    for (auto& hedge : hedges) {
+      hedge.cancel();
+    }
+    folly::collectAll(hedges).wait();
+  }
 }
 
 void HgQueuedBackingStore::processTreeImportRequests(
     std::vector<std::shared_ptr<HgImportRequest>>&& requests) {
   folly::stop_watch<std::chrono::milliseconds> watch;
 
+  requests = dropCancelledRequests<Tree>(std::move(requests));
+  if (requests.empty()) {
+    return;
+  }
+
   for (auto& request : requests) {
     auto* treeImport = request->getRequest<HgImportRequest::TreeImport>();
 
@@ -206,6 +325,7 @@ void HgQueuedBackingStore::processTreeImportRequests(
     XLOGF(DBG4, "Processing tree request for {}", treeImport->hash);
   }
 
+  auto batchSize = requests.size();
   backingStore_->getDatapackStore().getTreeBatch(requests);
 
   {
@@ -240,12 +360,29 @@ void HgQueuedBackingStore::processTreeImportRequests(
 
     folly::collectAll(futures).wait();
   }
+
+  queue_.reportTreeBatchDuration(batchSize, watch.elapsed());
 }
 
-void HgQueuedBackingStore::processRequest() {
+void HgQueuedBackingStore::processRequest(
+    size_t threadIndex,
+    size_t totalThreads) {
   folly::setThreadName("hgqueue");
   for (;;) {
-    auto requests = queue_.dequeue();
+    // The first `reserved-interactive-threads` threads only service Normal
+    // and higher priority requests, so a flood of background prefetch
+    // batches can never occupy every servicing thread and starve
+    // interactive fetches behind slow imports. The count is re-read on
+    // every batch so it can be tuned without a restart, and clamped so at
+    // least one thread always services background work.
+    auto reservedThreads = std::min<size_t>(
+        config_->getEdenConfig()->numReservedInteractiveThreads.getValue(),
+        totalThreads - 1);
+    auto minimumClass = threadIndex < reservedThreads
+        ? ImportPriority::Class::Normal
+        : ImportPriority::Class::Low;
+
+    auto requests = queue_.dequeue(minimumClass);
 
     if (requests.empty()) {
       break;
@@ -370,10 +507,12 @@ folly::SemiFuture<BackingStore::GetTreeResult> HgQueuedBackingStore::getTree(
       folly::Range{&proxyHash, 1},
       ObjectFetchContext::ObjectType::Tree);
 
+  folly::stop_watch<> watch;
   if (auto tree =
           backingStore_->getDatapackStore().getTreeLocal(id, proxyHash)) {
     XLOG(DBG5) << "imported tree of '" << proxyHash.path() << "', "
                << proxyHash.revHash().toString() << " from hgcache";
+    stats_->addDuration(&HgBackingStoreStats::fetchTreeCache, watch.elapsed());
     return folly::makeSemiFuture(GetTreeResult{
         std::move(tree), ObjectFetchContext::Origin::FromDiskCache});
   }
@@ -410,7 +549,11 @@ HgQueuedBackingStore::getTreeImpl(
     const ObjectFetchContextPtr& context) {
   auto getTreeFuture = folly::makeFutureWith([&] {
     auto request = HgImportRequest::makeTreeImportRequest(
-        id, proxyHash, context->getPriority(), context->getCause());
+        id,
+        proxyHash,
+        context->getPriority(),
+        context->getCause(),
+        context->getCancellationToken());
     uint64_t unique = request->getUnique();
 
     auto importTracker =
@@ -437,9 +580,12 @@ HgQueuedBackingStore::getTreeImpl(
         });
   });
 
+  folly::stop_watch<> watch;
   return std::move(getTreeFuture)
-      .thenTry([this, id](folly::Try<std::unique_ptr<Tree>>&& result) {
+      .thenTry([this, id, watch](folly::Try<std::unique_ptr<Tree>>&& result) {
         this->queue_.markImportAsFinished<Tree>(id, result);
+        stats_->addDuration(
+            &HgBackingStoreStats::fetchTreeRemote, watch.elapsed());
         auto tree = std::move(result).value();
         return GetTreeResult{
             std::move(tree), ObjectFetchContext::Origin::FromNetworkFetch};
@@ -462,8 +608,10 @@ folly::SemiFuture<BackingStore::GetBlobResult> HgQueuedBackingStore::getBlob(
       folly::Range{&proxyHash, 1},
       ObjectFetchContext::ObjectType::Blob);
 
+  folly::stop_watch<> watch;
   if (auto blob =
           backingStore_->getDatapackStore().getBlobLocal(id, proxyHash)) {
+    stats_->addDuration(&HgBackingStoreStats::fetchBlobCache, watch.elapsed());
     return folly::makeSemiFuture(GetBlobResult{
         std::move(blob), ObjectFetchContext::Origin::FromDiskCache});
   }
@@ -481,7 +629,11 @@ HgQueuedBackingStore::getBlobImpl(
                << ", hash is:" << id;
 
     auto request = HgImportRequest::makeBlobImportRequest(
-        id, proxyHash, context->getPriority(), context->getCause());
+        id,
+        proxyHash,
+        context->getPriority(),
+        context->getCause(),
+        context->getCancellationToken());
     auto unique = request->getUnique();
 
     auto importTracker =
@@ -508,18 +660,65 @@ HgQueuedBackingStore::getBlobImpl(
         });
   });
 
+  folly::stop_watch<> watch;
   return std::move(getBlobFuture)
-      .thenTry([this, id](folly::Try<std::unique_ptr<Blob>>&& result) {
+      .thenTry([this, id, watch](folly::Try<std::unique_ptr<Blob>>&& result) {
         this->queue_.markImportAsFinished<Blob>(id, result);
+        stats_->addDuration(
+            &HgBackingStoreStats::fetchBlobRemote, watch.elapsed());
         auto blob = std::move(result).value();
         return GetBlobResult{
             std::move(blob), ObjectFetchContext::Origin::FromNetworkFetch};
       });
 }
 
+void HgQueuedBackingStore::maybeLoadBootstrapBundle(const RootId& rootId) {
+  if (!config_ || rootId.value().empty()) {
+    return;
+  }
+  auto bundleDir = config_->getEdenConfig()->hgBootstrapBundleDir.getValue();
+  if (bundleDir.empty()) {
+    return;
+  }
+  {
+    auto tried = bootstrapBundlesTried_.wlock();
+    if (!tried->insert(rootId.value()).second) {
+      return;
+    }
+  }
+
+  auto bundlePath =
+      fmt::format("{}/{}", bundleDir, bootstrapBundleFileName(rootId));
+  std::string data;
+  if (!folly::readFile(bundlePath.c_str(), data)) {
+    XLOG(DBG4) << "no bootstrap bundle for " << rootId << " at " << bundlePath;
+    return;
+  }
+
+  folly::stop_watch<std::chrono::milliseconds> watch;
+  try {
+    auto trees =
+        deserializeBootstrapBundle(folly::ByteRange{folly::StringPiece{data}});
+    auto batch = localStore_->beginWrite();
+    for (const auto& tree : trees) {
+      batch->putTree(*tree);
+    }
+    batch->flush();
+    XLOG(INFO) << "seeded " << trees.size() << " trees for " << rootId
+               << " from bootstrap bundle " << bundlePath << " in "
+               << watch.elapsed().count() << "ms";
+  } catch (const std::exception& ex) {
+    // A bad bundle must never break mounting; the trees it would have
+    // seeded are simply fetched on demand as before.
+    XLOG(WARN) << "ignoring unusable bootstrap bundle " << bundlePath << ": "
+               << ex.what();
+  }
+}
+
 ImmediateFuture<std::unique_ptr<Tree>> HgQueuedBackingStore::getRootTree(
     const RootId& rootId,
     const ObjectFetchContextPtr& /*context*/) {
+  maybeLoadBootstrapBundle(rootId);
   return backingStore_->getRootTree(rootId);
 }
 
@@ -220,10 +220,25 @@ class HgQueuedBackingStore final : public BackingStore {
   void processPrefetchRequests(
       std::vector<std::shared_ptr<HgImportRequest>>&& requests);
 
+  /**
+   * Remove requests whose every subscriber has requested cancellation (e.g.
+   * an interrupted FUSE request) from a freshly dequeued batch, failing
+   * their promises with EINTR and clearing their de-duplication tracker
+   * entries so a later fetch of the same object starts a fresh import.
+   * Returns the requests that are still wanted.
+   */
+  template <typename T>
+  std::vector<std::shared_ptr<HgImportRequest>> dropCancelledRequests(
+      std::vector<std::shared_ptr<HgImportRequest>>&& requests);
+
   /**
    * The worker runloop function.
+   *
+   * Threads whose index falls below
+   * `backingstore:reserved-interactive-threads` only service Normal and
+   * higher priority requests.
    */
-  void processRequest();
+  void processRequest(size_t threadIndex, size_t totalThreads);
 
   void logMissingProxyHash();
 
@@ -286,6 +301,15 @@ class HgQueuedBackingStore final : public BackingStore {
   RequestMetricsScope::LockedRequestWatchList& getPendingImportWatches(
       HgBackingStore::HgImportObject object) const;
 
+  /**
+   * If a bootstrap bundle directory is configured and this commit's root
+   * tree has not been requested before, load the commit's bundle (when one
+   * exists) and bulk-insert its trees into the local store. Runs inline on
+   * the first getRootTree call for a commit: one file read and one write
+   * batch, in exchange for the tree round trips it saves a cold mount.
+   */
+  void maybeLoadBootstrapBundle(const RootId& rootId);
+
   /**
    * isRecordingFetch_ indicates if HgQueuedBackingStore is recording paths
    * for fetched files. Initially we don't record paths. When
@@ -297,6 +321,12 @@ class HgQueuedBackingStore final : public BackingStore {
   std::atomic<bool> isRecordingFetch_{false};
   folly::Synchronized<std::unordered_set<std::string>> fetchedFilePaths_;
 
+  /**
+   * Commits whose bootstrap bundle has already been probed for, so each
+   * bundle is loaded at most once per process.
+   */
+  folly::Synchronized<std::unordered_set<std::string>> bootstrapBundlesTried_;
+
   std::shared_ptr<LocalStore> localStore_;
   std::shared_ptr<EdenStats> stats_;
 
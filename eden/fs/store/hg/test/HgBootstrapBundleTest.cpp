@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/hg/HgBootstrapBundle.h"
+
+#include <fmt/format.h>
+#include <folly/portability/GTest.h>
+
+#include "eden/fs/model/RootId.h"
+#include "eden/fs/model/Tree.h"
+#include "eden/fs/model/TreeEntry.h"
+#include "eden/fs/utils/PathFuncs.h"
+
+using namespace facebook::eden;
+
+namespace {
+
+Tree makeTree(folly::StringPiece idHex, size_t entryCount) {
+  auto id = ObjectId::fromHex(idHex);
+  Tree::container entries{CaseSensitivity::Sensitive};
+  for (size_t i = 0; i < entryCount; ++i) {
+    entries.emplace(
+        PathComponent{fmt::format("file{}", i)},
+        id,
+        TreeEntryType::REGULAR_FILE);
+  }
+  return Tree{std::move(entries), id};
+}
+
+folly::ByteRange asBytes(const std::string& data) {
+  return folly::ByteRange{folly::StringPiece{data}};
+}
+
+} // namespace
+
+TEST(HgBootstrapBundle, roundTrip) {
+  auto one = makeTree("1111111111111111111111111111111111111111", 3);
+  auto two = makeTree("2222222222222222222222222222222222222222", 0);
+
+  auto data = serializeBootstrapBundle({&one, &two});
+  auto trees = deserializeBootstrapBundle(asBytes(data));
+
+  ASSERT_EQ(2, trees.size());
+  EXPECT_EQ(one.getHash(), trees[0]->getHash());
+  EXPECT_EQ(3, trees[0]->size());
+  EXPECT_NE(trees[0]->cend(), trees[0]->find("file1"_pc));
+  EXPECT_EQ(two.getHash(), trees[1]->getHash());
+  EXPECT_EQ(0, trees[1]->size());
+}
+
+TEST(HgBootstrapBundle, emptyBundleRoundTrips) {
+  auto data = serializeBootstrapBundle({});
+  EXPECT_TRUE(deserializeBootstrapBundle(asBytes(data)).empty());
+}
+
+TEST(HgBootstrapBundle, rejectsMalformedData) {
+  EXPECT_THROW(
+      deserializeBootstrapBundle(asBytes(std::string{})),
+      std::invalid_argument);
+
+  // Unknown format version.
+  EXPECT_THROW(
+      deserializeBootstrapBundle(asBytes(std::string{"\xff", 1})),
+      std::invalid_argument);
+
+  auto tree = makeTree("1111111111111111111111111111111111111111", 1);
+  auto data = serializeBootstrapBundle({&tree});
+
+  // Truncation anywhere in the stream is rejected.
+  for (size_t length = 1; length < data.size(); ++length) {
+    EXPECT_THROW(
+        deserializeBootstrapBundle(asBytes(data.substr(0, length))),
+        std::invalid_argument);
+  }
+
+  // As are trailing bytes after the last record.
+  EXPECT_THROW(
+      deserializeBootstrapBundle(asBytes(data + "x")), std::invalid_argument);
+}
+
+TEST(HgBootstrapBundle, fileNameUsesTheRootId) {
+  RootId rootId{"1111111111111111111111111111111111111111"};
+  EXPECT_EQ(
+      "1111111111111111111111111111111111111111.treebundle",
+      bootstrapBundleFileName(rootId));
+}
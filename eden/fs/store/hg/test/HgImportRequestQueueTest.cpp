@@ -5,11 +5,15 @@
  * GNU General Public License version 2.
  */
 
+#include <folly/CancellationToken.h>
 #include <folly/Try.h>
 #include <folly/logging/xlog.h>
 #include <folly/portability/GTest.h>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
 
 #include "eden/fs/config/ReloadableConfig.h"
 #include "eden/fs/model/Hash.h"
@@ -329,6 +333,128 @@ TEST_F(HgImportRequestQueueTest, getMultipleRequests) {
   }
 }
 
+TEST_F(HgImportRequestQueueTest, adaptiveBatchSizing) {
+  rawEdenConfig->importBatchSize.setValue(8, ConfigSource::UserConfig, true);
+  rawEdenConfig->importBatchTargetLatency.setValue(
+      std::chrono::nanoseconds{std::chrono::milliseconds{100}},
+      ConfigSource::UserConfig,
+      true);
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  std::vector<std::shared_ptr<HgImportRequest>> processed;
+  for (int i = 0; i < 20; i++) {
+    insertBlobImportRequest(
+        queue, ImportPriority{ImportPriority::Class::Normal});
+  }
+
+  auto dequeueAll = [&](size_t expected) {
+    auto batch = queue.dequeue();
+    EXPECT_EQ(expected, batch.size());
+    processed.insert(processed.end(), batch.begin(), batch.end());
+    return batch.size();
+  };
+
+  // The first batch uses the configured size.
+  dequeueAll(8);
+
+  // A batch that blew through the latency budget halves the next one.
+  queue.reportBlobBatchDuration(8, std::chrono::milliseconds{500});
+  dequeueAll(4);
+
+  // A full batch imported well under budget grows the cap again.
+  queue.reportBlobBatchDuration(4, std::chrono::milliseconds{10});
+  dequeueAll(6);
+  dequeueAll(2);
+
+  for (auto& request : processed) {
+    folly::Try<std::unique_ptr<Blob>> blob = folly::makeTryWith(
+        [hash =
+             request->getRequest<HgImportRequest::BlobImport>()->hash]() {
+          return std::make_unique<Blob>(hash, folly::IOBuf{});
+        });
+    queue.markImportAsFinished<Blob>(
+        request->getRequest<HgImportRequest::BlobImport>()->hash, blob);
+  }
+}
+
+TEST_F(HgImportRequestQueueTest, highPriorityBatchExcludesBackgroundWork) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  // A background prefetch burst is queued first.
+  std::set<ObjectId> prefetch;
+  for (int i = 0; i < 5; i++) {
+    prefetch.emplace(insertBlobImportRequest(
+        queue, ImportPriority(ImportPriority::Class::Low)));
+  }
+
+  // Interactive requests arrive afterwards.
+  auto interactive1 = insertBlobImportRequest(
+      queue, ImportPriority(ImportPriority::Class::High, 1));
+  auto interactive2 = insertBlobImportRequest(
+      queue, ImportPriority(ImportPriority::Class::High));
+
+  rawEdenConfig->importBatchSize.setValue(10, ConfigSource::UserConfig, true);
+
+  // Even though the batch size has room for all queued requests, the batch
+  // led by the interactive requests must not be padded with the prefetch
+  // burst.
+  auto batch = queue.dequeue();
+  ASSERT_EQ(2, batch.size());
+  EXPECT_EQ(
+      interactive1,
+      batch.at(0)->getRequest<HgImportRequest::BlobImport>()->hash);
+  EXPECT_EQ(
+      interactive2,
+      batch.at(1)->getRequest<HgImportRequest::BlobImport>()->hash);
+
+  // The background requests make up the next batch.
+  auto rest = queue.dequeue();
+  EXPECT_EQ(5, rest.size());
+
+  batch.insert(batch.end(), rest.begin(), rest.end());
+  for (auto& request : batch) {
+    folly::Try<std::unique_ptr<Blob>> blob = folly::makeTryWith(
+        [hash =
+             request->getRequest<HgImportRequest::BlobImport>()->hash]() {
+          return std::make_unique<Blob>(hash, folly::IOBuf{});
+        });
+    queue.markImportAsFinished<Blob>(
+        request->getRequest<HgImportRequest::BlobImport>()->hash, blob);
+  }
+}
+
+TEST_F(HgImportRequestQueueTest, reservedDequeueSkipsBackgroundWork) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  // Only background work is queued; a dequeue restricted to Normal and
+  // above must leave it in the queue and block.
+  auto background = insertBlobImportRequest(
+      queue, ImportPriority(ImportPriority::Class::Low));
+
+  std::atomic<bool> dequeued{false};
+  std::thread reserved([&] {
+    auto batch = queue.dequeue(ImportPriority::Class::Normal);
+    dequeued = true;
+    ASSERT_EQ(1, batch.size());
+    EXPECT_EQ(
+        ImportPriority::Class::Normal,
+        batch.at(0)->getPriority().getClass());
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(dequeued.load());
+
+  insertBlobImportRequest(queue, ImportPriority(ImportPriority::Class::Normal));
+  reserved.join();
+  EXPECT_TRUE(dequeued.load());
+
+  // The background request is still available to an unrestricted dequeue.
+  auto batch = queue.dequeue();
+  ASSERT_EQ(1, batch.size());
+  EXPECT_EQ(
+      background, batch.at(0)->getRequest<HgImportRequest::BlobImport>()->hash);
+}
+
 TEST_F(HgImportRequestQueueTest, duplicateRequestAfterEnqueue) {
   auto queue = HgImportRequestQueue{edenConfig};
   std::vector<ObjectId> enqueued;
@@ -403,6 +529,49 @@ TEST_F(HgImportRequestQueueTest, duplicateRequestAfterDequeue) {
       dequeuedRequest->getRequest<HgImportRequest::BlobImport>()->hash, blob);
 }
 
+TEST_F(HgImportRequestQueueTest, higherPriorityDuplicateOfInflightRequest) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  auto hgRevHash = uniqueHash();
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, hgRevHash};
+
+  auto [hash, request] = makeBlobImportRequestWithHash(
+      ImportPriority(ImportPriority::Class::Normal, 5), proxyHash);
+
+  queue.enqueueBlob(std::move(request));
+  auto dequeuedRequest = queue.dequeue().at(0);
+  EXPECT_FALSE(dequeuedRequest->isInQueue());
+
+  // While the first request is executing, enqueue an unrelated blob and a
+  // higher priority duplicate of the in-flight one. The duplicate must
+  // attach to the in-flight request rather than be queued again, and must
+  // not disturb the queued request.
+  auto otherHash = insertBlobImportRequest(
+      queue, ImportPriority(ImportPriority::Class::Normal, 5));
+  auto [hash2, request2] = makeBlobImportRequestWithHash(
+      ImportPriority(ImportPriority::Class::High, 5), proxyHash);
+  queue.enqueueBlob(std::move(request2));
+
+  EXPECT_EQ(
+      1,
+      dequeuedRequest->getRequest<HgImportRequest::BlobImport>()
+          ->promises.size());
+
+  auto nextRequest = queue.dequeue().at(0);
+  EXPECT_EQ(
+      otherHash,
+      nextRequest->getRequest<HgImportRequest::BlobImport>()->hash);
+
+  folly::Try<std::unique_ptr<Blob>> blob =
+      folly::makeTryWith([hash = proxyHash.sha1()]() {
+        return std::make_unique<Blob>(hash, folly::IOBuf{});
+      });
+  queue.markImportAsFinished<Blob>(
+      dequeuedRequest->getRequest<HgImportRequest::BlobImport>()->hash, blob);
+  queue.markImportAsFinished<Blob>(
+      nextRequest->getRequest<HgImportRequest::BlobImport>()->hash, blob);
+}
+
 TEST_F(HgImportRequestQueueTest, duplicateRequestAfterMarkedDone) {
   auto queue = HgImportRequestQueue{edenConfig};
   std::vector<ObjectId> enqueued;
@@ -568,3 +737,61 @@ TEST_F(HgImportRequestQueueTest, twoDuplicateRequestsDifferentPriority) {
         request->getRequest<HgImportRequest::BlobImport>()->hash, expBlob);
   }
 }
+
+TEST_F(HgImportRequestQueueTest, cancellationRequiresEverySubscriber) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  auto source = folly::CancellationSource{};
+  auto hgRevHash = uniqueHash();
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, hgRevHash};
+  auto hash = proxyHash.sha1();
+
+  auto request = HgImportRequest::makeBlobImportRequest(
+      hash,
+      proxyHash,
+      ImportPriority(ImportPriority::Class::Normal),
+      ObjectFetchContext::Cause::Fs,
+      source.getToken());
+  queue.enqueueBlob(request);
+
+  // A duplicate whose token can never be signalled keeps the import alive
+  // even after the first subscriber cancels.
+  auto [dupHash, duplicate] = makeBlobImportRequestWithHash(
+      ImportPriority(ImportPriority::Class::Normal), proxyHash);
+  queue.enqueueBlob(std::move(duplicate));
+
+  EXPECT_FALSE(request->isCancelled());
+  source.requestCancellation();
+  EXPECT_FALSE(request->isCancelled());
+}
+
+TEST_F(HgImportRequestQueueTest, cancelledWhenAllSubscribersAbandon) {
+  auto queue = HgImportRequestQueue{edenConfig};
+
+  auto source1 = folly::CancellationSource{};
+  auto source2 = folly::CancellationSource{};
+  auto hgRevHash = uniqueHash();
+  auto proxyHash = HgProxyHash{RelativePath{"some_blob"}, hgRevHash};
+  auto hash = proxyHash.sha1();
+
+  auto request = HgImportRequest::makeBlobImportRequest(
+      hash,
+      proxyHash,
+      ImportPriority(ImportPriority::Class::Normal),
+      ObjectFetchContext::Cause::Fs,
+      source1.getToken());
+  queue.enqueueBlob(request);
+
+  auto duplicate = HgImportRequest::makeBlobImportRequest(
+      hash,
+      proxyHash,
+      ImportPriority(ImportPriority::Class::Normal),
+      ObjectFetchContext::Cause::Fs,
+      source2.getToken());
+  queue.enqueueBlob(std::move(duplicate));
+
+  source1.requestCancellation();
+  EXPECT_FALSE(request->isCancelled());
+  source2.requestCancellation();
+  EXPECT_TRUE(request->isCancelled());
+}
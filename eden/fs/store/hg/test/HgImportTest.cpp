@@ -94,6 +94,40 @@ TEST_F(HgImportTest, importTest) {
       "no match found");
 }
 
+TEST_F(HgImportTest, fetchTreesPipelined) {
+  if (!testEnvironmentSupportsHg()) {
+    GTEST_SKIP();
+  }
+
+  repo_.mkdir("foo");
+  repo_.writeFile("foo/bar.txt", "this is a test file\n");
+  repo_.hg("add", "foo");
+  repo_.commit("Initial commit");
+
+  HgImporter importer(repo_.path(), stats_);
+
+  auto manifestNode =
+      Hash20{repo_.hg("log", "-r.", "-T{manifest}").substr(0, 40)};
+
+  // Pipeline several requests on a single helper process, including one for
+  // a manifest node that does not exist; only that entry should fail.
+  std::vector<std::pair<RelativePath, Hash20>> requests;
+  requests.emplace_back(RelativePath{}, manifestNode);
+  requests.emplace_back(RelativePath{}, makeTestHash20("123"));
+  requests.emplace_back(RelativePath{}, manifestNode);
+
+  auto results = importer.fetchTrees(requests);
+  ASSERT_EQ(results.size(), 3);
+  EXPECT_TRUE(results[0].hasValue());
+  EXPECT_FALSE(results[0].value()->empty());
+  EXPECT_TRUE(results[1].hasException());
+  EXPECT_TRUE(results[2].hasValue());
+
+  // The response stream must still be in sync after the failed entry.
+  auto buf = importer.fetchTree(RelativePathPiece{}, manifestNode);
+  EXPECT_FALSE(buf->empty());
+}
+
 // TODO(T33797958): Check hg_importer_helper's exit code on Windows (in
 // HgImportTest).
 #ifndef _WIN32
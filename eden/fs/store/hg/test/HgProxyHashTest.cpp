@@ -12,6 +12,7 @@
 
 #include "eden/fs/model/Hash.h"
 #include "eden/fs/model/TestOps.h"
+#include "eden/fs/store/MemoryLocalStore.h"
 #include "eden/fs/store/hg/HgProxyHash.h"
 #include "eden/fs/telemetry/EdenStats.h"
 #include "eden/fs/utils/IDGen.h"
@@ -61,6 +62,30 @@ TEST(HgProxyHashTest, round_trip_version_1) {
   }
 }
 
+TEST(HgProxyHashTest, legacy_resolutions_are_cached) {
+  EdenStats stats;
+  Hash20 hash{folly::StringPiece{"0123456789abcdef0123456789abcdef01234567"}};
+
+  HgProxyHash proxy{RelativePathPiece{"some/legacy/path"}, hash};
+  auto legacyId = proxy.sha1();
+
+  auto store = std::make_shared<MemoryLocalStore>();
+  store->put(
+      KeySpace::HgProxyHashFamily,
+      legacyId,
+      folly::StringPiece{proxy.getValue()});
+
+  auto loaded = HgProxyHash::load(store.get(), legacyId, "test", stats);
+  EXPECT_EQ(proxy, loaded);
+
+  // Resolving the same ID against a store that has never seen it must
+  // succeed: the mapping is immutable, so the first load's result is served
+  // from the in-memory cache.
+  auto emptyStore = std::make_shared<MemoryLocalStore>();
+  auto cached = HgProxyHash::load(emptyStore.get(), legacyId, "test", stats);
+  EXPECT_EQ(proxy, cached);
+}
+
 TEST(HgProxyHashTest, round_trip_version_2) {
   EdenStats stats;
   Hash20 hash{folly::StringPiece{"0123456789abcdef0123456789abcdef01234567"}};
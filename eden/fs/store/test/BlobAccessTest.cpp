@@ -171,3 +171,24 @@ TEST_F(BlobAccessTest, drops_oldest_blobs) {
   EXPECT_EQ(2, backingStore->getAccessCount(hash4));
   EXPECT_EQ(1, backingStore->getAccessCount(hash5));
 }
+
+TEST_F(BlobAccessTest, concurrent_misses_share_one_backing_store_fetch) {
+  const auto hash7 =
+      ObjectId::fromHex("0000000000000000000000000000000000000004");
+  auto* storedBlob = backingStore->putBlob(hash7, "7777777"_sp);
+
+  auto future1 =
+      blobAccess->getBlob(hash7, ObjectFetchContext::getNullContext());
+  auto future2 =
+      blobAccess->getBlob(hash7, ObjectFetchContext::getNullContext());
+  EXPECT_FALSE(future1.isReady());
+  EXPECT_FALSE(future2.isReady());
+
+  storedBlob->setReady();
+
+  EXPECT_EQ(7, std::move(future1).get(0ms).object->getSize());
+  EXPECT_EQ(7, std::move(future2).get(0ms).object->getSize());
+  // The second request subscribed to the first fetch rather than issuing its
+  // own.
+  EXPECT_EQ(1, backingStore->getAccessCount(hash7));
+}
@@ -118,3 +118,31 @@ TEST(BlobCache, does_not_forget_blob_until_last_handle_is_forgotten) {
   result2.interestHandle.reset();
   EXPECT_FALSE(weak.lock());
 }
+
+TEST(BlobCache, evicted_blob_is_recovered_from_compressed_tier) {
+  // A compressible blob large enough that its zstd form is smaller.
+  auto compressibleHash =
+      ObjectId::fromHex("00000000000000000000000000000000000000aa");
+  auto compressibleBlob = std::make_shared<Blob>(
+      compressibleHash, folly::StringPiece{std::string(64, 'a')});
+
+  auto cache = BlobCache::create(70, 0, 1024);
+  cache->insert(compressibleBlob);
+  cache->insert(blob9); // evicts the compressible blob into the tier
+
+  auto result = cache->get(compressibleHash);
+  ASSERT_TRUE(result.object);
+  EXPECT_EQ(std::string(64, 'a'), result.object->asString());
+}
+
+TEST(BlobCache, compressed_tier_disabled_by_default) {
+  auto compressibleHash =
+      ObjectId::fromHex("00000000000000000000000000000000000000ab");
+  auto compressibleBlob = std::make_shared<Blob>(
+      compressibleHash, folly::StringPiece{std::string(64, 'a')});
+
+  auto cache = BlobCache::create(70, 0);
+  cache->insert(compressibleBlob);
+  cache->insert(blob9);
+  EXPECT_FALSE(cache->get(compressibleHash).object);
+}
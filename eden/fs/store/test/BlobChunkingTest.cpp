@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/BlobChunking.h"
+
+#include <random>
+#include <set>
+#include <string>
+
+#include "eden/fs/store/KeySpace.h"
+#include "eden/fs/store/test/LocalStoreTest.h"
+
+using namespace facebook::eden;
+
+namespace {
+
+std::vector<uint8_t> makeTestData(size_t size, uint32_t seed) {
+  std::mt19937 rng{seed};
+  std::vector<uint8_t> data(size);
+  for (auto& byte : data) {
+    byte = static_cast<uint8_t>(rng());
+  }
+  return data;
+}
+
+} // namespace
+
+TEST(BlobChunking, chunksCoverInputExactly) {
+  auto data = makeTestData(10 * 1024 * 1024, 1);
+  auto chunks = chunkBlob(folly::ByteRange{data.data(), data.size()});
+
+  ASSERT_FALSE(chunks.empty());
+  const uint8_t* expectedStart = data.data();
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    EXPECT_EQ(expectedStart, chunks[i].data());
+    EXPECT_LE(chunks[i].size(), kMaxBlobChunkSize);
+    if (i + 1 < chunks.size()) {
+      EXPECT_GE(chunks[i].size(), kMinBlobChunkSize);
+    }
+    expectedStart += chunks[i].size();
+  }
+  EXPECT_EQ(data.data() + data.size(), expectedStart);
+}
+
+TEST(BlobChunking, smallInputIsOneChunk) {
+  auto data = makeTestData(kMinBlobChunkSize / 2, 2);
+  auto chunks = chunkBlob(folly::ByteRange{data.data(), data.size()});
+  ASSERT_EQ(1u, chunks.size());
+  EXPECT_EQ(data.size(), chunks[0].size());
+}
+
+TEST(BlobChunking, boundariesAreContentDefined) {
+  // Prepending data only disturbs boundaries near the start: chunking must
+  // resynchronize so the tails of both versions split identically. This is
+  // the property the on-disk dedup depends on.
+  auto data = makeTestData(8 * 1024 * 1024, 3);
+  std::vector<uint8_t> shifted = makeTestData(128 * 1024, 4);
+  shifted.insert(shifted.end(), data.begin(), data.end());
+
+  auto chunks = chunkBlob(folly::ByteRange{data.data(), data.size()});
+  auto shiftedChunks =
+      chunkBlob(folly::ByteRange{shifted.data(), shifted.size()});
+
+  std::set<std::string> chunkContents;
+  for (auto chunk : chunks) {
+    chunkContents.insert(std::string{folly::StringPiece{chunk}});
+  }
+  size_t sharedBytes = 0;
+  for (auto chunk : shiftedChunks) {
+    if (chunkContents.count(std::string{folly::StringPiece{chunk}})) {
+      sharedBytes += chunk.size();
+    }
+  }
+  EXPECT_GE(sharedBytes, data.size() / 2);
+}
+
+TEST(BlobChunking, manifestRoundTrip) {
+  std::vector<Hash20> chunks = {
+      Hash20::sha1(folly::ByteRange{folly::StringPiece{"chunk one"}}),
+      Hash20::sha1(folly::ByteRange{folly::StringPiece{"chunk two"}}),
+  };
+  auto serialized = serializeChunkedBlobManifest(12345, chunks);
+  auto parsed = parseChunkedBlobManifest(serialized.coalesce());
+
+  ASSERT_TRUE(parsed.has_value());
+  EXPECT_EQ(12345, parsed->blobSize);
+  EXPECT_EQ(chunks, parsed->chunks);
+}
+
+TEST(BlobChunking, gitBlobDataIsNotAManifest) {
+  folly::StringPiece gitBlob{"blob 5\0hello", 12};
+  EXPECT_FALSE(
+      parseChunkedBlobManifest(folly::ByteRange{gitBlob}).has_value());
+}
+
+TEST_P(LocalStoreTest, testChunkedBlobRoundTrip) {
+  store_->blobChunkingThreshold.store(1024 * 1024, std::memory_order_relaxed);
+
+  ObjectId id = ObjectId::fromHex("3a8f8eb91101860fd8484154885838bf322964d0");
+  auto data = makeTestData(5 * 1024 * 1024, 5);
+  auto blob = Blob{
+      id,
+      folly::IOBuf{
+          folly::IOBuf::COPY_BUFFER, data.data(), data.size()}};
+
+  store_->putBlob(id, &blob);
+
+  // The blob family holds a manifest, not the contents.
+  auto raw = store_->get(KeySpace::BlobFamily, id);
+  ASSERT_TRUE(raw.isValid());
+  EXPECT_LT(raw.bytes().size(), data.size());
+  EXPECT_TRUE(parseChunkedBlobManifest(raw.bytes()).has_value());
+
+  auto loaded = store_->getBlob(id).get(std::chrono::seconds{10});
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(blob.asString(), loaded->asString());
+}
+
+TEST_P(LocalStoreTest, testSmallBlobsAreNotChunked) {
+  store_->blobChunkingThreshold.store(1024 * 1024, std::memory_order_relaxed);
+
+  ObjectId id = ObjectId::fromHex("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+  auto blob = Blob{id, folly::StringPiece{"small contents"}};
+  store_->putBlob(id, &blob);
+
+  auto raw = store_->get(KeySpace::BlobFamily, id);
+  ASSERT_TRUE(raw.isValid());
+  EXPECT_FALSE(parseChunkedBlobManifest(raw.bytes()).has_value());
+
+  auto loaded = store_->getBlob(id).get(std::chrono::seconds{10});
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(blob.asString(), loaded->asString());
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/BlobSpillStore.h"
+
+#include <folly/experimental/TestUtil.h>
+#include <folly/portability/GTest.h>
+
+#include "eden/fs/model/Blob.h"
+
+using namespace facebook::eden;
+
+namespace {
+
+const auto hash1 =
+    ObjectId::fromHex("0000000000000000000000000000000000000001");
+const auto hash2 =
+    ObjectId::fromHex("0000000000000000000000000000000000000002");
+
+} // namespace
+
+TEST(BlobSpillStoreTest, storeAndGetRoundTrip) {
+  folly::test::TemporaryDirectory dir{"eden_blob_spill_test"};
+  BlobSpillStore store{canonicalPath(dir.path().string()), 16};
+
+  std::string contents(1024, 'x');
+  Blob blob{hash1, folly::StringPiece{contents}};
+
+  auto spilled = store.store(blob);
+  ASSERT_NE(nullptr, spilled);
+  EXPECT_EQ(hash1, spilled->getHash());
+  EXPECT_EQ(contents, spilled->asString());
+
+  // A fresh lookup is served from the spill file.
+  auto fetched = store.get(hash1);
+  ASSERT_NE(nullptr, fetched);
+  EXPECT_EQ(contents, fetched->asString());
+}
+
+TEST(BlobSpillStoreTest, getReturnsNullForUnknownBlob) {
+  folly::test::TemporaryDirectory dir{"eden_blob_spill_test"};
+  BlobSpillStore store{canonicalPath(dir.path().string()), 16};
+
+  EXPECT_EQ(nullptr, store.get(hash2));
+}
+
+TEST(BlobSpillStoreTest, spillFileOutlivesStore) {
+  folly::test::TemporaryDirectory dir{"eden_blob_spill_test"};
+  auto path = canonicalPath(dir.path().string());
+
+  std::string contents(256, 'y');
+  {
+    BlobSpillStore store{path, 16};
+    ASSERT_NE(nullptr, store.store(Blob{hash1, folly::StringPiece{contents}}));
+  }
+
+  // Spill files are content-addressed and survive restarts: a new store over
+  // the same directory serves the blob without re-storing it.
+  BlobSpillStore store{path, 16};
+  auto fetched = store.get(hash1);
+  ASSERT_NE(nullptr, fetched);
+  EXPECT_EQ(contents, fetched->asString());
+}
@@ -8,6 +8,7 @@
 #include "eden/fs/store/test/LocalStoreTest.h"
 #include "eden/fs/store/MemoryLocalStore.h"
 #include "eden/fs/store/SqliteLocalStore.h"
+#include "eden/fs/utils/UnboundedQueueExecutor.h"
 
 namespace {
 
@@ -91,6 +92,24 @@ TEST_P(LocalStoreTest, testReadAndWriteMetadata) {
   EXPECT_EQ(size, retrievedMetadata.value().size);
 }
 
+TEST_P(LocalStoreTest, testBlobSha1Index) {
+  ObjectId id = ObjectId::fromHex("3a8f8eb91101860fd8484154885838bf322964d0");
+  auto sha1 = Hash20::sha1("foobar");
+  BlobMetadata metadata{sha1, 6};
+
+  EXPECT_EQ(std::nullopt, store_->getBlobIdForSha1(sha1));
+
+  store_->putBlobMetadata(id, metadata);
+  EXPECT_EQ(id, store_->getBlobIdForSha1(sha1));
+
+  // A later write for the same content wins; the index tracks the ID the
+  // content was most recently cached under.
+  ObjectId newId =
+      ObjectId::fromHex("0123456789012345678901234567890123456789");
+  store_->putBlobMetadata(newId, metadata);
+  EXPECT_EQ(newId, store_->getBlobIdForSha1(sha1));
+}
+
 TEST_P(LocalStoreTest, testReadNonexistent) {
   using namespace std::chrono_literals;
 
@@ -238,6 +257,52 @@ TEST_P(LocalStoreTest, testMultipleBlobWriters) {
   EXPECT_EQ("hello world1_4", result1_4.piece());
 }
 
+TEST_P(LocalStoreTest, filterMissingStripsPresentIds) {
+  ObjectId present =
+      ObjectId::fromHex("3a8f8eb91101860fd8484154885838bf322964d0");
+  ObjectId absent =
+      ObjectId::fromHex("8e073e366ed82de6465d1209d3f07da7eebabb93");
+  store_->put(KeySpace::BlobFamily, present, "hello"_sp);
+
+  std::vector<ObjectId> ids{present, absent};
+  auto missing = store_->filterMissing(KeySpace::BlobFamily, folly::crange(ids));
+  ASSERT_EQ(1, missing.size());
+  EXPECT_EQ(absent, missing[0]);
+
+  // A second sweep is answered by the presence filter and must still strip
+  // the present id.
+  missing = store_->filterMissing(KeySpace::BlobFamily, folly::crange(ids));
+  ASSERT_EQ(1, missing.size());
+  EXPECT_EQ(absent, missing[0]);
+
+  // Clearing the caches resets the filter along with the stored data.
+  store_->clearCaches();
+  missing = store_->filterMissing(KeySpace::BlobFamily, folly::crange(ids));
+  EXPECT_EQ(2, missing.size());
+}
+
+TEST_P(LocalStoreTest, largeTreeDeserializesOnPool) {
+  // Build a tree whose serialized form exceeds the deserialization offload
+  // threshold so getTree() parses it on the pool rather than inline.
+  Tree::container entries{kPathMapDefaultCaseSensitive};
+  for (int i = 0; i < 1000; ++i) {
+    entries.emplace(
+        PathComponent{fmt::format("entry{}", i)},
+        ObjectId::fromHex("8e073e366ed82de6465d1209d3f07da7eebabb93"),
+        TreeEntryType::REGULAR_FILE);
+  }
+  ObjectId hash = ObjectId::fromHex("3a8f8eb91101860fd8484154885838bf322964d0");
+  auto tree = Tree{std::move(entries), hash};
+
+  store_->putTree(tree);
+  store_->setDeserializationPool(
+      std::make_shared<UnboundedQueueExecutor>(1, "parse"));
+
+  auto result = store_->getTree(hash).get(10s);
+  ASSERT_TRUE(result);
+  EXPECT_EQ(*result, tree);
+}
+
 TEST_P(LocalStoreTest, testClearKeySpace) {
   store_->put(KeySpace::BlobFamily, "key1"_sp, "blob1"_sp);
   store_->put(KeySpace::BlobFamily, "key2"_sp, "blob2"_sp);
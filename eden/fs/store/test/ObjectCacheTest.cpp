@@ -218,6 +218,39 @@ TEST(ObjectCache, testReinsert) {
   EXPECT_EQ(object3c, cache->getSimple(object3c->getHash()));
 }
 
+TEST(ObjectCache, testShrinkMaximumSizeEvictsOldest) {
+  auto cache =
+      ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(20, 0);
+
+  cache->insertSimple(object3);
+  cache->insertSimple(object4);
+  cache->insertSimple(object5);
+  EXPECT_EQ(20, cache->getMaximumCacheSizeBytes());
+
+  cache->setMaximumCacheSizeBytes(9);
+
+  EXPECT_EQ(9, cache->getMaximumCacheSizeBytes());
+  EXPECT_FALSE(cache->contains(object3->getHash()));
+  EXPECT_TRUE(cache->contains(object4->getHash()));
+  EXPECT_TRUE(cache->contains(object5->getHash()));
+}
+
+TEST(ObjectCache, testGrowMaximumSizeAdmitsMoreObjects) {
+  auto cache =
+      ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(7, 0);
+
+  cache->setMaximumCacheSizeBytes(20);
+
+  cache->insertSimple(object3);
+  cache->insertSimple(object4);
+  cache->insertSimple(object5);
+
+  EXPECT_TRUE(cache->contains(object3->getHash()));
+  EXPECT_TRUE(cache->contains(object4->getHash()));
+  EXPECT_TRUE(cache->contains(object5->getHash()));
+  EXPECT_EQ(12, cache->getStats().totalSizeInBytes);
+}
+
 /**
  * Interest-handle test cases
  */
@@ -534,3 +567,39 @@ TEST(
   handle3.reset();
   EXPECT_TRUE(cache->contains(hash3));
 }
+
+/**
+ * sharded cache test cases. Caches large enough to be split into multiple
+ * shards must still behave like one logical cache.
+ */
+
+TEST(ObjectCache, sharded_cache_stores_and_returns_objects) {
+  // Large enough for multiple shards, so objects land in different shards
+  // depending on their hash.
+  auto cache = ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(
+      64 * 1024 * 1024, 0);
+  cache->insertSimple(object3);
+  cache->insertSimple(object4);
+  cache->insertSimple(object5);
+  EXPECT_EQ(object3, cache->getSimple(hash3));
+  EXPECT_EQ(object4, cache->getSimple(hash4));
+  EXPECT_EQ(object5, cache->getSimple(hash5));
+
+  auto stats = cache->getStats();
+  EXPECT_EQ(3, stats.objectCount);
+  EXPECT_EQ(12, stats.totalSizeInBytes);
+  EXPECT_EQ(3, stats.hitCount);
+}
+
+TEST(ObjectCache, sharded_cache_clear_empties_every_shard) {
+  auto cache = ObjectCache<CacheObject, ObjectCacheFlavor::Simple>::create(
+      64 * 1024 * 1024, 0);
+  cache->insertSimple(object3);
+  cache->insertSimple(object4);
+  cache->insertSimple(object5);
+  cache->clear();
+  EXPECT_FALSE(cache->contains(hash3));
+  EXPECT_FALSE(cache->contains(hash4));
+  EXPECT_FALSE(cache->contains(hash5));
+  EXPECT_EQ(0, cache->getStats().totalSizeInBytes);
+}
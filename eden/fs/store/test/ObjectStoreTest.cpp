@@ -106,6 +106,48 @@ TEST_F(ObjectStoreTest, getBlob_tracks_second_read_from_cache) {
   EXPECT_EQ(ObjectFetchContext::FromDiskCache, request.origin);
 }
 
+TEST_F(ObjectStoreTest, getBlobs_returns_blobs_in_request_order) {
+  auto otherBlobId = putReadyBlob("otherblob");
+  auto blobs =
+      objectStore->getBlobs({readyBlobId, otherBlobId}, context).get(0ms);
+  ASSERT_EQ(2, blobs.size());
+  EXPECT_EQ("readyblob", blobs[0]->getContents().moveToFbString());
+  EXPECT_EQ("otherblob", blobs[1]->getContents().moveToFbString());
+}
+
+TEST_F(ObjectStoreTest, getTrees_fetches_all_requested_trees) {
+  auto trees = objectStore->getTrees({readyTreeId, readyTreeId}, context)
+                   .get(0ms);
+  ASSERT_EQ(2, trees.size());
+  EXPECT_EQ(readyTreeId, trees[0]->getHash());
+  EXPECT_EQ(readyTreeId, trees[1]->getHash());
+}
+
+TEST_F(ObjectStoreTest, getTrees_serves_warm_trees_from_local_store) {
+  objectStore->getTree(readyTreeId, context).get(0ms);
+
+  // clear the in memory cache so the batch has to go to the local store
+  treeCache->clear();
+
+  auto trees = objectStore->getTrees({readyTreeId}, context).get(0ms);
+  ASSERT_EQ(1, trees.size());
+  EXPECT_EQ(readyTreeId, trees[0]->getHash());
+  ASSERT_EQ(2, loggingContext->requests.size());
+  EXPECT_EQ(
+      ObjectFetchContext::FromDiskCache, loggingContext->requests[1].origin);
+}
+
+TEST_F(ObjectStoreTest, getBlobs_serves_warm_blobs_from_local_store) {
+  objectStore->getBlob(readyBlobId, context).get(0ms);
+
+  auto blobs = objectStore->getBlobs({readyBlobId}, context).get(0ms);
+  ASSERT_EQ(1, blobs.size());
+  EXPECT_EQ("readyblob", blobs[0]->getContents().moveToFbString());
+  ASSERT_EQ(2, loggingContext->requests.size());
+  EXPECT_EQ(
+      ObjectFetchContext::FromDiskCache, loggingContext->requests[1].origin);
+}
+
 TEST_F(ObjectStoreTest, getTree_tracks_backing_store_read) {
   objectStore->getTree(readyTreeId, context).get(0ms);
   ASSERT_EQ(1, loggingContext->requests.size());
@@ -198,6 +240,22 @@ TEST_F(ObjectStoreTest, getBlobSizeNotFound) {
       "blob .* not found");
 }
 
+TEST_F(ObjectStoreTest, getBlobSizeNotFoundIsCached) {
+  ObjectId id;
+
+  EXPECT_THROW_RE(
+      objectStore->getBlobSize(id, context).get(),
+      std::domain_error,
+      "blob .* not found");
+
+  // The second miss is answered by the negative cache without consulting the
+  // store, and still fails with the same error.
+  EXPECT_THROW_RE(
+      objectStore->getBlobSize(id, context).get(),
+      std::domain_error,
+      "blob .* not found");
+}
+
 TEST_F(ObjectStoreTest, getBlobSha1) {
   auto data = "A"_sp;
   ObjectId id = putReadyBlob(data);
@@ -263,3 +321,61 @@ TEST_F(ObjectStoreTest, test_process_access_counts) {
   EXPECT_EQ(2, objectStore->getPidFetches().rlock()->at(pid0));
   EXPECT_EQ(1, objectStore->getPidFetches().rlock()->at(pid1));
 }
+
+class PriorityFetchContext final : public ObjectFetchContext {
+ public:
+  PriorityFetchContext(pid_t pid) : ObjectFetchContext{}, pid_{pid} {}
+
+  std::optional<pid_t> getClientPid() const override {
+    return pid_;
+  }
+
+  Cause getCause() const override {
+    return Cause::Unknown;
+  }
+
+  ImportPriority getPriority() const override {
+    return priority_;
+  }
+
+  void deprioritize(uint64_t delta) override {
+    priority_ = priority_.adjusted(-static_cast<int64_t>(delta));
+  }
+
+  const std::unordered_map<std::string, std::string>* FOLLY_NULLABLE
+  getRequestInfo() const override {
+    return nullptr;
+  }
+
+ private:
+  pid_t pid_;
+  ImportPriority priority_{kDefaultImportPriority};
+};
+
+TEST_F(ObjectStoreTest, graduated_deprioritization_scales_with_fetch_count) {
+  auto rawEdenConfig = EdenConfig::createTestEdenConfig();
+  rawEdenConfig->fetchHeavyThreshold.setValue(2, ConfigSource::Default, true);
+  rawEdenConfig->fetchDeprioritizeMaxFactor.setValue(
+      3, ConfigSource::Default, true);
+  auto store = ObjectStore::create(
+      localStore,
+      backingStore,
+      treeCache,
+      stats,
+      std::make_shared<ProcessNameCache>(),
+      std::make_shared<NullStructuredLogger>(),
+      rawEdenConfig,
+      kPathMapDefaultCaseSensitive);
+
+  pid_t pid{10002};
+  for (int i = 0; i < 10; i++) {
+    store->getBlob(readyBlobId, makeRefPtr<PriorityFetchContext>(pid))
+        .get(0ms);
+  }
+
+  // 10 recorded fetches over a threshold of 2 is five thresholds' worth,
+  // clamped at the configured factor of 3.
+  auto context = makeRefPtr<PriorityFetchContext>(pid);
+  store->getBlob(readyBlobId, context).get(0ms);
+  EXPECT_EQ(-3, context->getPriority().getAdjustment());
+}
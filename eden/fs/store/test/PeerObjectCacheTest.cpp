@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifndef _WIN32
+
+#include "eden/fs/store/PeerObjectCache.h"
+
+#include <atomic>
+#include <map>
+#include <string>
+#include <thread>
+
+#include <folly/executors/InlineExecutor.h>
+#include <folly/io/IOBuf.h>
+#include <folly/lang/Bits.h>
+#include <folly/portability/GTest.h>
+#include <folly/logging/xlog.h>
+#include <folly/portability/Sockets.h>
+
+using namespace facebook::eden;
+
+namespace {
+
+bool readFully(int fd, void* data, size_t len) {
+  auto* p = static_cast<char*>(data);
+  while (len > 0) {
+    auto n = ::recv(fd, p, len, 0);
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= n;
+  }
+  return true;
+}
+
+void writeFully(int fd, const void* data, size_t len) {
+  auto* p = static_cast<const char*>(data);
+  while (len > 0) {
+    auto n = ::send(fd, p, len, 0);
+    if (n <= 0) {
+      return;
+    }
+    p += n;
+    len -= n;
+  }
+}
+
+/**
+ * A single-threaded in-process peer speaking the PeerObjectCache protocol,
+ * backed by a map.
+ */
+class TestPeerServer {
+ public:
+  TestPeerServer() {
+    listenFd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    XCHECK_GE(listenFd_, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    XCHECK_EQ(
+        0, ::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)));
+    XCHECK_EQ(0, ::listen(listenFd_, 8));
+    socklen_t addrLen = sizeof(addr);
+    XCHECK_EQ(
+        0,
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &addrLen));
+    address_ = folly::SocketAddress{"127.0.0.1", ntohs(addr.sin_port)};
+    thread_ = std::thread{[this] { acceptLoop(); }};
+  }
+
+  ~TestPeerServer() {
+    ::shutdown(listenFd_, SHUT_RDWR);
+    ::close(listenFd_);
+    thread_.join();
+  }
+
+  const folly::SocketAddress& address() const {
+    return address_;
+  }
+
+  /**
+   * When set, GET replies flip the last byte of the value while echoing
+   * the stored digest, simulating a peer whose disk or transport corrupted
+   * the bytes after they were digested.
+   */
+  void setCorruptReads(bool corrupt) {
+    corruptReads_.store(corrupt, std::memory_order_relaxed);
+  }
+
+  /**
+   * When set, GET replies for a present key serve some other stored
+   * entry's (value, digest) pair, simulating a peer whose key index is
+   * corrupt. The served entry is internally consistent, so a digest over
+   * the value alone would verify.
+   */
+  void setMisassociateReads(bool misassociate) {
+    misassociateReads_.store(misassociate, std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kDigestSize = 20;
+
+  void acceptLoop() {
+    while (true) {
+      int fd = ::accept(listenFd_, nullptr, nullptr);
+      if (fd < 0) {
+        return;
+      }
+      serveConnection(fd);
+      ::close(fd);
+    }
+  }
+
+  void serveConnection(int fd) {
+    while (true) {
+      uint8_t op;
+      uint16_t keyLen;
+      if (!readFully(fd, &op, sizeof(op)) ||
+          !readFully(fd, &keyLen, sizeof(keyLen))) {
+        return;
+      }
+      std::string key(folly::Endian::big(keyLen), '\0');
+      if (!readFully(fd, key.data(), key.size())) {
+        return;
+      }
+      if (op == 2) { // PUT
+        uint32_t valueLen;
+        if (!readFully(fd, &valueLen, sizeof(valueLen))) {
+          return;
+        }
+        StoredObject object;
+        object.digest.resize(kDigestSize);
+        if (!readFully(fd, object.digest.data(), object.digest.size())) {
+          return;
+        }
+        object.value.resize(folly::Endian::big(valueLen));
+        if (!readFully(fd, object.value.data(), object.value.size())) {
+          return;
+        }
+        objects_[key] = std::move(object);
+        uint8_t status = 1;
+        writeFully(fd, &status, sizeof(status));
+      } else { // GET
+        auto it = objects_.find(key);
+        if (it != objects_.end() &&
+            misassociateReads_.load(std::memory_order_relaxed)) {
+          auto other = std::next(it);
+          it = other != objects_.end() ? other : objects_.begin();
+        }
+        uint8_t status = it != objects_.end() ? 1 : 0;
+        writeFully(fd, &status, sizeof(status));
+        if (status) {
+          auto value = it->second.value;
+          if (corruptReads_.load(std::memory_order_relaxed) &&
+              !value.empty()) {
+            value.back() ^= 0x01;
+          }
+          uint32_t valueLen =
+              folly::Endian::big(static_cast<uint32_t>(value.size()));
+          writeFully(fd, &valueLen, sizeof(valueLen));
+          writeFully(fd, it->second.digest.data(), it->second.digest.size());
+          writeFully(fd, value.data(), value.size());
+        }
+      }
+    }
+  }
+
+  struct StoredObject {
+    std::string digest;
+    std::string value;
+  };
+
+  int listenFd_ = -1;
+  folly::SocketAddress address_;
+  std::map<std::string, StoredObject> objects_;
+  std::thread thread_;
+  std::atomic<bool> corruptReads_{false};
+  std::atomic<bool> misassociateReads_{false};
+};
+
+std::shared_ptr<folly::Executor> inlineExecutor() {
+  return std::shared_ptr<folly::Executor>{
+      &folly::InlineExecutor::instance(), [](folly::Executor*) {}};
+}
+
+std::string bufToString(const std::unique_ptr<folly::IOBuf>& buf) {
+  auto cloned = buf->cloneCoalescedAsValue();
+  return std::string{
+      reinterpret_cast<const char*>(cloned.data()), cloned.length()};
+}
+
+} // namespace
+
+TEST(PeerObjectCacheTest, miss_then_put_then_hit) {
+  TestPeerServer server;
+  PeerObjectCache cache{
+      server.address(), std::chrono::milliseconds(1000), inlineExecutor()};
+
+  EXPECT_EQ(nullptr, cache.get("repo/blob/abc").get());
+
+  cache.put(
+      "repo/blob/abc", folly::IOBuf::copyBuffer("hello peer", 10));
+  auto value = cache.get("repo/blob/abc").get();
+  ASSERT_NE(nullptr, value);
+  EXPECT_EQ("hello peer", bufToString(value));
+
+  // Other keys still miss.
+  EXPECT_EQ(nullptr, cache.get("repo/blob/def").get());
+}
+
+TEST(PeerObjectCacheTest, values_round_trip_binary_data) {
+  TestPeerServer server;
+  PeerObjectCache cache{
+      server.address(), std::chrono::milliseconds(1000), inlineExecutor()};
+
+  std::string data;
+  for (int i = 0; i < 1000; i++) {
+    data.push_back(static_cast<char>(i & 0xff));
+  }
+  cache.put("repo/tree/123", folly::IOBuf::copyBuffer(data));
+  auto value = cache.get("repo/tree/123").get();
+  ASSERT_NE(nullptr, value);
+  EXPECT_EQ(data, bufToString(value));
+}
+
+TEST(PeerObjectCacheTest, corrupted_value_reads_as_miss) {
+  TestPeerServer server;
+  PeerObjectCache cache{
+      server.address(), std::chrono::milliseconds(1000), inlineExecutor()};
+
+  cache.put("repo/blob/abc", folly::IOBuf::copyBuffer("hello peer", 10));
+  ASSERT_NE(nullptr, cache.get("repo/blob/abc").get());
+
+  // A reply whose bytes don't match the digest must never be surfaced as
+  // a hit; the tier above would persist it into the local store.
+  server.setCorruptReads(true);
+  EXPECT_EQ(nullptr, cache.get("repo/blob/abc").get());
+
+  // The mismatch is treated like any connection error: the backoff is
+  // armed, so the next lookup misses without contacting the peer.
+  server.setCorruptReads(false);
+  EXPECT_EQ(nullptr, cache.get("repo/blob/abc").get());
+}
+
+TEST(PeerObjectCacheTest, misassociated_value_reads_as_miss) {
+  TestPeerServer server;
+  PeerObjectCache cache{
+      server.address(), std::chrono::milliseconds(1000), inlineExecutor()};
+
+  cache.put("repo/blob/abc", folly::IOBuf::copyBuffer("value one", 9));
+  cache.put("repo/blob/def", folly::IOBuf::copyBuffer("value two", 9));
+  ASSERT_NE(nullptr, cache.get("repo/blob/abc").get());
+
+  // The served entry is intact — its value matches its digest — but it
+  // belongs to a different key. Since the digest covers the key too, it
+  // must not verify; surfacing it would persist the wrong object's bytes
+  // under this key in the local store.
+  server.setMisassociateReads(true);
+  EXPECT_EQ(nullptr, cache.get("repo/blob/abc").get());
+}
+
+TEST(PeerObjectCacheTest, unreachable_peer_reads_as_miss) {
+  // Bind a port and close it again so nothing is listening there.
+  folly::SocketAddress address;
+  {
+    TestPeerServer server;
+    address = server.address();
+  }
+  PeerObjectCache cache{
+      address, std::chrono::milliseconds(200), inlineExecutor()};
+
+  EXPECT_EQ(nullptr, cache.get("repo/blob/abc").get());
+  // The failure arms the backoff; further lookups miss immediately
+  // without a connection attempt.
+  EXPECT_EQ(nullptr, cache.get("repo/blob/abc").get());
+  cache.put("repo/blob/abc", folly::IOBuf::copyBuffer("x", 1));
+}
+
+#endif
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/StoreCompression.h"
+
+#include <iterator>
+#include <random>
+#include <string>
+
+#include "eden/fs/store/KeySpace.h"
+#include "eden/fs/store/test/LocalStoreTest.h"
+
+using namespace facebook::eden;
+
+namespace {
+
+std::string makeCompressibleData(size_t size, uint32_t seed) {
+  // Repeating dictionary words approximate source text: low entropy, but
+  // not trivially constant.
+  constexpr folly::StringPiece kWords[] = {
+      "return ", "static ", "include ", "namespace ", "struct ", "void "};
+  std::mt19937 rng{seed};
+  std::string data;
+  data.reserve(size);
+  while (data.size() < size) {
+    auto word = kWords[rng() % std::size(kWords)];
+    data.append(word.data(), word.size());
+  }
+  data.resize(size);
+  return data;
+}
+
+std::string makeRandomData(size_t size, uint32_t seed) {
+  std::mt19937 rng{seed};
+  std::string data(size, '\0');
+  for (auto& byte : data) {
+    byte = static_cast<char>(rng());
+  }
+  return data;
+}
+
+} // namespace
+
+TEST(StoreCompression, roundTripSmallValue) {
+  auto data = makeCompressibleData(4 * 1024, 1);
+  auto compressed = compressStoreValue(folly::ByteRange{
+      folly::StringPiece{data}});
+
+  ASSERT_TRUE(compressed.has_value());
+  EXPECT_LT(compressed->computeChainDataLength(), data.size());
+
+  auto raw = decompressStoreValue(compressed->coalesce());
+  ASSERT_TRUE(raw.has_value());
+  EXPECT_EQ(data, raw->moveToFbString().toStdString());
+}
+
+TEST(StoreCompression, roundTripLargeValue) {
+  auto data = makeCompressibleData(kZstdValueSizeThreshold * 2, 2);
+  auto compressed = compressStoreValue(folly::ByteRange{
+      folly::StringPiece{data}});
+
+  ASSERT_TRUE(compressed.has_value());
+  EXPECT_LT(compressed->computeChainDataLength(), data.size());
+
+  auto raw = decompressStoreValue(compressed->coalesce());
+  ASSERT_TRUE(raw.has_value());
+  EXPECT_EQ(data, raw->moveToFbString().toStdString());
+}
+
+TEST(StoreCompression, tinyValuesAreNotCompressed) {
+  auto data = makeCompressibleData(kMinCompressibleValueSize / 2, 3);
+  EXPECT_FALSE(
+      compressStoreValue(folly::ByteRange{folly::StringPiece{data}})
+          .has_value());
+}
+
+TEST(StoreCompression, randomDataIsNotCompressed) {
+  auto data = makeRandomData(64 * 1024, 4);
+  EXPECT_FALSE(
+      compressStoreValue(folly::ByteRange{folly::StringPiece{data}})
+          .has_value());
+}
+
+TEST(StoreCompression, entropyEstimates) {
+  auto text = makeCompressibleData(64 * 1024, 5);
+  auto random = makeRandomData(64 * 1024, 6);
+  EXPECT_LT(
+      estimateEntropy(folly::ByteRange{folly::StringPiece{text}}), 6.0);
+  EXPECT_GT(
+      estimateEntropy(folly::ByteRange{folly::StringPiece{random}}), 7.5);
+}
+
+TEST(StoreCompression, plainValuesPassThrough) {
+  folly::StringPiece gitBlob{"blob 5\0hello", 12};
+  EXPECT_FALSE(
+      decompressStoreValue(folly::ByteRange{gitBlob}).has_value());
+}
+
+TEST(StoreCompression, headerSniffIsOnlyAPrefixCheck) {
+  auto data = makeCompressibleData(4 * 1024, 9);
+  auto compressed =
+      compressStoreValue(folly::ByteRange{folly::StringPiece{data}});
+  ASSERT_TRUE(compressed.has_value());
+  EXPECT_TRUE(hasStoreCompressionHeader(compressed->coalesce()));
+
+  // Raw content that merely starts with the header string also matches;
+  // callers with unframed key spaces must disambiguate by content hash.
+  folly::StringPiece lookalike{"zblob 1 4096\0not actually compressed", 37};
+  EXPECT_TRUE(hasStoreCompressionHeader(folly::ByteRange{lookalike}));
+  EXPECT_FALSE(hasStoreCompressionHeader(
+      folly::ByteRange{folly::StringPiece{"blob 5\0hello", 12}}));
+}
+
+TEST_P(LocalStoreTest, testCompressedBlobRoundTrip) {
+  store_->compressBlobs.store(true, std::memory_order_relaxed);
+
+  ObjectId id = ObjectId::fromHex("bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb");
+  auto data = makeCompressibleData(64 * 1024, 7);
+  auto blob = Blob{id, folly::StringPiece{data}};
+
+  store_->putBlob(id, &blob);
+
+  // The stored value carries the compression header and is smaller than the
+  // contents.
+  auto raw = store_->get(KeySpace::BlobFamily, id);
+  ASSERT_TRUE(raw.isValid());
+  EXPECT_LT(raw.bytes().size(), data.size());
+
+  auto loaded = store_->getBlob(id).get(std::chrono::seconds{10});
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(blob.asString(), loaded->asString());
+}
+
+TEST_P(LocalStoreTest, testRawChunkStartingWithCompressionHeader) {
+  // Chunk boundaries are content-defined, so a raw chunk can begin with the
+  // literal bytes "zblob " (think fixtures or logs containing that string).
+  // With compression off the chunk is stored raw; the read path must not
+  // mistake it for a compressed value.
+  store_->blobChunkingThreshold.store(1024 * 1024, std::memory_order_relaxed);
+
+  ObjectId id = ObjectId::fromHex("dddddddddddddddddddddddddddddddddddddddd");
+  std::string data{"zblob 1 4096", 12};
+  data.push_back('\0');
+  // Random tail so the blob cannot be mistaken for anything structured and
+  // the payload after the fake header is not valid LZ4.
+  data += makeRandomData(5 * 1024 * 1024, 10);
+  auto blob = Blob{id, folly::StringPiece{data}};
+
+  store_->putBlob(id, &blob);
+
+  auto loaded = store_->getBlob(id).get(std::chrono::seconds{10});
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(blob.asString(), loaded->asString());
+}
+
+TEST_P(LocalStoreTest, testCompressedChunkRoundTrip) {
+  // The inverse case: with compression on, a compressible chunk is stored
+  // with a real header and must still decompress on read even though chunk
+  // values are disambiguated by content hash.
+  store_->blobChunkingThreshold.store(1024 * 1024, std::memory_order_relaxed);
+  store_->compressBlobs.store(true, std::memory_order_relaxed);
+
+  ObjectId id = ObjectId::fromHex("eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee");
+  auto data = makeCompressibleData(5 * 1024 * 1024, 11);
+  auto blob = Blob{id, folly::StringPiece{data}};
+
+  store_->putBlob(id, &blob);
+
+  auto loaded = store_->getBlob(id).get(std::chrono::seconds{10});
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(blob.asString(), loaded->asString());
+}
+
+TEST_P(LocalStoreTest, testCompressionDisabledStoresPlainValues) {
+  ObjectId id = ObjectId::fromHex("cccccccccccccccccccccccccccccccccccccccc");
+  auto data = makeCompressibleData(64 * 1024, 8);
+  auto blob = Blob{id, folly::StringPiece{data}};
+
+  store_->putBlob(id, &blob);
+
+  auto raw = store_->get(KeySpace::BlobFamily, id);
+  ASSERT_TRUE(raw.isValid());
+  EXPECT_GT(raw.bytes().size(), data.size());
+
+  auto loaded = store_->getBlob(id).get(std::chrono::seconds{10});
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(blob.asString(), loaded->asString());
+}
@@ -164,6 +164,27 @@ TEST_F(TreeCacheTest, testLargeInsert) {
   EXPECT_EQ(tree4, cache->get(tree4->getHash()));
 }
 
+TEST_F(TreeCacheTest, testIdenticalContentsShareOneContainer) {
+  // Same entries as tree0 under a different ObjectId, the way an unchanged
+  // directory shows up when walked from a different commit.
+  auto tree0Copy = std::make_shared<const Tree>(
+      Tree::container{{{entry0Name, entry0}}, kPathMapDefaultCaseSensitive},
+      hash6);
+  EXPECT_NE(tree0->getEntries(), tree0Copy->getEntries());
+
+  cache->insert(tree0);
+  cache->insert(tree0Copy);
+
+  auto cached = cache->get(tree0Copy->getHash());
+  ASSERT_TRUE(cached);
+  EXPECT_EQ(tree0Copy->getHash(), cached->getHash());
+  EXPECT_EQ(tree0->getEntries(), cached->getEntries());
+
+  // Trees with different contents must not be merged.
+  cache->insert(tree1);
+  EXPECT_NE(tree0->getEntries(), cache->get(tree1->getHash())->getEntries());
+}
+
 TEST_F(TreeCacheTest, testSizeOverflowLargeInsert) {
   cache->insert(tree0);
   cache->insert(tree1);
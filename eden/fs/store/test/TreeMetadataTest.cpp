@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/TreeMetadata.h"
+
+#include <folly/portability/GTest.h>
+
+#include "eden/fs/model/BlobMetadata.h"
+#include "eden/fs/store/StoreResult.h"
+#include "eden/fs/testharness/TestUtil.h"
+
+using namespace facebook::eden;
+
+namespace {
+
+TreeMetadata::HashIndexedEntryMetadata makeEntries() {
+  TreeMetadata::HashIndexedEntryMetadata entries;
+  entries.emplace_back(
+      makeTestHash("1"), BlobMetadata{makeTestHash20("aa"), 100});
+  entries.emplace_back(
+      makeTestHash("2"), BlobMetadata{makeTestHash20("bb"), 200});
+  entries.emplace_back(
+      makeTestHash("3"), BlobMetadata{makeTestHash20("cc"), 300});
+  return entries;
+}
+
+StoreResult toStoreResult(folly::IOBuf buf) {
+  auto coalesced = buf.cloneCoalescedAsValue();
+  return StoreResult{std::string{
+      reinterpret_cast<const char*>(coalesced.data()), coalesced.length()}};
+}
+
+std::string toString(folly::IOBuf buf) {
+  auto coalesced = buf.cloneCoalescedAsValue();
+  return std::string{
+      reinterpret_cast<const char*>(coalesced.data()), coalesced.length()};
+}
+
+} // namespace
+
+TEST(TreeMetadataTest, round_trips_through_serialize_and_deserialize) {
+  auto entries = makeEntries();
+  TreeMetadata metadata{entries};
+
+  auto result = toStoreResult(metadata.serialize());
+  auto deserialized = TreeMetadata::deserialize(result);
+  auto roundTripped =
+      std::get<TreeMetadata::HashIndexedEntryMetadata>(deserialized.entries());
+  ASSERT_EQ(entries.size(), roundTripped.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    EXPECT_EQ(entries[i].first, roundTripped[i].first);
+    EXPECT_EQ(entries[i].second.sha1, roundTripped[i].second.sha1);
+    EXPECT_EQ(entries[i].second.size, roundTripped[i].second.size);
+  }
+}
+
+TEST(TreeMetadataTest, find_entry_decodes_only_the_probed_entry) {
+  auto entries = makeEntries();
+  TreeMetadata metadata{entries};
+  auto serialized = toString(metadata.serialize());
+
+  for (auto& [hash, expected] : entries) {
+    auto found = TreeMetadata::findEntry(serialized, hash);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(expected.sha1, found->sha1);
+    EXPECT_EQ(expected.size, found->size);
+  }
+  EXPECT_FALSE(
+      TreeMetadata::findEntry(serialized, makeTestHash("ff")).has_value());
+}
+
+TEST(TreeMetadataTest, find_entry_handles_variable_length_hashes) {
+  // A non-20-byte id forces the V2 serialization format.
+  TreeMetadata::HashIndexedEntryMetadata entries;
+  entries.emplace_back(
+      ObjectId{folly::ByteRange{folly::StringPiece{"proxy-hash-key"}}},
+      BlobMetadata{makeTestHash20("aa"), 100});
+  entries.emplace_back(
+      makeTestHash("2"), BlobMetadata{makeTestHash20("bb"), 200});
+  TreeMetadata metadata{entries};
+  auto serialized = toString(metadata.serialize());
+
+  auto found = TreeMetadata::findEntry(serialized, entries[0].first);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(100u, found->size);
+  found = TreeMetadata::findEntry(serialized, entries[1].first);
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(200u, found->size);
+  EXPECT_FALSE(
+      TreeMetadata::findEntry(serialized, makeTestHash("ff")).has_value());
+}
+
+TEST(TreeMetadataTest, split_record_round_trips_entry_ids) {
+  auto entries = makeEntries();
+  TreeMetadata metadata{entries};
+
+  auto result = toStoreResult(metadata.serializeSplit());
+  auto entryIds = TreeMetadata::deserializeEntryIds(result);
+  ASSERT_EQ(entries.size(), entryIds.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    EXPECT_EQ(entries[i].first, entryIds[i]);
+  }
+}
+
+TEST(TreeMetadataTest, split_record_is_smaller_than_embedded_record) {
+  auto metadata = TreeMetadata{makeEntries()};
+  EXPECT_LT(
+      metadata.serializeSplit().computeChainDataLength(),
+      metadata.serialize().computeChainDataLength());
+}
+
+TEST(TreeMetadataTest, split_and_embedded_records_reject_each_other) {
+  auto metadata = TreeMetadata{makeEntries()};
+
+  auto split = toStoreResult(metadata.serializeSplit());
+  EXPECT_THROW(TreeMetadata::deserialize(split), std::invalid_argument);
+  EXPECT_FALSE(
+      TreeMetadata::findEntry(split.piece(), makeTestHash("1")).has_value());
+
+  auto embedded = toStoreResult(metadata.serialize());
+  EXPECT_THROW(
+      TreeMetadata::deserializeEntryIds(embedded), std::invalid_argument);
+}
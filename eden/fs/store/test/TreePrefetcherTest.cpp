@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/TreePrefetcher.h"
+
+#include <folly/portability/GTest.h>
+
+#include "eden/fs/store/LocalStoreCachedBackingStore.h"
+#include "eden/fs/store/MemoryLocalStore.h"
+#include "eden/fs/store/ObjectFetchContext.h"
+#include "eden/fs/store/ObjectStore.h"
+#include "eden/fs/telemetry/NullStructuredLogger.h"
+#include "eden/fs/testharness/FakeBackingStore.h"
+#include "eden/fs/testharness/StoredObject.h"
+#include "eden/fs/utils/ImmediateFuture.h"
+
+using namespace facebook::eden;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct TreePrefetcherTest : ::testing::Test {
+  void SetUp() override {
+    auto edenConfig = std::make_shared<ReloadableConfig>(
+        EdenConfig::createTestEdenConfig(), ConfigReloadBehavior::NoReload);
+    treeCache = TreeCache::create(edenConfig);
+    localStore = std::make_shared<MemoryLocalStore>();
+    stats = std::make_shared<EdenStats>();
+    fakeBackingStore = std::make_shared<FakeBackingStore>();
+    backingStore = std::make_shared<LocalStoreCachedBackingStore>(
+        fakeBackingStore, localStore, stats);
+    objectStore = ObjectStore::create(
+        localStore,
+        backingStore,
+        treeCache,
+        stats,
+        std::make_shared<ProcessNameCache>(),
+        std::make_shared<NullStructuredLogger>(),
+        EdenConfig::createTestEdenConfig(),
+        kPathMapDefaultCaseSensitive);
+
+    // root
+    // ├── a.txt
+    // └── sub
+    //     ├── b.txt
+    //     └── deep
+    //         └── c.txt
+    blobA = fakeBackingStore->putBlob("a");
+    blobA->setReady();
+    blobB = fakeBackingStore->putBlob("b");
+    blobB->setReady();
+    blobC = fakeBackingStore->putBlob("c");
+    blobC->setReady();
+    deepTree = fakeBackingStore->putTree({{"c.txt", blobC}});
+    deepTree->setReady();
+    subTree = fakeBackingStore->putTree({{"b.txt", blobB}, {"deep", deepTree}});
+    subTree->setReady();
+    rootTree = fakeBackingStore->putTree({{"a.txt", blobA}, {"sub", subTree}});
+    rootTree->setReady();
+  }
+
+  std::shared_ptr<const Tree> getRoot() {
+    return objectStore->getTree(rootTree->get().getHash(), context).get(0ms);
+  }
+
+  ObjectFetchContextPtr context = ObjectFetchContext::getNullContext();
+  std::shared_ptr<LocalStore> localStore;
+  std::shared_ptr<FakeBackingStore> fakeBackingStore;
+  std::shared_ptr<BackingStore> backingStore;
+  std::shared_ptr<TreeCache> treeCache;
+  std::shared_ptr<EdenStats> stats;
+  std::shared_ptr<ObjectStore> objectStore;
+
+  StoredBlob* blobA = nullptr;
+  StoredBlob* blobB = nullptr;
+  StoredBlob* blobC = nullptr;
+  StoredTree* deepTree = nullptr;
+  StoredTree* subTree = nullptr;
+  StoredTree* rootTree = nullptr;
+};
+
+} // namespace
+
+TEST_F(TreePrefetcherTest, walks_all_levels_and_prefetches_every_blob) {
+  auto prefetchStats =
+      prefetchTreeRecursive(
+          *objectStore, context, getRoot(), std::nullopt, true)
+          .get(0ms);
+  EXPECT_EQ(3, prefetchStats.treesWalked);
+  EXPECT_EQ(3, prefetchStats.blobsPrefetched);
+}
+
+TEST_F(TreePrefetcherTest, depth_limit_bounds_the_walk) {
+  auto prefetchStats =
+      prefetchTreeRecursive(*objectStore, context, getRoot(), 0u, true)
+          .get(0ms);
+  EXPECT_EQ(1, prefetchStats.treesWalked);
+  EXPECT_EQ(1, prefetchStats.blobsPrefetched);
+
+  prefetchStats = prefetchTreeRecursive(*objectStore, context, getRoot(), 1u, true)
+              .get(0ms);
+  EXPECT_EQ(2, prefetchStats.treesWalked);
+  EXPECT_EQ(2, prefetchStats.blobsPrefetched);
+}
+
+TEST_F(TreePrefetcherTest, directories_only_skips_blobs) {
+  auto prefetchStats =
+      prefetchTreeRecursive(
+          *objectStore, context, getRoot(), std::nullopt, false)
+          .get(0ms);
+  EXPECT_EQ(3, prefetchStats.treesWalked);
+  EXPECT_EQ(0, prefetchStats.blobsPrefetched);
+}
+
+TEST_F(TreePrefetcherTest, duplicate_blobs_within_a_level_are_deduplicated) {
+  auto tree = fakeBackingStore->putTree({{"x.txt", blobA}, {"y.txt", blobA}});
+  tree->setReady();
+  auto root = objectStore->getTree(tree->get().getHash(), context).get(0ms);
+
+  auto prefetchStats =
+      prefetchTreeRecursive(*objectStore, context, std::move(root),
+                            std::nullopt, true)
+          .get(0ms);
+  EXPECT_EQ(1, prefetchStats.treesWalked);
+  EXPECT_EQ(1, prefetchStats.blobsPrefetched);
+}
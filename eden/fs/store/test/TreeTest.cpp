@@ -48,3 +48,43 @@ TEST_P(LocalStoreTest, testReadAndWriteTree) {
   ASSERT_TRUE(outTree);
   EXPECT_EQ(*outTree, tree);
 }
+
+TEST_P(LocalStoreTest, testFindSerializedTreeEntry) {
+  ObjectId hash{"3a8f8eb91101860fd8484154885838bf322964d0aacc"};
+  ObjectId childHash1("8e073e366ed82de6465d1209d3f07da7eebabb93bbdd");
+  ObjectId childHash2("8e073e366ed82de6465d1209d3f07da7eebabb939988");
+
+  Tree::container entries{kPathMapDefaultCaseSensitive};
+  entries.emplace("one"_pc, childHash1, TreeEntryType::REGULAR_FILE);
+  entries.emplace("two"_pc, childHash2, TreeEntryType::TREE);
+  entries.emplace("three"_pc, childHash1, TreeEntryType::EXECUTABLE_FILE);
+  entries.emplace("four"_pc, childHash2, TreeEntryType::REGULAR_FILE);
+  entries.emplace("five"_pc, childHash1, TreeEntryType::SYMLINK);
+  auto tree = Tree{std::move(entries), hash};
+
+  auto serialized = tree.serialize();
+  serialized.coalesce();
+
+  store_->put(
+      KeySpace::TreeFamily,
+      hash.getBytes(),
+      folly::ByteRange(serialized.data(), serialized.length()));
+  auto outResult = store_->get(KeySpace::TreeFamily, hash);
+  ASSERT_TRUE(outResult.isValid());
+
+  // Each entry can be decoded directly from the serialized bytes, without
+  // materializing the rest of the tree.
+  for (const auto& entry : tree) {
+    auto found =
+        Tree::findSerializedEntry(outResult.piece(), entry.first.piece());
+    ASSERT_TRUE(found.has_value()) << "missing entry " << entry.first;
+    EXPECT_EQ(entry.first, found->first);
+    EXPECT_EQ(entry.second.getHash(), found->second.getHash());
+    EXPECT_EQ(entry.second.getType(), found->second.getType());
+  }
+
+  EXPECT_FALSE(
+      Tree::findSerializedEntry(outResult.piece(), "missing"_pc).has_value());
+  EXPECT_FALSE(
+      Tree::findSerializedEntry(outResult.piece(), "zzz"_pc).has_value());
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/store/WorkingSetSnapshot.h"
+
+#include <folly/portability/GTest.h>
+
+using namespace facebook::eden;
+
+namespace {
+
+folly::ByteRange asBytes(const std::string& data) {
+  return folly::ByteRange{folly::StringPiece{data}};
+}
+
+} // namespace
+
+TEST(WorkingSetSnapshot, roundTrip) {
+  WorkingSet workingSet;
+  workingSet.blobs.push_back(ObjectId::sha1("blob one"));
+  workingSet.blobs.push_back(ObjectId::sha1("blob two"));
+  workingSet.trees.push_back(ObjectId::sha1("tree one"));
+  // IDs are length-prefixed, so mixed-width IDs must survive a round trip.
+  workingSet.trees.push_back(ObjectId{folly::ByteRange{
+      folly::StringPiece{"a-backing-store-specific-identifier"}}});
+
+  auto data = serializeWorkingSet(workingSet);
+  auto parsed = deserializeWorkingSet(asBytes(data));
+
+  EXPECT_EQ(workingSet.blobs, parsed.blobs);
+  EXPECT_EQ(workingSet.trees, parsed.trees);
+}
+
+TEST(WorkingSetSnapshot, emptySetRoundTrips) {
+  auto data = serializeWorkingSet(WorkingSet{});
+  auto parsed = deserializeWorkingSet(asBytes(data));
+  EXPECT_TRUE(parsed.blobs.empty());
+  EXPECT_TRUE(parsed.trees.empty());
+}
+
+TEST(WorkingSetSnapshot, rejectsMalformedData) {
+  EXPECT_THROW(deserializeWorkingSet(folly::ByteRange{}), std::invalid_argument);
+
+  // Unknown version byte.
+  std::string badVersion{"\xff"};
+  EXPECT_THROW(
+      deserializeWorkingSet(asBytes(badVersion)), std::invalid_argument);
+
+  WorkingSet workingSet;
+  workingSet.blobs.push_back(ObjectId::sha1("blob"));
+  auto data = serializeWorkingSet(workingSet);
+
+  // Truncating the last ID byte must be detected.
+  auto truncated = data.substr(0, data.size() - 1);
+  EXPECT_THROW(
+      deserializeWorkingSet(asBytes(truncated)), std::invalid_argument);
+
+  // Unknown record type.
+  data[1] = 'x';
+  EXPECT_THROW(deserializeWorkingSet(asBytes(data)), std::invalid_argument);
+}
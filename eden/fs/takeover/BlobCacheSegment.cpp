@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifndef _WIN32
+
+#include "eden/fs/takeover/BlobCacheSegment.h"
+
+#include <memory>
+
+#include <folly/FileUtil.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+#include <folly/logging/xlog.h>
+#include <folly/system/MemoryMapping.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "eden/fs/model/Blob.h"
+#include "eden/fs/store/BlobCache.h"
+
+namespace facebook::eden {
+
+namespace {
+
+/**
+ * Segment layout: a magic word and entry count, followed by one record per
+ * blob: the ObjectId length and bytes, then the blob length and bytes. All
+ * integers are native-endian since the segment never leaves this machine.
+ */
+constexpr uint32_t kBlobCacheSegmentMagic = 0x45424331; // "EBC1"
+
+folly::File makeAnonymousFile() {
+#ifdef __linux__
+  int fd = memfd_create("eden_blob_cache_segment", MFD_CLOEXEC);
+  if (fd != -1) {
+    return folly::File{fd, /*ownsFd=*/true};
+  }
+  // Fall through to the portable path on EINVAL/ENOSYS.
+#endif
+  auto* f = tmpfile();
+  if (!f) {
+    folly::throwSystemError("unable to create blob cache segment file");
+  }
+  // Duplicate the descriptor so the FILE* can be closed without invalidating
+  // the folly::File.
+  folly::File file{::dup(fileno(f)), /*ownsFd=*/true};
+  fclose(f);
+  return file;
+}
+
+void releaseMapping(void* /*buf*/, void* userData) {
+  delete static_cast<std::shared_ptr<folly::MemoryMapping>*>(userData);
+}
+
+} // namespace
+
+std::optional<folly::File> serializeBlobCacheSegment(const BlobCache& cache) {
+  auto blobs = cache.getAllObjects();
+  if (blobs.empty()) {
+    return std::nullopt;
+  }
+
+  try {
+    auto file = makeAnonymousFile();
+
+    std::string buffer;
+    auto append = [&](const void* data, size_t size) {
+      buffer.append(static_cast<const char*>(data), size);
+    };
+    auto appendInt = [&](auto value) { append(&value, sizeof(value)); };
+
+    appendInt(kBlobCacheSegmentMagic);
+    appendInt(uint64_t{blobs.size()});
+    for (const auto& blob : blobs) {
+      auto hashBytes = blob->getHash().getBytes();
+      appendInt(uint32_t(hashBytes.size()));
+      append(hashBytes.data(), hashBytes.size());
+      appendInt(uint64_t{blob->getSize()});
+      for (auto range : blob->getContents()) {
+        append(range.data(), range.size());
+      }
+    }
+
+    if (folly::writeFull(file.fd(), buffer.data(), buffer.size()) !=
+        ssize_t(buffer.size())) {
+      folly::throwSystemError("short write to blob cache segment");
+    }
+
+    XLOG(DBG2) << "serialized " << blobs.size() << " blobs (" << buffer.size()
+               << " bytes) into blob cache takeover segment";
+    return file;
+  } catch (const std::exception& ex) {
+    XLOG(WARN) << "unable to serialize blob cache takeover segment: "
+               << ex.what();
+    return std::nullopt;
+  }
+}
+
+void restoreBlobCacheSegment(folly::File segment, BlobCache& cache) {
+  try {
+    auto mapping =
+        std::make_shared<folly::MemoryMapping>(std::move(segment), 0, -1);
+    auto range = mapping->range();
+    auto buf = folly::IOBuf::wrapBufferAsValue(range.data(), range.size());
+    folly::io::Cursor cursor{&buf};
+
+    if (cursor.read<uint32_t>() != kBlobCacheSegmentMagic) {
+      XLOG(WARN) << "blob cache takeover segment has unexpected magic; "
+                    "ignoring";
+      return;
+    }
+
+    auto count = cursor.read<uint64_t>();
+    for (uint64_t i = 0; i < count; ++i) {
+      auto hashSize = cursor.read<uint32_t>();
+      ObjectId hash{cursor.peekBytes().subpiece(0, hashSize)};
+      cursor.skip(hashSize);
+      auto blobSize = cursor.read<uint64_t>();
+
+      // Wrap the mapped bytes directly rather than copying them; each blob
+      // holds a reference to the shared mapping so the segment stays alive
+      // until the last blob is released.
+      auto contents = folly::IOBuf::takeOwnership(
+          const_cast<uint8_t*>(cursor.data()),
+          blobSize,
+          releaseMapping,
+          new std::shared_ptr<folly::MemoryMapping>(mapping));
+      cursor.skip(blobSize);
+
+      cache.insert(std::make_shared<const Blob>(hash, std::move(*contents)));
+    }
+
+    XLOG(DBG2) << "restored " << count << " blobs from blob cache takeover "
+               << "segment";
+  } catch (const std::exception& ex) {
+    XLOG(WARN) << "unable to restore blob cache takeover segment: "
+               << ex.what();
+  }
+}
+
+} // namespace facebook::eden
+
+#endif
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <optional>
+
+#include <folly/File.h>
+
+namespace facebook::eden {
+
+class BlobCache;
+
+/**
+ * Serialize the current contents of the BlobCache into an anonymous
+ * memory-backed file (memfd on Linux, an unlinked temporary file elsewhere).
+ *
+ * The returned file descriptor can be transferred to another process through
+ * TakeoverData so a newly started daemon begins with the old daemon's hot
+ * blob set instead of refetching it from disk or the network.
+ *
+ * Returns std::nullopt if the cache is empty or the segment could not be
+ * created; takeover must proceed regardless.
+ */
+std::optional<folly::File> serializeBlobCacheSegment(const BlobCache& cache);
+
+/**
+ * Repopulate the BlobCache from a segment produced by
+ * serializeBlobCacheSegment.
+ *
+ * The segment is mapped into memory and blob contents are wrapped without
+ * copying; the mapping is released once the last blob referencing it is
+ * evicted. Malformed segments are logged and ignored since the cache contents
+ * are purely an optimization.
+ */
+void restoreBlobCacheSegment(folly::File segment, BlobCache& cache);
+
+} // namespace facebook::eden
+
+#endif
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#ifndef _WIN32
+
+#include "eden/fs/takeover/InodeMapSegment.h"
+
+#include <folly/FileUtil.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+#include <folly/logging/xlog.h>
+#include <folly/system/MemoryMapping.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace facebook::eden {
+
+namespace {
+
+/**
+ * Segment layout: a magic word and entry count, followed by one record per
+ * unloaded inode: inode number, parent inode number, name length and bytes,
+ * unlinked flag, FS reference count, a hash-present flag with the hash
+ * length and bytes, and the mode. All integers are native-endian since the
+ * segment never leaves this machine.
+ */
+constexpr uint32_t kInodeMapSegmentMagic = 0x45494d31; // "EIM1"
+
+folly::File makeAnonymousFile() {
+#ifdef __linux__
+  int fd = memfd_create("eden_inode_map_segment", MFD_CLOEXEC);
+  if (fd != -1) {
+    return folly::File{fd, /*ownsFd=*/true};
+  }
+  // Fall through to the portable path on EINVAL/ENOSYS.
+#endif
+  auto* f = tmpfile();
+  if (!f) {
+    folly::throwSystemError("unable to create inode map segment file");
+  }
+  // Duplicate the descriptor so the FILE* can be closed without invalidating
+  // the folly::File.
+  folly::File file{::dup(fileno(f)), /*ownsFd=*/true};
+  fclose(f);
+  return file;
+}
+
+/**
+ * Render the records for a contiguous range of entries into a buffer. The
+ * record format is self-delimiting, so independently rendered ranges can be
+ * concatenated to form a valid segment body.
+ */
+std::string renderEntryRange(
+    const std::vector<SerializedInodeMapEntry>& entries,
+    size_t begin,
+    size_t end) {
+  std::string buffer;
+  auto append = [&](const void* data, size_t size) {
+    buffer.append(static_cast<const char*>(data), size);
+  };
+  auto appendInt = [&](auto value) { append(&value, sizeof(value)); };
+
+  for (size_t i = begin; i < end; ++i) {
+    const auto& entry = entries[i];
+    appendInt(uint64_t(*entry.inodeNumber_ref()));
+    appendInt(uint64_t(*entry.parentInode_ref()));
+    const auto& name = *entry.name_ref();
+    appendInt(uint32_t(name.size()));
+    append(name.data(), name.size());
+    appendInt(uint8_t(*entry.isUnlinked_ref() ? 1 : 0));
+    appendInt(int64_t(*entry.numFsReferences_ref()));
+    if (entry.hash_ref().has_value()) {
+      appendInt(uint8_t{1});
+      const auto& hash = entry.hash_ref().value();
+      appendInt(uint32_t(hash.size()));
+      append(hash.data(), hash.size());
+    } else {
+      appendInt(uint8_t{0});
+    }
+    appendInt(uint32_t(*entry.mode_ref()));
+  }
+  return buffer;
+}
+
+/**
+ * Entry count below which the segment body is rendered on the calling
+ * thread. Sharded rendering only pays off once encoding dominates, which
+ * takes a few hundred thousand records.
+ */
+constexpr size_t kParallelRenderThreshold = 250'000;
+
+/**
+ * Workers used to render a large segment. Bounded low because
+ * serializeChunked may already be building several mounts concurrently.
+ */
+constexpr size_t kMaxRenderWorkers = 4;
+
+} // namespace
+
+folly::File serializeInodeMapSegment(const SerializedInodeMap& inodeMap) {
+  auto file = makeAnonymousFile();
+
+  const auto& entries = *inodeMap.unloadedInodes_ref();
+
+  std::string header;
+  header.append(
+      reinterpret_cast<const char*>(&kInodeMapSegmentMagic),
+      sizeof(kInodeMapSegmentMagic));
+  uint64_t count = entries.size();
+  header.append(reinterpret_cast<const char*>(&count), sizeof(count));
+
+  // Each range renders into its own buffer and the buffers are stitched
+  // together in order below; the record format is self-delimiting, so the
+  // concatenation is identical to a single sequential pass.
+  std::vector<std::string> buffers;
+  if (entries.size() < kParallelRenderThreshold) {
+    buffers.push_back(renderEntryRange(entries, 0, entries.size()));
+  } else {
+    const size_t numWorkers = kMaxRenderWorkers;
+    folly::CPUThreadPoolExecutor executor{numWorkers};
+    std::vector<folly::Future<std::string>> futures;
+    futures.reserve(numWorkers);
+    const size_t perWorker = (entries.size() + numWorkers - 1) / numWorkers;
+    for (size_t begin = 0; begin < entries.size(); begin += perWorker) {
+      const size_t end = std::min(begin + perWorker, entries.size());
+      futures.push_back(folly::via(&executor, [&entries, begin, end] {
+        return renderEntryRange(entries, begin, end);
+      }));
+    }
+    for (auto& result : folly::collectAll(std::move(futures)).get()) {
+      buffers.push_back(std::move(result).value());
+    }
+  }
+
+  size_t totalBytes = header.size();
+  if (folly::writeFull(file.fd(), header.data(), header.size()) !=
+      ssize_t(header.size())) {
+    folly::throwSystemError("short write to inode map segment");
+  }
+  for (const auto& buffer : buffers) {
+    if (folly::writeFull(file.fd(), buffer.data(), buffer.size()) !=
+        ssize_t(buffer.size())) {
+      folly::throwSystemError("short write to inode map segment");
+    }
+    totalBytes += buffer.size();
+  }
+
+  XLOG(DBG2) << "serialized " << entries.size() << " unloaded inodes ("
+             << totalBytes << " bytes) into inode map takeover segment";
+  return file;
+}
+
+void forEachInodeMapSegmentEntry(
+    const folly::File& segment,
+    folly::FunctionRef<void(const InodeMapSegmentEntry&)> callback) {
+  folly::MemoryMapping mapping{segment.fd(), 0, -1};
+  auto range = mapping.range();
+  auto buf = folly::IOBuf::wrapBufferAsValue(range.data(), range.size());
+  folly::io::Cursor cursor{&buf};
+
+  if (cursor.read<uint32_t>() != kInodeMapSegmentMagic) {
+    throw std::runtime_error(
+        "inode map takeover segment has unexpected magic");
+  }
+
+  auto readString = [&](uint32_t size) {
+    folly::StringPiece value{
+        reinterpret_cast<const char*>(cursor.data()), size};
+    cursor.skip(size);
+    return value;
+  };
+
+  auto count = cursor.read<uint64_t>();
+  for (uint64_t i = 0; i < count; ++i) {
+    InodeMapSegmentEntry entry;
+    entry.inodeNumber = cursor.read<uint64_t>();
+    entry.parentInode = cursor.read<uint64_t>();
+    entry.name = readString(cursor.read<uint32_t>());
+    entry.isUnlinked = cursor.read<uint8_t>() != 0;
+    entry.numFsReferences = cursor.read<int64_t>();
+    if (cursor.read<uint8_t>() != 0) {
+      entry.hash = readString(cursor.read<uint32_t>());
+    }
+    entry.mode = cursor.read<uint32_t>();
+    callback(entry);
+  }
+}
+
+} // namespace facebook::eden
+
+#endif
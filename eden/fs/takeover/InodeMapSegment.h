@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <optional>
+
+#include <folly/File.h>
+#include <folly/Function.h>
+#include <folly/Range.h>
+
+#include "eden/fs/takeover/gen-cpp2/takeover_types.h"
+
+namespace facebook::eden {
+
+/**
+ * One unloaded-inode record read out of an inode map segment. The string
+ * fields point directly into the mapped segment; they are only valid for
+ * the duration of the forEachInodeMapSegmentEntry() callback.
+ */
+struct InodeMapSegmentEntry {
+  uint64_t inodeNumber;
+  uint64_t parentInode;
+  folly::StringPiece name;
+  bool isUnlinked;
+  int64_t numFsReferences;
+  /**
+   * Unset means the inode is materialized, matching the semantics of
+   * SerializedInodeMapEntry::hash.
+   */
+  std::optional<folly::StringPiece> hash;
+  uint32_t mode;
+};
+
+/**
+ * Write a mount's unloaded-inode table into an anonymous memory-backed file
+ * (memfd on Linux, an unlinked temporary file elsewhere) using a flat
+ * native-endian record format.
+ *
+ * The returned file descriptor is transferred through TakeoverData in place
+ * of the thrift-encoded inode map, so the new daemon can map the pages the
+ * old daemon wrote instead of decoding millions of thrift entries out of the
+ * takeover message. Unlike the blob cache segment this data is
+ * authoritative, so failures throw rather than being swallowed.
+ */
+folly::File serializeInodeMapSegment(const SerializedInodeMap& inodeMap);
+
+/**
+ * Invoke the callback for each record in a segment produced by
+ * serializeInodeMapSegment. The segment is mapped read-only and the entry's
+ * string fields alias the mapping, so callers that need the data beyond the
+ * callback must copy it. Throws on a malformed segment.
+ */
+void forEachInodeMapSegmentEntry(
+    const folly::File& segment,
+    folly::FunctionRef<void(const InodeMapSegmentEntry&)> callback);
+
+} // namespace facebook::eden
+
+#endif
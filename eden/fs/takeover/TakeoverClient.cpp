@@ -9,6 +9,9 @@
 
 #include "eden/fs/takeover/TakeoverClient.h"
 
+#include <optional>
+
+#include <fmt/format.h>
 #include <folly/io/Cursor.h>
 #include <folly/io/async/EventBase.h>
 #include <folly/logging/xlog.h>
@@ -31,14 +34,49 @@ DEFINE_int32(
 
 namespace facebook::eden {
 
+namespace {
+
+/**
+ * Receive the per-mount follow-up messages sent when the CHUNKED_MOUNTS
+ * capability was negotiated. Each message carries exactly one mount and
+ * that mount's channel fd; the mounts are appended to `data` as they
+ * arrive.
+ */
+folly::Future<folly::Unit> receiveMountChunks(
+    FutureUnixSocket& socket,
+    TakeoverData& data,
+    size_t remaining) {
+  if (remaining == 0) {
+    return folly::makeFuture();
+  }
+  auto timeout = std::chrono::seconds(FLAGS_takeoverReceiveTimeout);
+  return socket.receive(timeout).thenValue(
+      [&socket, &data, remaining](UnixSocket::Message&& msg) {
+        for (auto& file : msg.files) {
+          XLOG(DBG7) << "received fd for takeover: " << file.fd();
+        }
+        auto chunk = TakeoverData::deserialize(msg);
+        if (chunk.mountPoints.size() != 1) {
+          throw std::runtime_error(fmt::format(
+              "expected a takeover mount chunk to contain exactly one "
+              "mount, but it contained {}",
+              chunk.mountPoints.size()));
+        }
+        data.mountPoints.emplace_back(std::move(chunk.mountPoints.front()));
+        return receiveMountChunks(socket, data, remaining - 1);
+      });
+}
+
+} // namespace
+
 TakeoverData takeoverMounts(
     AbsolutePathPiece socketPath,
     bool shouldPing,
     const std::set<int32_t>& supportedVersions,
     const uint64_t supportedTakeoverCapabilities) {
   folly::EventBase evb;
-  folly::Expected<UnixSocket::Message, folly::exception_wrapper>
-      expectedMessage;
+  std::optional<TakeoverData> takeoverData;
+  folly::exception_wrapper error;
 
   auto connectTimeout = std::chrono::seconds(1);
   FutureUnixSocket socket;
@@ -84,26 +122,28 @@ TakeoverData takeoverMounts(
           return folly::makeFuture<UnixSocket::Message>(std::move(msg));
         }
       })
-      .thenValue([&expectedMessage](UnixSocket::Message&& msg) {
-        expectedMessage = std::move(msg);
+      .thenValue([&socket, &takeoverData](UnixSocket::Message&& msg) {
+        for (auto& file : msg.files) {
+          XLOG(DBG7) << "received fd for takeover: " << file.fd();
+        }
+        // Deserialize the initial message before leaving the event loop:
+        // when the server sent the mounts in per-mount chunks this message
+        // tells us how many follow-up messages to receive.
+        auto& data = takeoverData.emplace(TakeoverData::deserialize(msg));
+        return receiveMountChunks(socket, data, data.chunkedMountCount);
       })
-      .thenError([&expectedMessage](folly::exception_wrapper&& ew) {
-        expectedMessage = folly::makeUnexpected(std::move(ew));
+      .thenError([&error](folly::exception_wrapper&& ew) {
+        error = std::move(ew);
       })
       .ensure([&evb] { evb.terminateLoopSoon(); });
 
   evb.loop();
 
-  if (!expectedMessage) {
-    XLOG(ERR) << "error receiving takeover data: " << expectedMessage.error();
-    expectedMessage.error().throw_exception();
-  }
-  auto& message = expectedMessage.value();
-  for (auto& file : message.files) {
-    XLOG(DBG7) << "received fd for takeover: " << file.fd();
+  if (error) {
+    XLOG(ERR) << "error receiving takeover data: " << error;
+    error.throw_exception();
   }
-
-  return TakeoverData::deserialize(message);
+  return std::move(takeoverData).value();
 }
 } // namespace facebook::eden
 
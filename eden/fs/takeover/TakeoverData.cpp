@@ -14,12 +14,15 @@
 #include <variant>
 
 #include <fmt/format.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/futures/Future.h>
 #include <folly/io/IOBuf.h>
 #include <folly/logging/xlog.h>
 #include "folly/Likely.h"
 
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
+#include "eden/fs/takeover/InodeMapSegment.h"
 #include "eden/fs/utils/Bug.h"
 #include "eden/fs/utils/Throw.h"
 #include "eden/fs/utils/UnixSocket.h"
@@ -48,6 +51,53 @@ TakeoverMountProtocol getMountProtocol(
       mountInfo.mountPath);
 }
 
+/**
+ * Build the SerializedMountInfo for a single mount.
+ *
+ * The inode map dominates the size of the takeover message: it has one
+ * entry per unloaded inode, which can run into the millions on a large
+ * mount. With the INODE_MAP_SEGMENTS capability it is written into a
+ * memory-backed file stored on the MountInfo, so only the file descriptor
+ * travels through the message. Otherwise it is moved into the returned
+ * struct rather than copied inside the stop-the-world window; callers that
+ * may still need the mount for recovery are responsible for moving it back.
+ */
+SerializedMountInfo serializeMountInfo(
+    uint64_t protocolCapabilities,
+    TakeoverData::MountInfo& mount,
+    TakeoverMountProtocol mountProtocol) {
+  SerializedMountInfo serializedMount;
+
+  *serializedMount.mountPath_ref() = mount.mountPath.asString();
+  *serializedMount.stateDirectory_ref() = mount.stateDirectory.asString();
+
+  for (const auto& bindMount : mount.bindMounts) {
+    serializedMount.bindMountPaths_ref()->push_back(bindMount.asString());
+  }
+
+  if (auto fuseChannelInfo = std::get_if<FuseChannelData>(&mount.channelInfo)) {
+    // Stuffing the fuse connection information in as a binary
+    // blob because we know that the endianness of the target
+    // machine must match the current system for a graceful
+    // takeover, and it saves us from re-encoding an operating
+    // system specific struct into a thrift file.
+    serializedMount.connInfo_ref() = std::string{
+        reinterpret_cast<const char*>(&fuseChannelInfo->connInfo),
+        sizeof(fuseChannelInfo->connInfo)};
+  }
+
+  if (protocolCapabilities & TakeoverCapabilities::INODE_MAP_SEGMENTS) {
+    mount.inodeMapSegment = serializeInodeMapSegment(mount.inodeMap);
+    serializedMount.inodeMapSegmentAttached_ref() = true;
+  } else {
+    *serializedMount.inodeMap_ref() = std::move(mount.inodeMap);
+  }
+
+  serializedMount.mountProtocol_ref() = mountProtocol;
+
+  return serializedMount;
+}
+
 } // namespace
 
 const std::set<int32_t> kSupportedTakeoverVersions{
@@ -63,7 +113,10 @@ const uint64_t kSupportedCapabilities = TakeoverCapabilities::FUSE |
     TakeoverCapabilities::RESULT_TYPE_SERIALIZATION |
     TakeoverCapabilities::ORDERED_FDS | TakeoverCapabilities::OPTIONAL_MOUNTD |
     TakeoverCapabilities::CAPABILITY_MATCHING |
-    TakeoverCapabilities::INCLUDE_HEADER_SIZE;
+    TakeoverCapabilities::INCLUDE_HEADER_SIZE |
+    TakeoverCapabilities::CACHE_SEGMENT |
+    TakeoverCapabilities::CHUNKED_MOUNTS |
+    TakeoverCapabilities::INODE_MAP_SEGMENTS;
 
 std::optional<int32_t> TakeoverData::computeCompatibleVersion(
     const std::set<int32_t>& versions,
@@ -102,6 +155,25 @@ uint64_t TakeoverData::computeCompatibleCapabilities(
     throw std::runtime_error{
         "Optional mountd can not be used without ordered file descriptors"};
   }
+  if ((compatible & TakeoverCapabilities::CACHE_SEGMENT) &&
+      ((compatible & TakeoverCapabilities::ORDERED_FDS) == 0)) {
+    throw std::runtime_error{
+        "The cache segment can not be used without ordered file descriptors"};
+  }
+  if ((compatible & TakeoverCapabilities::CHUNKED_MOUNTS) &&
+      ((compatible & TakeoverCapabilities::ORDERED_FDS) == 0 ||
+       (compatible & TakeoverCapabilities::RESULT_TYPE_SERIALIZATION) == 0)) {
+    throw std::runtime_error{
+        "Chunked mounts can not be used without ordered file descriptors "
+        "and result type serialization"};
+  }
+  if ((compatible & TakeoverCapabilities::INODE_MAP_SEGMENTS) &&
+      ((compatible & TakeoverCapabilities::ORDERED_FDS) == 0 ||
+       (compatible & TakeoverCapabilities::RESULT_TYPE_SERIALIZATION) == 0)) {
+    throw std::runtime_error{
+        "Inode map segments can not be used without ordered file "
+        "descriptors and result type serialization"};
+  }
 
   return compatible;
 }
@@ -151,6 +223,15 @@ int32_t TakeoverData::capabilitesToVersion(uint64_t capabilities) {
   if (capabilities == 0) {
     return kTakeoverProtocolVersionNeverSupported;
   }
+
+  // Capabilities introduced after version seven don't define new versions;
+  // they are negotiated through CAPABILITY_MATCHING. Mask them out when
+  // computing the version to advertise.
+  constexpr uint64_t kVersionlessCapabilities =
+      TakeoverCapabilities::CACHE_SEGMENT |
+      TakeoverCapabilities::CHUNKED_MOUNTS |
+      TakeoverCapabilities::INODE_MAP_SEGMENTS;
+  capabilities &= ~kVersionlessCapabilities;
   if (capabilities ==
       (TakeoverCapabilities::CUSTOM_SERIALIZATION |
        TakeoverCapabilities::FUSE)) {
@@ -219,6 +300,10 @@ std::vector<FileDescriptorType> TakeoverData::generateGeneralFdOrder(
        mountdServerSocket != std::nullopt)) {
     fileDescriptorOrder.push_back(FileDescriptorType::MOUNTD_SOCKET);
   }
+  if ((protocolCapabilities & TakeoverCapabilities::CACHE_SEGMENT) &&
+      blobCacheSegment != std::nullopt) {
+    fileDescriptorOrder.push_back(FileDescriptorType::BLOB_CACHE_SEGMENT);
+  }
   return fileDescriptorOrder;
 }
 
@@ -236,6 +321,9 @@ void TakeoverData::serializeFd(
     case FileDescriptorType::MOUNTD_SOCKET:
       fileToSerialize = &mountdServerSocket.value();
       break;
+    case FileDescriptorType::BLOB_CACHE_SEGMENT:
+      fileToSerialize = &blobCacheSegment.value();
+      break;
     default:
       throwf<std::runtime_error>("Unexpected FileDescriptorType {}", type);
   }
@@ -256,6 +344,9 @@ void TakeoverData::deserializeFd(FileDescriptorType type, folly::File& file) {
     case FileDescriptorType::MOUNTD_SOCKET:
       mountdServerSocket = std::move(file);
       return;
+    case FileDescriptorType::BLOB_CACHE_SEGMENT:
+      blobCacheSegment = std::move(file);
+      return;
     default:
       throwf<std::runtime_error>("Unexpected FileDescriptorType {}", type);
   }
@@ -292,9 +383,106 @@ void TakeoverData::serialize(
     } else {
       throw std::runtime_error("Unexpected Channel Type");
     }
+    if (mount.inodeMapSegment.has_value()) {
+      msg.files.push_back(std::move(mount.inodeMapSegment.value()));
+      mount.inodeMapSegment.reset();
+    }
   }
 }
 
+std::vector<UnixSocket::Message> TakeoverData::serializeChunked(
+    uint64_t protocolCapabilities) {
+  XCHECK(protocolCapabilities & TakeoverCapabilities::CHUNKED_MOUNTS)
+      << fmt::format(
+             "Asked to serialize chunked takeover data without the chunked "
+             "mounts capability. Capabilities: {}",
+             protocolCapabilities);
+
+  // Validate every mount before building any message so that a capability
+  // mismatch surfaces before anything has been consumed.
+  for (const auto& mount : mountPoints) {
+    checkCanSerDeMountType(
+        protocolCapabilities, getMountProtocol(mount), mount.mountPath.view());
+  }
+
+  std::vector<UnixSocket::Message> messages;
+  messages.reserve(mountPoints.size() + 1);
+
+  // The initial message carries the general file descriptors and an empty
+  // mount list announcing how many per-mount messages follow.
+  auto mounts = std::move(mountPoints);
+  mountPoints.clear();
+  chunkedMountCount = mounts.size();
+  serialize(protocolCapabilities, messages.emplace_back());
+  chunkedMountCount = 0;
+
+  // Building a mount's chunk renders its inode map into either a thrift
+  // struct or a memory-backed segment, which takes seconds per mount when
+  // millions of unloaded inodes are attached. The chunks are independent,
+  // so build them concurrently with one worker per mount (bounded), keeping
+  // the message order stable. This all runs inside the restart blackout
+  // window, so the work is worth the short-lived threads.
+  constexpr size_t kMaxSerializeWorkers = 8;
+  const size_t numWorkers = std::min(mounts.size(), kMaxSerializeWorkers);
+  if (numWorkers <= 1) {
+    for (auto& mount : mounts) {
+      messages.emplace_back(
+          serializeMountChunk(protocolCapabilities, std::move(mount)));
+    }
+  } else {
+    folly::CPUThreadPoolExecutor executor{numWorkers};
+    std::vector<folly::Future<UnixSocket::Message>> futures;
+    futures.reserve(mounts.size());
+    for (auto& mount : mounts) {
+      futures.push_back(folly::via(
+          &executor, [protocolCapabilities, mount = std::move(mount)]() mutable {
+            return serializeMountChunk(protocolCapabilities, std::move(mount));
+          }));
+    }
+    for (auto& result : folly::collectAll(std::move(futures)).get()) {
+      // value() rethrows a failed chunk, surfacing it like a failure in the
+      // sequential path would.
+      messages.emplace_back(std::move(result).value());
+    }
+  }
+
+  return messages;
+}
+
+UnixSocket::Message TakeoverData::serializeMountChunk(
+    uint64_t protocolCapabilities,
+    MountInfo&& mount) {
+  UnixSocket::Message msg;
+  folly::IOBufQueue bufQ;
+  serializeHeader(protocolCapabilities, bufQ);
+
+  auto mountProtocol = getMountProtocol(mount);
+
+  SerializedTakeoverInfo serialized;
+  serialized.mounts_ref()->emplace_back(
+      serializeMountInfo(protocolCapabilities, mount, mountProtocol));
+  // The general file descriptors were sent with the initial message, so
+  // this message's fd list holds only the mount's channel fd.
+  SerializedTakeoverResult result;
+  result.takeoverData_ref() = std::move(serialized);
+  CompactSerializer::serialize(result, &bufQ);
+  msg.data = std::move(*bufQ.move());
+
+  if (auto fuseData = std::get_if<FuseChannelData>(&mount.channelInfo)) {
+    msg.files.push_back(std::move(fuseData->fd));
+  } else if (auto nfsData = std::get_if<NfsChannelData>(&mount.channelInfo)) {
+    msg.files.push_back(std::move(nfsData->nfsdSocketFd));
+  } else {
+    throw std::runtime_error("Unexpected Channel Type");
+  }
+  if (mount.inodeMapSegment.has_value()) {
+    msg.files.push_back(std::move(mount.inodeMapSegment.value()));
+    mount.inodeMapSegment.reset();
+  }
+
+  return msg;
+}
+
 IOBuf TakeoverData::serialize(uint64_t protocolCapabilities) {
   XCHECK(protocolCapabilities & TakeoverCapabilities::THRIFT_SERIALIZATION)
       << fmt::format(
@@ -349,8 +537,15 @@ TakeoverData TakeoverData::deserialize(UnixSocket::Message& msg) {
       : shouldSerdeNFSInfo(capabilities) ? 3
                                          : 2;
 
+  // Each mount sends its channel fd, plus an inode map segment fd when one
+  // is attached.
+  size_t mountPointFiles = 0;
+  for (const auto& mount : data.mountPoints) {
+    mountPointFiles += mount.inodeMapSegment.has_value() ? 2 : 1;
+  }
+
   // Add 2 here for the lock file and the thrift socket
-  if (data.mountPoints.size() + mountPointFilesOffset != msg.files.size()) {
+  if (mountPointFiles + mountPointFilesOffset != msg.files.size()) {
     throw_<std::runtime_error>(
         "received ",
         data.mountPoints.size(),
@@ -373,16 +568,19 @@ TakeoverData TakeoverData::deserialize(UnixSocket::Message& msg) {
                  << data.mountdServerSocket->fd();
     }
   }
-  for (size_t n = 0; n < data.mountPoints.size(); ++n) {
-    auto& mountInfo = data.mountPoints[n];
+  size_t fileIndex = mountPointFilesOffset;
+  for (auto& mountInfo : data.mountPoints) {
     if (auto fuseData = std::get_if<FuseChannelData>(&mountInfo.channelInfo)) {
-      fuseData->fd = std::move(msg.files[n + mountPointFilesOffset]);
+      fuseData->fd = std::move(msg.files[fileIndex++]);
     } else if (
         auto nfsData = std::get_if<NfsChannelData>(&mountInfo.channelInfo)) {
-      nfsData->nfsdSocketFd = std::move(msg.files[n + mountPointFilesOffset]);
+      nfsData->nfsdSocketFd = std::move(msg.files[fileIndex++]);
     } else {
       throw std::runtime_error("Unexpected Channel Type");
     }
+    if (mountInfo.inodeMapSegment.has_value()) {
+      mountInfo.inodeMapSegment = std::move(msg.files[fileIndex++]);
+    }
   }
   return data;
 }
@@ -515,40 +713,35 @@ IOBuf TakeoverData::serializeThrift(uint64_t protocolCapabilities) {
 
   serializeHeader(protocolCapabilities, bufQ);
 
-  std::vector<SerializedMountInfo> serializedMounts;
+  // Validate every mount before moving any state into the serialized
+  // structs below, so that a capability mismatch cannot leave this
+  // TakeoverData partially gutted for the recovery path.
   for (const auto& mount : mountPoints) {
-    auto mountProtocol = getMountProtocol(mount);
-
     checkCanSerDeMountType(
-        protocolCapabilities, mountProtocol, mount.mountPath.view());
-
-    SerializedMountInfo serializedMount;
-
-    *serializedMount.mountPath_ref() = mount.mountPath.asString();
-    *serializedMount.stateDirectory_ref() = mount.stateDirectory.asString();
-
-    for (const auto& bindMount : mount.bindMounts) {
-      serializedMount.bindMountPaths_ref()->push_back(bindMount.asString());
-    }
+        protocolCapabilities, getMountProtocol(mount), mount.mountPath.view());
+  }
 
-    if (auto fuseChannelInfo =
-            std::get_if<FuseChannelData>(&mount.channelInfo)) {
-      // Stuffing the fuse connection information in as a binary
-      // blob because we know that the endianness of the target
-      // machine must match the current system for a graceful
-      // takeover, and it saves us from re-encoding an operating
-      // system specific struct into a thrift file.
-      serializedMount.connInfo_ref() = std::string{
-          reinterpret_cast<const char*>(&fuseChannelInfo->connInfo),
-          sizeof(fuseChannelInfo->connInfo)};
+  std::vector<SerializedMountInfo> serializedMounts;
+  serializedMounts.reserve(mountPoints.size());
+  for (auto& mount : mountPoints) {
+    serializedMounts.emplace_back(serializeMountInfo(
+        protocolCapabilities, mount, getMountProtocol(mount)));
+  }
+
+  // If sending the message fails, this TakeoverData is handed back to the
+  // old daemon so it can recover its mounts, and recovery needs the inode
+  // maps that were moved into the serialized structs above. Return them to
+  // their MountInfo once the message bytes have been rendered. Mounts whose
+  // inode map went into a segment were never gutted, so there is nothing to
+  // restore for them.
+  auto restoreInodeMaps = [&](std::vector<SerializedMountInfo>& mounts) {
+    XDCHECK_EQ(mounts.size(), mountPoints.size());
+    for (size_t i = 0; i < mounts.size(); ++i) {
+      if (!*mounts[i].inodeMapSegmentAttached_ref()) {
+        mountPoints[i].inodeMap = std::move(*mounts[i].inodeMap_ref());
+      }
     }
-
-    *serializedMount.inodeMap_ref() = mount.inodeMap;
-
-    serializedMount.mountProtocol_ref() = mountProtocol;
-
-    serializedMounts.emplace_back(std::move(serializedMount));
-  }
+  };
 
   if (protocolCapabilities & TakeoverCapabilities::RESULT_TYPE_SERIALIZATION) {
     // depending on if RESULT_TYPE_SERIALIZATION is set we might use either of
@@ -559,15 +752,19 @@ IOBuf TakeoverData::serializeThrift(uint64_t protocolCapabilities) {
     if (protocolCapabilities & TakeoverCapabilities::ORDERED_FDS) {
       serialized.fileDescriptors_ref() = generalFDOrder;
     }
+    serialized.chunkedMountCount_ref() =
+        static_cast<int32_t>(chunkedMountCount);
     SerializedTakeoverResult result;
-    result.takeoverData_ref() = serialized;
+    result.takeoverData_ref() = std::move(serialized);
 
     CompactSerializer::serialize(result, &bufQ);
+    restoreInodeMaps(*result.takeoverData_ref()->mounts_ref());
   } else {
     SerializedTakeoverData serialized;
     serialized.mounts_ref() = std::move(serializedMounts);
 
     CompactSerializer::serialize(serialized, &bufQ);
+    restoreInodeMaps(*serialized.mounts_ref());
   }
 
   return std::move(*bufQ.move());
@@ -621,6 +818,10 @@ TakeoverData TakeoverData::deserializeThrift(
           takeoverData.generalFDOrder =
               *(serialized.takeoverData_ref()->fileDescriptors_ref());
         }
+        if (protocolCapabilities & TakeoverCapabilities::CHUNKED_MOUNTS) {
+          takeoverData.chunkedMountCount = static_cast<size_t>(
+              *(serialized.takeoverData_ref()->chunkedMountCount_ref()));
+        }
         return takeoverData;
       }
       case SerializedTakeoverResult::Type::__EMPTY__:
@@ -699,6 +900,12 @@ TakeoverData TakeoverData::deserializeThriftMounts(
         throw std::runtime_error(
             "impossible enum variant for TakeoverMountProtocol");
     }
+    if (*serializedMount.inodeMapSegmentAttached_ref()) {
+      // Mark that a segment fd follows this mount's channel fd; the fd
+      // itself is filled in by deserialize() once the message's file
+      // descriptors are mapped.
+      data.mountPoints.back().inodeMapSegment = folly::File{};
+    }
   }
   return data;
 }
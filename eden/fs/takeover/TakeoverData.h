@@ -109,6 +109,31 @@ class TakeoverCapabilities {
     // Indicates that we include the size of the header in the header itself.
     // This will allow us to more safely evolve the header in the future.
     INCLUDE_HEADER_SIZE = 1 << 10,
+
+    // Indicates that an optional memfd segment containing the old daemon's
+    // in-memory blob cache may be transferred, so the new daemon starts with
+    // a warm cache instead of an I/O storm.
+    // Note this capability can not be used without ORDERED_FDS.
+    CACHE_SEGMENT = 1 << 11,
+
+    // Indicates that the takeover data is sent as a sequence of messages:
+    // one initial message carrying the general file descriptors, followed
+    // by one message per mount point carrying that mount's state and
+    // channel fd. This bounds the size of any single message and lets the
+    // new daemon process each mount as soon as its own message lands
+    // instead of waiting for the full transfer.
+    // Note this capability can not be used without ORDERED_FDS and
+    // RESULT_TYPE_SERIALIZATION.
+    CHUNKED_MOUNTS = 1 << 12,
+
+    // Indicates that each mount's unloaded-inode table is transferred as a
+    // memory-backed file descriptor instead of being thrift-encoded into
+    // the takeover message. The new daemon maps the segment and builds its
+    // InodeMap directly from the mapped records, which avoids decoding
+    // millions of thrift entries during the restart-critical path.
+    // Note this capability can not be used without ORDERED_FDS and
+    // RESULT_TYPE_SERIALIZATION.
+    INODE_MAP_SEGMENTS = 1 << 13,
   };
 };
 
@@ -264,6 +289,15 @@ class TakeoverData {
         channelInfo;
 
     SerializedInodeMap inodeMap;
+
+    /**
+     * A memory-backed file holding the flat-serialized inode map, used in
+     * place of the inodeMap field when both sides support
+     * INODE_MAP_SEGMENTS. On the sending side this is populated while
+     * serializing; on the receiving side it is filled in from the
+     * transferred file descriptors.
+     */
+    std::optional<folly::File> inodeMapSegment;
   };
 
   /**
@@ -292,6 +326,19 @@ class TakeoverData {
    */
   void serialize(uint64_t protocolCapabilities, UnixSocket::Message& msg);
 
+  /**
+   * Serialize the TakeoverData as a sequence of unix socket messages: one
+   * initial message carrying the general file descriptors and an empty
+   * mount list whose chunkedMountCount announces what follows, then one
+   * message per mount point carrying that mount's state and channel fd.
+   *
+   * Requires the CHUNKED_MOUNTS capability (and therefore ORDERED_FDS and
+   * RESULT_TYPE_SERIALIZATION). Unlike serialize(), this consumes the
+   * mount state; it must only be called once the transfer is committed.
+   */
+  std::vector<UnixSocket::Message> serializeChunked(
+      uint64_t protocolCapabilities);
+
   /**
    * Serialize an exception.
    */
@@ -346,6 +393,12 @@ class TakeoverData {
    */
   std::optional<folly::File> mountdServerSocket;
 
+  /**
+   * A memfd segment containing the serialized contents of the old daemon's
+   * blob cache. Only transferred when both sides support CACHE_SEGMENT.
+   */
+  std::optional<folly::File> blobCacheSegment;
+
   std::vector<FileDescriptorType> generalFDOrder;
 
   // allows manipulating the result of generateGeneralFdOrder in tests.
@@ -357,6 +410,14 @@ class TakeoverData {
    */
   std::vector<MountInfo> mountPoints;
 
+  /**
+   * When the CHUNKED_MOUNTS capability is in use, the number of per-mount
+   * messages that follow the initial message. Only meaningful on the
+   * receiving side immediately after deserializing the initial message;
+   * zero everywhere else.
+   */
+  size_t chunkedMountCount{0};
+
   /**
    * The takeoverComplete promise will be fulfilled by the TakeoverServer code
    * once the TakeoverData has been sent to the remote process.
@@ -388,6 +449,15 @@ class TakeoverData {
    */
   folly::IOBuf serializeThrift(uint64_t protocolCapabilities);
 
+  /**
+   * Serialize a single mount point into its own message for the chunked
+   * transfer: the serialized mount state plus its channel fd. The mount is
+   * consumed.
+   */
+  static UnixSocket::Message serializeMountChunk(
+      uint64_t protocolCapabilities,
+      MountInfo&& mount);
+
   /**
    * Serialize an exception for any version that uses thrift serialization. This
    * is versions 3+.
@@ -253,11 +253,17 @@ Future<Unit> TakeoverServer::ConnHandler::sendTakeoverData(
   // lock is released so the client can take over.
   server_->getTakeoverHandler()->closeStorage();
 
-  UnixSocket::Message msg;
+  std::vector<UnixSocket::Message> messages;
   try {
-    data.serialize(protocolCapabilities_, msg);
-    for (auto& file : msg.files) {
-      XLOG(DBG7) << "sending fd for takeover: " << file.fd();
+    if (protocolCapabilities_ & TakeoverCapabilities::CHUNKED_MOUNTS) {
+      messages = data.serializeChunked(protocolCapabilities_);
+    } else {
+      data.serialize(protocolCapabilities_, messages.emplace_back());
+    }
+    for (auto& msg : messages) {
+      for (auto& file : msg.files) {
+        XLOG(DBG7) << "sending fd for takeover: " << file.fd();
+      }
     }
   } catch (...) {
     auto ew = folly::exception_wrapper{std::current_exception()};
@@ -266,10 +272,23 @@ Future<Unit> TakeoverServer::ConnHandler::sendTakeoverData(
         TakeoverData::serializeError(protocolCapabilities_, ew));
   }
 
-  XLOG(INFO) << "Sending takeover data to new process: "
-             << msg.data.computeChainDataLength() << " bytes";
+  size_t totalBytes = 0;
+  for (const auto& msg : messages) {
+    totalBytes += msg.data.computeChainDataLength();
+  }
+  XLOG(INFO) << "Sending takeover data to new process: " << totalBytes
+             << " bytes in " << messages.size() << " message(s)";
+
+  auto sendFuture = folly::makeFuture();
+  for (auto& msg : messages) {
+    sendFuture = std::move(sendFuture)
+                     .thenValue([this, msg = std::move(msg)](
+                                    folly::Unit&&) mutable {
+                       return socket_.send(std::move(msg));
+                     });
+  }
 
-  return socket_.send(std::move(msg))
+  return std::move(sendFuture)
       .thenTry([promise = std::move(data.takeoverComplete)](
                    folly::Try<Unit>&& sendResult) mutable {
         if (sendResult.hasException()) {
@@ -66,6 +66,11 @@ struct SerializedMountInfo {
   6: SerializedInodeMap inodeMap;
 
   7: TakeoverMountProtocol mountProtocol = TakeoverMountProtocol.UNKNOWN;
+
+  // When the INODE_MAP_SEGMENTS capability is negotiated the inode map is
+  // transferred as a memory-backed file descriptor following this mount's
+  // channel fd, and the inodeMap field above is left empty.
+  8: bool inodeMapSegmentAttached = false;
 }
 
 // TODO(T110300475): remove after SerializedTakeoverResult becomes stable. Should be
@@ -83,11 +88,18 @@ enum FileDescriptorType {
   LOCK_FILE = 0,
   THRIFT_SOCKET = 1,
   MOUNTD_SOCKET = 2,
+  // A memfd segment holding the old daemon's hot blob cache contents, so the
+  // new daemon can warm its in-memory caches instead of refetching everything.
+  BLOB_CACHE_SEGMENT = 3,
 }
 
 struct SerializedTakeoverInfo {
   1: list<SerializedMountInfo> mounts;
   2: list<FileDescriptorType> fileDescriptors;
+  // When the CHUNKED_MOUNTS capability is negotiated the initial message
+  // carries no mounts; this field holds the number of follow-up messages,
+  // each carrying exactly one mount and that mount's channel fd.
+  3: i32 chunkedMountCount;
 }
 
 // This is the highlevel structure we use to send takeover data between the
@@ -14,6 +14,7 @@
 #include <folly/test/TestUtils.h>
 
 #include <eden/fs/takeover/gen-cpp2/takeover_types.h>
+#include "eden/fs/takeover/InodeMapSegment.h"
 #include "eden/fs/takeover/TakeoverClient.h"
 #include "eden/fs/takeover/TakeoverData.h"
 #include "eden/fs/takeover/TakeoverHandler.h"
@@ -580,6 +581,196 @@ TEST(Takeover, manyMounts) {
   }
 }
 
+TEST(Takeover, chunkedSerializeRoundTrip) {
+  TemporaryDirectory tmpDir("eden_takeover_test");
+  AbsolutePathPiece tmpDirPath{tmpDir.path().string()};
+
+  // Build a TakeoverData object with a few mounts
+  TakeoverData serverData;
+  auto lockFilePath = tmpDirPath + "lock"_pc;
+  serverData.lockFile = folly::File{lockFilePath.view(), O_RDWR | O_CREAT};
+  auto thriftSocketPath = tmpDirPath + "thrift"_pc;
+  serverData.thriftSocket =
+      folly::File{thriftSocketPath.view(), O_RDWR | O_CREAT};
+  auto mountdSocketPath = tmpDirPath + "mountd"_pc;
+  serverData.mountdServerSocket =
+      folly::File{mountdSocketPath.view(), O_RDWR | O_CREAT};
+
+  constexpr size_t numMounts = 3;
+  for (size_t n = 0; n < numMounts; ++n) {
+    auto mountPath =
+        tmpDirPath + RelativePathPiece{folly::to<string>("mounts/test", n)};
+    auto stateDirectory =
+        tmpDirPath + RelativePathPiece{folly::to<string>("client", n)};
+    auto fusePath =
+        tmpDirPath + PathComponentPiece{folly::to<string>("fuse", n)};
+    serverData.mountPoints.emplace_back(
+        mountPath,
+        stateDirectory,
+        std::vector<AbsolutePath>{},
+        FuseChannelData{
+            folly::File{fusePath.view(), O_RDWR | O_CREAT}, fuse_init_out{}},
+        SerializedInodeMap{});
+  }
+
+  // Serializing chunked should produce an initial message announcing the
+  // mount count plus one message per mount, each with its channel fd.
+  auto messages = serverData.serializeChunked(kSupportedCapabilities);
+  ASSERT_EQ(numMounts + 1, messages.size());
+  EXPECT_TRUE(serverData.mountPoints.empty());
+
+  auto clientData = TakeoverData::deserialize(messages[0]);
+  EXPECT_EQ(numMounts, clientData.chunkedMountCount);
+  EXPECT_EQ(0, clientData.mountPoints.size());
+  checkExpectedFile(clientData.lockFile.fd(), lockFilePath);
+  checkExpectedFile(clientData.thriftSocket.fd(), thriftSocketPath);
+  checkExpectedFile(clientData.mountdServerSocket->fd(), mountdSocketPath);
+
+  for (size_t n = 0; n < numMounts; ++n) {
+    auto chunk = TakeoverData::deserialize(messages[n + 1]);
+    ASSERT_EQ(1, chunk.mountPoints.size());
+    const auto& mountInfo = chunk.mountPoints.front();
+
+    auto expectedMountPath =
+        tmpDirPath + RelativePathPiece{folly::to<string>("mounts/test", n)};
+    EXPECT_EQ(expectedMountPath, mountInfo.mountPath);
+
+    auto expectedFusePath =
+        tmpDirPath + PathComponentPiece{folly::to<string>("fuse", n)};
+    auto& fuseChannelData = std::get<FuseChannelData>(mountInfo.channelInfo);
+    checkExpectedFile(fuseChannelData.fd.fd(), expectedFusePath);
+  }
+}
+
+TEST(Takeover, inodeMapSegmentRoundTrip) {
+  TemporaryDirectory tmpDir("eden_takeover_test");
+  AbsolutePathPiece tmpDirPath{tmpDir.path().string()};
+
+  // Build a TakeoverData object with one mount carrying a couple of
+  // unloaded inodes
+  TakeoverData serverData;
+  auto lockFilePath = tmpDirPath + "lock"_pc;
+  serverData.lockFile = folly::File{lockFilePath.view(), O_RDWR | O_CREAT};
+  auto thriftSocketPath = tmpDirPath + "thrift"_pc;
+  serverData.thriftSocket =
+      folly::File{thriftSocketPath.view(), O_RDWR | O_CREAT};
+  auto mountdSocketPath = tmpDirPath + "mountd"_pc;
+  serverData.mountdServerSocket =
+      folly::File{mountdSocketPath.view(), O_RDWR | O_CREAT};
+
+  SerializedInodeMap inodeMap;
+  SerializedInodeMapEntry entry1;
+  entry1.inodeNumber_ref() = 42;
+  entry1.parentInode_ref() = 1;
+  entry1.name_ref() = "foo";
+  entry1.isUnlinked_ref() = false;
+  entry1.numFsReferences_ref() = 2;
+  entry1.hash_ref() = "fakehash";
+  entry1.mode_ref() = 0644;
+  inodeMap.unloadedInodes_ref()->emplace_back(std::move(entry1));
+  SerializedInodeMapEntry entry2;
+  entry2.inodeNumber_ref() = 43;
+  entry2.parentInode_ref() = 42;
+  entry2.name_ref() = "bar";
+  entry2.isUnlinked_ref() = true;
+  entry2.numFsReferences_ref() = 0;
+  // no hash: materialized
+  entry2.mode_ref() = 0755;
+  inodeMap.unloadedInodes_ref()->emplace_back(std::move(entry2));
+
+  auto mountPath = tmpDirPath + "mounts/test"_relpath;
+  auto fusePath = tmpDirPath + "fuse"_pc;
+  serverData.mountPoints.emplace_back(
+      mountPath,
+      tmpDirPath + "client"_relpath,
+      std::vector<AbsolutePath>{},
+      FuseChannelData{
+          folly::File{fusePath.view(), O_RDWR | O_CREAT}, fuse_init_out{}},
+      std::move(inodeMap));
+
+  // Perform the takeover
+  auto serverSendFuture = serverData.takeoverComplete.getFuture();
+  TestHandler handler{std::move(serverData)};
+  auto result = runTakeover(tmpDir, &handler);
+  ASSERT_TRUE(serverSendFuture.hasValue());
+  ASSERT_TRUE(result.hasValue());
+  auto& clientData = result.value();
+
+  // The inode map should have arrived as a memory-backed segment rather
+  // than thrift entries in the message.
+  ASSERT_EQ(1, clientData.mountPoints.size());
+  auto& mountInfo = clientData.mountPoints.front();
+  EXPECT_TRUE(mountInfo.inodeMap.unloadedInodes_ref()->empty());
+  ASSERT_TRUE(mountInfo.inodeMapSegment.has_value());
+
+  // The entry's string fields alias the mapping and are only valid inside
+  // the callback, so check each record as it is visited.
+  size_t index = 0;
+  forEachInodeMapSegmentEntry(
+      mountInfo.inodeMapSegment.value(), [&](const InodeMapSegmentEntry& e) {
+        if (index == 0) {
+          EXPECT_EQ(42, e.inodeNumber);
+          EXPECT_EQ(1, e.parentInode);
+          EXPECT_EQ("foo", e.name);
+          EXPECT_FALSE(e.isUnlinked);
+          EXPECT_EQ(2, e.numFsReferences);
+          ASSERT_TRUE(e.hash.has_value());
+          EXPECT_EQ("fakehash", e.hash.value());
+          EXPECT_EQ(0644, e.mode);
+        } else if (index == 1) {
+          EXPECT_EQ(43, e.inodeNumber);
+          EXPECT_EQ(42, e.parentInode);
+          EXPECT_EQ("bar", e.name);
+          EXPECT_TRUE(e.isUnlinked);
+          EXPECT_EQ(0, e.numFsReferences);
+          EXPECT_FALSE(e.hash.has_value());
+          EXPECT_EQ(0755, e.mode);
+        }
+        ++index;
+      });
+  EXPECT_EQ(2, index);
+}
+
+TEST(Takeover, inodeMapSegmentLargeShardedRender) {
+  // Enough entries to cross the sharded-render threshold inside
+  // serializeInodeMapSegment; the stitched ranges must produce the same
+  // ordered record stream as the single-threaded path.
+  SerializedInodeMap inodeMap;
+  constexpr uint64_t numEntries = 300'000;
+  auto& entries = *inodeMap.unloadedInodes_ref();
+  entries.reserve(numEntries);
+  for (uint64_t i = 0; i < numEntries; ++i) {
+    SerializedInodeMapEntry entry;
+    entry.inodeNumber_ref() = i + 100;
+    entry.parentInode_ref() = i;
+    entry.name_ref() = folly::to<string>("inode", i);
+    entry.isUnlinked_ref() = (i % 7) == 0;
+    entry.numFsReferences_ref() = i % 3;
+    if (i % 2 == 0) {
+      entry.hash_ref() = folly::to<string>("hash", i);
+    }
+    entry.mode_ref() = 0644;
+    entries.emplace_back(std::move(entry));
+  }
+
+  auto segment = serializeInodeMapSegment(inodeMap);
+
+  uint64_t index = 0;
+  forEachInodeMapSegmentEntry(
+      segment, [&](const InodeMapSegmentEntry& entry) {
+        ASSERT_EQ(index + 100, entry.inodeNumber);
+        ASSERT_EQ(folly::to<string>("inode", index), entry.name);
+        if (index % 2 == 0) {
+          ASSERT_TRUE(entry.hash.has_value());
+          ASSERT_EQ(folly::to<string>("hash", index), entry.hash.value());
+        } else {
+          ASSERT_FALSE(entry.hash.has_value());
+        }
+        ++index;
+      });
+  EXPECT_EQ(numEntries, index);
+}
+
 TEST(Takeover, error) {
   TemporaryDirectory tmpDir("eden_takeover_test");
   ErrorHandler handler;
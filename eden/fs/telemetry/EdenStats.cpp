@@ -13,6 +13,38 @@
 
 namespace facebook::eden {
 
+namespace {
+
+/**
+ * Baseline readings of the timestamp counter and the steady clock, captured
+ * at load time. The counter frequency is estimated from the span between the
+ * baseline and the conversion time, so by the time the first sample is
+ * recorded (well after process start) the estimate is accurate to a small
+ * fraction of a percent. On platforms without a cheap hardware counter,
+ * folly::hardware_timestamp falls back to the steady clock and the ratio
+ * simply works out to ticks-per-nanosecond of 1.
+ */
+const uint64_t kBaselineTicks = folly::hardware_timestamp();
+const std::chrono::steady_clock::time_point kBaselineTime =
+    std::chrono::steady_clock::now();
+
+std::chrono::microseconds ticksToMicroseconds(uint64_t ticks) {
+  auto spanTicks = folly::hardware_timestamp() - kBaselineTicks;
+  auto spanUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - kBaselineTime)
+                    .count();
+  if (spanTicks == 0 || spanUs <= 0) {
+    return std::chrono::microseconds{0};
+  }
+  // Floating point avoids overflow: ticks * spanUs can exceed 64 bits once
+  // the process has been up for a while.
+  double ticksPerUs = static_cast<double>(spanTicks) / spanUs;
+  return std::chrono::microseconds{
+      static_cast<uint64_t>(ticks / ticksPerUs)};
+}
+
+} // namespace
+
 void EdenStats::flush() {
   // This method is only really useful while testing to ensure that the service
   // data singleton instance has the latest stats. Since all our stats are now
@@ -61,4 +93,17 @@ DurationScope::~DurationScope() noexcept {
   }
 }
 
+std::atomic<uint32_t> SampledDurationScope::samplingInterval_{0};
+
+SampledDurationScope::~SampledDurationScope() noexcept {
+  if (edenStats_ && updateScope_) {
+    auto elapsedTicks = folly::hardware_timestamp() - startTicks_;
+    try {
+      updateScope_(*edenStats_, ticksToMicroseconds(elapsedTicks));
+    } catch (const std::exception& e) {
+      XLOG(ERR) << "error recording sampled duration: " << e.what();
+    }
+  }
+}
+
 } // namespace facebook::eden
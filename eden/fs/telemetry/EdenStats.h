@@ -7,10 +7,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <utility>
 
 #include <fb303/detail/QuantileStatWrappers.h>
 #include <folly/ThreadLocal.h>
+#include <folly/chrono/Hardware.h>
 #include <folly/stop_watch.h>
 
 #include "eden/fs/eden-config.h"
@@ -25,6 +28,8 @@ struct HgBackingStoreStats;
 struct HgImporterStats;
 struct JournalStats;
 struct ThriftStats;
+struct StageStats;
+struct OverlayStats;
 
 /**
  * StatsGroupBase is a base class for a group of thread-local stats
@@ -117,6 +122,8 @@ class EdenStats {
   ThreadLocal<HgImporterStats> hgImporterStats_;
   ThreadLocal<JournalStats> journalStats_;
   ThreadLocal<ThriftStats> thriftStats_;
+  ThreadLocal<StageStats> stageStats_;
+  ThreadLocal<OverlayStats> overlayStats_;
 };
 
 template <>
@@ -161,6 +168,16 @@ inline ThriftStats& EdenStats::getStatsForCurrentThread<ThriftStats>() {
   return *thriftStats_.get();
 }
 
+template <>
+inline StageStats& EdenStats::getStatsForCurrentThread<StageStats>() {
+  return *stageStats_.get();
+}
+
+template <>
+inline OverlayStats& EdenStats::getStatsForCurrentThread<OverlayStats>() {
+  return *overlayStats_.get();
+}
+
 template <typename T>
 class StatsGroup : public StatsGroupBase {
  public:
@@ -206,8 +223,23 @@ struct FuseStats : StatsGroup<FuseStats> {
   Duration bmap{"fuse.bmap_us"};
   Duration ioctl{"fuse.ioctl_us"};
   Duration poll{"fuse.poll_us"};
-  Duration forgetmulti{"fuse.forgetmulti_us"};
   Duration fallocate{"fuse.fallocate_us"};
+
+  // Counts inode forgets queued to the background forget thread, including
+  // the individual elements of a FUSE_BATCH_FORGET. Comparing this against
+  // fuse.forget_us.count shows the backlog of the forget lane.
+  Counter forgetsQueued{"fuse.forgets_queued"};
+
+  // Negative lookup cache probes (see fuse:negative-lookup-cache). A hit
+  // answers ENOENT without consulting the inode tree; a miss falls through
+  // to the regular lookup path.
+  Counter lookupNegativeCacheHit{"fuse.lookup_negative_cache_hit"};
+  Counter lookupNegativeCacheMiss{"fuse.lookup_negative_cache_miss"};
+
+  // Attribute cache probes (see mount:attribute-cache). A hit answers
+  // getattr from a previously computed stat; a miss consults the inode.
+  Counter getattrCacheHit{"fuse.getattr_cache_hit"};
+  Counter getattrCacheMiss{"fuse.getattr_cache_miss"};
 };
 
 struct NfsStats : StatsGroup<NfsStats> {
@@ -233,6 +265,11 @@ struct NfsStats : StatsGroup<NfsStats> {
   Duration nfsFsinfo{"nfs.fsinfo_us"};
   Duration nfsPathconf{"nfs.pathconf_us"};
   Duration nfsCommit{"nfs.commit_us"};
+
+  // Attribute cache probes (see mount:attribute-cache), mirroring the FUSE
+  // counters of the same name.
+  Counter getattrCacheHit{"nfs.getattr_cache_hit"};
+  Counter getattrCacheMiss{"nfs.getattr_cache_miss"};
 };
 
 struct PrjfsStats : StatsGroup<PrjfsStats> {
@@ -266,8 +303,12 @@ struct ObjectStoreStats : StatsGroup<ObjectStoreStats> {
 
   Counter getBlobFromLocalStore{"object_store.get_blob.local_store"};
   Counter getBlobFromBackingStore{"object_store.get_blob.backing_store"};
+  Counter getBlobFromPeerCache{"object_store.get_blob.peer_cache"};
+  Counter getTreeFromPeerCache{"object_store.get_tree.peer_cache"};
 
   Counter getBlobMetadataFromMemory{"object_store.get_blob_metadata.memory"};
+  Counter getBlobMetadataMissFromNegativeCache{
+      "object_store.get_blob_metadata.negative_cache"};
   Counter getBlobMetadataFromLocalStore{
       "object_store.get_blob_metadata.local_store"};
   Counter getBlobMetadataFromBackingStore{
@@ -291,6 +332,17 @@ struct HgBackingStoreStats : StatsGroup<HgBackingStoreStats> {
   Duration getBlobMetadata{"store.hg.get_blob_metadata_us"};
   Counter loadProxyHash{"store.hg.load_proxy_hash"};
   Counter auxMetadataMiss{"store.hg.aux_metadata_miss"};
+
+  /**
+   * Fetch latency split by where the object was found: "cache" is a hit in
+   * the local hgcache, "remote" covers import queueing plus the network
+   * round trip. The exported counts of these durations give the
+   * remote-fetch ratio by object type.
+   */
+  Duration fetchTreeCache{"store.hg.fetch_tree.cache_us"};
+  Duration fetchTreeRemote{"store.hg.fetch_tree.remote_us"};
+  Duration fetchBlobCache{"store.hg.fetch_blob.cache_us"};
+  Duration fetchBlobRemote{"store.hg.fetch_blob.remote_us"};
 };
 
 /**
@@ -310,9 +362,40 @@ struct JournalStats : StatsGroup<JournalStats> {
   Counter filesAccumulated{"journal.files_accumulated"};
 };
 
+/**
+ * Stats for the overlay I/O scheduler. The wait duration only counts
+ * acquisitions that actually slept, so its count is the number of throttled
+ * I/Os.
+ */
+struct OverlayStats : StatsGroup<OverlayStats> {
+  Duration throttleWait{"overlay.throttle_wait_us"};
+  Counter deadlinePromotions{"overlay.throttle_deadline_promotions"};
+};
+
 struct ThriftStats : StatsGroup<ThriftStats> {
   Duration streamChangesSince{
       "thrift.StreamingEdenService.streamChangesSince.streaming_time_us"};
+
+  Counter globCompiledCacheHit{"thrift.glob.compiled_cache_hit"};
+  Counter globCompiledCacheMiss{"thrift.glob.compiled_cache_miss"};
+  Counter globResultCacheHit{"thrift.glob.result_cache_hit"};
+  Counter globResultCacheMiss{"thrift.glob.result_cache_miss"};
+};
+
+/**
+ * Sampled latency histograms for internal stages of hot request paths,
+ * recorded via SampledDurationScope. The coarse per-endpoint durations above
+ * show that a request was slow; these show which stage it spent its time in
+ * without attaching a profiler.
+ *
+ * Only one in every telemetry:stage-sampling-interval passes through a stage
+ * is timed, so the histograms describe the latency distribution but the
+ * .count statistic undercounts calls by the sampling interval.
+ */
+struct StageStats : StatsGroup<StageStats> {
+  Duration inodeMapLookup{"stage.inode_map_lookup_us"};
+  Duration objectStoreCacheProbe{"stage.object_store_cache_probe_us"};
+  Duration overlayWrite{"stage.overlay_write_us"};
 };
 
 /**
@@ -354,4 +437,76 @@ class DurationScope {
   std::function<void(EdenStats& stats, StopWatch::duration)> updateScope_;
 };
 
+/**
+ * A sampled variant of DurationScope for stages inside hot request paths.
+ *
+ * Construction normally just decrements a thread-local countdown and returns;
+ * one in every N constructions (per thread and stats group) arms the scope,
+ * which then times the stage with the CPU timestamp counter
+ * (folly::hardware_timestamp) and records the elapsed time on destruction.
+ * With sampling disabled or unarmed the cost is a couple of nanoseconds, so
+ * these scopes may sit on paths entered hundreds of thousands of times per
+ * second.
+ *
+ * The sampling interval is process-wide and driven by the
+ * telemetry:stage-sampling-interval config setting; 0 (the default) disables
+ * sampling entirely.
+ *
+ * Unlike DurationScope this holds a raw EdenStats pointer, so the scope must
+ * not outlive the stats object: keep it on the stack around the synchronous
+ * portion of a stage rather than moving it into futures.
+ */
+class SampledDurationScope {
+ public:
+  SampledDurationScope() = delete;
+
+  template <typename T>
+  SampledDurationScope(
+      EdenStats* edenStats,
+      StatsGroupBase::Duration T::*duration) noexcept {
+    static thread_local uint32_t countdown = 0;
+    auto interval = samplingInterval_.load(std::memory_order_relaxed);
+    if (interval == 0) {
+      return;
+    }
+    if (countdown > 0) {
+      --countdown;
+      return;
+    }
+    countdown = interval - 1;
+    startTicks_ = folly::hardware_timestamp();
+    edenStats_ = edenStats;
+    updateScope_ = [duration](EdenStats& stats, std::chrono::microseconds us) {
+      stats.addDuration(duration, us);
+    };
+  }
+
+  ~SampledDurationScope() noexcept;
+
+  SampledDurationScope(SampledDurationScope&& that) noexcept
+      : startTicks_{that.startTicks_},
+        edenStats_{std::exchange(that.edenStats_, nullptr)},
+        updateScope_{std::move(that.updateScope_)} {}
+
+  SampledDurationScope(const SampledDurationScope&) = delete;
+  SampledDurationScope& operator=(const SampledDurationScope&) = delete;
+  SampledDurationScope& operator=(SampledDurationScope&&) = delete;
+
+  /**
+   * Sets the process-wide sampling interval: one in every `interval` passes
+   * through an instrumented stage is timed, and 0 disables sampling.
+   */
+  static void setSamplingInterval(uint32_t interval) noexcept {
+    samplingInterval_.store(interval, std::memory_order_relaxed);
+  }
+
+ private:
+  static std::atomic<uint32_t> samplingInterval_;
+
+  uint64_t startTicks_{0};
+  EdenStats* edenStats_{nullptr};
+  std::function<void(EdenStats& stats, std::chrono::microseconds)>
+      updateScope_;
+};
+
 } // namespace facebook::eden
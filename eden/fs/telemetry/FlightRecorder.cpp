@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/telemetry/FlightRecorder.h"
+
+#include <folly/Exception.h>
+#include <folly/FileUtil.h>
+#include <array>
+
+namespace facebook::eden {
+
+namespace {
+
+// "EFR1" in ASCII.
+constexpr uint32_t kFlightRecorderMagic = 0x45465231;
+constexpr uint32_t kFlightRecorderVersion = 1;
+
+} // namespace
+
+FlightRecorder::FlightRecorder(uint32_t maxEvents) : maxEvents_{maxEvents} {}
+
+void FlightRecorder::record(FlightRecorderEntry entry) noexcept {
+  auto state = state_.lock();
+  if (state->entries.size() < maxEvents_) {
+    state->entries.push_back(entry);
+  } else {
+    state->entries[state->head] = entry;
+    state->head = (state->head + 1) % maxEvents_;
+  }
+}
+
+uint64_t FlightRecorder::dump(folly::File& file, std::chrono::nanoseconds window)
+    const {
+  uint64_t cutoffNs = 0;
+  if (window.count() > 0) {
+    auto nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count();
+    if (nowNs > window.count()) {
+      cutoffNs = static_cast<uint64_t>(nowNs - window.count());
+    }
+  }
+
+  // Copy the ring under the spinlock, oldest first, so publishers are not
+  // blocked on file I/O.
+  std::vector<FlightRecorderEntry> snapshot;
+  {
+    auto state = state_.lock();
+    const size_t size = state->entries.size();
+    snapshot.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      const auto& entry = state->entries[(state->head + i) % size];
+      if (entry.monotonicNs >= cutoffNs) {
+        snapshot.push_back(entry);
+      }
+    }
+  }
+
+  const std::array<uint32_t, 4> header = {
+      kFlightRecorderMagic,
+      kFlightRecorderVersion,
+      static_cast<uint32_t>(snapshot.size()),
+      0,
+  };
+  if (folly::writeFull(file.fd(), header.data(), sizeof(header)) !=
+      sizeof(header)) {
+    folly::throwSystemError("short write of flight recorder header");
+  }
+  const size_t bytes = snapshot.size() * sizeof(FlightRecorderEntry);
+  if (folly::writeFull(file.fd(), snapshot.data(), bytes) !=
+      static_cast<ssize_t>(bytes)) {
+    folly::throwSystemError("short write of flight recorder entries");
+  }
+  return snapshot.size();
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <folly/File.h>
+#include <folly/SpinLock.h>
+#include <folly/Synchronized.h>
+
+namespace facebook::eden {
+
+/**
+ * Identifies which subsystem recorded a FlightRecorderEntry.
+ */
+enum class FlightRecorderSubsystem : uint8_t {
+  FUSE = 1,
+  NFS = 2,
+  PRJFS = 3,
+  INODE = 4,
+};
+
+/**
+ * A compact, fixed-size record of one trace event. The meaning of the
+ * event-specific fields depends on the subsystem:
+ *
+ *   id:    FUSE request unique / NFS xid / PrjFS commandId / inode number
+ *   code:  FUSE opcode / NFS procedure number / PrjFS call type / inode
+ *          event type
+ *   phase: request phase (0 = start, 1 = finish) or, for inode events, the
+ *          InodeEventProgress value
+ *   pid:   requesting process, when the subsystem knows it, otherwise 0
+ */
+struct FlightRecorderEntry {
+  uint64_t monotonicNs;
+  uint64_t id;
+  uint32_t pid;
+  uint16_t code;
+  uint8_t phase;
+  FlightRecorderSubsystem subsystem;
+};
+
+// The ring holds tens of thousands of these; keep them compact.
+static_assert(sizeof(FlightRecorderEntry) == 24);
+
+/**
+ * FlightRecorder keeps a fixed-size in-memory ring of compact trace records
+ * across all of a mount's trace buses, so a cross-subsystem snapshot of
+ * recent activity can be captured after the fact - for example when a
+ * latency SLO trips - without continuous collection overhead. Recording an
+ * entry is a spinlocked 24-byte copy, cheap enough to stay subscribed to the
+ * trace buses at all times; once the ring is full the oldest entries are
+ * overwritten.
+ *
+ * dump() writes the ring to a file in a simple binary format: a 16-byte
+ * header of four uint32 values - the magic number "EFR1" (0x45465231),
+ * a format version, the entry count, and a reserved zero - followed by the
+ * raw FlightRecorderEntry records, oldest first. All values are in native
+ * endianness: dumps are intended to be analyzed off the host that produced
+ * them, but not across architectures.
+ */
+class FlightRecorder {
+ public:
+  explicit FlightRecorder(uint32_t maxEvents);
+
+  FlightRecorder(const FlightRecorder&) = delete;
+  FlightRecorder(FlightRecorder&&) = delete;
+  FlightRecorder& operator=(const FlightRecorder&) = delete;
+  FlightRecorder& operator=(FlightRecorder&&) = delete;
+
+  /**
+   * Adds an entry to the ring, overwriting the oldest entry if the ring is
+   * full.
+   */
+  void record(FlightRecorderEntry entry) noexcept;
+
+  /**
+   * Writes the entries recorded during the last `window` to `file` in the
+   * format described above, oldest first. A zero window dumps the entire
+   * ring. Returns the number of entries written.
+   *
+   * Throws std::system_error if writing fails.
+   */
+  uint64_t dump(folly::File& file, std::chrono::nanoseconds window) const;
+
+ private:
+  struct State {
+    // Grows up to maxEvents_; once full, `head` indexes the oldest entry
+    // and records overwrite it.
+    std::vector<FlightRecorderEntry> entries;
+    size_t head = 0;
+  };
+
+  const uint32_t maxEvents_;
+  folly::Synchronized<State, folly::SpinLock> state_;
+};
+
+} // namespace facebook::eden
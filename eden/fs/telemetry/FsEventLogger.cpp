@@ -7,6 +7,9 @@
 
 #include "eden/fs/telemetry/FsEventLogger.h"
 
+#include <algorithm>
+#include <limits>
+
 #include <folly/Random.h>
 
 #include "eden/fs/config/EdenConfig.h"
@@ -49,24 +52,63 @@ FsEventLogger::FsEventLogger(
       logger_{std::move(logger)},
       counterStartTime_{std::chrono::steady_clock::now()},
       configsString_{getConfigsString(edenConfig_->getEdenConfig())},
-      configsStringUpdateTime_{std::chrono::steady_clock::now()} {}
+      configsStringUpdateTime_{std::chrono::steady_clock::now()} {
+  tuneSamplingThresholds();
+}
+
+void FsEventLogger::tuneSamplingThresholds() {
+  auto config = edenConfig_->getEdenConfig(ConfigReloadBehavior::NoReload);
+  const auto& denominators =
+      config->requestSamplingGroupDenominators.getValue();
+  const auto samplesPerMinute = config->requestSamplesPerMinute.getValue();
+  samplesPerMinute_.store(samplesPerMinute, std::memory_order_relaxed);
+
+  for (size_t i = 0; i < kSamplingGroupCount; ++i) {
+    const auto observed = eventCounts_[i].exchange(0, std::memory_order_relaxed);
+    // Groups beyond the configured vector drop everything, matching the
+    // documented look-up failure behavior.
+    uint64_t effective = i < denominators.size() ? denominators[i] : 0;
+    if (effective != 0 && samplesPerMinute != 0) {
+      // Scale the denominator up whenever the previous window's event rate
+      // would have produced more samples than the per-minute budget, so the
+      // expected sample rate tracks the budget instead of the load. The
+      // value is recomputed from the configured denominator each window, so
+      // it also relaxes back down when the event rate drops.
+      const auto wouldSample = observed / effective;
+      if (wouldSample > samplesPerMinute) {
+        effective = std::max<uint64_t>(
+            effective, (observed + samplesPerMinute - 1) / samplesPerMinute);
+      }
+    }
+    effectiveDenominators_[i].store(
+        static_cast<uint32_t>(std::min<uint64_t>(
+            effective, std::numeric_limits<uint32_t>::max())),
+        std::memory_order_relaxed);
+  }
+}
 
 void FsEventLogger::log(Event event) {
   if (event.samplingGroup == SamplingGroup::DropAll) {
     return;
   }
 
-  auto config = edenConfig_->getEdenConfig(ConfigReloadBehavior::NoReload);
-
-  const auto& denominators =
-      config->requestSamplingGroupDenominators.getValue();
   auto samplingGroup = folly::to_underlying(event.samplingGroup);
-  if (samplingGroup > denominators.size()) {
+  if (samplingGroup >= kSamplingGroupCount) {
     // sampling group does not exist
     return;
   }
-  if (auto sampleDenominator = denominators.at(samplingGroup);
-      sampleDenominator && 0 != folly::Random::rand32(sampleDenominator)) {
+
+  // Count every event, sampled or not: the window roll below needs the true
+  // event rate to tune the denominators.
+  eventCounts_[samplingGroup].fetch_add(1, std::memory_order_relaxed);
+
+  auto sampleDenominator =
+      effectiveDenominators_[samplingGroup].load(std::memory_order_relaxed);
+  if (sampleDenominator == 0) {
+    // group is dropped entirely
+    return;
+  }
+  if (0 != folly::Random::rand32(sampleDenominator)) {
     // failed sampling
     return;
   }
@@ -76,11 +118,12 @@ void FsEventLogger::log(Event event) {
   // given the sampling above.
   auto now = std::chrono::steady_clock::now();
   if ((now - counterStartTime_.load()) > std::chrono::minutes(1)) {
-    // reset counter for this minute
+    // reset counter for this minute and retune the thresholds; this is the
+    // only place the config snapshot is consulted on the logging path.
     counterStartTime_.store(now);
+    tuneSamplingThresholds();
     samplesCount_.store(1);
-  } else if (
-      samplesCount_.load() < config->requestSamplesPerMinute.getValue()) {
+  } else if (samplesCount_.load() < samplesPerMinute_.load(std::memory_order_relaxed)) {
     // not throttled so bump counter
     samplesCount_.fetch_add(1, std::memory_order_relaxed);
   } else {
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <vector>
@@ -45,12 +46,46 @@ class FsEventLogger {
   void log(Event event);
 
  private:
+  /**
+   * Number of sampling groups, including DropAll.
+   */
+  static constexpr size_t kSamplingGroupCount = 6;
+
+  /**
+   * Re-reads the sampling config and retunes the per-group denominators
+   * from the event rates observed in the window that just ended. Called
+   * once per sampling window, so log() itself never touches the config
+   * snapshot.
+   */
+  void tuneSamplingThresholds();
+
   std::shared_ptr<ReloadableConfig> edenConfig_;
   std::shared_ptr<IHiveLogger> logger_;
 
   std::atomic<uint32_t> samplesCount_{0};
   std::atomic<std::chrono::steady_clock::time_point> counterStartTime_;
 
+  /**
+   * Per-minute sample budget, cached from requestSamplesPerMinute when the
+   * window rolls.
+   */
+  std::atomic<uint32_t> samplesPerMinute_{0};
+
+  /**
+   * Events observed per sampling group in the current window, counted
+   * before any sampling so the window roll can see the true event rate.
+   */
+  std::array<std::atomic<uint64_t>, kSamplingGroupCount> eventCounts_{};
+
+  /**
+   * The denominator actually applied to each group: the configured value,
+   * scaled up whenever the previous window's event rate would have
+   * produced more samples than the per-minute budget. 0 drops the group
+   * entirely, matching the config semantics.
+   */
+  std::array<std::atomic<uint32_t>, kSamplingGroupCount>
+      effectiveDenominators_{};
+
   folly::Synchronized<std::string> configsString_;
   std::atomic<std::chrono::steady_clock::time_point> configsStringUpdateTime_;
 };
@@ -8,6 +8,7 @@
 #include "RequestMetricsScope.h"
 
 #include <algorithm>
+#include <atomic>
 #include <numeric>
 
 #include <folly/String.h>
@@ -17,16 +18,63 @@
 
 namespace facebook::eden {
 
+namespace {
+
+/**
+ * Pin each thread to a shard. A round-robin assignment spreads the FUSE
+ * worker threads evenly without hashing thread ids, and a pinned thread
+ * takes the same uncontended lock for every request it starts.
+ */
+size_t currentThreadShard(size_t numShards) {
+  static std::atomic<size_t> nextShard{0};
+  static thread_local size_t myShard =
+      nextShard.fetch_add(1, std::memory_order_relaxed);
+  return myShard % numShards;
+}
+
+} // namespace
+
+RequestMetricsScope::LockedRequestWatchList::Handle
+RequestMetricsScope::LockedRequestWatchList::insert() {
+  auto shard = currentThreadShard(kNumShards);
+  folly::stop_watch<> watch;
+  auto watches = shards_[shard].watches.wlock();
+  return Handle{shard, watches->insert(watches->end(), watch)};
+}
+
+void RequestMetricsScope::LockedRequestWatchList::erase(Handle handle) {
+  auto watches = shards_[handle.shard].watches.wlock();
+  watches->erase(handle.iterator);
+}
+
+size_t RequestMetricsScope::LockedRequestWatchList::count() const {
+  size_t count = 0;
+  for (auto& shard : shards_) {
+    count += shard.watches.rlock()->size();
+  }
+  return count;
+}
+
+RequestMetricsScope::DefaultRequestDuration
+RequestMetricsScope::LockedRequestWatchList::maxDuration() const {
+  DefaultRequestDuration max{0};
+  for (auto& shard : shards_) {
+    auto watches = shard.watches.rlock();
+    if (!watches->empty()) {
+      // By virtue of enqueing new watches at the end of the list, the front
+      // is the watch that has been in this shard the longest.
+      max = std::max(max, watches->front().elapsed());
+    }
+  }
+  return max;
+}
+
 RequestMetricsScope::RequestMetricsScope() : pendingRequestWatches_{nullptr} {}
 
 RequestMetricsScope::RequestMetricsScope(
     LockedRequestWatchList* pendingRequestWatches)
     : pendingRequestWatches_{pendingRequestWatches} {
-  folly::stop_watch<> watch;
-  {
-    auto startTimes = pendingRequestWatches_->wlock();
-    requestWatch_ = startTimes->insert(startTimes->end(), watch);
-  }
+  requestWatch_ = pendingRequestWatches_->insert();
 }
 
 RequestMetricsScope::RequestMetricsScope(RequestMetricsScope&& that) noexcept
@@ -44,15 +92,13 @@ RequestMetricsScope& RequestMetricsScope::operator=(
 
 RequestMetricsScope::~RequestMetricsScope() {
   if (pendingRequestWatches_) {
-    auto startTimes = pendingRequestWatches_->wlock();
-    startTimes->erase(requestWatch_);
+    pendingRequestWatches_->erase(requestWatch_);
   }
 }
 
 void RequestMetricsScope::reset() {
   if (pendingRequestWatches_) {
-    auto startTimes = pendingRequestWatches_->wlock();
-    startTimes->erase(requestWatch_);
+    pendingRequestWatches_->erase(requestWatch_);
     pendingRequestWatches_ = nullptr;
   }
 }
@@ -108,7 +154,7 @@ size_t RequestMetricsScope::getMetricFromWatches(
     const LockedRequestWatchList& watches) {
   switch (metric) {
     case COUNT:
-      return watches.rlock()->size();
+      return watches.count();
     case MAX_DURATION_US:
       return static_cast<size_t>(
           std::chrono::duration_cast<std::chrono::microseconds>(
@@ -120,17 +166,7 @@ size_t RequestMetricsScope::getMetricFromWatches(
 
 RequestMetricsScope::DefaultRequestDuration RequestMetricsScope::getMaxDuration(
     const LockedRequestWatchList& watches) {
-  {
-    auto lockedWatches = watches.rlock();
-    if (lockedWatches->empty()) {
-      return RequestMetricsScope::DefaultRequestDuration{0};
-    }
-
-    // By virtue of enqueing new watches at the end of the list, the front will
-    // always be the watch that has been in the list the longest, ie: the one
-    // with the max duration.
-    return lockedWatches->front().elapsed();
-  }
+  return watches.maxDuration();
 }
 
 } // namespace facebook::eden
@@ -7,12 +7,14 @@
 
 #pragma once
 
+#include <array>
 #include <list>
 #include <memory>
 #include <string>
 
 #include <folly/String.h>
 #include <folly/Synchronized.h>
+#include <folly/lang/Align.h>
 #include <folly/stop_watch.h>
 
 namespace facebook::eden {
@@ -28,10 +30,54 @@ namespace facebook::eden {
 class RequestMetricsScope {
  public:
   using RequestWatchList = std::list<folly::stop_watch<>>;
-  using LockedRequestWatchList = folly::Synchronized<RequestWatchList>;
   using DefaultRequestDuration =
       std::chrono::steady_clock::steady_clock::duration;
 
+  /**
+   * A sharded set of in-flight request watches.
+   *
+   * This used to be a single folly::Synchronized list per channel, which
+   * made every request start and finish serialize on one lock; with tens of
+   * thousands of outstanding requests during fetch storms that lock was
+   * visible in contention traces. Watches are instead spread over a fixed
+   * set of independently locked shards, with each thread pinned to one
+   * shard so arm/disarm stays O(1) and uncontended in the common case.
+   *
+   * Within a shard new watches are appended at the tail, so the head of
+   * each shard's list is its longest-running request and the aggregate
+   * maximum is the max over the shard heads.
+   */
+  class LockedRequestWatchList {
+   public:
+    struct Handle {
+      size_t shard;
+      RequestWatchList::iterator iterator;
+    };
+
+    /** Start tracking a request; O(1), locks only the calling
+     * thread's shard. */
+    Handle insert();
+
+    /** Stop tracking a request; O(1), locks only the handle's shard. */
+    void erase(Handle handle);
+
+    /** Number of requests currently tracked. */
+    size_t count() const;
+
+    /** Elapsed time of the longest-running tracked request. */
+    DefaultRequestDuration maxDuration() const;
+
+   private:
+    static constexpr size_t kNumShards = 16;
+
+    struct Shard {
+      alignas(folly::hardware_destructive_interference_size)
+          folly::Synchronized<RequestWatchList> watches;
+    };
+
+    std::array<Shard, kNumShards> shards_;
+  };
+
   RequestMetricsScope();
   explicit RequestMetricsScope(LockedRequestWatchList* pendingRequestWatches);
   RequestMetricsScope(const RequestMetricsScope&) = delete;
@@ -107,6 +153,6 @@ class RequestMetricsScope {
 
  private:
   LockedRequestWatchList* pendingRequestWatches_;
-  RequestWatchList::iterator requestWatch_;
+  LockedRequestWatchList::Handle requestWatch_;
 }; // namespace eden
 } // namespace facebook::eden
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/telemetry/RequestProbes.h"
+
+namespace facebook::eden {
+
+RequestAnnotation& currentRequestAnnotation() {
+  thread_local RequestAnnotation annotation;
+  thread_local bool published = [] {
+    // Hand the area's address to any attached eBPF program exactly once
+    // per thread so it can read the fields at CPU-sample time.
+    EDEN_SDT(request_annotation, &annotation);
+    return true;
+  }();
+  (void)published;
+  return annotation;
+}
+
+} // namespace facebook::eden
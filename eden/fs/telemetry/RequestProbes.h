@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <folly/tracing/StaticTracepoint.h>
+
+/**
+ * USDT probes for attributing CPU samples to request types and causes.
+ *
+ * Hot-path code fires statically-defined tracepoints (USDT) through this
+ * macro so that perf and eBPF tools can hook them without any rebuild:
+ *
+ *   bpftrace -e 'usdt:/usr/local/bin/edenfs:edenfs:fuse_request_start
+ *       { @[arg1] = count(); }'
+ *
+ * All probes live in the "edenfs" provider. They compile to a single nop
+ * when not attached, and to nothing at all on platforms where folly lacks
+ * SDT support, so they are safe on every hot path.
+ */
+#define EDEN_SDT(name, ...) FOLLY_SDT(edenfs, name, ##__VA_ARGS__)
+
+namespace facebook::eden {
+
+/**
+ * A per-thread annotation area describing the request the thread is
+ * currently working on, for profilers that sample CPU rather than hooking
+ * probes.
+ *
+ * The edenfs:request_annotation probe fires once per thread with the
+ * address of this thread's area, so an eBPF program can remember the
+ * task-to-address mapping and then read the fields directly at CPU-sample
+ * time. The fields are plain integers written without synchronization;
+ * sampling may observe a torn update across fields, which is acceptable
+ * for profiling.
+ */
+struct RequestAnnotation {
+  /** Unique id of the in-flight request, or 0 when the thread is idle. */
+  uint64_t requestId = 0;
+  /**
+   * What kind of request this is. For FUSE dispatch this is the FUSE
+   * opcode; other probe sites pass their own probe-documented encoding.
+   */
+  uint32_t requestType = 0;
+  /** An ObjectFetchContext::Cause value, or 0 when unknown. */
+  uint32_t cause = 0;
+};
+
+/**
+ * Returns this thread's annotation area, publishing its address through the
+ * edenfs:request_annotation probe on first use.
+ */
+RequestAnnotation& currentRequestAnnotation();
+
+/**
+ * RAII scope that fills in the calling thread's RequestAnnotation and
+ * restores the previous contents on destruction, so nested scopes (e.g. an
+ * object fetch performed while dispatching a FUSE request) attribute their
+ * samples to the innermost request.
+ */
+class RequestAnnotationScope {
+ public:
+  RequestAnnotationScope(uint64_t requestId, uint32_t requestType, uint32_t cause)
+      : annotation_{currentRequestAnnotation()}, saved_{annotation_} {
+    annotation_.requestId = requestId;
+    annotation_.requestType = requestType;
+    annotation_.cause = cause;
+  }
+
+  ~RequestAnnotationScope() {
+    annotation_ = saved_;
+  }
+
+  RequestAnnotationScope(const RequestAnnotationScope&) = delete;
+  RequestAnnotationScope& operator=(const RequestAnnotationScope&) = delete;
+
+ private:
+  RequestAnnotation& annotation_;
+  RequestAnnotation saved_;
+};
+
+} // namespace facebook::eden
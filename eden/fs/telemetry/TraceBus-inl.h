@@ -7,6 +7,8 @@
 
 #include <folly/logging/xlog.h>
 #include <folly/system/ThreadName.h>
+#include <algorithm>
+#include <limits>
 
 namespace facebook::eden {
 
@@ -18,20 +20,37 @@ std::shared_ptr<TraceBus<TraceEvent>> TraceBus<TraceEvent>::create(
       PrivateConstructorTag{}, std::move(name), bufferCapacity);
 }
 
+template <typename TraceEvent>
+std::shared_ptr<TraceBus<TraceEvent>> TraceBus<TraceEvent>::createLossy(
+    std::string name,
+    size_t bufferCapacity) {
+  return std::make_shared<TraceBus<TraceEvent>>(
+      PrivateConstructorTag{},
+      std::move(name),
+      bufferCapacity,
+      /*lossy=*/true);
+}
+
 template <typename TraceEvent>
 TraceBus<TraceEvent>::TraceBus(
     PrivateConstructorTag,
     std::string name,
-    size_t bufferCapacity)
-    : name_{std::move(name)}, bufferCapacity_{bufferCapacity} {
+    size_t bufferCapacity,
+    bool lossy)
+    : name_{std::move(name)},
+      bufferCapacity_{bufferCapacity},
+      lossy_{lossy},
+      rings_{[this] { return new LossyRing(&droppedEvents_); }} {
   XCHECK_GT(bufferCapacity_, 0u) << "Buffer capacity must not be zero";
 
-  state_.unsafeGetUnlocked().writeBuffer.reserve(bufferCapacity_);
-
-  // Allocate the backbuffer here rather than in the thread so std::bad_alloc
-  // can be caught.
+  // Allocate the buffers here rather than in the thread so std::bad_alloc
+  // can be caught. The lossy mode's per-thread rings are instead allocated
+  // lazily by each publishing thread.
   std::vector<TraceEvent> readBuffer;
-  readBuffer.reserve(bufferCapacity);
+  if (!lossy_) {
+    state_.unsafeGetUnlocked().writeBuffer.reserve(bufferCapacity_);
+    readBuffer.reserve(bufferCapacity);
+  }
 
   std::string threadName = "tracebus-" + name_;
 
@@ -39,7 +58,11 @@ TraceBus<TraceEvent>::TraceBus(
                          threadName = std::move(threadName),
                          readBuffer = std::move(readBuffer)]() mutable {
     folly::setThreadName(threadName);
-    threadLoop(readBuffer);
+    if (lossy_) {
+      threadLoopLossy(readBuffer);
+    } else {
+      threadLoop(readBuffer);
+    }
   }};
 }
 
@@ -68,6 +91,11 @@ template <typename TraceEvent>
 void TraceBus<TraceEvent>::publish(TraceEvent&& event) noexcept {
   static_assert(std::is_nothrow_move_constructible_v<TraceEvent>);
 
+  if (lossy_) {
+    publishLossy(std::move(event));
+    return;
+  }
+
   bool wake;
   {
     auto state = state_.lock();
@@ -90,6 +118,27 @@ void TraceBus<TraceEvent>::publish(TraceEvent&& event) noexcept {
   }
 }
 
+template <typename TraceEvent>
+void TraceBus<TraceEvent>::publishLossy(TraceEvent&& event) noexcept {
+  static_assert(std::is_nothrow_move_assignable_v<TraceEvent>);
+
+  auto& ring = *rings_;
+  std::lock_guard<std::mutex> guard{ring.mutex};
+  // The stamp is taken while the ring lock is held so that every event with
+  // a sequence number below a value observed by the draining thread is
+  // either already in its ring or behind a lock the drain will wait on.
+  auto sequence = publishSequence_.fetch_add(1, std::memory_order_acq_rel);
+  if (ring.slots.size() < bufferCapacity_) {
+    ring.slots.push_back(StampedEvent{sequence, std::move(event)});
+  } else {
+    // The ring is full: overwrite the oldest event so recent history is
+    // retained, and count the drop.
+    ring.slots[ring.head] = StampedEvent{sequence, std::move(event)};
+    ring.head = (ring.head + 1) % bufferCapacity_;
+    ++ring.dropped;
+  }
+}
+
 template <typename TraceEvent>
 TraceSubscriptionHandle<TraceEvent> TraceBus<TraceEvent>::subscribe(
     std::shared_ptr<Subscriber> subscriber) {
@@ -134,6 +183,47 @@ void TraceBus<TraceEvent>::logFullOnce() noexcept {
   });
 }
 
+template <typename TraceEvent>
+void TraceBus<TraceEvent>::logDroppedOnce() noexcept {
+  folly::call_once(logIfDroppedFlag_, [&]() noexcept {
+    try {
+      XLOG(WARN) << "TraceBus(" << name_
+                 << ") is dropping events; a publisher is outrunning the "
+                 << "drain. Is capacity " << bufferCapacity_ << " sufficient?";
+    } catch (std::exception&) {
+      // Nothing reasonable to do.
+    }
+  });
+}
+
+template <typename TraceEvent>
+void TraceBus<TraceEvent>::reapUnsubscribed(
+    State& state,
+    uint64_t lastObservedSequenceNumber) noexcept {
+  // While the lock is held, delete all unsubscribed subscriptions.
+  // plink is pointer to current node pointer.
+  // nlink is pointer to next node pointer.
+  // p is pointer to current node.
+  Subscription** plink = &state.subscriptions;
+  Subscription* p = *plink;
+  while (p) {
+    Subscription** nlink = &p->next;
+    Subscription* next = *nlink;
+    if (p->unsubscribe && p->unsubscribe <= lastObservedSequenceNumber) {
+      // Here, we know this subscription has seen events up to (and possibly
+      // beyond) its unsubscription request, so unlink it.
+      *plink = *nlink;
+      delete p;
+    } else {
+      // Otherwise, if the subscription has requested unsubscription, then
+      // it needs to make one more iteration through the loop and will be
+      // deleted after.
+      plink = nlink;
+    }
+    p = next;
+  }
+}
+
 template <typename TraceEvent>
 void TraceBus<TraceEvent>::threadLoop(
     std::vector<TraceEvent>& readBuffer) noexcept {
@@ -150,28 +240,7 @@ void TraceBus<TraceEvent>::threadLoop(
       auto state = state_.lock();
 
       // Deallocate before we wait.
-      // While the lock is held, delete all unsubscribed subscriptions.
-      // plink is pointer to current node pointer.
-      // nlink is pointer to next node pointer.
-      // p is pointer to current node.
-      Subscription** plink = &state->subscriptions;
-      Subscription* p = *plink;
-      while (p) {
-        Subscription** nlink = &p->next;
-        Subscription* next = *nlink;
-        if (p->unsubscribe && p->unsubscribe <= lastObservedSequenceNumber) {
-          // Here, we know this subscription has seen events up to (and possibly
-          // beyond) its unsubscription request, so unlink it.
-          *plink = *nlink;
-          delete p;
-        } else {
-          // Otherwise, if the subscription has requested unsubscription, then
-          // it needs to make one more iteration through the loop and will be
-          // deleted after.
-          plink = nlink;
-        }
-        p = next;
-      }
+      reapUnsubscribed(*state, lastObservedSequenceNumber);
 
       // TODO: If it were safe to access Subscription::unsubscribe when the lock
       // weren't held, it would be possible to check the unsubscribe sequence
@@ -217,4 +286,104 @@ void TraceBus<TraceEvent>::threadLoop(
   }
 }
 
+template <typename TraceEvent>
+void TraceBus<TraceEvent>::threadLoopLossy(
+    std::vector<TraceEvent>& readBuffer) noexcept {
+  // Unlike threadLoop, this loop may allocate: the batch size is bounded by
+  // the number of publishing threads rather than bufferCapacity_.
+
+  // Events drained from the rings but published at or after the current
+  // barrier. They are held until the next pass so an event cannot be
+  // observed before an earlier event that was still being published on
+  // another thread.
+  std::vector<StampedEvent> pending;
+  std::vector<StampedEvent> batch;
+
+  bool done = false;
+  uint64_t lastObservedSequenceNumber = 0;
+  while (true) {
+    Subscription* head;
+    {
+      auto state = state_.lock();
+      reapUnsubscribed(*state, lastObservedSequenceNumber);
+      // Lossy publishes do not bump the sequence number, so advance it once
+      // per drain pass instead; an unsubscribed subscription is then
+      // reclaimed on the following pass, mirroring threadLoop.
+      state->sequenceNumber++;
+      lastObservedSequenceNumber = state->sequenceNumber;
+      if (!done) {
+        emptyCV_.wait_for(
+            state.as_lock(), kLossyPollInterval, [&] { return state->done; });
+      }
+      done = state->done;
+      head = state->subscriptions;
+    }
+
+    // On the final pass everything must be flushed; otherwise only deliver
+    // events stamped before the barrier. Any event below the barrier is
+    // either already in its ring or behind a ring lock we are about to
+    // acquire, so the merged batch is complete up to the barrier.
+    uint64_t barrier = done ? std::numeric_limits<uint64_t>::max()
+                            : publishSequence_.load(std::memory_order_acquire);
+
+    {
+      auto accessor = rings_.accessAllThreads();
+      for (auto& ring : accessor) {
+        std::lock_guard<std::mutex> guard{ring.mutex};
+        const size_t size = ring.slots.size();
+        for (size_t i = 0; i < size; ++i) {
+          pending.push_back(std::move(ring.slots[(ring.head + i) % size]));
+        }
+        ring.slots.clear();
+        ring.head = 0;
+        if (ring.dropped) {
+          droppedEvents_.fetch_add(ring.dropped, std::memory_order_relaxed);
+          ring.dropped = 0;
+          logDroppedOnce();
+        }
+      }
+    }
+
+    batch.clear();
+    auto mid = std::partition(
+        pending.begin(), pending.end(), [&](const StampedEvent& e) {
+          return e.sequence < barrier;
+        });
+    for (auto it = pending.begin(); it != mid; ++it) {
+      batch.push_back(std::move(*it));
+    }
+    pending.erase(pending.begin(), mid);
+    std::sort(
+        batch.begin(), batch.end(), [](const auto& a, const auto& b) {
+          return a.sequence < b.sequence;
+        });
+
+    readBuffer.clear();
+    readBuffer.reserve(batch.size());
+    for (auto& stamped : batch) {
+      readBuffer.push_back(std::move(stamped.event));
+    }
+
+    for (auto* sub = head; sub; sub = sub->next) {
+      if (sub->hasThrownException) {
+        continue;
+      }
+      const TraceEvent* begin = readBuffer.data();
+      const TraceEvent* end = begin + readBuffer.size();
+      try {
+        sub->subscriber->observeBatch(begin, end);
+      } catch (const std::exception& e) {
+        sub->hasThrownException = true;
+        XLOG(ERR) << "Subscription: " << sub->subscriber->name() << " threw "
+                  << e.what() << ", unsubscribing.";
+      }
+    }
+
+    readBuffer.clear();
+    if (done) {
+      return;
+    }
+  }
+}
+
 } // namespace facebook::eden
@@ -8,12 +8,16 @@
 #pragma once
 
 #include <folly/Synchronized.h>
+#include <folly/ThreadLocal.h>
 #include <folly/synchronization/CallOnce.h>
 #include <stdint.h>
+#include <atomic>
 #include <chrono>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <utility>
+#include <vector>
 
 namespace facebook::eden {
 
@@ -156,6 +160,13 @@ class TraceSubscriptionHandle {
  *
  * Ideally, capacity would be dynamically determined with algorithms similar to
  * network protocols, but a small fixed-size buffer should be sufficient.
+ *
+ * For high-frequency publishers where blocking is unacceptable, `createLossy`
+ * builds a bus whose publish path appends to a per-thread ring buffer instead
+ * of taking a shared lock. The background thread drains the rings in batches.
+ * If a producer outruns the drain, the oldest buffered events on that thread
+ * are overwritten and counted in getDroppedEventCount() rather than blocking
+ * the publisher.
  */
 template <typename TraceEvent>
 class TraceBus : public std::enable_shared_from_this<TraceBus<TraceEvent>> {
@@ -176,13 +187,31 @@ class TraceBus : public std::enable_shared_from_this<TraceBus<TraceEvent>> {
       std::string name,
       size_t bufferCapacity);
 
+  /**
+   * Creates a lossy TraceBus: publish() appends to a per-thread ring buffer
+   * of bufferCapacity events and never blocks. The background thread drains
+   * the rings periodically; when a producer fills its ring between drains,
+   * the oldest events on that thread are overwritten and counted in
+   * getDroppedEventCount().
+   *
+   * Published events carry a global sequence number, so subscribers still
+   * observe events in publish order even across threads. Unlike the default
+   * mode, a subscriber may continue to observe events published after its
+   * subscription handle is dropped until the background thread notices the
+   * unsubscription. Destruction still flushes all buffered events.
+   */
+  static std::shared_ptr<TraceBus> createLossy(
+      std::string name,
+      size_t bufferCapacity);
+
   /**
    * Use `create` instead. TraceBus must be managed by shared_ptr.
    */
   TraceBus(
       PrivateConstructorTag,
       std::string threadName,
-      size_t bufferCapacity);
+      size_t bufferCapacity,
+      bool lossy = false);
 
   /**
    * Blocks until all published events have been observed by all registered
@@ -233,6 +262,15 @@ class TraceBus : public std::enable_shared_from_this<TraceBus<TraceEvent>> {
         std::move(name), std::forward<Fn>(fn)));
   };
 
+  /**
+   * Returns the number of events dropped so far by a lossy bus. Always zero
+   * for a bus created with `create`. The count may lag publishers by one
+   * drain interval.
+   */
+  uint64_t getDroppedEventCount() const noexcept {
+    return droppedEvents_.load(std::memory_order_relaxed);
+  }
+
   TraceBus(TraceBus&&) = delete;
   TraceBus(const TraceBus&) = delete;
   TraceBus& operator=(TraceBus&&) = delete;
@@ -248,8 +286,12 @@ class TraceBus : public std::enable_shared_from_this<TraceBus<TraceEvent>> {
   void unsubscribe(void* subscription) noexcept;
 
   void logFullOnce() noexcept;
+  void logDroppedOnce() noexcept;
+
+  void publishLossy(TraceEvent&& event) noexcept;
 
   void threadLoop(std::vector<TraceEvent>& readbuffer) noexcept;
+  void threadLoopLossy(std::vector<TraceEvent>& readbuffer) noexcept;
 
   struct Subscription {
     const std::shared_ptr<Subscriber> subscriber;
@@ -278,8 +320,58 @@ class TraceBus : public std::enable_shared_from_this<TraceBus<TraceEvent>> {
     uint64_t sequenceNumber = 1;
   };
 
+  /**
+   * Delete subscriptions whose unsubscription request has been satisfied.
+   * Must be called with the state lock held.
+   */
+  void reapUnsubscribed(
+      State& state,
+      uint64_t lastObservedSequenceNumber) noexcept;
+
+  /**
+   * An event buffered in a per-thread ring, stamped with the global publish
+   * sequence so the background thread can restore cross-thread ordering
+   * when merging ring contents.
+   */
+  struct StampedEvent {
+    uint64_t sequence;
+    TraceEvent event;
+  };
+
+  /**
+   * Per-thread ring buffer for the lossy mode. The mutex is only contended
+   * when the background thread drains the ring, so the publish path is an
+   * uncontended lock plus an append in the common case.
+   */
+  struct LossyRing {
+    explicit LossyRing(std::atomic<uint64_t>* droppedSink)
+        : droppedSink{droppedSink} {}
+
+    ~LossyRing() {
+      // A thread may exit with undrained events; they can no longer be
+      // delivered, so account for them as drops.
+      droppedSink->fetch_add(
+          slots.size() + dropped, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t>* const droppedSink;
+    std::mutex mutex;
+    // Grows up to bufferCapacity_; once full, `head` indexes the oldest
+    // event and publishes overwrite it.
+    std::vector<StampedEvent> slots;
+    size_t head = 0;
+    uint64_t dropped = 0;
+  };
+
+  /**
+   * How often the background thread drains the per-thread rings in lossy
+   * mode. This bounds the latency between publish and observation.
+   */
+  static constexpr std::chrono::milliseconds kLossyPollInterval{10};
+
   const std::string name_;
   const size_t bufferCapacity_;
+  const bool lossy_;
 
   folly::Synchronized<State, std::mutex> state_;
   // Encodes the condition done || !writeBuffer.empty()
@@ -287,6 +379,16 @@ class TraceBus : public std::enable_shared_from_this<TraceBus<TraceEvent>> {
   // Encodes the condition writeBuffer.size() < bufferCapacity_
   std::condition_variable fullCV_;
   folly::once_flag logIfFullFlag_;
+  folly::once_flag logIfDroppedFlag_;
+
+  // Stamp source for lossy publishes; taken while the publishing thread's
+  // ring lock is held so that ring contents are sequence-ordered.
+  std::atomic<uint64_t> publishSequence_{1};
+  std::atomic<uint64_t> droppedEvents_{0};
+  // Must be declared after droppedEvents_: ring destructors fold their
+  // counts into it.
+  folly::ThreadLocal<LossyRing, TraceBus> rings_;
+
   std::thread thread_;
 
   // For unsubscribe.
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/telemetry/TracePerfAggregator.h"
+
+#include <folly/likely.h>
+
+#include <algorithm>
+
+namespace facebook::eden {
+
+namespace {
+
+constexpr std::chrono::minutes kInFlightTimeout{5};
+
+uint64_t steadySecond(std::chrono::steady_clock::time_point when) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::seconds>(
+          when.time_since_epoch())
+          .count());
+}
+
+uint64_t elapsedNs(
+    std::chrono::steady_clock::time_point from,
+    std::chrono::steady_clock::time_point to) {
+  if (to <= from) {
+    return 0;
+  }
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+} // namespace
+
+TracePerfAggregator::StageTotals& TracePerfAggregator::rowFor(
+    State& state,
+    Operation operation,
+    uint32_t code,
+    std::chrono::steady_clock::time_point when) {
+  auto second = steadySecond(when);
+  auto& bucket = state.buckets[second % state.buckets.size()];
+  if (bucket.second < second) {
+    // The slot last held an older second's rows; recycle it.
+    bucket.second = second;
+    bucket.ops.clear();
+  }
+  // An event stamped slightly in the past (trace buses deliver
+  // asynchronously) lands in the slot's current bin rather than
+  // resurrecting a dead one.
+  return bucket.ops[opKey(operation, code)];
+}
+
+void TracePerfAggregator::pruneStaleInFlight(
+    State& state,
+    std::chrono::steady_clock::time_point now) {
+  auto cutoff = now - kInFlightTimeout;
+  for (auto iter = state.inFlightFs.begin(); iter != state.inFlightFs.end();) {
+    if (iter->second.start < cutoff) {
+      iter = state.inFlightFs.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  for (auto iter = state.inFlightImports.begin();
+       iter != state.inFlightImports.end();) {
+    auto reference = iter->second.queued ? *iter->second.queued
+                                         : iter->second.started.value_or(now);
+    if (reference < cutoff) {
+      iter = state.inFlightImports.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+void TracePerfAggregator::recordFsStart(
+    uint64_t requestId,
+    uint32_t opcode,
+    std::chrono::steady_clock::time_point when) {
+  auto state = state_.wlock();
+  // The in-flight sets normally stay small; only prune once they suggest
+  // finish events are going missing.
+  if (UNLIKELY(state->inFlightFs.size() >= 10000)) {
+    pruneStaleInFlight(*state, when);
+  }
+  state->inFlightFs[requestId] = InFlightFsRequest{opcode, when, 0, 0};
+}
+
+void TracePerfAggregator::recordFsFinish(
+    uint64_t requestId,
+    std::chrono::steady_clock::time_point when) {
+  auto state = state_.wlock();
+  auto iter = state->inFlightFs.find(requestId);
+  if (iter == state->inFlightFs.end()) {
+    // Started before we subscribed, or pruned as stale.
+    return;
+  }
+  auto request = iter->second;
+  state->inFlightFs.erase(iter);
+
+  auto durationNs = elapsedNs(request.start, when);
+  auto& row = rowFor(*state, Operation::FsRequest, request.opcode, when);
+  row.count += 1;
+  row.totalNs += durationNs;
+  row.maxNs = std::max(row.maxNs, durationNs);
+  row.queueWaitNs += request.queueWaitNs;
+  row.storeFetchNs += request.storeFetchNs;
+}
+
+void TracePerfAggregator::recordImportQueue(
+    uint64_t importId,
+    bool /*isTree*/,
+    std::chrono::steady_clock::time_point when) {
+  auto state = state_.wlock();
+  if (UNLIKELY(state->inFlightImports.size() >= 10000)) {
+    pruneStaleInFlight(*state, when);
+  }
+  state->inFlightImports[importId].queued = when;
+}
+
+void TracePerfAggregator::recordImportStart(
+    uint64_t importId,
+    bool /*isTree*/,
+    std::chrono::steady_clock::time_point when) {
+  auto state = state_.wlock();
+  state->inFlightImports[importId].started = when;
+}
+
+void TracePerfAggregator::recordImportFinish(
+    uint64_t importId,
+    bool isTree,
+    bool causedByFs,
+    std::chrono::steady_clock::time_point when) {
+  auto state = state_.wlock();
+  InFlightImport import;
+  auto iter = state->inFlightImports.find(importId);
+  if (iter != state->inFlightImports.end()) {
+    import = iter->second;
+    state->inFlightImports.erase(iter);
+  }
+
+  // Tracing may have missed the queue event (the import was already queued
+  // when the mount's subscription attached); fall back to whatever earlier
+  // stage we did see.
+  uint64_t queueWaitNs = 0;
+  uint64_t fetchNs = 0;
+  if (import.started) {
+    fetchNs = elapsedNs(*import.started, when);
+    if (import.queued) {
+      queueWaitNs = elapsedNs(*import.queued, *import.started);
+    }
+  } else if (import.queued) {
+    fetchNs = elapsedNs(*import.queued, when);
+  }
+
+  auto operation =
+      isTree ? Operation::HgTreeImport : Operation::HgBlobImport;
+  auto& row = rowFor(*state, operation, 0, when);
+  row.count += 1;
+  row.totalNs += queueWaitNs + fetchNs;
+  row.maxNs = std::max(row.maxNs, queueWaitNs + fetchNs);
+  row.queueWaitNs += queueWaitNs;
+  row.storeFetchNs += fetchNs;
+
+  if (causedByFs && !state->inFlightFs.empty()) {
+    // Charge the import to the oldest in-flight filesystem request: the
+    // request most likely stalled on it. See the class comment for why
+    // this heuristic is acceptable.
+    auto oldest = std::min_element(
+        state->inFlightFs.begin(),
+        state->inFlightFs.end(),
+        [](const auto& lhs, const auto& rhs) {
+          return lhs.second.start < rhs.second.start;
+        });
+    oldest->second.queueWaitNs += queueWaitNs;
+    oldest->second.storeFetchNs += fetchNs;
+  }
+}
+
+void TracePerfAggregator::recordInodeEvent(
+    bool isMaterialization,
+    std::chrono::nanoseconds duration,
+    std::chrono::steady_clock::time_point when) {
+  auto durationNs =
+      duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+  auto state = state_.wlock();
+  auto operation = isMaterialization ? Operation::InodeMaterialization
+                                     : Operation::InodeLoad;
+  auto& row = rowFor(*state, operation, 0, when);
+  row.count += 1;
+  row.totalNs += durationNs;
+  row.maxNs = std::max(row.maxNs, durationNs);
+}
+
+std::vector<TracePerfAggregator::OpReport> TracePerfAggregator::read(
+    std::chrono::seconds window) const {
+  window = std::clamp(window, std::chrono::seconds{1}, kMaxWindow);
+  auto nowSecond = steadySecond(std::chrono::steady_clock::now());
+  auto cutoff = nowSecond >= static_cast<uint64_t>(window.count())
+      ? nowSecond - static_cast<uint64_t>(window.count()) + 1
+      : 0;
+
+  folly::F14FastMap<uint64_t, StageTotals> merged;
+  {
+    auto state = state_.rlock();
+    for (const auto& bucket : state->buckets) {
+      if (bucket.second < cutoff) {
+        // Either never written or aged out of the window.
+        continue;
+      }
+      for (const auto& [key, totals] : bucket.ops) {
+        auto& row = merged[key];
+        row.count += totals.count;
+        row.totalNs += totals.totalNs;
+        row.maxNs = std::max(row.maxNs, totals.maxNs);
+        row.queueWaitNs += totals.queueWaitNs;
+        row.storeFetchNs += totals.storeFetchNs;
+      }
+    }
+  }
+
+  std::vector<OpReport> reports;
+  reports.reserve(merged.size());
+  for (const auto& [key, totals] : merged) {
+    reports.push_back(OpReport{
+        static_cast<Operation>(key >> 32),
+        static_cast<uint32_t>(key & 0xffffffffu),
+        totals});
+  }
+  return reports;
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+
+namespace facebook::eden {
+
+/**
+ * TracePerfAggregator folds a mount's trace streams into rolling
+ * per-operation stage breakdowns, so `eden trace perf` can answer "where is
+ * time going right now" without the caller joining the raw fs, hg and inode
+ * event streams by hand.
+ *
+ * The aggregator stays subscribed to the mount's trace buses for the
+ * mount's lifetime. Events are bucketed into one-second bins covering the
+ * last kMaxWindow seconds; read() sums the bins inside the caller's window,
+ * so the cost of a query does not depend on the event rate.
+ *
+ * Stage attribution: hg imports report their own queue-wait (QUEUE to
+ * START) and fetch (START to FINISH) stages directly. When an import
+ * caused by a filesystem request finishes, those two stages are also
+ * charged to the oldest filesystem request still in flight - the request
+ * most likely blocked on it - so the per-opcode rows split total latency
+ * into queue wait, store fetch, and everything else. This is a heuristic:
+ * with several requests in flight the charge can land on a sibling
+ * request, but in the common case of one stalled request it is exact, and
+ * it never invents time that was not spent in the importer.
+ *
+ * All record methods are cheap (a map update under one lock) and safe to
+ * call from any thread; each trace bus delivers from its own background
+ * thread.
+ */
+class TracePerfAggregator {
+ public:
+  /**
+   * What a row aggregates. FsRequest rows are further keyed by the
+   * channel's operation code (FUSE opcode, NFS procedure, or PrjFS call
+   * type); the other rows use code 0.
+   */
+  enum class Operation : uint8_t {
+    FsRequest,
+    HgBlobImport,
+    HgTreeImport,
+    InodeMaterialization,
+    InodeLoad,
+  };
+
+  struct StageTotals {
+    uint64_t count = 0;
+    uint64_t totalNs = 0;
+    uint64_t maxNs = 0;
+    uint64_t queueWaitNs = 0;
+    uint64_t storeFetchNs = 0;
+  };
+
+  struct OpReport {
+    Operation operation;
+    uint32_t code = 0;
+    StageTotals totals;
+  };
+
+  /** The widest window read() can serve; older bins are overwritten. */
+  static constexpr std::chrono::seconds kMaxWindow{60};
+
+  TracePerfAggregator() = default;
+
+  TracePerfAggregator(const TracePerfAggregator&) = delete;
+  TracePerfAggregator& operator=(const TracePerfAggregator&) = delete;
+
+  void recordFsStart(
+      uint64_t requestId,
+      uint32_t opcode,
+      std::chrono::steady_clock::time_point when);
+
+  void recordFsFinish(
+      uint64_t requestId,
+      std::chrono::steady_clock::time_point when);
+
+  void recordImportQueue(
+      uint64_t importId,
+      bool isTree,
+      std::chrono::steady_clock::time_point when);
+
+  void recordImportStart(
+      uint64_t importId,
+      bool isTree,
+      std::chrono::steady_clock::time_point when);
+
+  /**
+   * `causedByFs` marks imports issued on behalf of a filesystem request;
+   * their queue-wait and fetch stages are charged to the oldest in-flight
+   * filesystem request as described above.
+   */
+  void recordImportFinish(
+      uint64_t importId,
+      bool isTree,
+      bool causedByFs,
+      std::chrono::steady_clock::time_point when);
+
+  /**
+   * Inode events arrive as single completed records carrying their own
+   * duration, so there is nothing to correlate.
+   */
+  void recordInodeEvent(
+      bool isMaterialization,
+      std::chrono::nanoseconds duration,
+      std::chrono::steady_clock::time_point when);
+
+  /**
+   * Sum the rows recorded during the trailing `window`, clamped to
+   * [1s, kMaxWindow]. Rows are in no particular order.
+   */
+  std::vector<OpReport> read(std::chrono::seconds window) const;
+
+ private:
+  struct InFlightFsRequest {
+    uint32_t opcode = 0;
+    std::chrono::steady_clock::time_point start;
+    // Import stages charged to this request so far; folded into the row
+    // when the request finishes.
+    uint64_t queueWaitNs = 0;
+    uint64_t storeFetchNs = 0;
+  };
+
+  struct InFlightImport {
+    std::optional<std::chrono::steady_clock::time_point> queued;
+    std::optional<std::chrono::steady_clock::time_point> started;
+  };
+
+  /**
+   * One second's worth of rows. `second` is the bin's absolute
+   * steady-clock second; a bin whose stamp has fallen out of the window is
+   * dead and gets reset the next time its slot is written.
+   */
+  struct Bucket {
+    uint64_t second = 0;
+    folly::F14FastMap<uint64_t, StageTotals> ops;
+  };
+
+  struct State {
+    folly::F14FastMap<uint64_t, InFlightFsRequest> inFlightFs;
+    folly::F14FastMap<uint64_t, InFlightImport> inFlightImports;
+    std::array<Bucket, kMaxWindow.count()> buckets;
+  };
+
+  static uint64_t opKey(Operation operation, uint32_t code) {
+    return (static_cast<uint64_t>(operation) << 32) | code;
+  }
+
+  StageTotals& rowFor(
+      State& state,
+      Operation operation,
+      uint32_t code,
+      std::chrono::steady_clock::time_point when);
+
+  /**
+   * Drop in-flight entries older than a few minutes so requests whose
+   * finish event was never published (an interrupted FUSE request, a
+   * cancelled import) do not accumulate forever.
+   */
+  void pruneStaleInFlight(
+      State& state,
+      std::chrono::steady_clock::time_point now);
+
+  folly::Synchronized<State> state_;
+};
+
+} // namespace facebook::eden
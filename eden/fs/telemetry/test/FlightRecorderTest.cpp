@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/telemetry/FlightRecorder.h"
+
+#include <folly/FileUtil.h>
+#include <folly/experimental/TestUtil.h>
+#include <folly/portability/GTest.h>
+
+using namespace facebook::eden;
+
+namespace {
+
+constexpr uint32_t kMaxEvents = 4;
+
+uint64_t nowNs() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+FlightRecorderEntry makeEntry(uint64_t id, uint64_t monotonicNs) {
+  return FlightRecorderEntry{
+      monotonicNs,
+      id,
+      /*pid=*/100,
+      /*code=*/1,
+      /*phase=*/0,
+      FlightRecorderSubsystem::FUSE};
+}
+
+std::vector<FlightRecorderEntry> dumpToEntries(
+    const FlightRecorder& recorder,
+    std::chrono::nanoseconds window) {
+  folly::test::TemporaryFile output;
+  folly::File file{output.fd(), /*ownsFd=*/false};
+  auto count = recorder.dump(file, window);
+
+  std::string contents;
+  EXPECT_TRUE(folly::readFile(output.path().c_str(), contents));
+  EXPECT_EQ(
+      4 * sizeof(uint32_t) + count * sizeof(FlightRecorderEntry),
+      contents.size());
+
+  const auto* header = reinterpret_cast<const uint32_t*>(contents.data());
+  EXPECT_EQ(0x45465231u, header[0]); // "EFR1"
+  EXPECT_EQ(1u, header[1]);
+  EXPECT_EQ(count, header[2]);
+
+  std::vector<FlightRecorderEntry> entries(count);
+  memcpy(
+      entries.data(),
+      contents.data() + 4 * sizeof(uint32_t),
+      count * sizeof(FlightRecorderEntry));
+  return entries;
+}
+
+} // namespace
+
+TEST(FlightRecorderTest, dump_empty) {
+  FlightRecorder recorder{kMaxEvents};
+  auto entries = dumpToEntries(recorder, std::chrono::nanoseconds{0});
+  EXPECT_TRUE(entries.empty());
+}
+
+TEST(FlightRecorderTest, dump_preserves_order) {
+  FlightRecorder recorder{kMaxEvents};
+  auto base = nowNs();
+  for (uint64_t i = 1; i <= 3; i++) {
+    recorder.record(makeEntry(i, base + i));
+  }
+
+  auto entries = dumpToEntries(recorder, std::chrono::nanoseconds{0});
+  ASSERT_EQ(3ul, entries.size());
+  for (uint64_t i = 1; i <= 3; i++) {
+    EXPECT_EQ(i, entries[i - 1].id);
+    EXPECT_EQ(FlightRecorderSubsystem::FUSE, entries[i - 1].subsystem);
+  }
+}
+
+TEST(FlightRecorderTest, ring_overwrites_oldest) {
+  FlightRecorder recorder{kMaxEvents};
+  auto base = nowNs();
+  for (uint64_t i = 1; i <= 10; i++) {
+    recorder.record(makeEntry(i, base + i));
+  }
+
+  // Only the last kMaxEvents entries remain, oldest first.
+  auto entries = dumpToEntries(recorder, std::chrono::nanoseconds{0});
+  ASSERT_EQ(kMaxEvents, entries.size());
+  for (uint64_t i = 0; i < kMaxEvents; i++) {
+    EXPECT_EQ(10 - kMaxEvents + 1 + i, entries[i].id);
+  }
+}
+
+TEST(FlightRecorderTest, dump_window_filters_old_entries) {
+  FlightRecorder recorder{kMaxEvents};
+  recorder.record(makeEntry(1, /*monotonicNs=*/1));
+  recorder.record(makeEntry(2, nowNs()));
+
+  auto entries = dumpToEntries(recorder, std::chrono::hours{1});
+  ASSERT_EQ(1ul, entries.size());
+  EXPECT_EQ(2ul, entries[0].id);
+}
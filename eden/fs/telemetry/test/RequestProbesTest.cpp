@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include <folly/portability/GTest.h>
+
+#include <thread>
+
+#include "eden/fs/telemetry/RequestProbes.h"
+
+using namespace facebook::eden;
+
+TEST(RequestProbes, annotationDefaultsToIdle) {
+  std::thread([] {
+    auto& annotation = currentRequestAnnotation();
+    EXPECT_EQ(0u, annotation.requestId);
+    EXPECT_EQ(0u, annotation.requestType);
+    EXPECT_EQ(0u, annotation.cause);
+  }).join();
+}
+
+TEST(RequestProbes, scopeSetsAndRestoresAnnotation) {
+  auto& annotation = currentRequestAnnotation();
+  {
+    RequestAnnotationScope outer{1, 10, 100};
+    EXPECT_EQ(1u, annotation.requestId);
+    EXPECT_EQ(10u, annotation.requestType);
+    EXPECT_EQ(100u, annotation.cause);
+    {
+      RequestAnnotationScope inner{2, 20, 200};
+      EXPECT_EQ(2u, annotation.requestId);
+      EXPECT_EQ(20u, annotation.requestType);
+      EXPECT_EQ(200u, annotation.cause);
+    }
+    // Leaving the inner scope re-attributes samples to the outer request.
+    EXPECT_EQ(1u, annotation.requestId);
+    EXPECT_EQ(10u, annotation.requestType);
+    EXPECT_EQ(100u, annotation.cause);
+  }
+  EXPECT_EQ(0u, annotation.requestId);
+}
+
+TEST(RequestProbes, annotationIsPerThread) {
+  RequestAnnotationScope scope{42, 1, 1};
+  std::thread([] {
+    EXPECT_EQ(0u, currentRequestAnnotation().requestId);
+  }).join();
+  EXPECT_EQ(42u, currentRequestAnnotation().requestId);
+}
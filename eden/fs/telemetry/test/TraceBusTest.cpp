@@ -46,6 +46,43 @@ TEST(TraceBusTest, publishes_exceed_capacity) {
   }
 }
 
+TEST(TraceBusTest, lossy_publish_reaches_subscriber) {
+  folly::Promise<int> promise;
+  auto future = promise.getFuture();
+
+  auto bus = TraceBus<int>::createLossy("bus", 10);
+  auto handle = bus->subscribeFunction(
+      "sub", [&](int event) { promise.setValue(event); });
+  bus->publish(1234);
+
+  EXPECT_EQ(1234, std::move(future).get(1000ms));
+}
+
+TEST(TraceBusTest, lossy_publishes_exceed_capacity) {
+  std::vector<int> values;
+  uint64_t dropped;
+  {
+    auto bus = TraceBus<int>::createLossy("bus", 4);
+    auto handle =
+        bus->subscribeFunction("sub", [&](int v) { values.push_back(v); });
+
+    for (int i = 0; i < 100; ++i) {
+      bus->publish(i);
+    }
+
+    dropped = bus->getDroppedEventCount();
+  }
+
+  // The lossy bus drops the oldest events when the ring fills, but never
+  // reorders or duplicates, and destruction flushes whatever remains.
+  XCHECK(!values.empty());
+  XCHECK_EQ(99, values.back());
+  for (size_t i = 1; i < values.size(); ++i) {
+    XCHECK_LT(values[i - 1], values[i]);
+  }
+  XCHECK_LE(values.size() + dropped, 100ul);
+}
+
 TEST(TraceBusTest, unsubscribes_upon_exception) {
   int i = 0;
 
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/telemetry/TracePerfAggregator.h"
+
+#include <folly/portability/GTest.h>
+
+using namespace facebook::eden;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Operation = TracePerfAggregator::Operation;
+
+std::optional<TracePerfAggregator::OpReport> findReport(
+    const std::vector<TracePerfAggregator::OpReport>& reports,
+    Operation operation,
+    uint32_t code = 0) {
+  for (const auto& report : reports) {
+    if (report.operation == operation && report.code == code) {
+      return report;
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+TEST(TracePerfAggregator, aggregatesFsRequestsByOpcode) {
+  TracePerfAggregator aggregator;
+  auto base = std::chrono::steady_clock::now();
+
+  aggregator.recordFsStart(1, /*opcode=*/10, base);
+  aggregator.recordFsFinish(1, base + 2ms);
+  aggregator.recordFsStart(2, /*opcode=*/10, base);
+  aggregator.recordFsFinish(2, base + 6ms);
+  aggregator.recordFsStart(3, /*opcode=*/20, base);
+  aggregator.recordFsFinish(3, base + 1ms);
+
+  auto reports = aggregator.read(60s);
+  auto lookups = findReport(reports, Operation::FsRequest, 10);
+  ASSERT_TRUE(lookups.has_value());
+  EXPECT_EQ(2, lookups->totals.count);
+  EXPECT_EQ(8'000'000, lookups->totals.totalNs);
+  EXPECT_EQ(6'000'000, lookups->totals.maxNs);
+
+  auto other = findReport(reports, Operation::FsRequest, 20);
+  ASSERT_TRUE(other.has_value());
+  EXPECT_EQ(1, other->totals.count);
+  EXPECT_EQ(1'000'000, other->totals.totalNs);
+}
+
+TEST(TracePerfAggregator, ignoresFinishWithoutStart) {
+  TracePerfAggregator aggregator;
+  aggregator.recordFsFinish(42, std::chrono::steady_clock::now());
+  EXPECT_TRUE(aggregator.read(60s).empty());
+}
+
+TEST(TracePerfAggregator, importStagesAreBrokenOut) {
+  TracePerfAggregator aggregator;
+  auto base = std::chrono::steady_clock::now();
+
+  aggregator.recordImportQueue(7, /*isTree=*/false, base);
+  aggregator.recordImportStart(7, /*isTree=*/false, base + 3ms);
+  aggregator.recordImportFinish(
+      7, /*isTree=*/false, /*causedByFs=*/false, base + 8ms);
+
+  auto reports = aggregator.read(60s);
+  auto blobs = findReport(reports, Operation::HgBlobImport);
+  ASSERT_TRUE(blobs.has_value());
+  EXPECT_EQ(1, blobs->totals.count);
+  EXPECT_EQ(3'000'000, blobs->totals.queueWaitNs);
+  EXPECT_EQ(5'000'000, blobs->totals.storeFetchNs);
+  EXPECT_EQ(8'000'000, blobs->totals.totalNs);
+}
+
+TEST(TracePerfAggregator, fsCausedImportIsChargedToOldestInFlightRequest) {
+  TracePerfAggregator aggregator;
+  auto base = std::chrono::steady_clock::now();
+
+  aggregator.recordFsStart(1, /*opcode=*/10, base);
+  aggregator.recordFsStart(2, /*opcode=*/20, base + 1ms);
+
+  aggregator.recordImportQueue(7, /*isTree=*/true, base + 2ms);
+  aggregator.recordImportStart(7, /*isTree=*/true, base + 4ms);
+  aggregator.recordImportFinish(
+      7, /*isTree=*/true, /*causedByFs=*/true, base + 9ms);
+
+  aggregator.recordFsFinish(1, base + 10ms);
+  aggregator.recordFsFinish(2, base + 10ms);
+
+  auto reports = aggregator.read(60s);
+  auto oldest = findReport(reports, Operation::FsRequest, 10);
+  ASSERT_TRUE(oldest.has_value());
+  EXPECT_EQ(2'000'000, oldest->totals.queueWaitNs);
+  EXPECT_EQ(5'000'000, oldest->totals.storeFetchNs);
+
+  auto younger = findReport(reports, Operation::FsRequest, 20);
+  ASSERT_TRUE(younger.has_value());
+  EXPECT_EQ(0, younger->totals.queueWaitNs);
+  EXPECT_EQ(0, younger->totals.storeFetchNs);
+
+  // The import also reports its own row.
+  auto trees = findReport(reports, Operation::HgTreeImport);
+  ASSERT_TRUE(trees.has_value());
+  EXPECT_EQ(1, trees->totals.count);
+}
+
+TEST(TracePerfAggregator, importWithoutQueueEventCountsFetchOnly) {
+  TracePerfAggregator aggregator;
+  auto base = std::chrono::steady_clock::now();
+
+  // The subscription attached after the import was queued.
+  aggregator.recordImportStart(7, /*isTree=*/false, base);
+  aggregator.recordImportFinish(
+      7, /*isTree=*/false, /*causedByFs=*/false, base + 4ms);
+
+  auto reports = aggregator.read(60s);
+  auto blobs = findReport(reports, Operation::HgBlobImport);
+  ASSERT_TRUE(blobs.has_value());
+  EXPECT_EQ(0, blobs->totals.queueWaitNs);
+  EXPECT_EQ(4'000'000, blobs->totals.storeFetchNs);
+}
+
+TEST(TracePerfAggregator, aggregatesInodeEvents) {
+  TracePerfAggregator aggregator;
+  auto now = std::chrono::steady_clock::now();
+
+  aggregator.recordInodeEvent(/*isMaterialization=*/true, 2ms, now);
+  aggregator.recordInodeEvent(/*isMaterialization=*/true, 4ms, now);
+  aggregator.recordInodeEvent(/*isMaterialization=*/false, 1ms, now);
+
+  auto reports = aggregator.read(60s);
+  auto materializations =
+      findReport(reports, Operation::InodeMaterialization);
+  ASSERT_TRUE(materializations.has_value());
+  EXPECT_EQ(2, materializations->totals.count);
+  EXPECT_EQ(6'000'000, materializations->totals.totalNs);
+  EXPECT_EQ(4'000'000, materializations->totals.maxNs);
+
+  auto loads = findReport(reports, Operation::InodeLoad);
+  ASSERT_TRUE(loads.has_value());
+  EXPECT_EQ(1, loads->totals.count);
+}
+
+TEST(TracePerfAggregator, oldEventsAgeOutOfTheWindow) {
+  TracePerfAggregator aggregator;
+  auto old = std::chrono::steady_clock::now() -
+      TracePerfAggregator::kMaxWindow - 5s;
+
+  aggregator.recordFsStart(1, /*opcode=*/10, old);
+  aggregator.recordFsFinish(1, old + 1ms);
+
+  EXPECT_TRUE(aggregator.read(60s).empty());
+}
@@ -333,6 +333,16 @@ class TestMount {
     return serverState_;
   }
 
+  /**
+   * Get the EdenConfig used by this mount.
+   *
+   * Tests may mutate settings through this reference; the mount reads the
+   * same object, so changes apply to subsequent operations.
+   */
+  EdenConfig& getEdenConfig() {
+    return *edenConfig_;
+  }
+
   /**
    * Get a hash to use for the next commit.
    *
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/AsciiCaseFold.h"
+
+#include <folly/hash/SpookyHashV2.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace facebook::eden {
+
+namespace {
+
+inline char foldChar(char c) {
+  if (c >= 'A' && c <= 'Z') {
+    c += 'a' - 'A';
+  }
+  return c;
+}
+
+#if defined(__AVX2__)
+
+constexpr size_t kBlockSize = 32;
+
+inline __m256i foldBlock(__m256i v) {
+  // Signed compares are correct here: 'A' and 'Z' are both positive, and
+  // bytes >= 0x80 are negative, so non-ASCII bytes never match the range.
+  auto upper = _mm256_and_si256(
+      _mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+      _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+  return _mm256_add_epi8(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+/**
+ * Returns the index of the first byte whose folded value differs between a
+ * and b, or len if the folded ranges are identical.
+ */
+size_t mismatchFolded(const char* a, const char* b, size_t len) {
+  size_t i = 0;
+  for (; i + kBlockSize <= len; i += kBlockSize) {
+    auto va = foldBlock(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+    auto vb = foldBlock(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+    auto mask = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)));
+    if (mask != 0xffffffffu) {
+      return i + __builtin_ctz(~mask);
+    }
+  }
+  for (; i < len; ++i) {
+    if (foldChar(a[i]) != foldChar(b[i])) {
+      return i;
+    }
+  }
+  return len;
+}
+
+void foldCopy(char* dst, const char* src, size_t len) {
+  size_t i = 0;
+  for (; i + kBlockSize <= len; i += kBlockSize) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i),
+        foldBlock(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i))));
+  }
+  for (; i < len; ++i) {
+    dst[i] = foldChar(src[i]);
+  }
+}
+
+#elif defined(__SSE2__)
+
+constexpr size_t kBlockSize = 16;
+
+inline __m128i foldBlock(__m128i v) {
+  // Signed compares are correct here: 'A' and 'Z' are both positive, and
+  // bytes >= 0x80 are negative, so non-ASCII bytes never match the range.
+  auto upper = _mm_and_si128(
+      _mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+      _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v));
+  return _mm_add_epi8(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+size_t mismatchFolded(const char* a, const char* b, size_t len) {
+  size_t i = 0;
+  for (; i + kBlockSize <= len; i += kBlockSize) {
+    auto va =
+        foldBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+    auto vb =
+        foldBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+    auto mask =
+        static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)));
+    if (mask != 0xffffu) {
+      return i + __builtin_ctz(~mask & 0xffffu);
+    }
+  }
+  for (; i < len; ++i) {
+    if (foldChar(a[i]) != foldChar(b[i])) {
+      return i;
+    }
+  }
+  return len;
+}
+
+void foldCopy(char* dst, const char* src, size_t len) {
+  size_t i = 0;
+  for (; i + kBlockSize <= len; i += kBlockSize) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + i),
+        foldBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+  }
+  for (; i < len; ++i) {
+    dst[i] = foldChar(src[i]);
+  }
+}
+
+#elif defined(__aarch64__)
+
+constexpr size_t kBlockSize = 16;
+
+inline uint8x16_t foldBlock(uint8x16_t v) {
+  auto upper = vandq_u8(
+      vcgeq_u8(v, vdupq_n_u8('A')), vcleq_u8(v, vdupq_n_u8('Z')));
+  return vaddq_u8(v, vandq_u8(upper, vdupq_n_u8(0x20)));
+}
+
+size_t mismatchFolded(const char* a, const char* b, size_t len) {
+  size_t i = 0;
+  for (; i + kBlockSize <= len; i += kBlockSize) {
+    auto va = foldBlock(vld1q_u8(reinterpret_cast<const uint8_t*>(a + i)));
+    auto vb = foldBlock(vld1q_u8(reinterpret_cast<const uint8_t*>(b + i)));
+    auto eq = vceqq_u8(va, vb);
+    if (vminvq_u8(eq) != 0xff) {
+      // Some lane differs; scan the block to find the first one.
+      std::array<uint8_t, kBlockSize> lanes;
+      vst1q_u8(lanes.data(), eq);
+      for (size_t lane = 0; lane < kBlockSize; ++lane) {
+        if (lanes[lane] != 0xff) {
+          return i + lane;
+        }
+      }
+    }
+  }
+  for (; i < len; ++i) {
+    if (foldChar(a[i]) != foldChar(b[i])) {
+      return i;
+    }
+  }
+  return len;
+}
+
+void foldCopy(char* dst, const char* src, size_t len) {
+  size_t i = 0;
+  for (; i + kBlockSize <= len; i += kBlockSize) {
+    vst1q_u8(
+        reinterpret_cast<uint8_t*>(dst + i),
+        foldBlock(vld1q_u8(reinterpret_cast<const uint8_t*>(src + i))));
+  }
+  for (; i < len; ++i) {
+    dst[i] = foldChar(src[i]);
+  }
+}
+
+#else
+
+size_t mismatchFolded(const char* a, const char* b, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    if (foldChar(a[i]) != foldChar(b[i])) {
+      return i;
+    }
+  }
+  return len;
+}
+
+void foldCopy(char* dst, const char* src, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    dst[i] = foldChar(src[i]);
+  }
+}
+
+#endif
+
+} // namespace
+
+int compareAsciiIgnoreCase(
+    std::string_view lhs,
+    std::string_view rhs) noexcept {
+  auto commonLength = std::min(lhs.size(), rhs.size());
+  auto index = mismatchFolded(lhs.data(), rhs.data(), commonLength);
+  if (index < commonLength) {
+    return foldChar(lhs[index]) < foldChar(rhs[index]) ? -1 : 1;
+  }
+  if (lhs.size() == rhs.size()) {
+    return 0;
+  }
+  return lhs.size() < rhs.size() ? -1 : 1;
+}
+
+bool equalsAsciiIgnoreCase(
+    std::string_view lhs,
+    std::string_view rhs) noexcept {
+  return lhs.size() == rhs.size() &&
+      mismatchFolded(lhs.data(), rhs.data(), lhs.size()) == lhs.size();
+}
+
+size_t hashAsciiIgnoreCase(std::string_view value) noexcept {
+  // Hash the folded bytes a buffer at a time; SpookyHashV2's streaming
+  // interface produces the same result as a one-shot hash of the folded
+  // string without having to materialize it.
+  folly::hash::SpookyHashV2 hash{};
+  std::array<char, 256> buffer;
+  while (!value.empty()) {
+    auto chunkSize = std::min(value.size(), buffer.size());
+    foldCopy(buffer.data(), value.data(), chunkSize);
+    hash.Update(buffer.data(), chunkSize);
+    value.remove_prefix(chunkSize);
+  }
+  uint64_t hash1, hash2;
+  hash.Final(&hash1, &hash2);
+  return hash1;
+}
+
+} // namespace facebook::eden
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace facebook::eden {
+
+/*
+ * ASCII case folding kernels.
+ *
+ * These are the building blocks for case-insensitive path comparison and
+ * hashing.  Only the 26 ASCII letters are folded; all other bytes - including
+ * UTF-8 continuation bytes - compare verbatim, matching the semantics the
+ * path comparators have always had.
+ *
+ * The implementations process a vector register's worth of bytes at a time
+ * (AVX2 or SSE2 on x86-64, NEON on ARM64) instead of calling tolower() per
+ * character.  Path comparison is hot enough on case-insensitive mounts for
+ * this to show up in metadata-heavy profiles.
+ */
+
+/**
+ * Three-way compare of two strings, ignoring ASCII case.
+ *
+ * Returns a negative value if lhs orders before rhs, zero if they are equal,
+ * and a positive value otherwise, equivalent to memcmp() over the case-folded
+ * bytes.
+ */
+int compareAsciiIgnoreCase(std::string_view lhs, std::string_view rhs) noexcept;
+
+/**
+ * Test two strings for equality, ignoring ASCII case.
+ */
+bool equalsAsciiIgnoreCase(
+    std::string_view lhs,
+    std::string_view rhs) noexcept;
+
+/**
+ * Hash a string over its ASCII-case-folded bytes.
+ *
+ * Two strings for which equalsAsciiIgnoreCase() returns true hash to the same
+ * value, making this suitable as the hash half of a case-insensitive
+ * comparator pair.
+ */
+size_t hashAsciiIgnoreCase(std::string_view value) noexcept;
+
+} // namespace facebook::eden
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <type_traits>
+
+namespace facebook::eden {
+
+/**
+ * A multi-writer variant of BucketedLog that requires no external
+ * synchronization. Where BucketedLog advances a shared window under a lock,
+ * AtomicBucketedLog stamps each slot in the ring with the time it currently
+ * represents and lazily recycles slots as writers arrive, so any number of
+ * threads can add() concurrently with nothing heavier than a relaxed
+ * fetch_add on the hot path.
+ *
+ * Bucket must be default-constructible and expose:
+ *  - add(args...), safe to call concurrently (typically std::atomic members
+ *    with relaxed increments),
+ *  - clear(), called by the one writer that wins the recycling race for an
+ *    expired slot,
+ *  - load(), returning a plain `Bucket::Value` snapshot of the counters.
+ *
+ * The lock-free recycling is approximate at bucket boundaries: a writer that
+ * observed a slot's stamp immediately before another thread recycled it may
+ * have its sample cleared or folded into the newer second. Samples are only
+ * ever misplaced across a full window (`Size` time units), so this is
+ * acceptable for the rate counters this class is intended for; use
+ * BucketedLog under a lock when samples must never be dropped.
+ *
+ * A little faster if Size is a power of two.
+ */
+template <typename Bucket, size_t Size>
+class AtomicBucketedLog {
+ public:
+  static_assert(
+      std::is_default_constructible_v<Bucket>,
+      "Bucket must be default-constructible");
+
+  using Value = typename Bucket::Value;
+
+  /**
+   * Calls `.add(args...)` on the bucket for time `now`, recycling the slot
+   * first if it still holds data from at least `Size` time units ago. Calls
+   * with a `now` older than the slot's current time are ignored, matching
+   * BucketedLog.
+   */
+  template <typename... Args>
+  void add(uint64_t now, Args&&... args) {
+    auto& slot = slots_[now % Size];
+    auto stamp = slot.stamp.load(std::memory_order_acquire);
+    while (stamp < now) {
+      if (slot.stamp.compare_exchange_weak(
+              stamp, now, std::memory_order_acq_rel)) {
+        // We won the race to recycle this slot; drop the expired data.
+        slot.bucket.clear();
+        stamp = now;
+        break;
+      }
+    }
+    if (stamp == now) {
+      slot.bucket.add(std::forward<Args>(args)...);
+    }
+  }
+
+  /**
+   * Returns a snapshot of the `Size` buckets ending at `now`, oldest first.
+   * Slots whose data has expired (or that were never written) read as
+   * default-constructed Values. Unlike BucketedLog::getAll, this does not
+   * advance any shared clock, so it is safe to call concurrently with
+   * writers; in-flight add()s may or may not be visible.
+   */
+  std::array<Value, Size> getAll(uint64_t now) const {
+    std::array<Value, Size> result{};
+    for (size_t i = 0; i < Size; ++i) {
+      uint64_t age = Size - 1 - i;
+      if (age > now) {
+        // Times before 0 don't exist; leave the default Value.
+        continue;
+      }
+      uint64_t bucketTime = now - age;
+      const auto& slot = slots_[bucketTime % Size];
+      if (slot.stamp.load(std::memory_order_acquire) == bucketTime) {
+        result[i] = slot.bucket.load();
+      }
+    }
+    return result;
+  }
+
+ private:
+  struct Slot {
+    /**
+     * The time unit this slot's bucket currently accumulates. Slot k only
+     * ever holds times congruent to k mod Size, so a mismatched stamp means
+     * the data is stale and the slot is recycled on the next add().
+     */
+    std::atomic<uint64_t> stamp{0};
+    Bucket bucket;
+  };
+
+  std::array<Slot, Size> slots_;
+};
+
+} // namespace facebook::eden
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <folly/hash/Hash.h>
+#include <folly/lang/Bits.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace facebook::eden {
+
+/**
+ * A fixed-size, lock-free Bloom filter over 64-bit hashes.
+ *
+ * add() and mayContain() may be called concurrently from any thread.
+ * mayContain() never returns false for a hash that was added, but may
+ * return false positives, so it is only suitable for optimizations that
+ * tolerate occasionally treating an absent key as present.
+ *
+ * To keep the false positive rate bounded on long-lived filters, the
+ * filter resets itself once the number of added hashes substantially
+ * exceeds its capacity. After a reset, previously-added hashes may
+ * report as absent until they are added again.
+ */
+class BloomFilter {
+ public:
+  /**
+   * Create a filter with the given number of bits, rounded up to a power
+   * of two. With the four probes used here the false positive rate stays
+   * around 1% while the filter holds up to bitCount/10 hashes.
+   */
+  explicit BloomFilter(size_t bitCount)
+      : bits_(folly::nextPowTwo(std::max<size_t>(bitCount, 64)) / 64),
+        bitMask_{bits_.size() * 64 - 1},
+        capacity_{bits_.size() * 64 / 10} {}
+
+  BloomFilter(const BloomFilter&) = delete;
+  BloomFilter& operator=(const BloomFilter&) = delete;
+
+  void add(uint64_t hash) noexcept {
+    if (approximateSize_.fetch_add(1, std::memory_order_relaxed) >=
+        capacity_) {
+      clear();
+    }
+    uint64_t h2 = probeStride(hash);
+    for (size_t i = 0; i < kProbes; ++i) {
+      auto bit = (hash + i * h2) & bitMask_;
+      bits_[bit / 64].fetch_or(
+          uint64_t{1} << (bit % 64), std::memory_order_relaxed);
+    }
+  }
+
+  bool mayContain(uint64_t hash) const noexcept {
+    uint64_t h2 = probeStride(hash);
+    for (size_t i = 0; i < kProbes; ++i) {
+      auto bit = (hash + i * h2) & bitMask_;
+      if (!(bits_[bit / 64].load(std::memory_order_relaxed) &
+            (uint64_t{1} << (bit % 64)))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Reset the filter to empty. Safe to call concurrently with add() and
+   * mayContain(); concurrent adds may be partially lost, which only
+   * weakens the filter towards reporting hashes as absent.
+   */
+  void clear() noexcept {
+    approximateSize_.store(0, std::memory_order_relaxed);
+    for (auto& word : bits_) {
+      word.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  static constexpr size_t kProbes = 4;
+
+  /**
+   * Derive an odd second hash for double hashing, so the four probe
+   * positions are independent even though callers supply one hash value.
+   */
+  static uint64_t probeStride(uint64_t hash) noexcept {
+    return folly::hash::twang_mix64(hash) | 1;
+  }
+
+  std::vector<std::atomic<uint64_t>> bits_;
+  const uint64_t bitMask_;
+  const uint64_t capacity_;
+  std::atomic<uint64_t> approximateSize_{0};
+};
+
+} // namespace facebook::eden
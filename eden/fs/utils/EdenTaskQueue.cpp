@@ -7,33 +7,99 @@
 
 #include "eden/fs/utils/EdenTaskQueue.h"
 
+#include <thread>
+
 namespace facebook::eden {
 
 folly::BlockingQueueAddResult EdenTaskQueue::add(
     folly::CPUThreadPoolExecutor::CPUTask item) {
-  queue_.enqueue(std::move(item));
+  if (auto* local = *myWorkerQueue_) {
+    // A pool thread is spawning a subtask. Keep it local so the same thread
+    // picks it back up next, rather than parking it behind unrelated work in
+    // the shared queue. The deque is unbounded: blocking a consumer thread on
+    // backpressure here could deadlock the pool.
+    local->tasks.lock()->push_back(std::move(item));
+  } else {
+    queue_.enqueue(std::move(item));
+  }
   return sem_.post();
 }
 
 folly::CPUThreadPoolExecutor::CPUTask EdenTaskQueue::take() {
+  registerWorkerQueue();
   sem_.wait();
-  folly::CPUThreadPoolExecutor::CPUTask res;
-  queue_.dequeue(res);
-  return res;
+  return dequeueTask();
 }
 
 folly::Optional<folly::CPUThreadPoolExecutor::CPUTask>
 EdenTaskQueue::try_take_for(std::chrono::milliseconds time) {
+  registerWorkerQueue();
   if (!sem_.try_wait_for(time)) {
     return folly::none;
   }
-  folly::CPUThreadPoolExecutor::CPUTask res;
-  queue_.dequeue(res);
-  return res;
+  return dequeueTask();
 }
 
 size_t EdenTaskQueue::size() {
-  return queue_.size();
+  size_t size = queue_.size();
+  auto queues = workerQueues_.rlock();
+  for (const auto& queue : *queues) {
+    size += queue->tasks.lock()->size();
+  }
+  return size;
+}
+
+EdenTaskQueue::WorkerQueue& EdenTaskQueue::registerWorkerQueue() {
+  if (auto* local = *myWorkerQueue_) {
+    return *local;
+  }
+  auto owned = std::make_unique<WorkerQueue>();
+  auto* queue = owned.get();
+  workerQueues_.wlock()->push_back(std::move(owned));
+  *myWorkerQueue_ = queue;
+  return *queue;
+}
+
+folly::CPUThreadPoolExecutor::CPUTask EdenTaskQueue::dequeueTask() {
+  auto* local = *myWorkerQueue_;
+  while (true) {
+    // Newest local work first: it was spawned by the task this thread just
+    // ran, so its working set is the most likely to still be in cache.
+    if (local) {
+      auto tasks = local->tasks.lock();
+      if (!tasks->empty()) {
+        auto task = std::move(tasks->back());
+        tasks->pop_back();
+        return task;
+      }
+    }
+
+    folly::CPUThreadPoolExecutor::CPUTask task;
+    if (queue_.try_dequeue(task)) {
+      return task;
+    }
+
+    // Steal the oldest task from another thread's deque; the owner is
+    // working LIFO off the other end.
+    {
+      auto queues = workerQueues_.rlock();
+      for (const auto& victim : *queues) {
+        if (victim.get() == local) {
+          continue;
+        }
+        auto tasks = victim->tasks.lock();
+        if (!tasks->empty()) {
+          auto stolen = std::move(tasks->front());
+          tasks->pop_front();
+          return stolen;
+        }
+      }
+    }
+
+    // The semaphore guarantees a task exists somewhere, but a producer may
+    // not have finished publishing it yet; back off and rescan.
+    std::this_thread::yield();
+  }
 }
 
 } // namespace facebook::eden
@@ -5,6 +5,12 @@
  * GNU General Public License version 2.
  */
 
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <folly/Synchronized.h>
+#include <folly/ThreadLocal.h>
 #include <folly/concurrency/DynamicBoundedQueue.h>
 #include <folly/executors/CPUThreadPoolExecutor.h>
 
@@ -13,7 +19,13 @@ namespace facebook::eden {
 /**
  * Task queue that can be used to hold work needing to be processed.
  *
- * This is backed by a DMPMCQueue.
+ * Tasks enqueued from outside the pool land in a shared DMPMCQueue. Tasks
+ * enqueued by a pool thread - typically subtasks spawned while processing
+ * recursive work like diff, checkout, or glob - are instead pushed onto that
+ * thread's own deque and popped back off LIFO, so the thread keeps working
+ * on data it just touched while it is still warm in cache. An idle thread
+ * first drains its own deque, then the shared queue, and finally steals from
+ * the other threads' deques FIFO, taking their oldest (coldest) work.
  */
 class EdenTaskQueue
     : public folly::BlockingQueue<folly::CPUThreadPoolExecutor::CPUTask> {
@@ -33,8 +45,36 @@ class EdenTaskQueue
   size_t size() override;
 
  private:
+  struct WorkerQueue {
+    folly::Synchronized<
+        std::deque<folly::CPUThreadPoolExecutor::CPUTask>,
+        std::mutex>
+        tasks;
+  };
+
+  /**
+   * Returns the calling thread's WorkerQueue, registering one on first use.
+   * Only called from the consume paths, so producer-only threads never get a
+   * deque of their own and always feed the shared queue.
+   */
+  WorkerQueue& registerWorkerQueue();
+
+  /**
+   * Removes one task. Must only be called after acquiring sem_, which
+   * guarantees a task is visible in one of the queues.
+   */
+  folly::CPUThreadPoolExecutor::CPUTask dequeueTask();
+
   folly::LifoSem sem_;
   folly::DMPMCQueue<folly::CPUThreadPoolExecutor::CPUTask, true> queue_;
+
+  /**
+   * One deque per consumer thread. Entries are never removed: the deques
+   * must outlive their owning thread so the remaining work stays stealable.
+   */
+  folly::Synchronized<std::vector<std::unique_ptr<WorkerQueue>>>
+      workerQueues_;
+  folly::ThreadLocal<WorkerQueue*> myWorkerQueue_;
 };
 
 } // namespace facebook::eden
@@ -9,8 +9,13 @@
 
 #include <folly/Overload.h>
 #include <folly/futures/Future.h>
+#include <folly/json.h>
 #include <folly/logging/xlog.h>
 
+#include <cmath>
+
+#include "eden/fs/utils/Throw.h"
+
 using folly::SemiFuture;
 using folly::StringPiece;
 using folly::Unit;
@@ -22,6 +27,27 @@ FaultInjector::Fault::Fault(StringPiece regex, FaultBehavior&& b, size_t count)
       countRemaining(count),
       behavior(std::move(b)) {}
 
+std::chrono::milliseconds FaultInjector::RandomDelay::sample() {
+  double ms = 0.0;
+  switch (distribution) {
+    case DelayDistribution::Lognormal: {
+      // The median of a lognormal is e^mu, so mu = ln(median).
+      std::lognormal_distribution<double> dist{std::log(scaleMs), shape};
+      ms = dist(*rng);
+      break;
+    }
+    case DelayDistribution::Pareto: {
+      // Invert the Pareto CDF: x = scale / u^(1/alpha) with u in (0, 1].
+      std::uniform_real_distribution<double> uniform{0.0, 1.0};
+      auto u = 1.0 - uniform(*rng);
+      ms = scaleMs / std::pow(u, 1.0 / shape);
+      break;
+    }
+  }
+  return std::chrono::milliseconds{
+      std::lround(std::min(ms, double(maxDelay.count())))};
+}
+
 FaultInjector::FaultInjector(bool enabled) : enabled_{enabled} {}
 
 FaultInjector::~FaultInjector() {
@@ -55,6 +81,11 @@ SemiFuture<Unit> FaultInjector::checkAsyncImpl(
             }
             return folly::futures::sleep(delay.duration);
           },
+          [&](const FaultInjector::RandomDelay&) -> SemiFuture<Unit> {
+            // findFault() samples random delays and returns them as Delay.
+            XLOG(FATAL) << "RandomDelay escaped findFault: " << keyClass
+                        << ", " << keyValue;
+          },
           [&](const folly::exception_wrapper& error) {
             XLOG(DBG1) << "error fault hit: " << keyClass << ", " << keyValue;
             return folly::makeSemiFuture<Unit>(error);
@@ -82,6 +113,11 @@ void FaultInjector::checkImpl(StringPiece keyClass, StringPiece keyValue) {
               delay.error.value().throw_exception();
             }
           },
+          [&](const FaultInjector::RandomDelay&) {
+            // findFault() samples random delays and returns them as Delay.
+            XLOG(FATAL) << "RandomDelay escaped findFault: " << keyClass
+                        << ", " << keyValue;
+          },
           [&](const folly::exception_wrapper& error) {
             XLOG(DBG1) << "error fault hit: " << keyClass << ", " << keyValue;
             error.throw_exception();
@@ -122,6 +158,73 @@ void FaultInjector::injectDelay(
   injectFault(keyClass, keyValueRegex, Delay{duration}, count);
 }
 
+void FaultInjector::injectRandomDelay(
+    StringPiece keyClass,
+    StringPiece keyValueRegex,
+    DelayDistribution distribution,
+    double scaleMs,
+    double shape,
+    std::chrono::milliseconds maxDelay,
+    uint64_t seed,
+    size_t count) {
+  XLOG(INFO) << "injectRandomDelay(" << keyClass << ", " << keyValueRegex
+             << ", scaleMs=" << scaleMs << ", shape=" << shape
+             << ", seed=" << seed << ", count=" << count << ")";
+  injectFault(
+      keyClass,
+      keyValueRegex,
+      RandomDelay{
+          distribution,
+          scaleMs,
+          shape,
+          maxDelay,
+          std::make_shared<std::mt19937_64>(seed)},
+      count);
+}
+
+void FaultInjector::loadLatencyProfile(StringPiece profileJson) {
+  auto profile = folly::parseJson(profileJson);
+  uint64_t baseSeed = profile.getDefault("seed", 0).asInt();
+  auto* faults = profile.get_ptr("faults");
+  if (!faults || !faults->isArray()) {
+    throw_<std::invalid_argument>(
+        "latency profile has no \"faults\" array");
+  }
+
+  uint64_t index = 0;
+  for (const auto& entry : *faults) {
+    auto distributionName = entry["distribution"].asString();
+    DelayDistribution distribution;
+    double scaleMs;
+    double shape;
+    if (distributionName == "lognormal") {
+      distribution = DelayDistribution::Lognormal;
+      scaleMs = entry["medianMs"].asDouble();
+      shape = entry["sigma"].asDouble();
+    } else if (distributionName == "pareto") {
+      distribution = DelayDistribution::Pareto;
+      scaleMs = entry["scaleMs"].asDouble();
+      shape = entry["shape"].asDouble();
+    } else {
+      throwf<std::invalid_argument>(
+          "unknown latency distribution \"{}\"", distributionName);
+    }
+
+    injectRandomDelay(
+        entry["keyClass"].asString(),
+        entry.getDefault("keyValueRegex", ".*").asString(),
+        distribution,
+        scaleMs,
+        shape,
+        std::chrono::milliseconds{entry.getDefault("maxDelayMs", 10'000)
+                                      .asInt()},
+        // Offset the seed per entry so each fault draws an independent but
+        // still deterministic stream.
+        baseSeed + index++,
+        entry.getDefault("count", 0).asInt());
+  }
+}
+
 void FaultInjector::injectKill(
     StringPiece keyClass,
     StringPiece keyValueRegex,
@@ -266,6 +369,15 @@ FaultInjector::FaultBehavior FaultInjector::findFault(
         faultVector.erase(iter);
       }
     }
+    if (auto* randomDelay = std::get_if<RandomDelay>(&behavior)) {
+      // Sample while the state lock is held so that concurrent checks draw
+      // from the fault's engine deterministically, and hand the check paths
+      // a plain Delay.
+      auto duration = randomDelay->sample();
+      XLOG(DBG1) << "random delay fault sampled " << duration.count()
+                 << "ms: " << keyClass << ", " << keyValue;
+      return Delay{duration};
+    }
     return behavior;
   }
 
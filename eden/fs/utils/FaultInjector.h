@@ -13,7 +13,9 @@
 #include <folly/container/F14Map.h>
 #include <folly/futures/Future.h>
 #include <chrono>
+#include <memory>
 #include <optional>
+#include <random>
 #include <variant>
 
 namespace facebook::eden {
@@ -162,6 +164,68 @@ class FaultInjector {
       folly::StringPiece keyValueRegex,
       std::chrono::milliseconds duration,
       size_t count = 0);
+
+  /**
+   * The shape of the delay distribution used by injectRandomDelay().
+   */
+  enum class DelayDistribution {
+    Lognormal,
+    Pareto,
+  };
+
+  /**
+   * Inject a fault that delays each matching check for a duration drawn from
+   * a probability distribution, so tests can reproduce measured latency
+   * shapes (including the tail) rather than a single fixed delay.
+   *
+   * The parameters depend on the distribution:
+   *  - Lognormal: `scaleMs` is the median latency in milliseconds and
+   *    `shape` is sigma, the standard deviation of the underlying normal.
+   *  - Pareto: `scaleMs` is the minimum latency in milliseconds and `shape`
+   *    is alpha; smaller alpha means a heavier tail.
+   *
+   * Samples are capped at `maxDelay` so a heavy tail cannot stall a test
+   * run indefinitely. Each injected fault owns one random engine seeded
+   * with `seed`, so a given seed always produces the same delay sequence
+   * regardless of which threads hit the fault; the sequence is drawn under
+   * the injector's lock.
+   */
+  void injectRandomDelay(
+      folly::StringPiece keyClass,
+      folly::StringPiece keyValueRegex,
+      DelayDistribution distribution,
+      double scaleMs,
+      double shape,
+      std::chrono::milliseconds maxDelay,
+      uint64_t seed,
+      size_t count = 0);
+
+  /**
+   * Install the random-delay faults described by a latency profile.
+   *
+   * A profile is a JSON document, typically capturing latency distributions
+   * fitted to production measurements:
+   *
+   *   {
+   *     "seed": 42,
+   *     "faults": [
+   *       {"keyClass": "HgQueuedBackingStore::getBlob",
+   *        "keyValueRegex": ".*",
+   *        "distribution": "lognormal", "medianMs": 12, "sigma": 0.8,
+   *        "maxDelayMs": 5000},
+   *       {"keyClass": "HgQueuedBackingStore::getTree",
+   *        "distribution": "pareto", "scaleMs": 4, "shape": 1.5}
+   *     ]
+   *   }
+   *
+   * `keyValueRegex` defaults to ".*", `maxDelayMs` to 10000 and `count` to
+   * 0 (never expires). Each entry's engine is seeded with `seed` plus the
+   * entry's index, so the whole profile replays deterministically.
+   *
+   * Throws std::invalid_argument if the profile is malformed.
+   */
+  void loadLatencyProfile(folly::StringPiece profileJson);
+
   void injectDelayedError(
       folly::StringPiece keyClass,
       folly::StringPiece keyValueRegex,
@@ -233,12 +297,24 @@ class FaultInjector {
     std::chrono::milliseconds duration;
     std::optional<folly::exception_wrapper> error;
   };
+  struct RandomDelay {
+    DelayDistribution distribution;
+    double scaleMs;
+    double shape;
+    std::chrono::milliseconds maxDelay;
+    // Shared so copies of the behavior advance one deterministic sequence.
+    // Samples must only be drawn while holding the injector's state lock.
+    std::shared_ptr<std::mt19937_64> rng;
+
+    std::chrono::milliseconds sample();
+  };
   struct Kill {};
 
   using FaultBehavior = std::variant<
       folly::Unit, // no fault
       Block, // block until explicitly unblocked at a later point
       Delay, // delay for a specified amount of time
+      RandomDelay, // delay for a duration sampled from a distribution
       folly::exception_wrapper, // throw an exception
       Kill // exit the process ungracefully
       >;
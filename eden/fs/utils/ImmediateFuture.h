@@ -287,6 +287,37 @@ class ImmediateFuture {
   Kind kind_;
 };
 
+namespace detail {
+/**
+ * In-situ capacity of folly::Function on 64-bit platforms.
+ *
+ * The immediate path of an ImmediateFuture chain invokes continuations in
+ * place and never allocates for them. When a chain degrades to a SemiFuture,
+ * however, each continuation is stored in a folly::Function inside the
+ * future core; captures larger than this spill to a separate heap
+ * allocation per continuation.
+ */
+inline constexpr size_t kMaxInlineContinuationSize = 6 * sizeof(void*);
+} // namespace detail
+
+/**
+ * Statically assert that a continuation's captures stay within the given
+ * byte budget.
+ *
+ * Use at hot call sites to keep capture growth from silently adding a
+ * per-request heap allocation on the deferred path: hoist the lambda into a
+ * named variable, assert on it, then pass it to thenValue/thenTry. Prefer a
+ * budget of detail::kMaxInlineContinuationSize where the captures fit
+ * folly::Function's inline storage; for call sites that already exceed it,
+ * pin the current size so further growth is at least deliberate.
+ */
+#define EDEN_ASSERT_CONTINUATION_CAPTURE_LE(func, maxSize)   \
+  static_assert(                                             \
+      sizeof(func) <= (maxSize),                             \
+      #func " captures grew past its audited size budget; "  \
+            "large captures heap-allocate when the chain "   \
+            "degrades to a SemiFuture")
+
 /**
  * Exception thrown if the ImmediateFuture is used after being destroyed.
  */
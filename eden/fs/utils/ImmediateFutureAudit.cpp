@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/ImmediateFutureAudit.h"
+
+#include <folly/Synchronized.h>
+
+#include <memory>
+
+namespace facebook::eden {
+
+namespace {
+
+using Registry =
+    folly::Synchronized<std::vector<std::unique_ptr<detail::ImmediateFutureAuditEntry>>>;
+
+Registry& getRegistry() {
+  static auto* registry = new Registry{};
+  return *registry;
+}
+
+} // namespace
+
+detail::ImmediateFutureAuditEntry& ImmediateFutureAudit::entryFor(
+    SourceLocation location) {
+  auto entry = std::make_unique<detail::ImmediateFutureAuditEntry>(location);
+  auto* ptr = entry.get();
+  getRegistry().wlock()->push_back(std::move(entry));
+  return *ptr;
+}
+
+std::vector<ImmediateFutureAudit::Snapshot> ImmediateFutureAudit::snapshot() {
+  std::vector<Snapshot> result;
+  auto registry = getRegistry().rlock();
+  result.reserve(registry->size());
+  for (const auto& entry : *registry) {
+    result.push_back(Snapshot{
+        entry->location,
+        entry->immediateCount.load(std::memory_order_relaxed),
+        entry->semiCount.load(std::memory_order_relaxed)});
+  }
+  return result;
+}
+
+} // namespace facebook::eden
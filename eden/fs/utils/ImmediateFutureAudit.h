@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "eden/fs/utils/SourceLocation.h"
+
+namespace facebook::eden {
+
+namespace detail {
+
+/**
+ * Per-call-site counters for EDEN_AUDIT_IMMEDIATE_FUTURE. Entries are
+ * allocated once per call site and never freed, so references stay valid for
+ * the lifetime of the process.
+ */
+struct ImmediateFutureAuditEntry {
+  explicit ImmediateFutureAuditEntry(SourceLocation loc) : location{loc} {}
+
+  SourceLocation location;
+  std::atomic<uint64_t> immediateCount{0};
+  std::atomic<uint64_t> semiCount{0};
+};
+
+} // namespace detail
+
+/**
+ * Process-wide registry of ImmediateFuture call-site audits.
+ *
+ * ImmediateFuture is only a win if chains usually hold an immediate value;
+ * when a chain silently degrades to a SemiFuture it pays an allocation and an
+ * executor bounce per continuation. The audit makes that visible: wrap a
+ * future in EDEN_AUDIT_IMMEDIATE_FUTURE at a suspect call site and the
+ * registry will count, per site, how often the chain was immediate versus
+ * backed by a SemiFuture. Results are exported through the
+ * debugGetImmediateFutureAudit thrift call.
+ *
+ * Sampling costs one relaxed atomic increment after the first call, so it is
+ * safe to leave instrumentation in place on hot paths.
+ */
+class ImmediateFutureAudit {
+ public:
+  struct Snapshot {
+    SourceLocation location;
+    uint64_t immediateCount;
+    uint64_t semiCount;
+  };
+
+  /**
+   * Returns the counter entry for the given call site, registering it on
+   * first use. Intended to be called through EDEN_AUDIT_IMMEDIATE_FUTURE,
+   * which caches the result in a function-local static.
+   */
+  static detail::ImmediateFutureAuditEntry& entryFor(SourceLocation location);
+
+  /**
+   * Returns a copy of all registered call sites and their counters.
+   */
+  static std::vector<Snapshot> snapshot();
+};
+
+/**
+ * Records whether `fut` currently holds an immediate value or has degraded
+ * to a SemiFuture, attributed to this call site. `fut` is only inspected via
+ * isReady() and is not consumed.
+ */
+#define EDEN_AUDIT_IMMEDIATE_FUTURE(fut)                                \
+  do {                                                                  \
+    static auto& eden_ifAuditEntry =                                    \
+        ::facebook::eden::ImmediateFutureAudit::entryFor(               \
+            EDEN_CURRENT_SOURCE_LOCATION);                              \
+    if ((fut).isReady()) {                                              \
+      eden_ifAuditEntry.immediateCount.fetch_add(                       \
+          1, std::memory_order_relaxed);                                \
+    } else {                                                            \
+      eden_ifAuditEntry.semiCount.fetch_add(1, std::memory_order_relaxed); \
+    }                                                                   \
+  } while (0)
+
+} // namespace facebook::eden
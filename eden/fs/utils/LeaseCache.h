@@ -7,8 +7,11 @@
 
 #pragma once
 #include <folly/container/EvictingCacheMap.h>
+#include <folly/container/F14Map.h>
 #include <folly/futures/Future.h>
 #include <folly/futures/SharedPromise.h>
+#include <optional>
+#include <vector>
 
 namespace facebook::eden {
 
@@ -20,10 +23,55 @@ class LeaseCache {
   using SharedPromiseType = std::shared_ptr<folly::SharedPromise<ValuePtr>>;
   using FetchFunc = std::function<FutureType(const KEY& key)>;
 
+  /**
+   * Counters accumulated across get() and getBatch() calls. A hit means
+   * the caller inherited an existing lease (completed or still in
+   * flight); a miss means the call started a new fetch.
+   */
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    /**
+     * Leases started on behalf of each requester identity, for the
+     * callers that pass one. Requesters that only ever inherit existing
+     * leases do not appear here.
+     */
+    folly::F14FastMap<pid_t, uint64_t> leasesStartedByRequester;
+  };
+
  private:
   std::mutex lock_;
   folly::EvictingCacheMap<KEY, SharedPromiseType, HASH> cache_;
   FetchFunc fetcher_;
+  Stats stats_;
+
+  /**
+   * Look up or create the lease for key, recording stats. Returns the
+   * entry and whether this call created it (and therefore owns starting
+   * the fetch once the lock is dropped). The caller must hold lock_.
+   */
+  std::pair<SharedPromiseType, bool> leaseLocked(
+      const KEY& key,
+      std::optional<pid_t> requester) {
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+      ++stats_.hits;
+      return {it->second, false};
+    }
+
+    ++stats_.misses;
+    if (requester.has_value()) {
+      ++stats_.leasesStartedByRequester[*requester];
+    }
+    auto entry = std::make_shared<typename SharedPromiseType::element_type>();
+    cache_.set(key, entry);
+    return {std::move(entry), true};
+  }
+
+  void startFetch(const KEY& key, const SharedPromiseType& entry) {
+    fetcher_(key).thenTry(
+        [entry](folly::Try<ValuePtr>&& t) { entry->setTry(std::move(t)); });
+  }
 
  public:
   LeaseCache(size_t maxSize, FetchFunc fetcher, size_t clearSize = 1)
@@ -45,28 +93,61 @@ class LeaseCache {
     cache_.setMaxSize(size);
   }
 
-  FutureType get(const KEY& key) {
+  FutureType get(
+      const KEY& key,
+      std::optional<pid_t> requester = std::nullopt) {
     SharedPromiseType entry;
+    bool started;
 
     {
       std::lock_guard<std::mutex> g(lock_);
+      std::tie(entry, started) = leaseLocked(key, requester);
+    }
 
-      auto it = cache_.find(key);
-      if (it != cache_.end()) {
-        entry = it->second;
-        return entry->getFuture();
-      }
+    auto future = entry->getFuture();
+    if (started) {
+      startFetch(key, entry);
+    }
+    return future;
+  }
+
+  /**
+   * Lease every key in keys with a single pass under the lock, returning
+   * one future per key in the same order. Keys with an existing lease
+   * inherit it; fetches for the rest are started only after the lock is
+   * released, so a slow fetcher cannot hold up concurrent callers. This
+   * is meant for wide enumeration (e.g. readdirplus attribute batches)
+   * where taking the lock once per key adds up.
+   */
+  std::vector<FutureType> getBatch(
+      const std::vector<KEY>& keys,
+      std::optional<pid_t> requester = std::nullopt) {
+    std::vector<FutureType> futures;
+    futures.reserve(keys.size());
+    std::vector<std::pair<KEY, SharedPromiseType>> started;
 
-      entry = std::make_shared<typename SharedPromiseType::element_type>();
-      cache_.set(key, entry);
+    {
+      std::lock_guard<std::mutex> g(lock_);
+      for (const auto& key : keys) {
+        auto [entry, isNew] = leaseLocked(key, requester);
+        futures.push_back(entry->getFuture());
+        if (isNew) {
+          started.emplace_back(key, std::move(entry));
+        }
+      }
     }
 
-    auto future = entry->getFuture();
+    for (auto& [key, entry] : started) {
+      startFetch(key, entry);
+    }
 
-    fetcher_(key).thenTry(
-        [entry](folly::Try<ValuePtr>&& t) { entry->setTry(std::move(t)); });
+    return futures;
+  }
 
-    return future;
+  /** Returns a snapshot of the hit/miss and per-requester counters. */
+  Stats getStats() {
+    std::lock_guard<std::mutex> g(lock_);
+    return stats_;
   }
 
   bool exists(const KEY& key) {
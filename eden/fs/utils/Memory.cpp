@@ -9,9 +9,170 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <array>
+#include <new>
+
+#include <fmt/format.h>
+#include <folly/logging/xlog.h>
+#include <folly/memory/Malloc.h>
 
 namespace facebook::eden {
 
+namespace {
+
+/**
+ * These mirror jemalloc's stable MALLOCX_* ABI encodings. jemalloc is an
+ * optional runtime dependency discovered through folly's weak symbols, so
+ * its header is not available to include here.
+ */
+int mallocxArenaFlag(unsigned arenaIndex) {
+  return static_cast<int>((arenaIndex + 1) << 20);
+}
+
+/**
+ * MALLOCX_TCACHE(-1): bypass the thread cache so every allocation is
+ * attributed to its arena rather than to whichever arena last refilled the
+ * calling thread's cache bin.
+ */
+constexpr int kMallocxTcacheNone = 0x100;
+
+struct ArenaTable {
+  bool enabled = false;
+  std::array<unsigned, kMemoryArenaCount> arenaIndex{};
+
+  ArenaTable() {
+    if (!folly::usingJEMalloc() || !mallctl || !mallocx || !dallocx) {
+      return;
+    }
+    for (auto& index : arenaIndex) {
+      size_t indexLen = sizeof(index);
+      if (mallctl("arenas.create", &index, &indexLen, nullptr, 0) != 0) {
+        XLOG(WARN)
+            << "unable to create jemalloc arenas; per-subsystem memory "
+               "attribution is disabled";
+        return;
+      }
+    }
+    enabled = true;
+  }
+};
+
+ArenaTable& arenaTable() {
+  static ArenaTable table;
+  return table;
+}
+
+template <typename T>
+bool readMallctlStat(const std::string& name, T& out) {
+  size_t outLen = sizeof(out);
+  return mallctl(name.c_str(), &out, &outLen, nullptr, 0) == 0;
+}
+
+} // namespace
+
+folly::StringPiece memoryArenaName(MemoryArena arena) {
+  switch (arena) {
+    case MemoryArena::BlobData:
+      return "blob_data";
+    case MemoryArena::TreeData:
+      return "tree_data";
+    case MemoryArena::Thrift:
+      return "thrift";
+  }
+  return "unknown";
+}
+
+void* arenaMalloc(MemoryArena arena, size_t size) {
+  auto& table = arenaTable();
+  // jemalloc rejects zero-sized mallocx calls.
+  size = std::max<size_t>(size, 1);
+  void* ptr;
+  if (table.enabled) {
+    ptr = mallocx(
+        size,
+        mallocxArenaFlag(table.arenaIndex[static_cast<unsigned>(arena)]) |
+            kMallocxTcacheNone);
+  } else {
+    ptr = malloc(size);
+  }
+  if (!ptr) {
+    throw std::bad_alloc{};
+  }
+  return ptr;
+}
+
+void arenaFree(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  if (arenaTable().enabled) {
+    dallocx(ptr, kMallocxTcacheNone);
+  } else {
+    free(ptr);
+  }
+}
+
+folly::IOBuf newArenaIOBuf(MemoryArena arena, size_t capacity) {
+  if (!arenaTable().enabled) {
+    return folly::IOBuf{folly::IOBuf::CREATE, capacity};
+  }
+  void* ptr = arenaMalloc(arena, capacity);
+  return folly::IOBuf{
+      folly::IOBuf::TAKE_OWNERSHIP,
+      ptr,
+      capacity,
+      0, // start empty; the caller appends as it fills the buffer
+      [](void* buf, void*) { arenaFree(buf); },
+      nullptr};
+}
+
+std::vector<ArenaStats> getMemoryArenaStats() {
+  auto& table = arenaTable();
+  std::vector<ArenaStats> results;
+  results.reserve(kMemoryArenaCount);
+
+  size_t pageSize = 0;
+  if (table.enabled) {
+    // jemalloc only refreshes its stats when the epoch is advanced.
+    uint64_t epoch = 1;
+    size_t epochLen = sizeof(epoch);
+    mallctl("epoch", &epoch, &epochLen, &epoch, sizeof(epoch));
+    readMallctlStat("arenas.page", pageSize);
+  }
+
+  for (unsigned i = 0; i < kMemoryArenaCount; ++i) {
+    auto& stats = results.emplace_back();
+    stats.name = memoryArenaName(static_cast<MemoryArena>(i)).str();
+    if (!table.enabled) {
+      continue;
+    }
+    auto index = table.arenaIndex[i];
+    size_t smallAllocated = 0;
+    size_t largeAllocated = 0;
+    size_t activePages = 0;
+    size_t mapped = 0;
+    bool ok = readMallctlStat(
+        fmt::format("stats.arenas.{}.small.allocated", index),
+        smallAllocated);
+    ok = readMallctlStat(
+             fmt::format("stats.arenas.{}.large.allocated", index),
+             largeAllocated) &&
+        ok;
+    ok = readMallctlStat(
+             fmt::format("stats.arenas.{}.pactive", index), activePages) &&
+        ok;
+    ok = readMallctlStat(
+             fmt::format("stats.arenas.{}.mapped", index), mapped) &&
+        ok;
+    stats.supported = ok;
+    stats.allocatedBytes = smallAllocated + largeAllocated;
+    stats.activeBytes = activePages * pageSize;
+    stats.mappedBytes = mapped;
+  }
+  return results;
+}
+
 void assertZeroBits(const void* memory, size_t size) {
   if (0 == size) {
     return;
@@ -7,8 +7,12 @@
 
 #pragma once
 #include <folly/FBString.h>
+#include <folly/Range.h>
+#include <folly/io/IOBuf.h>
+#include <cstdint>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace facebook::eden {
 
@@ -18,6 +22,65 @@ namespace facebook::eden {
  */
 void assertZeroBits(const void* memory, size_t size);
 
+/**
+ * Subsystems whose heap usage is attributed separately.
+ *
+ * When the process runs under jemalloc, each value maps to a dedicated
+ * allocator arena, so the bytes (and the fragmentation) each subsystem is
+ * responsible for show up in getMemoryArenaStats() instead of blurring into
+ * one process-wide heap. Without jemalloc the allocation helpers fall back
+ * to the regular heap and the stats report supported=false.
+ */
+enum class MemoryArena : unsigned {
+  /** Blob payload buffers, e.g. the contents held by the BlobCache. */
+  BlobData,
+  /** Tree and inode metadata buffers. */
+  TreeData,
+  /** Buffers built while assembling Thrift responses. */
+  Thrift,
+};
+
+constexpr unsigned kMemoryArenaCount = 3;
+
+folly::StringPiece memoryArenaName(MemoryArena arena);
+
+/**
+ * Allocates `size` bytes from the subsystem's arena. Throws std::bad_alloc
+ * on failure. The returned memory must be released with arenaFree().
+ */
+void* arenaMalloc(MemoryArena arena, size_t size);
+
+/** Frees memory obtained from arenaMalloc(), regardless of arena. */
+void arenaFree(void* ptr);
+
+/**
+ * Creates an empty IOBuf with `capacity` writable bytes whose storage comes
+ * from the subsystem's arena. Behaves like IOBuf{CREATE, capacity} when
+ * arenas are unavailable.
+ */
+folly::IOBuf newArenaIOBuf(MemoryArena arena, size_t capacity);
+
+struct ArenaStats {
+  std::string name;
+  /**
+   * False when the process is not running under jemalloc (or arena creation
+   * failed); the byte counts are meaningless in that case.
+   */
+  bool supported = false;
+  /** Bytes in live allocations. */
+  uint64_t allocatedBytes = 0;
+  /** Bytes in active pages; the gap to allocatedBytes is fragmentation. */
+  uint64_t activeBytes = 0;
+  /** Bytes of address space mapped by the arena. */
+  uint64_t mappedBytes = 0;
+};
+
+/**
+ * Snapshot of allocator stats for every subsystem arena, in MemoryArena
+ * order.
+ */
+std::vector<ArenaStats> getMemoryArenaStats();
+
 template <typename T>
 void assertZeroBits(const T& value) {
   assertZeroBits(&value, sizeof(T));
@@ -22,6 +22,7 @@
 #include <type_traits>
 
 #include "eden/common/utils/StringConv.h"
+#include "eden/fs/utils/AsciiCaseFold.h"
 #include "eden/fs/utils/CaseSensitivity.h"
 #include "eden/fs/utils/String.h"
 #include "eden/fs/utils/Throw.h"
@@ -252,21 +253,6 @@ enum class CompareResult {
   AFTER,
 };
 
-struct AsciiLessThanCaseInsensitive {
-  static char toLower(char c) {
-    if (c >= 'A' && c <= 'Z') {
-      c += 'a' - 'A';
-    }
-    return c;
-  }
-
-  bool operator()(char lhs, char rhs) const {
-    lhs = toLower(lhs);
-    rhs = toLower(rhs);
-    return lhs < rhs;
-  }
-};
-
 namespace detail {
 
 // Helper for equality testing, borrowed from
@@ -331,12 +317,8 @@ struct PathOperators {
           if (caseSensitive == CaseSensitivity::Sensitive) {
             return leftStringPiece < rightStringPiece;
           } else {
-            return std::lexicographical_compare(
-                leftStringPiece.begin(),
-                leftStringPiece.end(),
-                rightStringPiece.begin(),
-                rightStringPiece.end(),
-                AsciiLessThanCaseInsensitive{});
+            return compareAsciiIgnoreCase(leftStringPiece, rightStringPiece) <
+                0;
           }
         }
 
@@ -357,12 +339,7 @@ struct PathOperators {
       if (caseSensitive == CaseSensitivity::Sensitive) {
         return leftStringPiece < rightStringPiece;
       } else {
-        return std::lexicographical_compare(
-            leftStringPiece.begin(),
-            leftStringPiece.end(),
-            rightStringPiece.begin(),
-            rightStringPiece.end(),
-            AsciiLessThanCaseInsensitive{});
+        return compareAsciiIgnoreCase(leftStringPiece, rightStringPiece) < 0;
       }
     }
   }
@@ -401,12 +378,7 @@ struct PathOperators {
           if (caseSensitive == CaseSensitivity::Sensitive) {
             return leftStringPiece == rightStringPiece;
           } else {
-            return std::equal(
-                leftStringPiece.begin(),
-                leftStringPiece.end(),
-                rightStringPiece.begin(),
-                rightStringPiece.end(),
-                folly::AsciiCaseInsensitive{});
+            return equalsAsciiIgnoreCase(leftStringPiece, rightStringPiece);
           }
         }
 
@@ -427,12 +399,7 @@ struct PathOperators {
       if (caseSensitive == CaseSensitivity::Sensitive) {
         return leftStringPiece == rightStringPiece;
       } else {
-        return std::equal(
-            leftStringPiece.begin(),
-            leftStringPiece.end(),
-            rightStringPiece.begin(),
-            rightStringPiece.end(),
-            folly::AsciiCaseInsensitive{});
+        return equalsAsciiIgnoreCase(leftStringPiece, rightStringPiece);
       }
     }
   }
@@ -1970,6 +1937,32 @@ std::ostream& operator<<(
 
 } // namespace detail
 
+/**
+ * Hash functor for hashed containers keyed on one of the path types whose
+ * equality must respect a CaseSensitivity.
+ *
+ * When constructed as case insensitive the hash is computed over the
+ * ASCII-case-folded bytes, so two paths for which isPathPieceEqual() returns
+ * true also hash to the same value.  The case sensitive flavor matches the
+ * plain hash_value() above.
+ */
+struct CaseAwarePathHash {
+  explicit CaseAwarePathHash(CaseSensitivity caseSensitive)
+      : caseSensitive_{caseSensitive} {}
+
+  template <typename Path>
+  size_t operator()(const Path& path) const {
+    auto s = path.view();
+    if (caseSensitive_ == CaseSensitivity::Insensitive) {
+      return hashAsciiIgnoreCase(s);
+    }
+    return folly::hash::SpookyHashV2::Hash64(s.data(), s.size(), 0);
+  }
+
+ private:
+  CaseSensitivity caseSensitive_;
+};
+
 // I'm not really a fan of operator overloading, but these
 // are reasonably clear in intent; the `+` operator can be used
 // to compose certain of the path types together in certain,
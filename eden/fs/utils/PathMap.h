@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <functional>
 #include <iterator>
+#include <memory>
 #include <utility>
 #include "eden/fs/utils/CaseSensitivity.h"
 #include "eden/fs/utils/PathFuncs.h"
@@ -31,13 +32,17 @@ namespace facebook::eden {
  *   it is better to pre-sort the data to be inserted.
  * - Since insert and erase operations move the vector contents around,
  *   those operations invalidate iterators.
+ * - The storage can be placed with a custom allocator via the Allocator
+ *   template parameter, which is forwarded to the underlying vector.
  */
-template <typename Value, typename Key = PathComponent>
-class PathMap : private folly::fbvector<std::pair<Key, Value>> {
+template <
+    typename Value,
+    typename Key = PathComponent,
+    typename Allocator = std::allocator<std::pair<Key, Value>>>
+class PathMap : private folly::fbvector<std::pair<Key, Value>, Allocator> {
   using Pair = std::pair<Key, Value>;
-  using Vector = folly::fbvector<Pair>;
+  using Vector = folly::fbvector<Pair, Allocator>;
   using Piece = typename Key::piece_type;
-  using Allocator = typename Vector::allocator_type;
 
   // Comparator that knows how compare Stored and Piece in the vector.
   struct Compare {
@@ -77,6 +82,44 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
     CaseSensitivity caseSensitive_{kPathMapDefaultCaseSensitive};
   };
 
+  // Comparison kernel with the case sensitivity baked in at compile time.
+  // lower_bound tests the map's sensitivity once and runs the whole binary
+  // search with one of these, so the comparisons inside the loop compile
+  // down to a plain memcmp-style compare (or the case-folding compare)
+  // instead of re-branching on the mode for every probe.
+  template <CaseSensitivity CS>
+  struct CompareAs {
+    // Compare two values that are convertible to the Piece type.
+    template <typename A, typename B>
+    typename std::enable_if<
+        std::is_convertible<A, Piece>::value &&
+            std::is_convertible<B, Piece>::value,
+        bool>::type
+    operator()(const A& a, const B& b) const {
+      return isPathPieceLess(Piece(a), Piece(b), CS);
+    }
+
+    // Compare a Piece-convertible value against the stored Pair.
+    template <typename A, typename B, typename C>
+    typename std::enable_if<
+        std::is_convertible<A, Piece>::value &&
+            std::is_convertible<B, Piece>::value,
+        bool>::type
+    operator()(const A& a, const std::pair<B, C>& rhs) const {
+      return isPathPieceLess(Piece(a), Piece(rhs.first), CS);
+    }
+
+    // Compare the stored Pair against a Piece-convertible value.
+    template <typename A, typename B, typename C>
+    typename std::enable_if<
+        std::is_convertible<A, Piece>::value &&
+            std::is_convertible<B, Piece>::value,
+        bool>::type
+    operator()(const std::pair<A, C>& lhs, const B& b) const {
+      return isPathPieceLess(Piece(lhs.first), Piece(b), CS);
+    }
+  };
+
   // Hold an instance of the comparator.
   Compare compare_;
 
@@ -99,27 +142,39 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
   using const_reverse_iterator = typename Vector::const_reverse_iterator;
 
   // Construct empty.
-  explicit PathMap(CaseSensitivity caseSensitive) : compare_(caseSensitive) {}
+  explicit PathMap(
+      CaseSensitivity caseSensitive,
+      const Allocator& alloc = Allocator())
+      : Vector(alloc), compare_(caseSensitive) {}
 
   // Populate from an initializer_list.
-  PathMap(std::initializer_list<value_type> init, CaseSensitivity caseSensitive)
-      : PathMap(init.begin(), init.end(), caseSensitive) {}
+  PathMap(
+      std::initializer_list<value_type> init,
+      CaseSensitivity caseSensitive,
+      const Allocator& alloc = Allocator())
+      : PathMap(init.begin(), init.end(), caseSensitive, alloc) {}
 
   // Populate from a pair of input iterators.
   template <typename InputIterator>
   PathMap(
       InputIterator first,
       InputIterator last,
-      CaseSensitivity caseSensitive)
-      : compare_(caseSensitive) {
+      CaseSensitivity caseSensitive,
+      const Allocator& alloc = Allocator())
+      : Vector(alloc), compare_(caseSensitive) {
     // The std::distance call is O(1) if the iterators are random-access, but
     // O(n) otherwise.  We're fine with the O(n) on the basis that if n is large
     // enough to matter, the cost of iterating will be dwarfed by the cost
     // of growing the storage several times during population.
     this->reserve(std::distance(first, last));
     for (; first != last; ++first) {
-      insert(*first);
+      Vector::emplace_back(*first);
     }
+    // Appending everything and sorting once is O(n log n); n ordered
+    // inserts are O(n^2) when the input order disagrees with ours, which
+    // is common for case insensitive maps fed case sensitively sorted
+    // data. Duplicate handling matches insert(): the earliest entry wins.
+    sortAndDedupe();
   }
 
   // Inherit the underlying vector copy/assignment.
@@ -148,6 +203,7 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
   using Vector::empty;
   using Vector::end;
   using Vector::erase;
+  using Vector::get_allocator;
   using Vector::max_size;
   using Vector::rbegin;
   using Vector::rend;
@@ -168,11 +224,21 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
    * case sensitive search.
    */
   iterator lower_bound(Piece key) {
-    return std::lower_bound(begin(), end(), key, compare_);
+    if (compare_.caseSensitive_ == CaseSensitivity::Sensitive) {
+      return std::lower_bound(
+          begin(), end(), key, CompareAs<CaseSensitivity::Sensitive>{});
+    }
+    return std::lower_bound(
+        begin(), end(), key, CompareAs<CaseSensitivity::Insensitive>{});
   }
 
   const_iterator lower_bound(Piece key) const {
-    return std::lower_bound(begin(), end(), key, compare_);
+    if (compare_.caseSensitive_ == CaseSensitivity::Sensitive) {
+      return std::lower_bound(
+          begin(), end(), key, CompareAs<CaseSensitivity::Sensitive>{});
+    }
+    return std::lower_bound(
+        begin(), end(), key, CompareAs<CaseSensitivity::Insensitive>{});
   }
 
   /** Find using the Piece representation of a key.
@@ -236,6 +302,34 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
     return std::make_pair(iter, true);
   }
 
+  /** Append a key-value pair to the end of the storage without searching
+   * for its sorted position. The args are forwarded to the Value
+   * constructor.
+   *
+   * This suspends the map's ordering invariant: no lookups, ordered
+   * inserts or erases may run until a matching sortAndDedupe() call
+   * restores it. Intended for bulk rebuilds, where appending every entry
+   * and sorting once is O(n log n) while n ordered inserts degrade to
+   * O(n^2) when the input order disagrees with the map's. */
+  template <typename... Args>
+  void unsortedAppend(Piece key, Args&&... args) {
+    Vector::emplace_back(
+        std::make_pair(Key(key), Value(std::forward<Args>(args)...)));
+  }
+
+  /** Restore the ordering invariant after a run of unsortedAppend() calls
+   * with one sort followed by a single linear dedupe pass.
+   *
+   * When entries collide (equal keys under the map's case sensitivity),
+   * the earliest appended entry wins, matching insert()'s treatment of
+   * duplicate keys. Returns the number of colliding entries dropped. */
+  size_type sortAndDedupe() {
+    if (compare_.caseSensitive_ == CaseSensitivity::Sensitive) {
+      return sortAndDedupeAs<CaseSensitivity::Sensitive>();
+    }
+    return sortAndDedupeAs<CaseSensitivity::Insensitive>();
+  }
+
   /** Returns a reference to the map position for key, creating it needed.
    * If the key is already present, no additional allocations are performed. */
   mapped_type& operator[](Piece key) {
@@ -301,31 +395,54 @@ class PathMap : private folly::fbvector<std::pair<Key, Value>> {
     return compare_.caseSensitive_;
   }
 
+ private:
+  template <CaseSensitivity CS>
+  size_type sortAndDedupeAs() {
+    const CompareAs<CS> compare{};
+    // stable_sort keeps colliding keys in append order, so std::unique
+    // retains the earliest appended entry of each colliding run.
+    std::stable_sort(begin(), end(), [&](const Pair& a, const Pair& b) {
+      return compare(a.first, b.first);
+    });
+    const auto last =
+        std::unique(begin(), end(), [&](const Pair& a, const Pair& b) {
+          return !compare(a.first, b.first) && !compare(b.first, a.first);
+        });
+    const auto removed = static_cast<size_type>(std::distance(last, end()));
+    Vector::erase(last, end());
+    return removed;
+  }
+
+ public:
   /// Equality operator.
-  template <typename V, typename K>
-  friend bool operator==(const PathMap<V, K>& lhs, const PathMap<V, K>& rhs);
+  template <typename V, typename K, typename A>
+  friend bool operator==(
+      const PathMap<V, K, A>& lhs,
+      const PathMap<V, K, A>& rhs);
 
   /// Inequality operator.
-  template <typename V, typename K>
-  friend bool operator!=(const PathMap<V, K>& lhs, const PathMap<V, K>& rhs);
+  template <typename V, typename K, typename A>
+  friend bool operator!=(
+      const PathMap<V, K, A>& lhs,
+      const PathMap<V, K, A>& rhs);
 };
 
 // Implementations of the equality operators; gcc hates us if we
 // define them inline in the class above.
 
 /// Equality operator.
-template <typename V, typename K>
-bool operator==(const PathMap<V, K>& lhs, const PathMap<V, K>& rhs) {
+template <typename V, typename K, typename A>
+bool operator==(const PathMap<V, K, A>& lhs, const PathMap<V, K, A>& rhs) {
   // reinterpret lhs as the underlying vector type.
-  const folly::fbvector<std::pair<K, V>>& vector = lhs;
+  const folly::fbvector<std::pair<K, V>, A>& vector = lhs;
   return vector == rhs;
 }
 
 /// Inequality operator.
-template <typename V, typename K>
-bool operator!=(const PathMap<V, K>& lhs, const PathMap<V, K>& rhs) {
+template <typename V, typename K, typename A>
+bool operator!=(const PathMap<V, K, A>& lhs, const PathMap<V, K, A>& rhs) {
   // reinterpret lhs as the underlying vector type.
-  const folly::fbvector<std::pair<K, V>>& vector = lhs;
+  const folly::fbvector<std::pair<K, V>, A>& vector = lhs;
   return vector != rhs;
 }
 } // namespace facebook::eden
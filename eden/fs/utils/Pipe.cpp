@@ -67,6 +67,16 @@ Pipe::Pipe(bool nonBlocking) {
 #endif
 }
 
+void Pipe::expandBufferSize(size_t size) {
+#ifdef F_SETPIPE_SZ
+  // Sizing either end resizes the pipe object itself. Failure is fine;
+  // the pipe simply keeps the default (usually 64KiB) capacity.
+  ::fcntl(read.fd(), F_SETPIPE_SZ, static_cast<int>(size));
+#else
+  (void)size;
+#endif
+}
+
 SocketPair::SocketPair(bool nonBlocking) {
   FileDescriptor::system_handle_type pair[2];
 #ifdef _WIN32
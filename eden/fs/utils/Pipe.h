@@ -15,6 +15,16 @@ struct Pipe {
   FileDescriptor write;
 
   explicit Pipe(bool nonBlocking = false);
+
+  /**
+   * Best-effort request to grow the kernel buffer of this pipe to `size`
+   * bytes. A larger buffer lets a fast writer run further ahead of the
+   * reader before blocking, which matters for high-volume streams like the
+   * hg importer data channel. The kernel may refuse (fs.pipe-max-size,
+   * privilege limits) or not support resizing at all; the pipe keeps its
+   * default capacity in that case.
+   */
+  void expandBufferSize(size_t size);
 };
 
 struct SocketPair {
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <thread>
+
+#include <folly/concurrency/UnboundedQueue.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/synchronization/LifoSem.h>
+
+namespace facebook::eden {
+
+/**
+ * Unbounded task queue with a small number of priority lanes, used by
+ * UnboundedQueueExecutor so CPU work submitted on behalf of interactive
+ * requests can jump ahead of already-queued background work like diff and
+ * prefetch evaluation.
+ *
+ * Consumers always drain the highest-priority lane first. Every lane is
+ * unbounded, so add() never blocks: parts of Eden rely on enqueueing being
+ * non-blocking for deadlock safety.
+ */
+class PriorityTaskQueue
+    : public folly::BlockingQueue<folly::CPUThreadPoolExecutor::CPUTask> {
+  using CPUTask = folly::CPUThreadPoolExecutor::CPUTask;
+
+ public:
+  static constexpr size_t kNumLanes = 3;
+
+  folly::BlockingQueueAddResult add(CPUTask item) override {
+    return addWithPriority(std::move(item), folly::Executor::MID_PRI);
+  }
+
+  folly::BlockingQueueAddResult addWithPriority(CPUTask item, int8_t priority)
+      override {
+    lanes_[laneForPriority(priority)].queue.enqueue(std::move(item));
+    return sem_.post();
+  }
+
+  uint8_t getNumPriorities() override {
+    return kNumLanes;
+  }
+
+  CPUTask take() override {
+    sem_.wait();
+    return dequeueTask();
+  }
+
+  folly::Optional<CPUTask> try_take_for(
+      std::chrono::milliseconds time) override {
+    if (!sem_.try_wait_for(time)) {
+      return folly::none;
+    }
+    return dequeueTask();
+  }
+
+  size_t size() override {
+    size_t size = 0;
+    for (const auto& lane : lanes_) {
+      size += lane.queue.size();
+    }
+    return size;
+  }
+
+  /**
+   * Number of tasks waiting in the given lane. Lane 0 is the lowest
+   * priority.
+   */
+  size_t laneSize(size_t lane) const {
+    return lanes_[lane].queue.size();
+  }
+
+ private:
+  struct Lane {
+    folly::UMPMCQueue<CPUTask, /*MayBlock=*/false> queue;
+  };
+
+  /**
+   * Same translation folly's priority queues use: negative priorities
+   * select lanes below the middle one, positive above, saturating at the
+   * ends. So LO_PRI, MID_PRI and HI_PRI map to lanes 0, 1 and 2.
+   */
+  static size_t laneForPriority(int8_t priority) {
+    constexpr int kMid = static_cast<int>(kNumLanes) / 2;
+    auto lane = kMid + static_cast<int>(priority);
+    return static_cast<size_t>(
+        std::max(0, std::min(static_cast<int>(kNumLanes) - 1, lane)));
+  }
+
+  /**
+   * Removes one task, preferring the highest-priority lane. Must only be
+   * called after acquiring sem_, which guarantees a task is visible in one
+   * of the lanes.
+   */
+  CPUTask dequeueTask() {
+    while (true) {
+      for (size_t lane = kNumLanes; lane-- > 0;) {
+        CPUTask task;
+        if (lanes_[lane].queue.try_dequeue(task)) {
+          return task;
+        }
+      }
+      // The semaphore guarantees a task exists somewhere, but its producer
+      // may not have finished publishing it yet; back off and rescan.
+      std::this_thread::yield();
+    }
+  }
+
+  folly::LifoSem sem_;
+  std::array<Lane, kNumLanes> lanes_;
+};
+
+} // namespace facebook::eden
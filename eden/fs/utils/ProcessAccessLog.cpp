@@ -53,6 +53,18 @@ struct ThreadLocalBucket {
     return isNewPid;
   }
 
+  bool add(
+      uint64_t secondsSinceStart,
+      pid_t pid,
+      ProcessAccessLog::AccessType type,
+      size_t bytes) {
+    auto state = state_.lock();
+
+    bool isNewPid = false;
+    state->buckets.add(secondsSinceStart, pid, isNewPid, type, bytes);
+    return isNewPid;
+  }
+
   void mergeUpstream() {
     auto state = state_.lock();
     if (!state->owner) {
@@ -119,6 +131,48 @@ void ProcessAccessLog::Bucket::add(
   isNewPid = contains;
 }
 
+void ProcessAccessLog::Bucket::add(
+    pid_t pid,
+    bool& isNewPid,
+    ProcessAccessLog::AccessType type,
+    size_t bytes) {
+  auto [it, contains] = accessCountsByPid.emplace(pid, PerBucketAccessCounts{});
+  switch (type) {
+    case AccessType::FsChannelRead:
+      it->second.bytesRead += bytes;
+      break;
+    case AccessType::FsChannelWrite:
+      it->second.bytesWritten += bytes;
+      break;
+    default:
+      XLOG(DFATAL) << "recordBytes called with access type "
+                   << enumValue(type);
+      break;
+  }
+  isNewPid = contains;
+}
+
+void ProcessAccessLog::OperationBucket::add(AccessType type) {
+  auto idx = enumValue(type);
+  XDCHECK_LT(idx, enumValue(AccessType::Last));
+  counts[idx].fetch_add(1, std::memory_order_relaxed);
+}
+
+void ProcessAccessLog::OperationBucket::clear() {
+  for (auto& count : counts) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+ProcessAccessLog::OperationBucket::Value ProcessAccessLog::OperationBucket::
+    load() const {
+  Value value{};
+  for (size_t i = 0; i < value.size(); ++i) {
+    value[i] = counts[i].load(std::memory_order_relaxed);
+  }
+  return value;
+}
+
 void ProcessAccessLog::Bucket::merge(const Bucket& other) {
   for (auto [pid, otherAccessCounts] : other.accessCountsByPid) {
     for (std::underlying_type_t<AccessType> type = 0;
@@ -127,6 +181,8 @@ void ProcessAccessLog::Bucket::merge(const Bucket& other) {
       accessCountsByPid[pid].counts[type] += otherAccessCounts.counts[type];
     }
     accessCountsByPid[pid].duration += otherAccessCounts.duration;
+    accessCountsByPid[pid].bytesRead += otherAccessCounts.bytesRead;
+    accessCountsByPid[pid].bytesWritten += otherAccessCounts.bytesWritten;
   }
 }
 
@@ -160,11 +216,18 @@ uint64_t ProcessAccessLog::getSecondsSinceEpoch() {
 void ProcessAccessLog::recordAccess(
     pid_t pid,
     ProcessAccessLog::AccessType type) {
+  auto now = getSecondsSinceEpoch();
+
   // This function is called very frequently from different threads. It's a
   // write-often, read-rarely use case, so, to avoid synchronization overhead,
   // record to thread-local storage and only merge into the access log when the
   // calling thread dies or when the data must be read.
-  bool isNewPid = getTlb()->add(getSecondsSinceEpoch(), pid, type);
+  bool isNewPid = getTlb()->add(now, pid, type);
+
+  // The aggregate per-type counts have no per-pid map to maintain, so they go
+  // straight to a shared lock-free log instead of through the thread-local
+  // buckets.
+  operationCounts_.add(now, type);
 
   // Many processes are short-lived, so grab the executable name during the
   // access. We could potentially get away with grabbing executable names a
@@ -193,6 +256,36 @@ void ProcessAccessLog::recordDuration(
   }
 }
 
+void ProcessAccessLog::recordBytes(
+    pid_t pid,
+    ProcessAccessLog::AccessType type,
+    size_t bytes) {
+  bool isNewPid = getTlb()->add(getSecondsSinceEpoch(), pid, type, bytes);
+  if (pid != 0 && isNewPid) {
+    processNameCache_->add(pid);
+  }
+}
+
+std::array<uint64_t, enumValue(ProcessAccessLog::AccessType::Last)>
+ProcessAccessLog::getOperationCounts(std::chrono::seconds lastNSeconds) {
+  std::array<uint64_t, enumValue(AccessType::Last)> totals{};
+  auto secondCount = lastNSeconds.count();
+  if (secondCount < 0) {
+    return totals;
+  }
+
+  auto allBuckets = operationCounts_.getAll(getSecondsSinceEpoch());
+  uint64_t count = std::min(
+      static_cast<uint64_t>(allBuckets.size()),
+      static_cast<uint64_t>(secondCount));
+  for (auto iter = allBuckets.end() - count; iter != allBuckets.end(); ++iter) {
+    for (size_t i = 0; i < totals.size(); ++i) {
+      totals[i] += (*iter)[i];
+    }
+  }
+  return totals;
+}
+
 std::unordered_map<pid_t, AccessCounts> ProcessAccessLog::getAccessCounts(
     std::chrono::seconds lastNSeconds) {
   auto secondCount = lastNSeconds.count();
@@ -236,6 +329,9 @@ std::unordered_map<pid_t, AccessCounts> ProcessAccessLog::getAccessCounts(
         accessCounts[AccessType::FsChannelBackingStoreImport];
     accessCountsByPid[pid].fsChannelDurationNs_ref() =
         accessCounts.duration.count();
+    accessCountsByPid[pid].fsChannelBytesRead_ref() = accessCounts.bytesRead;
+    accessCountsByPid[pid].fsChannelBytesWritten_ref() =
+        accessCounts.bytesWritten;
   }
   return accessCountsByPid;
 }
@@ -8,9 +8,12 @@
 #pragma once
 
 #include <folly/Synchronized.h>
+#include <array>
+#include <atomic>
 #include <type_traits>
 
 #include "eden/fs/service/gen-cpp2/eden_types.h"
+#include "eden/fs/utils/AtomicBucketedLog.h"
 #include "eden/fs/utils/BucketedLog.h"
 #include "eden/fs/utils/EnumValue.h"
 
@@ -54,6 +57,15 @@ class ProcessAccessLog {
   void recordAccess(pid_t pid, AccessType type);
   void recordDuration(pid_t pid, std::chrono::nanoseconds duration);
 
+  /**
+   * Records bytes transferred on behalf of a process ID. `type` must be
+   * FsChannelRead or FsChannelWrite; other access types carry no byte counts.
+   *
+   * Unlike recordAccess, this does not count as an access, so record both
+   * where byte counts are available.
+   */
+  void recordBytes(pid_t pid, AccessType type, size_t bytes);
+
   /**
    * Returns the number of times each pid was passed to recordAccess() in
    * `lastNSeconds`.
@@ -64,10 +76,24 @@ class ProcessAccessLog {
   std::unordered_map<pid_t, AccessCounts> getAccessCounts(
       std::chrono::seconds lastNSeconds);
 
+  /**
+   * Returns the total number of recordAccess() calls per AccessType in
+   * `lastNSeconds`, without the per-pid breakdown. These counts come from a
+   * lock-free log shared by all threads, so reading them does not merge
+   * thread-local state or stop writers the way getAccessCounts() does.
+   *
+   * Subject to the same whole-second bucketing approximation as
+   * getAccessCounts().
+   */
+  std::array<uint64_t, enumValue(AccessType::Last)> getOperationCounts(
+      std::chrono::seconds lastNSeconds);
+
  private:
   struct PerBucketAccessCounts {
     size_t counts[enumValue(AccessType::Last)];
     std::chrono::nanoseconds duration;
+    size_t bytesRead;
+    size_t bytesWritten;
 
     size_t& operator[](AccessType type) {
       static_assert(std::is_unsigned_v<std::underlying_type_t<AccessType>>);
@@ -82,11 +108,27 @@ class ProcessAccessLog {
     void clear();
     void add(pid_t pid, bool& isNew, AccessType type);
     void add(pid_t pid, bool& isNew, std::chrono::nanoseconds duration);
+    void add(pid_t pid, bool& isNew, AccessType type, size_t bytes);
     void merge(const Bucket& other);
 
     std::unordered_map<pid_t, PerBucketAccessCounts> accessCountsByPid;
   };
 
+  /**
+   * Aggregate operation counts for one second, shared by all threads. There
+   * is no per-pid breakdown here, just one atomic counter per AccessType, so
+   * it can be bumped lock-free on every channel request.
+   */
+  struct OperationBucket {
+    using Value = std::array<uint64_t, enumValue(AccessType::Last)>;
+
+    void add(AccessType type);
+    void clear();
+    Value load() const;
+
+    std::atomic<uint64_t> counts[enumValue(AccessType::Last)] = {};
+  };
+
   // Keep up to ten seconds of data, but use a power of two so BucketedLog
   // generates smaller, faster code.
   static constexpr uint64_t kBucketCount = 16;
@@ -98,6 +140,7 @@ class ProcessAccessLog {
 
   const std::shared_ptr<ProcessNameCache> processNameCache_;
   folly::Synchronized<State> state_;
+  AtomicBucketedLog<OperationBucket, kBucketCount> operationCounts_;
 
   uint64_t getSecondsSinceEpoch();
   ThreadLocalBucket* getTlb();
@@ -42,6 +42,24 @@ extern char** environ;
 
 namespace facebook::eden {
 
+namespace {
+/** Kernel pipe buffer to request for child pipes (best effort). */
+constexpr size_t kPipeBufferSize = 1024 * 1024;
+/**
+ * Adaptive chunking for the output pump loops: start small so chatty
+ * low-volume streams don't waste memory, and double up to the cap while
+ * reads keep coming back full.
+ */
+constexpr size_t kMinReadChunk = 4096;
+constexpr size_t kMaxReadChunk = 1024 * 1024;
+/**
+ * Overflow buffer read alongside the primary chunk, so a burst larger than
+ * the current chunk still drains in a single vectored read (and tells the
+ * sizing logic to grow).
+ */
+constexpr size_t kReadSpillSize = 128 * 1024;
+} // namespace
+
 ProcessStatus ProcessStatus::fromWaitStatus(int rawStatus) {
 #ifndef _WIN32
   if (WIFEXITED(rawStatus)) {
@@ -333,6 +351,9 @@ void SpawnedProcess::Options::pipe(int targetFd, bool childRead) {
   }
 
   Pipe pipe;
+  // Ask for a roomier kernel buffer so a chatty child doesn't stall on a
+  // 64KiB default ring while we're between reads. Best effort.
+  pipe.expandBufferSize(kPipeBufferSize);
 
   if (childRead) {
     pipes_.emplace(std::make_pair(targetFd, std::move(pipe.write)));
@@ -1036,6 +1057,11 @@ std::pair<std::string, std::string> SpawnedProcess::pollingCommunicate(
   pfds.reserve(pipes_.size());
   revmap.reserve(pipes_.size());
 
+  // Per-stream adaptive read chunk, keyed by target fd. Streams that keep
+  // filling their chunk double it up to the cap.
+  std::unordered_map<int, size_t> chunkSizes;
+  std::vector<char> buf;
+
   while (!pipes_.empty()) {
     revmap.clear();
     pfds.clear();
@@ -1064,8 +1090,10 @@ std::pair<std::string, std::string> SpawnedProcess::pollingCommunicate(
     for (auto& pfd : pfds) {
       if ((pfd.revents & (POLLHUP | POLLIN)) &&
           revmap[pfd.fd] != STDIN_FILENO) {
-        char buf[BUFSIZ];
-        auto l = ::read(pfd.fd, buf, sizeof(buf));
+        auto& chunkSize =
+            chunkSizes.emplace(revmap[pfd.fd], kMinReadChunk).first->second;
+        buf.resize(chunkSize);
+        auto l = ::read(pfd.fd, buf.data(), buf.size());
         if (l == -1 && (errno == EAGAIN || errno == EINTR)) {
           continue;
         }
@@ -1079,7 +1107,10 @@ std::pair<std::string, std::string> SpawnedProcess::pollingCommunicate(
           pipes_.erase(revmap[pfd.fd]);
           continue;
         }
-        outputs[revmap[pfd.fd]].append(buf, l);
+        outputs[revmap[pfd.fd]].append(buf.data(), l);
+        if (static_cast<size_t>(l) == chunkSize && chunkSize < kMaxReadChunk) {
+          chunkSize *= 2;
+        }
       }
 
       if ((pfd.revents & POLLHUP) && revmap[pfd.fd] == STDIN_FILENO) {
@@ -1127,16 +1158,40 @@ folly::Future<std::string> SpawnedProcess::readPipe(int fd) {
     std::string result;
     p->setWith([&] {
       auto& pipe = pipes_[fd];
+      size_t chunkSize = kMinReadChunk;
+      std::vector<char> spill(kReadSpillSize);
       while (true) {
-        char buf[4096];
-        auto readResult = pipe.read(buf, sizeof(buf));
-        readResult.throwUnlessValue();
-        auto len = readResult.value();
-        if (len == 0) {
+        // Read directly into the tail of the result string, with the spill
+        // buffer as a second iovec so a burst larger than the current chunk
+        // is still consumed in one syscall.
+        auto len = result.size();
+        result.resize(len + chunkSize);
+        iovec iov[2];
+        iov[0].iov_base = &result[len];
+        iov[0].iov_len = chunkSize;
+        iov[1].iov_base = spill.data();
+        iov[1].iov_len = spill.size();
+        auto readResult = pipe.readv(iov, 2);
+        if (readResult.hasException()) {
+          result.resize(len);
+          readResult.throwUnlessValue();
+        }
+        auto n = static_cast<size_t>(readResult.value());
+        if (n == 0) {
           // all done
+          result.resize(len);
           break;
         }
-        result.append(buf, len);
+        if (n <= chunkSize) {
+          result.resize(len + n);
+        } else {
+          result.append(spill.data(), n - chunkSize);
+        }
+        if (n >= chunkSize && chunkSize < kMaxReadChunk) {
+          // The stream is filling our chunk; ramp up so large transfers
+          // need fewer syscalls.
+          chunkSize *= 2;
+        }
       }
       return std::string(result.data(), result.size());
     });
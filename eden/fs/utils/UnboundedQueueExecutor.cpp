@@ -9,22 +9,36 @@
 
 #include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/executors/ManualExecutor.h>
-#include <folly/executors/task_queue/UnboundedBlockingQueue.h>
 #include <folly/executors/thread_factory/NamedThreadFactory.h>
 
+#include "eden/fs/utils/PriorityTaskQueue.h"
+
 namespace facebook::eden {
 
 UnboundedQueueExecutor::UnboundedQueueExecutor(
     size_t threadCount,
-    folly::StringPiece threadNamePrefix)
-    : executor_{std::make_unique<folly::CPUThreadPoolExecutor>(
-          threadCount,
-          std::make_unique<folly::UnboundedBlockingQueue<
-              folly::CPUThreadPoolExecutor::CPUTask>>(),
-          std::make_unique<folly::NamedThreadFactory>(threadNamePrefix))} {}
+    folly::StringPiece threadNamePrefix) {
+  auto queue = std::make_unique<PriorityTaskQueue>();
+  taskQueue_ = queue.get();
+  executor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+      threadCount,
+      std::move(queue),
+      std::make_unique<folly::NamedThreadFactory>(threadNamePrefix));
+}
 
 UnboundedQueueExecutor::UnboundedQueueExecutor(
     std::shared_ptr<folly::ManualExecutor> executor)
     : executor_{std::move(executor)} {}
 
+std::vector<size_t> UnboundedQueueExecutor::getLaneDepths() const {
+  std::vector<size_t> depths;
+  if (taskQueue_) {
+    depths.reserve(PriorityTaskQueue::kNumLanes);
+    for (size_t lane = 0; lane < PriorityTaskQueue::kNumLanes; ++lane) {
+      depths.push_back(taskQueue_->laneSize(lane));
+    }
+  }
+  return depths;
+}
+
 } // namespace facebook::eden
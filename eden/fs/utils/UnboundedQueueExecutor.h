@@ -9,6 +9,7 @@
 
 #include <folly/Executor.h>
 #include <folly/Range.h>
+#include <vector>
 
 namespace folly {
 class ManualExecutor;
@@ -16,6 +17,8 @@ class ManualExecutor;
 
 namespace facebook::eden {
 
+class PriorityTaskQueue;
+
 /**
  * An Executor that is guaranteed to never block, nor throw (except OOM), nor
  * execute inline from `add()`.
@@ -50,8 +53,39 @@ class UnboundedQueueExecutor : public folly::Executor {
     executor_->add(std::move(func));
   }
 
+  /**
+   * Adds a task to the given priority lane (folly::Executor::LO_PRI,
+   * MID_PRI or HI_PRI). Falls back to plain add() when the underlying
+   * executor has a single priority, as the ManualExecutor used by tests
+   * does.
+   */
+  void addWithPriority(folly::Func func, int8_t priority) override {
+    if (executor_->getNumPriorities() > 1) {
+      executor_->addWithPriority(std::move(func), priority);
+    } else {
+      executor_->add(std::move(func));
+    }
+  }
+
+  uint8_t getNumPriorities() const override {
+    return executor_->getNumPriorities();
+  }
+
+  /**
+   * Depth of each priority lane of the underlying task queue, lowest
+   * priority first. Empty when the executor was constructed from a
+   * ManualExecutor.
+   */
+  std::vector<size_t> getLaneDepths() const;
+
  private:
   std::shared_ptr<folly::Executor> executor_;
+
+  /**
+   * The task queue feeding executor_, owned by the CPUThreadPoolExecutor.
+   * Null when the executor was constructed from a ManualExecutor.
+   */
+  PriorityTaskQueue* taskQueue_ = nullptr;
 };
 
 } // namespace facebook::eden
@@ -20,6 +20,7 @@
 #include <folly/portability/Sockets.h>
 #include <folly/portability/SysUio.h>
 #include <algorithm>
+#include <cstring>
 #include <new>
 #ifdef __APPLE__
 #include <sys/ucred.h> // @manual
@@ -58,6 +59,19 @@ namespace {
  * linux/include/net/scm.h
  */
 constexpr size_t kMaxFDs = 253;
+
+/**
+ * The maximum number of messages to send in one pass through trySend().
+ *
+ * If we have multiple messages to send and the writes don't block, break out
+ * after this many just to yield the event loop so that we don't starve other
+ * events that need to be handled.
+ *
+ * Note that MSG_ZEROCOPY is deliberately not used here even for large
+ * payloads: the kernel only implements it for TCP and UDP sockets, and
+ * setting SO_ZEROCOPY on an AF_UNIX socket fails.
+ */
+constexpr unsigned int kMaxSendsPerEventLoop = 10;
 } // namespace
 
 class UnixSocket::Connector : private folly::EventHandler, folly::AsyncTimeout {
@@ -482,28 +496,41 @@ UnixSocket::Header UnixSocket::deserializeHeader(const HeaderBuffer& buffer) {
 }
 
 void UnixSocket::trySend() {
-  // If we have multiple message to send and write doesn't block,
-  // break out after sending MAX_MSGS_AT_ONCE, just to yield the event loop
-  // so that we don't starve other events that need to be handled.
-  constexpr unsigned int MAX_MSGS_AT_ONCE = 10;
-  for (unsigned int n = 0; n < MAX_MSGS_AT_ONCE; ++n) {
+  unsigned int n = 0;
+  while (n < kMaxSendsPerEventLoop) {
     if (!sendQueue_) {
       break;
     }
 
+#ifdef __linux__
+    // When several messages are queued up, pass them to the kernel with a
+    // single sendmmsg() call rather than one sendmsg() per message.  This
+    // matters most during graceful takeover, where the TakeoverData transfer
+    // queues many messages at once.  Messages carrying file descriptors still
+    // go through the single-message path below for SCM_RIGHTS handling.
+    if (sendQueue_->next && sendQueue_->message.files.empty()) {
+      unsigned int numComplete = 0;
+      bool keepSending = trySendBatch(kMaxSendsPerEventLoop - n, numComplete);
+      // Always count at least one message against the loop budget so that a
+      // batch that made no progress cannot spin here forever.
+      n += std::max(numComplete, 1u);
+      popCompletedSends(numComplete);
+      if (!keepSending) {
+        // The write blocked, and we need to retry after waiting for the
+        // socket to become writable.
+        break;
+      }
+      continue;
+    }
+#endif
+
     if (!trySendMessage(sendQueue_.get())) {
       // The write blocked, and we need to retry this message again
       // after waiting for the socket to become writable.
       break;
     }
-    auto* callback = sendQueue_->callback;
-    sendQueue_ = std::move(sendQueue_->next);
-    if (!sendQueue_) {
-      sendQueueTail_ = nullptr;
-    }
-    if (callback) {
-      callback->sendSuccess();
-    }
+    popCompletedSends(1);
+    ++n;
   }
 
   // Update our I/O event and timeout registration
@@ -522,6 +549,89 @@ void UnixSocket::trySend() {
   }
 }
 
+void UnixSocket::popCompletedSends(unsigned int numComplete) {
+  for (unsigned int i = 0; i < numComplete; ++i) {
+    XDCHECK(sendQueue_);
+    auto* callback = sendQueue_->callback;
+    sendQueue_ = std::move(sendQueue_->next);
+    if (!sendQueue_) {
+      sendQueueTail_ = nullptr;
+    }
+    if (callback) {
+      callback->sendSuccess();
+    }
+  }
+}
+
+void UnixSocket::advanceIovecs(SendQueueEntry* entry, size_t bytesSent) {
+  while (bytesSent > 0) {
+    if (bytesSent >= entry->iov[entry->iovIndex].iov_len) {
+      bytesSent -= entry->iov[entry->iovIndex].iov_len;
+      ++entry->iovIndex;
+    } else {
+      auto* iov = entry->iov + entry->iovIndex;
+      iov->iov_len -= bytesSent;
+      iov->iov_base = static_cast<char*>(iov->iov_base) + bytesSent;
+      break;
+    }
+  }
+}
+
+#ifdef __linux__
+bool UnixSocket::trySendBatch(
+    unsigned int maxMessages,
+    unsigned int& numComplete) {
+  std::array<struct mmsghdr, kMaxSendsPerEventLoop> msgs;
+  std::array<SendQueueEntry*, kMaxSendsPerEventLoop> entries;
+  XDCHECK_LE(maxMessages, kMaxSendsPerEventLoop);
+
+  unsigned int count = 0;
+  for (auto* entry = sendQueue_.get(); entry && count < maxMessages;
+       entry = entry->next.get()) {
+    if (!entry->message.files.empty()) {
+      // This message needs SCM_RIGHTS control data; stop here and let
+      // trySendMessage() handle it on the next pass.
+      break;
+    }
+    auto& msg = msgs[count];
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_hdr.msg_iov = entry->iov + entry->iovIndex;
+    // Send at most IOV_MAX chunks per message; the send may fail with
+    // EMSGSIZE if we send too many iovecs at once.
+    msg.msg_hdr.msg_iovlen =
+        std::min(entry->iovCount - entry->iovIndex, folly::kIovMax);
+    entries[count] = entry;
+    ++count;
+  }
+  XDCHECK_GT(count, 0u);
+
+  auto rc = sendmmsg(socket_.fd(), msgs.data(), count, MSG_DONTWAIT);
+  XLOG(DBG9) << "sendmmsg() returned " << rc << " of " << count << " messages";
+  if (rc < 0) {
+    if (errno == EAGAIN) {
+      numComplete = 0;
+      return false;
+    }
+    throwSystemError("sendmmsg() failed on UnixSocket");
+  }
+
+  // The kernel processes the messages in order, so only the last message it
+  // touched can be partially sent; every earlier one completed in full.
+  numComplete = 0;
+  bool blocked = static_cast<unsigned int>(rc) < count;
+  for (int i = 0; i < rc; ++i) {
+    advanceIovecs(entries[i], msgs[i].msg_len);
+    if (entries[i]->iovIndex == entries[i]->iovCount) {
+      ++numComplete;
+    } else {
+      blocked = true;
+      break;
+    }
+  }
+  return !blocked;
+}
+#endif
+
 bool UnixSocket::trySendMessage(SendQueueEntry* entry) {
   uint8_t dataByte = 0;
   struct msghdr msg = {};
@@ -583,18 +693,7 @@ bool UnixSocket::trySendMessage(SendQueueEntry* entry) {
   if (entry->iovIndex < entry->iovCount) {
     // Update entry->iov and entry->iovIndex to account for the data that was
     // successfully sent.
-    while (bytesSent > 0) {
-      if (static_cast<size_t>(bytesSent) >=
-          entry->iov[entry->iovIndex].iov_len) {
-        bytesSent -= entry->iov[entry->iovIndex].iov_len;
-        ++entry->iovIndex;
-      } else {
-        auto* iov = entry->iov + entry->iovIndex;
-        iov->iov_len -= bytesSent;
-        iov->iov_base = static_cast<char*>(iov->iov_base) + bytesSent;
-        break;
-      }
-    }
+    advanceIovecs(entry, bytesSent);
   }
 
   // Update entry->filesSent to account for the file descriptors we sent.
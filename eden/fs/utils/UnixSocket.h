@@ -354,6 +354,31 @@ class UnixSocket : public folly::DelayedDestruction,
 
   void trySend();
   bool trySendMessage(SendQueueEntry* entry);
+#ifdef __linux__
+  /**
+   * Send several queued messages with a single sendmmsg() call.
+   *
+   * This examines up to maxMessages entries from the front of the send queue,
+   * stopping early at the first message that carries file descriptors, since
+   * those need SCM_RIGHTS control data and go through trySendMessage().
+   *
+   * On return numComplete contains the number of fully-sent messages at the
+   * front of the queue; the caller is responsible for popping them and
+   * invoking their callbacks.  Returns false if the socket blocked and we
+   * need to wait for it to become writable before sending more data.
+   */
+  bool trySendBatch(unsigned int maxMessages, unsigned int& numComplete);
+#endif
+  /**
+   * Advance entry->iov and entry->iovIndex past bytesSent bytes of
+   * successfully-sent data.
+   */
+  static void advanceIovecs(SendQueueEntry* entry, size_t bytesSent);
+  /**
+   * Pop numComplete fully-sent entries off the front of the send queue and
+   * invoke their callbacks.
+   */
+  void popCompletedSends(unsigned int numComplete);
   size_t initializeFirstControlMsg(
       std::vector<uint8_t>& controlBuf,
       struct msghdr* msg,
@@ -8,9 +8,339 @@
 #include "eden/fs/utils/Utf8.h"
 
 #include <folly/Unicode.h>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 namespace facebook::eden {
 
+namespace {
+
+/**
+ * Validate starting with a word-at-a-time ASCII prescan, falling back to the
+ * byte-at-a-time validator at the first non-ASCII word.  Used for strings too
+ * short to fill a vector register and as the portable implementation.
+ */
+bool validateWithAsciiPrescan(const char* data, size_t len) {
+  size_t i = 0;
+  while (i + sizeof(uint64_t) <= len) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    if (word & 0x8080808080808080ull) {
+      break;
+    }
+    i += sizeof(word);
+  }
+  return detail::isValidUtf8Scalar(data + i, data + len);
+}
+
+#if defined(__AVX2__) || defined(__aarch64__)
+
+/*
+ * Shuffle-based UTF-8 DFA, after Keiser & Lemire, "Validating UTF-8 In Less
+ * Than One Instruction Per Byte".
+ *
+ * Every pair of adjacent bytes is classified through three 16-entry nibble
+ * lookup tables (one per nibble of the first byte, one for the high nibble of
+ * the second); ANDing the lookups yields a nonzero error flag for every
+ * two-byte sequence that cannot appear in valid UTF-8: stray or missing
+ * continuation bytes, overlong encodings, surrogate halves, and codepoints
+ * past U+10FFFF.  Third and fourth continuation bytes are checked separately
+ * by comparing against the bytes two and three positions back.
+ */
+
+constexpr uint8_t kTooShort = 1 << 0; // lead byte followed by another lead
+constexpr uint8_t kTooLong = 1 << 1; // continuation after an ASCII byte
+constexpr uint8_t kOverlong3 = 1 << 2; // E0 followed by 80..9F
+constexpr uint8_t kTooLarge = 1 << 3; // F4 90.. and beyond
+constexpr uint8_t kSurrogate = 1 << 4; // ED followed by A0..BF
+constexpr uint8_t kOverlong2 = 1 << 5; // C0/C1 lead
+constexpr uint8_t kTooLarge1000 = 1 << 6; // F5..FF lead followed by 80..8F
+constexpr uint8_t kOverlong4 = 1 << 6; // F0 followed by 80..8F
+constexpr uint8_t kTwoConts = 1 << 7; // two continuation bytes in a row
+
+// Carried through for every low nibble: these cases depend only on the high
+// nibble of the first byte and the high nibble of the second.
+constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+// Indexed by the high nibble of the first byte of the pair.
+alignas(16) constexpr uint8_t kByte1High[16] = {
+    // 0x0_-0x7_: ASCII; only an error if followed by a continuation.
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    // 0x8_-0xB_: continuation bytes.
+    kTwoConts,
+    kTwoConts,
+    kTwoConts,
+    kTwoConts,
+    // 0xC_: two-byte lead; C0/C1 are overlong.
+    kTooShort | kOverlong2,
+    // 0xD_: two-byte lead.
+    kTooShort,
+    // 0xE_: three-byte lead; E0 8x is overlong, ED Ax is a surrogate.
+    kTooShort | kOverlong3 | kSurrogate,
+    // 0xF_: four-byte lead; F0 8x is overlong, F4 9x+ and F5+ are too large.
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+};
+
+// Indexed by the low nibble of the first byte of the pair.
+alignas(16) constexpr uint8_t kByte1Low[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4, // 0: E0, C0, F0
+    kCarry | kOverlong2, // 1: C1
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge, // 4: F4
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate, // D: ED
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+};
+
+// Indexed by the high nibble of the second byte of the pair.
+alignas(16) constexpr uint8_t kByte2High[16] = {
+    // 0x0_-0x7_: ASCII after a lead byte cuts the sequence short.
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    // 0x8_-0xB_: continuation bytes; which leads they invalidate varies.
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    // 0xC_-0xF_: another lead byte also cuts the sequence short.
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+};
+
+#endif
+
+#if defined(__AVX2__)
+
+constexpr size_t kBlockSize = 32;
+
+template <int N>
+inline __m256i prevBytes(__m256i input, __m256i prevInput) {
+  return _mm256_alignr_epi8(
+      input, _mm256_permute2x128_si256(prevInput, input, 0x21), 16 - N);
+}
+
+inline __m256i loadTable(const uint8_t (&table)[16]) {
+  auto lane = _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+  return _mm256_broadcastsi128_si256(lane);
+}
+
+/**
+ * Per-block validation state.  error accumulates nonzero bytes on invalid
+ * input; prevIncomplete is nonzero if the previous block ended in the middle
+ * of a multi-byte sequence.
+ */
+struct Utf8Checker {
+  __m256i error = _mm256_setzero_si256();
+  __m256i prevInput = _mm256_setzero_si256();
+  __m256i prevIncomplete = _mm256_setzero_si256();
+
+  void check(__m256i input) {
+    if (_mm256_movemask_epi8(input) == 0) {
+      // All ASCII: only invalid if the previous block was cut short.
+      error = _mm256_or_si256(error, prevIncomplete);
+      prevIncomplete = _mm256_setzero_si256();
+      prevInput = input;
+      return;
+    }
+
+    auto lowNibbleMask = _mm256_set1_epi8(0x0F);
+    auto prev1 = prevBytes<1>(input, prevInput);
+    auto byte1High = _mm256_shuffle_epi8(
+        loadTable(kByte1High),
+        _mm256_and_si256(_mm256_srli_epi16(prev1, 4), lowNibbleMask));
+    auto byte1Low = _mm256_shuffle_epi8(
+        loadTable(kByte1Low), _mm256_and_si256(prev1, lowNibbleMask));
+    auto byte2High = _mm256_shuffle_epi8(
+        loadTable(kByte2High),
+        _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibbleMask));
+    auto specialCases =
+        _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+    // Bytes that must be the third or fourth byte of a sequence carry the
+    // kTwoConts bit; everywhere else the bit set in specialCases is an error.
+    auto prev2 = prevBytes<2>(input, prevInput);
+    auto prev3 = prevBytes<3>(input, prevInput);
+    auto isThirdByte =
+        _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 1)));
+    auto isFourthByte =
+        _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 1)));
+    auto mustBeContinuation = _mm256_cmpgt_epi8(
+        _mm256_or_si256(isThirdByte, isFourthByte), _mm256_setzero_si256());
+    error = _mm256_or_si256(
+        error,
+        _mm256_xor_si256(
+            _mm256_and_si256(
+                mustBeContinuation, _mm256_set1_epi8(static_cast<char>(0x80))),
+            specialCases));
+
+    // Lead bytes whose sequence extends past the end of this block.
+    alignas(32) static constexpr uint8_t maxValue[kBlockSize] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1,
+        0xC0 - 1};
+    prevIncomplete = _mm256_subs_epu8(
+        input, _mm256_load_si256(reinterpret_cast<const __m256i*>(maxValue)));
+    prevInput = input;
+  }
+
+  bool valid() const {
+    return _mm256_testz_si256(
+               _mm256_or_si256(error, prevIncomplete),
+               _mm256_or_si256(error, prevIncomplete)) != 0;
+  }
+};
+
+bool isValidUtf8Impl(const char* data, size_t len) {
+  if (len < kBlockSize) {
+    return validateWithAsciiPrescan(data, len);
+  }
+
+  Utf8Checker checker;
+  size_t i = 0;
+  for (; i + kBlockSize <= len; i += kBlockSize) {
+    checker.check(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+  }
+  if (i < len) {
+    // Pad the tail with zeros; the padding is ASCII, so a sequence truncated
+    // by the real end of input still fails as "too short".
+    alignas(32) char tail[kBlockSize] = {0};
+    memcpy(tail, data + i, len - i);
+    checker.check(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+  }
+  return checker.valid();
+}
+
+#elif defined(__aarch64__)
+
+constexpr size_t kBlockSize = 16;
+
+struct Utf8Checker {
+  uint8x16_t error = vdupq_n_u8(0);
+  uint8x16_t prevInput = vdupq_n_u8(0);
+  uint8x16_t prevIncomplete = vdupq_n_u8(0);
+
+  void check(uint8x16_t input) {
+    if (vmaxvq_u8(input) < 0x80) {
+      // All ASCII: only invalid if the previous block was cut short.
+      error = vorrq_u8(error, prevIncomplete);
+      prevIncomplete = vdupq_n_u8(0);
+      prevInput = input;
+      return;
+    }
+
+    auto prev1 = vextq_u8(prevInput, input, 16 - 1);
+    auto byte1High = vqtbl1q_u8(vld1q_u8(kByte1High), vshrq_n_u8(prev1, 4));
+    auto byte1Low =
+        vqtbl1q_u8(vld1q_u8(kByte1Low), vandq_u8(prev1, vdupq_n_u8(0x0F)));
+    auto byte2High = vqtbl1q_u8(vld1q_u8(kByte2High), vshrq_n_u8(input, 4));
+    auto specialCases = vandq_u8(vandq_u8(byte1High, byte1Low), byte2High);
+
+    // Bytes that must be the third or fourth byte of a sequence carry the
+    // kTwoConts bit; everywhere else the bit set in specialCases is an error.
+    auto prev2 = vextq_u8(prevInput, input, 16 - 2);
+    auto prev3 = vextq_u8(prevInput, input, 16 - 3);
+    auto isThirdByte = vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 1));
+    auto isFourthByte = vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 1));
+    auto mustBeContinuation = vreinterpretq_u8_s8(vcgtq_s8(
+        vreinterpretq_s8_u8(vorrq_u8(isThirdByte, isFourthByte)),
+        vdupq_n_s8(0)));
+    error = vorrq_u8(
+        error,
+        veorq_u8(
+            vandq_u8(mustBeContinuation, vdupq_n_u8(0x80)), specialCases));
+
+    // Lead bytes whose sequence extends past the end of this block.
+    alignas(16) static constexpr uint8_t maxValue[kBlockSize] = {
+        0xFF,
+        0xFF,
+        0xFF,
+        0xFF,
+        0xFF,
+        0xFF,
+        0xFF,
+        0xFF,
+        0xFF,
+        0xFF,
+        0xFF,
+        0xFF,
+        0xFF,
+        0xF0 - 1,
+        0xE0 - 1,
+        0xC0 - 1};
+    prevIncomplete = vqsubq_u8(input, vld1q_u8(maxValue));
+    prevInput = input;
+  }
+
+  bool valid() const {
+    return vmaxvq_u8(vorrq_u8(error, prevIncomplete)) == 0;
+  }
+};
+
+bool isValidUtf8Impl(const char* data, size_t len) {
+  if (len < kBlockSize) {
+    return validateWithAsciiPrescan(data, len);
+  }
+
+  Utf8Checker checker;
+  size_t i = 0;
+  for (; i + kBlockSize <= len; i += kBlockSize) {
+    checker.check(vld1q_u8(reinterpret_cast<const uint8_t*>(data + i)));
+  }
+  if (i < len) {
+    // Pad the tail with zeros; the padding is ASCII, so a sequence truncated
+    // by the real end of input still fails as "too short".
+    alignas(16) uint8_t tail[kBlockSize] = {0};
+    memcpy(tail, data + i, len - i);
+    checker.check(vld1q_u8(tail));
+  }
+  return checker.valid();
+}
+
+#else
+
+bool isValidUtf8Impl(const char* data, size_t len) {
+  return validateWithAsciiPrescan(data, len);
+}
+
+#endif
+
+} // namespace
+
+bool isValidUtf8(folly::StringPiece str) noexcept {
+  return isValidUtf8Impl(str.data(), str.size());
+}
+
 std::string ensureValidUtf8(folly::ByteRange str) {
   std::string output;
   output.reserve(str.size());
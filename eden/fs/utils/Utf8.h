@@ -57,18 +57,14 @@ constexpr bool isValidContinuation(
 
   return true;
 }
-} // namespace detail
 
 /**
- * Returns whether the given string is correctly-encoded UTF-8.
+ * Byte-at-a-time UTF-8 validator.
  *
- * This doesn't verify whether the codepoints are actually valid unicode
- * characters.
+ * This is the reference implementation behind isValidUtf8(); it also handles
+ * the unaligned tail left over by the vectorized validator.
  */
-constexpr bool isValidUtf8(folly::StringPiece str) {
-  const char* begin = str.begin();
-  const char* const end = str.end();
-
+constexpr bool isValidUtf8Scalar(const char* begin, const char* const end) {
   while (begin != end) {
     char first = *begin++;
     if (!detail::isBitSet(first, 7)) {
@@ -98,6 +94,11 @@ constexpr bool isValidUtf8(folly::StringPiece str) {
       if (codepoint < 0x800) {
         return false;
       }
+
+      // UTF-16 surrogate halves are not valid codepoints.
+      if (codepoint >= 0xD800 && codepoint <= 0xDFFF) {
+        return false;
+      }
     } else if (!detail::isBitSet(first, 3)) {
       // 11110xxx: 4 bytes
       uint32_t codepoint = folly::to_unsigned(first) & 0x7;
@@ -109,6 +110,12 @@ constexpr bool isValidUtf8(folly::StringPiece str) {
       if (codepoint < 0x10000) {
         return false;
       }
+
+      // Codepoints past U+10FFFF cannot be encoded in UTF-16 and are
+      // disallowed by RFC 3629.
+      if (codepoint > 0x10FFFF) {
+        return false;
+      }
     } else {
       // 11111xxx isn't ever valid.
       return false;
@@ -117,6 +124,18 @@ constexpr bool isValidUtf8(folly::StringPiece str) {
 
   return true;
 }
+} // namespace detail
+
+/**
+ * Returns whether the given string is correctly-encoded UTF-8 per RFC 3629:
+ * no overlong encodings, no surrogate halves, and no codepoints past
+ * U+10FFFF.
+ *
+ * Processes a vector register's worth of bytes at a time with a fast path for
+ * ASCII; paths are validated on every request on some mounts, so this sits on
+ * the per-request critical path.
+ */
+bool isValidUtf8(folly::StringPiece str) noexcept;
 
 std::string ensureValidUtf8(folly::ByteRange str);
 
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/AsciiCaseFold.h"
+
+#include <folly/portability/GTest.h>
+#include <string>
+
+using namespace facebook::eden;
+
+namespace {
+char foldChar(char c) {
+  if (c >= 'A' && c <= 'Z') {
+    c += 'a' - 'A';
+  }
+  return c;
+}
+
+std::string foldString(std::string_view s) {
+  std::string result{s};
+  for (auto& c : result) {
+    c = foldChar(c);
+  }
+  return result;
+}
+} // namespace
+
+TEST(AsciiCaseFold, equals) {
+  EXPECT_TRUE(equalsAsciiIgnoreCase("", ""));
+  EXPECT_TRUE(equalsAsciiIgnoreCase("foo", "FOO"));
+  EXPECT_TRUE(equalsAsciiIgnoreCase("README.txt", "readme.TXT"));
+  EXPECT_FALSE(equalsAsciiIgnoreCase("foo", "foo1"));
+  EXPECT_FALSE(equalsAsciiIgnoreCase("foo", "bar"));
+}
+
+TEST(AsciiCaseFold, onlyAsciiLettersFold) {
+  // '@' (0x40) and '[' (0x5b) sit just outside 'A'..'Z'; a range check that
+  // is off by one would fold them to '`' and '{'.
+  EXPECT_FALSE(equalsAsciiIgnoreCase("@", "`"));
+  EXPECT_FALSE(equalsAsciiIgnoreCase("[", "{"));
+
+  // Bytes >= 0x80 (UTF-8 sequences) must compare verbatim.
+  EXPECT_TRUE(equalsAsciiIgnoreCase("caf\xc3\xa9", "CAF\xc3\xa9"));
+  EXPECT_FALSE(equalsAsciiIgnoreCase("\xc3\xa9", "\xc3\x89"));
+}
+
+TEST(AsciiCaseFold, equalsAtVectorBoundaries) {
+  // Exercise lengths around the 16 and 32 byte SIMD block sizes, with the
+  // differing byte placed at every position.
+  for (size_t len : {1u, 15u, 16u, 17u, 31u, 32u, 33u, 64u, 100u}) {
+    std::string lower(len, 'a');
+    std::string upper(len, 'A');
+    EXPECT_TRUE(equalsAsciiIgnoreCase(lower, upper)) << "len=" << len;
+
+    for (size_t pos = 0; pos < len; ++pos) {
+      auto modified = upper;
+      modified[pos] = 'B';
+      EXPECT_FALSE(equalsAsciiIgnoreCase(lower, modified))
+          << "len=" << len << " pos=" << pos;
+      EXPECT_EQ(
+          compareAsciiIgnoreCase(lower, modified) < 0,
+          foldString(lower) < foldString(modified))
+          << "len=" << len << " pos=" << pos;
+    }
+  }
+}
+
+TEST(AsciiCaseFold, compare) {
+  EXPECT_EQ(0, compareAsciiIgnoreCase("", ""));
+  EXPECT_EQ(0, compareAsciiIgnoreCase("Foo", "foO"));
+  EXPECT_LT(compareAsciiIgnoreCase("abc", "abd"), 0);
+  EXPECT_GT(compareAsciiIgnoreCase("abd", "ABC"), 0);
+  // A shared prefix orders the shorter string first.
+  EXPECT_LT(compareAsciiIgnoreCase("abc", "abcd"), 0);
+  EXPECT_GT(compareAsciiIgnoreCase("ABCD", "abc"), 0);
+}
+
+TEST(AsciiCaseFold, compareMatchesScalarReference) {
+  std::vector<std::string> values = {
+      "",
+      "a",
+      "A",
+      "z",
+      "Some/Long/Path/With/Many/Components/readme.txt",
+      "some/long/path/with/many/components/README.TXT",
+      "some/long/path/with/many/components/README.TXU",
+      std::string(40, 'Q'),
+      std::string(40, 'q') + "r",
+  };
+  for (const auto& lhs : values) {
+    for (const auto& rhs : values) {
+      auto expected = foldString(lhs).compare(foldString(rhs));
+      auto actual = compareAsciiIgnoreCase(lhs, rhs);
+      EXPECT_EQ(expected < 0, actual < 0) << lhs << " vs " << rhs;
+      EXPECT_EQ(expected == 0, actual == 0) << lhs << " vs " << rhs;
+    }
+  }
+}
+
+TEST(AsciiCaseFold, hashAgreesWithEquality) {
+  EXPECT_EQ(
+      hashAsciiIgnoreCase("SomeDirectory/SomeFile.TXT"),
+      hashAsciiIgnoreCase("somedirectory/somefile.txt"));
+  EXPECT_NE(hashAsciiIgnoreCase("foo"), hashAsciiIgnoreCase("bar"));
+
+  // Strings longer than the internal folding buffer still hash as a whole.
+  std::string big(1000, 'X');
+  EXPECT_EQ(
+      hashAsciiIgnoreCase(big), hashAsciiIgnoreCase(std::string(1000, 'x')));
+  EXPECT_NE(
+      hashAsciiIgnoreCase(big),
+      hashAsciiIgnoreCase(std::string(999, 'x') + "y"));
+}
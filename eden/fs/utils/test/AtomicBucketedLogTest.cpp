@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/AtomicBucketedLog.h"
+
+#include <folly/portability/GTest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace facebook::eden;
+
+namespace {
+
+struct Bucket {
+  using Value = uint64_t;
+
+  void add(uint64_t n) {
+    count.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  void clear() {
+    count.store(0, std::memory_order_relaxed);
+  }
+
+  Value load() const {
+    return count.load(std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> count{0};
+};
+
+template <typename... U>
+std::array<uint64_t, sizeof...(U)> valueArray(U... u) {
+  return {static_cast<uint64_t>(u)...};
+}
+
+} // namespace
+
+TEST(AtomicBucketedLog, drops_values_too_old) {
+  AtomicBucketedLog<Bucket, 3> b;
+
+  b.add(1, 1);
+  EXPECT_EQ(valueArray(0, 0, 1), b.getAll(1));
+
+  b.add(2, 2);
+  EXPECT_EQ(valueArray(0, 1, 2), b.getAll(2));
+
+  b.add(3, 3);
+  EXPECT_EQ(valueArray(1, 2, 3), b.getAll(3));
+
+  b.add(4, 4);
+  EXPECT_EQ(valueArray(2, 3, 4), b.getAll(4));
+
+  // Slot 1 now holds time 4's data, so a stale write to time 1 is ignored.
+  b.add(1, 100);
+  EXPECT_EQ(valueArray(2, 3, 4), b.getAll(4));
+}
+
+TEST(AtomicBucketedLog, accumulates_within_bucket) {
+  AtomicBucketedLog<Bucket, 3> b;
+  b.add(1, 1);
+  b.add(1, 2);
+  b.add(1, 3);
+  EXPECT_EQ(valueArray(0, 0, 6), b.getAll(1));
+}
+
+TEST(AtomicBucketedLog, expired_slots_read_as_empty_when_time_skips_ahead) {
+  AtomicBucketedLog<Bucket, 3> b;
+  b.add(1, 1);
+  b.add(4, 2);
+  b.add(7, 3);
+  EXPECT_EQ(valueArray(0, 0, 3), b.getAll(7));
+  EXPECT_EQ(valueArray(0, 0, 0), b.getAll(10));
+}
+
+TEST(AtomicBucketedLog, keeps_older_data_points_but_drops_expired_ones) {
+  AtomicBucketedLog<Bucket, 3> b;
+  b.add(2, 1);
+  b.add(3, 2);
+  b.add(4, 3);
+
+  b.add(3, 10);
+  b.add(1, 100);
+  EXPECT_EQ(valueArray(1, 12, 3), b.getAll(4));
+}
+
+TEST(AtomicBucketedLog, concurrent_writers_to_one_bucket_lose_nothing) {
+  AtomicBucketedLog<Bucket, 4> b;
+
+  constexpr size_t kThreads = 8;
+  constexpr uint64_t kAddsPerThread = 10000;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&b] {
+      for (uint64_t n = 0; n < kAddsPerThread; ++n) {
+        b.add(5, 1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // No slot recycling happens when every writer uses the same time, so the
+  // total is exact.
+  auto all = b.getAll(5);
+  EXPECT_EQ(kThreads * kAddsPerThread, all.back());
+}
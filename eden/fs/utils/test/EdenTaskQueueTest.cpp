@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/EdenTaskQueue.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/portability/GTest.h>
+#include <folly/synchronization/Baton.h>
+
+using namespace facebook::eden;
+
+TEST(EdenTaskQueueTest, runsExternallyEnqueuedTasks) {
+  folly::CPUThreadPoolExecutor pool(
+      2,
+      std::make_unique<EdenTaskQueue>(/*maxInflightRequests=*/100),
+      std::make_unique<folly::NamedThreadFactory>("TestPool"));
+
+  std::atomic<int> count{0};
+  for (int i = 0; i < 50; ++i) {
+    pool.add([&] { count.fetch_add(1); });
+  }
+  pool.join();
+  EXPECT_EQ(50, count.load());
+}
+
+TEST(EdenTaskQueueTest, subtasksRunLifoOnTheSpawningThread) {
+  folly::CPUThreadPoolExecutor pool(
+      1,
+      std::make_unique<EdenTaskQueue>(/*maxInflightRequests=*/100),
+      std::make_unique<folly::NamedThreadFactory>("TestPool"));
+
+  std::vector<int> order;
+  folly::Baton<> done;
+  pool.add([&] {
+    // These land in the spawning thread's deque and are popped back off
+    // newest-first.
+    for (int i = 0; i < 3; ++i) {
+      pool.add([&order, i] { order.push_back(i); });
+    }
+    pool.add([&done] { done.post(); });
+  });
+  // The done.post() task was pushed last, so it runs first; wait for the
+  // rest of the deque to drain before checking.
+  done.wait();
+  pool.join();
+
+  EXPECT_EQ((std::vector<int>{2, 1, 0}), order);
+}
+
+TEST(EdenTaskQueueTest, idleThreadsStealSpawnedWork) {
+  folly::CPUThreadPoolExecutor pool(
+      2,
+      std::make_unique<EdenTaskQueue>(/*maxInflightRequests=*/100),
+      std::make_unique<folly::NamedThreadFactory>("TestPool"));
+
+  // Park one thread spawning subtasks while blocked, so the only way the
+  // subtasks can run is for the other thread to steal them.
+  folly::Baton<> subtasksRan;
+  std::atomic<int> count{0};
+  pool.add([&] {
+    for (int i = 0; i < 4; ++i) {
+      pool.add([&] {
+        if (count.fetch_add(1) == 3) {
+          subtasksRan.post();
+        }
+      });
+    }
+    subtasksRan.wait();
+  });
+  pool.join();
+  EXPECT_EQ(4, count.load());
+}
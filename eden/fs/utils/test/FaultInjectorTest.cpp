@@ -166,3 +166,55 @@ TEST(FaultInjector, joinedKey) {
   fi.checkAsync("my_fault", "foo", "baz").get();
   fi.check("my_fault", "bar", "foo");
 }
+
+TEST(FaultInjector, randomDelay) {
+  FaultInjector fi(true);
+  // A zero cap clamps every sample, so the checks return promptly while
+  // still exercising the sampling path. The fault expires after two hits.
+  fi.injectRandomDelay(
+      "store",
+      ".*",
+      FaultInjector::DelayDistribution::Lognormal,
+      /*scaleMs=*/12.0,
+      /*shape=*/0.8,
+      /*maxDelay=*/0ms,
+      /*seed=*/42,
+      /*count=*/2);
+  fi.injectError("store", ".*", std::runtime_error("expired"));
+
+  fi.check("store", "blob1");
+  fi.checkAsync("store", "blob2").get();
+  EXPECT_THROW_RE(fi.check("store", "blob3"), std::runtime_error, "expired");
+}
+
+TEST(FaultInjector, latencyProfile) {
+  FaultInjector fi(true);
+  fi.loadLatencyProfile(R"({
+    "seed": 42,
+    "faults": [
+      {"keyClass": "getBlob", "keyValueRegex": ".*",
+       "distribution": "lognormal", "medianMs": 1, "sigma": 0.1,
+       "maxDelayMs": 1},
+      {"keyClass": "getTree",
+       "distribution": "pareto", "scaleMs": 1, "shape": 2.0, "maxDelayMs": 1}
+    ]
+  })");
+
+  fi.check("getBlob", "abc");
+  fi.check("getTree", "abc");
+
+  // Both faults were installed under their regexes (the second with the
+  // default catch-all) and can be removed like any other fault.
+  EXPECT_TRUE(fi.removeFault("getBlob", ".*"));
+  EXPECT_TRUE(fi.removeFault("getTree", ".*"));
+
+  EXPECT_THROW_RE(
+      fi.loadLatencyProfile(R"({"faults": 7})"),
+      std::invalid_argument,
+      "faults");
+  EXPECT_THROW_RE(
+      fi.loadLatencyProfile(
+          R"({"faults": [{"keyClass": "x", "distribution": "bimodal"}]})"),
+      std::invalid_argument,
+      "bimodal");
+}
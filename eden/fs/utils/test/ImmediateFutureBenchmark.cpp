@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/ImmediateFuture.h"
+
+#include <benchmark/benchmark.h>
+
+#include <folly/futures/Future.h>
+
+namespace {
+
+using namespace facebook::eden;
+
+void immediate_chain(benchmark::State& state) {
+  auto depth = state.range(0);
+  for (auto _ : state) {
+    ImmediateFuture<int> fut{0};
+    for (int64_t i = 0; i < depth; ++i) {
+      fut = std::move(fut).thenValue([](int value) { return value + 1; });
+    }
+    benchmark::DoNotOptimize(std::move(fut).get());
+  }
+}
+BENCHMARK(immediate_chain)->Arg(1)->Arg(8)->Arg(64);
+
+void non_immediate_chain(benchmark::State& state) {
+  auto depth = state.range(0);
+  for (auto _ : state) {
+    auto [promise, semiFut] = folly::makePromiseContract<int>();
+    ImmediateFuture<int> fut{std::move(semiFut)};
+    for (int64_t i = 0; i < depth; ++i) {
+      fut = std::move(fut).thenValue([](int value) { return value + 1; });
+    }
+    promise.setValue(0);
+    benchmark::DoNotOptimize(std::move(fut).get());
+  }
+}
+BENCHMARK(non_immediate_chain)->Arg(1)->Arg(8)->Arg(64);
+
+void immediate_then_try(benchmark::State& state) {
+  auto depth = state.range(0);
+  for (auto _ : state) {
+    ImmediateFuture<int> fut{0};
+    for (int64_t i = 0; i < depth; ++i) {
+      fut = std::move(fut).thenTry(
+          [](folly::Try<int> value) { return *value + 1; });
+    }
+    benchmark::DoNotOptimize(std::move(fut).get());
+  }
+}
+BENCHMARK(immediate_then_try)->Arg(1)->Arg(8)->Arg(64);
+
+} // namespace
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/LeaseCache.h"
+
+#include <folly/portability/GTest.h>
+
+using namespace facebook::eden;
+
+namespace {
+
+using Cache = LeaseCache<std::string, int>;
+
+/** A fetcher that completes immediately and counts its invocations. */
+Cache::FetchFunc countingFetcher(size_t& fetches) {
+  return [&fetches](const std::string& key) {
+    ++fetches;
+    return folly::makeFuture(std::make_shared<int>(int(key.size())));
+  };
+}
+
+} // namespace
+
+TEST(LeaseCache, getBatchFetchesEachKeyOnce) {
+  size_t fetches = 0;
+  Cache cache{10, countingFetcher(fetches)};
+
+  auto futures = cache.getBatch({"a", "bb", "a", "ccc"});
+  ASSERT_EQ(4, futures.size());
+  EXPECT_EQ(3, fetches);
+
+  // Futures correspond positionally to the requested keys, with the
+  // duplicate key sharing its first occurrence's lease.
+  EXPECT_EQ(1, *std::move(futures[0]).get());
+  EXPECT_EQ(2, *std::move(futures[1]).get());
+  EXPECT_EQ(1, *std::move(futures[2]).get());
+  EXPECT_EQ(3, *std::move(futures[3]).get());
+
+  // A second batch inherits every lease.
+  cache.getBatch({"a", "bb", "ccc"});
+  EXPECT_EQ(3, fetches);
+}
+
+TEST(LeaseCache, batchInheritsInFlightLeases) {
+  folly::SharedPromise<Cache::ValuePtr> inFlight;
+  size_t fetches = 0;
+  Cache cache{10, [&](const std::string&) {
+                ++fetches;
+                return inFlight.getFuture();
+              }};
+
+  auto first = cache.get("key");
+  auto batch = cache.getBatch({"key"});
+  ASSERT_EQ(1, batch.size());
+  EXPECT_EQ(1, fetches);
+  EXPECT_FALSE(first.isReady());
+  EXPECT_FALSE(batch[0].isReady());
+
+  inFlight.setValue(std::make_shared<int>(42));
+  EXPECT_EQ(42, *std::move(first).get());
+  EXPECT_EQ(42, *std::move(batch[0]).get());
+}
+
+TEST(LeaseCache, statsTrackRequesterIdentity) {
+  size_t fetches = 0;
+  Cache cache{10, countingFetcher(fetches)};
+
+  cache.getBatch({"a", "bb"}, pid_t{100});
+  cache.getBatch({"a", "ccc"}, pid_t{200});
+  cache.get("a");
+
+  auto stats = cache.getStats();
+  EXPECT_EQ(2, stats.hits);
+  EXPECT_EQ(3, stats.misses);
+  EXPECT_EQ(2, stats.leasesStartedByRequester.at(100));
+  EXPECT_EQ(1, stats.leasesStartedByRequester.at(200));
+  // get() without a requester counts in hits/misses only.
+  EXPECT_EQ(2, stats.leasesStartedByRequester.size());
+}
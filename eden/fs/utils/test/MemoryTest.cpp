@@ -7,12 +7,51 @@
 
 #include "eden/fs/utils/Memory.h"
 
+#include <cstring>
+
 #include <folly/Exception.h>
 #include <folly/portability/GTest.h>
 
 using std::string;
 using namespace facebook::eden;
 
+TEST(Memory, ArenaMallocRoundTrip) {
+  void* ptr = arenaMalloc(MemoryArena::BlobData, 128);
+  ASSERT_NE(nullptr, ptr);
+  memset(ptr, 0xab, 128);
+  arenaFree(ptr);
+
+  // Zero-sized requests still return a distinct, freeable allocation.
+  void* zero = arenaMalloc(MemoryArena::TreeData, 0);
+  ASSERT_NE(nullptr, zero);
+  arenaFree(zero);
+}
+
+TEST(Memory, ArenaIOBufIsWritable) {
+  auto buf = newArenaIOBuf(MemoryArena::BlobData, 1024);
+  EXPECT_EQ(0, buf.length());
+  ASSERT_GE(buf.tailroom(), 1024);
+  memset(buf.writableTail(), 0x5a, 1024);
+  buf.append(1024);
+  EXPECT_EQ(1024, buf.length());
+}
+
+TEST(Memory, ArenaStatsCoverEveryArena) {
+  auto stats = getMemoryArenaStats();
+  ASSERT_EQ(kMemoryArenaCount, stats.size());
+  EXPECT_EQ("blob_data", stats[0].name);
+  EXPECT_EQ("tree_data", stats[1].name);
+  EXPECT_EQ("thrift", stats[2].name);
+  for (const auto& arena : stats) {
+    if (!arena.supported) {
+      // Not running under jemalloc; the byte counts are not meaningful.
+      continue;
+    }
+    EXPECT_GE(arena.mappedBytes, arena.activeBytes);
+    EXPECT_GE(arena.activeBytes, arena.allocatedBytes);
+  }
+}
+
 TEST(Memory, StdStringMemoryUsage) {
   std::string test;
   for (int stringLength = 0; stringLength < 100; stringLength++) {
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/PathMap.h"
+
+#include <benchmark/benchmark.h>
+
+#include <fmt/format.h>
+#include <vector>
+
+namespace {
+
+using namespace facebook::eden;
+
+std::vector<PathComponent> makeComponents(size_t count) {
+  std::vector<PathComponent> components;
+  components.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    components.emplace_back(fmt::format("file{}.txt", i));
+  }
+  return components;
+}
+
+void insert_in_order(benchmark::State& state) {
+  auto components = makeComponents(state.range(0));
+  for (auto _ : state) {
+    PathMap<int> map{CaseSensitivity::Sensitive};
+    for (auto& component : components) {
+      map.insert(std::make_pair(component, 0));
+    }
+    benchmark::DoNotOptimize(map);
+  }
+  state.SetItemsProcessed(state.iterations() * components.size());
+}
+BENCHMARK(insert_in_order)->Arg(32)->Arg(1024);
+
+void find_existing(benchmark::State& state) {
+  auto components = makeComponents(state.range(0));
+  PathMap<int> map{CaseSensitivity::Sensitive};
+  for (auto& component : components) {
+    map.insert(std::make_pair(component, 0));
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(components[i]));
+    i = (i + 1) % components.size();
+  }
+}
+BENCHMARK(find_existing)->Arg(32)->Arg(1024);
+
+void find_existing_case_insensitive(benchmark::State& state) {
+  auto components = makeComponents(state.range(0));
+  PathMap<int> map{CaseSensitivity::Insensitive};
+  for (auto& component : components) {
+    map.insert(std::make_pair(component, 0));
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.find(components[i]));
+    i = (i + 1) % components.size();
+  }
+}
+BENCHMARK(find_existing_case_insensitive)->Arg(32)->Arg(1024);
+
+} // namespace
@@ -260,3 +260,105 @@ TEST(PathMap, swap) {
   EXPECT_EQ(0, b.size()) << "b now has 0 elements";
   EXPECT_EQ("foo", a.at("foo"_pc));
 }
+
+namespace {
+// A minimal allocator that counts how many bytes it hands out, so we can
+// verify that PathMap places its storage with the supplied allocator.
+template <typename T>
+struct CountingAllocator {
+  using value_type = T;
+
+  explicit CountingAllocator(size_t* allocated) : allocated(allocated) {}
+
+  template <typename U>
+  /* implicit */ CountingAllocator(const CountingAllocator<U>& other)
+      : allocated(other.allocated) {}
+
+  T* allocate(size_t n) {
+    *allocated += n * sizeof(T);
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* p, size_t n) {
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+  template <typename U>
+  bool operator==(const CountingAllocator<U>& other) const {
+    return allocated == other.allocated;
+  }
+  template <typename U>
+  bool operator!=(const CountingAllocator<U>& other) const {
+    return allocated != other.allocated;
+  }
+
+  size_t* allocated;
+};
+} // namespace
+
+TEST(PathMap, customAllocator) {
+  using Pair = std::pair<PathComponent, int>;
+  size_t allocated = 0;
+
+  PathMap<int, PathComponent, CountingAllocator<Pair>> map(
+      kPathMapDefaultCaseSensitive, CountingAllocator<Pair>(&allocated));
+
+  map.insert(std::make_pair(PathComponent("foo"), 1));
+  map.insert(std::make_pair(PathComponent("bar"), 2));
+
+  EXPECT_GE(allocated, 2 * sizeof(Pair))
+      << "storage came from the supplied allocator";
+  EXPECT_EQ(1, map.at("foo"_pc));
+  EXPECT_EQ(2, map.at("bar"_pc));
+}
+
+TEST(PathMap, unsortedAppendThenSort) {
+  PathMap<int> map(CaseSensitivity::Sensitive);
+  map.unsortedAppend("c"_pc, 3);
+  map.unsortedAppend("a"_pc, 1);
+  map.unsortedAppend("b"_pc, 2);
+  EXPECT_EQ(map.sortAndDedupe(), 0);
+
+  EXPECT_EQ(map.size(), 3);
+  EXPECT_EQ(map.at("a"_pc), 1);
+  EXPECT_EQ(map.at("b"_pc), 2);
+  EXPECT_EQ(map.at("c"_pc), 3);
+
+  // The result is in sorted order, just as if insert() had been used.
+  auto iter = map.begin();
+  EXPECT_EQ(iter->first, "a"_pc);
+  EXPECT_EQ((++iter)->first, "b"_pc);
+  EXPECT_EQ((++iter)->first, "c"_pc);
+}
+
+TEST(PathMap, sortAndDedupeKeepsTheEarliestCollidingEntry) {
+  PathMap<int> map(CaseSensitivity::Insensitive);
+  map.unsortedAppend("readme"_pc, 1);
+  map.unsortedAppend("other"_pc, 2);
+  map.unsortedAppend("README"_pc, 3);
+  EXPECT_EQ(map.sortAndDedupe(), 1);
+
+  EXPECT_EQ(map.size(), 2);
+  // Like insert(), the earliest entry for a key wins.
+  EXPECT_EQ(map.at("Readme"_pc), 1);
+  EXPECT_EQ(map.at("other"_pc), 2);
+
+  // A case sensitive map keeps both spellings.
+  PathMap<int> sensitive(CaseSensitivity::Sensitive);
+  sensitive.unsortedAppend("readme"_pc, 1);
+  sensitive.unsortedAppend("README"_pc, 3);
+  EXPECT_EQ(sensitive.sortAndDedupe(), 0);
+  EXPECT_EQ(sensitive.size(), 2);
+}
+
+TEST(PathMap, iteratorConstructionDedupes) {
+  std::vector<std::pair<PathComponent, int>> pairs{
+      {PathComponent("b"), 1},
+      {PathComponent("A"), 2},
+      {PathComponent("a"), 3},
+  };
+  PathMap<int> map(pairs.begin(), pairs.end(), CaseSensitivity::Insensitive);
+  EXPECT_EQ(map.size(), 2);
+  EXPECT_EQ(map.at("a"_pc), 2);
+  EXPECT_EQ(map.at("b"_pc), 1);
+}
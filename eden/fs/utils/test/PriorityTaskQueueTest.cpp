@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This software may be used and distributed according to the terms of the
+ * GNU General Public License version 2.
+ */
+
+#include "eden/fs/utils/PriorityTaskQueue.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/portability/GTest.h>
+#include <folly/synchronization/Baton.h>
+
+using namespace facebook::eden;
+
+TEST(PriorityTaskQueueTest, runsTasksAtEveryPriority) {
+  folly::CPUThreadPoolExecutor pool(
+      2,
+      std::make_unique<PriorityTaskQueue>(),
+      std::make_unique<folly::NamedThreadFactory>("TestPool"));
+
+  std::atomic<int> count{0};
+  for (int i = 0; i < 10; ++i) {
+    pool.addWithPriority([&] { count.fetch_add(1); }, folly::Executor::LO_PRI);
+    pool.add([&] { count.fetch_add(1); });
+    pool.addWithPriority([&] { count.fetch_add(1); }, folly::Executor::HI_PRI);
+  }
+  pool.join();
+  EXPECT_EQ(30, count.load());
+}
+
+TEST(PriorityTaskQueueTest, higherPriorityTasksRunFirst) {
+  folly::CPUThreadPoolExecutor pool(
+      1,
+      std::make_unique<PriorityTaskQueue>(),
+      std::make_unique<folly::NamedThreadFactory>("TestPool"));
+
+  // Block the single worker so the remaining tasks queue up, then release
+  // it and observe the drain order.
+  folly::Baton<> release;
+  pool.add([&] { release.wait(); });
+
+  std::vector<int> order;
+  pool.addWithPriority([&] { order.push_back(0); }, folly::Executor::LO_PRI);
+  pool.addWithPriority([&] { order.push_back(1); }, folly::Executor::MID_PRI);
+  pool.addWithPriority([&] { order.push_back(2); }, folly::Executor::HI_PRI);
+  release.post();
+  pool.join();
+
+  EXPECT_EQ((std::vector<int>{2, 1, 0}), order);
+}
+
+TEST(PriorityTaskQueueTest, laneSizeReportsPerLaneDepth) {
+  PriorityTaskQueue queue;
+
+  auto makeTask = [] { return folly::CPUThreadPoolExecutor::CPUTask{}; };
+
+  queue.addWithPriority(makeTask(), folly::Executor::LO_PRI);
+  queue.addWithPriority(makeTask(), folly::Executor::HI_PRI);
+  queue.addWithPriority(makeTask(), folly::Executor::HI_PRI);
+
+  EXPECT_EQ(1, queue.laneSize(0));
+  EXPECT_EQ(0, queue.laneSize(1));
+  EXPECT_EQ(2, queue.laneSize(2));
+  EXPECT_EQ(3, queue.size());
+
+  // take() drains the high-priority lane first.
+  queue.take();
+  EXPECT_EQ(1, queue.laneSize(2));
+}
@@ -44,6 +44,34 @@ TEST(ProcessAccessLog, accessIncrementsAccessCount) {
   EXPECT_THAT(log.getAccessCounts(10s), Contains(std::pair{pid, ac}));
 }
 
+TEST(ProcessAccessLog, recordBytesAccumulatesPerPid) {
+  auto pid = pid_t{42};
+  auto log = ProcessAccessLog{std::make_shared<ProcessNameCache>()};
+
+  log.recordBytes(pid, ProcessAccessLog::AccessType::FsChannelRead, 100);
+  log.recordBytes(pid, ProcessAccessLog::AccessType::FsChannelRead, 50);
+  log.recordBytes(pid, ProcessAccessLog::AccessType::FsChannelWrite, 10);
+
+  auto ac = AccessCounts{};
+  ac.fsChannelBytesRead_ref() = 150;
+  ac.fsChannelBytesWritten_ref() = 10;
+
+  EXPECT_THAT(log.getAccessCounts(10s), Contains(std::pair{pid, ac}));
+}
+
+TEST(ProcessAccessLog, operationCountsAggregateAcrossPids) {
+  auto log = ProcessAccessLog{std::make_shared<ProcessNameCache>()};
+
+  log.recordAccess(pid_t{1}, ProcessAccessLog::AccessType::FsChannelRead);
+  log.recordAccess(pid_t{2}, ProcessAccessLog::AccessType::FsChannelRead);
+  log.recordAccess(pid_t{2}, ProcessAccessLog::AccessType::FsChannelWrite);
+
+  auto counts = log.getOperationCounts(10s);
+  EXPECT_EQ(2, counts[enumValue(ProcessAccessLog::AccessType::FsChannelRead)]);
+  EXPECT_EQ(1, counts[enumValue(ProcessAccessLog::AccessType::FsChannelWrite)]);
+  EXPECT_EQ(0, counts[enumValue(ProcessAccessLog::AccessType::FsChannelOther)]);
+}
+
 TEST(ProcessAccessLog, accessAddsProcessToProcessNameCache) {
   auto pid = pid_t{1};
   auto processNameCache = std::make_shared<ProcessNameCache>();
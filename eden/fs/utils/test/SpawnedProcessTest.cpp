@@ -130,6 +130,37 @@ TEST(SpawnedProcess, stresstest_pipe_output) {
   EXPECT_TRUE(okay);
 }
 
+void test_large_pipe_output(bool threaded) {
+#ifndef _WIN32
+  // Large enough to push the pump loops through several chunk doublings
+  // and into the spill iovec.
+  Options opts;
+  opts.pipeStdout();
+  opts.nullStdin();
+  SpawnedProcess proc({"seq", "1", "200000"}, std::move(opts));
+  auto done = [](FileDescriptor&) { return true; };
+  auto outputs = threaded ? proc.threadedCommunicate(done)
+                          : proc.pollingCommunicate(done);
+  proc.wait();
+
+  std::vector<std::string> resultLines;
+  folly::split('\n', outputs.first, resultLines, /*ignoreEmpty=*/true);
+  ASSERT_EQ(200000, resultLines.size());
+  EXPECT_EQ("1", resultLines.front());
+  EXPECT_EQ("200000", resultLines.back());
+#else
+  (void)threaded;
+#endif
+}
+
+TEST(SpawnedProcess, largeOutputThreaded) {
+  test_large_pipe_output(true);
+}
+
+TEST(SpawnedProcess, largeOutputNotThreaded) {
+  test_large_pipe_output(false);
+}
+
 TEST(SpawnedProcess, inputThreaded) {
   test_pipe_input(true);
 }
@@ -253,6 +253,56 @@ TEST(FutureUnixSocket, receiveQueue) {
   EXPECT_EQ(sendMessages.size(), receivedMessages.size());
 }
 
+TEST(FutureUnixSocket, queuedLargeSends) {
+  auto sockets = createSocketPair();
+  EventBase evb;
+
+  auto socket1 = make_unique<FutureUnixSocket>(&evb, std::move(sockets.first));
+  auto socket2 = make_unique<FutureUnixSocket>(&evb, std::move(sockets.second));
+
+  // Queue up several messages much larger than the socket buffer before the
+  // event loop runs, so the later sends back up behind the first and get
+  // flushed together once the socket becomes writable.
+  constexpr size_t kNumMessages = 20;
+  constexpr size_t kMessageSize = 512 * 1024;
+  std::vector<std::string> sendMessages;
+  for (size_t n = 0; n < kNumMessages; ++n) {
+    sendMessages.emplace_back(kMessageSize, static_cast<char>('a' + n));
+  }
+
+  std::vector<UnixSocket::Message> receivedMessages;
+  for (size_t n = 0; n < kNumMessages; ++n) {
+    auto future = socket2->receive(5s)
+                      .thenValue([&receivedMessages](UnixSocket::Message&& msg) {
+                        receivedMessages.emplace_back(std::move(msg));
+                      })
+                      .thenError([n, &evb](const folly::exception_wrapper& ew) {
+                        ADD_FAILURE() << "receive " << n << " error: " << ew.what();
+                        evb.terminateLoopSoon();
+                      });
+    if (n == kNumMessages - 1) {
+      std::move(future).ensure([&evb]() { evb.terminateLoopSoon(); });
+    }
+  }
+
+  for (const auto& msg : sendMessages) {
+    auto sendBuf = IOBuf(IOBuf::WRAP_BUFFER, ByteRange{StringPiece{msg}});
+    socket1->send(std::move(sendBuf))
+        .thenError([](const folly::exception_wrapper& ew) {
+          ADD_FAILURE() << "send error: " << ew.what();
+        });
+  }
+
+  evb.loopForever();
+
+  ASSERT_EQ(kNumMessages, receivedMessages.size());
+  for (size_t n = 0; n < kNumMessages; ++n) {
+    EXPECT_EQ(
+        StringPiece{sendMessages[n]},
+        StringPiece{receivedMessages[n].data.coalesce()});
+  }
+}
+
 TEST(FutureUnixSocket, attachEventBase) {
   // A helper function to attach sockets to an EventBase, send a message, then
   // detach from the EventBase
@@ -33,6 +33,31 @@ TEST(Utf8Test, isValidUtf8) {
   // overlong
   EXPECT_FALSE(isValidUtf8("\xF0\x82\x82\xAC"));
   EXPECT_FALSE(isValidUtf8("\xA0prefix\xB0"));
+  // UTF-16 surrogate half
+  EXPECT_FALSE(isValidUtf8("\xED\xA0\x80"));
+  // past U+10FFFF
+  EXPECT_FALSE(isValidUtf8("\xF4\x90\x80\x80"));
+  // truncated sequences
+  EXPECT_FALSE(isValidUtf8("\xC3"));
+  EXPECT_FALSE(isValidUtf8("\xE2\x82"));
+  EXPECT_FALSE(isValidUtf8("\xF0\x9F\x98"));
+}
+
+TEST(Utf8Test, isValidUtf8AcrossBlockBoundaries) {
+  // The validator processes a vector register's worth of bytes at a time;
+  // slide multi-byte sequences across every alignment to cover sequences
+  // that straddle blocks and truncation at the end of the input.
+  for (size_t pad = 0; pad < 70; ++pad) {
+    std::string prefix(pad, 'a');
+    EXPECT_TRUE(isValidUtf8(prefix));
+    EXPECT_TRUE(
+        isValidUtf8(prefix + reinterpret_cast<const char*>(u8"\U00010348")));
+    EXPECT_TRUE(isValidUtf8(
+        prefix + reinterpret_cast<const char*>(u8"\u00A2") + prefix));
+    EXPECT_FALSE(isValidUtf8(prefix + "\xff"));
+    EXPECT_FALSE(isValidUtf8(prefix + "\xED\xA0\x80" + prefix));
+    EXPECT_FALSE(isValidUtf8(prefix + "\xE2\x82"));
+  }
 }
 
 TEST(Utf8String, ensureValidUtf8) {
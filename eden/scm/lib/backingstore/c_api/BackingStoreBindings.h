@@ -33,13 +33,15 @@ enum class TreeEntryType : uint8_t {
 
 struct BackingStore;
 
+struct Bytes;
+
 template<typename T = void>
 struct Vec;
 
 struct CBytes {
   uint8_t *ptr;
   size_t len;
-  Vec<uint8_t> *vec;
+  Bytes *bytes;
   folly::ByteRange asByteRange() const {
     return folly::ByteRange(ptr, len);
   }
@@ -21,6 +21,11 @@ namespace {
 /**
  * Convert a `CBytes` into `folly::IOBuf` without copying the underlying
  * data.
+ *
+ * The buffer is owned by the Rust `Bytes` carried inside the `CBytes` and
+ * may be backed by an mmap of the hgcache, so it must be treated as
+ * read-only: the IOBuf's contents must never be written through, only the
+ * chain metadata may change.
  */
 std::unique_ptr<folly::IOBuf> bytesToIOBuf(CBytes* bytes) {
   return folly::IOBuf::takeOwnership(
@@ -14,6 +14,7 @@ use anyhow::anyhow;
 use anyhow::Result;
 use log::warn;
 use manifest::List;
+use minibytes::Bytes;
 use revisionstore::scmstore::file::FileAuxData;
 use revisionstore::scmstore::FileAttributes;
 use revisionstore::scmstore::FileStore;
@@ -88,14 +89,14 @@ impl BackingStore {
 
     /// Reads file from blobstores. When `local_only` is true, this function will only read blobs
     /// from on disk stores.
-    pub fn get_blob(&self, node: &[u8], local_only: bool) -> Result<Option<Vec<u8>>> {
+    pub fn get_blob(&self, node: &[u8], local_only: bool) -> Result<Option<Bytes>> {
         let hgid = HgId::from_slice(node)?;
         let key = Key::new(RepoPathBuf::new(), hgid);
         self.get_blob_by_key(key, local_only)
     }
 
     #[instrument(level = "debug", skip(self))]
-    fn get_blob_by_key(&self, key: Key, local_only: bool) -> Result<Option<Vec<u8>>> {
+    fn get_blob_by_key(&self, key: Key, local_only: bool) -> Result<Option<Bytes>> {
         let local = self.filestore.local();
         let fetch_result = if local_only {
             event!(Level::TRACE, "attempting to fetch blob locally");
@@ -107,7 +108,10 @@ impl BackingStore {
         .single();
 
         Ok(if let Some(mut file) = fetch_result? {
-            Some(file.file_content()?.into_vec())
+            // The returned `Bytes` keeps whatever store buffer backs the
+            // content alive; converting to a `Vec` here would copy every
+            // blob fetched over this interface.
+            Some(file.file_content()?)
         } else {
             None
         })
@@ -189,7 +193,7 @@ impl BackingStore {
     #[instrument(level = "debug", skip(self, resolve))]
     pub fn get_blob_batch<F>(&self, keys: Vec<Key>, local_only: bool, resolve: F)
     where
-        F: Fn(usize, Result<Option<Vec<u8>>>) -> (),
+        F: Fn(usize, Result<Option<Bytes>>) -> (),
     {
         self.get_file_attrs_batch(
             keys,
@@ -198,11 +202,7 @@ impl BackingStore {
                 resolve(
                     idx,
                     res.transpose()
-                        .map(|res| {
-                            res.and_then(|mut file| {
-                                file.file_content().map(|content| content.into_vec())
-                            })
-                        })
+                        .map(|res| res.and_then(|mut file| file.file_content()))
                         .transpose(),
                 )
             },
@@ -96,7 +96,7 @@ pub extern "C" fn sapling_backingstore_get_blob(
         store
             .get_blob(node.slice(), local)
             .and_then(|opt| opt.ok_or_else(|| Error::msg("no blob found")))
-            .map(CBytes::from_vec)
+            .map(CBytes::from_bytes)
     })
     .into()
 }
@@ -113,7 +113,7 @@ pub extern "C" fn sapling_backingstore_get_blob_batch(
     store.get_blob_batch(keys, local, |idx, result| {
         let result: CFallible<CBytes> = result
             .and_then(|opt| opt.ok_or_else(|| Error::msg("no blob found")))
-            .map(CBytes::from_vec)
+            .map(CBytes::from_bytes)
             .into();
         unsafe { resolve(data, idx, result.into()) };
     });
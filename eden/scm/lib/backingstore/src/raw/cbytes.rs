@@ -5,30 +5,41 @@
  * GNU General Public License version 2.
  */
 
-//! Provides a struct to pass a Rust `vec` to C++. However, the C++ code must hold a reference to
-//! the underlying Rust `vec` since `Vec::as_ptr` requires the vector remain valid and alive over
-//! the lifetime of the pointer it returns.
+//! Provides a struct to pass a Rust buffer to C++ without copying. The C++
+//! code must hold a reference to the underlying `Bytes` for as long as it
+//! reads through the pointer, since the bytes may be backed by refcounted
+//! heap memory or an indexedlog mmap that is only kept alive by the `Bytes`.
 
 use libc::size_t;
+use minibytes::Bytes;
 
 #[repr(C)]
 pub struct CBytes {
     ptr: *mut u8,
     len: size_t,
-    vec: *mut Vec<u8>,
+    bytes: *mut Bytes,
 }
 
 impl CBytes {
-    pub fn from_vec(vec: Vec<u8>) -> Self {
-        let mut vec = Box::new(vec);
-        let ptr = vec.as_mut_ptr();
+    /// Wraps a `Bytes` without copying it. Whatever storage backs the bytes
+    /// (a heap buffer, an mmap of the hgcache, ...) stays alive until
+    /// `sapling_cbytes_free`. The buffer must be treated as read-only on the
+    /// C++ side: it may live in pages mapped without write permission.
+    pub fn from_bytes(bytes: Bytes) -> Self {
+        let bytes = Box::new(bytes);
+        let ptr = bytes.as_ptr() as *mut u8;
+        let len = bytes.len();
 
         Self {
             ptr,
-            len: vec.len(),
-            vec: Box::into_raw(vec),
+            len,
+            bytes: Box::into_raw(bytes),
         }
     }
+
+    pub fn from_vec(vec: Vec<u8>) -> Self {
+        Self::from_bytes(Bytes::from_owner(vec))
+    }
 }
 
 impl From<Vec<u8>> for CBytes {
@@ -39,13 +50,13 @@ impl From<Vec<u8>> for CBytes {
 
 impl Drop for CBytes {
     fn drop(&mut self) {
-        let vec = unsafe { Box::from_raw(self.vec) };
-        drop(vec);
+        let bytes = unsafe { Box::from_raw(self.bytes) };
+        drop(bytes);
     }
 }
 
 #[no_mangle]
-pub extern "C" fn sapling_cbytes_free(vec: *mut CBytes) {
-    let ptr = unsafe { Box::from_raw(vec) };
+pub extern "C" fn sapling_cbytes_free(bytes: *mut CBytes) {
+    let ptr = unsafe { Box::from_raw(bytes) };
     drop(ptr);
 }